@@ -1,7 +1,9 @@
 #include "context.h"
 
 #include <ctype.h>
+#include <limits.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <time.h>
 
@@ -44,6 +46,7 @@ void initContext(void) {
   CREATE_INT_CONTEXT(anaerobic,       "ANAEROBIC",        ARG_OFF, FLAG_YES);
   CREATE_INT_CONTEXT(flooding,        "FLOODING",         ARG_OFF, FLAG_YES);
   CREATE_INT_CONTEXT(carbonSaturation,"CARBON_SATURATION",ARG_OFF, FLAG_YES);
+  CREATE_INT_CONTEXT(analyticLight,   "ANALYTIC_LIGHT",   ARG_OFF, FLAG_YES);
 
   // Flags, I/O
   CREATE_INT_CONTEXT(doMainOutput,    "DO_MAIN_OUTPUT",   ARG_ON,  FLAG_YES);
@@ -51,6 +54,10 @@ void initContext(void) {
   CREATE_INT_CONTEXT(dumpConfig,      "DUMP_CONFIG",      ARG_OFF, FLAG_YES);
   CREATE_INT_CONTEXT(printHeader,     "PRINT_HEADER",     ARG_ON,  FLAG_YES);
   CREATE_INT_CONTEXT(quiet,           "QUIET",            ARG_OFF, FLAG_YES);
+  CREATE_INT_CONTEXT(climateCache,    "CLIMATE_CACHE",    ARG_ON,  FLAG_YES);
+  CREATE_INT_CONTEXT(climateStream,   "CLIMATE_STREAM",   ARG_OFF, FLAG_YES);
+  CREATE_INT_CONTEXT(asyncOutput,     "ASYNC_OUTPUT",     ARG_OFF, FLAG_YES);
+  CREATE_INT_CONTEXT(autoResume,      "AUTO_RESUME",      ARG_OFF, FLAG_YES);
 
   // Files
   CREATE_CHAR_CONTEXT(paramFile,      "PARAM_FILE",       NO_DEFAULT_FILE);
@@ -62,11 +69,44 @@ void initContext(void) {
   CREATE_CHAR_CONTEXT(restartIn,      "RESTART_IN",       NO_DEFAULT_FILE);
   CREATE_CHAR_CONTEXT(restartOut,     "RESTART_OUT",      NO_DEFAULT_FILE);
   CREATE_CHAR_CONTEXT(debugLogPrefix, "DEBUG_LOG_PREFIX", NO_DEFAULT_FILE);
+  CREATE_CHAR_CONTEXT(ensembleFile,   "ENSEMBLE_FILE",    NO_DEFAULT_FILE);
+  CREATE_CHAR_CONTEXT(scenarioFile,   "SCENARIO_FILE",    NO_DEFAULT_FILE);
   // clang-format on
 
   // Other
   // Prefix for climate and parameter input files.
   CREATE_CHAR_CONTEXT(filePrefix, "FILE_PREFIX", DEFAULT_FILE_NAME);
+  // Worker threads for ensemble runs; 0 means one per online CPU
+  CREATE_INT_CONTEXT(numThreads, "NUM_THREADS", 0, FLAG_NO);
+  // Threads for parsing climate files; 0 means one per online CPU
+  CREATE_INT_CONTEXT(climateThreads, "CLIMATE_THREADS", 1, FLAG_NO);
+  // Ensemble members run together by each thread
+  CREATE_INT_CONTEXT(numLanes, "NUM_LANES", 1, FLAG_NO);
+  // Format of the main output file
+  CREATE_CHAR_CONTEXT(outputFormat, "OUTPUT_FORMAT", OUTPUT_FORMAT_TEXT);
+  // Variables written to the main output and debug logs; empty for all
+  CREATE_CHAR_CONTEXT(outputVars, "OUTPUT_VARS", "");
+  // Period the main output is aggregated over
+  CREATE_CHAR_CONTEXT(outputPeriod, "OUTPUT_PERIOD", OUTPUT_PERIOD_STEP);
+  // Variables written to the single-variable output file; empty for the
+  // default set
+  CREATE_CHAR_CONTEXT(singleOutputVars, "SINGLE_OUTPUT_VARS", "");
+  // Deflate level for NetCDF output
+  CREATE_INT_CONTEXT(netcdfDeflate, "NETCDF_DEFLATE", 0, FLAG_NO);
+  // NetCDF met file read instead of the .clim file; empty for none
+  CREATE_CHAR_CONTEXT(metFile, "MET_FILE", "");
+  // Years of the met file to read; empty for all
+  CREATE_CHAR_CONTEXT(metYears, "MET_YEARS", "");
+  // Compression of the main output, debug logs and events output
+  CREATE_CHAR_CONTEXT(compressOutput, "COMPRESS_OUTPUT", COMPRESS_OUTPUT_NONE);
+  // Format of restart-out checkpoints
+  CREATE_CHAR_CONTEXT(restartFormat, "RESTART_FORMAT", RESTART_FORMAT_AUTO);
+  // How often to write periodic checkpoints; empty for never
+  CREATE_CHAR_CONTEXT(checkpointEvery, "CHECKPOINT_EVERY", "");
+  // Dates to write restart-out checkpoints after; empty for the end of run
+  CREATE_CHAR_CONTEXT(restartDates, "RESTART_DATES", "");
+  // Date the scenario-file branches leave the baseline run
+  CREATE_CHAR_CONTEXT(scenarioDate, "SCENARIO_DATE", "");
 }
 
 // With all the different permutations of spellings for config params, lets
@@ -192,6 +232,203 @@ void validateFilename(void) {
   }
 }
 
+// See context.h
+int isOutputFormat(const char *format) {
+  return (strcmp(format, OUTPUT_FORMAT_TEXT) == 0) ||
+         (strcmp(format, OUTPUT_FORMAT_BINARY) == 0) ||
+         (strcmp(format, OUTPUT_FORMAT_BINARY32) == 0) ||
+         (strcmp(format, OUTPUT_FORMAT_NETCDF) == 0);
+}
+
+// See context.h
+int isOutputCompression(const char *method) {
+  return (strcmp(method, COMPRESS_OUTPUT_NONE) == 0) ||
+         (strcmp(method, COMPRESS_OUTPUT_GZIP) == 0) ||
+         (strcmp(method, COMPRESS_OUTPUT_ZSTD) == 0);
+}
+
+// See context.h
+int isRestartFormat(const char *format) {
+  return (strcmp(format, RESTART_FORMAT_AUTO) == 0) ||
+         (strcmp(format, RESTART_FORMAT_TEXT) == 0) ||
+         (strcmp(format, RESTART_FORMAT_BINARY) == 0);
+}
+
+// See context.h
+int isOutputPeriod(const char *period) {
+  return (strcmp(period, OUTPUT_PERIOD_STEP) == 0) ||
+         (strcmp(period, OUTPUT_PERIOD_DAY) == 0) ||
+         (strcmp(period, OUTPUT_PERIOD_MONTH) == 0) ||
+         (strcmp(period, OUTPUT_PERIOD_YEAR) == 0);
+}
+
+// See context.h
+int parseMetYears(const char *years, int *firstYear, int *lastYear) {
+  char *end;
+  long first, last;
+
+  *firstYear = INT_MIN;
+  *lastYear = INT_MAX;
+  if (*years == '\0') {
+    return 1;
+  }
+  if (!isdigit((unsigned char)*years)) {
+    return 0;
+  }
+  first = strtol(years, &end, 10);
+  last = first;
+  if (*end == '-') {
+    if (!isdigit((unsigned char)end[1])) {
+      return 0;
+    }
+    last = strtol(end + 1, &end, 10);
+  }
+  if ((*end != '\0') || (first > last) || (last > INT_MAX)) {
+    return 0;
+  }
+  *firstYear = (int)first;
+  *lastYear = (int)last;
+  return 1;
+}
+
+// See context.h
+int parseCheckpointEvery(const char *every, long *count, int *inYears) {
+  char *end;
+
+  *count = 0;
+  *inYears = 0;
+  if (*every == '\0') {
+    return 1;
+  }
+  if (!isdigit((unsigned char)*every)) {
+    return 0;
+  }
+  long value = strtol(every, &end, 10);
+  if ((strcmp(end, "years") == 0) || (strcmp(end, "year") == 0)) {
+    *inYears = 1;
+  } else if ((strcmp(end, "steps") != 0) && (strcmp(end, "step") != 0)) {
+    return 0;
+  }
+  if ((value <= 0) || (value > INT_MAX)) {
+    return 0;
+  }
+  *count = value;
+  return 1;
+}
+
+// See context.h
+int nextRestartDate(const char *dates, size_t *pos, int *year, int *day) {
+  const char *date = dates + *pos;
+  char *end;
+
+  if (*date == '\0') {
+    return 0;
+  }
+  if (!isdigit((unsigned char)*date)) {
+    return -1;
+  }
+  long yearValue = strtol(date, &end, 10);
+  if ((*end != '-') || !isdigit((unsigned char)end[1])) {
+    return -1;
+  }
+  long dayValue = strtol(end + 1, &end, 10);
+  if ((yearValue > INT_MAX) || (dayValue < 1) || (dayValue > 366)) {
+    return -1;
+  }
+  if (*end == ',') {
+    ++end;
+    if (*end == '\0') {
+      return -1;
+    }
+  } else if (*end != '\0') {
+    return -1;
+  }
+  *year = (int)yearValue;
+  *day = (int)dayValue;
+  *pos = (size_t)(end - dates);
+  return 1;
+}
+
+// See context.h
+int countRestartDates(const char *dates) {
+  size_t pos = 0;
+  int count = 0;
+  int year, day, lastYear = 0, lastDay = 0;
+  int found;
+
+  while ((found = nextRestartDate(dates, &pos, &year, &day)) == 1) {
+    if ((count > 0) &&
+        ((year < lastYear) || ((year == lastYear) && (day <= lastDay)))) {
+      return -1;
+    }
+    lastYear = year;
+    lastDay = day;
+    ++count;
+  }
+  return (found < 0) ? -1 : count;
+}
+
+// See context.h
+int formatRestartOut(char *path, size_t size, const char *restartOut, int year,
+                     int day) {
+  size_t len = 0;
+  char field[16];
+
+  for (const char *c = restartOut; *c != '\0'; ++c) {
+    const char *text = field;
+    if (*c != '%') {
+      field[0] = *c;
+      field[1] = '\0';
+    } else if (c[1] == 'Y') {
+      snprintf(field, sizeof(field), "%d", year);
+      ++c;
+    } else if (c[1] == 'j') {
+      snprintf(field, sizeof(field), "%03d", day);
+      ++c;
+    } else if (c[1] == '%') {
+      text = "%";
+      ++c;
+    } else {
+      return 0;
+    }
+    size_t textLen = strlen(text);
+    if (len + textLen >= size) {
+      return 0;
+    }
+    memcpy(path + len, text, textLen);
+    len += textLen;
+  }
+  path[len] = '\0';
+  return 1;
+}
+
+// See context.h
+int isRestartOutTemplate(const char *restartOut, const char *restartDates) {
+  return (strlen(restartDates) > 0) || (strstr(restartOut, "%Y") != NULL) ||
+         (strstr(restartOut, "%j") != NULL);
+}
+
+// See context.h
+int isOutputVar(const char *name) {
+  const char *item = ctx.outputVars;
+  size_t nameLen = strlen(name);
+
+  if (*item == '\0') {
+    return 1;
+  }
+  while (*item != '\0') {
+    size_t itemLen = strcspn(item, ",");
+    if ((itemLen == nameLen) && (strncmp(item, name, nameLen) == 0)) {
+      return 1;
+    }
+    item += itemLen;
+    if (*item == ',') {
+      ++item;
+    }
+  }
+  return 0;
+}
+
 void validateContext(void) {
   int hasError = 0;
 
@@ -217,6 +454,214 @@ void validateContext(void) {
     hasError = 1;
   }
 
+  if (ctx.numThreads < 0) {
+    logError("threads must be zero (one per CPU) or positive\n");
+    hasError = 1;
+  }
+
+  if (ctx.climateThreads < 0) {
+    logError("climate-threads must be zero (one per CPU) or positive\n");
+    hasError = 1;
+  }
+
+  if (ctx.numLanes < 1 || ctx.numLanes > MAX_ENSEMBLE_LANES) {
+    logError("lanes must be between 1 and %d\n", MAX_ENSEMBLE_LANES);
+    hasError = 1;
+  }
+
+  if (!isOutputFormat(ctx.outputFormat)) {
+    logError("output-format must be %s, %s, %s or %s\n", OUTPUT_FORMAT_TEXT,
+             OUTPUT_FORMAT_BINARY, OUTPUT_FORMAT_BINARY32,
+             OUTPUT_FORMAT_NETCDF);
+    hasError = 1;
+  }
+#ifndef SIPNET_NETCDF
+  if (strcmp(ctx.outputFormat, OUTPUT_FORMAT_NETCDF) == 0) {
+    logError("output-format %s needs a build with NetCDF support; rebuild "
+             "with make NETCDF=1\n",
+             OUTPUT_FORMAT_NETCDF);
+    hasError = 1;
+  }
+#endif
+
+  if (ctx.netcdfDeflate < 0 || ctx.netcdfDeflate > NETCDF_MAX_DEFLATE) {
+    logError("netcdf-deflate must be between 0 and %d\n", NETCDF_MAX_DEFLATE);
+    hasError = 1;
+  }
+
+  if (!isOutputCompression(ctx.compressOutput)) {
+    logError("compress-output must be %s, %s or %s\n", COMPRESS_OUTPUT_NONE,
+             COMPRESS_OUTPUT_GZIP, COMPRESS_OUTPUT_ZSTD);
+    hasError = 1;
+  }
+#ifndef SIPNET_ZLIB
+  if (strcmp(ctx.compressOutput, COMPRESS_OUTPUT_GZIP) == 0) {
+    logError("compress-output %s needs a build with zlib\n",
+             COMPRESS_OUTPUT_GZIP);
+    hasError = 1;
+  }
+#endif
+#ifndef SIPNET_ZSTD
+  if (strcmp(ctx.compressOutput, COMPRESS_OUTPUT_ZSTD) == 0) {
+    logError("compress-output %s needs a build with libzstd\n",
+             COMPRESS_OUTPUT_ZSTD);
+    hasError = 1;
+  }
+#endif
+
+  if (strlen(ctx.metFile) > 0) {
+#ifndef SIPNET_NETCDF
+    logError("met-file needs a build with NetCDF support; rebuild with make "
+             "NETCDF=1\n");
+    hasError = 1;
+#endif
+    // The met file is read whole; only text climate files are streamed
+    if (ctx.climateStream) {
+      logError("met-file may not be combined with climate-stream\n");
+      hasError = 1;
+    }
+  } else if (strlen(ctx.metYears) > 0) {
+    logError("met-years requires met-file\n");
+    hasError = 1;
+  }
+  int firstYear, lastYear;
+  if (!parseMetYears(ctx.metYears, &firstYear, &lastYear)) {
+    logError("met-years must be a year or a range of years, e.g. 2010-2015\n");
+    hasError = 1;
+  }
+
+  if (!isRestartFormat(ctx.restartFormat)) {
+    logError("restart-format must be %s, %s or %s\n", RESTART_FORMAT_AUTO,
+             RESTART_FORMAT_TEXT, RESTART_FORMAT_BINARY);
+    hasError = 1;
+  }
+
+  long checkpointCount;
+  int checkpointInYears;
+  if (!parseCheckpointEvery(ctx.checkpointEvery, &checkpointCount,
+                            &checkpointInYears)) {
+    logError("checkpoint-every must be a number of years or steps, e.g. "
+             "10years\n");
+    hasError = 1;
+  }
+  // The longest expansion of the template has to fit; other paths are used
+  // as they are
+  char restartPath[FILENAME_MAXLEN];
+  if (isRestartOutTemplate(ctx.restartOut, ctx.restartDates) &&
+      !formatRestartOut(restartPath, sizeof(restartPath), ctx.restartOut,
+                        -999999, 366)) {
+    logError("restart-out must be a path, or a template using %%Y, %%j and "
+             "%%%% that is shorter than %d characters\n",
+             FILENAME_MAXLEN);
+    hasError = 1;
+  }
+  int numRestartDates = countRestartDates(ctx.restartDates);
+  if (numRestartDates < 0) {
+    logError("restart-dates must be a comma-separated list of ascending "
+             "<year>-<day> dates, e.g. 2016-47,2016-49\n");
+    hasError = 1;
+  } else if (numRestartDates > 0 && strlen(ctx.restartOut) == 0) {
+    logError("restart-dates requires restart-out\n");
+    hasError = 1;
+  } else if (numRestartDates > 1 && (strstr(ctx.restartOut, "%Y") == NULL ||
+                                     strstr(ctx.restartOut, "%j") == NULL)) {
+    logError("restart-out must be a template using %%Y and %%j when "
+             "restart-dates lists more than one date\n");
+    hasError = 1;
+  }
+  if (ctx.autoResume && strlen(ctx.restartIn) > 0) {
+    logError("auto-resume may not be combined with restart-in\n");
+    hasError = 1;
+  }
+
+  if (!isOutputPeriod(ctx.outputPeriod)) {
+    logError("output-period must be %s, %s, %s or %s\n", OUTPUT_PERIOD_STEP,
+             OUTPUT_PERIOD_DAY, OUTPUT_PERIOD_MONTH, OUTPUT_PERIOD_YEAR);
+    hasError = 1;
+  }
+
+  // A resumed run cuts the main and events outputs back to its checkpoint and
+  // appends to them, which takes plain files written a row per step; the other
+  // outputs are not kept with checkpoints
+  if (ctx.autoResume) {
+    if (strcmp(ctx.outputFormat, OUTPUT_FORMAT_TEXT) != 0 ||
+        strcmp(ctx.outputPeriod, OUTPUT_PERIOD_STEP) != 0 ||
+        strcmp(ctx.compressOutput, COMPRESS_OUTPUT_NONE) != 0) {
+      logError("auto-resume requires output-format %s, output-period %s and "
+               "compress-output %s\n",
+               OUTPUT_FORMAT_TEXT, OUTPUT_PERIOD_STEP, COMPRESS_OUTPUT_NONE);
+      hasError = 1;
+    }
+    if (strlen(ctx.debugLogPrefix) > 0 || ctx.doSingleOutputs) {
+      logError("auto-resume may not be combined with debug-log or "
+               "do-single-outputs\n");
+      hasError = 1;
+    }
+  }
+
+  // Ensemble members run concurrently and write their own outputs, so the
+  // single-run restart and debug log files don't apply
+  if (strlen(ctx.ensembleFile) > 0) {
+    if (strlen(ctx.restartIn) > 0 || strlen(ctx.restartOut) > 0) {
+      logError("ensemble may not be combined with restart-in or restart-out\n");
+      hasError = 1;
+    }
+    if (strlen(ctx.checkpointEvery) > 0 || ctx.autoResume) {
+      logError("ensemble may not be combined with checkpoint-every or "
+               "auto-resume\n");
+      hasError = 1;
+    }
+    if (strlen(ctx.debugLogPrefix) > 0) {
+      logError("ensemble may not be combined with debug-log\n");
+      hasError = 1;
+    }
+    // Members share one copy of the whole climate record
+    if (ctx.climateStream) {
+      logError("ensemble may not be combined with climate-stream\n");
+      hasError = 1;
+    }
+  }
+
+  // Scenario branches resume from the baseline's state in memory and write
+  // their own outputs; like ensemble members, they share the climate record
+  if (strlen(ctx.scenarioFile) > 0) {
+    // A list of one date is one date
+    if (countRestartDates(ctx.scenarioDate) != 1) {
+      logError("scenario-file requires scenario-date, a <year>-<day> date, "
+               "e.g. 2016-47\n");
+      hasError = 1;
+    }
+    if (!ctx.events) {
+      logError("scenario-file requires events\n");
+      hasError = 1;
+    }
+    if (strlen(ctx.ensembleFile) > 0) {
+      logError("scenario-file may not be combined with ensemble\n");
+      hasError = 1;
+    }
+    if (strlen(ctx.restartIn) > 0 || strlen(ctx.restartOut) > 0) {
+      logError("scenario-file may not be combined with restart-in or "
+               "restart-out\n");
+      hasError = 1;
+    }
+    if (strlen(ctx.checkpointEvery) > 0 || ctx.autoResume) {
+      logError("scenario-file may not be combined with checkpoint-every or "
+               "auto-resume\n");
+      hasError = 1;
+    }
+    if (strlen(ctx.debugLogPrefix) > 0) {
+      logError("scenario-file may not be combined with debug-log\n");
+      hasError = 1;
+    }
+    if (ctx.climateStream) {
+      logError("scenario-file may not be combined with climate-stream\n");
+      hasError = 1;
+    }
+  } else if (strlen(ctx.scenarioDate) > 0) {
+    logError("scenario-date requires scenario-file\n");
+    hasError = 1;
+  }
+
   if (hasError) {
     exit(EXIT_CODE_BAD_PARAMETER_VALUE);
   }
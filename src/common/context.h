@@ -9,6 +9,33 @@
 // For convenience
 #define FILENAME_MAXLEN CONTEXT_CHAR_MAXLEN
 #define FILENAME_PREFIX_MAXLEN (FILENAME_MAXLEN - 10)
+// Most ensemble members one thread runs together (see sipnet/lanes.h)
+#define MAX_ENSEMBLE_LANES 8
+// Values of outputFormat: text rows, or columnar binary with float64 or
+// float32 values (see sipnet/binaryOutput.h)
+#define OUTPUT_FORMAT_TEXT "text"
+#define OUTPUT_FORMAT_BINARY "binary"
+#define OUTPUT_FORMAT_BINARY32 "binary32"
+// NetCDF output, in builds with NetCDF support (see sipnet/netcdfOutput.h)
+#define OUTPUT_FORMAT_NETCDF "netcdf"
+// Highest deflate level for NetCDF output
+#define NETCDF_MAX_DEFLATE 9
+// Values of compressOutput: none, or gzip or zstd in builds with zlib or
+// libzstd (see sipnet/compressedOutput.h)
+#define COMPRESS_OUTPUT_NONE "none"
+#define COMPRESS_OUTPUT_GZIP "gzip"
+#define COMPRESS_OUTPUT_ZSTD "zstd"
+// Values of outputPeriod: every step, or rows aggregated by calendar period
+// (see sipnet/outputPeriod.h)
+// Values of restartFormat: by the file's extension, or always text or binary
+// (see sipnet/restart.h)
+#define RESTART_FORMAT_AUTO "auto"
+#define RESTART_FORMAT_TEXT "text"
+#define RESTART_FORMAT_BINARY "binary"
+#define OUTPUT_PERIOD_STEP "step"
+#define OUTPUT_PERIOD_DAY "day"
+#define OUTPUT_PERIOD_MONTH "month"
+#define OUTPUT_PERIOD_YEAR "year"
 
 #include <stdio.h>
 
@@ -36,7 +63,7 @@ struct context_metadata {
   UT_hash_handle hh;  // makes this structure hashable
 };
 
-#define NUM_CONTEXT_MODEL_FLAGS 12
+#define NUM_CONTEXT_MODEL_FLAGS 13
 // See docs/developer-guide/cli-options.md for details on how to add a new
 // Context entry
 struct Context {
@@ -54,6 +81,7 @@ struct Context {
   int anaerobic;
   int flooding;
   int carbonSaturation;
+  int analyticLight;
   // IF ADDING A NEW MODEL FLAG, update NUM_CONTEXT_MODEL_FLAGS above and
   // relevant code in restart.c
 
@@ -63,6 +91,10 @@ struct Context {
   int dumpConfig;
   int printHeader;
   int quiet;
+  int climateCache;
+  int climateStream;
+  int asyncOutput;
+  int autoResume;
 
   // Files
   char paramFile[CONTEXT_CHAR_MAXLEN];
@@ -76,10 +108,51 @@ struct Context {
   char restartIn[CONTEXT_CHAR_MAXLEN];
   char restartOut[CONTEXT_CHAR_MAXLEN];
   char debugLogPrefix[CONTEXT_CHAR_MAXLEN];
+  char ensembleFile[CONTEXT_CHAR_MAXLEN];
+  char scenarioFile[CONTEXT_CHAR_MAXLEN];
 
   // Other
   // File prefix for climate and param files
   char filePrefix[CONTEXT_CHAR_MAXLEN];
+  // Number of worker threads for ensemble runs; 0 means one per online CPU
+  int numThreads;
+  // Number of threads for parsing climate files; 0 means one per online CPU
+  int climateThreads;
+  // Number of ensemble members each thread runs together in lockstep
+  int numLanes;
+  // Format of the main output file, one of the OUTPUT_FORMAT_* values
+  char outputFormat[CONTEXT_CHAR_MAXLEN];
+  // Comma-separated names of the variables written to the main output and
+  // debug logs; empty for all of them
+  char outputVars[CONTEXT_CHAR_MAXLEN];
+  // Period the main output is aggregated over, one of the OUTPUT_PERIOD_*
+  // values
+  char outputPeriod[CONTEXT_CHAR_MAXLEN];
+  // Comma-separated names of the variables written to the single-variable
+  // output file with doSingleOutputs: registry names such as "trackers.gpp",
+  // or NEE, NEE_cum, GPP and GPP_cum; empty for those four
+  char singleOutputVars[CONTEXT_CHAR_MAXLEN];
+  // Deflate level for NetCDF output, 0 (none) to NETCDF_MAX_DEFLATE
+  int netcdfDeflate;
+  // NetCDF met file to read climate from, instead of <filePrefix>.clim; empty
+  // for none
+  char metFile[CONTEXT_CHAR_MAXLEN];
+  // Years of the met file to read: "first-last", or one year; empty for all
+  char metYears[CONTEXT_CHAR_MAXLEN];
+  // Compression of the main output, debug logs and events output, one of the
+  // COMPRESS_OUTPUT_* values
+  char compressOutput[CONTEXT_CHAR_MAXLEN];
+  // Format of restart-out checkpoints, one of the RESTART_FORMAT_* values
+  char restartFormat[CONTEXT_CHAR_MAXLEN];
+  // How often to write periodic checkpoints: "<n>years" or "<n>steps"; empty
+  // for never
+  char checkpointEvery[CONTEXT_CHAR_MAXLEN];
+  // Comma-separated <year>-<day> dates to write restart-out checkpoints after,
+  // in order; empty for one at the end of the run
+  char restartDates[CONTEXT_CHAR_MAXLEN];
+  // <year>-<day> date the scenario-file branches leave the baseline run, at
+  // its midnight
+  char scenarioDate[CONTEXT_CHAR_MAXLEN];
 
   // Temp space for handling command line flag args; we do not write directly
   // the params since we want to do a precedence check first. If the new source
@@ -125,6 +198,83 @@ char *getContextSourceString(context_source_t src);
 
 void validateFilename(void);
 
+// Nonzero if format is one of the OUTPUT_FORMAT_* values
+int isOutputFormat(const char *format);
+
+// Nonzero if method is one of the COMPRESS_OUTPUT_* values
+int isOutputCompression(const char *method);
+
+// Nonzero if format is one of the RESTART_FORMAT_* values
+int isRestartFormat(const char *format);
+
+// Nonzero if period is one of the OUTPUT_PERIOD_* values
+int isOutputPeriod(const char *period);
+
+/*!
+ * Parse a met-years value: "first-last", one year, or empty for all years
+ *
+ * @param years the value to parse
+ * @param firstYear set to the first year to read (INT_MIN for all)
+ * @param lastYear set to the last year to read (INT_MAX for all)
+ * @return nonzero if years is valid
+ */
+int parseMetYears(const char *years, int *firstYear, int *lastYear);
+
+/*!
+ * Parse a checkpoint-every value: a count followed directly by "years" or
+ * "steps" ("year" and "step" also do), e.g. "10years"; or empty for no
+ * periodic checkpoints
+ *
+ * @param every the value to parse
+ * @param count set to the count, or 0 for none
+ * @param inYears set to nonzero if the count is of years, zero for steps
+ * @return nonzero if every is valid
+ */
+int parseCheckpointEvery(const char *every, long *count, int *inYears);
+
+/*!
+ * Read the next date from a restart-dates value, "<year>-<day>[,...]"
+ *
+ * @param dates the value to read from
+ * @param pos offset in dates to read at; advanced past the date and its comma
+ * @param year set to the date's year
+ * @param day set to the date's day of year
+ * @return 1 if a date was read, 0 at the end of dates, or -1 if dates is
+ * invalid at pos
+ */
+int nextRestartDate(const char *dates, size_t *pos, int *year, int *day);
+
+// Number of dates in a restart-dates value, or -1 if it is invalid or they
+// aren't in ascending order
+int countRestartDates(const char *dates);
+
+/*!
+ * Expand a restart-out template for a checkpoint after the given day: %Y is
+ * the year, %j the zero-padded day of year and %% a percent sign; a path
+ * without these is copied as is
+ *
+ * @param path set to the expanded path
+ * @param size size of path
+ * @param restartOut the restart-out value
+ * @param year year of the checkpoint's boundary
+ * @param day day of year of the checkpoint's boundary
+ * @return nonzero on success, zero if restartOut has some other % conversion
+ * or the expanded path doesn't fit in size
+ */
+int formatRestartOut(char *path, size_t size, const char *restartOut, int year,
+                     int day);
+
+/*!
+ * Whether restart-out is a template for formatRestartOut() to expand: with
+ * restart-dates, or if it has %Y or %j in it. Any other path is used as it is,
+ * '%' and all.
+ */
+int isRestartOutTemplate(const char *restartOut, const char *restartDates);
+
+// Nonzero if name is listed in ctx.outputVars, or if that is empty (all
+// variables are written)
+int isOutputVar(const char *name);
+
 void validateContext(void);
 
 void printConfig(FILE *outFile);
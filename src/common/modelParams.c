@@ -6,6 +6,7 @@
 
 #include "exitCodes.h"
 #include "logging.h"
+#include "tokenizer.h"
 #include "util.h"
 
 // Private/helper functions: not defined in modelParams.h
@@ -124,8 +125,8 @@ void initializeOneModelParam(ModelParams *modelParams, char *name,
   modelParams->numParams++;
 }
 
-void checkParamFormat(char *line, const char *sep) {
-  int numParams = countFields(line, sep);
+void checkParamFormat(const char *line) {
+  int numParams = countTokens(line);
   if (numParams > 2) {
     logInfo("extra columns in .param file are being ignored (found %d "
             "columns)\n",
@@ -134,8 +135,6 @@ void checkParamFormat(char *line, const char *sep) {
 }
 
 void readModelParams(ModelParams *modelParams, FILE *paramFile) {
-  const char *SEPARATORS = " \t\n\r";  // characters that can separate values
-                                       // in parameter files
   const char *COMMENT_CHARS = "!";  // comment characters (ignore everything
                                     // after this on a line)
 
@@ -145,7 +144,7 @@ void readModelParams(ModelParams *modelParams, FILE *paramFile) {
   OneModelParam *param;  // a pointer to a single parameter, for easier access
   char strValue[32];  // before we know whether value is a number or "*"
   double value;
-  char *errc;
+  const char *curr;
   int isComment;
   char unknownParams[MODEL_PARAM_ERROR_BUFFER_SIZE] = {0};
   char hasUnknownParams = 0;
@@ -161,14 +160,18 @@ void readModelParams(ModelParams *modelParams, FILE *paramFile) {
     if (!isComment) {  // if this isn't just a comment line or blank line
       // Check for old spatial-param format and warn if appropriate
       if (!formatChecked) {
-        checkParamFormat(line, SEPARATORS);
+        checkParamFormat(line);
         formatChecked = 1;
       }
 
       // tokenize line:
-      strcpy(pName, strtok(line, SEPARATORS));  // copy first token into pName
+      curr = line;
+      scanToken(&curr, pName, sizeof(pName));  // copy first token into pName
 
-      strcpy(strValue, strtok(NULL, SEPARATORS));
+      if (!scanToken(&curr, strValue, sizeof(strValue))) {
+        logError("reading parameter %s; no value found\n", pName);
+        exit(EXIT_CODE_INPUT_FILE_ERROR);
+      }
 
       if (strcmp(strValue, "*") == 0) {
         // This used to mean "spatially varying" when sipnet supported multiple
@@ -176,7 +179,7 @@ void readModelParams(ModelParams *modelParams, FILE *paramFile) {
         logError("reading parameter %s; '*' is no longer supported\n", pName);
         exit(EXIT_CODE_BAD_PARAMETER_VALUE);
       }
-      value = strtod(strValue, &errc);
+      value = parseDouble(strValue, NULL);
       paramIndex = locateParam(modelParams, pName);
 
       if (paramIndex == -1) {  // not found
@@ -0,0 +1,288 @@
+/* Fast number formatting for output files; see numFormat.h
+*/
+
+#include "numFormat.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Most digits formatted directly; beyond this, rounding needs more than 52
+// bits of the scaled value
+#define MAX_FAST_PRECISION 15
+// Scaled values must stay below 2^52, so that their fractional part is exact
+// to at least half a unit
+#define MAX_FAST_SCALED 4503599627370496.0
+// Largest power of ten that is exactly a double
+#define MAX_EXACT_POW10 22
+// log10(2), for estimating decimal exponents from binary ones
+#define LOG10_2 0.30102999566398120
+// 2^27 + 1, for splitting a double into two halves that multiply exactly
+#define SPLITTER 134217729.0
+
+static const double POW10[MAX_EXACT_POW10 + 1] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+static const uint64_t INT_POW10[MAX_FAST_PRECISION + 1] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+    100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL,
+    1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+    1000000000000000ULL};
+
+// Exact product of a and b, as hi + lo (Dekker's algorithm); needs a and b
+// far enough from overflow and underflow, which the callers make sure of
+static void twoProduct(double a, double b, double *hi, double *lo) {
+  double t = SPLITTER * a;
+  double aHi = t - (t - a);
+  double aLo = a - aHi;
+  t = SPLITTER * b;
+  double bHi = t - (t - b);
+  double bLo = b - bHi;
+
+  *hi = a * b;
+  *lo = (((aHi * bHi - *hi) + aHi * bLo) + aLo * bHi) + aLo * bLo;
+}
+
+// mag * 10^scale, for |scale| <= MAX_EXACT_POW10, as hi + lo: hi is the
+// rounded result, and lo what is left over, less than half a unit of hi. When
+// multiplying, lo is exact; when dividing, only its sign is, which is all
+// roundNearest() needs.
+static void scaleByPow10(double mag, int scale, double *hi, double *lo) {
+  if (scale >= 0) {
+    twoProduct(mag, POW10[scale], hi, lo);
+  } else {
+    double divisor = POW10[-scale];
+    double quotient = mag / divisor;
+    double prodHi, prodLo;
+    // The remainder mag - quotient * divisor is exactly a double, and this
+    // computes it exactly
+    twoProduct(quotient, divisor, &prodHi, &prodLo);
+    *hi = quotient;
+    *lo = ((mag - prodHi) - prodLo) / divisor;
+  }
+}
+
+// Round hi + lo, as from scaleByPow10(), to the nearest integer, exact ties
+// going to even, as printf() does in the default rounding mode; hi must be
+// non-negative and below MAX_FAST_SCALED
+static uint64_t roundNearest(double hi, double lo) {
+  uint64_t n = (uint64_t)hi;
+  double frac = hi - (double)n;  // exact
+  double diff;
+
+  // With hi below 2^52, |lo| is at most 1/4, so hi + lo rounds down
+  if (frac < 0.25) {
+    return n;
+  }
+  // Exact, as frac is within a factor of two of 0.5. When it isn't zero, it is
+  // at least a unit of hi, so larger than |lo|, and decides by itself.
+  diff = frac - 0.5;
+  if ((diff > 0) || ((diff == 0) && ((lo > 0) || ((lo == 0) && (n & 1))))) {
+    return n + 1;
+  }
+  return n;
+}
+
+// Write the decimal digits of n into digits, least significant first, at
+// least minDigits of them (with leading zeros); returns the number written
+static int reversedDigits(uint64_t n, char *digits, int minDigits) {
+  int numDigits = 0;
+
+  do {
+    digits[numDigits++] = (char)('0' + n % 10);
+    n /= 10;
+  } while (n > 0);
+  while (numDigits < minDigits) {
+    digits[numDigits++] = '0';
+  }
+  return numDigits;
+}
+
+// Pad the len characters at start to width, as printf() does: on the left if
+// width is positive, on the right if negative; returns the new end
+static char *padField(char *start, int len, int width) {
+  if (width > len) {
+    memmove(start + width - len, start, len);
+    memset(start, ' ', width - len);
+    return start + width;
+  }
+  if (-width > len) {
+    memset(start + len, ' ', -width - len);
+    return start - width;
+  }
+  return start + len;
+}
+
+// Format with snprintf(), for the cases not handled directly
+static char *fallbackFixed(char *buf, double value, int width, int precision) {
+  int len = snprintf(buf, FORMAT_MAX_LEN, "%*.*f", width, precision, value);
+  return buf + len;
+}
+
+static char *fallbackGeneral(char *buf, double value, int precision) {
+  int len = snprintf(buf, FORMAT_MAX_LEN, "%.*g", precision, value);
+  return buf + len;
+}
+
+// See numFormat.h
+char *formatFixed(char *buf, double value, int width, int precision) {
+  double mag = fabs(value);
+  double hi, lo = 0;
+  char digits[MAX_FAST_PRECISION + 2];
+  int numDigits;
+  char *pos = buf;
+
+  if ((precision < 0) || (precision > MAX_FAST_PRECISION)) {
+    return fallbackFixed(buf, value, width, precision);
+  }
+  hi = mag * POW10[precision];
+  // Also catches inf and nan
+  if (!(hi < MAX_FAST_SCALED)) {
+    return fallbackFixed(buf, value, width, precision);
+  }
+  // Below 1/4, the value rounds down whatever lo is; skipping it there also
+  // keeps twoProduct() clear of underflow
+  if (hi >= 0.25) {
+    twoProduct(mag, POW10[precision], &hi, &lo);
+  }
+
+  numDigits = reversedDigits(roundNearest(hi, lo), digits, precision + 1);
+  if (signbit(value)) {
+    *pos++ = '-';
+  }
+  while (numDigits > precision) {
+    *pos++ = digits[--numDigits];
+  }
+  if (precision > 0) {
+    *pos++ = '.';
+    while (numDigits > 0) {
+      *pos++ = digits[--numDigits];
+    }
+  }
+
+  return padField(buf, (int)(pos - buf), width);
+}
+
+// See numFormat.h
+char *formatGeneral(char *buf, double value, int precision) {
+  double mag = fabs(value);
+  double hi, lo;
+  char digits[MAX_FAST_PRECISION + 1];
+  int binExp, exp10, scale, numDigits, numSig;
+  uint64_t n;
+  char *pos = buf;
+
+  if (value == 0) {
+    if (signbit(value)) {
+      *pos++ = '-';
+    }
+    *pos++ = '0';
+    return pos;
+  }
+  // Also catches inf and nan
+  if ((precision < 1) || (precision > MAX_FAST_PRECISION) || !isfinite(mag)) {
+    return fallbackGeneral(buf, value, precision);
+  }
+
+  // This estimate of the decimal exponent is exact or one too small
+  frexp(mag, &binExp);
+  exp10 = (int)floor((binExp - 1) * LOG10_2);
+  scale = precision - 1 - exp10;
+  // Digits that would take more than one power of ten to reach go to
+  // snprintf()
+  if (abs(scale) > MAX_EXACT_POW10) {
+    return fallbackGeneral(buf, value, precision);
+  }
+  scaleByPow10(mag, scale, &hi, &lo);
+  if (hi >= POW10[precision]) {
+    ++exp10;
+    if (--scale < -MAX_EXACT_POW10) {
+      return fallbackGeneral(buf, value, precision);
+    }
+    scaleByPow10(mag, scale, &hi, &lo);
+  }
+  n = roundNearest(hi, lo);
+  if (n == INT_POW10[precision]) {
+    // Rounded up to the next power of ten
+    n /= 10;
+    ++exp10;
+  }
+
+  numDigits = reversedDigits(n, digits, precision);
+  // Trailing zeros are dropped, which are at the start of digits
+  numSig = 0;
+  while ((numSig < numDigits - 1) && (digits[numSig] == '0')) {
+    ++numSig;
+  }
+
+  if (signbit(value)) {
+    *pos++ = '-';
+  }
+  if ((exp10 < -4) || (exp10 >= precision)) {
+    // Exponential notation; exponents here are all two digits
+    int absExp = abs(exp10);
+    *pos++ = digits[--numDigits];
+    if (numDigits > numSig) {
+      *pos++ = '.';
+      while (numDigits > numSig) {
+        *pos++ = digits[--numDigits];
+      }
+    }
+    *pos++ = 'e';
+    *pos++ = (exp10 < 0) ? '-' : '+';
+    *pos++ = (char)('0' + absExp / 10);
+    *pos++ = (char)('0' + absExp % 10);
+  } else if (exp10 >= 0) {
+    int numInt = exp10 + 1;
+    while (numInt-- > 0) {
+      *pos++ = digits[--numDigits];
+    }
+    if (numDigits > numSig) {
+      *pos++ = '.';
+      while (numDigits > numSig) {
+        *pos++ = digits[--numDigits];
+      }
+    }
+  } else {
+    *pos++ = '0';
+    *pos++ = '.';
+    for (int ind = -1; ind > exp10; --ind) {
+      *pos++ = '0';
+    }
+    while (numDigits > numSig) {
+      *pos++ = digits[--numDigits];
+    }
+  }
+
+  return pos;
+}
+
+// See numFormat.h
+char *formatInt(char *buf, int value, int width) {
+  char digits[12];
+  // Negate as unsigned, so INT_MIN works too
+  unsigned int mag =
+      (value < 0) ? 0U - (unsigned int)value : (unsigned int)value;
+  int numDigits = reversedDigits(mag, digits, 1);
+  char *pos = buf;
+
+  if (value < 0) {
+    *pos++ = '-';
+  }
+  while (numDigits > 0) {
+    *pos++ = digits[--numDigits];
+  }
+
+  return padField(buf, (int)(pos - buf), width);
+}
+
+// See numFormat.h
+char *formatString(char *buf, const char *str, int width) {
+  int len = (int)strlen(str);
+
+  memcpy(buf, str, len);
+  return padField(buf, len, width);
+}
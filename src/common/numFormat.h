@@ -0,0 +1,73 @@
+/* Fast number formatting for output files
+
+   These replace the printf family in the writers of the main output, the
+   debug logs and the events output, which format every value of every time
+   step. Each function writes exactly what the corresponding printf conversion
+   would, byte for byte, so output files are unchanged.
+
+   What is written is not '\0'-terminated; each function returns a pointer
+   just past the last character written, so that calls can be chained to build a
+   line in a buffer, which is then written with a single fwrite().
+*/
+
+#ifndef NUM_FORMAT_H
+#define NUM_FORMAT_H
+
+// Room a buffer needs for any one number, for widths of up to FORMAT_MAX_WIDTH
+// and precisions of up to FORMAT_MAX_PRECISION: a sign, the 309 integer digits
+// of DBL_MAX, a point and the decimals, and the '\0' that snprintf() adds
+#define FORMAT_MAX_WIDTH 32
+#define FORMAT_MAX_PRECISION 17
+#define FORMAT_MAX_LEN (1 + 309 + 1 + FORMAT_MAX_PRECISION + 1)
+
+/*!
+ * Write value as printf("%*.*f", width, precision, value) would
+ *
+ * Values are correctly rounded, with exact ties going to even, as glibc does.
+ * Values whose scaled digits don't fit in 52 bits, precisions over 15, and
+ * inf and nan are passed on to snprintf().
+ *
+ * @param buf where to write; needs room for FORMAT_MAX_LEN characters
+ * @param value value to write
+ * @param width minimum field width, padded on the left with spaces; a
+ * negative width pads on the right, like the '-' flag
+ * @param precision number of decimals, 0 to FORMAT_MAX_PRECISION
+ * @return pointer just past the last character written
+ */
+char *formatFixed(char *buf, double value, int width, int precision);
+
+/*!
+ * Write value as printf("%.*g", precision, value) would
+ *
+ * Values are formatted directly when their digits take a single exact power
+ * of ten to reach, which for 15 digits is magnitudes from about 1e-8 to 1e37.
+ * Anything else, and precisions over 15, are passed on to snprintf().
+ *
+ * @param buf where to write; needs room for FORMAT_MAX_LEN characters
+ * @param value value to write
+ * @param precision number of significant digits, 1 to FORMAT_MAX_PRECISION
+ * @return pointer just past the last character written
+ */
+char *formatGeneral(char *buf, double value, int precision);
+
+/*!
+ * Write value as printf("%*d", width, value) would
+ *
+ * @param buf where to write; needs room for FORMAT_MAX_WIDTH characters
+ * @param value value to write
+ * @param width minimum field width; negative pads on the right
+ * @return pointer just past the last character written
+ */
+char *formatInt(char *buf, int value, int width);
+
+/*!
+ * Write str as printf("%*s", width, str) would
+ *
+ * @param buf where to write; needs room for strlen(str) and width characters
+ * @param str string to write
+ * @param width minimum field width; negative pads on the right
+ * @return pointer just past the last character written
+ */
+char *formatString(char *buf, const char *str, int width);
+
+#endif
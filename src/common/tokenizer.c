@@ -0,0 +1,272 @@
+/* Fast line reading and tokenizing for input files; see tokenizer.h
+*/
+
+#include "tokenizer.h"
+
+#include <float.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "exitCodes.h"
+#include "logging.h"
+
+// Most significant digits that always fit in a uint64_t
+#define MAX_FAST_DIGITS 19
+// Largest integer for which every smaller integer is exactly a double (2^53)
+#define MAX_EXACT_MANTISSA (1ULL << 53)
+// Largest power of ten that is exactly a double
+#define MAX_EXACT_POW10 22
+
+static const double POW10[MAX_EXACT_POW10 + 1] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// These are run on every character of the input, so they are macros rather
+// than functions, to keep them fast in unoptimized builds too
+
+// Same set of characters as isspace() in the C locale
+#define IS_SPACE(c) \
+  (((c) == ' ') || ((unsigned char)((c) - '\t') <= '\r' - '\t'))
+#define IS_DIGIT(c) ((unsigned char)((c) - '0') <= 9)
+
+void initLineReader(LineReader *reader, FILE *in) {
+  initLineReaderRange(reader, in, SIZE_MAX);
+}
+
+void initLineReaderRange(LineReader *reader, FILE *in, size_t numBytes) {
+  reader->in = in;
+  reader->start = 0;
+  reader->end = 0;
+  reader->remaining = numBytes;
+  reader->eof = 0;
+  reader->offset = 0;
+}
+
+char *readLine(LineReader *reader) {
+  char *line;
+  char *newline;
+  size_t numRead;
+
+  while (1) {
+    line = reader->buf + reader->start;
+    newline = memchr(line, '\n', reader->end - reader->start);
+    if (newline != NULL) {
+      *newline = '\0';
+      reader->offset += newline + 1 - line;
+      reader->start = newline + 1 - reader->buf;
+      return line;
+    }
+
+    if (reader->eof) {
+      if (reader->start == reader->end) {
+        return NULL;
+      }
+      // Last line, with no newline
+      reader->buf[reader->end] = '\0';
+      reader->offset += reader->end - reader->start;
+      reader->start = reader->end;
+      return line;
+    }
+
+    // Move the partial line to the start of the buffer, and read more after it
+    memmove(reader->buf, line, reader->end - reader->start);
+    reader->end -= reader->start;
+    reader->start = 0;
+    if (reader->end == LINE_READER_BUF_SIZE) {
+      logError("input line longer than %d characters\n", LINE_READER_BUF_SIZE);
+      exit(EXIT_CODE_INPUT_FILE_ERROR);
+    }
+    numRead = LINE_READER_BUF_SIZE - reader->end;
+    if (numRead > reader->remaining) {
+      numRead = reader->remaining;
+    }
+    numRead = fread(reader->buf + reader->end, 1, numRead, reader->in);
+    if (numRead == 0) {
+      if (ferror(reader->in)) {
+        logError("error reading input file\n");
+        exit(EXIT_CODE_FILE_OPEN_OR_READ_ERROR);
+      }
+      reader->eof = 1;
+    }
+    reader->end += numRead;
+    reader->remaining -= numRead;
+  }
+}
+
+const char *skipSpace(const char *str) {
+  while (IS_SPACE(*str)) {
+    ++str;
+  }
+  return str;
+}
+
+int countTokens(const char *line) {
+  int numTokens = 0;
+
+  line = skipSpace(line);
+  while (*line != '\0') {
+    ++numTokens;
+    while ((*line != '\0') && !IS_SPACE(*line)) {
+      ++line;
+    }
+    line = skipSpace(line);
+  }
+
+  return numTokens;
+}
+
+double parseDouble(const char *str, char **end) {
+  const char *curr = str;
+  const char *digitsStart;
+  uint64_t mantissa = 0;
+  unsigned digit;
+  int numDigits = 0;  // significant digits in mantissa
+  int sawDigit;
+  int exponent = 0;
+  int negative = 0;
+  double value;
+
+  while (IS_SPACE(*curr)) {
+    ++curr;
+  }
+  if ((*curr == '+') || (*curr == '-')) {
+    negative = (*curr == '-');
+    ++curr;
+  }
+  // Leave hex to strtod
+  if ((curr[0] == '0') && ((curr[1] == 'x') || (curr[1] == 'X'))) {
+    return strtod(str, end);
+  }
+
+  // Integer part, then fractional part. Leading zeros aren't significant, so
+  // they don't count towards numDigits; mantissa may overflow once numDigits
+  // is past MAX_FAST_DIGITS, but then strtod is used instead.
+  digitsStart = curr;
+  while ((digit = (unsigned)(*curr - '0')) < 10) {
+    mantissa = mantissa * 10 + digit;
+    numDigits += (mantissa != 0);
+    ++curr;
+  }
+  sawDigit = (curr != digitsStart);
+  if (*curr == '.') {
+    digitsStart = ++curr;
+    while ((digit = (unsigned)(*curr - '0')) < 10) {
+      mantissa = mantissa * 10 + digit;
+      numDigits += (mantissa != 0);
+      ++curr;
+    }
+    exponent = -(int)(curr - digitsStart);
+    sawDigit = sawDigit || (curr != digitsStart);
+  }
+  if (!sawDigit) {
+    // No number here, or inf/nan
+    return strtod(str, end);
+  }
+  if (numDigits > MAX_FAST_DIGITS) {
+    return strtod(str, end);
+  }
+
+  // Exponent, only if there are digits after the 'e'
+  if ((*curr == 'e') || (*curr == 'E')) {
+    const char *expCurr = curr + 1;
+    int expNegative = 0;
+    int expValue = 0;
+    if ((*expCurr == '+') || (*expCurr == '-')) {
+      expNegative = (*expCurr == '-');
+      ++expCurr;
+    }
+    if (IS_DIGIT(*expCurr)) {
+      for (; IS_DIGIT(*expCurr); ++expCurr) {
+        if (expValue < 100000) {
+          expValue = expValue * 10 + (*expCurr - '0');
+        }
+      }
+      exponent += expNegative ? -expValue : expValue;
+      curr = expCurr;
+    }
+  }
+
+  // mantissa and 10^|exponent| are both exact doubles here, so one multiply
+  // or divide gives the correctly rounded result, as strtod does. This needs
+  // double arithmetic to be done in double precision.
+  if (mantissa == 0) {
+    value = 0.0;
+  } else if ((FLT_EVAL_METHOD == 0) && (mantissa <= MAX_EXACT_MANTISSA) &&
+             (exponent >= -MAX_EXACT_POW10) && (exponent <= MAX_EXACT_POW10)) {
+    if (exponent < 0) {
+      value = (double)mantissa / POW10[-exponent];
+    } else {
+      value = (double)mantissa * POW10[exponent];
+    }
+  } else {
+    return strtod(str, end);
+  }
+
+  if (end != NULL) {
+    *end = (char *)curr;
+  }
+  return negative ? -value : value;
+}
+
+int scanDouble(const char **str, double *value) {
+  char *end;
+  double parsed = parseDouble(*str, &end);
+
+  if (end == *str) {
+    return 0;
+  }
+  *value = parsed;
+  *str = end;
+  return 1;
+}
+
+int scanInt(const char **str, int *value) {
+  const char *curr = skipSpace(*str);
+  long long parsed = 0;
+  int negative = 0;
+
+  if ((*curr == '+') || (*curr == '-')) {
+    negative = (*curr == '-');
+    ++curr;
+  }
+  if (!IS_DIGIT(*curr)) {
+    return 0;
+  }
+  for (; IS_DIGIT(*curr); ++curr) {
+    if (parsed <= INT_MAX) {
+      parsed = parsed * 10 + (*curr - '0');
+    }
+  }
+  if (negative) {
+    parsed = -parsed;
+  }
+
+  if (parsed > INT_MAX) {
+    *value = INT_MAX;
+  } else if (parsed < INT_MIN) {
+    *value = INT_MIN;
+  } else {
+    *value = (int)parsed;
+  }
+  *str = curr;
+  return 1;
+}
+
+int scanToken(const char **str, char *buf, size_t bufSize) {
+  const char *curr = skipSpace(*str);
+  size_t len = 0;
+
+  if (*curr == '\0') {
+    return 0;
+  }
+  for (; (*curr != '\0') && !IS_SPACE(*curr); ++curr) {
+    if (len + 1 < bufSize) {
+      buf[len++] = *curr;
+    }
+  }
+  buf[len] = '\0';
+  *str = curr;
+  return 1;
+}
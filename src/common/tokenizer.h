@@ -0,0 +1,97 @@
+/* Fast line reading and tokenizing for input files
+
+   These replace the stdio scanf family (and strtok/strtod) in the input file
+   readers. Nothing here allocates memory: lines are read into a fixed buffer
+   owned by the caller, and tokens are parsed in place.
+
+   The scan functions behave like the corresponding scanf conversions: each
+   skips leading whitespace, then converts as much of the input as it can, so
+   that a sequence of them reads a line the same way a scanf format string
+   would.
+*/
+
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+// Size of the buffer in a LineReader, and so the longest line it can read
+#define LINE_READER_BUF_SIZE 65536
+
+// Buffered reader that hands out one line of a file at a time
+typedef struct LineReader {
+  FILE *in;
+  char buf[LINE_READER_BUF_SIZE + 1];  // + 1 for the terminating '\0'
+  size_t start;  // start of unread data in buf
+  size_t end;  // end of data in buf
+  size_t remaining;  // bytes left to read from in
+  int eof;  // whether all of the input has been read into buf
+  long offset;  // bytes of input handed out (as lines) so far
+} LineReader;
+
+// Start reading lines from in, which must be open for reading, from its
+// current position to end of file
+void initLineReader(LineReader *reader, FILE *in);
+
+// Start reading lines from in, from its current position, stopping after
+// numBytes bytes
+void initLineReaderRange(LineReader *reader, FILE *in, size_t numBytes);
+
+/*!
+ * Read the next line
+ *
+ * Exits with an error if the line is longer than LINE_READER_BUF_SIZE.
+ *
+ * @return the line, without its newline; it is modified in place, and only
+ * valid until the next call. NULL at end of file.
+ */
+char *readLine(LineReader *reader);
+
+// Return a pointer to the first non-whitespace character in str
+const char *skipSpace(const char *str);
+
+// Return the number of whitespace-separated tokens in line
+int countTokens(const char *line);
+
+/*!
+ * Convert the start of str to a double, exactly as strtod() would
+ *
+ * Plain decimal numbers of up to 19 significant digits, which is everything
+ * in our input files, are converted directly; anything else (hex, inf, nan,
+ * very long or very large numbers) is passed on to strtod().
+ *
+ * @param str string to convert
+ * @param end if not NULL, set to the first character after the number, or to
+ * str if there is no number
+ * @return the value, or 0 if there is no number
+ */
+double parseDouble(const char *str, char **end);
+
+/*!
+ * Read a double from *str, like scanf("%lf")
+ *
+ * @return 1 if a number was read (and *str moved past it), 0 otherwise
+ */
+int scanDouble(const char **str, double *value);
+
+/*!
+ * Read a decimal integer from *str, like scanf("%d")
+ *
+ * Values out of range are clamped to INT_MIN or INT_MAX.
+ *
+ * @return 1 if a number was read (and *str moved past it), 0 otherwise
+ */
+int scanInt(const char **str, int *value);
+
+/*!
+ * Read a whitespace-delimited token from *str, like scanf("%s")
+ *
+ * The token is truncated if it doesn't fit in buf, but *str is always moved
+ * past all of it.
+ *
+ * @return 1 if a token was read, 0 if only whitespace was left
+ */
+int scanToken(const char **str, char *buf, size_t bufSize);
+
+#endif
@@ -10,6 +10,7 @@
 #include <string.h>
 #include <ctype.h>
 #include <errno.h>
+#include <float.h>
 
 #include "exitCodes.h"
 #include "logging.h"
@@ -48,30 +49,62 @@ int stripComment(char *line, const char *commentChars) {
   return (lenTrim == 0);
 }
 
-// count number of fields in a string separated by delimiter 'sep'
-int countFields(const char *line, const char *sep) {
-  // strtok modifies string, so we need a copy
-  size_t lineLen = strlen(line);
-  char *lineCopy = (char *)malloc(lineLen + 1);
-  if (lineCopy == NULL) {
-    logError("memory allocation failure in file processing\n");
-    exit(EXIT_CODE_INTERNAL_ERROR);
+double calcRatio(const double num, const double den) {
+  const double effectiveDen = den < TINY ? TINY : den;
+  return num / effectiveDen;
+}
+
+// Euler-Mascheroni constant
+#define EULER_GAMMA 0.57721566490153286061
+// Relative size of the last term (or factor) at which to stop a series
+#define SERIES_EPS 1e-17
+// Iterations after which to give up; no series here needs more than ~40
+#define SERIES_MAX_ITER 100
+
+double expIntEin(double x) {
+  if (x > 1.0) {
+    return EULER_GAMMA + log(x) + expIntE1(x);
   }
-  strcpy(lineCopy, line);
 
-  int numParams = 0;
-  char *par = strtok(lineCopy, sep);
-  while (par != NULL) {
-    ++numParams;
-    par = strtok(NULL, sep);
+  // Power series, from Abramowitz & Stegun 5.1.11:
+  //   Ein(x) = sum_{k>=1} (-1)^(k+1) x^k / (k * k!)
+  double sum = 0.0;
+  double term = -1.0;  // (-1)^(k+1) x^k / k!
+  for (int k = 1; k <= SERIES_MAX_ITER; ++k) {
+    term *= -x / k;
+    double delta = term / k;
+    sum += delta;
+    if (fabs(delta) <= SERIES_EPS * fabs(sum)) {
+      break;
+    }
   }
-  free(lineCopy);
-  return numParams;
+  return sum;
 }
 
-double calcRatio(const double num, const double den) {
-  const double effectiveDen = den < TINY ? TINY : den;
-  return num / effectiveDen;
+double expIntE1(double x) {
+  if (x <= 1.0) {
+    return -EULER_GAMMA - log(x) + expIntEin(x);
+  }
+
+  // Continued fraction, evaluated with the modified Lentz method (Numerical
+  // Recipes 6.3):
+  //   E1(x) = exp(-x) * (1/(x+1-) 1/(x+3-) 4/(x+5-) 9/(x+7-) ...)
+  double b = x + 1.0;
+  double c = 1.0 / DBL_MIN;
+  double d = 1.0 / b;
+  double h = d;
+  for (int i = 1; i <= SERIES_MAX_ITER; ++i) {
+    double a = -(double)i * i;
+    b += 2.0;
+    d = 1.0 / (a * d + b);
+    c = b + a / c;
+    double delta = c * d;
+    h *= delta;
+    if (fabs(delta - 1.0) <= SERIES_EPS) {
+      break;
+    }
+  }
+  return h * exp(-x);
 }
 
 // For global linkage
@@ -22,13 +22,33 @@ FILE *openFile(const char *name, const char *mode);
 // Return 1 if line contains only a comment (or only blanks), 0 otherwise
 int stripComment(char *line, const char *commentChars);
 
-int countFields(const char *line, const char *sep);
-
 /**
  * Calculate the ratio of the inputs safely
  */
 double calcRatio(double num, double den);
 
+/**
+ * Exponential integral E1(x) = integral from x to infinity of exp(-t)/t dt
+ *
+ * Accurate to a few units in the last place.
+ *
+ * @param x Argument; must be positive
+ * @return E1(x)
+ */
+double expIntE1(double x);
+
+/**
+ * Entire exponential integral Ein(x) = integral from 0 to x of
+ * (1 - exp(-t))/t dt, which equals E1(x) + ln(x) + gamma
+ *
+ * Unlike E1, this is finite and smooth at 0. Accurate to a few units in the
+ * last place.
+ *
+ * @param x Argument; must be non-negative
+ * @return Ein(x)
+ */
+double expIntEin(double x);
+
 /**
  * Clips input double to [0,1]
  *
@@ -0,0 +1,181 @@
+// Output rows written on a separate thread; see asyncOutput.h
+
+#include "asyncOutput.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "common/exitCodes.h"
+#include "common/logging.h"
+
+// A queued row: who writes it, followed by its values
+typedef struct AsyncRecord {
+  AsyncRowWriter writer;
+  void *target;
+  const void *layout;
+  int numValues;
+} AsyncRecord;
+
+// Space a record takes in a buffer, keeping the next one aligned for doubles
+#define RECORD_HEADER_SIZE                                                     \
+  ((sizeof(AsyncRecord) + sizeof(double) - 1) / sizeof(double) *              \
+   sizeof(double))
+#define RECORD_SIZE(numValues)                                                 \
+  (RECORD_HEADER_SIZE + (size_t)(numValues) * sizeof(double))
+
+typedef struct AsyncBuffer {
+  char *data;
+  size_t used;
+} AsyncBuffer;
+
+struct AsyncOutput {
+  AsyncBuffer buffers[ASYNC_OUTPUT_BUFFERS];
+  pthread_t writer;
+  pthread_mutex_t lock;
+  pthread_cond_t bufferFilled;  // signaled when a buffer is handed over
+  pthread_cond_t bufferWritten;  // signaled when the writer frees a buffer
+  // Buffers handed to the writer are writeIndex, writeIndex + 1, ... (mod
+  // ASYNC_OUTPUT_BUFFERS), numQueued of them, including the one being written;
+  // the model thread fills the one after those
+  int writeIndex;
+  int numQueued;
+  int fillIndex;
+  int stop;
+};
+
+// Write every record in a buffer, in order
+static void writeBuffer(AsyncBuffer *buffer) {
+  size_t pos = 0;
+
+  while (pos < buffer->used) {
+    AsyncRecord *record = (AsyncRecord *)(buffer->data + pos);
+    const double *values =
+        (const double *)(buffer->data + pos + RECORD_HEADER_SIZE);
+    record->writer(record->target, record->layout, values, record->numValues);
+    pos += RECORD_SIZE(record->numValues);
+  }
+  buffer->used = 0;
+}
+
+static void *asyncOutputWriter(void *arg) {
+  AsyncOutput *async = (AsyncOutput *)arg;
+
+  pthread_mutex_lock(&async->lock);
+  while (1) {
+    while ((async->numQueued == 0) && !async->stop) {
+      pthread_cond_wait(&async->bufferFilled, &async->lock);
+    }
+    if (async->numQueued == 0) {
+      break;
+    }
+    AsyncBuffer *buffer = &async->buffers[async->writeIndex];
+    // The model thread doesn't touch queued buffers, so this one can be
+    // written without the lock
+    pthread_mutex_unlock(&async->lock);
+    writeBuffer(buffer);
+    pthread_mutex_lock(&async->lock);
+    async->writeIndex = (async->writeIndex + 1) % ASYNC_OUTPUT_BUFFERS;
+    --async->numQueued;
+    pthread_cond_broadcast(&async->bufferWritten);
+  }
+  pthread_mutex_unlock(&async->lock);
+
+  return NULL;
+}
+
+// Hand the buffer being filled to the writer, and move on to the next one,
+// waiting for it to be written if the ring is full
+static void handOffBuffer(AsyncOutput *async) {
+  pthread_mutex_lock(&async->lock);
+  ++async->numQueued;
+  pthread_cond_signal(&async->bufferFilled);
+  while (async->numQueued == ASYNC_OUTPUT_BUFFERS) {
+    pthread_cond_wait(&async->bufferWritten, &async->lock);
+  }
+  async->fillIndex =
+      (async->writeIndex + async->numQueued) % ASYNC_OUTPUT_BUFFERS;
+  pthread_mutex_unlock(&async->lock);
+}
+
+// See asyncOutput.h
+AsyncOutput *newAsyncOutput(void) {
+  AsyncOutput *async = (AsyncOutput *)calloc(1, sizeof(AsyncOutput));
+  if (async == NULL) {
+    logError("memory allocation failure starting asynchronous output\n");
+    exit(EXIT_CODE_INTERNAL_ERROR);
+  }
+  for (int ind = 0; ind < ASYNC_OUTPUT_BUFFERS; ++ind) {
+    async->buffers[ind].data = (char *)malloc(ASYNC_OUTPUT_BUFFER_SIZE);
+    if (async->buffers[ind].data == NULL) {
+      logError("memory allocation failure starting asynchronous output\n");
+      exit(EXIT_CODE_INTERNAL_ERROR);
+    }
+  }
+  pthread_mutex_init(&async->lock, NULL);
+  pthread_cond_init(&async->bufferFilled, NULL);
+  pthread_cond_init(&async->bufferWritten, NULL);
+
+  if (pthread_create(&async->writer, NULL, asyncOutputWriter, async) != 0) {
+    logError("unable to start asynchronous output thread\n");
+    exit(EXIT_CODE_INTERNAL_ERROR);
+  }
+
+  return async;
+}
+
+// See asyncOutput.h
+double *reserveAsyncRow(AsyncOutput *async, AsyncRowWriter writer,
+                        void *target, const void *layout, int numValues) {
+  size_t size = RECORD_SIZE(numValues);
+  AsyncBuffer *buffer = &async->buffers[async->fillIndex];
+
+  if (size > ASYNC_OUTPUT_BUFFER_SIZE) {
+    logError("output row of %d values is too large for asynchronous output\n",
+             numValues);
+    exit(EXIT_CODE_INTERNAL_ERROR);
+  }
+  if (buffer->used + size > ASYNC_OUTPUT_BUFFER_SIZE) {
+    handOffBuffer(async);
+    buffer = &async->buffers[async->fillIndex];
+  }
+
+  AsyncRecord *record = (AsyncRecord *)(buffer->data + buffer->used);
+  record->writer = writer;
+  record->target = target;
+  record->layout = layout;
+  record->numValues = numValues;
+  buffer->used += size;
+
+  return (double *)((char *)record + RECORD_HEADER_SIZE);
+}
+
+// See asyncOutput.h
+void drainAsyncOutput(AsyncOutput *async) {
+  if (async->buffers[async->fillIndex].used > 0) {
+    handOffBuffer(async);
+  }
+  pthread_mutex_lock(&async->lock);
+  while (async->numQueued > 0) {
+    pthread_cond_wait(&async->bufferWritten, &async->lock);
+  }
+  pthread_mutex_unlock(&async->lock);
+}
+
+// See asyncOutput.h
+void deleteAsyncOutput(AsyncOutput *async) {
+  drainAsyncOutput(async);
+
+  pthread_mutex_lock(&async->lock);
+  async->stop = 1;
+  pthread_cond_signal(&async->bufferFilled);
+  pthread_mutex_unlock(&async->lock);
+  pthread_join(async->writer, NULL);
+
+  for (int ind = 0; ind < ASYNC_OUTPUT_BUFFERS; ++ind) {
+    free(async->buffers[ind].data);
+  }
+  pthread_mutex_destroy(&async->lock);
+  pthread_cond_destroy(&async->bufferFilled);
+  pthread_cond_destroy(&async->bufferWritten);
+  free(async);
+}
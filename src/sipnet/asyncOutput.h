@@ -0,0 +1,73 @@
+// header file for asyncOutput.c: writing output rows on a separate thread
+//
+// With asynchronous output, the model thread only copies the values of each
+// output row into a ring of preallocated buffers; a writer thread formats
+// them and writes them to their files. The model thread waits only when every
+// buffer is full, so slow or stalling storage holds up the model loop only
+// once it has fallen a whole ring behind.
+//
+// Rows are written in the order they were queued. The formatting functions
+// are the same ones used for synchronous output, so the files are the same
+// either way.
+
+#ifndef ASYNC_OUTPUT_H
+#define ASYNC_OUTPUT_H
+
+// Number of buffers in the ring, and the size of each in bytes; a row of the
+// main output takes about 300 bytes, and one of all the debug logs about 900
+#define ASYNC_OUTPUT_BUFFERS 4
+#define ASYNC_OUTPUT_BUFFER_SIZE (64 * 1024)
+
+/*!
+ * Formats and writes one row, from its captured values
+ *
+ * Runs on the writer thread for queued rows, or directly on the model thread
+ * for synchronous output.
+ *
+ * @param target where the row goes (a file, or an output writer)
+ * @param layout how the values are laid out, if the writer needs it
+ * @param values the row's values
+ * @param numValues number of values
+ */
+typedef void (*AsyncRowWriter)(void *target, const void *layout,
+                               const double *values, int numValues);
+
+typedef struct AsyncOutput AsyncOutput;
+
+/*!
+ * Allocate the ring of buffers and start the writer thread
+ *
+ * @return new AsyncOutput; exits if the thread can't be started
+ */
+AsyncOutput *newAsyncOutput(void);
+
+/*!
+ * Reserve space for a row in the ring
+ *
+ * The caller fills in the values before the next call to any function here;
+ * the writer thread then calls writer(target, layout, values, numValues).
+ * Waits if the ring is full.
+ *
+ * @param writer function that will write the row
+ * @param target passed to writer; must stay valid until the row is written
+ * @param layout passed to writer; must stay valid until the row is written
+ * @param numValues number of values in the row
+ * @return space for numValues values
+ */
+double *reserveAsyncRow(AsyncOutput *async, AsyncRowWriter writer,
+                        void *target, const void *layout, int numValues);
+
+/*!
+ * Wait until every queued row has been written
+ *
+ * Call this before closing, or writing directly to, any file that rows have
+ * been queued for.
+ */
+void drainAsyncOutput(AsyncOutput *async);
+
+/*!
+ * Write any queued rows, stop the writer thread and free the AsyncOutput
+ */
+void deleteAsyncOutput(AsyncOutput *async);
+
+#endif  // ASYNC_OUTPUT_H
@@ -5,162 +5,179 @@
 #include "common/context.h"
 #include "common/exitCodes.h"
 #include "common/logging.h"
-#include "state.h"
+#include "model.h"
 
-// Definition of global balance tracker struct
-BalanceTracker balanceTracker;
-
-void getMassTotals(double *carbon, double *nitrogen) {
-  *carbon = (envi.plantWoodC + envi.plantCAccountingDelta) + envi.plantLeafC +
-            envi.fineRootC + envi.coarseRootC + envi.soilC;
+void getMassTotals(SipnetModel *model, double *carbon, double *nitrogen) {
+  *carbon = (model->envi.plantWoodC + model->envi.plantCAccountingDelta) +
+            model->envi.plantLeafC + model->envi.fineRootC +
+            model->envi.coarseRootC + model->envi.soilC;
   if (ctx.litterPool) {
-    *carbon += envi.litterC;
+    *carbon += model->envi.litterC;
   }
 
   if (ctx.nitrogenCycle) {
     // Note: this is the one place where we use plantWoodC by itself; it's the
     // reason plantCAccountingDelta was created, so that we can ignore it here.
-    *nitrogen =
-        envi.plantWoodC / params.woodCN + envi.plantLeafC / params.leafCN +
-        envi.fineRootC / params.fineRootCN + envi.coarseRootC / params.woodCN +
-        envi.soilOrgN + envi.litterN + envi.minN + envi.plantStorageN;
+    *nitrogen = model->envi.plantWoodC / model->params.woodCN +
+                model->envi.plantLeafC / model->params.leafCN +
+                model->envi.fineRootC / model->params.fineRootCN +
+                model->envi.coarseRootC / model->params.woodCN +
+                model->envi.soilOrgN + model->envi.litterN + model->envi.minN +
+                model->envi.plantStorageN;
   } else {
     *nitrogen = 0.0;
   }
 }
 
-void updateBalanceTrackerPreUpdate(void) {
+void updateBalanceTrackerPreUpdate(SipnetModel *model) {
   // Set the pre-update pool totals
-  getMassTotals(&balanceTracker.preTotalC, &balanceTracker.preTotalN);
+  getMassTotals(model, &model->balanceTracker.preTotalC,
+                &model->balanceTracker.preTotalN);
 }
 
-void updateBalanceTrackerPostUpdate(void) {
+void updateBalanceTrackerPostUpdate(SipnetModel *model) {
   // Set the post-update pool totals
-  getMassTotals(&balanceTracker.postTotalC, &balanceTracker.postTotalN);
+  getMassTotals(model, &model->balanceTracker.postTotalC,
+                &model->balanceTracker.postTotalN);
 }
 
-void updateBalanceTrackerPostClamp(void) {
-  getMassTotals(&balanceTracker.finalC, &balanceTracker.finalN);
+void updateBalanceTrackerPostClamp(SipnetModel *model) {
+  getMassTotals(model, &model->balanceTracker.finalC,
+                &model->balanceTracker.finalN);
 
   // Difference between post-update and post-clamp is the amount we "gained" by
   // setting negative values to zero
-  balanceTracker.clampedC = balanceTracker.finalC - balanceTracker.postTotalC;
-  if (balanceTracker.clampedC < -EPS) {
+  model->balanceTracker.clampedC = model->balanceTracker.finalC -
+                                   model->balanceTracker.postTotalC;
+  if (model->balanceTracker.clampedC < -EPS) {
     // This shouldn't happen, by construction
     logInternalError("Non-negative clamping has cause carbon loss\n");
   }
-  if (balanceTracker.clampedC < EPS) {
-    balanceTracker.clampedC = 0;
+  if (model->balanceTracker.clampedC < EPS) {
+    model->balanceTracker.clampedC = 0;
   }
 
-  balanceTracker.clampedN = balanceTracker.finalN - balanceTracker.postTotalN;
-  if (balanceTracker.clampedN < -EPS) {
+  model->balanceTracker.clampedN = model->balanceTracker.finalN -
+                                   model->balanceTracker.postTotalN;
+  if (model->balanceTracker.clampedN < -EPS) {
     // This shouldn't happen, by construction
     logInternalError("Non-negative clamping has cause nitrogen loss\n");
   }
-  if (balanceTracker.clampedN < EPS) {
-    balanceTracker.clampedN = 0;
+  if (model->balanceTracker.clampedN < EPS) {
+    model->balanceTracker.clampedN = 0;
   }
 
   // Calculate the system inputs and outputs
   // CARBON
-  balanceTracker.inputsC = fluxes.photosynthesis +  // GPP
-                           fluxes.eventInputC;  // agro event additions
-  balanceTracker.outputsC = fluxes.rVeg + fluxes.rFineRoot +
-                            fluxes.rCoarseRoot +  // R_a
-                            fluxes.rSoil +  // R_h
-                            fluxes.soilMethane +  // methane
-                            fluxes.eventOutputC;  // agro event removals
+  model->balanceTracker.inputsC =
+      model->fluxes.photosynthesis +  // GPP
+      model->fluxes.eventInputC;  // agro event additions
+  model->balanceTracker.outputsC =
+      model->fluxes.rVeg + model->fluxes.rFineRoot +
+      model->fluxes.rCoarseRoot +  // R_a
+      model->fluxes.rSoil +  // R_h
+      model->fluxes.soilMethane +  // methane
+      model->fluxes.eventOutputC;  // agro event removals
   if (ctx.litterPool) {
-    balanceTracker.outputsC += fluxes.rLitter + fluxes.litterMethane;
+    model->balanceTracker.outputsC += model->fluxes.rLitter +
+                                      model->fluxes.litterMethane;
   }
   // Account for climate length
-  balanceTracker.inputsC *= climate->length;
-  balanceTracker.outputsC *= climate->length;
+  model->balanceTracker.inputsC *= model->climate->length;
+  model->balanceTracker.outputsC *= model->climate->length;
 
   // NITROGEN
   if (ctx.nitrogenCycle) {
-    balanceTracker.inputsN = fluxes.nFixation + fluxes.eventInputN;
-    balanceTracker.outputsN =
-        fluxes.nLeaching + fluxes.nVolatilization + fluxes.eventOutputN;
+    model->balanceTracker.inputsN = model->fluxes.nFixation +
+                                    model->fluxes.eventInputN;
+    model->balanceTracker.outputsN = model->fluxes.nLeaching +
+                                     model->fluxes.nVolatilization +
+                                     model->fluxes.eventOutputN;
 
     // Account for climate length
-    balanceTracker.inputsN *= climate->length;
-    balanceTracker.outputsN *= climate->length;
+    model->balanceTracker.inputsN *= model->climate->length;
+    model->balanceTracker.outputsN *= model->climate->length;
   }
 
   // Account for gains from clamping
-  balanceTracker.inputsC += balanceTracker.clampedC;
+  model->balanceTracker.inputsC += model->balanceTracker.clampedC;
   if (ctx.nitrogenCycle) {
-    balanceTracker.inputsN += balanceTracker.clampedN;
+    model->balanceTracker.inputsN += model->balanceTracker.clampedN;
   }
 }
 
-void initBalanceTracker(void) {
+void initBalanceTracker(SipnetModel *model) {
   // Initialize all to zero
   // Pools
-  balanceTracker.preTotalC = 0.0;
-  balanceTracker.postTotalC = 0.0;
-  balanceTracker.clampedC = 0.0;
-  balanceTracker.finalC = 0.0;
-  balanceTracker.preTotalN = 0.0;
-  balanceTracker.postTotalN = 0.0;
-  balanceTracker.clampedN = 0.0;
-  balanceTracker.finalN = 0.0;
+  model->balanceTracker.preTotalC = 0.0;
+  model->balanceTracker.postTotalC = 0.0;
+  model->balanceTracker.clampedC = 0.0;
+  model->balanceTracker.finalC = 0.0;
+  model->balanceTracker.preTotalN = 0.0;
+  model->balanceTracker.postTotalN = 0.0;
+  model->balanceTracker.clampedN = 0.0;
+  model->balanceTracker.finalN = 0.0;
 
   // System I/O
-  balanceTracker.inputsC = 0.0;
-  balanceTracker.outputsC = 0.0;
-  balanceTracker.inputsN = 0.0;
-  balanceTracker.outputsN = 0.0;
+  model->balanceTracker.inputsC = 0.0;
+  model->balanceTracker.outputsC = 0.0;
+  model->balanceTracker.inputsN = 0.0;
+  model->balanceTracker.outputsN = 0.0;
 
   // Checks
-  balanceTracker.deltaC = 0.0;
-  balanceTracker.deltaN = 0.0;
+  model->balanceTracker.deltaC = 0.0;
+  model->balanceTracker.deltaN = 0.0;
 }
 
-void checkBalance(void) {
+void checkBalance(SipnetModel *model) {
   // CARBON
   // Pool delta
-  double poolCDelta = balanceTracker.finalC - balanceTracker.preTotalC;
+  double poolCDelta = model->balanceTracker.finalC -
+                      model->balanceTracker.preTotalC;
   // System delta
-  double systemCDelta = balanceTracker.inputsC - balanceTracker.outputsC;
-  balanceTracker.deltaC = poolCDelta - systemCDelta;
+  double systemCDelta = model->balanceTracker.inputsC -
+                        model->balanceTracker.outputsC;
+  model->balanceTracker.deltaC = poolCDelta - systemCDelta;
 
   // NITROGEN
   // Pool delta
-  double poolNDelta = balanceTracker.finalN - balanceTracker.preTotalN;
+  double poolNDelta = model->balanceTracker.finalN -
+                      model->balanceTracker.preTotalN;
   // System delta
-  double systemNDelta = balanceTracker.outputsN - balanceTracker.inputsN;
-  balanceTracker.deltaN = poolNDelta + systemNDelta;
+  double systemNDelta = model->balanceTracker.outputsN -
+                        model->balanceTracker.inputsN;
+  model->balanceTracker.deltaN = poolNDelta + systemNDelta;
 
   // To avoid weird negative-zero issues...
-  if (fabs(balanceTracker.deltaC) < EPS) {
-    balanceTracker.deltaC = 0.0;
+  if (fabs(model->balanceTracker.deltaC) < EPS) {
+    model->balanceTracker.deltaC = 0.0;
   }
-  if (fabs(balanceTracker.deltaN) < EPS) {
-    balanceTracker.deltaN = 0.0;
+  if (fabs(model->balanceTracker.deltaN) < EPS) {
+    model->balanceTracker.deltaN = 0.0;
   }
 
   int err = 0;
-  if (fabs(balanceTracker.deltaC) > 0.0) {
+  if (fabs(model->balanceTracker.deltaC) > 0.0) {
     // err = 1;
     //  logInternalError(  someday
     logWarning(
         "Carbon balance check failed (delta=%.6f, Y: %d D: %d T: %4.2f)\n",
-        balanceTracker.deltaC, climate->year, climate->day, climate->time);
+        model->balanceTracker.deltaC, model->climate->year, model->climate->day,
+        model->climate->time);
   }
-  if (fabs(balanceTracker.deltaN) > 0.0) {
+  if (fabs(model->balanceTracker.deltaN) > 0.0) {
     // err = 1;
     // logInternalError(  someday
     logWarning(
         "Nitrogen balance check failed (delta=%.6f, Y: %d D: %d T: %4.2f)\n",
-        balanceTracker.deltaN, climate->year, climate->day, climate->time);
+        model->balanceTracker.deltaN, model->climate->year, model->climate->day,
+        model->climate->time);
     logWarning("preTot %.7f postTot %.7f input %.7f output %.7f clamped "
                "%.7f delta %.7f\n",
-               balanceTracker.preTotalN, balanceTracker.postTotalN,
-               balanceTracker.inputsN, balanceTracker.outputsN,
-               balanceTracker.clampedN, balanceTracker.deltaN);
+               model->balanceTracker.preTotalN,
+               model->balanceTracker.postTotalN,
+               model->balanceTracker.inputsN, model->balanceTracker.outputsN,
+               model->balanceTracker.clampedN, model->balanceTracker.deltaN);
   }
   if (err) {
     logInternalError("Exiting\n");
@@ -5,6 +5,9 @@
 // Differences smaller than this are treated as numerical noise.
 #define EPS 1e-8
 
+// Model instance holding all run state; defined in model.h
+typedef struct SipnetModel SipnetModel;
+
 typedef struct BalanceTrackerStruct {
   // Mass balance checks:
   //   X_t - X_(t-1) = inputs - outputs + tolerance
@@ -39,17 +42,14 @@ typedef struct BalanceTrackerStruct {
   double deltaN;
 } BalanceTracker;
 
-// Global var
-extern BalanceTracker balanceTracker;
-
-void updateBalanceTrackerPreUpdate(void);
+void updateBalanceTrackerPreUpdate(SipnetModel *model);
 
-void updateBalanceTrackerPostUpdate(void);
+void updateBalanceTrackerPostUpdate(SipnetModel *model);
 
-void updateBalanceTrackerPostClamp(void);
+void updateBalanceTrackerPostClamp(SipnetModel *model);
 
-void initBalanceTracker(void);
+void initBalanceTracker(SipnetModel *model);
 
-void checkBalance(void);
+void checkBalance(SipnetModel *model);
 
 #endif  // BALANCE_H
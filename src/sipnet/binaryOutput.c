@@ -0,0 +1,157 @@
+// Columnar binary model output; see binaryOutput.h for the file layout
+
+#include "binaryOutput.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/exitCodes.h"
+#include "common/logging.h"
+
+struct BinaryOutput {
+  FILE *out;
+  int numColumns;
+  BinaryColumnType *types;
+  // One buffer per column, each with room for BINARY_OUTPUT_BLOCK_ROWS values
+  // of the column's type
+  char **buffers;
+  int numRows;  // rows in the current block
+};
+
+static size_t typeSize(BinaryColumnType type) {
+  switch (type) {
+    case BINARY_INT32:
+      return sizeof(int32_t);
+    case BINARY_FLOAT32:
+      return sizeof(float);
+    case BINARY_FLOAT64:
+      return sizeof(double);
+  }
+  logError("unknown binary output column type %d\n", (int)type);
+  exit(EXIT_CODE_INTERNAL_ERROR);
+}
+
+static void checkWrite(int ok) {
+  if (!ok) {
+    logError("error writing binary output file\n");
+    exit(EXIT_CODE_FAILURE);
+  }
+}
+
+static void writeString(FILE *out, const char *str) {
+  size_t len = strlen(str);
+  uint8_t len8 = (uint8_t)len;
+
+  if (len > UINT8_MAX) {
+    logError("binary output column label '%s' is too long\n", str);
+    exit(EXIT_CODE_INTERNAL_ERROR);
+  }
+  checkWrite(fwrite(&len8, 1, 1, out) == 1);
+  checkWrite(fwrite(str, 1, len, out) == len);
+}
+
+static void writeHeader(FILE *out, const BinaryColumn *columns,
+                        int numColumns) {
+  uint32_t version = BINARY_OUTPUT_VERSION;
+  uint32_t byteOrder = BINARY_OUTPUT_BYTE_ORDER;
+  uint32_t count = (uint32_t)numColumns;
+  uint32_t blockRows = BINARY_OUTPUT_BLOCK_ROWS;
+
+  checkWrite(fwrite(BINARY_OUTPUT_MAGIC, 1, BINARY_OUTPUT_MAGIC_LEN, out) ==
+             BINARY_OUTPUT_MAGIC_LEN);
+  checkWrite(fwrite(&version, sizeof(version), 1, out) == 1);
+  checkWrite(fwrite(&byteOrder, sizeof(byteOrder), 1, out) == 1);
+  checkWrite(fwrite(&count, sizeof(count), 1, out) == 1);
+  checkWrite(fwrite(&blockRows, sizeof(blockRows), 1, out) == 1);
+  for (int col = 0; col < numColumns; ++col) {
+    uint8_t type = (uint8_t)columns[col].type;
+    checkWrite(fwrite(&type, 1, 1, out) == 1);
+    writeString(out, columns[col].name);
+    writeString(out, columns[col].units);
+  }
+}
+
+// Write the rows in the current block, if any, and start a new block
+static void flushBlock(BinaryOutput *output) {
+  uint32_t numRows = (uint32_t)output->numRows;
+
+  if (numRows == 0) {
+    return;
+  }
+  checkWrite(fwrite(&numRows, sizeof(numRows), 1, output->out) == 1);
+  for (int col = 0; col < output->numColumns; ++col) {
+    size_t size = typeSize(output->types[col]);
+    checkWrite(fwrite(output->buffers[col], size, numRows, output->out) ==
+               numRows);
+  }
+  output->numRows = 0;
+}
+
+// See binaryOutput.h
+BinaryOutput *newBinaryOutput(FILE *out, const BinaryColumn *columns,
+                              int numColumns) {
+  BinaryOutput *output = (BinaryOutput *)calloc(1, sizeof(BinaryOutput));
+  if (output != NULL) {
+    output->types =
+        (BinaryColumnType *)malloc(numColumns * sizeof(BinaryColumnType));
+    output->buffers = (char **)calloc(numColumns, sizeof(char *));
+  }
+  if (output == NULL || output->types == NULL || output->buffers == NULL) {
+    logError("memory allocation failure creating binary output\n");
+    exit(EXIT_CODE_INTERNAL_ERROR);
+  }
+
+  output->out = out;
+  output->numColumns = numColumns;
+  output->numRows = 0;
+  for (int col = 0; col < numColumns; ++col) {
+    output->types[col] = columns[col].type;
+    output->buffers[col] =
+        (char *)malloc(BINARY_OUTPUT_BLOCK_ROWS * typeSize(columns[col].type));
+    if (output->buffers[col] == NULL) {
+      logError("memory allocation failure creating binary output\n");
+      exit(EXIT_CODE_INTERNAL_ERROR);
+    }
+  }
+
+  writeHeader(out, columns, numColumns);
+
+  return output;
+}
+
+// See binaryOutput.h
+void writeBinaryOutputRow(BinaryOutput *output, const double *values) {
+  int row = output->numRows;
+
+  for (int col = 0; col < output->numColumns; ++col) {
+    switch (output->types[col]) {
+      case BINARY_INT32:
+        ((int32_t *)output->buffers[col])[row] = (int32_t)values[col];
+        break;
+      case BINARY_FLOAT32:
+        ((float *)output->buffers[col])[row] = (float)values[col];
+        break;
+      case BINARY_FLOAT64:
+        ((double *)output->buffers[col])[row] = values[col];
+        break;
+    }
+  }
+
+  output->numRows++;
+  if (output->numRows == BINARY_OUTPUT_BLOCK_ROWS) {
+    flushBlock(output);
+  }
+}
+
+// See binaryOutput.h
+void closeBinaryOutput(BinaryOutput *output) {
+  flushBlock(output);
+  for (int col = 0; col < output->numColumns; ++col) {
+    free(output->buffers[col]);
+  }
+  free(output->buffers);
+  free(output->types);
+  free(output);
+}
@@ -0,0 +1,78 @@
+// header file for binaryOutput.c: columnar binary model output
+//
+// A binary output file starts with a header describing its columns, followed
+// by blocks of rows stored column by column:
+//
+//   header:
+//     char[8]  magic, "SIPNETOB"
+//     uint32   format version, BINARY_OUTPUT_VERSION
+//     uint32   byte order mark, 0x01020304 as written by this machine
+//     uint32   number of columns
+//     uint32   most rows in one block
+//     for each column:
+//       uint8    type (BinaryColumnType)
+//       uint8    length of name, then the name (no trailing '\0')
+//       uint8    length of units, then the units (no trailing '\0')
+//   blocks, until the end of the file:
+//     uint32   number of rows in this block, at least 1
+//     for each column: that many values of the column's type
+//
+// All numbers are in the byte order of the machine that wrote the file; a
+// reader on a machine of the other order can tell from the byte order mark.
+// Readers for C and Python are in tools/ (sipnet_binary.h, sipnet_binary.py).
+
+#ifndef BINARY_OUTPUT_H
+#define BINARY_OUTPUT_H
+
+#include <stdio.h>
+
+#define BINARY_OUTPUT_MAGIC "SIPNETOB"
+#define BINARY_OUTPUT_MAGIC_LEN 8
+#define BINARY_OUTPUT_BYTE_ORDER 0x01020304u
+#define BINARY_OUTPUT_VERSION 1
+
+// Rows buffered before a block is written; one block of the main output is
+// about 300 kB at float64
+#define BINARY_OUTPUT_BLOCK_ROWS 1024
+
+// Column value types; the numbers are part of the file format
+typedef enum BinaryColumnType {
+  BINARY_INT32 = 1,
+  BINARY_FLOAT32 = 2,
+  BINARY_FLOAT64 = 3
+} BinaryColumnType;
+
+typedef struct BinaryColumn {
+  const char *name;  // at most 255 characters
+  const char *units;  // at most 255 characters
+  BinaryColumnType type;
+} BinaryColumn;
+
+typedef struct BinaryOutput BinaryOutput;
+
+/*!
+ * Start a binary output file, writing its header
+ *
+ * @param out file to write to, open for binary writing; it stays open when the
+ *            BinaryOutput is closed
+ * @param columns column descriptions, copied
+ * @param numColumns number of columns
+ * @return new BinaryOutput; exits on allocation failure
+ */
+BinaryOutput *newBinaryOutput(FILE *out, const BinaryColumn *columns,
+                              int numColumns);
+
+/*!
+ * Add a row to the current block, writing the block once it is full
+ *
+ * @param values one value for each column, in column order; values of
+ *               BINARY_INT32 columns must be whole numbers
+ */
+void writeBinaryOutputRow(BinaryOutput *output, const double *values);
+
+/*!
+ * Write any buffered rows and free the BinaryOutput
+ */
+void closeBinaryOutput(BinaryOutput *output);
+
+#endif  // BINARY_OUTPUT_H
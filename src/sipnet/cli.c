@@ -1,5 +1,8 @@
 #include "cli.h"
 
+#include <limits.h>
+#include <stdlib.h>
+
 #include "common/exitCodes.h"
 #include "common/logging.h"
 
@@ -13,6 +16,23 @@
 #define CLI_RESTART_IN 1001
 #define CLI_RESTART_OUT 1002
 #define CLI_DEBUG_LOG 1003
+#define CLI_ENSEMBLE 1004
+#define CLI_THREADS 1005
+#define CLI_CLIMATE_THREADS 1006
+#define CLI_LANES 1007
+#define CLI_OUTPUT_FORMAT 1008
+#define CLI_OUTPUT_VARS 1009
+#define CLI_OUTPUT_PERIOD 1010
+#define CLI_SINGLE_OUTPUT_VARS 1011
+#define CLI_NETCDF_DEFLATE 1012
+#define CLI_MET_FILE 1013
+#define CLI_MET_YEARS 1014
+#define CLI_COMPRESS_OUTPUT 1015
+#define CLI_RESTART_FORMAT 1016
+#define CLI_CHECKPOINT_EVERY 1017
+#define CLI_RESTART_DATES 1018
+#define CLI_SCENARIOS 1019
+#define CLI_SCENARIO_DATE 1020
 
 // The struct 'option' is defined in getopt.h, and is expected by getopt_long()
 // See docs/developer-guide/cli-options.md for details on how to add a new
@@ -34,12 +54,17 @@ static struct option long_options[] = {  // NOLINT
     DECLARE_FLAG(anaerobic),
     DECLARE_FLAG(flooding),
     DECLARE_FLAG(carbon-saturation),
+    DECLARE_FLAG(analytic-light),
 
     DECLARE_FLAG(do-main-output),
     DECLARE_FLAG(do-single-outputs),
     DECLARE_FLAG(dump-config),
     DECLARE_FLAG(print-header),
     DECLARE_FLAG(quiet),
+    DECLARE_FLAG(climate-cache),
+    DECLARE_FLAG(climate-stream),
+    DECLARE_FLAG(async-output),
+    DECLARE_FLAG(auto-resume),
 
     // These options don’t set a flag. We distinguish them by their val.
     // Aliases share the same val (e.g. file-prefix and file-name both use
@@ -51,7 +76,24 @@ static struct option long_options[] = {  // NOLINT
     {"events-prefix", required_argument, 0, 'e'},
     {"restart-in", required_argument, 0, CLI_RESTART_IN},
     {"restart-out", required_argument, 0, CLI_RESTART_OUT},
+    {"restart-format", required_argument, 0, CLI_RESTART_FORMAT},
+    {"restart-dates", required_argument, 0, CLI_RESTART_DATES},
+    {"checkpoint-every", required_argument, 0, CLI_CHECKPOINT_EVERY},
     {"debug-log", required_argument, 0, CLI_DEBUG_LOG},
+    {"ensemble", required_argument, 0, CLI_ENSEMBLE},
+    {"scenarios", required_argument, 0, CLI_SCENARIOS},
+    {"scenario-date", required_argument, 0, CLI_SCENARIO_DATE},
+    {"threads", required_argument, 0, CLI_THREADS},
+    {"climate-threads", required_argument, 0, CLI_CLIMATE_THREADS},
+    {"lanes", required_argument, 0, CLI_LANES},
+    {"output-format", required_argument, 0, CLI_OUTPUT_FORMAT},
+    {"output-vars", required_argument, 0, CLI_OUTPUT_VARS},
+    {"output-period", required_argument, 0, CLI_OUTPUT_PERIOD},
+    {"single-output-vars", required_argument, 0, CLI_SINGLE_OUTPUT_VARS},
+    {"netcdf-deflate", required_argument, 0, CLI_NETCDF_DEFLATE},
+    {"met-file", required_argument, 0, CLI_MET_FILE},
+    {"met-years", required_argument, 0, CLI_MET_YEARS},
+    {"compress-output", required_argument, 0, CLI_COMPRESS_OUTPUT},
     {"help", no_argument, 0, 'h'},
     {"version", no_argument, 0, 'v'},
     {0, 0, 0, 0}};
@@ -69,11 +111,14 @@ char *argNameMap[] = {
     DECLARE_ARG_FOR_MAP(soilPhenol), DECLARE_ARG_FOR_MAP(waterHResp),
     DECLARE_ARG_FOR_MAP(nitrogenCycle), DECLARE_ARG_FOR_MAP(anaerobic),
     DECLARE_ARG_FOR_MAP(flooding), DECLARE_ARG_FOR_MAP(carbonSaturation),
+    DECLARE_ARG_FOR_MAP(analyticLight),
 
     // I/O
     DECLARE_ARG_FOR_MAP(doMainOutput), DECLARE_ARG_FOR_MAP(doSingleOutputs),
     DECLARE_ARG_FOR_MAP(dumpConfig), DECLARE_ARG_FOR_MAP(printHeader),
-    DECLARE_ARG_FOR_MAP(quiet)};
+    DECLARE_ARG_FOR_MAP(quiet), DECLARE_ARG_FOR_MAP(climateCache),
+    DECLARE_ARG_FOR_MAP(climateStream), DECLARE_ARG_FOR_MAP(asyncOutput),
+    DECLARE_ARG_FOR_MAP(autoResume)};
 // clang-format on
 
 // Print the help message when requested
@@ -88,8 +133,18 @@ void usage(char *progName) {
   printf("  -f, --file-prefix <name>           Prefix of climate and parameter files ('sipnet')\n");
   printf("      --file-name <name>             Backward-compatible alias for --file-prefix\n");
   printf("  -e, --events-prefix <name>         Prefix of events input/output files ('events' => 'events.in' / 'events.out')\n");
+  printf("      --ensemble <path>              Run each file prefix listed in <path> as an ensemble member over one shared climate\n");
+  printf("      --scenarios <path>             Run the baseline once to --scenario-date, then each prefix listed in <path> from there with its own <prefix>.events.in\n");
+  printf("      --scenario-date <year>-<day>   Date the --scenarios branches leave the baseline, at its midnight\n");
+  printf("      --threads <n>                  Number of threads for ensemble and scenario runs; 0 for one per CPU (0)\n");
+  printf("      --lanes <n>                    Number of ensemble members each thread runs together in lockstep, up to 8 (1)\n");
+  printf("      --climate-threads <n>          Number of threads for parsing the climate file; 0 for one per CPU (1)\n");
+  printf("      --met-file <path>              Read climate from a NetCDF met file with CF variables instead of <file-prefix>.clim;\n");
+  printf("                                     soil temperature is air temperature if the file has none\n");
+  printf("      --met-years <first>[-<last>]   Years of the met file to read (all)\n");
   printf("\n");
   printf("Model flags: (prepend flag with 'no-' to force off, eg '--no-events')\n");
+  printf("  --analytic-light     Integrate the canopy light effect exactly rather than with Simpson's rule (0)\n");
   printf("  --anaerobic          Enable modeling of methane and anaerobic effect on Rh moisture dependency (0)\n");
   printf("  --events             Enable event handling (1)\n");
   printf("  --flooding           Enable soil moisture to go above water holding capacity\n");
@@ -103,21 +158,40 @@ void usage(char *progName) {
   printf("  --water-hresp        Whether soil moisture affects heterotrophic respiration (1)\n");
   printf("  --carbon-saturation  Enable maximum storage limit of soil organic carbon (0)\n");
   printf("\n");
+  printf("Input flags: (prepend flag with 'no-' to force off, eg '--no-climate-cache')\n");
+  printf("  --climate-cache      Cache parsed climate data in <file-prefix>.climb and reuse it while the .clim file is unchanged (1)\n");
+  printf("  --climate-stream     Read climate in chunks on a separate thread while the model runs, using constant memory (0)\n");
+  printf("\n");
   printf("Output flags: (prepend flag with 'no-' to force off, eg '--no-print-header')\n");
-  printf("  --debug-log <prefix> Write debug state logs to <prefix>_{envi,fluxes,trackers}.log\n");
+  printf("  --async-output       Write output files on a separate thread, so slow storage doesn't hold up the model (0)\n");
   printf("  --do-main-output     Print time series of all output variables to <file-prefix>.out (1)\n");
-  printf("  --do-single-outputs  Print selection* of outputs one variable per file (e.g. <file-prefix>.NEE)\n");
+  printf("  --do-single-outputs  Print selected* outputs, one column each, to <file-prefix>.single (0)\n");
   printf("  --dump-config        Print final config to <file-prefix>.config (0)\n");
   printf("  --print-header       Whether to print header row in output files (1)\n");
   printf("  --quiet              Suppress info and warning message (0)\n");
-  printf("  --restart-in <path>  Read a restart checkpoint from path\n");
-  printf("  --restart-out <path> Write a restart checkpoint to path at end of run\n");
+  printf("\n");
+  printf("Output options:\n");
+  printf("      --compress-output <m>          Compress <file-prefix>.out, the debug logs and events output as they are written: none, gzip (.gz) or zstd (.zst) (none)\n");
+  printf("      --debug-log <prefix>           Write debug state logs to <prefix>_{envi,fluxes,trackers}.log\n");
+  printf("      --netcdf-deflate <n>           Deflate level for --output-format netcdf, 0 (none) to 9 (0)\n");
+  printf("      --output-format <f>            Format of <file-prefix>.out: text, or columnar binary with float64 (binary) or float32 (binary32) values, or <file-prefix>.nc with netcdf (text)\n");
+  printf("      --output-period <p>            Period each row of <file-prefix>.out covers: step, or sums and end-of-period pools by day, month or year (step)\n");
+  printf("      --output-vars <list>           Comma-separated variables to write to <file-prefix>.out and the debug logs, e.g. nee,gpp,soilWater (all)\n");
+  printf("      --single-output-vars <list>    Comma-separated variables for --do-single-outputs, e.g. trackers.gpp,envi.soilC\n");
+  printf("\n");
+  printf("Restart options:\n");
+  printf("      --restart-in <path>            Read a restart checkpoint from path\n");
+  printf("      --restart-out <path>           Write a restart checkpoint to path at end of run, or after each --restart-dates date; %%Y and %%j in path are the checkpoint's year and day\n");
+  printf("      --restart-dates <list>         Comma-separated <year>-<day> dates, in order, to write --restart-out checkpoints after in one run, e.g. 2016-47,2016-49\n");
+  printf("      --restart-format <f>           Format of --restart-out: text, binary, or auto for binary if path ends in .restartb (auto)\n");
+  printf("      --checkpoint-every <n>         Rotate a checkpoint in <file-prefix>.checkpoint at the first midnight after every <n>years or <n>steps\n");
+  printf("      --auto-resume                  Resume from the newest valid <file-prefix>.checkpoint written by --checkpoint-every, if any (0)\n");
   printf("\n");
   printf("Info options:\n");
   printf("  -h, --help           Print this message and exit\n");
   printf("  -v, --version        Print version information and exit\n");
   printf("\n");
-  printf("*do-single-outputs option outputs are: NEE, NEE_cum, GPP, GPP_cum\n");
+  printf("*do-single-outputs option outputs are NEE, NEE_cum, GPP, GPP_cum unless --single-output-vars lists others\n");
   printf("\n");
   printf("Configuration options are read from <input_file>. Other options specified on the command\n");
   printf("line override settings from that file.\n");
@@ -196,6 +270,34 @@ void parseCommandLineArgs(int argc, char *argv[]) {
         }
         updateCharContext("restartOut", optarg, CTX_COMMAND_LINE);
         break;
+      case CLI_RESTART_FORMAT:
+        requireCLIArg("--restart-format");
+        if (!isRestartFormat(optarg)) {
+          logError("invalid value for --restart-format: %s\n", optarg);
+          exit(EXIT_CODE_BAD_CLI_ARGUMENT);
+        }
+        updateCharContext("restartFormat", optarg, CTX_COMMAND_LINE);
+        break;
+      case CLI_RESTART_DATES:
+        requireCLIArg("--restart-dates");
+        if ((strlen(optarg) >= CONTEXT_CHAR_MAXLEN) ||
+            countRestartDates(optarg) <= 0) {
+          logError("invalid value for --restart-dates: %s\n", optarg);
+          exit(EXIT_CODE_BAD_CLI_ARGUMENT);
+        }
+        updateCharContext("restartDates", optarg, CTX_COMMAND_LINE);
+        break;
+      case CLI_CHECKPOINT_EVERY: {
+        long count;
+        int inYears;
+        requireCLIArg("--checkpoint-every");
+        if ((strlen(optarg) >= CONTEXT_CHAR_MAXLEN) ||
+            !parseCheckpointEvery(optarg, &count, &inYears) || count == 0) {
+          logError("invalid value for --checkpoint-every: %s\n", optarg);
+          exit(EXIT_CODE_BAD_CLI_ARGUMENT);
+        }
+        updateCharContext("checkpointEvery", optarg, CTX_COMMAND_LINE);
+      } break;
       case CLI_DEBUG_LOG: {
         const size_t maxDebugPrefixLen =
             FILENAME_MAXLEN - strlen("_trackers.log") - 1;
@@ -207,6 +309,138 @@ void parseCommandLineArgs(int argc, char *argv[]) {
         }
         updateCharContext("debugLogPrefix", optarg, CTX_COMMAND_LINE);
       } break;
+      case CLI_ENSEMBLE:
+        requireCLIArg("--ensemble");
+        if (strlen(optarg) >= FILENAME_MAXLEN) {
+          logError("ensemble path %s exceeds maximum length of %d\n", optarg,
+                   FILENAME_MAXLEN);
+          exit(EXIT_CODE_BAD_CLI_ARGUMENT);
+        }
+        updateCharContext("ensembleFile", optarg, CTX_COMMAND_LINE);
+        break;
+      case CLI_SCENARIOS:
+        requireCLIArg("--scenarios");
+        if (strlen(optarg) >= FILENAME_MAXLEN) {
+          logError("scenarios path %s exceeds maximum length of %d\n", optarg,
+                   FILENAME_MAXLEN);
+          exit(EXIT_CODE_BAD_CLI_ARGUMENT);
+        }
+        updateCharContext("scenarioFile", optarg, CTX_COMMAND_LINE);
+        break;
+      case CLI_SCENARIO_DATE:
+        requireCLIArg("--scenario-date");
+        if ((strlen(optarg) >= CONTEXT_CHAR_MAXLEN) ||
+            countRestartDates(optarg) != 1) {
+          logError("invalid value for --scenario-date: %s\n", optarg);
+          exit(EXIT_CODE_BAD_CLI_ARGUMENT);
+        }
+        updateCharContext("scenarioDate", optarg, CTX_COMMAND_LINE);
+        break;
+      case CLI_THREADS: {
+        char *end;
+        requireCLIArg("--threads");
+        long numThreads = strtol(optarg, &end, 10);
+        if (*optarg == '\0' || *end != '\0' || numThreads < 0 ||
+            numThreads > INT_MAX) {
+          logError("invalid value for --threads: %s\n", optarg);
+          exit(EXIT_CODE_BAD_CLI_ARGUMENT);
+        }
+        updateIntContext("numThreads", (int)numThreads, CTX_COMMAND_LINE);
+      } break;
+      case CLI_CLIMATE_THREADS: {
+        char *end;
+        requireCLIArg("--climate-threads");
+        long numThreads = strtol(optarg, &end, 10);
+        if (*optarg == '\0' || *end != '\0' || numThreads < 0 ||
+            numThreads > INT_MAX) {
+          logError("invalid value for --climate-threads: %s\n", optarg);
+          exit(EXIT_CODE_BAD_CLI_ARGUMENT);
+        }
+        updateIntContext("climateThreads", (int)numThreads, CTX_COMMAND_LINE);
+      } break;
+      case CLI_LANES: {
+        char *end;
+        requireCLIArg("--lanes");
+        long numLanes = strtol(optarg, &end, 10);
+        if (*optarg == '\0' || *end != '\0' || numLanes < 1 ||
+            numLanes > MAX_ENSEMBLE_LANES) {
+          logError("invalid value for --lanes: %s\n", optarg);
+          exit(EXIT_CODE_BAD_CLI_ARGUMENT);
+        }
+        updateIntContext("numLanes", (int)numLanes, CTX_COMMAND_LINE);
+      } break;
+      case CLI_OUTPUT_FORMAT:
+        requireCLIArg("--output-format");
+        if (!isOutputFormat(optarg)) {
+          logError("invalid value for --output-format: %s\n", optarg);
+          exit(EXIT_CODE_BAD_CLI_ARGUMENT);
+        }
+        updateCharContext("outputFormat", optarg, CTX_COMMAND_LINE);
+        break;
+      case CLI_COMPRESS_OUTPUT:
+        requireCLIArg("--compress-output");
+        if (!isOutputCompression(optarg)) {
+          logError("invalid value for --compress-output: %s\n", optarg);
+          exit(EXIT_CODE_BAD_CLI_ARGUMENT);
+        }
+        updateCharContext("compressOutput", optarg, CTX_COMMAND_LINE);
+        break;
+      case CLI_OUTPUT_PERIOD:
+        requireCLIArg("--output-period");
+        if (!isOutputPeriod(optarg)) {
+          logError("invalid value for --output-period: %s\n", optarg);
+          exit(EXIT_CODE_BAD_CLI_ARGUMENT);
+        }
+        updateCharContext("outputPeriod", optarg, CTX_COMMAND_LINE);
+        break;
+      case CLI_OUTPUT_VARS:
+        requireCLIArg("--output-vars");
+        if (strlen(optarg) >= CONTEXT_CHAR_MAXLEN) {
+          logError("--output-vars list exceeds maximum length of %d\n",
+                   CONTEXT_CHAR_MAXLEN - 1);
+          exit(EXIT_CODE_BAD_CLI_ARGUMENT);
+        }
+        updateCharContext("outputVars", optarg, CTX_COMMAND_LINE);
+        break;
+      case CLI_SINGLE_OUTPUT_VARS:
+        requireCLIArg("--single-output-vars");
+        if (strlen(optarg) >= CONTEXT_CHAR_MAXLEN) {
+          logError("--single-output-vars list exceeds maximum length of %d\n",
+                   CONTEXT_CHAR_MAXLEN - 1);
+          exit(EXIT_CODE_BAD_CLI_ARGUMENT);
+        }
+        updateCharContext("singleOutputVars", optarg, CTX_COMMAND_LINE);
+        break;
+      case CLI_MET_FILE:
+        requireCLIArg("--met-file");
+        if (strlen(optarg) >= FILENAME_MAXLEN) {
+          logError("met file path %s exceeds maximum length of %d\n", optarg,
+                   FILENAME_MAXLEN);
+          exit(EXIT_CODE_BAD_CLI_ARGUMENT);
+        }
+        updateCharContext("metFile", optarg, CTX_COMMAND_LINE);
+        break;
+      case CLI_MET_YEARS: {
+        int firstYear, lastYear;
+        requireCLIArg("--met-years");
+        if ((strlen(optarg) >= CONTEXT_CHAR_MAXLEN) ||
+            !parseMetYears(optarg, &firstYear, &lastYear)) {
+          logError("invalid value for --met-years: %s\n", optarg);
+          exit(EXIT_CODE_BAD_CLI_ARGUMENT);
+        }
+        updateCharContext("metYears", optarg, CTX_COMMAND_LINE);
+      } break;
+      case CLI_NETCDF_DEFLATE: {
+        char *end;
+        requireCLIArg("--netcdf-deflate");
+        long level = strtol(optarg, &end, 10);
+        if (*optarg == '\0' || *end != '\0' || level < 0 ||
+            level > NETCDF_MAX_DEFLATE) {
+          logError("invalid value for --netcdf-deflate: %s\n", optarg);
+          exit(EXIT_CODE_BAD_CLI_ARGUMENT);
+        }
+        updateIntContext("netcdfDeflate", (int)level, CTX_COMMAND_LINE);
+      } break;
       case 'i':
         requireCLIArg("--input-file");
         if (strlen(optarg) >= FILENAME_MAXLEN) {
@@ -0,0 +1,756 @@
+// Reading climate files, all at once or streamed in chunks; see climate.h
+
+#include "climate.h"
+
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "common/context.h"
+#include "common/exitCodes.h"
+#include "common/logging.h"
+#include "common/tokenizer.h"
+#include "common/util.h"
+
+#include "climate_cache.h"
+#include "climate_netcdf.h"
+
+// Chunks in a climate stream: one being used by the model, one ready for it,
+// and one being parsed
+#define NUM_STREAM_CHUNKS 3
+
+// Results of reading one climate record; see tryReadClimateRecord()
+#define CLIMATE_RECORD_READ 1
+#define CLIMATE_RECORD_EOF 0
+#define CLIMATE_RECORD_BAD_DATA (-1)
+#define CLIMATE_RECORD_BAD_LOCATION (-2)
+
+// State for reading the records of a climate file one at a time
+typedef struct ClimateReader {
+  FILE *in;
+  LineReader lines;
+  const char *climFile;
+  int legacyFormat;
+  int expectedNumCols;
+  int firstLoc;
+  // Values read from the last line, as returned by parseClimateLine()
+  int numValuesRead;
+  // The first record is read along with the format check, and is held here
+  // until it is asked for
+  int haveFirstRecord;
+  ClimateRecord record;
+} ClimateReader;
+
+struct ClimateStream {
+  ClimateReader reader;
+  long chunkSteps;
+  ClimateData *chunks[NUM_STREAM_CHUNKS];
+
+  // Chunks that have been filled by the parser and not yet handed back by the
+  // consumer, including the one the consumer is using
+  int numFilled;
+  // Next chunk for the parser to fill, and next chunk for the consumer
+  int fillIndex;
+  int useIndex;
+  // Whether the consumer is using chunks[useIndex - 1]
+  int holdingChunk;
+  // Set by the parser at end of file, and by closeClimateStream() to stop the
+  // parser early
+  int done;
+  int stop;
+
+  pthread_t parser;
+  pthread_mutex_t lock;
+  pthread_cond_t chunkFilled;
+  pthread_cond_t chunkFreed;
+};
+
+// Count the lines in numBytes of a file from offset start (or to end of file,
+// if that comes first), then seek back to start; used to size the climate
+// arrays
+static long countLines(FILE *in, long start, long numBytes) {
+  char buf[65536];
+  size_t numRead;
+  long numLines = 0;
+  char lastChar = '\n';
+
+  fseek(in, start, SEEK_SET);
+  while ((numBytes > 0) &&
+         (numRead = fread(buf, 1,
+                          (numBytes < (long)sizeof(buf)) ? numBytes
+                                                          : sizeof(buf),
+                          in)) > 0) {
+    const char *curr = buf;
+    const char *end = buf + numRead;
+    while ((curr = memchr(curr, '\n', end - curr)) != NULL) {
+      ++numLines;
+      ++curr;
+    }
+    lastChar = buf[numRead - 1];
+    numBytes -= numRead;
+  }
+  if (lastChar != '\n') {
+    ++numLines;  // last line with no newline
+  }
+  fseek(in, start, SEEK_SET);
+
+  return numLines;
+}
+
+// See climate.h
+ClimateData *allocClimateData(long capacity) {
+  const int numDoubleVars = 11;
+  const int numIntVars = 2;
+  ClimateData *data;
+  double *doubles;
+  int *ints;
+
+  // The struct size is a multiple of its pointer alignment, so the double
+  // arrays that follow it are aligned; the int arrays go last
+  data = (ClimateData *)malloc(sizeof(ClimateData) +
+                               capacity * (numDoubleVars * sizeof(double) +
+                                           numIntVars * sizeof(int)));
+  if (data == NULL) {
+    logError("memory allocation failure reading climate data (%ld steps)\n",
+             capacity);
+    exit(EXIT_CODE_INTERNAL_ERROR);
+  }
+
+  doubles = (double *)(data + 1);
+  data->time = doubles;
+  data->length = doubles + capacity;
+  data->tair = doubles + 2 * capacity;
+  data->tsoil = doubles + 3 * capacity;
+  data->par = doubles + 4 * capacity;
+  data->precip = doubles + 5 * capacity;
+  data->vpd = doubles + 6 * capacity;
+  data->vpdSoil = doubles + 7 * capacity;
+  data->vPress = doubles + 8 * capacity;
+  data->wspd = doubles + 9 * capacity;
+  data->gdd = doubles + 10 * capacity;
+
+  ints = (int *)(doubles + numDoubleVars * capacity);
+  data->year = ints;
+  data->day = ints + capacity;
+
+  data->numSteps = 0;
+  data->mapping = NULL;
+  data->mappingSize = 0;
+
+  return data;
+}
+
+// Parse one line of a climate file into rec, stopping at the first value that
+// can't be read. Return the number of values read, or -1 if the line has
+// values left over after a full record.
+static int parseClimateLine(const char *line, int legacyFormat,
+                            ClimateRecord *rec) {
+  double *doubleVals[] = {&rec->time,   &rec->length,  &rec->tair,
+                          &rec->tsoil,  &rec->par,     &rec->precip,
+                          &rec->vpd,    &rec->vpdSoil, &rec->vPress,
+                          &rec->wspd,   &rec->soilWetness};
+  // soilWetness is only in the legacy format
+  int numDoubles = sizeof(doubleVals) / sizeof(double *) - !legacyFormat;
+  const char *curr = line;
+  int numRead = 0;
+
+  if (legacyFormat) {
+    if (!scanInt(&curr, &rec->loc)) {
+      return numRead;
+    }
+    ++numRead;
+  }
+  if (!scanInt(&curr, &rec->year)) {
+    return numRead;
+  }
+  ++numRead;
+  if (!scanInt(&curr, &rec->day)) {
+    return numRead;
+  }
+  ++numRead;
+  for (int ind = 0; ind < numDoubles; ++ind) {
+    if (!scanDouble(&curr, doubleVals[ind])) {
+      return numRead;
+    }
+    ++numRead;
+  }
+
+  if (*skipSpace(curr) != '\0') {
+    return -1;
+  }
+  return numRead;
+}
+
+/*!
+ * Start reading a climate file, checking its format
+ *
+ * Each line of the climate file represents one time step, with the following
+ * format:
+ *    year day time intervalLength tair tsoil par precip vpd vpdSoil vPress wspd
+ *
+ * An older format with a location column first and a soilWetness column last
+ * is also accepted; those two columns are ignored.
+ *
+ * NOTE: there should be NO blank lines in the file.
+ *
+ * @param reader reader to initialize
+ * @param in climate file, open for reading at its start
+ * @param climFile name of climate file, for messages
+ */
+static void initClimateReader(ClimateReader *reader, FILE *in,
+                              const char *climFile) {
+  ClimateRecord *rec = &reader->record;
+  int numFields, status;
+  char *firstLine;
+
+  memset(reader, 0, sizeof(*reader));
+  reader->in = in;
+  reader->climFile = climFile;
+  initLineReader(&reader->lines, in);
+
+  // Check format of first line to see if location is still specified (we will
+  // ignore it if so)
+  firstLine = readLine(&reader->lines);
+  if (firstLine == NULL) {  // EOF
+    logError("no climate data in %s\n", climFile);
+    exit(EXIT_CODE_INPUT_FILE_ERROR);
+  }
+
+  numFields = countTokens(firstLine);
+  switch (numFields) {
+    case NUM_CLIM_FILE_COLS:
+      // Standard format
+      reader->expectedNumCols = NUM_CLIM_FILE_COLS;
+      reader->legacyFormat = 0;
+      break;
+    case NUM_CLIM_FILE_COLS_LEGACY:
+      reader->expectedNumCols = NUM_CLIM_FILE_COLS_LEGACY;
+      reader->legacyFormat = 1;
+      logInfo("old climate file format detected (found %d cols); ignoring "
+              "location and soilWetness columns in %s\n",
+              numFields, climFile);
+      break;
+    default:
+      // Unrecognized format
+      logError("format unrecognized in climate file %s; %d columns found, "
+               "expected %d or %d (legacy format)\n",
+               climFile, numFields, NUM_CLIM_FILE_COLS,
+               NUM_CLIM_FILE_COLS_LEGACY);
+      exit(EXIT_CODE_INPUT_FILE_ERROR);
+  }
+
+  status = parseClimateLine(firstLine, reader->legacyFormat, rec);
+  if (status != reader->expectedNumCols) {
+    logError("while reading climate file: bad data on first line\n");
+    exit(EXIT_CODE_INPUT_FILE_ERROR);
+  }
+
+  reader->firstLoc = rec->loc;
+  reader->haveFirstRecord = 1;
+}
+
+// Read the next record into reader->record, without reporting errors; return
+// one of the CLIMATE_RECORD_ codes above
+static int tryReadClimateRecord(ClimateReader *reader) {
+  ClimateRecord *rec = &reader->record;
+  char *line;
+
+  if (reader->haveFirstRecord) {
+    reader->haveFirstRecord = 0;
+    return CLIMATE_RECORD_READ;
+  }
+
+  // Skip blank lines
+  do {
+    line = readLine(&reader->lines);
+    if (line == NULL) {
+      return CLIMATE_RECORD_EOF;
+    }
+  } while (*skipSpace(line) == '\0');
+
+  reader->numValuesRead = parseClimateLine(line, reader->legacyFormat, rec);
+  if (reader->numValuesRead != reader->expectedNumCols) {
+    return CLIMATE_RECORD_BAD_DATA;
+  }
+  // Check for older file with multiple locations - that's an error now
+  if (reader->legacyFormat && (rec->loc != reader->firstLoc)) {
+    return CLIMATE_RECORD_BAD_LOCATION;
+  }
+
+  return CLIMATE_RECORD_READ;
+}
+
+// Report an error returned by tryReadClimateRecord(), and exit
+static void climateRecordError(const ClimateReader *reader, int status) {
+  const ClimateRecord *rec = &reader->record;
+
+  if (status == CLIMATE_RECORD_BAD_LOCATION) {
+    logError("while reading legacy climate file %s: multiple locations "
+             "not supported (locations found: %d and %d)\n",
+             reader->climFile, reader->firstLoc, rec->loc);
+  } else {
+    logError("while reading climate file: bad data near year %d day %d\n",
+             rec->year, rec->day);
+  }
+  exit(EXIT_CODE_INPUT_FILE_ERROR);
+}
+
+// Read the next record into reader->record; return 1 if there was one, 0 at
+// end of file
+static int readClimateRecord(ClimateReader *reader) {
+  int status = tryReadClimateRecord(reader);
+
+  if (status < 0) {
+    climateRecordError(reader, status);
+  }
+  return status;
+}
+
+// See climate.h
+void storeClimateStep(ClimateData *data, long step, const ClimateRecord *rec) {
+  double length = rec->length;  // in days (or fraction of day)
+  double thisGdd;  // growing degree days contributed by this time step
+
+  data->year[step] = rec->year;
+  data->day[step] = rec->day;
+  data->time[step] = rec->time;
+
+  if (length < 0) {  // parse as seconds
+    length = length / -86400.;  // convert to days
+  }
+  data->length[step] = length;
+
+  data->tair[step] = rec->tair;
+  data->tsoil[step] = rec->tsoil;
+  data->par[step] = rec->par * (1.0 / length);
+  // convert par from Einsteins * m^-2 to Einsteins * m^-2 * day^-1
+  data->precip[step] = rec->precip * 0.1;  // convert from mm to cm
+  data->vpd[step] = rec->vpd * 0.001;  // convert from Pa to kPa
+  if (data->vpd[step] < TINY) {
+    data->vpd[step] = TINY;  // avoid divide by zero
+  }
+  data->vpdSoil[step] = rec->vpdSoil * 0.001;  // convert from Pa to kPa
+  data->vPress[step] = rec->vPress * 0.001;  // convert from Pa to kPa
+  data->wspd[step] = rec->wspd;
+  if (data->wspd[step] < TINY) {
+    data->wspd[step] = TINY;  // avoid divide by zero
+  }
+
+  if (ctx.gdd) {
+    thisGdd = rec->tair * length;
+    if (thisGdd < 0) {  // can't have negative growing degree days
+      thisGdd = 0;
+    }
+    data->gdd[step] = thisGdd;
+  } else {
+    data->gdd[step] = 0.0;
+  }
+}
+
+// Read up to maxSteps records into data, starting at step 0; sets and returns
+// data->numSteps
+static long readClimateSteps(ClimateReader *reader, ClimateData *data,
+                             long maxSteps) {
+  long step = 0;
+
+  while ((step < maxSteps) && readClimateRecord(reader)) {
+    storeClimateStep(data, step, &reader->record);
+    ++step;
+  }
+  data->numSteps = step;
+
+  return step;
+}
+
+// Parse a whole text climate file on the calling thread
+static ClimateData *parseClimateFileSerial(const char *climFile) {
+  ClimateReader reader;
+  ClimateData *data;
+  FILE *in;
+  long capacity;
+
+  in = openFile(climFile, "r");
+  // Each step is on its own line, so the line count bounds the number of steps
+  capacity = countLines(in, 0, LONG_MAX);
+  initClimateReader(&reader, in, climFile);
+
+  data = allocClimateData(capacity);
+  readClimateSteps(&reader, data, capacity);
+
+  fclose(in);
+
+  return data;
+}
+
+// One piece of a climate file, counted and parsed on its own thread
+typedef struct ClimatePiece {
+  ClimateReader reader;
+  long start;  // offset in the file
+  long numBytes;
+  long numLines;
+  // Climate data shared by all pieces; this piece stores its records from
+  // step firstStep on
+  ClimateData *data;
+  long firstStep;
+  long numSteps;
+  int status;  // CLIMATE_RECORD_ code that ended the parse
+  pthread_t thread;
+} ClimatePiece;
+
+// Return the offset of the first line in a file that starts at or after
+// offset, which must be past the start of the file
+static long nextLineStart(FILE *in, long offset) {
+  int c;
+
+  fseek(in, offset - 1, SEEK_SET);
+  while (((c = getc(in)) != EOF) && (c != '\n')) {
+  }
+  return ftell(in);
+}
+
+// Thread for opening a piece of a climate file and counting its lines
+static void *countClimatePiece(void *arg) {
+  ClimatePiece *piece = (ClimatePiece *)arg;
+
+  piece->reader.in = openFile(piece->reader.climFile, "r");
+  piece->numLines = countLines(piece->reader.in, piece->start, piece->numBytes);
+
+  return NULL;
+}
+
+// Thread for parsing a piece of a climate file, after countClimatePiece()
+static void *parseClimatePiece(void *arg) {
+  ClimatePiece *piece = (ClimatePiece *)arg;
+  ClimateReader *reader = &piece->reader;
+  long step = piece->firstStep;
+
+  // countLines() left the file at the start of the piece
+  initLineReaderRange(&reader->lines, reader->in, piece->numBytes);
+  while ((piece->status = tryReadClimateRecord(reader)) ==
+         CLIMATE_RECORD_READ) {
+    storeClimateStep(piece->data, step, &reader->record);
+    ++step;
+  }
+  piece->numSteps = step - piece->firstStep;
+  fclose(reader->in);
+
+  return NULL;
+}
+
+// Run work on each piece, each on its own thread, and wait for them all
+static void runClimatePieces(ClimatePiece *pieces, int numPieces,
+                             void *(*work)(void *)) {
+  for (int ind = 0; ind < numPieces; ++ind) {
+    if (pthread_create(&pieces[ind].thread, NULL, work, &pieces[ind]) != 0) {
+      logError("unable to start climate parsing thread %d\n", ind);
+      exit(EXIT_CODE_INTERNAL_ERROR);
+    }
+  }
+  for (int ind = 0; ind < numPieces; ++ind) {
+    pthread_join(pieces[ind].thread, NULL);
+  }
+}
+
+// Move numSteps steps of climate data from step src to step dest
+static void moveClimateSteps(ClimateData *data, long dest, long src,
+                             long numSteps) {
+  double *doubleVars[] = {data->time,    data->length, data->tair,
+                          data->tsoil,   data->par,    data->precip,
+                          data->vpd,     data->vpdSoil, data->vPress,
+                          data->wspd,    data->gdd};
+  int *intVars[] = {data->year, data->day};
+
+  for (int ind = 0; ind < (int)(sizeof(doubleVars) / sizeof(double *));
+       ++ind) {
+    memmove(doubleVars[ind] + dest, doubleVars[ind] + src,
+            numSteps * sizeof(double));
+  }
+  for (int ind = 0; ind < (int)(sizeof(intVars) / sizeof(int *)); ++ind) {
+    memmove(intVars[ind] + dest, intVars[ind] + src, numSteps * sizeof(int));
+  }
+}
+
+// Parse a whole text climate file on numThreads threads
+//
+// The file after the first line is split into one piece per thread, at line
+// boundaries. Each thread counts the lines in its piece; the pieces are then
+// given consecutive ranges of steps and parsed in parallel. Errors are
+// reported for the first bad line in the file, just as when parsing serially.
+static ClimateData *parseClimateFileParallel(const char *climFile,
+                                             int numThreads) {
+  ClimateReader reader;
+  ClimatePiece *pieces;
+  ClimateData *data;
+  FILE *in;
+  long dataStart, fileSize, pieceEnd, numSteps;
+
+  // Check the format, and read the first record, here
+  in = openFile(climFile, "r");
+  initClimateReader(&reader, in, climFile);
+  dataStart = reader.lines.offset;
+  fseek(in, 0, SEEK_END);
+  fileSize = ftell(in);
+
+  pieces = (ClimatePiece *)calloc(numThreads, sizeof(ClimatePiece));
+  if (pieces == NULL) {
+    logError("memory allocation failure reading climate file %s\n", climFile);
+    exit(EXIT_CODE_INTERNAL_ERROR);
+  }
+  pieceEnd = dataStart;
+  for (int ind = 0; ind < numThreads; ++ind) {
+    ClimatePiece *piece = &pieces[ind];
+    piece->reader = reader;
+    piece->reader.haveFirstRecord = 0;
+    piece->start = pieceEnd;
+    if (ind == numThreads - 1) {
+      pieceEnd = fileSize;
+    } else {
+      long target = dataStart + (fileSize - dataStart) / numThreads * (ind + 1);
+      if (target > pieceEnd) {
+        pieceEnd = nextLineStart(in, target);
+      }
+    }
+    piece->numBytes = pieceEnd - piece->start;
+  }
+  fclose(in);
+
+  runClimatePieces(pieces, numThreads, countClimatePiece);
+
+  // Step 0 is the first line, read above
+  numSteps = 1;
+  for (int ind = 0; ind < numThreads; ++ind) {
+    pieces[ind].firstStep = numSteps;
+    numSteps += pieces[ind].numLines;
+  }
+  data = allocClimateData(numSteps);
+  storeClimateStep(data, 0, &reader.record);
+  for (int ind = 0; ind < numThreads; ++ind) {
+    pieces[ind].data = data;
+  }
+
+  runClimatePieces(pieces, numThreads, parseClimatePiece);
+
+  // Join the pieces up, closing gaps left by blank lines, and stop at the
+  // first error
+  numSteps = 1;
+  for (int ind = 0; ind < numThreads; ++ind) {
+    ClimatePiece *piece = &pieces[ind];
+    if (piece->status < 0) {
+      ClimateRecord *rec = &piece->reader.record;
+      int yearCol = piece->reader.legacyFormat;
+      int numRead = piece->reader.numValuesRead;
+      if ((piece->numSteps == 0) && (numRead >= 0)) {
+        // The bad line is the first in its piece, so values it didn't get to
+        // are left over from the first line of the file, not the line before
+        if (numRead <= yearCol) {
+          rec->year = data->year[numSteps - 1];
+        }
+        if (numRead <= yearCol + 1) {
+          rec->day = data->day[numSteps - 1];
+        }
+      }
+      climateRecordError(&piece->reader, piece->status);
+    }
+    if (piece->firstStep != numSteps) {
+      moveClimateSteps(data, numSteps, piece->firstStep, piece->numSteps);
+    }
+    numSteps += piece->numSteps;
+  }
+  data->numSteps = numSteps;
+
+  free(pieces);
+
+  return data;
+}
+
+// Parse a whole text climate file, on as many threads as configured
+static ClimateData *parseClimateFile(const char *climFile) {
+  int numThreads = ctx.climateThreads;
+
+  if (numThreads == 0) {
+    long numCPUs = sysconf(_SC_NPROCESSORS_ONLN);
+    numThreads = (numCPUs > 0) ? (int)numCPUs : 1;
+  }
+  if (numThreads > 1) {
+    return parseClimateFileParallel(climFile, numThreads);
+  }
+  return parseClimateFileSerial(climFile);
+}
+
+// See climate.h
+ClimateData *readClimate(const char *climFile) {
+  ClimateData *data;
+
+  // A NetCDF met file is already binary, so it isn't cached
+  if (strlen(ctx.metFile) > 0) {
+    return readNetcdfClimate(climFile);
+  }
+  if (ctx.climateCache) {
+    data = readClimateCache(climFile);
+    if (data != NULL) {
+      return data;
+    }
+  }
+
+  // The cache is keyed on the file as it was before parsing, in case it is
+  // rewritten while it is read
+  struct stat sourceStat;
+  int canCache = ctx.climateCache && (stat(climFile, &sourceStat) == 0);
+  data = parseClimateFile(climFile);
+  if (canCache) {
+    writeClimateCache(climFile, &sourceStat, data);
+  }
+
+  return data;
+}
+
+// See climate.h
+ClimateData *newClimateView(const ClimateData *climateData, long firstStep,
+                            long numSteps) {
+  ClimateData *view = (ClimateData *)malloc(sizeof(ClimateData));
+  if (view == NULL) {
+    logError("memory allocation failure making climate data view\n");
+    exit(EXIT_CODE_INTERNAL_ERROR);
+  }
+
+  view->numSteps = numSteps;
+  view->year = climateData->year + firstStep;
+  view->day = climateData->day + firstStep;
+  view->time = climateData->time + firstStep;
+  view->length = climateData->length + firstStep;
+  view->tair = climateData->tair + firstStep;
+  view->tsoil = climateData->tsoil + firstStep;
+  view->par = climateData->par + firstStep;
+  view->precip = climateData->precip + firstStep;
+  view->vpd = climateData->vpd + firstStep;
+  view->vpdSoil = climateData->vpdSoil + firstStep;
+  view->vPress = climateData->vPress + firstStep;
+  view->wspd = climateData->wspd + firstStep;
+  view->gdd = climateData->gdd + firstStep;
+  // The arrays aren't the view's to free
+  view->mapping = NULL;
+  view->mappingSize = 0;
+  return view;
+}
+
+// See climate.h
+void freeClimate(ClimateData *climateData) {
+  if (climateData->mapping != NULL) {
+    freeClimateCache(climateData);
+  } else {
+    free(climateData);
+  }
+}
+
+// Parser thread for a climate stream: fill chunks as the consumer frees them,
+// until end of file
+static void *climateStreamParser(void *arg) {
+  ClimateStream *stream = (ClimateStream *)arg;
+
+  while (1) {
+    pthread_mutex_lock(&stream->lock);
+    while ((stream->numFilled == NUM_STREAM_CHUNKS) && !stream->stop) {
+      pthread_cond_wait(&stream->chunkFreed, &stream->lock);
+    }
+    if (stream->stop) {
+      pthread_mutex_unlock(&stream->lock);
+      break;
+    }
+    ClimateData *chunk = stream->chunks[stream->fillIndex];
+    pthread_mutex_unlock(&stream->lock);
+
+    // The consumer never touches a chunk that isn't filled, so this can be
+    // done without holding the lock
+    long numSteps =
+        readClimateSteps(&stream->reader, chunk, stream->chunkSteps);
+
+    pthread_mutex_lock(&stream->lock);
+    if (numSteps > 0) {
+      ++stream->numFilled;
+      stream->fillIndex = (stream->fillIndex + 1) % NUM_STREAM_CHUNKS;
+    }
+    if (numSteps < stream->chunkSteps) {
+      stream->done = 1;
+    }
+    pthread_cond_signal(&stream->chunkFilled);
+    pthread_mutex_unlock(&stream->lock);
+
+    if (numSteps < stream->chunkSteps) {
+      break;
+    }
+  }
+
+  return NULL;
+}
+
+// See climate.h
+ClimateStream *openClimateStream(const char *climFile, long chunkSteps) {
+  ClimateStream *stream = (ClimateStream *)calloc(1, sizeof(ClimateStream));
+  if (stream == NULL) {
+    logError("memory allocation failure opening climate stream\n");
+    exit(EXIT_CODE_INTERNAL_ERROR);
+  }
+
+  // Check the format, and read the first record, before starting the parser
+  initClimateReader(&stream->reader, openFile(climFile, "r"), climFile);
+  stream->chunkSteps = chunkSteps;
+  for (int ind = 0; ind < NUM_STREAM_CHUNKS; ++ind) {
+    stream->chunks[ind] = allocClimateData(chunkSteps);
+  }
+  pthread_mutex_init(&stream->lock, NULL);
+  pthread_cond_init(&stream->chunkFilled, NULL);
+  pthread_cond_init(&stream->chunkFreed, NULL);
+
+  if (pthread_create(&stream->parser, NULL, climateStreamParser, stream) !=
+      0) {
+    logError("unable to start climate stream thread for %s\n", climFile);
+    exit(EXIT_CODE_INTERNAL_ERROR);
+  }
+
+  return stream;
+}
+
+// See climate.h
+ClimateData *nextClimateChunk(ClimateStream *stream) {
+  ClimateData *chunk = NULL;
+
+  pthread_mutex_lock(&stream->lock);
+  if (stream->holdingChunk) {
+    // Hand the previous chunk back to the parser
+    --stream->numFilled;
+    stream->holdingChunk = 0;
+    pthread_cond_signal(&stream->chunkFreed);
+  }
+  while ((stream->numFilled == 0) && !stream->done) {
+    pthread_cond_wait(&stream->chunkFilled, &stream->lock);
+  }
+  if (stream->numFilled > 0) {
+    chunk = stream->chunks[stream->useIndex];
+    stream->useIndex = (stream->useIndex + 1) % NUM_STREAM_CHUNKS;
+    stream->holdingChunk = 1;
+  }
+  pthread_mutex_unlock(&stream->lock);
+
+  return chunk;
+}
+
+// See climate.h
+void closeClimateStream(ClimateStream *stream) {
+  pthread_mutex_lock(&stream->lock);
+  stream->stop = 1;
+  pthread_cond_signal(&stream->chunkFreed);
+  pthread_mutex_unlock(&stream->lock);
+  pthread_join(stream->parser, NULL);
+
+  fclose(stream->reader.in);
+  for (int ind = 0; ind < NUM_STREAM_CHUNKS; ++ind) {
+    free(stream->chunks[ind]);
+  }
+  pthread_mutex_destroy(&stream->lock);
+  pthread_cond_destroy(&stream->chunkFilled);
+  pthread_cond_destroy(&stream->chunkFreed);
+  free(stream);
+}
@@ -0,0 +1,113 @@
+// header file for reading climate files
+//
+// Climate data can be read in two ways: all at once, into one ClimateData
+// struct holding every step of the run (see readClimate()), or streamed in
+// fixed-size chunks that a background thread parses while the model runs on
+// earlier chunks (see openClimateStream()). Streaming keeps memory use
+// constant no matter how long the climate record is.
+
+#ifndef SIPNET_CLIMATE_H
+#define SIPNET_CLIMATE_H
+
+#include "state.h"
+
+// Number of steps in each chunk of a climate stream (a little under a year of
+// half-hourly steps)
+#define CLIMATE_STREAM_CHUNK_STEPS 16384
+
+// Climate file being streamed in chunks; defined in climate.c
+typedef struct ClimateStream ClimateStream;
+
+// One record of a climate file, in the units of the file (before unit
+// conversions): time in hours, length in days (or negative seconds), par in
+// Einsteins m-2 over the step, precip in mm over the step, and vpd, vpdSoil
+// and vPress in Pa
+typedef struct ClimateRecord {
+  int loc;  // legacy format only
+  int year;
+  int day;
+  double time;
+  double length;
+  double tair;
+  double tsoil;
+  double par;
+  double precip;
+  double vpd;
+  double vpdSoil;
+  double vPress;
+  double wspd;
+  double soilWetness;  // legacy format only
+} ClimateRecord;
+
+/*!
+ * Read a climate file into newly allocated climate data
+ *
+ * Uses the binary climate cache when it is enabled and up to date, and
+ * (re)writes the cache otherwise; see climate_cache.h. With a met file
+ * (ctx.metFile), climFile is that NetCDF file, read with readNetcdfClimate().
+ *
+ * @param climFile name of climate file
+ * @return climate data for every step in the file; free with freeClimate()
+ */
+ClimateData *readClimate(const char *climFile);
+
+/*!
+ * Free climate data returned by readClimate()
+ */
+void freeClimate(ClimateData *climateData);
+
+/*!
+ * Make climate data for numSteps steps of climateData, starting at firstStep,
+ * without copying them
+ *
+ * @return a view of climateData's arrays, valid while climateData is; free
+ * with freeClimate(), which leaves the arrays alone
+ */
+ClimateData *newClimateView(const ClimateData *climateData, long firstStep,
+                            long numSteps);
+
+/*!
+ * Allocate climate data with room for capacity steps, with the struct and all
+ * of its arrays in one block; free with freeClimate()
+ */
+ClimateData *allocClimateData(long capacity);
+
+/*!
+ * Convert a record to model units and store it as the given step
+ *
+ * All climate readers store their steps through this, so the model gets the
+ * same values whatever format the climate came in.
+ */
+void storeClimateStep(ClimateData *data, long step, const ClimateRecord *rec);
+
+/*!
+ * Start streaming a climate file
+ *
+ * Starts a thread that parses the file into chunks of chunkSteps steps, a few
+ * chunks ahead of the consumer. The binary climate cache is neither read nor
+ * written.
+ *
+ * @param climFile name of climate file
+ * @param chunkSteps number of steps per chunk
+ * @return the stream; get chunks with nextClimateChunk(), and close it with
+ * closeClimateStream()
+ */
+ClimateStream *openClimateStream(const char *climFile, long chunkSteps);
+
+/*!
+ * Get the next chunk of a climate stream
+ *
+ * Waits for the chunk to be parsed if needed. The chunk returned by the
+ * previous call is handed back to the parser and must no longer be used.
+ *
+ * @param stream stream from openClimateStream()
+ * @return the next chunk of steps (never empty), or NULL after the last chunk
+ */
+ClimateData *nextClimateChunk(ClimateStream *stream);
+
+/*!
+ * Stop a climate stream and free its memory, including all chunks
+ */
+void closeClimateStream(ClimateStream *stream);
+
+#endif  // SIPNET_CLIMATE_H
@@ -0,0 +1,261 @@
+// Binary climate cache, written next to a text climate file and memory-mapped
+// by later runs; see climate_cache.h
+
+#include "climate_cache.h"
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "common/context.h"
+#include "common/exitCodes.h"
+#include "common/logging.h"
+
+#define CLIMATE_CACHE_MAGIC "SIPNETCB"
+#define CLIMATE_CACHE_MAGIC_LEN 8
+// Caches are written in native byte order; this marker doesn't match when the
+// cache was written on a machine with the other byte order
+#define CLIMATE_CACHE_BYTE_ORDER 0x01020304u
+
+#define NUM_CACHE_DOUBLE_VARS 11
+#define NUM_CACHE_INT_VARS 2
+
+// Header at the start of each cache file. The arrays follow it, each holding
+// numSteps values: first the double arrays, then the int arrays, in the order
+// given by getArraySlots().
+typedef struct ClimateCacheHeader {
+  char magic[CLIMATE_CACHE_MAGIC_LEN];
+  uint32_t version;
+  uint32_t byteOrder;
+  // Size and modification time of the text climate file the cache was made
+  // from
+  int64_t sourceSize;
+  int64_t sourceMtimeSec;
+  int64_t sourceMtimeNsec;
+  // Value of the gdd flag when the cache was written; the gdd array depends on
+  // it
+  int32_t gdd;
+  // sizeof(int) when the cache was written, for the year and day arrays
+  int32_t intSize;
+  int64_t numSteps;
+} ClimateCacheHeader;
+
+// Addresses of the array pointers in climateData, in cache file order
+static void getArraySlots(ClimateData *climateData,
+                          double **doubleSlots[NUM_CACHE_DOUBLE_VARS],
+                          int **intSlots[NUM_CACHE_INT_VARS]) {
+  doubleSlots[0] = &climateData->time;
+  doubleSlots[1] = &climateData->length;
+  doubleSlots[2] = &climateData->tair;
+  doubleSlots[3] = &climateData->tsoil;
+  doubleSlots[4] = &climateData->par;
+  doubleSlots[5] = &climateData->precip;
+  doubleSlots[6] = &climateData->vpd;
+  doubleSlots[7] = &climateData->vpdSoil;
+  doubleSlots[8] = &climateData->vPress;
+  doubleSlots[9] = &climateData->wspd;
+  doubleSlots[10] = &climateData->gdd;
+
+  intSlots[0] = &climateData->year;
+  intSlots[1] = &climateData->day;
+}
+
+// Size in bytes of a cache file holding numSteps steps
+static size_t getCacheSize(int64_t numSteps) {
+  return sizeof(ClimateCacheHeader) +
+         numSteps * (NUM_CACHE_DOUBLE_VARS * sizeof(double) +
+                     NUM_CACHE_INT_VARS * sizeof(int));
+}
+
+static void getModificationTime(const struct stat *fileStat, int64_t *sec,
+                                int64_t *nsec) {
+#ifdef __APPLE__
+  *sec = fileStat->st_mtimespec.tv_sec;
+  *nsec = fileStat->st_mtimespec.tv_nsec;
+#else
+  *sec = fileStat->st_mtim.tv_sec;
+  *nsec = fileStat->st_mtim.tv_nsec;
+#endif
+}
+
+// Fill in a header for a cache of the given source file; everything but
+// numSteps
+static void initCacheHeader(ClimateCacheHeader *header,
+                            const struct stat *sourceStat) {
+  memset(header, 0, sizeof(*header));
+  memcpy(header->magic, CLIMATE_CACHE_MAGIC, CLIMATE_CACHE_MAGIC_LEN);
+  header->version = CLIMATE_CACHE_VERSION;
+  header->byteOrder = CLIMATE_CACHE_BYTE_ORDER;
+  header->sourceSize = sourceStat->st_size;
+  getModificationTime(sourceStat, &header->sourceMtimeSec,
+                      &header->sourceMtimeNsec);
+  header->gdd = ctx.gdd;
+  header->intSize = sizeof(int);
+}
+
+// Return 1 if a cache with this header was made from the current source file
+// by a compatible build, 0 otherwise
+static int cacheHeaderMatches(const ClimateCacheHeader *header,
+                              const struct stat *sourceStat) {
+  ClimateCacheHeader expected;
+
+  initCacheHeader(&expected, sourceStat);
+  if (memcmp(header->magic, expected.magic, CLIMATE_CACHE_MAGIC_LEN) != 0) {
+    return 0;
+  }
+  return (header->version == expected.version) &&
+         (header->byteOrder == expected.byteOrder) &&
+         (header->sourceSize == expected.sourceSize) &&
+         (header->sourceMtimeSec == expected.sourceMtimeSec) &&
+         (header->sourceMtimeNsec == expected.sourceMtimeNsec) &&
+         (header->gdd == expected.gdd) &&
+         (header->intSize == expected.intSize) && (header->numSteps > 0);
+}
+
+// See climate_cache.h
+ClimateData *readClimateCache(const char *climFile) {
+  char cacheFile[FILENAME_MAXLEN + sizeof(CLIMATE_CACHE_SUFFIX)];
+  struct stat sourceStat, cacheStat;
+  ClimateCacheHeader header;
+  ClimateData *climateData;
+  double **doubleSlots[NUM_CACHE_DOUBLE_VARS];
+  int **intSlots[NUM_CACHE_INT_VARS];
+  void *mapping;
+  int fd;
+
+  snprintf(cacheFile, sizeof(cacheFile), "%s%s", climFile,
+           CLIMATE_CACHE_SUFFIX);
+  if (stat(climFile, &sourceStat) != 0) {
+    // Let the text reader report the missing file
+    return NULL;
+  }
+  fd = open(cacheFile, O_RDONLY);
+  if (fd < 0) {
+    return NULL;
+  }
+  if ((fstat(fd, &cacheStat) != 0) ||
+      (cacheStat.st_size < (off_t)sizeof(ClimateCacheHeader))) {
+    close(fd);
+    return NULL;
+  }
+  mapping = mmap(NULL, cacheStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    return NULL;
+  }
+
+  memcpy(&header, mapping, sizeof(header));
+  if (!cacheHeaderMatches(&header, &sourceStat) ||
+      (getCacheSize(header.numSteps) != (size_t)cacheStat.st_size)) {
+    logInfo("climate cache %s is out of date or incompatible; reading %s\n",
+            cacheFile, climFile);
+    munmap(mapping, cacheStat.st_size);
+    return NULL;
+  }
+
+  climateData = (ClimateData *)malloc(sizeof(ClimateData));
+  if (climateData == NULL) {
+    logError("memory allocation failure reading climate cache %s\n",
+             cacheFile);
+    exit(EXIT_CODE_INTERNAL_ERROR);
+  }
+  climateData->numSteps = header.numSteps;
+  climateData->mapping = mapping;
+  climateData->mappingSize = cacheStat.st_size;
+
+  getArraySlots(climateData, doubleSlots, intSlots);
+  double *doubles = (double *)((char *)mapping + sizeof(ClimateCacheHeader));
+  for (int ind = 0; ind < NUM_CACHE_DOUBLE_VARS; ++ind) {
+    *doubleSlots[ind] = doubles + ind * header.numSteps;
+  }
+  int *ints = (int *)(doubles + NUM_CACHE_DOUBLE_VARS * header.numSteps);
+  for (int ind = 0; ind < NUM_CACHE_INT_VARS; ++ind) {
+    *intSlots[ind] = ints + ind * header.numSteps;
+  }
+
+  logInfo("Read climate data from cache %s\n", cacheFile);
+
+  return climateData;
+}
+
+// See climate_cache.h
+void writeClimateCache(const char *climFile, const struct stat *sourceStat,
+                       const ClimateData *climateData) {
+  char cacheFile[FILENAME_MAXLEN + sizeof(CLIMATE_CACHE_SUFFIX)];
+  char tmpFile[sizeof(cacheFile) + sizeof(".XXXXXX")];
+  struct stat currentStat;
+  ClimateCacheHeader header;
+  double **doubleSlots[NUM_CACHE_DOUBLE_VARS];
+  int **intSlots[NUM_CACHE_INT_VARS];
+  size_t numSteps = climateData->numSteps;
+  FILE *out;
+  int fd, ok;
+
+  snprintf(cacheFile, sizeof(cacheFile), "%s%s", climFile,
+           CLIMATE_CACHE_SUFFIX);
+  snprintf(tmpFile, sizeof(tmpFile), "%s.XXXXXX", cacheFile);
+  initCacheHeader(&header, sourceStat);
+  header.numSteps = climateData->numSteps;
+  if (stat(climFile, &currentStat) != 0) {
+    logWarning("unable to write climate cache %s; continuing without it\n",
+               cacheFile);
+    return;
+  }
+  // A file rewritten while it was parsed may not match the data read, which
+  // would otherwise be cached under the new file's key
+  if (!cacheHeaderMatches(&header, &currentStat)) {
+    logWarning("%s changed while it was read; not writing climate cache %s\n",
+               climFile, cacheFile);
+    return;
+  }
+
+  // Write to a temporary file, then rename it into place, so that other runs
+  // never see a partly written cache
+  fd = mkstemp(tmpFile);
+  if (fd < 0) {
+    logWarning("unable to write climate cache %s; continuing without it\n",
+               cacheFile);
+    return;
+  }
+  fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+  out = fdopen(fd, "wb");
+  if (out == NULL) {
+    close(fd);
+    unlink(tmpFile);
+    logWarning("unable to write climate cache %s; continuing without it\n",
+               cacheFile);
+    return;
+  }
+
+  // getArraySlots only hands back the array pointers; nothing is modified
+  getArraySlots((ClimateData *)climateData, doubleSlots, intSlots);
+  ok = (fwrite(&header, sizeof(header), 1, out) == 1);
+  for (int ind = 0; ok && ind < NUM_CACHE_DOUBLE_VARS; ++ind) {
+    ok = (fwrite(*doubleSlots[ind], sizeof(double), numSteps, out) ==
+          numSteps);
+  }
+  for (int ind = 0; ok && ind < NUM_CACHE_INT_VARS; ++ind) {
+    ok = (fwrite(*intSlots[ind], sizeof(int), numSteps, out) == numSteps);
+  }
+  ok = (fclose(out) == 0) && ok;
+  ok = ok && (rename(tmpFile, cacheFile) == 0);
+
+  if (!ok) {
+    unlink(tmpFile);
+    logWarning("unable to write climate cache %s; continuing without it\n",
+               cacheFile);
+    return;
+  }
+  logInfo("Wrote climate cache %s\n", cacheFile);
+}
+
+// See climate_cache.h
+void freeClimateCache(ClimateData *climateData) {
+  munmap(climateData->mapping, climateData->mappingSize);
+  free(climateData);
+}
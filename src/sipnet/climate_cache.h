@@ -0,0 +1,52 @@
+// header file for the binary climate cache
+//
+// Parsing a long text climate file dominates startup, so the first run over
+// <name>.clim saves the parsed, unit-converted data to <name>.climb. Later
+// runs map that file into memory instead of parsing the text again, as long as
+// the text file's size and modification time still match the ones recorded in
+// the cache header.
+
+#ifndef SIPNET_CLIMATE_CACHE_H
+#define SIPNET_CLIMATE_CACHE_H
+
+#include <sys/stat.h>
+
+#include "state.h"
+
+// Bump this whenever the layout of the cache file changes
+#define CLIMATE_CACHE_VERSION 1
+
+// Suffix appended to the climate file name to get the cache file name
+#define CLIMATE_CACHE_SUFFIX "b"
+
+/*!
+ * Map the cache for a climate file into memory, if it is up to date
+ *
+ * @param climFile name of the text climate file
+ * @return climate data backed by the mapped cache, or NULL if there is no
+ * usable cache (missing, stale, or written by an incompatible build); free
+ * with freeClimateCache()
+ */
+ClimateData *readClimateCache(const char *climFile);
+
+/*!
+ * Save climate data parsed from a text climate file to its cache
+ *
+ * Failing to write the cache is not an error; a warning is logged and the run
+ * carries on without it. Nor is it written if the climate file's size or
+ * modification time have changed since sourceStat was taken.
+ *
+ * @param climFile name of the text climate file the data was read from
+ * @param sourceStat stat() of climFile taken before it was parsed; the cache
+ * is keyed on it
+ * @param climateData parsed climate data
+ */
+void writeClimateCache(const char *climFile, const struct stat *sourceStat,
+                       const ClimateData *climateData);
+
+/*!
+ * Release climate data returned by readClimateCache()
+ */
+void freeClimateCache(ClimateData *climateData);
+
+#endif  // SIPNET_CLIMATE_CACHE_H
@@ -0,0 +1,551 @@
+// Reading NetCDF met files; see climate_netcdf.h
+
+#include "climate_netcdf.h"
+
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "common/context.h"
+#include "common/exitCodes.h"
+#include "common/logging.h"
+
+#include "climate.h"
+
+#define SECONDS_PER_DAY 86400
+
+// Days from 1970-01-01 to year-month-day in the standard (proleptic
+// Gregorian) calendar
+static long long daysFromCivil(long long year, int month, int day) {
+  long long era, yearOfEra, dayOfYear, dayOfEra;
+
+  year -= (month <= 2);
+  era = ((year >= 0) ? year : year - 399) / 400;
+  yearOfEra = year - era * 400;
+  dayOfYear = (153 * (month + ((month > 2) ? -3 : 9)) + 2) / 5 + day - 1;
+  dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+  return era * 146097 + dayOfEra - 719468;
+}
+
+// Year of the day that is days after 1970-01-01; the inverse of
+// daysFromCivil()
+static long long yearFromDays(long long days) {
+  long long era, dayOfEra, yearOfEra, dayOfYear, monthIndex;
+
+  days += 719468;
+  era = ((days >= 0) ? days : days - 146096) / 146097;
+  dayOfEra = days - era * 146097;
+  yearOfEra =
+      (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+  dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+  monthIndex = (5 * dayOfYear + 2) / 153;  // 0 for March
+  return yearOfEra + era * 400 + (monthIndex >= 10);
+}
+
+// Seconds in unit, one of the CF time units; 0 if it isn't one
+static double cfUnitSeconds(const char *unit, size_t len) {
+  static const struct {
+    const char *name;
+    double seconds;
+  } units[] = {{"days", 86400},   {"day", 86400},    {"d", 86400},
+               {"hours", 3600},   {"hour", 3600},    {"hrs", 3600},
+               {"hr", 3600},      {"h", 3600},       {"minutes", 60},
+               {"minute", 60},    {"mins", 60},      {"min", 60},
+               {"seconds", 1},    {"second", 1},     {"secs", 1},
+               {"sec", 1},        {"s", 1}};
+
+  for (size_t ind = 0; ind < sizeof(units) / sizeof(units[0]); ++ind) {
+    if ((strlen(units[ind].name) == len) &&
+        (strncasecmp(units[ind].name, unit, len) == 0)) {
+      return units[ind].seconds;
+    }
+  }
+  return 0;
+}
+
+// See climate_netcdf.h
+int parseCFTimeUnits(const char *units, double *secondsPerUnit,
+                     long long *baseSeconds) {
+  const char *curr = units;
+  size_t len;
+  int year, month, day, hour = 0, minute = 0, numRead;
+  double second = 0;
+
+  while (isspace((unsigned char)*curr)) {
+    ++curr;
+  }
+  len = strcspn(curr, " \t");
+  *secondsPerUnit = cfUnitSeconds(curr, len);
+  if (*secondsPerUnit == 0) {
+    return 0;
+  }
+  curr += len;
+  if ((sscanf(curr, " since %d-%d-%d%n", &year, &month, &day, &numRead) != 3) ||
+      (month < 1) || (month > 12) || (day < 1) || (day > 31)) {
+    return 0;
+  }
+  curr += numRead;
+
+  // Optional time of day
+  if ((*curr == 'T') || (*curr == ' ')) {
+    int timeRead = 0;
+    if (sscanf(curr + 1, "%d:%d%n", &hour, &minute, &timeRead) == 2) {
+      curr += 1 + timeRead;
+      if (*curr == ':') {
+        if (sscanf(curr + 1, "%lf%n", &second, &timeRead) != 1) {
+          return 0;
+        }
+        curr += 1 + timeRead;
+      }
+    }
+  }
+  // Optional UTC time zone
+  while (isspace((unsigned char)*curr)) {
+    ++curr;
+  }
+  if ((*curr == 'Z') || (strncmp(curr, "+00:00", 6) == 0)) {
+    curr += (*curr == 'Z') ? 1 : 6;
+  } else if (strncmp(curr, "UTC", 3) == 0) {
+    curr += 3;
+  }
+  while (isspace((unsigned char)*curr)) {
+    ++curr;
+  }
+  if (*curr != '\0') {
+    return 0;
+  }
+
+  *baseSeconds = daysFromCivil(year, month, day) * SECONDS_PER_DAY +
+                 hour * 3600 + minute * 60 + llround(second);
+  return 1;
+}
+
+// See climate_netcdf.h
+void cfTimeToDate(long long seconds, int *year, int *day, double *hour) {
+  long long days = seconds / SECONDS_PER_DAY;
+  long long secondOfDay = seconds % SECONDS_PER_DAY;
+
+  if (secondOfDay < 0) {
+    secondOfDay += SECONDS_PER_DAY;
+    --days;
+  }
+  *year = (int)yearFromDays(days);
+  *day = (int)(days - daysFromCivil(*year, 1, 1)) + 1;
+  *hour = secondOfDay / 3600.0;
+}
+
+#ifdef SIPNET_NETCDF
+
+#include <netcdf.h>
+
+// Standard pressure, for files without air pressure, in Pa
+#define STANDARD_PRESSURE 101325.0
+// Fraction of shortwave radiation that is PAR, and photons per joule of PAR
+// in mol J-1; as in PEcAn's conversion of shortwave to PAR
+#define SW_PAR_FRACTION 0.486
+#define PAR_MOL_PER_JOULE (1.0e-6 / 0.235)
+
+// Units a variable may be in, and the conversion to the units the reader
+// works in: value * scale + offset
+typedef struct MetUnits {
+  const char *units;
+  double scale;
+  double offset;
+} MetUnits;
+
+static const MetUnits temperatureUnits[] = {{"K", 1, -273.15},
+                                            {"degC", 1, 0},
+                                            {"degree_Celsius", 1, 0},
+                                            {"celsius", 1, 0},
+                                            {NULL, 0, 0}};
+static const MetUnits massFluxUnits[] = {{"kg m-2 s-1", 1, 0},
+                                         {"kg/m2/s", 1, 0},
+                                         {"mm s-1", 1, 0},
+                                         {"mm/s", 1, 0},
+                                         {NULL, 0, 0}};
+static const MetUnits photonFluxUnits[] = {{"mol m-2 s-1", 1, 0},
+                                           {"umol m-2 s-1", 1.0e-6, 0},
+                                           {NULL, 0, 0}};
+static const MetUnits energyFluxUnits[] = {
+    {"W m-2", 1, 0}, {"W/m2", 1, 0}, {"W/m^2", 1, 0}, {NULL, 0, 0}};
+static const MetUnits humidityUnits[] = {{"kg kg-1", 1, 0},
+                                         {"kg/kg", 1, 0},
+                                         {"1", 1, 0},
+                                         {"g kg-1", 1.0e-3, 0},
+                                         {NULL, 0, 0}};
+static const MetUnits pressureUnits[] = {
+    {"Pa", 1, 0}, {"hPa", 100, 0}, {"kPa", 1000, 0}, {NULL, 0, 0}};
+static const MetUnits speedUnits[] = {
+    {"m s-1", 1, 0}, {"m/s", 1, 0}, {NULL, 0, 0}};
+
+// An open met file, and the steps being read from it
+typedef struct MetFile {
+  const char *path;
+  int ncid;
+  int timeDim;
+  size_t numTimes;
+  size_t start;  // first step read
+  size_t count;  // number of steps read
+} MetFile;
+
+static void checkMet(const MetFile *met, int status, const char *what) {
+  if (status != NC_NOERR) {
+    logError("met file %s: error reading %s: %s\n", met->path, what,
+             nc_strerror(status));
+    exit(EXIT_CODE_FILE_OPEN_OR_READ_ERROR);
+  }
+}
+
+static void *allocOrExit(size_t size) {
+  void *ptr = malloc(size);
+
+  if (ptr == NULL) {
+    logError("memory allocation failure reading met file\n");
+    exit(EXIT_CODE_INTERNAL_ERROR);
+  }
+  return ptr;
+}
+
+// Id of the variable with the given name, or -1 if there is none
+static int findMetVar(const MetFile *met, const char *name) {
+  int varid;
+
+  if (nc_inq_varid(met->ncid, name, &varid) != NC_NOERR) {
+    return -1;
+  }
+  return varid;
+}
+
+// Id of the variable with the given name; exits if there is none
+static int requireMetVar(const MetFile *met, const char *name) {
+  int varid = findMetVar(met, name);
+
+  if (varid < 0) {
+    logError("met file %s has no %s variable\n", met->path, name);
+    exit(EXIT_CODE_INPUT_FILE_ERROR);
+  }
+  return varid;
+}
+
+// Read a text attribute of a variable into value; return 0 if there is none
+static int getTextAttribute(const MetFile *met, int varid, const char *name,
+                            char *value, size_t size) {
+  size_t len;
+
+  if ((nc_inq_attlen(met->ncid, varid, name, &len) != NC_NOERR) ||
+      (len >= size)) {
+    return 0;
+  }
+  checkMet(met, nc_get_att_text(met->ncid, varid, name, value), name);
+  value[len] = '\0';
+  return 1;
+}
+
+// Read a numeric attribute of a variable into value; return 0 if there is none
+static int getDoubleAttribute(const MetFile *met, int varid, const char *name,
+                              double *value) {
+  size_t len;
+
+  if ((nc_inq_attlen(met->ncid, varid, name, &len) != NC_NOERR) ||
+      (len != 1)) {
+    return 0;
+  }
+  return nc_get_att_double(met->ncid, varid, name, value) == NC_NOERR;
+}
+
+// Read the steps being read of a variable into values, converted from its
+// units (which must be one of those listed) and unpacked
+static void readMetVar(const MetFile *met, const char *name,
+                       const MetUnits *units, double *values) {
+  int varid = requireMetVar(met, name);
+  int numDims, dims[NC_MAX_VAR_DIMS], hasTime = 0;
+  size_t start[NC_MAX_VAR_DIMS], count[NC_MAX_VAR_DIMS];
+  char unitsText[NC_MAX_NAME + 1];
+  double fill, missing, scale = 1, offset = 0;
+  int hasFill, hasMissing;
+  const MetUnits *unit;
+
+  checkMet(met, nc_inq_varndims(met->ncid, varid, &numDims), name);
+  checkMet(met, nc_inq_vardimid(met->ncid, varid, dims), name);
+  for (int dim = 0; dim < numDims; ++dim) {
+    if (dims[dim] == met->timeDim) {
+      start[dim] = met->start;
+      count[dim] = met->count;
+      hasTime = 1;
+    } else {
+      size_t len;
+      checkMet(met, nc_inq_dimlen(met->ncid, dims[dim], &len), name);
+      if (len != 1) {
+        logError("met file %s: %s has more than one site; only single-site "
+                 "files are supported\n",
+                 met->path, name);
+        exit(EXIT_CODE_INPUT_FILE_ERROR);
+      }
+      start[dim] = 0;
+      count[dim] = 1;
+    }
+  }
+  if (!hasTime) {
+    logError("met file %s: %s is not along time\n", met->path, name);
+    exit(EXIT_CODE_INPUT_FILE_ERROR);
+  }
+
+  if (!getTextAttribute(met, varid, "units", unitsText, sizeof(unitsText))) {
+    logError("met file %s: %s has no units\n", met->path, name);
+    exit(EXIT_CODE_INPUT_FILE_ERROR);
+  }
+  for (unit = units; unit->units != NULL; ++unit) {
+    if (strcmp(unit->units, unitsText) == 0) {
+      break;
+    }
+  }
+  if (unit->units == NULL) {
+    logError("met file %s: %s has unsupported units '%s'; expected '%s'\n",
+             met->path, name, unitsText, units[0].units);
+    exit(EXIT_CODE_INPUT_FILE_ERROR);
+  }
+
+  checkMet(met, nc_get_vara_double(met->ncid, varid, start, count, values),
+           name);
+
+  hasFill = getDoubleAttribute(met, varid, "_FillValue", &fill);
+  hasMissing = getDoubleAttribute(met, varid, "missing_value", &missing);
+  getDoubleAttribute(met, varid, "scale_factor", &scale);
+  getDoubleAttribute(met, varid, "add_offset", &offset);
+  for (size_t step = 0; step < met->count; ++step) {
+    if ((hasFill && (values[step] == fill)) ||
+        (hasMissing && (values[step] == missing)) || isnan(values[step])) {
+      logError("met file %s: %s is missing at step %zu\n", met->path, name,
+               met->start + step);
+      exit(EXIT_CODE_INPUT_FILE_ERROR);
+    }
+    values[step] = (values[step] * scale + offset) * unit->scale + unit->offset;
+  }
+}
+
+// Read the time coordinate, and choose the steps in the years of
+// ctx.metYears; returns the time of each step in the file, in seconds since
+// 1970
+static long long *readMetTimes(MetFile *met) {
+  int varid = requireMetVar(met, "time");
+  int numDims, firstYear, lastYear, found = 0;
+  char text[NC_MAX_NAME + 1];
+  double secondsPerUnit, *values;
+  long long baseSeconds, *seconds;
+  size_t first = 0, last = 0;
+
+  checkMet(met, nc_inq_varndims(met->ncid, varid, &numDims), "time");
+  if (numDims != 1) {
+    logError("met file %s: time must have one dimension\n", met->path);
+    exit(EXIT_CODE_INPUT_FILE_ERROR);
+  }
+  checkMet(met, nc_inq_vardimid(met->ncid, varid, &met->timeDim), "time");
+  checkMet(met, nc_inq_dimlen(met->ncid, met->timeDim, &met->numTimes),
+           "time");
+  if (met->numTimes == 0) {
+    logError("no climate data in %s\n", met->path);
+    exit(EXIT_CODE_INPUT_FILE_ERROR);
+  }
+
+  if (!getTextAttribute(met, varid, "units", text, sizeof(text)) ||
+      !parseCFTimeUnits(text, &secondsPerUnit, &baseSeconds)) {
+    logError("met file %s: time needs units of the form '<unit> since "
+             "<date>'\n",
+             met->path);
+    exit(EXIT_CODE_INPUT_FILE_ERROR);
+  }
+  if (getTextAttribute(met, varid, "calendar", text, sizeof(text)) &&
+      (strcmp(text, "standard") != 0) && (strcmp(text, "gregorian") != 0) &&
+      (strcmp(text, "proleptic_gregorian") != 0)) {
+    logError("met file %s: calendar %s is not supported; use standard\n",
+             met->path, text);
+    exit(EXIT_CODE_INPUT_FILE_ERROR);
+  }
+
+  values = (double *)allocOrExit(met->numTimes * sizeof(double));
+  seconds = (long long *)allocOrExit(met->numTimes * sizeof(long long));
+  checkMet(met, nc_get_var_double(met->ncid, varid, values), "time");
+  for (size_t step = 0; step < met->numTimes; ++step) {
+    seconds[step] = baseSeconds + llround(values[step] * secondsPerUnit);
+    if ((step > 0) && (seconds[step] <= seconds[step - 1])) {
+      logError("met file %s: times must increase (step %zu)\n", met->path,
+               step);
+      exit(EXIT_CODE_INPUT_FILE_ERROR);
+    }
+  }
+  free(values);
+
+  // Times increase, so the steps in the selected years are consecutive
+  parseMetYears(ctx.metYears, &firstYear, &lastYear);
+  for (size_t step = 0; step < met->numTimes; ++step) {
+    int year, day;
+    double hour;
+    cfTimeToDate(seconds[step], &year, &day, &hour);
+    if ((year >= firstYear) && (year <= lastYear)) {
+      if (!found) {
+        first = step;
+        found = 1;
+      }
+      last = step;
+    }
+  }
+  if (!found) {
+    logError("met file %s has no steps in met-years %s\n", met->path,
+             ctx.metYears);
+    exit(EXIT_CODE_BAD_PARAMETER_VALUE);
+  }
+  met->start = first;
+  met->count = last - first + 1;
+
+  return seconds;
+}
+
+// Saturation vapor pressure over water at temp (degC), in Pa; the Bolton
+// (1980) formula PEcAn uses to convert specific humidity
+static double saturationVaporPressure(double temp) {
+  return 611.2 * exp(17.67 * temp / (temp + 243.5));
+}
+
+// See climate_netcdf.h
+int hasNetcdfClimate(void) { return 1; }
+
+// See climate_netcdf.h
+ClimateData *readNetcdfClimate(const char *metFile) {
+  MetFile met;
+  ClimateData *data;
+  long long *seconds;
+  double *tair, *tsoil, *par, *precip, *humidity, *pressure, *wind, *windV;
+  int status;
+
+  memset(&met, 0, sizeof(met));
+  met.path = metFile;
+  status = nc_open(metFile, NC_NOWRITE, &met.ncid);
+  if (status != NC_NOERR) {
+    logError("Error opening met file %s: %s\n", metFile, nc_strerror(status));
+    exit(EXIT_CODE_FILE_OPEN_OR_READ_ERROR);
+  }
+  seconds = readMetTimes(&met);
+
+  tair = (double *)allocOrExit(met.count * sizeof(double));
+  tsoil = (double *)allocOrExit(met.count * sizeof(double));
+  par = (double *)allocOrExit(met.count * sizeof(double));
+  precip = (double *)allocOrExit(met.count * sizeof(double));
+  humidity = (double *)allocOrExit(met.count * sizeof(double));
+  pressure = (double *)allocOrExit(met.count * sizeof(double));
+  wind = (double *)allocOrExit(met.count * sizeof(double));
+  windV = NULL;
+
+  readMetVar(&met, "air_temperature", temperatureUnits, tair);
+  if (findMetVar(&met, "soil_temperature") >= 0) {
+    readMetVar(&met, "soil_temperature", temperatureUnits, tsoil);
+  } else {
+    // Soil respiration and soil evaporation then follow air temperature
+    logWarning("met file %s has no soil_temperature; using air_temperature "
+               "for soil temperature\n",
+               metFile);
+    memcpy(tsoil, tair, met.count * sizeof(double));
+  }
+  readMetVar(&met, "precipitation_flux", massFluxUnits, precip);
+  if (findMetVar(&met,
+                 "surface_downwelling_photosynthetic_photon_flux_in_air") >=
+      0) {
+    readMetVar(&met, "surface_downwelling_photosynthetic_photon_flux_in_air",
+               photonFluxUnits, par);
+  } else {
+    readMetVar(&met, "surface_downwelling_shortwave_flux_in_air",
+               energyFluxUnits, par);
+    for (size_t step = 0; step < met.count; ++step) {
+      par[step] *= SW_PAR_FRACTION * PAR_MOL_PER_JOULE;
+    }
+  }
+  readMetVar(&met, "specific_humidity", humidityUnits, humidity);
+  if (findMetVar(&met, "air_pressure") >= 0) {
+    readMetVar(&met, "air_pressure", pressureUnits, pressure);
+  } else {
+    for (size_t step = 0; step < met.count; ++step) {
+      pressure[step] = STANDARD_PRESSURE;
+    }
+  }
+  if (findMetVar(&met, "wind_speed") >= 0) {
+    readMetVar(&met, "wind_speed", speedUnits, wind);
+  } else {
+    windV = (double *)allocOrExit(met.count * sizeof(double));
+    readMetVar(&met, "eastward_wind", speedUnits, wind);
+    readMetVar(&met, "northward_wind", speedUnits, windV);
+    for (size_t step = 0; step < met.count; ++step) {
+      wind[step] = hypot(wind[step], windV[step]);
+    }
+  }
+  checkMet(&met, nc_close(met.ncid), "the file");
+
+  // Build the record a .clim file would hold for each step, and convert it
+  // as for a .clim file
+  data = allocClimateData((long)met.count);
+  for (size_t step = 0; step < met.count; ++step) {
+    size_t fileStep = met.start + step;
+    ClimateRecord rec;
+    long long lengthSec;
+    double vaporPressure, saturated, saturatedSoil;
+
+    // Each step lasts until the next; the last one as long as the one before
+    if (fileStep + 1 < met.numTimes) {
+      lengthSec = seconds[fileStep + 1] - seconds[fileStep];
+    } else if (fileStep > 0) {
+      lengthSec = seconds[fileStep] - seconds[fileStep - 1];
+    } else {
+      lengthSec = SECONDS_PER_DAY;
+    }
+
+    memset(&rec, 0, sizeof(rec));
+    cfTimeToDate(seconds[fileStep], &rec.year, &rec.day, &rec.time);
+    rec.length = (double)lengthSec / SECONDS_PER_DAY;
+    rec.tair = tair[step];
+    rec.tsoil = tsoil[step];
+    // Fluxes to amounts over the step: mol m-2 (Einsteins), and kg m-2 (mm)
+    rec.par = par[step] * lengthSec;
+    rec.precip = precip[step] * lengthSec;
+    // Vapor pressure from specific humidity, capped at saturation
+    vaporPressure = humidity[step] * pressure[step] /
+                    (0.622 + 0.378 * humidity[step]);
+    saturated = saturationVaporPressure(tair[step]);
+    saturatedSoil = saturationVaporPressure(tsoil[step]);
+    rec.vPress = (vaporPressure < saturated) ? vaporPressure : saturated;
+    rec.vpd = saturated - rec.vPress;
+    rec.vpdSoil = (vaporPressure < saturatedSoil)
+                      ? saturatedSoil - vaporPressure
+                      : 0;
+    rec.wspd = wind[step];
+    storeClimateStep(data, (long)step, &rec);
+  }
+  data->numSteps = (long)met.count;
+
+  free(seconds);
+  free(tair);
+  free(tsoil);
+  free(par);
+  free(precip);
+  free(humidity);
+  free(pressure);
+  free(wind);
+  free(windV);
+
+  return data;
+}
+
+#else  // SIPNET_NETCDF
+
+// See climate_netcdf.h
+int hasNetcdfClimate(void) { return 0; }
+
+// See climate_netcdf.h
+ClimateData *readNetcdfClimate(const char *metFile) {
+  logError("this build of SIPNET can't read NetCDF met file %s; rebuild with "
+           "make NETCDF=1\n",
+           metFile);
+  exit(EXIT_CODE_BAD_PARAMETER_VALUE);
+}
+
+#endif  // SIPNET_NETCDF
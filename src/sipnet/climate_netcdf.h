@@ -0,0 +1,76 @@
+// header file for reading NetCDF met files
+//
+// With --met-file, climate is read from a NetCDF file with CF variables, as
+// written by PEcAn's met workflows, instead of from <file-prefix>.clim. The
+// variables are converted to the values a .clim file made from the same data
+// would hold, and stored through the same conversions as a .clim file (see
+// storeClimateStep()), so the model sees the same forcing either way; the
+// conversion to .clim text is skipped.
+//
+// The file must have a time coordinate variable, "time", with CF units
+// ("<unit> since <date>") and a standard calendar, and these variables along
+// time (any other dimensions must have length 1, as for a single site):
+//    air_temperature                   K or degC
+//    precipitation_flux                kg m-2 s-1
+//    surface_downwelling_photosynthetic_photon_flux_in_air
+//                                      mol m-2 s-1 (or umol m-2 s-1); if
+//                                      missing, PAR is estimated from
+//    surface_downwelling_shortwave_flux_in_air
+//                                      W m-2
+//    specific_humidity                 kg kg-1
+//    air_pressure                      Pa (optional; standard pressure if
+//                                      missing)
+//    wind_speed                        m s-1; or eastward_wind and
+//                                      northward_wind
+//    soil_temperature                  K or degC (optional; air temperature,
+//                                      with a warning, if missing)
+//
+// Only these variables are read, and only the steps in the years selected by
+// --met-years.
+//
+// The reader needs the system libnetcdf, and is only built when SIPNET_NETCDF
+// is defined (make NETCDF=1). The CF time functions below are always built.
+
+#ifndef SIPNET_CLIMATE_NETCDF_H
+#define SIPNET_CLIMATE_NETCDF_H
+
+#include "state.h"
+
+/*!
+ * Nonzero if this build can read NetCDF met files
+ */
+int hasNetcdfClimate(void);
+
+/*!
+ * Read the selected years of a NetCDF met file into newly allocated climate
+ * data
+ *
+ * Exits with an error if the file can't be read, or lacks a variable it needs.
+ *
+ * @param metFile name of NetCDF met file
+ * @return climate data for every step read; free with freeClimate()
+ */
+ClimateData *readNetcdfClimate(const char *metFile);
+
+/*!
+ * Parse CF time units, "<unit> since <date>", where unit is days, hours,
+ * minutes or seconds (or their singular or abbreviated forms), and date is
+ * YYYY-MM-DD, optionally followed by a time, hh:mm or hh:mm:ss, after a space
+ * or 'T'
+ *
+ * @param units units attribute of a CF time variable
+ * @param secondsPerUnit set to the length of one unit, in seconds
+ * @param baseSeconds set to the time of the date, in seconds since
+ *                    1970-01-01 00:00:00
+ * @return nonzero if units could be parsed
+ */
+int parseCFTimeUnits(const char *units, double *secondsPerUnit,
+                     long long *baseSeconds);
+
+/*!
+ * Convert a time in seconds since 1970-01-01 00:00:00 (standard calendar) to
+ * year, day of year (1 for January 1) and hour of day
+ */
+void cfTimeToDate(long long seconds, int *year, int *day, double *hour);
+
+#endif  // SIPNET_CLIMATE_NETCDF_H
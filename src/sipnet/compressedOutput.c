@@ -0,0 +1,304 @@
+// Compressed output files; see compressedOutput.h
+
+// For fopencookie()
+#define _GNU_SOURCE
+
+#include "compressedOutput.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+
+#include "common/context.h"
+#include "common/exitCodes.h"
+#include "common/logging.h"
+#include "common/util.h"
+
+#ifdef SIPNET_ZLIB
+#include <zlib.h>
+#endif
+#ifdef SIPNET_ZSTD
+#include <zstd.h>
+#endif
+
+#if defined(SIPNET_ZLIB) || defined(SIPNET_ZSTD)
+
+typedef enum CompressionMethod { METHOD_GZIP, METHOD_ZSTD } CompressionMethod;
+
+// gzip output: deflate with a gzip header and trailer (windowBits 15, plus 16
+// for the gzip wrapper)
+#define GZIP_WINDOW_BITS (15 + 16)
+#define GZIP_MEM_LEVEL 8
+
+// The state behind one compressed stream
+typedef struct CompressedFile {
+  char *path;
+  FILE *raw;  // the file the compressed bytes go to
+  CompressionMethod method;
+#ifdef SIPNET_ZLIB
+  z_stream gzip;
+#endif
+#ifdef SIPNET_ZSTD
+  ZSTD_CStream *zstd;
+#endif
+  unsigned char *block;  // compressed bytes, before they are written to raw
+  int failed;  // nonzero once an error has been reported
+} CompressedFile;
+
+static void *allocOrExit(size_t size) {
+  void *ptr = malloc(size);
+
+  if (ptr == NULL) {
+    logError("memory allocation failure for compressed output\n");
+    exit(EXIT_CODE_INTERNAL_ERROR);
+  }
+  return ptr;
+}
+
+// Write numBytes of the compressed block to the file; nonzero on success
+static int writeBlock(CompressedFile *file, size_t numBytes) {
+  if (numBytes > 0 && fwrite(file->block, 1, numBytes, file->raw) != numBytes) {
+    if (!file->failed) {
+      logError("Error writing '%s': %s\n", file->path, strerror(errno));
+      file->failed = 1;
+    }
+    return 0;
+  }
+  return 1;
+}
+
+static void compressError(CompressedFile *file, const char *message) {
+  if (!file->failed) {
+    logError("Error compressing '%s': %s\n", file->path, message);
+    file->failed = 1;
+  }
+}
+
+#ifdef SIPNET_ZLIB
+// Compress size bytes of data, or finish the stream if finish is nonzero;
+// nonzero on success
+static int gzipBytes(CompressedFile *file, const char *data, size_t size,
+                     int finish) {
+  z_stream *strm = &file->gzip;
+  int flush = finish ? Z_FINISH : Z_NO_FLUSH;
+  int status;
+
+  strm->next_in = (Bytef *)data;
+  strm->avail_in = (uInt)size;
+  do {
+    strm->next_out = file->block;
+    strm->avail_out = COMPRESSED_OUTPUT_BLOCK;
+    status = deflate(strm, flush);
+    if (status == Z_STREAM_ERROR) {
+      compressError(file, "deflate failed");
+      return 0;
+    }
+    if (!writeBlock(file, COMPRESSED_OUTPUT_BLOCK - strm->avail_out)) {
+      return 0;
+    }
+  } while (strm->avail_out == 0 || (finish && status != Z_STREAM_END));
+  return 1;
+}
+#endif
+
+#ifdef SIPNET_ZSTD
+// As gzipBytes(), for zstd
+static int zstdBytes(CompressedFile *file, const char *data, size_t size,
+                     int finish) {
+  ZSTD_inBuffer in = {data, size, 0};
+  ZSTD_EndDirective mode = finish ? ZSTD_e_end : ZSTD_e_continue;
+  size_t remaining;
+
+  do {
+    ZSTD_outBuffer out = {file->block, COMPRESSED_OUTPUT_BLOCK, 0};
+    remaining = ZSTD_compressStream2(file->zstd, &out, &in, mode);
+    if (ZSTD_isError(remaining)) {
+      compressError(file, ZSTD_getErrorName(remaining));
+      return 0;
+    }
+    if (!writeBlock(file, out.pos)) {
+      return 0;
+    }
+  } while (in.pos < in.size || (finish && remaining > 0));
+  return 1;
+}
+#endif
+
+static int compressBytes(CompressedFile *file, const char *data, size_t size,
+                         int finish) {
+  switch (file->method) {
+#ifdef SIPNET_ZLIB
+    case METHOD_GZIP:
+      return gzipBytes(file, data, size, finish);
+#endif
+#ifdef SIPNET_ZSTD
+    case METHOD_ZSTD:
+      return zstdBytes(file, data, size, finish);
+#endif
+    default:
+      return 0;
+  }
+}
+
+// Called by the stream with each full block (and the last, partial one)
+static size_t writeCompressed(void *cookie, const char *buf, size_t size) {
+  CompressedFile *file = (CompressedFile *)cookie;
+
+  if (file->failed || !compressBytes(file, buf, size, 0)) {
+    return 0;
+  }
+  return size;
+}
+
+// Called by fclose(), after the last block has been written
+static int closeCompressed(void *cookie) {
+  CompressedFile *file = (CompressedFile *)cookie;
+  int ok = !file->failed && compressBytes(file, NULL, 0, 1);
+
+#ifdef SIPNET_ZLIB
+  if (file->method == METHOD_GZIP) {
+    deflateEnd(&file->gzip);
+  }
+#endif
+#ifdef SIPNET_ZSTD
+  if (file->method == METHOD_ZSTD) {
+    ZSTD_freeCStream(file->zstd);
+  }
+#endif
+  if (fclose(file->raw) != 0 && ok) {
+    logError("Error writing '%s': %s\n", file->path, strerror(errno));
+    ok = 0;
+  }
+  free(file->block);
+  free(file->path);
+  free(file);
+  return ok ? 0 : EOF;
+}
+
+#ifdef __APPLE__
+// BSD stdio has funopen() rather than fopencookie()
+static int writeCompressedBSD(void *cookie, const char *buf, int size) {
+  return (int)writeCompressed(cookie, buf, (size_t)size);
+}
+
+static FILE *openCookie(CompressedFile *file) {
+  return funopen(file, NULL, writeCompressedBSD, NULL, closeCompressed);
+}
+#else
+static ssize_t writeCompressedGNU(void *cookie, const char *buf, size_t size) {
+  return (ssize_t)writeCompressed(cookie, buf, size);
+}
+
+static FILE *openCookie(CompressedFile *file) {
+  cookie_io_functions_t funcs = {NULL, writeCompressedGNU, NULL,
+                                 closeCompressed};
+  return fopencookie(file, "w", funcs);
+}
+#endif
+
+static FILE *openCompressed(const char *path, CompressionMethod method) {
+  CompressedFile *file = (CompressedFile *)allocOrExit(sizeof(CompressedFile));
+  FILE *stream;
+
+  file->path = (char *)allocOrExit(strlen(path) + 1);
+  strcpy(file->path, path);
+  file->raw = openFile(path, "wb");
+  file->method = method;
+  file->block = (unsigned char *)allocOrExit(COMPRESSED_OUTPUT_BLOCK);
+  file->failed = 0;
+
+#ifdef SIPNET_ZLIB
+  if (method == METHOD_GZIP) {
+    file->gzip.zalloc = Z_NULL;
+    file->gzip.zfree = Z_NULL;
+    file->gzip.opaque = Z_NULL;
+    if (deflateInit2(&file->gzip, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                     GZIP_WINDOW_BITS, GZIP_MEM_LEVEL,
+                     Z_DEFAULT_STRATEGY) != Z_OK) {
+      logError("could not start gzip compression for '%s'\n", path);
+      exit(EXIT_CODE_INTERNAL_ERROR);
+    }
+  }
+#endif
+#ifdef SIPNET_ZSTD
+  if (method == METHOD_ZSTD) {
+    file->zstd = ZSTD_createCStream();
+    if (file->zstd == NULL) {
+      logError("could not start zstd compression for '%s'\n", path);
+      exit(EXIT_CODE_INTERNAL_ERROR);
+    }
+  }
+#endif
+
+  stream = openCookie(file);
+  if (stream == NULL) {
+    logError("Error writing '%s': %s\n", path, strerror(errno));
+    exit(EXIT_CODE_FILE_OPEN_OR_READ_ERROR);
+  }
+  // The compressor runs once per block rather than once per row
+  if (setvbuf(stream, NULL, _IOFBF, COMPRESSED_OUTPUT_BLOCK) != 0) {
+    logError("could not buffer compressed output '%s'\n", path);
+    exit(EXIT_CODE_INTERNAL_ERROR);
+  }
+  return stream;
+}
+
+#endif  // SIPNET_ZLIB || SIPNET_ZSTD
+
+// See compressedOutput.h
+int hasOutputCompression(const char *method) {
+  if (strcmp(method, COMPRESS_OUTPUT_NONE) == 0) {
+    return 1;
+  }
+#ifdef SIPNET_ZLIB
+  if (strcmp(method, COMPRESS_OUTPUT_GZIP) == 0) {
+    return 1;
+  }
+#endif
+#ifdef SIPNET_ZSTD
+  if (strcmp(method, COMPRESS_OUTPUT_ZSTD) == 0) {
+    return 1;
+  }
+#endif
+  return 0;
+}
+
+// See compressedOutput.h
+const char *outputCompressionSuffix(void) {
+  if (strcmp(ctx.compressOutput, COMPRESS_OUTPUT_GZIP) == 0) {
+    return GZIP_SUFFIX;
+  }
+  if (strcmp(ctx.compressOutput, COMPRESS_OUTPUT_ZSTD) == 0) {
+    return ZSTD_SUFFIX;
+  }
+  return "";
+}
+
+// See compressedOutput.h
+FILE *openOutputFile(const char *path) {
+  if (strcmp(ctx.compressOutput, COMPRESS_OUTPUT_NONE) == 0) {
+    return openFile(path, "w");
+  }
+#ifdef SIPNET_ZLIB
+  if (strcmp(ctx.compressOutput, COMPRESS_OUTPUT_GZIP) == 0) {
+    return openCompressed(path, METHOD_GZIP);
+  }
+#endif
+#ifdef SIPNET_ZSTD
+  if (strcmp(ctx.compressOutput, COMPRESS_OUTPUT_ZSTD) == 0) {
+    return openCompressed(path, METHOD_ZSTD);
+  }
+#endif
+  // validateContext() rejects methods this build doesn't have
+  logError("this build of SIPNET can't write %s output\n", ctx.compressOutput);
+  exit(EXIT_CODE_BAD_PARAMETER_VALUE);
+}
+
+// See compressedOutput.h
+FILE *continueOutputFile(const char *path) {
+  FILE *out = openFile(path, "a");
+  // So that ftell() gives the file's length before anything is written
+  fseek(out, 0, SEEK_END);
+  return out;
+}
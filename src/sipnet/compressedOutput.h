@@ -0,0 +1,67 @@
+// header file for compressedOutput.c: compressed output files
+//
+// With --compress-output gzip or zstd, the main output (text or binary), the
+// debug logs and the events output are compressed as they are written, to
+// files named with a .gz or .zst suffix. Each is opened as an ordinary FILE
+// stream whose writes pass through the compressor, so the code that writes
+// them, the async writer thread included, is unchanged.
+//
+// The streams are fully buffered in blocks of COMPRESSED_OUTPUT_BLOCK bytes,
+// and the compressor runs once per block, on whichever thread fills it; the
+// model thread, with --async-output, only queues rows. fclose() compresses
+// the last block and finishes the file.
+//
+// Each method is built only when its library is found at build time (see the
+// Makefile): gzip needs zlib (SIPNET_ZLIB), and zstd needs libzstd
+// (SIPNET_ZSTD).
+
+#ifndef COMPRESSED_OUTPUT_H
+#define COMPRESSED_OUTPUT_H
+
+#include <stdio.h>
+
+// Bytes written to a compressed stream between runs of the compressor
+#define COMPRESSED_OUTPUT_BLOCK (256 * 1024)
+
+// File name suffixes of the compressed formats
+#define GZIP_SUFFIX ".gz"
+#define ZSTD_SUFFIX ".zst"
+
+/*!
+ * Nonzero if this build can write output compressed with method
+ *
+ * @param method one of the COMPRESS_OUTPUT_* values (see common/context.h)
+ */
+int hasOutputCompression(const char *method);
+
+/*!
+ * Suffix added to the names of compressed output files: "" if
+ * ctx.compressOutput is none, or GZIP_SUFFIX or ZSTD_SUFFIX
+ */
+const char *outputCompressionSuffix(void);
+
+/*!
+ * Open an output file for writing, compressed as ctx.compressOutput says
+ *
+ * The name is used as is; callers add outputCompressionSuffix().
+ *
+ * @param path file to write
+ * @return stream to write to, and close with fclose(); exits if the file
+ *         can't be opened
+ */
+FILE *openOutputFile(const char *path);
+
+/*!
+ * Open an output file to add to what an earlier run wrote to it
+ *
+ * A compressed stream can't be added to, so this is for uncompressed output
+ * only; validateContext() keeps --auto-resume, which continues the outputs of
+ * the run it resumes, to those.
+ *
+ * @param path file to append to; it is created if it isn't there
+ * @return stream to write to, positioned at the end of the file; exits if the
+ *         file can't be opened
+ */
+FILE *continueOutputFile(const char *path);
+
+#endif  // COMPRESSED_OUTPUT_H
@@ -4,19 +4,20 @@
 
 #include "debug_log.h"
 
+#include "asyncOutput.h"
+#include "compressedOutput.h"
+
 #include "common/exitCodes.h"
 #include "common/logging.h"
 #include "common/context.h"
+#include "common/numFormat.h"
 #include "common/util.h"
-#include "state.h"
-typedef enum DebugFieldType {
-  DEBUG_FIELD_INT = 0,
-  DEBUG_FIELD_DOUBLE = 1
-} DebugFieldType;
+#include "model.h"
+#include "varRegistry.h"
 
 typedef struct DebugField {
   const char *name;
-  DebugFieldType type;
+  VarType type;
   const void *value;
 } DebugField;
 
@@ -25,158 +26,111 @@ typedef struct DebugField {
 #define NUM_LOGGED_TRACKER_FIELDS 33
 #define NUM_LOGGED_PHEN_TRACKER_FIELDS 3
 #define NUM_LOGGED_SURVIVAL_FIELDS 1
+// Values captured for one row of all the logs: year, day and time, then the
+// fields above, in order
+#define NUM_DEBUG_VALUES                                                       \
+  (3 + NUM_LOGGED_ENVI_FIELDS + NUM_LOGGED_FLUX_FIELDS +                       \
+   NUM_LOGGED_TRACKER_FIELDS + NUM_LOGGED_PHEN_TRACKER_FIELDS +                \
+   NUM_LOGGED_SURVIVAL_FIELDS)
+// Room for one line of any of the logs
+#define DEBUG_LINE_LEN (NUM_DEBUG_VALUES * (FORMAT_MAX_LEN + 1))
 
-typedef struct DebugFieldArrays {
+struct DebugFieldArrays {
   DebugField enviDF[NUM_LOGGED_ENVI_FIELDS];
   DebugField fluxDF[NUM_LOGGED_FLUX_FIELDS];
   DebugField trackerDF[NUM_LOGGED_TRACKER_FIELDS];
   DebugField phenoDF[NUM_LOGGED_PHEN_TRACKER_FIELDS];
   DebugField survivalDF[NUM_LOGGED_SURVIVAL_FIELDS];
-} DebugFieldArrays;
+  // Number of fields in each list above that are logged: those selected by
+  // output-vars, which are moved to the start of the list
+  size_t numEnvi;
+  size_t numFlux;
+  size_t numTracker;
+  size_t numPheno;
+  size_t numSurvival;
+};
+
+// Fill in the fields of a list from the registry's variables of a group,
+// pointing into model
+static void setGroupFields(DebugField *fields, size_t numFields,
+                           VarGroup group, SipnetModel *model) {
+  int count;
+  const VarInfo *vars = getGroupVariables(group, &count);
+
+  if ((size_t)count != numFields) {
+    logInternalError("Debug log array size mismatch: %s\n",
+                     getVarGroupName(group));
+    exit(EXIT_CODE_INTERNAL_ERROR);
+  }
+  for (int ind = 0; ind < count; ++ind) {
+    fields[ind] = (DebugField){vars[ind].field, vars[ind].type,
+                               getVariableAddress(model, &vars[ind])};
+  }
+}
+
+// Fill in every field of every list, pointing into model
+static void setDebugFields(DebugFieldArrays *debugFields, SipnetModel *model) {
+  setGroupFields(debugFields->enviDF, NUM_LOGGED_ENVI_FIELDS, VAR_ENVI, model);
+  setGroupFields(debugFields->fluxDF, NUM_LOGGED_FLUX_FIELDS, VAR_FLUXES,
+                 model);
+  setGroupFields(debugFields->trackerDF, NUM_LOGGED_TRACKER_FIELDS,
+                 VAR_TRACKERS, model);
+  setGroupFields(debugFields->phenoDF, NUM_LOGGED_PHEN_TRACKER_FIELDS,
+                 VAR_PHENOLOGY, model);
+  setGroupFields(debugFields->survivalDF, NUM_LOGGED_SURVIVAL_FIELDS,
+                 VAR_SURVIVAL, model);
+}
 
-static DebugFieldArrays *debugFields = NULL;
+// Move the fields selected by output-vars to the start of a list, keeping
+// their order; returns how many there are
+static size_t selectDebugFields(DebugField *fields, size_t numFields) {
+  size_t numSelected = 0;
 
-void initDebugArrays() {
+  for (size_t ind = 0; ind < numFields; ++ind) {
+    if (isOutputVar(fields[ind].name)) {
+      fields[numSelected++] = fields[ind];
+    }
+  }
+  return numSelected;
+}
+
+void initDebugArrays(SipnetModel *model) {
   if (strlen(ctx.debugLogPrefix) == 0) {
     return;
   }
 
-  debugFields = malloc(sizeof(DebugFieldArrays));
+  DebugFieldArrays *debugFields = malloc(sizeof(DebugFieldArrays));
   if (debugFields == NULL) {
     logError("memory allocation failure in debug log initialization\n");
     exit(EXIT_CODE_INTERNAL_ERROR);
   }
-  int ind = 0;
-
-  // clang-format off
-  debugFields->enviDF[ind++] = (DebugField){"plantWoodC", DEBUG_FIELD_DOUBLE, &envi.plantWoodC},
-  debugFields->enviDF[ind++] = (DebugField){"plantLeafC", DEBUG_FIELD_DOUBLE, &envi.plantLeafC},
-  debugFields->enviDF[ind++] = (DebugField){"soilC", DEBUG_FIELD_DOUBLE, &envi.soilC},
-  debugFields->enviDF[ind++] = (DebugField){"soilWater", DEBUG_FIELD_DOUBLE, &envi.soilWater},
-  debugFields->enviDF[ind++] = (DebugField){"litterC", DEBUG_FIELD_DOUBLE, &envi.litterC},
-  debugFields->enviDF[ind++] = (DebugField){"snow", DEBUG_FIELD_DOUBLE, &envi.snow},
-  debugFields->enviDF[ind++] = (DebugField){"coarseRootC", DEBUG_FIELD_DOUBLE, &envi.coarseRootC},
-  debugFields->enviDF[ind++] = (DebugField){"fineRootC", DEBUG_FIELD_DOUBLE, &envi.fineRootC},
-  debugFields->enviDF[ind++] = (DebugField){"minN", DEBUG_FIELD_DOUBLE, &envi.minN},
-  debugFields->enviDF[ind++] = (DebugField){"soilOrgN", DEBUG_FIELD_DOUBLE, &envi.soilOrgN},
-  debugFields->enviDF[ind++] = (DebugField){"litterN", DEBUG_FIELD_DOUBLE, &envi.litterN},
-  debugFields->enviDF[ind++] = (DebugField){"plantStorageN", DEBUG_FIELD_DOUBLE, &envi.plantStorageN},
-  debugFields->enviDF[ind  ] = (DebugField){"plantCAccountingDelta", DEBUG_FIELD_DOUBLE,&envi.plantCAccountingDelta};
-
-  ind = 0;
-  debugFields->fluxDF[ind++] = (DebugField){"photosynthesis", DEBUG_FIELD_DOUBLE, &fluxes.photosynthesis};
-  debugFields->fluxDF[ind++] = (DebugField){"leafLitter", DEBUG_FIELD_DOUBLE, &fluxes.leafLitter},
-  debugFields->fluxDF[ind++] = (DebugField){"woodLitter", DEBUG_FIELD_DOUBLE, &fluxes.woodLitter},
-  debugFields->fluxDF[ind++] = (DebugField){"rVeg", DEBUG_FIELD_DOUBLE, &fluxes.rVeg},
-  debugFields->fluxDF[ind++] = (DebugField){"rSoil", DEBUG_FIELD_DOUBLE, &fluxes.rSoil},
-  debugFields->fluxDF[ind++] = (DebugField){"rain", DEBUG_FIELD_DOUBLE, &fluxes.rain},
-  debugFields->fluxDF[ind++] = (DebugField){"transpiration", DEBUG_FIELD_DOUBLE, &fluxes.transpiration},
-  debugFields->fluxDF[ind++] = (DebugField){"drainage", DEBUG_FIELD_DOUBLE, &fluxes.drainage},
-  debugFields->fluxDF[ind++] = (DebugField){"litterToSoil", DEBUG_FIELD_DOUBLE, &fluxes.litterToSoil},
-  debugFields->fluxDF[ind++] = (DebugField){"rLitter", DEBUG_FIELD_DOUBLE, &fluxes.rLitter},
-  debugFields->fluxDF[ind++] = (DebugField){"snowFall", DEBUG_FIELD_DOUBLE, &fluxes.snowFall},
-  debugFields->fluxDF[ind++] = (DebugField){"snowMelt", DEBUG_FIELD_DOUBLE, &fluxes.snowMelt},
-  debugFields->fluxDF[ind++] = (DebugField){"sublimation", DEBUG_FIELD_DOUBLE, &fluxes.sublimation},
-  debugFields->fluxDF[ind++] = (DebugField){"immedEvap", DEBUG_FIELD_DOUBLE, &fluxes.immedEvap},
-  debugFields->fluxDF[ind++] = (DebugField){"fastFlow", DEBUG_FIELD_DOUBLE, &fluxes.fastFlow},
-  debugFields->fluxDF[ind++] = (DebugField){"evaporation", DEBUG_FIELD_DOUBLE, &fluxes.evaporation},
-  debugFields->fluxDF[ind++] = (DebugField){"fineRootLoss", DEBUG_FIELD_DOUBLE, &fluxes.fineRootLoss},
-  debugFields->fluxDF[ind++] = (DebugField){"coarseRootLoss", DEBUG_FIELD_DOUBLE, &fluxes.coarseRootLoss},
-  debugFields->fluxDF[ind++] = (DebugField){"fineRootCreation", DEBUG_FIELD_DOUBLE, &fluxes.fineRootCreation},
-  debugFields->fluxDF[ind++] = (DebugField){"coarseRootCreation", DEBUG_FIELD_DOUBLE, &fluxes.coarseRootCreation},
-  debugFields->fluxDF[ind++] = (DebugField){"rCoarseRoot", DEBUG_FIELD_DOUBLE, &fluxes.rCoarseRoot},
-  debugFields->fluxDF[ind++] = (DebugField){"rFineRoot", DEBUG_FIELD_DOUBLE, &fluxes.rFineRoot},
-  debugFields->fluxDF[ind++] = (DebugField){"leafCreation", DEBUG_FIELD_DOUBLE, &fluxes.leafCreation},
-  debugFields->fluxDF[ind++] = (DebugField){"woodCreation", DEBUG_FIELD_DOUBLE, &fluxes.woodCreation},
-  debugFields->fluxDF[ind++] = (DebugField){"leafOnCreation", DEBUG_FIELD_DOUBLE, &fluxes.leafOnCreation},
-  debugFields->fluxDF[ind++] = (DebugField){"leafOnCreationFromWood", DEBUG_FIELD_DOUBLE, &fluxes.leafOnCreationFromWood},
-  debugFields->fluxDF[ind++] = (DebugField){"nVolatilization", DEBUG_FIELD_DOUBLE, &fluxes.nVolatilization},
-  debugFields->fluxDF[ind++] = (DebugField){"nLeaching", DEBUG_FIELD_DOUBLE, &fluxes.nLeaching},
-  debugFields->fluxDF[ind++] = (DebugField){"nOrgSoil", DEBUG_FIELD_DOUBLE, &fluxes.nOrgSoil},
-  debugFields->fluxDF[ind++] = (DebugField){"nOrgLitter", DEBUG_FIELD_DOUBLE, &fluxes.nOrgLitter},
-  debugFields->fluxDF[ind++] = (DebugField){"nMin", DEBUG_FIELD_DOUBLE, &fluxes.nMin},
-  debugFields->fluxDF[ind++] = (DebugField){"nFixation", DEBUG_FIELD_DOUBLE, &fluxes.nFixation},
-  debugFields->fluxDF[ind++] = (DebugField){"nUptake", DEBUG_FIELD_DOUBLE, &fluxes.nUptake},
-  debugFields->fluxDF[ind++] = (DebugField){"leafOffNResorption", DEBUG_FIELD_DOUBLE, &fluxes.leafOffNResorption},
-  debugFields->fluxDF[ind++] = (DebugField){"reductionNResorption", DEBUG_FIELD_DOUBLE, &fluxes.reductionNResorption},
-  debugFields->fluxDF[ind++] = (DebugField){"eventLeafC", DEBUG_FIELD_DOUBLE, &fluxes.eventLeafC},
-  debugFields->fluxDF[ind++] = (DebugField){"eventWoodC", DEBUG_FIELD_DOUBLE, &fluxes.eventWoodC},
-  debugFields->fluxDF[ind++] = (DebugField){"eventFineRootC", DEBUG_FIELD_DOUBLE, &fluxes.eventFineRootC},
-  debugFields->fluxDF[ind++] = (DebugField){"eventCoarseRootC", DEBUG_FIELD_DOUBLE, &fluxes.eventCoarseRootC},
-  debugFields->fluxDF[ind++] = (DebugField){"eventEvap", DEBUG_FIELD_DOUBLE, &fluxes.eventEvap},
-  debugFields->fluxDF[ind++] = (DebugField){"eventSoilWater", DEBUG_FIELD_DOUBLE, &fluxes.eventSoilWater},
-  debugFields->fluxDF[ind++] = (DebugField){"eventSoilC", DEBUG_FIELD_DOUBLE, &fluxes.eventSoilC},
-  debugFields->fluxDF[ind++] = (DebugField){"eventLitterC", DEBUG_FIELD_DOUBLE, &fluxes.eventLitterC},
-  debugFields->fluxDF[ind++] = (DebugField){"eventMinN", DEBUG_FIELD_DOUBLE, &fluxes.eventMinN},
-  debugFields->fluxDF[ind++] = (DebugField){"eventSoilOrgN", DEBUG_FIELD_DOUBLE, &fluxes.eventSoilOrgN},
-  debugFields->fluxDF[ind++] = (DebugField){"eventLitterN", DEBUG_FIELD_DOUBLE, &fluxes.eventLitterN},
-  debugFields->fluxDF[ind++] = (DebugField){"eventInputC", DEBUG_FIELD_DOUBLE, &fluxes.eventInputC},
-  debugFields->fluxDF[ind++] = (DebugField){"eventOutputC", DEBUG_FIELD_DOUBLE, &fluxes.eventOutputC},
-  debugFields->fluxDF[ind++] = (DebugField){"eventInputN", DEBUG_FIELD_DOUBLE, &fluxes.eventInputN},
-  debugFields->fluxDF[ind++] = (DebugField){"eventOutputN", DEBUG_FIELD_DOUBLE, &fluxes.eventOutputN},
-  debugFields->fluxDF[ind++] = (DebugField){"eventLeafOnCreation", DEBUG_FIELD_DOUBLE, &fluxes.eventLeafOnCreation},
-  debugFields->fluxDF[ind++] = (DebugField){"eventLeafOnCreationFromWood", DEBUG_FIELD_DOUBLE, &fluxes.eventLeafOnCreationFromWood},
-  debugFields->fluxDF[ind++] = (DebugField){"eventLeafOffLitter", DEBUG_FIELD_DOUBLE, &fluxes.eventLeafOffLitter},
-  debugFields->fluxDF[ind++] = (DebugField){"eventLeafOffNResorption", DEBUG_FIELD_DOUBLE, &fluxes.eventLeafOffNResorption},
-  debugFields->fluxDF[ind++] = (DebugField){"soilMethane", DEBUG_FIELD_DOUBLE, &fluxes.soilMethane},
-  debugFields->fluxDF[ind  ] = (DebugField){"litterMethane", DEBUG_FIELD_DOUBLE, &fluxes.litterMethane};
-
-  ind = 0;
-  debugFields->trackerDF[ind++] = (DebugField){"gpp", DEBUG_FIELD_DOUBLE, &trackers.gpp},
-  debugFields->trackerDF[ind++] = (DebugField){"rtot", DEBUG_FIELD_DOUBLE, &trackers.rtot},
-  debugFields->trackerDF[ind++] = (DebugField){"ra", DEBUG_FIELD_DOUBLE, &trackers.ra},
-  debugFields->trackerDF[ind++] = (DebugField){"rh", DEBUG_FIELD_DOUBLE, &trackers.rh},
-  debugFields->trackerDF[ind++] = (DebugField){"rRoot", DEBUG_FIELD_DOUBLE, &trackers.rRoot},
-  debugFields->trackerDF[ind++] = (DebugField){"rSoil", DEBUG_FIELD_DOUBLE, &trackers.rSoil},
-  debugFields->trackerDF[ind++] = (DebugField){"rAboveground", DEBUG_FIELD_DOUBLE, &trackers.rAboveground},
-  debugFields->trackerDF[ind++] = (DebugField){"npp", DEBUG_FIELD_DOUBLE, &trackers.npp},
-  debugFields->trackerDF[ind++] = (DebugField){"nee", DEBUG_FIELD_DOUBLE, &trackers.nee},
-  debugFields->trackerDF[ind++] = (DebugField){"woodCreation", DEBUG_FIELD_DOUBLE, &trackers.woodCreation},
-  debugFields->trackerDF[ind++] = (DebugField){"gdd", DEBUG_FIELD_DOUBLE, &trackers.gdd},
-  debugFields->trackerDF[ind++] = (DebugField){"evapotranspiration", DEBUG_FIELD_DOUBLE, &trackers.evapotranspiration},
-  debugFields->trackerDF[ind++] = (DebugField){"soilWetnessFrac", DEBUG_FIELD_DOUBLE, &trackers.soilWetnessFrac},
-  debugFields->trackerDF[ind++] = (DebugField){"yearlyGpp", DEBUG_FIELD_DOUBLE, &trackers.yearlyGpp},
-  debugFields->trackerDF[ind++] = (DebugField){"yearlyRtot", DEBUG_FIELD_DOUBLE, &trackers.yearlyRtot},
-  debugFields->trackerDF[ind++] = (DebugField){"yearlyRa", DEBUG_FIELD_DOUBLE, &trackers.yearlyRa},
-  debugFields->trackerDF[ind++] = (DebugField){"yearlyRh", DEBUG_FIELD_DOUBLE, &trackers.yearlyRh},
-  debugFields->trackerDF[ind++] = (DebugField){"yearlyNpp", DEBUG_FIELD_DOUBLE, &trackers.yearlyNpp},
-  debugFields->trackerDF[ind++] = (DebugField){"yearlyNee", DEBUG_FIELD_DOUBLE, &trackers.yearlyNee},
-  debugFields->trackerDF[ind++] = (DebugField){"yearlyLitter", DEBUG_FIELD_DOUBLE, &trackers.yearlyLitter},
-  debugFields->trackerDF[ind++] = (DebugField){"totGpp", DEBUG_FIELD_DOUBLE, &trackers.totGpp},
-  debugFields->trackerDF[ind++] = (DebugField){"totRtot", DEBUG_FIELD_DOUBLE, &trackers.totRtot},
-  debugFields->trackerDF[ind++] = (DebugField){"totRa", DEBUG_FIELD_DOUBLE, &trackers.totRa},
-  debugFields->trackerDF[ind++] = (DebugField){"totRh", DEBUG_FIELD_DOUBLE, &trackers.totRh},
-  debugFields->trackerDF[ind++] = (DebugField){"totNpp", DEBUG_FIELD_DOUBLE, &trackers.totNpp},
-  debugFields->trackerDF[ind++] = (DebugField){"totNee", DEBUG_FIELD_DOUBLE, &trackers.totNee},
-  debugFields->trackerDF[ind++] = (DebugField){"lastYear", DEBUG_FIELD_INT, &trackers.lastYear},
-  debugFields->trackerDF[ind++] = (DebugField){"methane", DEBUG_FIELD_DOUBLE, &trackers.methane},
-  debugFields->trackerDF[ind++] = (DebugField){"n2o", DEBUG_FIELD_DOUBLE, &trackers.n2o},
-  debugFields->trackerDF[ind++] = (DebugField){"nLeaching", DEBUG_FIELD_DOUBLE, &trackers.nLeaching},
-  debugFields->trackerDF[ind++] = (DebugField){"nFixation", DEBUG_FIELD_DOUBLE, &trackers.nFixation},
-  debugFields->trackerDF[ind++] = (DebugField){"nUptake", DEBUG_FIELD_DOUBLE, &trackers.nUptake};
-  debugFields->trackerDF[ind  ] = (DebugField){"meanNPP", DEBUG_FIELD_DOUBLE, &trackers.meanNPP};
-
-  ind = 0;
-  debugFields->phenoDF[ind++] = (DebugField){"didLeafGrowth", DEBUG_FIELD_INT, &phenologyTrackers.didLeafGrowth},
-  debugFields->phenoDF[ind++] = (DebugField){"didLeafFall", DEBUG_FIELD_INT, &phenologyTrackers.didLeafFall},
-  debugFields->phenoDF[ind  ] = (DebugField){"lastYear", DEBUG_FIELD_INT, &phenologyTrackers.lastYear};
-
-  ind = 0;
-  debugFields->survivalDF[ind] = (DebugField){"isAlive", DEBUG_FIELD_INT, &plantSurvivalTracker.isAlive};
-  // clang-format on
+  model->debugFields = debugFields;
+  setDebugFields(debugFields, model);
+
+  debugFields->numEnvi =
+      selectDebugFields(debugFields->enviDF, NUM_LOGGED_ENVI_FIELDS);
+  debugFields->numFlux =
+      selectDebugFields(debugFields->fluxDF, NUM_LOGGED_FLUX_FIELDS);
+  debugFields->numTracker =
+      selectDebugFields(debugFields->trackerDF, NUM_LOGGED_TRACKER_FIELDS);
+  debugFields->numPheno =
+      selectDebugFields(debugFields->phenoDF, NUM_LOGGED_PHEN_TRACKER_FIELDS);
+  debugFields->numSurvival =
+      selectDebugFields(debugFields->survivalDF, NUM_LOGGED_SURVIVAL_FIELDS);
 }
 
 static FILE *openDebugLogFile(const char *debugLogPrefix, const char *suffix) {
   char filename[FILENAME_MAXLEN];
 
   const int written =
-      snprintf(filename, sizeof(filename), "%s%s", debugLogPrefix, suffix);
+      snprintf(filename, sizeof(filename), "%s%s%s", debugLogPrefix, suffix,
+               outputCompressionSuffix());
   if (written < 0 || (size_t)written >= sizeof(filename)) {
     logError("debug-log prefix '%s' is too long\n", debugLogPrefix);
     exit(EXIT_CODE_BAD_PARAMETER_VALUE);
   }
 
-  return openFile(filename, "w");
+  return openOutputFile(filename);
 }
 
 static void outputDebugFieldHeader(FILE *out, const char *prefix,
@@ -193,22 +147,44 @@ static void outputDebugFieldHeader(FILE *out, const char *prefix,
   }
 }
 
-static void outputDebugFieldValues(FILE *out, int year, int day, double time,
-                                   const DebugField *fields, size_t numFields,
-                                   int fullLine) {
-  if (fullLine) {
-    fprintf(out, "%4d %3d %5.2f", year, day, time);
-  }
+// Format year, day and time, which start a row of every log; returns the end
+// of what was written
+static char *formatDebugRowStart(char *pos, const double *values) {
+  pos = formatInt(pos, (int)values[0], 4);
+  *pos++ = ' ';
+  pos = formatInt(pos, (int)values[1], 3);
+  *pos++ = ' ';
+  return formatFixed(pos, values[2], 5, 2);
+}
+
+// Format the captured values of a list of fields, from values[0]; returns the
+// end of what was written
+static char *formatDebugFieldValues(char *pos, const double *values,
+                                    const DebugField *fields,
+                                    size_t numFields) {
   for (size_t ind = 0; ind < numFields; ++ind) {
-    if (fields[ind].type == DEBUG_FIELD_INT) {
-      fprintf(out, " %d", *((const int *)fields[ind].value));
+    *pos++ = ' ';
+    if (fields[ind].type == VAR_INT) {
+      pos = formatInt(pos, (int)values[ind], 0);
     } else {
-      fprintf(out, " %.15g", *((const double *)fields[ind].value));
+      pos = formatGeneral(pos, values[ind], 15);
     }
   }
-  if (fullLine) {
-    fprintf(out, "\n");
+  return pos;
+}
+
+// Capture the current values of a list of fields into values; returns the
+// number of values written
+static size_t getDebugFieldValues(double *values, const DebugField *fields,
+                                  size_t numFields) {
+  for (size_t ind = 0; ind < numFields; ++ind) {
+    if (fields[ind].type == VAR_INT) {
+      values[ind] = *((const int *)fields[ind].value);
+    } else {
+      values[ind] = *((const double *)fields[ind].value);
+    }
   }
+  return numFields;
 }
 
 void initDebugLogFiles(DebugLogFiles *debugLogFiles) {
@@ -249,64 +225,114 @@ void closeDebugLogFiles(DebugLogFiles *debugLogFiles) {
   }
 }
 
-void freeDebugArrays(void) {
-  if (debugFields != NULL) {
-    free(debugFields);
+void freeDebugArrays(SipnetModel *model) {
+  if (model->debugFields != NULL) {
+    free(model->debugFields);
+    model->debugFields = NULL;
   }
 }
 
-void outputDebugHeaders(DebugLogFiles *debugLogFiles) {
+void outputDebugHeaders(SipnetModel *model, DebugLogFiles *debugLogFiles) {
+  const DebugFieldArrays *debugFields = model->debugFields;
   if (debugLogFiles == NULL || debugFields == NULL) {
     return;
   }
 
   if (debugLogFiles->envi != NULL) {
     outputDebugFieldHeader(debugLogFiles->envi, "", debugFields->enviDF,
-                           NUM_LOGGED_ENVI_FIELDS, 1);
+                           debugFields->numEnvi, 1);
   }
   if (debugLogFiles->fluxes != NULL) {
     outputDebugFieldHeader(debugLogFiles->fluxes, "", debugFields->fluxDF,
-                           NUM_LOGGED_FLUX_FIELDS, 1);
+                           debugFields->numFlux, 1);
   }
   if (debugLogFiles->trackers != NULL) {
     fprintf(debugLogFiles->trackers, "year day time");
     outputDebugFieldHeader(debugLogFiles->trackers, "t.",
-                           debugFields->trackerDF, NUM_LOGGED_TRACKER_FIELDS,
-                           0);
+                           debugFields->trackerDF, debugFields->numTracker, 0);
     outputDebugFieldHeader(debugLogFiles->trackers, "pt.", debugFields->phenoDF,
-                           NUM_LOGGED_PHEN_TRACKER_FIELDS, 0);
+                           debugFields->numPheno, 0);
     outputDebugFieldHeader(debugLogFiles->trackers, "s.",
-                           debugFields->survivalDF, NUM_LOGGED_SURVIVAL_FIELDS,
+                           debugFields->survivalDF, debugFields->numSurvival,
                            0);
     fprintf(debugLogFiles->trackers, "\n");
   }
 }
 
-void outputDebugState(DebugLogFiles *debugLogFiles, int year, int day,
-                      double time) {
-  if (debugLogFiles == NULL || debugFields == NULL) {
-    return;
-  }
+// Write one row to each debug log, from the values captured by
+// outputDebugState(); an AsyncRowWriter
+static void writeDebugRow(void *target, const void *layout,
+                          const double *values, int numValues) {
+  DebugLogFiles *debugLogFiles = (DebugLogFiles *)target;
+  const DebugFieldArrays *debugFields = (const DebugFieldArrays *)layout;
+  const double *fieldValues = values + 3;
+  char line[DEBUG_LINE_LEN];
+  char *pos;
 
   if (debugLogFiles->envi != NULL) {
-    outputDebugFieldValues(debugLogFiles->envi, year, day, time,
-                           debugFields->enviDF, NUM_LOGGED_ENVI_FIELDS, 1);
+    pos = formatDebugRowStart(line, values);
+    pos = formatDebugFieldValues(pos, fieldValues, debugFields->enviDF,
+                                 debugFields->numEnvi);
+    *pos++ = '\n';
+    fwrite(line, 1, pos - line, debugLogFiles->envi);
   }
+  fieldValues += debugFields->numEnvi;
   if (debugLogFiles->fluxes != NULL) {
-    outputDebugFieldValues(debugLogFiles->fluxes, year, day, time,
-                           debugFields->fluxDF, NUM_LOGGED_FLUX_FIELDS, 1);
+    pos = formatDebugRowStart(line, values);
+    pos = formatDebugFieldValues(pos, fieldValues, debugFields->fluxDF,
+                                 debugFields->numFlux);
+    *pos++ = '\n';
+    fwrite(line, 1, pos - line, debugLogFiles->fluxes);
   }
+  fieldValues += debugFields->numFlux;
   if (debugLogFiles->trackers != NULL) {
-    fprintf(debugLogFiles->trackers, "%4d %3d %5.2f", year, day, time);
-    outputDebugFieldValues(debugLogFiles->trackers, year, day, time,
-                           debugFields->trackerDF, NUM_LOGGED_TRACKER_FIELDS,
-                           0);
-    outputDebugFieldValues(debugLogFiles->trackers, year, day, time,
-                           debugFields->phenoDF, NUM_LOGGED_PHEN_TRACKER_FIELDS,
-                           0);
-    outputDebugFieldValues(debugLogFiles->trackers, year, day, time,
-                           debugFields->survivalDF, NUM_LOGGED_SURVIVAL_FIELDS,
-                           0);
-    fprintf(debugLogFiles->trackers, "\n");
+    pos = formatDebugRowStart(line, values);
+    pos = formatDebugFieldValues(pos, fieldValues, debugFields->trackerDF,
+                                 debugFields->numTracker);
+    fieldValues += debugFields->numTracker;
+    pos = formatDebugFieldValues(pos, fieldValues, debugFields->phenoDF,
+                                 debugFields->numPheno);
+    fieldValues += debugFields->numPheno;
+    pos = formatDebugFieldValues(pos, fieldValues, debugFields->survivalDF,
+                                 debugFields->numSurvival);
+    *pos++ = '\n';
+    fwrite(line, 1, pos - line, debugLogFiles->trackers);
+  }
+}
+
+void outputDebugState(SipnetModel *model, DebugLogFiles *debugLogFiles,
+                      int year, int day, double time) {
+  const DebugFieldArrays *debugFields = model->debugFields;
+  double local[NUM_DEBUG_VALUES];
+  double *values = local;
+  size_t numValues;
+  size_t pos = 3;
+
+  if (debugLogFiles == NULL || debugFields == NULL) {
+    return;
+  }
+
+  numValues = 3 + debugFields->numEnvi + debugFields->numFlux +
+              debugFields->numTracker + debugFields->numPheno +
+              debugFields->numSurvival;
+  if (model->asyncOut != NULL) {
+    values = reserveAsyncRow(model->asyncOut, writeDebugRow, debugLogFiles,
+                             debugFields, (int)numValues);
+  }
+  values[0] = year;
+  values[1] = day;
+  values[2] = time;
+  pos += getDebugFieldValues(values + pos, debugFields->enviDF,
+                             debugFields->numEnvi);
+  pos += getDebugFieldValues(values + pos, debugFields->fluxDF,
+                             debugFields->numFlux);
+  pos += getDebugFieldValues(values + pos, debugFields->trackerDF,
+                             debugFields->numTracker);
+  pos += getDebugFieldValues(values + pos, debugFields->phenoDF,
+                             debugFields->numPheno);
+  getDebugFieldValues(values + pos, debugFields->survivalDF,
+                      debugFields->numSurvival);
+  if (model->asyncOut == NULL) {
+    writeDebugRow(debugLogFiles, debugFields, values, (int)numValues);
   }
 }
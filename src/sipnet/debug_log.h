@@ -6,20 +6,27 @@
 
 #include <stdio.h>
 
+// Model instance holding all run state; defined in model.h
+typedef struct SipnetModel SipnetModel;
+
+// Per-model table of logged fields; defined in debug_log.c
+typedef struct DebugFieldArrays DebugFieldArrays;
+
 typedef struct DebugLogFiles {
   FILE *envi;
   FILE *fluxes;
   FILE *trackers;
 } DebugLogFiles;
 
-void initDebugArrays(void);
+void initDebugArrays(SipnetModel *model);
 void initDebugLogFiles(DebugLogFiles *debugLogFiles);
 void openDebugLogFiles(DebugLogFiles *debugLogFiles,
                        const char *debugLogPrefix);
 void closeDebugLogFiles(DebugLogFiles *debugLogFiles);
-void freeDebugArrays(void);
-void outputDebugHeaders(DebugLogFiles *debugLogFiles);
-void outputDebugState(DebugLogFiles *debugLogFiles, int year, int day,
-                      double time);
+void freeDebugArrays(SipnetModel *model);
+void outputDebugHeaders(SipnetModel *model, DebugLogFiles *debugLogFiles);
+
+void outputDebugState(SipnetModel *model, DebugLogFiles *debugLogFiles,
+                      int year, int day, double time);
 
 #endif
@@ -6,24 +6,24 @@
 #include "common/util.h"
 
 #include "events.h"
-#include "state.h"
+#include "model.h"
 
 double getClippedWaterFrac(double water, double whc) {
   return unitClip(water / whc);
 }
 
-double calcAnaerobicIndex(double water, double whc) {
+double calcAnaerobicIndex(SipnetModel *model, double water, double whc) {
   double f_whc = getClippedWaterFrac(water, whc);
-  double f_a = params.fAnoxia;
+  double f_a = model->params.fAnoxia;
 
   // Anaerobic index (oxygen limitation proxy)
   return unitClip((f_whc - f_a) / (1 - f_a));
 }
 
-double calcRespMoistEffect(double water, double whc) {
+double calcRespMoistEffect(SipnetModel *model, double water, double whc) {
   double moistEffect;
 
-  if ((!ctx.waterHResp) || (climate->tsoil < 0)) {
+  if ((!ctx.waterHResp) || (model->climate->tsoil < 0)) {
     // if not waterHResp, soil moisture does not affect heterotrophic
     // respiration; also, ignore moisture effects in frozen soils
     // :: from [2], snowpack addition
@@ -40,40 +40,42 @@ double calcRespMoistEffect(double water, double whc) {
       // [TAG:UNKNOWN_PROVENANCE] soilRespMoistEffect
       // Note: older versions of sipnet note this as "using PnET formulation",
       // but we have been unable to verify that the exponent comes from PnET
-      moistEffect = pow(f_whc, params.soilRespMoistEffect);
+      moistEffect = pow(f_whc, model->params.soilRespMoistEffect);
     } else {
       // Unimodal moisture response: suppressed under dry conditions, maximal
       // at intermediate moisture, reduced under saturated/anoxic conditions
 
       // Aerobic water availability (dry limitation)
-      double D_aer = unitClip(f_whc / params.fAnoxia);
+      double D_aer = unitClip(f_whc / model->params.fAnoxia);
       // Anaerobic index (oxygen limitation proxy)
-      double A = calcAnaerobicIndex(water, whc);
+      double A = calcAnaerobicIndex(model, water, whc);
       // Uni-modal moisture response
       // Note that this will not go above 1, since:
       // - when f_whc <= f_a, A = 0, and moistEffect = D_aer
       // - when f_whc > f_a, D_aer caps at 1, and this becomes
       //   moistEffect = 1 - (1 - adr)A, and adr <= 1
-      moistEffect = (1 - A) * D_aer + params.anaerobicDecompRate * A;
+      moistEffect = (1 - A) * D_aer + model->params.anaerobicDecompRate * A;
     }
   }
 
   return moistEffect;
 }
 
-double calcMethaneMoistEffect(double water, double whc) {
+double calcMethaneMoistEffect(SipnetModel *model, double water, double whc) {
   // Anaerobic index (oxygen limitation proxy)
-  double A = calcAnaerobicIndex(water, whc);
+  double A = calcAnaerobicIndex(model, water, whc);
 
-  return pow(A, params.anaerobicTransExp);
+  return pow(A, model->params.anaerobicTransExp);
 }
 
-double calcTempEffect(double tsoil) {
+double calcTempEffect(SipnetModel *model, double tsoil) {
   // :: from [1], D_temp calc as part of eq (A20)
-  return pow(params.soilRespQ10, tsoil / 10);
+  return pow(model->params.soilRespQ10, tsoil / 10);
 }
 
-double calcTillageEffect(void) { return 1 + eventTrackers.d_till_mod; }
+double calcTillageEffect(SipnetModel *model) {
+  return 1 + model->eventTrackers.d_till_mod;
+}
 
 double calcCNEffect(double kCN, double poolC, double poolN) {
   if (!ctx.nitrogenCycle) {
@@ -86,9 +88,10 @@ double calcCNEffect(double kCN, double poolC, double poolN) {
   return kCN / (kCN + cn);
 }
 
-double calcVolatilizationMoistEffect(double water, double whc) {
+double calcVolatilizationMoistEffect(SipnetModel *model, double water,
+                                     double whc) {
   // Anaerobic index (oxygen limitation proxy)
-  double A = calcAnaerobicIndex(water, whc);
+  double A = calcAnaerobicIndex(model, water, whc);
 
   // 0.05 represents the baseline aerobic volatilization
   // The factor of 3.8 makes the max = 1, as with other dependency functions
@@ -1,6 +1,9 @@
 #ifndef DEP_EFFECTS_H
 #define DEP_EFFECTS_H
 
+// Model instance holding all run state; defined in model.h
+typedef struct SipnetModel SipnetModel;
+
 /**
  * Calculate water fraction bounded in [0,1]
  *
@@ -26,7 +29,7 @@ double getClippedWaterFrac(double water, double whc);
  * @param whc soil water holding capacity
  * @return anaerobic index
  */
-double calcAnaerobicIndex(double water, double whc);
+double calcAnaerobicIndex(SipnetModel *model, double water, double whc);
 
 /*!
  *  Calculate heterotrophic respiration moisture dependency effect
@@ -40,7 +43,7 @@ double calcAnaerobicIndex(double water, double whc);
  * @param whc water holding capacity
  * @return moisture effect as a fraction between 0 and 1
  */
-double calcRespMoistEffect(double water, double whc);
+double calcRespMoistEffect(SipnetModel *model, double water, double whc);
 
 /*!
  * Calculate methane production moisture dependency effect
@@ -56,7 +59,7 @@ double calcRespMoistEffect(double water, double whc);
  * @param whc water holding capacity
  * @return moisture effect as a fraction between 0 and 1
  */
-double calcMethaneMoistEffect(double water, double whc);
+double calcMethaneMoistEffect(SipnetModel *model, double water, double whc);
 
 /**
  * Calculate temperature dependency effect
@@ -67,12 +70,12 @@ double calcMethaneMoistEffect(double water, double whc);
  * @param tsoil soil temperature
  * @return temperature effect as a fraction between 0 and 1
  */
-double calcTempEffect(double tsoil);
+double calcTempEffect(SipnetModel *model, double tsoil);
 
 /**
  * Calculate effect of tillage on soil respiration or litter breakdown
  */
-double calcTillageEffect(void);
+double calcTillageEffect(SipnetModel *model);
 
 /**
  * Calculate C:N ratio dependency effect
@@ -101,6 +104,7 @@ double calcCNEffect(double kCN, double poolC, double poolN);
  * @param whc water holding capacity
  * @return moisture effect as a fraction between 0 and 1
  */
-double calcVolatilizationMoistEffect(double water, double whc);
+double calcVolatilizationMoistEffect(SipnetModel *model, double water,
+                                     double whc);
 
 #endif  // DEP_EFFECTS_H
@@ -0,0 +1,165 @@
+// Run a parameter ensemble over a shared climate data set with a pool of threads
+
+#include "ensemble.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/context.h"
+#include "common/exitCodes.h"
+#include "common/logging.h"
+#include "common/modelParams.h"
+#include "common/util.h"
+
+#include "compressedOutput.h"
+#include "events.h"
+#include "lanes.h"
+#include "model.h"
+#include "outputItems.h"
+#include "sipnet.h"
+#include "workPool.h"
+
+#define ENSEMBLE_EVENTS_OUT_SUFFIX ".events.out"
+
+typedef struct EnsembleRun {
+  // File prefix of each member, as listed in the ensemble file
+  char (*members)[FILENAME_MAXLEN];
+  int numMembers;
+
+  // Read-only climate data shared by all members
+  ClimateData *climate;
+
+  // Number of members each thread runs together
+  int numLanes;
+
+  // Serializes model setup, as parameter and event file parsing is not
+  // thread-safe
+  pthread_mutex_t lock;
+} EnsembleRun;
+
+// Everything a member owns while it runs
+typedef struct EnsembleMember {
+  SipnetModel *model;
+  ModelParams *modelParams;
+  OutputItems *outputItems;
+  FILE *out;
+} EnsembleMember;
+
+// Set up a member's model and open its outputs; the caller holds run->lock
+static void setupEnsembleMember(EnsembleRun *run, int memberIndex,
+                                EnsembleMember *member) {
+  const char *prefix = run->members[memberIndex];
+  char paramFile[FILENAME_MAXLEN], outFile[FILENAME_MAXLEN];
+  char eventsOutFile[FILENAME_MAXLEN];
+
+  snprintf(paramFile, sizeof(paramFile), "%s.param", prefix);
+  snprintf(outFile, sizeof(outFile), "%s%s", prefix, mainOutputSuffix());
+  snprintf(eventsOutFile, sizeof(eventsOutFile), "%s%s%s", prefix,
+           ENSEMBLE_EVENTS_OUT_SUFFIX, outputCompressionSuffix());
+
+  member->outputItems = NULL;
+  member->out = NULL;
+  member->model = newSipnetModel();
+  initModelWithClimate(member->model, &member->modelParams, paramFile,
+                       run->climate);
+  if (ctx.events) {
+    initEvents(member->model, ctx.eventsInFile, eventsOutFile,
+               ctx.printHeader);
+    if (isFirstEventBefore(member->model, member->model->climateData->year[0],
+                           member->model->climateData->day[0])) {
+      logError(
+          "First event occurs before the start of the climate file; please "
+          "fix and rerun\n");
+      exit(EXIT_CODE_INPUT_FILE_ERROR);
+    }
+  }
+  if (ctx.doSingleOutputs) {
+    member->outputItems = newOutputItems(prefix, ' ');
+    setupOutputItems(member->model, member->outputItems);
+  }
+  if (ctx.doMainOutput) {
+    member->out = openMainOutput(member->model, outFile);
+  }
+}
+
+// Close a member's outputs and free its model
+static void cleanupEnsembleMember(EnsembleMember *member) {
+  if (member->out != NULL) {
+    fclose(member->out);
+  }
+  if (member->outputItems != NULL) {
+    deleteOutputItems(member->outputItems);
+  }
+  cleanupModel(member->model);
+  deleteSipnetModel(member->model);
+  deleteModelParams(member->modelParams);
+}
+
+// Run numMembers members, starting at firstMember, from setup through
+// cleanup; several members run together in lanes (see lanes.h)
+static void runEnsembleMembers(EnsembleRun *run, int firstMember,
+                               int numMembers) {
+  EnsembleMember members[MAX_LANES];
+  SipnetModel *models[MAX_LANES];
+  FILE *outs[MAX_LANES];
+  OutputItems *outputItems[MAX_LANES];
+
+  pthread_mutex_lock(&run->lock);
+  for (int ind = 0; ind < numMembers; ++ind) {
+    setupEnsembleMember(run, firstMember + ind, &members[ind]);
+    models[ind] = members[ind].model;
+    outs[ind] = members[ind].out;
+    outputItems[ind] = members[ind].outputItems;
+  }
+  pthread_mutex_unlock(&run->lock);
+
+  if (numMembers == 1) {
+    runModelOutput(models[0], outs[0], NULL, outputItems[0], ctx.printHeader);
+  } else {
+    runModelLanes(models, numMembers, outs, outputItems, ctx.printHeader);
+  }
+
+  for (int ind = 0; ind < numMembers; ++ind) {
+    cleanupEnsembleMember(&members[ind]);
+  }
+}
+
+// Pool task: run the batch of numLanes members with index batch
+static void runEnsembleBatch(void *arg, int batch) {
+  EnsembleRun *run = (EnsembleRun *)arg;
+  int firstMember = batch * run->numLanes;
+  int numMembers = run->numMembers - firstMember;
+  if (numMembers > run->numLanes) {
+    numMembers = run->numLanes;
+  }
+  runEnsembleMembers(run, firstMember, numMembers);
+}
+
+// See ensemble.h
+void runEnsemble(const char *ensembleFile, const char *climFile,
+                 int numThreads, int numLanes) {
+  EnsembleRun run;
+
+  // Member file names end with the events output, the longest suffix
+  const size_t maxPrefixLen = FILENAME_MAXLEN -
+                              strlen(ENSEMBLE_EVENTS_OUT_SUFFIX) -
+                              strlen(outputCompressionSuffix()) - 1;
+  run.members = readPrefixList(ensembleFile, "ensemble member", maxPrefixLen,
+                               &run.numMembers);
+  run.climate = readClimate(climFile);
+  run.numLanes = numLanes;
+  pthread_mutex_init(&run.lock, NULL);
+
+  int numBatches = (run.numMembers + numLanes - 1) / numLanes;
+  numThreads = workPoolThreads(numThreads, numBatches);
+  logInfo("Running %d ensemble members on %d threads, %d at a time per "
+          "thread\n",
+          run.numMembers, numThreads, numLanes);
+  runWorkPool(numBatches, numThreads, runEnsembleBatch, &run, "ensemble");
+
+  pthread_mutex_destroy(&run.lock);
+  freeClimate(run.climate);
+  free(run.members);
+}
@@ -0,0 +1,33 @@
+// header file for running parameter ensembles
+//
+// An ensemble is a set of model runs that differ only in their parameters.
+// All members run over one set of climate data that is read once and shared
+// read-only, and members are handed out to a pool of worker threads.
+
+#ifndef SIPNET_ENSEMBLE_H
+#define SIPNET_ENSEMBLE_H
+
+/*!
+ * Run every member listed in an ensemble file over one shared climate file
+ *
+ * The ensemble file lists one file prefix per line; blank lines and anything
+ * after a '!' are ignored. For a member with prefix P, parameters are read
+ * from P.param and output is written to P.out (and P.events.out and P.single,
+ * when those outputs are turned on). Events are read from the usual events
+ * file and are the same for every member.
+ *
+ * Members are handed to worker threads numLanes at a time as threads become
+ * free, so runs that finish early (e.g. plant death) don't leave threads
+ * idle. With numLanes above one, each thread runs its members together in
+ * lockstep (see lanes.h); the output is the same either way.
+ *
+ * @param ensembleFile file listing the member file prefixes
+ * @param climFile climate file shared by all members
+ * @param numThreads number of worker threads; 0 for one per online CPU
+ * @param numLanes number of members each thread runs together, 1 to
+ *                 MAX_ENSEMBLE_LANES
+ */
+void runEnsemble(const char *ensembleFile, const char *climFile,
+                 int numThreads, int numLanes);
+
+#endif  // SIPNET_ENSEMBLE_H
@@ -23,18 +23,50 @@
 
 #include "common/exitCodes.h"
 #include "common/logging.h"
+#include "common/numFormat.h"
+#include "common/tokenizer.h"
 #include "common/util.h"
 
-#include "state.h"
+#include "compressedOutput.h"
+#include "model.h"
 
 #define EVENT_LINE_SIZE 1024
 
-// Global event variables - definition
-static EventNode *gEvents = NULL;
-static EventNode *gEvent = NULL;
+// Read up to numValues doubles from str, as sscanf would with "%lf %lf ...";
+// return the number read
+static int scanDoubles(const char *str, int numValues, ...) {
+  va_list args;
+  int numRead = 0;
+
+  va_start(args, numValues);
+  while ((numRead < numValues) && scanDouble(&str, va_arg(args, double *))) {
+    ++numRead;
+  }
+  va_end(args);
+
+  return numRead;
+}
 
-// events.out handle, only needed here
-static FILE *eventOutFile = NULL;
+// Read the year, day and event type at the start of an event line, as sscanf
+// would with "%d %d %s"; return the number read. When all three are read,
+// paramsStr is set to the rest of the line, after any whitespace.
+static int scanEventCore(const char *line, int *year, int *day,
+                         char *eventTypeStr, size_t eventTypeSize,
+                         const char **paramsStr) {
+  const char *curr = line;
+
+  if (!scanInt(&curr, year)) {
+    return 0;
+  }
+  if (!scanInt(&curr, day)) {
+    return 1;
+  }
+  if (!scanToken(&curr, eventTypeStr, eventTypeSize)) {
+    return 2;
+  }
+  *paramsStr = skipSpace(curr);
+  return 3;
+}
 
 EventNode *createEventNode(int year, int day, int eventType,
                            const char *eventParamsStr) {
@@ -48,9 +80,8 @@ EventNode *createEventNode(int year, int day, int eventType,
     case HARVEST: {
       double fracRA, fracRB, fracTA, fracTB;
       HarvestParams *hParams = (HarvestParams *)malloc(sizeof(HarvestParams));
-      int numRead =
-          sscanf(eventParamsStr,  // NOLINT
-                 "%lf %lf %lf %lf", &fracRA, &fracRB, &fracTA, &fracTB);
+      int numRead = scanDoubles(eventParamsStr, 4, &fracRA, &fracRB, &fracTA,
+                                &fracTB);
       if (numRead != NUM_HARVEST_PARAMS) {
         logError("parsing Harvest params for year %d day %d\n", year, day);
         exit(EXIT_CODE_INPUT_FILE_ERROR);
@@ -73,8 +104,11 @@ EventNode *createEventNode(int year, int day, int eventType,
       int method;
       IrrigationParams *iParams =
           (IrrigationParams *)malloc(sizeof(IrrigationParams));
-      int numRead = sscanf(eventParamsStr,  // NOLINT
-                           "%lf %d", &amountAdded, &method);
+      const char *curr = eventParamsStr;
+      int numRead = 0;
+      if (scanDouble(&curr, &amountAdded)) {
+        numRead = 1 + scanInt(&curr, &method);
+      }
       if (numRead != NUM_IRRIGATION_PARAMS) {
         logError("parsing Irrigation params for year %d day %d\n", year, day);
         exit(EXIT_CODE_INPUT_FILE_ERROR);
@@ -90,14 +124,13 @@ EventNode *createEventNode(int year, int day, int eventType,
       // double nh4_no3_frac;
       FertilizationParams *fParams =
           (FertilizationParams *)malloc(sizeof(FertilizationParams));
-      int numRead = sscanf(eventParamsStr,  // NOLINT
-                           "%lf %lf %lf", &orgN, &orgC, &minN);
+      int numRead = scanDoubles(eventParamsStr, 3, &orgN, &orgC, &minN);
       if (numRead != NUM_FERTILIZATION_PARAMS) {
         logError("parsing Fertilization params for year %d day %d\n", year,
                  day);
         exit(EXIT_CODE_INPUT_FILE_ERROR);
       }
-      // scanf(eventParamsStr, "%lf %lf %lf %lf", &org_N, &org_C, &min_N,
+      // scanDoubles(eventParamsStr, 4, &org_N, &org_C, &min_N,
       // &nh4_no3_frac);
       fParams->orgN = orgN;
       fParams->orgC = orgC;
@@ -115,9 +148,8 @@ EventNode *createEventNode(int year, int day, int eventType,
       double leafC, woodC, fineRootC, coarseRootC;
       PlantingParams *pParams =
           (PlantingParams *)malloc(sizeof(PlantingParams));
-      int numRead =
-          sscanf(eventParamsStr,  // NOLINT
-                 "%lf %lf %lf %lf", &leafC, &woodC, &fineRootC, &coarseRootC);
+      int numRead = scanDoubles(eventParamsStr, 4, &leafC, &woodC, &fineRootC,
+                                &coarseRootC);
       if (numRead != NUM_PLANTING_PARAMS) {
         logError("parsing Planting params for year %d day %d\n", year, day);
         exit(EXIT_CODE_INPUT_FILE_ERROR);
@@ -131,8 +163,7 @@ EventNode *createEventNode(int year, int day, int eventType,
     case TILLAGE: {
       double tillEffect;
       TillageParams *tParams = (TillageParams *)malloc(sizeof(TillageParams));
-      int numRead = sscanf(eventParamsStr,  // NOLINT
-                           "%lf", &tillEffect);
+      int numRead = scanDoubles(eventParamsStr, 1, &tillEffect);
       if (numRead != NUM_TILLAGE_PARAMS) {
         logError("parsing Tillage params for year %d day %d\n", year, day);
         exit(EXIT_CODE_INPUT_FILE_ERROR);
@@ -144,9 +175,8 @@ EventNode *createEventNode(int year, int day, int eventType,
       double dummy;
       LeafOnParams *lParams = (LeafOnParams *)malloc(sizeof(LeafOnParams));
       // Check for extraneous data: leafon takes no parameters, so error if any
-      // numbers are found. sscanf returns 0 or EOF (-1) for empty/whitespace.
-      int numRead = sscanf(eventParamsStr,  // NOLINT
-                           "%lf", &dummy);
+      // numbers are found.
+      int numRead = scanDoubles(eventParamsStr, 1, &dummy);
       if (numRead > NUM_LEAFON_PARAMS) {
         logError("parsing LeafOn params for year %d day %d\n", year, day);
         exit(EXIT_CODE_INPUT_FILE_ERROR);
@@ -157,9 +187,8 @@ EventNode *createEventNode(int year, int day, int eventType,
       double dummy;
       LeafOffParams *lParams = (LeafOffParams *)malloc(sizeof(LeafOffParams));
       // Check for extraneous data: leafoff takes no parameters, so error if
-      // any numbers are found. sscanf returns 0 or EOF (-1) for empty input.
-      int numRead = sscanf(eventParamsStr,  // NOLINT
-                           "%lf", &dummy);
+      // any numbers are found.
+      int numRead = scanDoubles(eventParamsStr, 1, &dummy);
       if (numRead > NUM_LEAFOFF_PARAMS) {
         logError("parsing LeafOff params for year %d day %d\n", year, day);
         exit(EXIT_CODE_INPUT_FILE_ERROR);
@@ -248,11 +277,11 @@ static void checkEventLineTruncation(const char *line, size_t len) {
   }
 }
 
-void checkForCalculatedLeafEvents(void) {
+void checkForCalculatedLeafEvents(SipnetModel *model) {
   // We have a leaf event in events.in, so make sure we are not also
   // calculating leaf events
-  if (ctx.gdd || ctx.soilPhenol || params.leafOnDay > 0 ||
-      params.leafOffDay > 0) {
+  if (ctx.gdd || ctx.soilPhenol || model->params.leafOnDay > 0 ||
+      model->params.leafOffDay > 0) {
     logError("calculated leaf events (via leafOnDay/leafOffDay params or "
              "gdd/soil-phenol command-line options) are not compatible "
              "with user-specified leaf events in event file\n");
@@ -260,11 +289,10 @@ void checkForCalculatedLeafEvents(void) {
   }
 }
 
-EventNode *readEventData(const char *eventFile) {
+EventNode *readEventData(SipnetModel *model, const char *eventFile) {
   int year, day, eventType;
   int currYear, currDay;
-  int numBytes;
-  char *eventParamsStr;
+  const char *eventParamsStr;
   char eventTypeStr[20];
   char line[EVENT_LINE_SIZE];
   EventNode *curr, *next;
@@ -292,13 +320,12 @@ EventNode *readEventData(const char *eventFile) {
   size_t len = strlen(line);
   checkEventLineTruncation(line, len);
 
-  int numRead = sscanf(line,  // NOLINT
-                       "%d %d %s %n", &year, &day, eventTypeStr, &numBytes);
+  int numRead = scanEventCore(line, &year, &day, eventTypeStr,
+                              sizeof(eventTypeStr), &eventParamsStr);
   if (numRead != NUM_EVENT_CORE_PARAMS) {
     logError("reading event file: bad data on first line\n");
     exit(EXIT_CODE_INPUT_FILE_ERROR);
   }
-  eventParamsStr = line + numBytes;
 
   eventType = eventStringToType(eventTypeStr);
   if (eventType == UNKNOWN_EVENT) {
@@ -309,7 +336,7 @@ EventNode *readEventData(const char *eventFile) {
   if (eventType == LEAFOFF || eventType == LEAFON) {
     // If we have a leaf event, make sure we aren't also looking for
     // calculated leaf events.
-    checkForCalculatedLeafEvents();
+    checkForCalculatedLeafEvents(model);
     hasCheckedLeafEvents = 1;
   }
 
@@ -324,14 +351,13 @@ EventNode *readEventData(const char *eventFile) {
     checkEventLineTruncation(line, len);
     // We have another event
     curr = next;
-    numRead = sscanf(line, "%d %d %s %n",  // NOLINT
-                     &year, &day, eventTypeStr, &numBytes);
+    numRead = scanEventCore(line, &year, &day, eventTypeStr,
+                            sizeof(eventTypeStr), &eventParamsStr);
     if (numRead != NUM_EVENT_CORE_PARAMS) {
       logError("reading event file: bad data on line after year %d day %d\n",
                currYear, currDay);
       exit(EXIT_CODE_INPUT_FILE_ERROR);
     }
-    eventParamsStr = line + numBytes;
 
     eventType = eventStringToType(eventTypeStr);
     if (eventType == UNKNOWN_EVENT) {
@@ -343,7 +369,7 @@ EventNode *readEventData(const char *eventFile) {
       // If we have a leaf event, make sure we aren't also looking for
       // calculated leaf events.
       if (!hasCheckedLeafEvents) {
-        checkForCalculatedLeafEvents();
+        checkForCalculatedLeafEvents(model);
         hasCheckedLeafEvents = 1;
       }
     }
@@ -366,95 +392,125 @@ EventNode *readEventData(const char *eventFile) {
   return newEvents;
 }
 
-void openEventOutFile(const char *eventOutFilePath, int printHeader) {
-  eventOutFile = openFile(eventOutFilePath, "w");
+void openEventOutFile(SipnetModel *model, const char *eventOutFilePath,
+                      int printHeader) {
+  if (model->continueOutputs) {
+    // The header was written by the run being resumed
+    model->eventOutFile = continueOutputFile(eventOutFilePath);
+    return;
+  }
+  model->eventOutFile = openOutputFile(eventOutFilePath);
   if (printHeader) {
     // Use format string analogous to the one in writeEventOut for
     // better alignment (won't be perfect, but definitely better)
-    fprintf(eventOutFile, "%4s  %3s  %-7s  %s", "year", "day", "type",
+    fprintf(model->eventOutFile, "%4s  %3s  %-7s  %s", "year", "day", "type",
             "param_name=delta[,param_name=delta,...]\n");
   }
 }
 
-void doWriteEventOut(int year, int day, const char *type, int numParams,
-                     va_list args) {
+void doWriteEventOut(SipnetModel *model, int year, int day, const char *type,
+                     int numParams, va_list args) {
   int ind = 0;
+  // Room for the year and day, or for one "=<delta>," after a param name
+  char line[FORMAT_MAX_LEN + 16];
+  char *pos;
 
   // Spec:
   // year day event_type <param name=delta>[,<param name>=<delta>,...]
 
-  // Standard prefix for all
-  fprintf(eventOutFile, "%4d  %3d  %-7s  ", year, day, type);
+  // Standard prefix for all; the type is padded to 7 characters
+  pos = formatInt(line, year, 4);
+  pos = formatString(pos, "  ", 0);
+  pos = formatInt(pos, day, 3);
+  pos = formatString(pos, "  ", 0);
+  fwrite(line, 1, pos - line, model->eventOutFile);
+  fputs(type, model->eventOutFile);
+  pos = line;
+  for (int len = (int)strlen(type); len < 7; ++len) {
+    *pos++ = ' ';
+  }
+  pos = formatString(pos, "  ", 0);
+  fwrite(line, 1, pos - line, model->eventOutFile);
 
   // For debugging on linux
   char *param;
   double val;
   // Variable output per oneEvent type
-  for (ind = 0; ind < numParams - 1; ind++) {
+  for (ind = 0; ind < numParams; ind++) {
     // For debugging on linux
     param = va_arg(args, char *);
     val = va_arg(args, double);
-    fprintf(eventOutFile, "%s=%-.2f,", param, val);
+    fputs(param, model->eventOutFile);
+    line[0] = '=';
+    pos = formatFixed(line + 1, val, 0, 2);
+    *pos++ = (ind < numParams - 1) ? ',' : '\n';
+    fwrite(line, 1, pos - line, model->eventOutFile);
   }
-  param = va_arg(args, char *);
-  val = va_arg(args, double);
-  fprintf(eventOutFile, "%s=%-.2f\n", param, val);
 }
 
-void writeEventOut(EventNode *oneEvent, int numParams, ...) {
+void writeEventOut(SipnetModel *model, EventNode *oneEvent, int numParams,
+                   ...) {
   va_list args;
   va_start(args, numParams);
-  doWriteEventOut(oneEvent->year, oneEvent->day,
+  doWriteEventOut(model, oneEvent->year, oneEvent->day,
                   eventTypeToString(oneEvent->type), numParams, args);
   va_end(args);
 }
 
-void writeComputedEventOut(int year, int day, const char *type, int numParams,
-                           ...) {
+void writeComputedEventOut(SipnetModel *model, int year, int day,
+                           const char *type, int numParams, ...) {
   va_list args;
   va_start(args, numParams);
-  doWriteEventOut(year, day, type, numParams, args);
+  doWriteEventOut(model, year, day, type, numParams, args);
   va_end(args);
 }
 
-void closeEventOutFile() {
-  if (eventOutFile) {
-    fclose(eventOutFile);
-    eventOutFile = NULL;
+void closeEventOutFile(SipnetModel *model) {
+  if (model->eventOutFile) {
+    fclose(model->eventOutFile);
+    model->eventOutFile = NULL;
   }
 }
 
-void initEvents(const char *eventInFile, const char *eventOutFilePath,
-                int printHeader) {
+void initEvents(SipnetModel *model, const char *eventInFile,
+                const char *eventOutFilePath, int printHeader) {
   if (ctx.events) {
-    gEvents = readEventData(eventInFile);
-    openEventOutFile(eventOutFilePath, printHeader);
+    model->events = readEventData(model, eventInFile);
+    openEventOutFile(model, eventOutFilePath, printHeader);
   }
 }
 
-void setupEvents() { gEvent = gEvents; }
+void setupEvents(SipnetModel *model) { model->event = model->events; }
 
-int isFirstEventBefore(int year, int day) {
-  if (gEvents == NULL) {
+void skipEventsBefore(SipnetModel *model, int year, int day) {
+  while (model->event != NULL &&
+         (model->event->year < year ||
+          (model->event->year == year && model->event->day < day))) {
+    model->event = model->event->nextEvent;
+  }
+}
+
+int isFirstEventBefore(SipnetModel *model, int year, int day) {
+  if (model->events == NULL) {
     // No events, so nothing to check
     return 0;
   }
-  EventNode *firstEvent = gEvents;
+  EventNode *firstEvent = model->events;
   if (firstEvent->year != year) {
     return firstEvent->year < year;
   }
   return firstEvent->day < day;
 }
 
-void processEvents(void) {
+void processEvents(SipnetModel *model) {
   // Event fluxes have all been reset to zero at the start of the time step,
   // so we can just add to them as needed
 
   // If event starts off NULL, this function will just fall through, as it
   // should.
-  const int climYear = climate->year;
-  const int climDay = climate->day;
-  const double climLen = climate->length;
+  const int climYear = model->climate->year;
+  const int climDay = model->climate->day;
+  const double climLen = model->climate->length;
 
   // As this is used as a divisor in many places, let's make sure it's >0
   if (climLen <= 0) {
@@ -465,30 +521,31 @@ void processEvents(void) {
   }
 
   // Reset harvest tracking
-  eventTrackers.harvestFracRemoved = 0;
-  eventTrackers.harvestFracTransferred = 0;
+  model->eventTrackers.harvestFracRemoved = 0;
+  model->eventTrackers.harvestFracTransferred = 0;
 
-  while (gEvent != NULL && gEvent->year <= climYear && gEvent->day <= climDay) {
+  while (model->event != NULL && model->event->year <= climYear &&
+         model->event->day <= climDay) {
     // The events file has been tested on read, so we know this event list
     // should be in chrono order. However, we need to check to make sure the
     // current event is not in the past, as that would indicate an event that
     // did not have a corresponding climate file record.
-    if (gEvent->year < climYear || gEvent->day < climDay) {
+    if (model->event->year < climYear || model->event->day < climDay) {
       logError("Agronomic event found for year: %d day: %d that does not "
                "have a corresponding record in the climate file\n",
-               gEvent->year, gEvent->day);
+               model->event->year, model->event->day);
       exit(EXIT_CODE_INPUT_FILE_ERROR);
     }
 
-    switch (gEvent->type) {
+    switch (model->event->type) {
       case IRRIGATION: {
-        const IrrigationParams *irrParams = gEvent->eventParams;
+        const IrrigationParams *irrParams = model->event->eventParams;
         const double amount = irrParams->amountAdded;
         double soilAmount, evapAmount;
         if (irrParams->method == CANOPY) {
           // Part of the irrigation evaporates, and the rest makes it to the
           // soil. Evaporated fraction:
-          evapAmount = params.immedEvapFrac * amount;
+          evapAmount = model->params.immedEvapFrac * amount;
           // Soil fraction:
           soilAmount = amount - evapAmount;
         } else if (irrParams->method == SOIL) {
@@ -499,23 +556,23 @@ void processEvents(void) {
           logError("Unknown irrigation method type: %d\n", irrParams->method);
           exit(EXIT_CODE_UNKNOWN_EVENT_TYPE_OR_PARAM);
         }
-        fluxes.eventEvap += evapAmount / climLen;
-        fluxes.eventSoilWater += soilAmount / climLen;
-        writeEventOut(gEvent, 2, "eventSoilWater", soilAmount, "eventEvap",
-                      evapAmount);
+        model->fluxes.eventEvap += evapAmount / climLen;
+        model->fluxes.eventSoilWater += soilAmount / climLen;
+        writeEventOut(model, model->event, 2, "eventSoilWater", soilAmount,
+                      "eventEvap", evapAmount);
       } break;
       case PLANTING: {
-        const PlantingParams *plantParams = gEvent->eventParams;
+        const PlantingParams *plantParams = model->event->eventParams;
         const double leafC = plantParams->leafC;
         const double woodC = plantParams->woodC;
         const double fineRootC = plantParams->fineRootC;
         const double coarseRootC = plantParams->coarseRootC;
 
         // Update the fluxes
-        fluxes.eventLeafC += leafC / climLen;
-        fluxes.eventWoodC += woodC / climLen;
-        fluxes.eventFineRootC += fineRootC / climLen;
-        fluxes.eventCoarseRootC += coarseRootC / climLen;
+        model->fluxes.eventLeafC += leafC / climLen;
+        model->fluxes.eventWoodC += woodC / climLen;
+        model->fluxes.eventFineRootC += fineRootC / climLen;
+        model->fluxes.eventCoarseRootC += coarseRootC / climLen;
 
         // No need to allocate to biomass N pools, we don't track that N
         // explicitly
@@ -523,15 +580,16 @@ void processEvents(void) {
         // MASS BALANCE: this is a system input
         const double inputC = leafC + woodC + fineRootC + coarseRootC;
         double inputN = 0.0;
-        fluxes.eventInputC += inputC / climLen;
+        model->fluxes.eventInputC += inputC / climLen;
         if (ctx.nitrogenCycle) {
-          inputN = leafC / params.leafCN + woodC / params.woodCN +
-                   fineRootC / params.fineRootCN + coarseRootC / params.woodCN;
-          fluxes.eventInputN += inputN / climLen;
+          inputN = leafC / model->params.leafCN + woodC / model->params.woodCN +
+                   fineRootC / model->params.fineRootCN +
+                   coarseRootC / model->params.woodCN;
+          model->fluxes.eventInputN += inputN / climLen;
         }
 
         // clang-format off
-        writeEventOut(gEvent, 6,
+        writeEventOut(model, model->event, 6,
                       "eventLeafC", leafC,
                       "eventWoodC", woodC,
                       "eventFineRootC", fineRootC,
@@ -543,35 +601,38 @@ void processEvents(void) {
       case HARVEST: {
         // Harvest can both remove biomass and move biomass to the soil/litter
         // pools
-        const HarvestParams *harvParams = gEvent->eventParams;
+        const HarvestParams *harvParams = model->event->eventParams;
         const double fracRA = harvParams->fractionRemovedAbove;
         const double fracTA = harvParams->fractionTransferredAbove;
         const double fracRB = harvParams->fractionRemovedBelow;
         const double fracTB = harvParams->fractionTransferredBelow;
-        const double woodC = envi.plantWoodC + envi.plantCAccountingDelta;
+        const double woodC = model->envi.plantWoodC +
+                             model->envi.plantCAccountingDelta;
 
         // Record fraction of total biomass removed and transferred
-        double aboveMass = woodC + envi.plantLeafC;
-        double belowMass = envi.fineRootC + envi.coarseRootC;
+        double aboveMass = woodC + model->envi.plantLeafC;
+        double belowMass = model->envi.fineRootC + model->envi.coarseRootC;
         double totalMass = aboveMass + belowMass;
         if (totalMass > TINY) {
           double massRemoved = fracRA * aboveMass + fracRB * belowMass;
           double massTransferred = fracTA * aboveMass + fracTB * belowMass;
-          eventTrackers.harvestFracRemoved += massRemoved / totalMass;
-          eventTrackers.harvestFracTransferred += massTransferred / totalMass;
+          model->eventTrackers.harvestFracRemoved += massRemoved / totalMass;
+          model->eventTrackers.harvestFracTransferred +=
+              massTransferred / totalMass;
         }
 
         // Litter increase
-        double litterAdd = fracTA * (envi.plantLeafC + woodC);
-        double soilAdd = fracTB * (envi.fineRootC + envi.coarseRootC);
+        double litterAdd = fracTA * (model->envi.plantLeafC + woodC);
+        double soilAdd = fracTB *
+                         (model->envi.fineRootC + model->envi.coarseRootC);
 
         // Pool reductions, counting both mass moved to litter and removed by
         // the harvest itself. Above-ground changes:
-        const double leafDelta = -envi.plantLeafC * (fracRA + fracTA);
+        const double leafDelta = -model->envi.plantLeafC * (fracRA + fracTA);
         const double woodDelta = -woodC * (fracRA + fracTA);
         // Below-ground changes:
-        const double fineDelta = -envi.fineRootC * (fracRB + fracTB);
-        const double coarseDelta = -envi.coarseRootC * (fracRB + fracTB);
+        const double fineDelta = -model->envi.fineRootC * (fracRB + fracTB);
+        const double coarseDelta = -model->envi.coarseRootC * (fracRB + fracTB);
 
         // Pool updates:
         if (!ctx.litterPool) {
@@ -579,12 +640,12 @@ void processEvents(void) {
           soilAdd += litterAdd;
           litterAdd = 0.0;
         }
-        fluxes.eventLitterC += litterAdd / climLen;
-        fluxes.eventSoilC += soilAdd / climLen;
-        fluxes.eventLeafC += leafDelta / climLen;
-        fluxes.eventWoodC += woodDelta / climLen;
-        fluxes.eventFineRootC += fineDelta / climLen;
-        fluxes.eventCoarseRootC += coarseDelta / climLen;
+        model->fluxes.eventLitterC += litterAdd / climLen;
+        model->fluxes.eventSoilC += soilAdd / climLen;
+        model->fluxes.eventLeafC += leafDelta / climLen;
+        model->fluxes.eventWoodC += woodDelta / climLen;
+        model->fluxes.eventFineRootC += fineDelta / climLen;
+        model->fluxes.eventCoarseRootC += coarseDelta / climLen;
 
         // No need to allocate to biomass N pools, we don't track that N
         // explicitly. We do need to handle soil and litter N, though.
@@ -593,34 +654,35 @@ void processEvents(void) {
         double litterNAdd = 0.0;
         double soilNAdd = 0.0;
         if (ctx.nitrogenCycle) {
-          const double totalAbove = (envi.plantLeafC / params.leafCN) +
-                                    (envi.plantWoodC / params.woodCN);
-          const double totalBelow = (envi.fineRootC / params.fineRootCN) +
-                                    (envi.coarseRootC / params.woodCN);
+          const double totalAbove =
+              (model->envi.plantLeafC / model->params.leafCN) +
+              (model->envi.plantWoodC / model->params.woodCN);
+          const double totalBelow =
+              (model->envi.fineRootC / model->params.fineRootCN) +
+              (model->envi.coarseRootC / model->params.woodCN);
           litterNAdd = fracTA * totalAbove;
           soilNAdd = fracTB * totalBelow;
-          fluxes.eventSoilOrgN += soilNAdd / climLen;
-          fluxes.eventLitterN += litterNAdd / climLen;
+          model->fluxes.eventSoilOrgN += soilNAdd / climLen;
+          model->fluxes.eventLitterN += litterNAdd / climLen;
         }
 
         // MASS BALANCE: removed fractions are system outputs
-        const double outputC = ((woodC + envi.plantLeafC) * fracRA +
-                                (envi.fineRootC + envi.coarseRootC) * fracRB);
+        const double outputC = ((woodC + model->envi.plantLeafC) * fracRA +
+                                (model->envi.fineRootC +
+                                 model->envi.coarseRootC) * fracRB);
         double outputN = 0.0;
-        fluxes.eventOutputC += outputC / climLen;
+        model->fluxes.eventOutputC += outputC / climLen;
         if (ctx.nitrogenCycle) {
           // just plantWoodC here, not woodC
-          outputN = (envi.plantWoodC / params.woodCN +
-                     envi.plantLeafC / params.leafCN) *
-                        fracRA +
-                    (envi.fineRootC / params.fineRootCN +
-                     envi.coarseRootC / params.woodCN) *
-                        fracRB;
-          fluxes.eventOutputN += outputN / climLen;
+          outputN = (model->envi.plantWoodC / model->params.woodCN +
+                     model->envi.plantLeafC / model->params.leafCN) * fracRA +
+                    (model->envi.fineRootC / model->params.fineRootCN +
+                     model->envi.coarseRootC / model->params.woodCN) * fracRB;
+          model->fluxes.eventOutputN += outputN / climLen;
         }
         // clang-format off
         writeEventOut(
-            gEvent, 10,
+            model, model->event, 10,
             "eventSoilC", soilAdd,
             "eventLitterC", litterAdd,
             "eventLeafC", leafDelta,
@@ -636,16 +698,16 @@ void processEvents(void) {
       case TILLAGE: {
         // BIG NOTE: this is the one event type that is NOT modeled as a flux;
         // see updateEventTrackers() for more
-        const TillageParams *tillParams = gEvent->eventParams;
+        const TillageParams *tillParams = model->event->eventParams;
         // Update the tillage mod for R_H calculations; this will be slowly
         // reduced by an exponential decay function. Note we add here, not set,
         // as there may be lingering effects from a prior tillage.
-        eventTrackers.d_till_mod += tillParams->tillageEffect;
-        writeEventOut(gEvent, 1, "eventTrackers.d_till_mod",
+        model->eventTrackers.d_till_mod += tillParams->tillageEffect;
+        writeEventOut(model, model->event, 1, "eventTrackers.d_till_mod",
                       tillParams->tillageEffect);
       } break;
       case FERTILIZATION: {
-        const FertilizationParams *fertParams = gEvent->eventParams;
+        const FertilizationParams *fertParams = model->event->eventParams;
         const double orgC = fertParams->orgC;
         double orgN = 0.0;
         double minN = 0.0;
@@ -654,27 +716,27 @@ void processEvents(void) {
           minN = fertParams->minN;
         }
         if (ctx.litterPool) {
-          fluxes.eventLitterC += orgC / climLen;
+          model->fluxes.eventLitterC += orgC / climLen;
         } else {
-          fluxes.eventSoilC += orgC / climLen;
+          model->fluxes.eventSoilC += orgC / climLen;
         }
 
         if (ctx.nitrogenCycle) {
           // As the warning says in readEventData(), we ignore N when the
           // nitrogen cycle model is off
           // Implies ctx.litterPool
-          fluxes.eventLitterN += orgN / climLen;
-          fluxes.eventMinN += minN / climLen;
+          model->fluxes.eventLitterN += orgN / climLen;
+          model->fluxes.eventMinN += minN / climLen;
         }
 
         // MASS BALANCE: this is a system input
-        fluxes.eventInputC += orgC / climLen;
+        model->fluxes.eventInputC += orgC / climLen;
         if (ctx.nitrogenCycle) {
-          fluxes.eventInputN += (orgN + minN) / climLen;
+          model->fluxes.eventInputN += (orgN + minN) / climLen;
         }
 
         // clang-format off
-        writeEventOut(gEvent, 6,
+        writeEventOut(model, model->event, 6,
           "eventLitterC", ctx.litterPool ? orgC : 0.0,
           "eventSoilC", ctx.litterPool ? 0.0 : orgC,
           "eventMinN", minN,
@@ -684,13 +746,13 @@ void processEvents(void) {
         // clang-format on
       } break;
       case LEAFON: {
-        double leafOnFlux = params.leafGrowth / climLen;
-        checkLeafOnLimitation(&leafOnFlux);
-        fluxes.eventLeafOnCreation += leafOnFlux;
-        double totalSourceC = envi.plantWoodC + envi.coarseRootC;
+        double leafOnFlux = model->params.leafGrowth / climLen;
+        checkLeafOnLimitation(model, &leafOnFlux);
+        model->fluxes.eventLeafOnCreation += leafOnFlux;
+        double totalSourceC = model->envi.plantWoodC + model->envi.coarseRootC;
         if (totalSourceC > TINY) {
-          fluxes.eventLeafOnCreationFromWood +=
-              leafOnFlux * envi.plantWoodC / totalSourceC;
+          model->fluxes.eventLeafOnCreationFromWood +=
+              leafOnFlux * model->envi.plantWoodC / totalSourceC;
         }
 
         // Nitrogen is handled implicitly by relative CN ratios. Missing N
@@ -704,23 +766,23 @@ void processEvents(void) {
         // limitation may change the amount
       } break;
       case LEAFOFF: {
-        double leafOff = envi.plantLeafC * params.fracLeafFall;
-        fluxes.eventLeafOffLitter += leafOff / climLen;
+        double leafOff = model->envi.plantLeafC * model->params.fracLeafFall;
+        model->fluxes.eventLeafOffLitter += leafOff / climLen;
 
         double litterNAdd = 0.0;
         double leafNResorption = 0.0;
         if (ctx.nitrogenCycle) {
           // Nitrogen - need to account for leaf N moving to litter, as with
           // harvests
-          double leafN = leafOff / params.leafCN;
-          leafNResorption = leafN * params.leafNResorptionFrac;
+          double leafN = leafOff / model->params.leafCN;
+          leafNResorption = leafN * model->params.leafNResorptionFrac;
           litterNAdd = leafN - leafNResorption;
-          fluxes.eventLeafOffNResorption += leafNResorption / climLen;
-          fluxes.eventLitterN += litterNAdd / climLen;
+          model->fluxes.eventLeafOffNResorption += leafNResorption / climLen;
+          model->fluxes.eventLitterN += litterNAdd / climLen;
         }
 
         // clang-format off
-        writeEventOut(gEvent, 3,
+        writeEventOut(model, model->event, 3,
           "eventLeafOffLitter", leafOff,
           "eventLeafOffNResorption", leafNResorption,
           "eventLitterN", litterNAdd);
@@ -730,69 +792,81 @@ void processEvents(void) {
         // There should be no way to get here, but covering our bases...
         logWarning("PLANTDEATH event found for year %d day %d, but not "
                    "implemented as an input event; ignoring\n",
-                   gEvent->year, gEvent->day);
+                   model->event->year, model->event->day);
         break;
       default:
-        logError("Unknown event type (%d) in processEvents()\n", gEvent->type);
+        logError("Unknown event type (%d) in processEvents()\n",
+                 model->event->type);
         exit(EXIT_CODE_UNKNOWN_EVENT_TYPE_OR_PARAM);
     }
 
-    gEvent = gEvent->nextEvent;
+    model->event = model->event->nextEvent;
   }
 }
 
-void updatePoolsForEvents(void) {
+void updatePoolsForEvents(SipnetModel *model) {
   // CARBON
   // Harvest and planting events
-  envi.plantWoodC += fluxes.eventWoodC * climate->length;
-  envi.plantLeafC += fluxes.eventLeafC * climate->length;
+  model->envi.plantWoodC += model->fluxes.eventWoodC * model->climate->length;
+  model->envi.plantLeafC += model->fluxes.eventLeafC * model->climate->length;
 
   // Harvest and fertilization events
-  envi.soilC += fluxes.eventSoilC * climate->length;
+  model->envi.soilC += model->fluxes.eventSoilC * model->climate->length;
   if (ctx.litterPool) {
-    envi.litterC += fluxes.eventLitterC * climate->length;
+    model->envi.litterC += model->fluxes.eventLitterC * model->climate->length;
   }
 
   // Leaf on and off events
   // Leaf on draws from wood and coarse root pools in proportion to their sizes
-  envi.plantWoodC -= fluxes.eventLeafOnCreationFromWood * climate->length;
+  model->envi.plantWoodC -= model->fluxes.eventLeafOnCreationFromWood *
+                            model->climate->length;
   double eventLeafOnCreationFromRoot =
-      fluxes.eventLeafOnCreation - fluxes.eventLeafOnCreationFromWood;
-  envi.coarseRootC -= eventLeafOnCreationFromRoot * climate->length;
-  envi.plantLeafC += (fluxes.eventLeafOnCreation - fluxes.eventLeafOffLitter) *
-                     climate->length;
+      model->fluxes.eventLeafOnCreation -
+      model->fluxes.eventLeafOnCreationFromWood;
+  model->envi.coarseRootC -= eventLeafOnCreationFromRoot *
+                             model->climate->length;
+  model->envi.plantLeafC += (model->fluxes.eventLeafOnCreation -
+                             model->fluxes.eventLeafOffLitter) *
+                            model->climate->length;
   if (ctx.litterPool) {
-    envi.litterC += fluxes.eventLeafOffLitter * climate->length;
+    model->envi.litterC += model->fluxes.eventLeafOffLitter *
+                           model->climate->length;
   } else {
-    envi.soilC += fluxes.eventLeafOffLitter * climate->length;
+    model->envi.soilC += model->fluxes.eventLeafOffLitter *
+                         model->climate->length;
   }
 
   // Harvest and planting events
-  envi.coarseRootC += fluxes.eventCoarseRootC * climate->length;
-  envi.fineRootC += fluxes.eventFineRootC * climate->length;
+  model->envi.coarseRootC += model->fluxes.eventCoarseRootC *
+                             model->climate->length;
+  model->envi.fineRootC += model->fluxes.eventFineRootC *
+                           model->climate->length;
 
   // WATER
   // Irrigation events
-  envi.soilWater += fluxes.eventSoilWater * climate->length;
+  model->envi.soilWater += model->fluxes.eventSoilWater *
+                           model->climate->length;
 
   // NITROGEN
   // Harvest, fertilization, and leaf-off events
   // (Planting events don't explicitly handle N)
   // Note: nitrogen_cycle implies litter_pool
   if (ctx.nitrogenCycle) {
-    envi.minN += fluxes.eventMinN * climate->length;
-    envi.soilOrgN += fluxes.eventSoilOrgN * climate->length;
-    envi.litterN += fluxes.eventLitterN * climate->length;
-    double leafOnNFlux = calcLeafOnNFromC(fluxes.eventLeafOnCreation);
-    envi.plantStorageN +=
-        (fluxes.eventLeafOffNResorption - leafOnNFlux) * climate->length;
+    model->envi.minN += model->fluxes.eventMinN * model->climate->length;
+    model->envi.soilOrgN += model->fluxes.eventSoilOrgN *
+                            model->climate->length;
+    model->envi.litterN += model->fluxes.eventLitterN * model->climate->length;
+    double leafOnNFlux = calcLeafOnNFromC(model,
+                                          model->fluxes.eventLeafOnCreation);
+    model->envi.plantStorageN += (model->fluxes.eventLeafOffNResorption -
+                                  leafOnNFlux) * model->climate->length;
   }
 }
 
-void freeEventList(void) {
+void freeEventList(SipnetModel *model) {
   EventNode *curr, *prev;
 
-  curr = gEvents;
+  curr = model->events;
   while (curr != NULL) {
     prev = curr;
     curr = curr->nextEvent;
@@ -803,20 +877,19 @@ void freeEventList(void) {
   }
 }
 
-// Definition of global event trackers struct
-EventTrackers eventTrackers;
-
-void initEventTrackers(void) { eventTrackers.d_till_mod = 0.0; }
+void initEventTrackers(SipnetModel *model) {
+  model->eventTrackers.d_till_mod = 0.0;
+}
 
-void updateEventTrackers(void) {
-  const double climLen = climate->length;
+void updateEventTrackers(SipnetModel *model) {
+  const double climLen = model->climate->length;
 
   // Tillage: decay any existing tillage effects at end of step
-  if (eventTrackers.d_till_mod > 0) {
-    eventTrackers.d_till_mod *= exp(-climLen * TILLAGE_DECAY_FACTOR);
+  if (model->eventTrackers.d_till_mod > 0) {
+    model->eventTrackers.d_till_mod *= exp(-climLen * TILLAGE_DECAY_FACTOR);
 
-    if (eventTrackers.d_till_mod < TILLAGE_THRESHOLD) {
-      eventTrackers.d_till_mod = 0.0;
+    if (model->eventTrackers.d_till_mod < TILLAGE_THRESHOLD) {
+      model->eventTrackers.d_till_mod = 0.0;
     }
   }
 }
@@ -1,6 +1,9 @@
 #ifndef EVENTS_H
 #define EVENTS_H
 
+// Model instance holding all run state; defined in model.h
+typedef struct SipnetModel SipnetModel;
+
 typedef enum EventType {
   FERTILIZATION,
   HARVEST,
@@ -106,15 +109,18 @@ event_type_t eventStringToType(const char *eventTypeStr);
  * Format: returned data is structured as an linked list of EventNode pointers.
  * It is assumed that the events are ordered by year and day.
  */
-EventNode *readEventData(const char *eventFile);
+EventNode *readEventData(SipnetModel *model, const char *eventFile);
 
 /*!
  * Open the configured event output file and optionally write a header row
+ *
+ * With model->continueOutputs, the file is appended to, without a header.
  * @param eventOutFile Path to event output file
  * @param printHeader Flag, non-zero value means write a header row
  * @return FILE pointer to output file
  */
-void openEventOutFile(const char *eventOutFile, int printHeader);
+void openEventOutFile(SipnetModel *model, const char *eventOutFile,
+                      int printHeader);
 
 /*!
  * \brief Write a line to the event output file for a single oneEvent
@@ -133,7 +139,7 @@ void openEventOutFile(const char *eventOutFile, int printHeader);
  * \param ...       Pairs of (char*, double) arguments to write, 2*numParams
  *                  values
  */
-void writeEventOut(EventNode *oneEvent, int numParams, ...);
+void writeEventOut(SipnetModel *model, EventNode *oneEvent, int numParams, ...);
 
 /*!
  * \brief Write a line to the event output file for a computed event
@@ -152,13 +158,13 @@ void writeEventOut(EventNode *oneEvent, int numParams, ...);
  * \param ...       Pairs of (char*, double) arguments to write, 2*numParams
  *                  values
  */
-void writeComputedEventOut(int year, int day, const char *type, int numParams,
-                           ...);
+void writeComputedEventOut(SipnetModel *model, int year, int day,
+                           const char *type, int numParams, ...);
 
 /*!
  * Close the event output file
  */
-void closeEventOutFile(void);
+void closeEventOutFile(SipnetModel *model);
 
 /*!
  * Read in event data for all the model runs
@@ -170,13 +176,24 @@ void closeEventOutFile(void);
  * @param eventInFile Name of file containing event data
  * @param eventOutFile Name of file to write processed event output to
  */
-void initEvents(const char *eventInFile, const char *eventOutFile,
-                int printHeader);
+void initEvents(SipnetModel *model, const char *eventInFile,
+                const char *eventOutFile, int printHeader);
 
 /*!
  * Initialize global event pointer
  */
-void setupEvents(void);
+void setupEvents(SipnetModel *model);
+
+/*!
+ * Move the event pointer past events dated before the input date
+ *
+ * For a run resumed in the same process, whose event list still holds the
+ * events of the segments already run.
+ *
+ * @param year
+ * @param day
+ */
+void skipEventsBefore(SipnetModel *model, int year, int day);
 
 /*!
  * Check if the first event is before the input date
@@ -184,7 +201,7 @@ void setupEvents(void);
  * @param year
  * @param day
  */
-int isFirstEventBefore(int year, int day);
+int isFirstEventBefore(SipnetModel *model, int year, int day);
 
 /*!
  * \brief Process events for current location/year/day
@@ -197,17 +214,17 @@ int isFirstEventBefore(int year, int day);
  * and write a row to the configured event output file listing the modified
  * variables and the delta applied.
  */
-void processEvents(void);
+void processEvents(SipnetModel *model);
 
 /*!
  * Update relevant environment pools after event fluxes have been calculated
  */
-void updatePoolsForEvents(void);
+void updatePoolsForEvents(SipnetModel *model);
 
 /*!
  * Deallocate space used for events linked list
  */
-void freeEventList(void);
+void freeEventList(SipnetModel *model);
 
 // Variables to track events with lingering effects
 typedef struct EventTrackerStruct {
@@ -220,16 +237,14 @@ typedef struct EventTrackerStruct {
   double harvestFracTransferred;
 } EventTrackers;
 
-extern EventTrackers eventTrackers;
-
 /*!
  * Initialize EventTrackers struct for tracking lingering event effects
  */
-void initEventTrackers(void);
+void initEventTrackers(SipnetModel *model);
 
 /*!
  * Perform any needed updates post fluxes-and-pools updates
  */
-void updateEventTrackers(void);
+void updateEventTrackers(SipnetModel *model);
 
 #endif  // EVENTS_H
@@ -0,0 +1,147 @@
+#include "forcing.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "common/exitCodes.h"
+#include "common/logging.h"
+
+#include "depeffects.h"
+#include "model.h"
+
+#define NUM_FORCING_VARS 8
+
+// Allocate forcing with room for capacity steps, with the struct and all of
+// its arrays in one block
+static ForcingData *allocForcingData(long capacity) {
+  ForcingData *forcing;
+  double *doubles;
+
+  forcing = (ForcingData *)malloc(sizeof(ForcingData) +
+                                  capacity * NUM_FORCING_VARS * sizeof(double));
+  if (forcing == NULL) {
+    logError("memory allocation failure calculating forcing (%ld steps)\n",
+             capacity);
+    exit(EXIT_CODE_INTERNAL_ERROR);
+  }
+
+  doubles = (double *)(forcing + 1);
+  forcing->dTemp = doubles;
+  forcing->dVpd = doubles + capacity;
+  forcing->folRespTempEffect = doubles + 2 * capacity;
+  forcing->woodRespTempEffect = doubles + 3 * capacity;
+  forcing->soilTempEffect = doubles + 4 * capacity;
+  forcing->coarseRootTempEffect = doubles + 5 * capacity;
+  forcing->fineRootTempEffect = doubles + 6 * capacity;
+  forcing->rd = doubles + 7 * capacity;
+
+  forcing->numSteps = 0;
+  forcing->capacity = capacity;
+  forcing->climateData = NULL;
+
+  return forcing;
+}
+
+// Calculate every term for data->numSteps steps. Each term gets its own loop
+// over the steps, with anything that depends only on the parameters hoisted
+// out of it.
+static void calcForcingSteps(SipnetModel *model, const ClimateData *data,
+                             ForcingData *forcing) {
+  const Params *params = &model->params;
+  const long numSteps = data->numSteps;
+
+  // Photosynthesis: reductions to the daily maximum for temperature and vpd
+  // :: from [1], eq (A9)
+  const double psnTRange = pow((params->psnTMax - params->psnTMin) / 2.0, 2);
+  for (long step = 0; step < numSteps; ++step) {
+    const double tair = data->tair[step];
+    const double dTemp = (params->psnTMax - tair) * (tair - params->psnTMin) /
+                         psnTRange;
+    forcing->dTemp[step] = fmax(dTemp, 0.0);
+  }
+  // :: from [1], eq (A10); modified to accept a variable exponent, [1] uses
+  // dVpdExp = 2 [TAG:UNKNOWN_PROVENANCE] vpd exponent
+  for (long step = 0; step < numSteps; ++step) {
+    const double dVpd = 1.0 - params->dVpdSlope *
+                                  pow(data->vpd[step], params->dVpdExp);
+    forcing->dVpd[step] = fmax(dVpd, 0.0);
+  }
+
+  // Vegetation respiration
+  // :: from [1], eqs (A18) and (A19)
+  for (long step = 0; step < numSteps; ++step) {
+    forcing->folRespTempEffect[step] = pow(
+        params->vegRespQ10, (data->tair[step] - params->psnTOpt) / 10.0);
+  }
+  for (long step = 0; step < numSteps; ++step) {
+    forcing->woodRespTempEffect[step] = pow(params->vegRespQ10,
+                                            data->tair[step] / 10.0);
+  }
+
+  // Soil and litter respiration, methane and volatilization
+  for (long step = 0; step < numSteps; ++step) {
+    forcing->soilTempEffect[step] = calcTempEffect(model, data->tsoil[step]);
+  }
+
+  // Root respiration
+  // :: from [3], root model description (eq (1) with root params)
+  for (long step = 0; step < numSteps; ++step) {
+    forcing->coarseRootTempEffect[step] = pow(params->coarseRootQ10,
+                                              data->tsoil[step] / 10.0);
+  }
+  for (long step = 0; step < numSteps; ++step) {
+    forcing->fineRootTempEffect[step] = pow(params->fineRootQ10,
+                                            data->tsoil[step] / 10.0);
+  }
+
+  // Aerodynamic resistance between ground and canopy air space (sec/m)
+  for (long step = 0; step < numSteps; ++step) {
+    forcing->rd[step] = params->rdConst / data->wspd[step];
+  }
+
+  forcing->numSteps = numSteps;
+}
+
+// See forcing.h
+void updateForcing(SipnetModel *model) {
+  const ClimateData *data = model->climateData;
+
+  if (data == NULL) {
+    return;
+  }
+  if ((model->forcing == NULL) || (model->forcing->capacity < data->numSteps)) {
+    freeForcing(model);
+    model->forcing = allocForcingData(data->numSteps);
+  }
+
+  calcForcingSteps(model, data, model->forcing);
+  model->forcing->climateData = data;
+}
+
+// See forcing.h
+void calcStepForcing(SipnetModel *model, ClimateNode *climate) {
+  // View the step as one-step climate and forcing data, so it is calculated
+  // exactly as the model's climate data is
+  ClimateData data = {.numSteps = 1,
+                      .tair = &climate->tair,
+                      .tsoil = &climate->tsoil,
+                      .vpd = &climate->vpd,
+                      .wspd = &climate->wspd};
+  ForcingData forcing = {.capacity = 1,
+                         .dTemp = &climate->dTemp,
+                         .dVpd = &climate->dVpd,
+                         .folRespTempEffect = &climate->folRespTempEffect,
+                         .woodRespTempEffect = &climate->woodRespTempEffect,
+                         .soilTempEffect = &climate->soilTempEffect,
+                         .coarseRootTempEffect = &climate->coarseRootTempEffect,
+                         .fineRootTempEffect = &climate->fineRootTempEffect,
+                         .rd = &climate->rd};
+
+  calcForcingSteps(model, &data, &forcing);
+}
+
+// See forcing.h
+void freeForcing(SipnetModel *model) {
+  free(model->forcing);
+  model->forcing = NULL;
+}
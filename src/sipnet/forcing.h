@@ -0,0 +1,57 @@
+// header file for climate-derived forcing
+//
+// Some terms of the flux calculations depend only on the climate and the
+// parameters, not on the model state: the temperature and vpd effects on
+// photosynthesis, the Q10 temperature effects on respiration, and the
+// aerodynamic resistance. Rather than recalculating them inside the step loop,
+// they are calculated for every step of the climate data in one pass when the
+// model is set up (for streamed climate, once per chunk), and setClimateStep()
+// copies them into model->climate along with the climate itself.
+
+#ifndef SIPNET_FORCING_H
+#define SIPNET_FORCING_H
+
+#include "state.h"
+
+// Climate-derived terms for every step of a model's climate data, stored as
+// one array per term; see ClimateVars for the meaning of each term. The struct
+// and all of its arrays share a single allocation.
+typedef struct ForcingData {
+  // number of time steps, and number of steps there is room for
+  long numSteps;
+  long capacity;
+  // climate data the terms were calculated from
+  const ClimateData *climateData;
+
+  double *dTemp;
+  double *dVpd;
+  double *folRespTempEffect;
+  double *woodRespTempEffect;
+  double *soilTempEffect;
+  double *coarseRootTempEffect;
+  double *fineRootTempEffect;
+  double *rd;
+} ForcingData;
+
+/*!
+ * Calculate model->forcing for every step of model->climateData
+ *
+ * Must be called again whenever the climate data or the parameters the terms
+ * depend on change; reuses the existing allocation when it is large enough.
+ */
+void updateForcing(SipnetModel *model);
+
+/*!
+ * Calculate the climate-derived terms of a single climate step in place
+ *
+ * For climate steps that are not part of the model's climate data, e.g. ones
+ * set up by hand in tests.
+ */
+void calcStepForcing(SipnetModel *model, ClimateNode *climate);
+
+/*!
+ * Free model->forcing
+ */
+void freeForcing(SipnetModel *model);
+
+#endif  // SIPNET_FORCING_H
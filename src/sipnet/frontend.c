@@ -15,11 +15,15 @@
 #include "common/util.h"
 
 #include "cli.h"
+#include "compressedOutput.h"
 #include "debug_log.h"
+#include "ensemble.h"
 #include "events.h"
 #include "sipnet.h"
-#include "state.h"
+#include "model.h"
 #include "outputItems.h"
+#include "restart.h"
+#include "scenario.h"
 
 void checkRuntype(const char *runType) {
   if (strcasecmp(runType, "standard") != 0) {
@@ -127,18 +131,34 @@ void readInputFile(void) {
   fclose(infile);
 }
 
+// Write the final config to <file-prefix>.config
+void writeConfigFile(void) {
+  char outConfigFile[FILENAME_MAXLEN];
+  FILE *outConfig;
+
+  strcpy(outConfigFile, ctx.filePrefix);
+  strcat(outConfigFile, ".config");
+  updateCharContext("outConfigFile", outConfigFile, CTX_CALCULATED);
+  outConfig = openFile(outConfigFile, "w");
+  printConfig(outConfig);
+  fclose(outConfig);
+}
+
 int main(int argc, char *argv[]) {
 
-  FILE *out, *outConfig;
+  FILE *out;
+  int printHeader;
   DebugLogFiles debugLogFiles;
 
+  SipnetModel *model;  // all state for this run
+
   ModelParams *modelParams;  // the parameters used in the model
   OutputItems *outputItems;  // structure to hold information for output to
                              // single-variable files (if doSingleOutputs is
                              // true)
 
   // char fileName[FILENAME_MAXLEN - 8];
-  char outFile[FILENAME_MAXLEN], outConfigFile[FILENAME_MAXLEN];
+  char outFile[FILENAME_MAXLEN];
   char paramFile[FILENAME_MAXLEN], climFile[FILENAME_MAXLEN];
   char eventsInFile[FILENAME_MAXLEN], eventsOutFile[FILENAME_MAXLEN];
 
@@ -164,11 +184,16 @@ int main(int argc, char *argv[]) {
   strcpy(paramFile, ctx.filePrefix);
   strcat(paramFile, ".param");
   updateCharContext("paramFile", paramFile, CTX_CALCULATED);
-  strcpy(climFile, ctx.filePrefix);
-  strcat(climFile, ".clim");
+  if (strlen(ctx.metFile) > 0) {
+    strcpy(climFile, ctx.metFile);
+  } else {
+    strcpy(climFile, ctx.filePrefix);
+    strcat(climFile, ".clim");
+  }
   updateCharContext("climFile", climFile, CTX_CALCULATED);
   if (ctx.events) {
-    const size_t maxEventsPrefixLen = FILENAME_MAXLEN - sizeof(".out");
+    const size_t maxEventsPrefixLen = FILENAME_MAXLEN - sizeof(".out") -
+                                      strlen(outputCompressionSuffix());
     if (strlen(ctx.eventsPrefix) > maxEventsPrefixLen) {
       logError("events-prefix value %s is too long; max length is %zu\n",
                ctx.eventsPrefix, maxEventsPrefixLen);
@@ -179,6 +204,7 @@ int main(int argc, char *argv[]) {
     strcpy(ctx.eventsInFile, eventsInFile);
     strcpy(eventsOutFile, ctx.eventsPrefix);
     strcat(eventsOutFile, ".out");
+    strcat(eventsOutFile, outputCompressionSuffix());
     strcpy(ctx.eventsOutFile, eventsOutFile);
   } else {
     eventsInFile[0] = '\0';
@@ -186,35 +212,68 @@ int main(int argc, char *argv[]) {
     ctx.eventsInFile[0] = '\0';
     ctx.eventsOutFile[0] = '\0';
   }
+
+  // Ensemble runs set up their own models and output files; of the files
+  // above, they use only the climate file and the events input file
+  if (strlen(ctx.ensembleFile) > 0) {
+    if (ctx.dumpConfig) {
+      writeConfigFile();
+    }
+    runEnsemble(ctx.ensembleFile, climFile, ctx.numThreads, ctx.numLanes);
+    freeContextMetadata();
+    return EXIT_CODE_SUCCESS;
+  }
+
+  // As do scenario runs, apart from the baseline, which writes the usual
+  // outputs
+  if (strlen(ctx.scenarioFile) > 0) {
+    size_t pos = 0;
+    int branchYear, branchDay;
+    // validateContext() has checked the date
+    nextRestartDate(ctx.scenarioDate, &pos, &branchYear, &branchDay);
+    if (ctx.dumpConfig) {
+      writeConfigFile();
+    }
+    runScenarios(ctx.scenarioFile, paramFile, climFile, branchYear, branchDay,
+                 ctx.numThreads);
+    freeContextMetadata();
+    return EXIT_CODE_SUCCESS;
+  }
+
+  // The main output is opened once the model is set up
+  out = NULL;
   if (ctx.doMainOutput) {
     strcpy(outFile, ctx.filePrefix);
-    strcat(outFile, ".out");
+    strcat(outFile, mainOutputSuffix());
     updateCharContext("outFile", outFile, CTX_CALCULATED);
-    out = openFile(outFile, "w");
-  } else {
-    out = NULL;
   }
   openDebugLogFiles(&debugLogFiles, ctx.debugLogPrefix);
 
   // Lastly - do after all other config processing
   if (ctx.dumpConfig) {
-    strcpy(outConfigFile, ctx.filePrefix);
-    strcat(outConfigFile, ".config");
-    updateCharContext("outConfigFile", outConfigFile, CTX_CALCULATED);
-    outConfig = openFile(outConfigFile, "w");
-    printConfig(outConfig);
-    fclose(outConfig);
-  } else {
-    outConfig = NULL;
+    writeConfigFile();
   }
 
   // 6. Initialize model, events, outputItems
-  initModel(&modelParams, paramFile, climFile);
+  model = newSipnetModel();
+  initModel(model, &modelParams, paramFile, climFile);
+  // A resumed run carries on with the outputs of the run it resumes, from its
+  // checkpoint; they already have their headers
+  if (ctx.autoResume) {
+    model->continueOutputs =
+        restartTruncateOutputs(ctx.doMainOutput ? outFile : NULL,
+                               ctx.events ? ctx.eventsOutFile : NULL);
+  }
+  printHeader = ctx.printHeader && !model->continueOutputs;
+  if (ctx.doMainOutput) {
+    out = openMainOutput(model, outFile);
+  }
 
   if (ctx.events) {
-    initEvents(ctx.eventsInFile, ctx.eventsOutFile, ctx.printHeader);
+    initEvents(model, ctx.eventsInFile, ctx.eventsOutFile, printHeader);
     // Check that first event is not before first climate record
-    if (isFirstEventBefore(firstClimate->year, firstClimate->day)) {
+    if (isFirstEventBefore(model, model->climateData->year[0],
+                           model->climateData->day[0])) {
       logError(
           "First event occurs before the start of the climate file; please "
           "fix and rerun\n");
@@ -224,25 +283,25 @@ int main(int argc, char *argv[]) {
 
   if (ctx.doSingleOutputs) {
     outputItems = newOutputItems(ctx.filePrefix, ' ');
-    setupOutputItems(outputItems);
+    setupOutputItems(model, outputItems);
   } else {
     outputItems = NULL;
   }
 
   // 7. Do the run!
-  runModelOutput(out, &debugLogFiles, outputItems, ctx.printHeader);
+  runModelOutput(model, out, &debugLogFiles, outputItems, printHeader);
 
   // 8. Cleanup
-  if (ctx.doMainOutput) {
-    if (out == NULL) {
-      logError("main output file handle missing during cleanup\n");
-      exit(EXIT_CODE_INTERNAL_ERROR);
-    }
+  // NetCDF output is closed with the rest of the main output, at the end of
+  // the run
+  if (out != NULL) {
     fclose(out);
   }
   closeDebugLogFiles(&debugLogFiles);
 
-  cleanupModel();
+  cleanupModel(model);
+  deleteSipnetModel(model);
+  freeContextMetadata();
   if (outputItems != NULL) {
     deleteOutputItems(outputItems);
   }
@@ -0,0 +1,74 @@
+// Advance several models in lockstep
+
+#include "lanes.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common/context.h"
+#include "common/exitCodes.h"
+#include "common/logging.h"
+
+#include "asyncOutput.h"
+#include "events.h"
+#include "sipnet.h"
+
+// See lanes.h
+void runModelLanes(SipnetModel **models, int numLanes, FILE **outs,
+                   OutputItems **outputItems, int printHeader) {
+  if (numLanes < 1 || numLanes > MAX_LANES) {
+    logInternalError("lane batch of %d models; must be 1 to %d\n", numLanes,
+                     MAX_LANES);
+    exit(EXIT_CODE_INTERNAL_ERROR);
+  }
+  for (int lane = 1; lane < numLanes; ++lane) {
+    if (models[lane]->climateData != models[0]->climateData) {
+      logInternalError("models in a lane batch must share climate data\n");
+      exit(EXIT_CODE_INTERNAL_ERROR);
+    }
+  }
+
+  for (int lane = 0; lane < numLanes; ++lane) {
+    startMainOutput(models[lane], (outs != NULL) ? outs[lane] : NULL,
+                    printHeader);
+    setupModel(models[lane]);
+    setupEvents(models[lane]);
+  }
+
+  if (ctx.asyncOutput) {
+    // One writer thread serves all the lanes
+    AsyncOutput *async = newAsyncOutput();
+    for (int lane = 0; lane < numLanes; ++lane) {
+      models[lane]->asyncOut = async;
+    }
+  }
+
+  // The models share the climate data, so all reach the end together
+  while (models[0]->climate != NULL) {
+    for (int lane = 0; lane < numLanes; ++lane) {
+      SipnetModel *model = models[lane];
+      updateState(model);
+      if (hasMainOutput(model, (outs != NULL) ? outs[lane] : NULL)) {
+        outputState(model, outs[lane], model->climate->year,
+                    model->climate->day, model->climate->time);
+      }
+      if ((outputItems != NULL) && (outputItems[lane] != NULL)) {
+        outputItemValues(model, outputItems[lane]);
+      }
+      setClimateStep(model, model->climateStep + 1);
+    }
+  }
+
+  if (models[0]->asyncOut != NULL) {
+    deleteAsyncOutput(models[0]->asyncOut);
+    for (int lane = 0; lane < numLanes; ++lane) {
+      models[lane]->asyncOut = NULL;
+    }
+  }
+  for (int lane = 0; lane < numLanes; ++lane) {
+    finishMainOutput(models[lane], (outs != NULL) ? outs[lane] : NULL);
+    if ((outputItems != NULL) && (outputItems[lane] != NULL)) {
+      finishOutputItems(outputItems[lane]);
+    }
+  }
+}
@@ -0,0 +1,43 @@
+// header file for advancing several models in lockstep
+//
+// A lane batch runs up to MAX_LANES models over the same climate data, one
+// time step at a time for all of them. The models differ only in their
+// parameters (and so in their state), as in an ensemble. Each model's step is
+// the same updateState() a single run uses, so there is one copy of the
+// model's physics; the batch shares one pass over the climate data and, with
+// --async-output, one writer thread.
+//
+// Each model's output is the same, to the last bit, as running it alone.
+
+#ifndef SIPNET_LANES_H
+#define SIPNET_LANES_H
+
+#include <stdio.h>
+
+#include "common/context.h"
+
+#include "model.h"
+#include "outputItems.h"
+
+// Most models in one lane batch
+#define MAX_LANES MAX_ENSEMBLE_LANES
+
+/*!
+ * Run several models over the same climate data in lockstep
+ *
+ * Like calling runModelOutput() for each model, with no debug logging and no
+ * restarts. Every model must run over the same climate data (see
+ * initModelWithClimate()), and have its events set up already, if any.
+ *
+ * @param models models to run, each set up with initModelWithClimate()
+ * @param numLanes number of models, at most MAX_LANES
+ * @param outs main output file for each model; NULL entries (or a NULL
+ *             array) suppress it
+ * @param outputItems single-variable outputs for each model; NULL entries (or
+ *                    a NULL array) suppress them
+ * @param printHeader Whether to print a header row in output files
+ */
+void runModelLanes(SipnetModel **models, int numLanes, FILE **outs,
+                   OutputItems **outputItems, int printHeader);
+
+#endif  // SIPNET_LANES_H
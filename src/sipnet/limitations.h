@@ -1,13 +1,16 @@
 #ifndef SIPNET_LIMITATIONS_H
 #define SIPNET_LIMITATIONS_H
 
+// Model instance holding all run state; defined in model.h
+typedef struct SipnetModel SipnetModel;
+
 /**
  * Check for complex limitations
  *
  * Check for complex situations:
  * - nitrogen limitation
  */
-void checkLimitations(void);
+void checkLimitations(SipnetModel *model);
 
 /**
  * Check for carbon and nitrogen limitations for leaf-on events
@@ -17,13 +20,13 @@ void checkLimitations(void);
  * @param[inout] leafOnFlux pointer to leaf-on flux variable, which may be
  *               modified if limitation is in effect
  */
-void checkLeafOnLimitation(double *leafOnFlux);
+void checkLeafOnLimitation(SipnetModel *model, double *leafOnFlux);
 
 /** Check for carbon-specific limitations
  *
  * Check carbon limits that should be dealt with before nitrogen fluxes are
  * calculated
  */
-void checkCarbonLimitations(void);
+void checkCarbonLimitations(SipnetModel *model);
 
 #endif  // SIPNET_LIMITATIONS_H
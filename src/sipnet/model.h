@@ -0,0 +1,116 @@
+// header file for the SipnetModel instance struct
+//
+// A SipnetModel holds everything that changes over the course of a single
+// model run: parameters, pools, fluxes, trackers, climate and event lists,
+// and the per-run bookkeeping used by events, debug logging and restarts.
+// Each run owns its own instance, so several runs can coexist in one process.
+//
+// The run configuration (ctx, see common/context.h) is not part of the
+// model; it is set up once from the command line and config file and is
+// treated as read-only while models are running.
+
+#ifndef SIPNET_MODEL_H
+#define SIPNET_MODEL_H
+
+#include <stdio.h>
+
+#include "asyncOutput.h"
+#include "balance.h"
+#include "binaryOutput.h"
+#include "netcdfOutput.h"
+#include "climate.h"
+#include "debug_log.h"
+#include "events.h"
+#include "forcing.h"
+#include "outputPeriod.h"
+#include "runmean.h"
+#include "state.h"
+
+struct SipnetModel {
+  // Parameters, current state and fluxes, see state.h
+  Params params;
+  Envi envi;
+  Fluxes fluxes;
+  Trackers trackers;
+  PhenologyTrackers phenologyTrackers;
+  PlantSurvivalTracker plantSurvivalTracker;
+  EventTrackers eventTrackers;
+  BalanceTracker balanceTracker;
+  // Parameters as they were before setupModel() converted them in place; a
+  // resumed run (see resumeModelOutput()) is set up from these again
+  Params unconvertedParams;
+
+  // Climate forcing for every time step, the index of the step currently
+  // being processed, and a copy of that step's values; climate points to
+  // currentClimate while a step is being processed, and is NULL once the
+  // last step is done
+  ClimateData *climateData;
+  long climateStep;
+  ClimateNode currentClimate;
+  ClimateNode *climate;
+  // When the climate is streamed (see climate.h), the stream, and the step
+  // index of the first step in climateData, which then holds only the current
+  // chunk; otherwise NULL and 0
+  ClimateStream *climateStream;
+  long climateChunkStart;
+  // Nonzero when the climate data belongs to the caller and may be shared
+  // with other models (see initModelWithClimate()); it is read-only here
+  int sharedClimate;
+  // Climate-derived terms for every step in climateData (see forcing.h); NULL
+  // until they are first calculated
+  ForcingData *forcing;
+
+  // Running mean of NPP, used for growth respiration and leaf allocation
+  MeanTracker *meanNPP;
+
+  // Linked list of events read from the event file, and the next event to be
+  // processed
+  EventNode *events;
+  EventNode *event;
+  FILE *eventOutFile;
+
+  // Field tables for debug logging; NULL when debug logging is off
+  DebugFieldArrays *debugFields;
+
+  // Columns of the main output file selected by output-vars, in file order;
+  // NULL for all of them. Set up by startMainOutput().
+  int *outputColumns;
+  int numOutputColumns;
+  // Aggregation of main output rows by period (see outputPeriod.h); NULL when
+  // every step is written. Set up by startMainOutput().
+  OutputPeriod *outputPeriod;
+  // Writer for the main output file when it is binary (see binaryOutput.h);
+  // NULL for text output
+  BinaryOutput *binaryOut;
+  // Writer for the main output file when it is NetCDF (see netcdfOutput.h);
+  // set up by openMainOutput()
+  NetcdfOutput *netcdfOut;
+  // Queue of output rows for the writer thread when output is asynchronous
+  // (see asyncOutput.h), shared by models run together in lanes; NULL when
+  // output is written directly
+  AsyncOutput *asyncOut;
+
+  // Restart bookkeeping; the step count carries over across restart segments
+  long long processedStepCount;
+  ClimateNode lastProcessedClimateStep;
+  int hasProcessedClimateStep;
+  // Periodic checkpoints (see restartPeriodicCheckpoint()): how many years or
+  // steps apart, 0 for none, and the steps and year ends since the last
+  long checkpointEvery;
+  int checkpointInYears;
+  long stepsSinceCheckpoint;
+  long yearsSinceCheckpoint;
+  // Whether the main and events outputs continue those of the run an
+  // --auto-resume run resumes (see restartTruncateOutputs()), so are appended
+  // to rather than started afresh
+  int continueOutputs;
+  // Dated restart-out checkpoints (see restartDatedCheckpoint()): whether one
+  // is still to come, its date, and where the date after it is in
+  // ctx.restartDates
+  int hasRestartDate;
+  int restartDateYear;
+  int restartDateDay;
+  size_t restartDatesPos;
+};
+
+#endif  // SIPNET_MODEL_H
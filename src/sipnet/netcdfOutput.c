@@ -0,0 +1,334 @@
+// NetCDF model output; see netcdfOutput.h
+
+#include "netcdfOutput.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/exitCodes.h"
+#include "common/logging.h"
+
+#ifdef SIPNET_NETCDF
+
+#include <netcdf.h>
+#include <pthread.h>
+
+// A column written as a PEcAn standard variable
+typedef struct StandardVar {
+  const char *column;  // SIPNET column name
+  const char *name;  // standard name
+  const char *units;  // standard units
+  double scale;  // multiplies the SIPNET value
+  int perRow;  // nonzero if the value is also divided by the row's length
+} StandardVar;
+
+#define G_TO_KG 0.001
+// Water depth in cm to mass in kg m-2
+#define CM_TO_KG_M2 10.0
+
+static const StandardVar standardVars[] = {
+    {"plantWoodC", "AbvGrndWood", "kg C m-2", G_TO_KG, 0},
+    {"plantLeafC", "leaf_carbon_content", "kg C m-2", G_TO_KG, 0},
+    {"soil", "TotSoilCarb", "kg C m-2", G_TO_KG, 0},
+    {"coarseRootC", "coarse_root_carbon_content", "kg C m-2", G_TO_KG, 0},
+    {"fineRootC", "fine_root_carbon_content", "kg C m-2", G_TO_KG, 0},
+    {"litter", "litter_carbon_content", "kg C m-2", G_TO_KG, 0},
+    {"soilWater", "SoilMoist", "kg m-2", CM_TO_KG_M2, 0},
+    {"soilWetnessFrac", "SoilMoistFrac", "1", 1, 0},
+    {"snow", "SWE", "kg m-2", CM_TO_KG_M2, 0},
+    {"npp", "NPP", "kg C m-2 s-1", G_TO_KG, 1},
+    {"nee", "NEE", "kg C m-2 s-1", G_TO_KG, 1},
+    {"gpp", "GPP", "kg C m-2 s-1", G_TO_KG, 1},
+    {"ra", "AutoResp", "kg C m-2 s-1", G_TO_KG, 1},
+    {"rh", "HeteroResp", "kg C m-2 s-1", G_TO_KG, 1},
+    {"rtot", "TotalResp", "kg C m-2 s-1", G_TO_KG, 1},
+    {"evapotranspiration", "Evap", "kg m-2 s-1", CM_TO_KG_M2, 1},
+    {"fluxestranspiration", "Transp", "kg m-2 s-1",
+     CM_TO_KG_M2 / NETCDF_SECONDS_PER_DAY, 0}};
+
+// Columns before the variables in each row: year, day and time
+#define NUM_TIME_COLUMNS 3
+
+struct NetcdfOutput {
+  char *path;
+  int ncid;
+  int timeVar;
+  int numColumns;
+  // Per column: variable id (-1 for year, day and time), and conversion
+  int *varIds;
+  double *scales;
+  int *perRow;
+
+  // Start of the year of the last row, in days since the start of baseYear
+  int baseYear;
+  int lastYear;
+  double lastYearStart;
+
+  // Buffered rows: their times, and one buffer per column
+  double *times;
+  float **buffers;
+  int numRows;
+  size_t numWritten;  // rows already in the file
+};
+
+// The NetCDF library is not thread-safe, and ensemble members write their
+// files from several threads
+static pthread_mutex_t netcdfLock = PTHREAD_MUTEX_INITIALIZER;
+
+static void checkNetcdf(const NetcdfOutput *output, int status,
+                        const char *what) {
+  if (status != NC_NOERR) {
+    logError("NetCDF output %s: error %s: %s\n", output->path, what,
+             nc_strerror(status));
+    exit(EXIT_CODE_FAILURE);
+  }
+}
+
+static void *allocOrExit(size_t size) {
+  void *ptr = malloc(size);
+
+  if (ptr == NULL) {
+    logError("memory allocation failure for NetCDF output\n");
+    exit(EXIT_CODE_INTERNAL_ERROR);
+  }
+  return ptr;
+}
+
+static int isLeapYear(int year) {
+  return ((year % 4 == 0) && (year % 100 != 0)) || (year % 400 == 0);
+}
+
+// Days from the start of output->baseYear to the start of year
+static double yearStart(NetcdfOutput *output, int year) {
+  while (output->lastYear < year) {
+    output->lastYearStart += 365 + isLeapYear(output->lastYear);
+    ++output->lastYear;
+  }
+  while (output->lastYear > year) {
+    --output->lastYear;
+    output->lastYearStart -= 365 + isLeapYear(output->lastYear);
+  }
+  return output->lastYearStart;
+}
+
+static const StandardVar *findStandardVar(const char *column) {
+  for (size_t ind = 0; ind < sizeof(standardVars) / sizeof(standardVars[0]);
+       ++ind) {
+    if (strcmp(standardVars[ind].column, column) == 0) {
+      return &standardVars[ind];
+    }
+  }
+  return NULL;
+}
+
+static void putText(NetcdfOutput *output, int varid, const char *name,
+                    const char *value) {
+  checkNetcdf(output, nc_put_att_text(output->ncid, varid, name, strlen(value),
+                                      value),
+              "writing attributes");
+}
+
+// Write the buffered rows
+static void flushRows(NetcdfOutput *output) {
+  size_t start = output->numWritten;
+  size_t count = (size_t)output->numRows;
+
+  if (count == 0) {
+    return;
+  }
+  pthread_mutex_lock(&netcdfLock);
+  checkNetcdf(output,
+              nc_put_vara_double(output->ncid, output->timeVar, &start, &count,
+                                 output->times),
+              "writing time");
+  for (int col = NUM_TIME_COLUMNS; col < output->numColumns; ++col) {
+    checkNetcdf(output,
+                nc_put_vara_float(output->ncid, output->varIds[col], &start,
+                                  &count, output->buffers[col]),
+                "writing values");
+  }
+  pthread_mutex_unlock(&netcdfLock);
+  output->numWritten += count;
+  output->numRows = 0;
+}
+
+// See netcdfOutput.h
+int hasNetcdfOutput(void) { return 1; }
+
+// See netcdfOutput.h
+NetcdfOutput *newNetcdfOutput(const char *path) {
+  NetcdfOutput *output = (NetcdfOutput *)allocOrExit(sizeof(NetcdfOutput));
+  int status;
+
+  output->path = (char *)allocOrExit(strlen(path) + 1);
+  strcpy(output->path, path);
+  output->numColumns = 0;
+  output->varIds = NULL;
+  output->scales = NULL;
+  output->perRow = NULL;
+  output->times = NULL;
+  output->buffers = NULL;
+  output->numRows = 0;
+  output->numWritten = 0;
+
+  pthread_mutex_lock(&netcdfLock);
+  status = nc_create(path, NC_CLOBBER | NC_NETCDF4, &output->ncid);
+  pthread_mutex_unlock(&netcdfLock);
+  if (status != NC_NOERR) {
+    logError("Error writing '%s': %s\n", path, nc_strerror(status));
+    exit(EXIT_CODE_FILE_OPEN_OR_READ_ERROR);
+  }
+  return output;
+}
+
+// See netcdfOutput.h
+void startNetcdfOutput(NetcdfOutput *output, const NetcdfColumn *columns,
+                       int numColumns, int baseYear, int deflateLevel) {
+  char timeUnits[64];
+  size_t chunk = NETCDF_OUTPUT_CHUNK_ROWS;
+  int timeDim;
+
+  output->numColumns = numColumns;
+  output->varIds = (int *)allocOrExit(numColumns * sizeof(int));
+  output->scales = (double *)allocOrExit(numColumns * sizeof(double));
+  output->perRow = (int *)allocOrExit(numColumns * sizeof(int));
+  output->times =
+      (double *)allocOrExit(NETCDF_OUTPUT_CHUNK_ROWS * sizeof(double));
+  output->buffers = (float **)allocOrExit(numColumns * sizeof(float *));
+  output->baseYear = baseYear;
+  output->lastYear = baseYear;
+  output->lastYearStart = 0;
+  snprintf(timeUnits, sizeof(timeUnits), "days since %04d-01-01 00:00:00",
+           baseYear);
+
+  pthread_mutex_lock(&netcdfLock);
+  checkNetcdf(output, nc_def_dim(output->ncid, "time", NC_UNLIMITED, &timeDim),
+              "defining time");
+  checkNetcdf(output,
+              nc_def_var(output->ncid, "time", NC_DOUBLE, 1, &timeDim,
+                         &output->timeVar),
+              "defining time");
+  checkNetcdf(output,
+              nc_def_var_chunking(output->ncid, output->timeVar, NC_CHUNKED,
+                                  &chunk),
+              "defining time");
+  putText(output, output->timeVar, "standard_name", "time");
+  putText(output, output->timeVar, "long_name", "time");
+  putText(output, output->timeVar, "units", timeUnits);
+  putText(output, output->timeVar, "calendar", "standard");
+  putText(output, NC_GLOBAL, "Conventions", "CF-1.8");
+  putText(output, NC_GLOBAL, "source", "SIPNET");
+
+  for (int col = 0; col < numColumns; ++col) {
+    const StandardVar *standard = findStandardVar(columns[col].name);
+    const char *name = (standard != NULL) ? standard->name : columns[col].name;
+    const char *units =
+        (standard != NULL) ? standard->units : columns[col].units;
+    int varid;
+
+    output->buffers[col] = NULL;
+    output->varIds[col] = -1;
+    if (col < NUM_TIME_COLUMNS) {
+      continue;
+    }
+    output->scales[col] = (standard != NULL) ? standard->scale : 1;
+    output->perRow[col] = (standard != NULL) && standard->perRow;
+    output->buffers[col] =
+        (float *)allocOrExit(NETCDF_OUTPUT_CHUNK_ROWS * sizeof(float));
+
+    checkNetcdf(output,
+                nc_def_var(output->ncid, name, NC_FLOAT, 1, &timeDim, &varid),
+                "defining variables");
+    checkNetcdf(output,
+                nc_def_var_chunking(output->ncid, varid, NC_CHUNKED, &chunk),
+                "defining variables");
+    if (deflateLevel > 0) {
+      checkNetcdf(output,
+                  nc_def_var_deflate(output->ncid, varid, 1, 1, deflateLevel),
+                  "defining variables");
+    }
+    putText(output, varid, "units", units);
+    putText(output, varid, "long_name", columns[col].name);
+    output->varIds[col] = varid;
+  }
+  checkNetcdf(output, nc_enddef(output->ncid), "defining variables");
+  pthread_mutex_unlock(&netcdfLock);
+}
+
+// See netcdfOutput.h
+void writeNetcdfOutputRow(NetcdfOutput *output, const double *values,
+                          double length) {
+  int row = output->numRows;
+  double seconds = length * NETCDF_SECONDS_PER_DAY;
+
+  output->times[row] = yearStart(output, (int)values[0]) + (values[1] - 1) +
+                       values[2] / 24.0;
+  for (int col = NUM_TIME_COLUMNS; col < output->numColumns; ++col) {
+    double value = values[col] * output->scales[col];
+    if (output->perRow[col]) {
+      value /= seconds;
+    }
+    output->buffers[col][row] = (float)value;
+  }
+  if (++output->numRows == NETCDF_OUTPUT_CHUNK_ROWS) {
+    flushRows(output);
+  }
+}
+
+// See netcdfOutput.h
+void closeNetcdfOutput(NetcdfOutput *output) {
+  if (output->buffers != NULL) {
+    flushRows(output);
+  }
+  pthread_mutex_lock(&netcdfLock);
+  checkNetcdf(output, nc_close(output->ncid), "closing the file");
+  pthread_mutex_unlock(&netcdfLock);
+
+  if (output->buffers != NULL) {
+    for (int col = 0; col < output->numColumns; ++col) {
+      free(output->buffers[col]);
+    }
+  }
+  free(output->buffers);
+  free(output->times);
+  free(output->perRow);
+  free(output->scales);
+  free(output->varIds);
+  free(output->path);
+  free(output);
+}
+
+#else  // SIPNET_NETCDF
+
+static void noNetcdf(void) {
+  logError("this build of SIPNET has no NetCDF output; rebuild with "
+           "make NETCDF=1\n");
+  exit(EXIT_CODE_BAD_PARAMETER_VALUE);
+}
+
+// See netcdfOutput.h
+int hasNetcdfOutput(void) { return 0; }
+
+// See netcdfOutput.h
+NetcdfOutput *newNetcdfOutput(const char *path) {
+  noNetcdf();
+  return NULL;
+}
+
+// See netcdfOutput.h
+void startNetcdfOutput(NetcdfOutput *output, const NetcdfColumn *columns,
+                       int numColumns, int baseYear, int deflateLevel) {
+  noNetcdf();
+}
+
+// See netcdfOutput.h
+void writeNetcdfOutputRow(NetcdfOutput *output, const double *values,
+                          double length) {
+  noNetcdf();
+}
+
+// See netcdfOutput.h
+void closeNetcdfOutput(NetcdfOutput *output) { noNetcdf(); }
+
+#endif  // SIPNET_NETCDF
@@ -0,0 +1,76 @@
+// header file for netcdfOutput.c: NetCDF model output
+//
+// With --output-format netcdf, the main output is written as a NetCDF-4 file,
+// <file-prefix>.nc, in place of <file-prefix>.out. The file has one unlimited
+// dimension, time, with a CF time coordinate in days since the start of the
+// first year of the climate record, built from each row's year, day and
+// time. Each other column of the main output is a float variable along time.
+// Columns that have a PEcAn standard variable are written under its name and
+// in its units: pools in kg m-2, and amounts over the step converted to rates
+// in kg m-2 s-1 by the length of the row. The rest keep their SIPNET names and
+// units.
+//
+// Rows are buffered and written NETCDF_OUTPUT_CHUNK_ROWS at a time, matching
+// the variables' chunks, which can be deflate-compressed.
+//
+// NetCDF support is optional, as it needs the system libnetcdf: it is built
+// only when SIPNET_NETCDF is defined (make NETCDF=1). Without it, these
+// functions exit with an error.
+
+#ifndef NETCDF_OUTPUT_H
+#define NETCDF_OUTPUT_H
+
+// Rows in each chunk of a variable, and buffered before they are written
+#define NETCDF_OUTPUT_CHUNK_ROWS 1024
+
+// Seconds per day, for converting amounts over a row to rates
+#define NETCDF_SECONDS_PER_DAY 86400.0
+
+typedef struct NetcdfColumn {
+  const char *name;  // SIPNET column name
+  const char *units;  // SIPNET units
+} NetcdfColumn;
+
+typedef struct NetcdfOutput NetcdfOutput;
+
+/*!
+ * Nonzero if this build can write NetCDF files
+ */
+int hasNetcdfOutput(void);
+
+/*!
+ * Create a NetCDF output file, replacing any file at path
+ *
+ * @param path file to create
+ * @return new NetcdfOutput; exits if the file can't be created
+ */
+NetcdfOutput *newNetcdfOutput(const char *path);
+
+/*!
+ * Define the variables of a NetcdfOutput
+ *
+ * @param output NetcdfOutput from newNetcdfOutput()
+ * @param columns the columns of each row; the first three must be year, day
+ *                and time, which make up the time coordinate
+ * @param numColumns number of columns
+ * @param baseYear year the time coordinate counts days from
+ * @param deflateLevel deflate compression level, 0 (none) to 9
+ */
+void startNetcdfOutput(NetcdfOutput *output, const NetcdfColumn *columns,
+                       int numColumns, int baseYear, int deflateLevel);
+
+/*!
+ * Add a row, writing the buffered rows once there is a chunk of them
+ *
+ * @param values one value for each column, in column order
+ * @param length length of the row, in days
+ */
+void writeNetcdfOutputRow(NetcdfOutput *output, const double *values,
+                          double length);
+
+/*!
+ * Write any buffered rows, close the file, and free the NetcdfOutput
+ */
+void closeNetcdfOutput(NetcdfOutput *output);
+
+#endif  // NETCDF_OUTPUT_H
@@ -1,6 +1,9 @@
 #ifndef NITROGEN_H
 #define NITROGEN_H
 
+// Model instance holding all run state; defined in model.h
+typedef struct SipnetModel SipnetModel;
+
 // Nitrogen cycle related functions
 
 /*!
@@ -9,14 +12,14 @@
  * Note: leafOnC can be either a flux or pool measurement; the returned
  * value will match.
  */
-double calcLeafOnNFromC(double leafOnC);
+double calcLeafOnNFromC(SipnetModel *model, double leafOnC);
 
 /*!
  * Calculate plant N demand flux from biomass creation fluxes
  *
  * @return Total nitrogen demand flux from plant growth
  */
-double calcPlantNDemandFlux(void);
+double calcPlantNDemandFlux(SipnetModel *model);
 
 /*!
  * Calculate nitrogen available for plant growth
@@ -29,7 +32,7 @@ double calcPlantNDemandFlux(void);
  *
  * @return Available N for plant growth
  */
-double calcPlantAvailableN(void);
+double calcPlantAvailableN(SipnetModel *model);
 
 /**
  * Calculate all fluxes for soil mineral N EXCEPT uptake
@@ -38,42 +41,42 @@ double calcPlantAvailableN(void);
  *
  * @return Sum of non-uptake fluxes for soil mineral N
  */
-double calcMinNNonUptakeFluxes(void);
+double calcMinNNonUptakeFluxes(SipnetModel *model);
 
 /**
  * Calculate how much of the plant storage N pool is not claimed by leaf-on
  */
-double calcUnclaimedStorageN(void);
+double calcUnclaimedStorageN(SipnetModel *model);
 
 /**
  * Calculate the N fixation fraction taking inhibition into account
  *
  * @return N fixation fraction used to compute amount of N fixation
  */
-double calcNFixationFrac(void);
+double calcNFixationFrac(SipnetModel *model);
 
 /*!
  * Calculate plant N fixation and uptake fluxes.
  */
-void calcNFixationAndUptakeFluxes(void);
+void calcNFixationAndUptakeFluxes(SipnetModel *model);
 
 /*!
  * Calculate all nitrogen fluxes
  *
  * This is the general flux calculation wrapper for sipnet.c
  */
-void calcNitrogenFluxes(void);
+void calcNitrogenFluxes(SipnetModel *model);
 
 /*!
  * Update all pools from nitrogen fluxes
  *
  * This is the general pool update wrapper for sipnet.c
  */
-void updateNitrogenPools(void);
+void updateNitrogenPools(SipnetModel *model);
 
 /**
  * In the public API for testing
  */
-void calcNResorptionFluxes(void);
+void calcNResorptionFluxes(SipnetModel *model);
 
 #endif  // NITROGEN_H
@@ -1,4 +1,4 @@
-/* outputItems: structures and functions to output single variables to files
+/* outputItems: structures and functions to output single variables to a file
 
    Author: Bill Sacks
    Creation date: 6/4/07
@@ -8,56 +8,77 @@
 #include <string.h>
 #include <stdlib.h>
 #include "outputItems.h"
+#include "common/context.h"
 #include "common/util.h"
 #include "common/logging.h"
 #include "common/exitCodes.h"
+#include "common/numFormat.h"
+
+// Decimals written for each item in text output, as printf's "%f"
+#define OUTPUT_ITEMS_DECIMALS 6
 
 // Private/helper functions: not defined in outputItems.h:
 
-/* Allocate space for a new singleOutputItem structure, return a pointer to it
-   Name and ptr will have the given values; f and nextItem will be NULL
-*/
-SingleOutputItem *newSingleOutputItem(char *name, double *ptr) {
-  SingleOutputItem *singleOutputItem;
+static void *allocOrExit(size_t size) {
+  void *ptr = malloc(size);
 
-  if (strlen(name) >= OUTPUT_ITEMS_MAXNAME) {
-    logError("newSingleOutputItem: name '%s' exceeds maximum length of %d\n",
-             name, OUTPUT_ITEMS_MAXNAME);
+  if (ptr == NULL) {
+    logError("memory allocation failure for single-variable outputs\n");
     exit(EXIT_CODE_INTERNAL_ERROR);
   }
-
-  singleOutputItem = (SingleOutputItem *)malloc(sizeof(SingleOutputItem));
-
-  strcpy(singleOutputItem->name, name);
-  singleOutputItem->ptr = ptr;
-  singleOutputItem->f = NULL;
-  singleOutputItem->nextItem = NULL;
-
-  return singleOutputItem;
+  return ptr;
 }
 
-/* Open the file associated with this output file
-    - This file will be named <filenameBase>.<name>
- */
-void openOutputItemFile(SingleOutputItem *singleOutputItem,
-                        char *filenameBase) {
-  char *filename;
+// Name and units of the label column ind
+static const char *labelName(int ind) {
+  static const char *names[OUTPUT_ITEMS_LABELS] = {"year", "day", "time"};
+  return names[ind];
+}
 
-  filename = (char *)malloc(
-      (strlen(filenameBase) + strlen(singleOutputItem->name) + 2) *
-      sizeof(char));
-  strcpy(filename, filenameBase);
-  strcat(filename, ".");
-  strcat(filename, singleOutputItem->name);
-  singleOutputItem->f = openFile(filename, "w");
+static const char *labelUnits(int ind) {
+  static const char *units[OUTPUT_ITEMS_LABELS] = {"year", "day of year",
+                                                     "hour"};
+  return units[ind];
+}
 
-  free(filename);
+// Write the names of the columns, separated by the separator
+static void writeTextHeader(OutputItems *outputItems) {
+  for (int ind = 0; ind < OUTPUT_ITEMS_LABELS + outputItems->count; ++ind) {
+    if (ind > 0) {
+      fputc(outputItems->separator, outputItems->f);
+    }
+    fputs((ind < OUTPUT_ITEMS_LABELS)
+              ? labelName(ind)
+              : outputItems->items[ind - OUTPUT_ITEMS_LABELS].name,
+          outputItems->f);
+  }
+  fputc('\n', outputItems->f);
 }
 
-// close the file associated with this output item
-void closeOutputItemFile(SingleOutputItem *singleOutputItem) {
-  fclose(singleOutputItem->f);
-  singleOutputItem->f = NULL;
+// Start binary output, describing each column
+static void startBinary(OutputItems *outputItems, const char *format) {
+  int numColumns = OUTPUT_ITEMS_LABELS + outputItems->count;
+  BinaryColumn *columns =
+      (BinaryColumn *)allocOrExit(numColumns * sizeof(BinaryColumn));
+  BinaryColumnType floatType = (strcmp(format, OUTPUT_FORMAT_BINARY32) == 0)
+                                   ? BINARY_FLOAT32
+                                   : BINARY_FLOAT64;
+
+  for (int ind = 0; ind < numColumns; ++ind) {
+    if (ind < OUTPUT_ITEMS_LABELS) {
+      columns[ind].name = labelName(ind);
+      columns[ind].units = labelUnits(ind);
+      columns[ind].type = (ind < 2) ? BINARY_INT32 : floatType;
+    } else {
+      const SingleOutputItem *item =
+          &outputItems->items[ind - OUTPUT_ITEMS_LABELS];
+      columns[ind].name = item->name;
+      columns[ind].units = item->units;
+      columns[ind].type = (item->type == VAR_INT) ? BINARY_INT32 : floatType;
+    }
+  }
+  outputItems->binaryOut = newBinaryOutput(outputItems->f, columns, numColumns);
+  free(columns);
 }
 
 /*************************************************/
@@ -65,105 +86,182 @@ void closeOutputItemFile(SingleOutputItem *singleOutputItem) {
 // Public functions: defined in outputItems.h
 
 /* Allocate space for a new outputItems structure, return a pointer to it
-   filenameBase is the base name of the files to which we'll output
-    - we'll output to <filenameBase>.<name> for each output item
-   separator is the character separating values in the output files (e.g. space,
+   filenameBase is the base name of the file to which we'll output
+    - we'll output to <filenameBase>.single
+   separator is the character separating values in text output (e.g. space,
    tab, or comma)
  */
-OutputItems *newOutputItems(char *filenameBase, char separator) {
+OutputItems *newOutputItems(const char *filenameBase, char separator) {
   OutputItems *outputItems;
 
-  outputItems = (OutputItems *)malloc(sizeof(OutputItems));
+  outputItems = (OutputItems *)allocOrExit(sizeof(OutputItems));
 
-  outputItems->head = newSingleOutputItem("", NULL);  // we'll keep a dummy item
-                                                      // at the head of the list
-  outputItems->tail = outputItems->head;
+  outputItems->items = NULL;
   outputItems->count = 0;
+  outputItems->capacity = 0;
 
   outputItems->filenameBase =
-      (char *)malloc((strlen(filenameBase) + 1) * sizeof(char));
+      (char *)allocOrExit((strlen(filenameBase) + 1) * sizeof(char));
   strcpy(outputItems->filenameBase, filenameBase);
 
   outputItems->separator = separator;
+  outputItems->f = NULL;
+  outputItems->binaryOut = NULL;
+  outputItems->line = NULL;
 
   return outputItems;
 }
 
 /* Add a new singleOutputItem to the end of the list given by outputItems
    strlen(name) must be < OUTPUT_ITEMS_MAXNAME
-   ptr must be a pointer to the variable holding this item (double)
+   ptr must be a pointer to the variable holding this item, of the given type
 
-   After calling this function, the file associated with this output item will
-   be open for writing
+   Items must all be added before openOutputItems() is called
  */
-void addOutputItem(OutputItems *outputItems, char *name, double *ptr) {
-  SingleOutputItem *singleOutputItem;
+void addOutputItem(OutputItems *outputItems, const char *name,
+                   const char *units, const void *ptr, VarType type) {
+  SingleOutputItem *item;
 
-  singleOutputItem = newSingleOutputItem(name, ptr);
-  openOutputItemFile(singleOutputItem, outputItems->filenameBase);
+  if (strlen(name) >= OUTPUT_ITEMS_MAXNAME) {
+    logError("addOutputItem: name '%s' exceeds maximum length of %d\n", name,
+             OUTPUT_ITEMS_MAXNAME);
+    exit(EXIT_CODE_INTERNAL_ERROR);
+  }
+  if (outputItems->f != NULL) {
+    logInternalError("addOutputItem: %s added after the output was opened\n",
+                     name);
+    exit(EXIT_CODE_INTERNAL_ERROR);
+  }
 
-  outputItems->tail->nextItem = singleOutputItem;
-  outputItems->tail = singleOutputItem;
-  outputItems->count++;
+  if (outputItems->count == outputItems->capacity) {
+    int capacity = (outputItems->capacity == 0) ? 8 : 2 * outputItems->capacity;
+    SingleOutputItem *items = (SingleOutputItem *)realloc(
+        outputItems->items, capacity * sizeof(SingleOutputItem));
+    if (items == NULL) {
+      logError("memory allocation failure for single-variable outputs\n");
+      exit(EXIT_CODE_INTERNAL_ERROR);
+    }
+    outputItems->items = items;
+    outputItems->capacity = capacity;
+  }
+
+  item = &outputItems->items[outputItems->count++];
+  strcpy(item->name, name);
+  item->units = units;
+  item->ptr = ptr;
+  item->type = type;
 }
 
-/* For each output item, write a label, followed by a separator
-   This is intended for writing a single label at the start of each line
-   - For example, could write the location for spatial output, or the value of
-   some variable for a sensitivity test
+/* Open the output file, and write its header
+   format is one of the OUTPUT_FORMAT_* values (see common/context.h); text
+   output has a header row only if printHeader is set, binary output always
+   describes its columns
  */
-void writeOutputItemLabels(OutputItems *outputItems, char *label) {
-  SingleOutputItem *singleOutputItem;
+void openOutputItems(OutputItems *outputItems, const char *format,
+                     int printHeader) {
+  int isText = (strcmp(format, OUTPUT_FORMAT_TEXT) == 0);
+  char *filename = (char *)allocOrExit(
+      (strlen(outputItems->filenameBase) + strlen(OUTPUT_ITEMS_SUFFIX) + 2) *
+      sizeof(char));
+
+  strcpy(filename, outputItems->filenameBase);
+  strcat(filename, ".");
+  strcat(filename, OUTPUT_ITEMS_SUFFIX);
+  outputItems->f = openFile(filename, isText ? "w" : "wb");
+  free(filename);
 
-  singleOutputItem = outputItems->head->nextItem;
-  while (singleOutputItem != NULL) {
-    fprintf(singleOutputItem->f, "%s%c", label, outputItems->separator);
-    singleOutputItem = singleOutputItem->nextItem;
+  if (isText) {
+    outputItems->line = (char *)allocOrExit(
+        (OUTPUT_ITEMS_LABELS + outputItems->count) * (FORMAT_MAX_LEN + 1) + 1);
+    if (printHeader) {
+      writeTextHeader(outputItems);
+    }
+  } else {
+    startBinary(outputItems, format);
   }
 }
 
-// For each output item, write its current value, followed by a separator
-void writeOutputItemValues(OutputItems *outputItems) {
-  SingleOutputItem *singleOutputItem;
+// Write a row of the current values of the output items
+void writeOutputItemValues(OutputItems *outputItems, int year, int day,
+                           double time) {
+  // Items are few enough for a row to fit on the stack
+  double values[OUTPUT_ITEMS_LABELS + outputItems->count];
 
-  singleOutputItem = outputItems->head->nextItem;
-  while (singleOutputItem != NULL) {
-    fprintf(singleOutputItem->f, "%f%c", *(singleOutputItem->ptr),
-            outputItems->separator);
-    singleOutputItem = singleOutputItem->nextItem;
+  getOutputItemValues(outputItems, year, day, time, values);
+  writeOutputItemRow(outputItems, NULL, values,
+                     OUTPUT_ITEMS_LABELS + outputItems->count);
+}
+
+/* Copy year, day, time and the current value of each output item to values,
+   which must have room for OUTPUT_ITEMS_LABELS + outputItems->count values
+ */
+void getOutputItemValues(OutputItems *outputItems, int year, int day,
+                         double time, double *values) {
+  values[0] = year;
+  values[1] = day;
+  values[2] = time;
+  for (int ind = 0; ind < outputItems->count; ++ind) {
+    const SingleOutputItem *item = &outputItems->items[ind];
+    values[OUTPUT_ITEMS_LABELS + ind] = (item->type == VAR_INT)
+                                            ? *(const int *)item->ptr
+                                            : *(const double *)item->ptr;
   }
 }
 
-/* For each output item, write a newline
-   This is intended to be called at the end of each run
+/* Write a row from values (as filled in by getOutputItemValues())
  */
-void terminateOutputItemLines(OutputItems *outputItems) {
-  SingleOutputItem *singleOutputItem;
+void writeOutputItemRow(void *target, const void *layout, const double *values,
+                        int numValues) {
+  OutputItems *outputItems = (OutputItems *)target;
+  char *pos = outputItems->line;
+
+  if (outputItems->binaryOut != NULL) {
+    writeBinaryOutputRow(outputItems->binaryOut, values);
+    return;
+  }
 
-  singleOutputItem = outputItems->head->nextItem;
-  while (singleOutputItem != NULL) {
-    fprintf(singleOutputItem->f, "\n");
-    singleOutputItem = singleOutputItem->nextItem;
+  for (int ind = 0; ind < numValues; ++ind) {
+    if (ind > 0) {
+      *pos++ = outputItems->separator;
+    }
+    if ((ind < 2) ||
+        ((ind >= OUTPUT_ITEMS_LABELS) &&
+         (outputItems->items[ind - OUTPUT_ITEMS_LABELS].type == VAR_INT))) {
+      pos = formatInt(pos, (int)values[ind], 0);
+    } else if (ind == 2) {
+      pos = formatFixed(pos, values[ind], 0, 2);
+    } else {
+      pos = formatFixed(pos, values[ind], 0, OUTPUT_ITEMS_DECIMALS);
+    }
+  }
+  *pos++ = '\n';
+  fwrite(outputItems->line, 1, pos - outputItems->line, outputItems->f);
+}
+
+/* Write any buffered rows
+   This is intended to be called at the end of each run
+ */
+void finishOutputItems(OutputItems *outputItems) {
+  if (outputItems->binaryOut != NULL) {
+    closeBinaryOutput(outputItems->binaryOut);
+    outputItems->binaryOut = NULL;
+  }
+  if (outputItems->f != NULL) {
+    fflush(outputItems->f);
   }
 }
 
 /* Free up space used by outputItems
-   Also, close all files associated with the individual output items
+   Also, close the output file
  */
 void deleteOutputItems(OutputItems *outputItems) {
-  SingleOutputItem *curr, *temp;
-
-  curr = outputItems->head;
-  while (curr != NULL) {
-    temp = curr;
-    curr = curr->nextItem;
-
-    if (temp->f != NULL) {
-      closeOutputItemFile(temp);
-      free(temp);
-    }
+  finishOutputItems(outputItems);
+  if (outputItems->f != NULL) {
+    fclose(outputItems->f);
   }
 
+  free(outputItems->items);
+  free(outputItems->line);
   free(outputItems->filenameBase);
   free(outputItems);
 }
@@ -1,70 +1,101 @@
 // header file for outputItems.c
+//
+// The single-variable outputs (--do-single-outputs) are written together to
+// one file, <filenameBase>.single, one row per time step and one column per
+// item, after the year, day and time of the step. As with the main output,
+// the file is text, or columnar binary (see binaryOutput.h) for the binary
+// output formats.
 
 #ifndef OUTPUT_ITEMS_H
 #define OUTPUT_ITEMS_H
 
 #include <stdio.h>
 
+#include "binaryOutput.h"
+#include "varRegistry.h"
+
 #define OUTPUT_ITEMS_MAXNAME                                                   \
   64  // maximum length of output item name, including the trailing '\0'
 
-// structure to hold an output item, and a pointer to the next (for a linked
-// list)
-typedef struct SingleOutputItemStruct {
-  char name[OUTPUT_ITEMS_MAXNAME];  // name of output item
-  double *ptr;  // pointer to the variable holding this item
-  FILE *f;  // output file for this output item
+// Suffix of the output file
+#define OUTPUT_ITEMS_SUFFIX "single"
+
+// Columns before the items in each row: year, day and time
+#define OUTPUT_ITEMS_LABELS 3
 
-  struct SingleOutputItemStruct *nextItem;
+// structure to hold an output item
+typedef struct SingleOutputItemStruct {
+  char name[OUTPUT_ITEMS_MAXNAME];  // name of output item, its column header
+  const char *units;
+  const void *ptr;  // pointer to the variable holding this item
+  VarType type;  // type of the variable ptr points to
 } SingleOutputItem;
 
-// structure to hold a bunch of SingleOutputItems
-// implemented as a linked list
+// structure to hold a bunch of SingleOutputItems, and the file they are
+// written to
 typedef struct OutputItemsStruct {
-  SingleOutputItem *head;
-  SingleOutputItem *tail;
+  SingleOutputItem *items;
+  int count;  // number of items
+  int capacity;  // number of items there is room for
 
-  int count;  // number of items in the list, not counting the dummy item at the
-              // head
   char *filenameBase;
-  char separator;  // character separating values in the output files (e.g.
-                   // space, tab, or comma)
+  char separator;  // character separating values in text output (e.g. space,
+                   // tab, or comma)
+
+  FILE *f;  // output file, once opened
+  BinaryOutput *binaryOut;  // binary writer, for binary output formats
+  char *line;  // text row buffer
 } OutputItems;
 
 /* Allocate space for a new outputItems structure, return a pointer to it
-   filenameBase is the base name of the files to which we'll output
-    - we'll output to <filenameBase>.<name> for each output item
-   separator is the character separating values in the output files (e.g. space,
+   filenameBase is the base name of the file to which we'll output
+    - we'll output to <filenameBase>.single
+   separator is the character separating values in text output (e.g. space,
    tab, or comma)
  */
-OutputItems *newOutputItems(char *filenameBase, char separator);
+OutputItems *newOutputItems(const char *filenameBase, char separator);
 
 /* Add a new singleOutputItem to the end of the list given by outputItems
    strlen(name) must be < OUTPUT_ITEMS_MAXNAME
-   ptr must be a pointer to the variable holding this item (double)
+   ptr must be a pointer to the variable holding this item, of the given type
 
-   After calling this function, the file associated with this output item will
-   be open for writing
+   Items must all be added before openOutputItems() is called
  */
-void addOutputItem(OutputItems *outputItems, char *name, double *ptr);
+void addOutputItem(OutputItems *outputItems, const char *name,
+                   const char *units, const void *ptr, VarType type);
 
-/* For each output item, write a label, followed by a separator
-   This is intended for writing a single label at the start of each line
-   - For example, could write the location for spatial output, or the value of
-   some variable for a sensitivity test
+/* Open the output file, and write its header
+   format is one of the OUTPUT_FORMAT_* values (see common/context.h); text
+   output has a header row only if printHeader is set, binary output always
+   describes its columns
  */
-void writeOutputItemLabels(OutputItems *outputItems, char *label);
+void openOutputItems(OutputItems *outputItems, const char *format,
+                     int printHeader);
 
-// For each output item, write its current value, followed by a separator
-void writeOutputItemValues(OutputItems *outputItems);
+// Write a row of the current values of the output items
+void writeOutputItemValues(OutputItems *outputItems, int year, int day,
+                           double time);
+
+/* Copy year, day, time and the current value of each output item to values,
+   which must have room for OUTPUT_ITEMS_LABELS + outputItems->count values
+ */
+void getOutputItemValues(OutputItems *outputItems, int year, int day,
+                         double time, double *values);
+
+/* Write a row from values (as filled in by getOutputItemValues())
+   target is the OutputItems; the signature matches AsyncRowWriter (see
+   asyncOutput.h), so the values can be written on another thread
+ */
+void writeOutputItemRow(void *target, const void *layout, const double *values,
+                        int numValues);
 
-/* For each output item, write a newline
+/* Write any buffered rows
    This is intended to be called at the end of each run
  */
-void terminateOutputItemLines(OutputItems *outputItems);
+void finishOutputItems(OutputItems *outputItems);
 
 /* Free up space used by outputItems
-   Also, close all files associated with the individual output items
+   Also, close the output file
  */
 void deleteOutputItems(OutputItems *outputItems);
 
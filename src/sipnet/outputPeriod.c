@@ -0,0 +1,166 @@
+// Aggregation of output rows by calendar period; see outputPeriod.h
+
+#include "outputPeriod.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/context.h"
+#include "common/exitCodes.h"
+#include "common/logging.h"
+
+typedef enum PeriodType { PERIOD_DAY, PERIOD_MONTH, PERIOD_YEAR } PeriodType;
+
+struct OutputPeriod {
+  PeriodType type;
+  const OutputColumnKind *kinds;
+  int numColumns;
+  int yearCol;
+  int dayCol;
+
+  // The current period, and the steps added to it so far
+  long key;
+  int numSteps;
+  double totLength;
+  double *values;
+
+  // Length of the period last finished
+  double finishedLength;
+};
+
+// Day of year on which each month starts, in non-leap and leap years, with the
+// start of the next year last
+static const int MONTH_STARTS[2][13] = {
+    {1, 32, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335, 366},
+    {1, 32, 61, 92, 122, 153, 183, 214, 245, 275, 306, 336, 367}};
+
+static int isLeapYear(int year) {
+  return ((year % 4 == 0) && (year % 100 != 0)) || (year % 400 == 0);
+}
+
+// Month (0 to 11) of a day of year; days past the end of the year count as
+// December
+static int monthOfDay(int year, int day) {
+  const int *starts = MONTH_STARTS[isLeapYear(year)];
+  int month = 0;
+
+  while ((month < 11) && (day >= starts[month + 1])) {
+    ++month;
+  }
+  return month;
+}
+
+// Key identifying the period a step of year and day falls in
+static long periodKey(const OutputPeriod *agg, int year, int day) {
+  switch (agg->type) {
+    case PERIOD_DAY:
+      return (long)year * 1000 + day;
+    case PERIOD_MONTH:
+      return (long)year * 1000 + monthOfDay(year, day);
+    default:
+      return year;
+  }
+}
+
+// See outputPeriod.h
+OutputPeriod *newOutputPeriod(const char *period, const OutputColumnKind *kinds,
+                              int numColumns, int yearCol, int dayCol) {
+  OutputPeriod *agg = (OutputPeriod *)malloc(sizeof(OutputPeriod));
+  if (agg != NULL) {
+    agg->values = (double *)malloc(numColumns * sizeof(double));
+  }
+  if ((agg == NULL) || (agg->values == NULL)) {
+    logError("memory allocation failure aggregating output by period\n");
+    exit(EXIT_CODE_INTERNAL_ERROR);
+  }
+
+  if (strcmp(period, OUTPUT_PERIOD_DAY) == 0) {
+    agg->type = PERIOD_DAY;
+  } else if (strcmp(period, OUTPUT_PERIOD_MONTH) == 0) {
+    agg->type = PERIOD_MONTH;
+  } else {
+    agg->type = PERIOD_YEAR;
+  }
+  agg->kinds = kinds;
+  agg->numColumns = numColumns;
+  agg->yearCol = yearCol;
+  agg->dayCol = dayCol;
+  agg->key = 0;
+  agg->numSteps = 0;
+  agg->totLength = 0;
+  agg->finishedLength = 0;
+
+  return agg;
+}
+
+// See outputPeriod.h
+int finishOutputPeriod(OutputPeriod *agg, double *row) {
+  if (agg->numSteps == 0) {
+    return 0;
+  }
+  for (int col = 0; col < agg->numColumns; ++col) {
+    row[col] = agg->values[col];
+    if ((agg->kinds[col] == COLUMN_MEAN) && (agg->totLength > 0)) {
+      row[col] /= agg->totLength;
+    }
+  }
+  agg->finishedLength = agg->totLength;
+  agg->numSteps = 0;
+  agg->totLength = 0;
+  return 1;
+}
+
+// See outputPeriod.h
+double getOutputPeriodLength(const OutputPeriod *agg) {
+  return agg->finishedLength;
+}
+
+// See outputPeriod.h
+int addOutputPeriodStep(OutputPeriod *agg, const double *values, double length,
+                        double *row) {
+  long key = periodKey(agg, (int)values[agg->yearCol],
+                       (int)values[agg->dayCol]);
+  int finished = 0;
+
+  if ((agg->numSteps > 0) && (key != agg->key)) {
+    finished = finishOutputPeriod(agg, row);
+  }
+
+  if (agg->numSteps == 0) {
+    agg->key = key;
+    for (int col = 0; col < agg->numColumns; ++col) {
+      agg->values[col] = 0;
+    }
+  }
+  for (int col = 0; col < agg->numColumns; ++col) {
+    switch (agg->kinds[col]) {
+      case COLUMN_LABEL:
+        if (agg->numSteps == 0) {
+          agg->values[col] = values[col];
+        }
+        break;
+      case COLUMN_SUM:
+        agg->values[col] += values[col];
+        break;
+      case COLUMN_MEAN:
+        agg->values[col] += values[col] * length;
+        break;
+      case COLUMN_LAST:
+        agg->values[col] = values[col];
+        break;
+    }
+  }
+  ++agg->numSteps;
+  agg->totLength += length;
+
+  return finished;
+}
+
+// See outputPeriod.h
+void deleteOutputPeriod(OutputPeriod *agg) {
+  if (agg == NULL) {
+    return;
+  }
+  free(agg->values);
+  free(agg);
+}
@@ -0,0 +1,79 @@
+// header file for outputPeriod.c: aggregation of output rows by calendar
+// period
+//
+// Rows of the main output can be written per day, month or year instead of
+// per time step. Each step's row is added to the period it falls in, which is
+// found from the step's year and day of year; when a step starts a new period,
+// the previous period's row is finished. Each column is aggregated by its kind
+// (OutputColumnKind): fluxes over the step are summed, rates averaged over
+// time, and pools sampled at the end of the period. A period's row is labelled
+// with the year, day and time of its first step.
+
+#ifndef OUTPUT_PERIOD_H
+#define OUTPUT_PERIOD_H
+
+// How a column is aggregated over a period
+typedef enum OutputColumnKind {
+  // Value of the period's first step: year, day and time
+  COLUMN_LABEL,
+  // Amount over the step, summed over the period
+  COLUMN_SUM,
+  // Rate, averaged over the period weighted by step length
+  COLUMN_MEAN,
+  // Pool or other state, sampled at the end of the period
+  COLUMN_LAST
+} OutputColumnKind;
+
+typedef struct OutputPeriod OutputPeriod;
+
+/*!
+ * Start aggregating rows by period
+ *
+ * @param period one of the OUTPUT_PERIOD_* values (see common/context.h)
+ *               other than OUTPUT_PERIOD_STEP
+ * @param kinds how each column is aggregated, not copied; it must outlive the
+ *              OutputPeriod
+ * @param numColumns number of columns in a row
+ * @param yearCol column holding the year
+ * @param dayCol column holding the day of year
+ * @return new OutputPeriod; exits on allocation failure
+ */
+OutputPeriod *newOutputPeriod(const char *period, const OutputColumnKind *kinds,
+                              int numColumns, int yearCol, int dayCol);
+
+/*!
+ * Add a step's row to its period
+ *
+ * If the step starts a new period, the previous period's row is finished
+ * first, and written to row.
+ *
+ * @param agg OutputPeriod
+ * @param values the step's row
+ * @param length length of the step, in days, weighting COLUMN_MEAN columns
+ * @param row where to write a finished row; not values
+ * @return 1 if a row was finished, 0 if not
+ */
+int addOutputPeriodStep(OutputPeriod *agg, const double *values, double length,
+                        double *row);
+
+/*!
+ * Finish the current period, partial or not, if it has any steps
+ *
+ * @param agg OutputPeriod
+ * @param row where to write the finished row
+ * @return 1 if a row was finished, 0 if no steps were added since the last one
+ */
+int finishOutputPeriod(OutputPeriod *agg, double *row);
+
+/*!
+ * Length, in days, of the period last finished: the sum of the lengths of its
+ * steps
+ */
+double getOutputPeriodLength(const OutputPeriod *agg);
+
+/*!
+ * Free an OutputPeriod; any unfinished period is dropped
+ */
+void deleteOutputPeriod(OutputPeriod *agg);
+
+#endif
@@ -5,18 +5,25 @@
 #include <errno.h>
 #include <limits.h>
 #include <math.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <unistd.h>
 
 #include "common/context.h"
 #include "common/exitCodes.h"
 #include "common/logging.h"
 #include "common/util.h"
 #include "events.h"
+#include "model.h"
+#include "sipnet.h"
+#include "varRegistry.h"
 #include "version.h"
 
 #define RESTART_MAGIC "SIPNET_RESTART"
+// Stands in for the file name in messages about in-memory checkpoints
+#define RESTART_MEMORY_NAME "<memory checkpoint>"
 #define RESTART_FLOAT_EPSILON 1e-8
 
 /*
@@ -77,7 +84,6 @@ typedef struct RestartClimateSignature {
   double time;
   double length;
 } RestartClimateSignature;
-static RestartClimateSignature boundaryClimate;
 
 // NUM_CONTEXT_MODEL_FLAGS is defined in context.h, as that is the authoritative
 // source
@@ -95,8 +101,8 @@ typedef struct RestartContextModelFlags {
   int anaerobic;
   int flooding;
   int carbonSaturation;
+  int analyticLight;
 } RestartContextModelFlags;
-static RestartContextModelFlags modelFlags;
 
 _Static_assert(sizeof(RestartContextModelFlags) == NUM_CONTEXT_MODEL_FLAGS * 4,
                "Restart schema drift: Model flags changed; update "
@@ -120,17 +126,16 @@ typedef struct StateField_s {
   int seen;
 } StateField;
 
-// **********
-// Tracking vars and storage for non-sipnet values
-// Make sure to handle the ones that modify SIPNET state in both read and write
-static long long processedStepCount = 0;
-static long long checkpointUTCEpoch = 0;
-static const ClimateNode *lastProcessedClimateStep = NULL;
-static char modelVersion[MODEL_VERSION_BUFFER_SIZE] = {0};
-static char buildInfo[BUILD_INFO_BUFFER_SIZE] = {0};
-static int endRestart = 0;
-
 typedef struct RestartState_s {
+  // Storage for non-sipnet values; the processed step count lives in the
+  // model, as it carries over between restart segments
+  long long checkpointUTCEpoch;
+  char modelVersion[MODEL_VERSION_BUFFER_SIZE];
+  char buildInfo[BUILD_INFO_BUFFER_SIZE];
+  int endRestart;
+  RestartClimateSignature boundaryClimate;
+  RestartContextModelFlags modelFlags;
+
   // Note: meanNPP value and weight arrays are still handled separately
   StateField metaPF[NUM_META_FIELDS + 1];
   StateField schemaPF[NUM_SCHEMA_FIELDS + 1];
@@ -145,14 +150,40 @@ typedef struct RestartState_s {
   StateField endPF[1];  // Should only ever be exactly one here
 } RestartState;
 
-void initResetState(RestartState *state, MeanTracker *npp) {
+// Fill in the fields of a list from the registry's variables of a group, keyed
+// by their qualified names, followed by the list's invalid entry
+static void setRegistryFields(StateField *fields, int numFields, VarGroup group,
+                              SipnetModel *model) {
+  int count;
+  const VarInfo *vars = getGroupVariables(group, &count);
+
+  if (count != numFields) {
+    logInternalError("Restart array size mismatch: %s\n",
+                     getVarGroupName(group));
+    exit(EXIT_CODE_INTERNAL_ERROR);
+  }
+  for (int ind = 0; ind < count; ++ind) {
+    fields[ind].type = (vars[ind].type == VAR_INT) ? FT_INT : FT_DOUBLE;
+    fields[ind].value = getVariableAddress(model, &vars[ind]);
+    fields[ind].seen = 0;
+    snprintf(fields[ind].key, sizeof(fields[ind].key), "%s", vars[ind].name);
+  }
+  fields[count] = (StateField){"", FT_INVALID, NULL, FIELD_INVALID};
+  snprintf(fields[count].key, sizeof(fields[count].key), "%s.invalid",
+           getVarGroupName(group));
+}
+
+void initResetState(SipnetModel *model, RestartState *state) {
+  MeanTracker *npp = model->meanNPP;
+  memset(state, 0, sizeof(*state));
+
   int ind = 0;
   // clang-format off
   // NOLINTBEGIN
-  state->metaPF[ind++] = (StateField){"meta_info.model_version",        FT_CHAR,      modelVersion,       MODEL_VERSION_BUFFER_SIZE};
-  state->metaPF[ind++] = (StateField){"meta_info.build_info",           FT_CHAR,      buildInfo,          BUILD_INFO_BUFFER_SIZE};
-  state->metaPF[ind++] = (StateField){"meta_info.checkpoint_utc_epoch", FT_LONGLONG, &checkpointUTCEpoch, 0};
-  state->metaPF[ind++] = (StateField){"meta_info.processed_steps",      FT_LONGLONG, &processedStepCount, 0};
+  state->metaPF[ind++] = (StateField){"meta_info.model_version",        FT_CHAR,      state->modelVersion,        MODEL_VERSION_BUFFER_SIZE};
+  state->metaPF[ind++] = (StateField){"meta_info.build_info",           FT_CHAR,      state->buildInfo,           BUILD_INFO_BUFFER_SIZE};
+  state->metaPF[ind++] = (StateField){"meta_info.checkpoint_utc_epoch", FT_LONGLONG, &state->checkpointUTCEpoch, 0};
+  state->metaPF[ind++] = (StateField){"meta_info.processed_steps",      FT_LONGLONG, &model->processedStepCount, 0};
   state->metaPF[ind++] = (StateField){"meta.info.invalid",              FT_INVALID,   NULL,               FIELD_INVALID};
   if (ind != NUM_META_FIELDS + 1) {
     logInternalError("Restart array size mismatch: metaPF\n");
@@ -171,18 +202,19 @@ void initResetState(RestartState *state, MeanTracker *npp) {
   }
 
   ind = 0;
-  state->flagsPF[ind++] = (StateField){"flags.events",        FT_INT, &modelFlags.events,        0};
-  state->flagsPF[ind++] = (StateField){"flags.gdd",           FT_INT, &modelFlags.gdd,           0};
-  state->flagsPF[ind++] = (StateField){"flags.growthResp",    FT_INT, &modelFlags.growthResp,    0};
-  state->flagsPF[ind++] = (StateField){"flags.leafWater",     FT_INT, &modelFlags.leafWater,     0};
-  state->flagsPF[ind++] = (StateField){"flags.litterPool",    FT_INT, &modelFlags.litterPool,    0};
-  state->flagsPF[ind++] = (StateField){"flags.snow",          FT_INT, &modelFlags.snow,          0};
-  state->flagsPF[ind++] = (StateField){"flags.soilPhenol",    FT_INT, &modelFlags.soilPhenol,    0};
-  state->flagsPF[ind++] = (StateField){"flags.waterHResp",    FT_INT, &modelFlags.waterHResp,    0};
-  state->flagsPF[ind++] = (StateField){"flags.nitrogenCycle", FT_INT, &modelFlags.nitrogenCycle, 0};
-  state->flagsPF[ind++] = (StateField){"flags.anaerobic",     FT_INT, &modelFlags.anaerobic,     0};
-  state->flagsPF[ind++] = (StateField){"flags.flooding",     FT_INT, &modelFlags.flooding,      0};
-  state->flagsPF[ind++] = (StateField){"flags.carbonSaturation", FT_INT, &modelFlags.carbonSaturation, 0};
+  state->flagsPF[ind++] = (StateField){"flags.events",        FT_INT, &state->modelFlags.events,        0};
+  state->flagsPF[ind++] = (StateField){"flags.gdd",           FT_INT, &state->modelFlags.gdd,           0};
+  state->flagsPF[ind++] = (StateField){"flags.growthResp",    FT_INT, &state->modelFlags.growthResp,    0};
+  state->flagsPF[ind++] = (StateField){"flags.leafWater",     FT_INT, &state->modelFlags.leafWater,     0};
+  state->flagsPF[ind++] = (StateField){"flags.litterPool",    FT_INT, &state->modelFlags.litterPool,    0};
+  state->flagsPF[ind++] = (StateField){"flags.snow",          FT_INT, &state->modelFlags.snow,          0};
+  state->flagsPF[ind++] = (StateField){"flags.soilPhenol",    FT_INT, &state->modelFlags.soilPhenol,    0};
+  state->flagsPF[ind++] = (StateField){"flags.waterHResp",    FT_INT, &state->modelFlags.waterHResp,    0};
+  state->flagsPF[ind++] = (StateField){"flags.nitrogenCycle", FT_INT, &state->modelFlags.nitrogenCycle, 0};
+  state->flagsPF[ind++] = (StateField){"flags.anaerobic",     FT_INT, &state->modelFlags.anaerobic,     0};
+  state->flagsPF[ind++] = (StateField){"flags.flooding",     FT_INT, &state->modelFlags.flooding,      0};
+  state->flagsPF[ind++] = (StateField){"flags.carbonSaturation", FT_INT, &state->modelFlags.carbonSaturation, 0};
+  state->flagsPF[ind++] = (StateField){"flags.analyticLight", FT_INT, &state->modelFlags.analyticLight, 0};
   state->flagsPF[ind++] = (StateField){"flags.invalid",      FT_INVALID, NULL, FIELD_INVALID};
   if (ind != NUM_CONTEXT_MODEL_FLAGS + 1) {
     logInternalError("Restart array size mismatch: flagsPF\n");
@@ -190,10 +222,10 @@ void initResetState(RestartState *state, MeanTracker *npp) {
   }
 
   ind = 0;
-  state->boundaryPF[ind++] = (StateField){"boundary.year",    FT_INT,     &boundaryClimate.year,   0};
-  state->boundaryPF[ind++] = (StateField){"boundary.day",     FT_INT,     &boundaryClimate.day,    0};
-  state->boundaryPF[ind++] = (StateField){"boundary.time",    FT_DOUBLE,  &boundaryClimate.time,   0};
-  state->boundaryPF[ind++] = (StateField){"boundary.length",  FT_DOUBLE,  &boundaryClimate.length, 0};
+  state->boundaryPF[ind++] = (StateField){"boundary.year",    FT_INT,     &state->boundaryClimate.year,   0};
+  state->boundaryPF[ind++] = (StateField){"boundary.day",     FT_INT,     &state->boundaryClimate.day,    0};
+  state->boundaryPF[ind++] = (StateField){"boundary.time",    FT_DOUBLE,  &state->boundaryClimate.time,   0};
+  state->boundaryPF[ind++] = (StateField){"boundary.length",  FT_DOUBLE,  &state->boundaryClimate.length, 0};
   state->boundaryPF[ind++] = (StateField){"boundary.invalid", FT_INVALID, NULL, FIELD_INVALID};
   if (ind != NUM_CLIMATE_SIGNATURE_FIELDS + 1) {
     logInternalError("Restart array size mismatch: boundaryPF\n");
@@ -212,88 +244,20 @@ void initResetState(RestartState *state, MeanTracker *npp) {
     exit(EXIT_CODE_INTERNAL_ERROR);
   }
 
-  ind = 0;
-  state->enviPF[ind++] = (StateField){"envi.plantWoodC",              FT_DOUBLE, &envi.plantWoodC,           0};
-  state->enviPF[ind++] = (StateField){"envi.plantLeafC",              FT_DOUBLE, &envi.plantLeafC,           0};
-  state->enviPF[ind++] = (StateField){"envi.soilC",                   FT_DOUBLE, &envi.soilC,                0};
-  state->enviPF[ind++] = (StateField){"envi.soilWater",               FT_DOUBLE, &envi.soilWater,            0};
-  state->enviPF[ind++] = (StateField){"envi.litterC",                 FT_DOUBLE, &envi.litterC,              0};
-  state->enviPF[ind++] = (StateField){"envi.snow",                    FT_DOUBLE, &envi.snow,                 0};
-  state->enviPF[ind++] = (StateField){"envi.coarseRootC",             FT_DOUBLE, &envi.coarseRootC,          0};
-  state->enviPF[ind++] = (StateField){"envi.fineRootC",               FT_DOUBLE, &envi.fineRootC,            0};
-  state->enviPF[ind++] = (StateField){"envi.minN",                   FT_DOUBLE, &envi.minN,                  0};
-  state->enviPF[ind++] = (StateField){"envi.soilOrgN",               FT_DOUBLE, &envi.soilOrgN,              0};
-  state->enviPF[ind++] = (StateField){"envi.litterN",                FT_DOUBLE, &envi.litterN,               0};
-  state->enviPF[ind++] = (StateField){"envi.plantStorageN",          FT_DOUBLE, &envi.plantStorageN,         0};
-  state->enviPF[ind++] = (StateField){"envi.plantCAccountingDelta",  FT_DOUBLE, &envi.plantCAccountingDelta, 0};
-  state->enviPF[ind++] = (StateField){"envi.invalid",                FT_INVALID,NULL, FIELD_INVALID};
-  if (ind != NUM_ENVI_FIELDS + 1) {
-    logInternalError("Restart array size mismatch: enviPF\n");
-    exit(EXIT_CODE_INTERNAL_ERROR);
-  }
-
-  ind = 0;
-  state->trackersPF[ind++] = (StateField){"trackers.gpp",                 FT_DOUBLE, &trackers.gpp,                0};
-  state->trackersPF[ind++] = (StateField){"trackers.rtot",                FT_DOUBLE, &trackers.rtot,               0};
-  state->trackersPF[ind++] = (StateField){"trackers.ra",                  FT_DOUBLE, &trackers.ra,                 0};
-  state->trackersPF[ind++] = (StateField){"trackers.rh",                  FT_DOUBLE, &trackers.rh,                 0};
-  state->trackersPF[ind++] = (StateField){"trackers.rRoot",               FT_DOUBLE, &trackers.rRoot,              0};
-  state->trackersPF[ind++] = (StateField){"trackers.rSoil",               FT_DOUBLE, &trackers.rSoil,              0};
-  state->trackersPF[ind++] = (StateField){"trackers.rAboveground",        FT_DOUBLE, &trackers.rAboveground,       0};
-  state->trackersPF[ind++] = (StateField){"trackers.npp",                 FT_DOUBLE, &trackers.npp,                0};
-  state->trackersPF[ind++] = (StateField){"trackers.nee",                 FT_DOUBLE, &trackers.nee,                0};
-  state->trackersPF[ind++] = (StateField){"trackers.woodCreation",        FT_DOUBLE, &trackers.woodCreation,       0};
-  state->trackersPF[ind++] = (StateField){"trackers.gdd",                FT_DOUBLE, &trackers.gdd,                0};
-  state->trackersPF[ind++] = (StateField){"trackers.evapotranspiration", FT_DOUBLE, &trackers.evapotranspiration, 0};
-  state->trackersPF[ind++] = (StateField){"trackers.soilWetnessFrac",    FT_DOUBLE, &trackers.soilWetnessFrac,    0},
-  state->trackersPF[ind++] = (StateField){"trackers.yearlyGpp",          FT_DOUBLE, &trackers.yearlyGpp,          0};
-  state->trackersPF[ind++] = (StateField){"trackers.yearlyRtot",         FT_DOUBLE, &trackers.yearlyRtot,         0};
-  state->trackersPF[ind++] = (StateField){"trackers.yearlyRa",           FT_DOUBLE, &trackers.yearlyRa,           0};
-  state->trackersPF[ind++] = (StateField){"trackers.yearlyRh",           FT_DOUBLE, &trackers.yearlyRh,           0};
-  state->trackersPF[ind++] = (StateField){"trackers.yearlyNpp",          FT_DOUBLE, &trackers.yearlyNpp,          0};
-  state->trackersPF[ind++] = (StateField){"trackers.yearlyNee",          FT_DOUBLE, &trackers.yearlyNee,          0};
-  state->trackersPF[ind++] = (StateField){"trackers.yearlyLitter",       FT_DOUBLE, &trackers.yearlyLitter,       0};
-  state->trackersPF[ind++] = (StateField){"trackers.totGpp",             FT_DOUBLE, &trackers.totGpp,             0};
-  state->trackersPF[ind++] = (StateField){"trackers.totRtot",            FT_DOUBLE, &trackers.totRtot,            0};
-  state->trackersPF[ind++] = (StateField){"trackers.totRa",              FT_DOUBLE, &trackers.totRa,              0};
-  state->trackersPF[ind++] = (StateField){"trackers.totRh",              FT_DOUBLE, &trackers.totRh,              0};
-  state->trackersPF[ind++] = (StateField){"trackers.totNpp",             FT_DOUBLE, &trackers.totNpp,             0};
-  state->trackersPF[ind++] = (StateField){"trackers.totNee",             FT_DOUBLE, &trackers.totNee,             0};
-  state->trackersPF[ind++] = (StateField){"trackers.lastYear",           FT_INT,    &trackers.lastYear,           0};
-  state->trackersPF[ind++] = (StateField){"trackers.methane",            FT_DOUBLE, &trackers.methane,            0};
-  state->trackersPF[ind++] = (StateField){"trackers.n2o",                FT_DOUBLE, &trackers.n2o,              0};
-  state->trackersPF[ind++] = (StateField){"trackers.nLeaching",          FT_DOUBLE, &trackers.nLeaching,        0};
-  state->trackersPF[ind++] = (StateField){"trackers.nFixation",          FT_DOUBLE, &trackers.nFixation,        0};
-  state->trackersPF[ind++] = (StateField){"trackers.nUptake",            FT_DOUBLE, &trackers.nUptake,          0};
-  state->trackersPF[ind++] = (StateField){"trackers.meanNPP",            FT_DOUBLE, &trackers.meanNPP,          0};
-  state->trackersPF[ind++] = (StateField){"trackers.invalid",            FT_INVALID, NULL, FIELD_INVALID};
-  if (ind != NUM_TRACKER_FIELDS + 1) {
-    logInternalError("Restart array size mismatch: trackerPF\n");
-    exit(EXIT_CODE_INTERNAL_ERROR);
-  }
-
-  ind = 0;
-  state->phenologyPF[ind++] = (StateField){"phenology.didLeafGrowth", FT_INT,     &phenologyTrackers.didLeafGrowth, 0};
-  state->phenologyPF[ind++] = (StateField){"phenology.didLeafFall",   FT_INT,     &phenologyTrackers.didLeafFall,   0};
-  state->phenologyPF[ind++] = (StateField){"phenology.lastYear",      FT_INT,     &phenologyTrackers.lastYear,      0};
-  state->phenologyPF[ind++] = (StateField){"phenology.invalid",       FT_INVALID, NULL, FIELD_INVALID};
-  if (ind != NUM_PHENOLOGY_TRACKERS_FIELDS + 1) {
-    logInternalError("Restart array size mismatch: phenoPF\n");
-    exit(EXIT_CODE_INTERNAL_ERROR);
-  }
-
-  ind = 0;
-  state->survivalPF[ind++] = (StateField){"survival.isAlive",  FT_INT,     &plantSurvivalTracker.isAlive,  0};
-  state->survivalPF[ind++] = (StateField){"survival.invalid",  FT_INVALID, NULL, FIELD_INVALID};
-  if (ind != NUM_SURVIVAL_TRACKERS_FIELDS + 1) {
-    logInternalError("Restart array size mismatch: survivalPF\n");
-    exit(EXIT_CODE_INTERNAL_ERROR);
-  }
+  // clang-format on
+  setRegistryFields(state->enviPF, NUM_ENVI_FIELDS, VAR_ENVI, model);
+  setRegistryFields(state->trackersPF, NUM_TRACKER_FIELDS, VAR_TRACKERS,
+                    model);
+  setRegistryFields(state->phenologyPF, NUM_PHENOLOGY_TRACKERS_FIELDS,
+                    VAR_PHENOLOGY, model);
+  setRegistryFields(state->survivalPF, NUM_SURVIVAL_TRACKERS_FIELDS,
+                    VAR_SURVIVAL, model);
 
+  // clang-format off
   ind = 0;
-  state->eventPF[ind++] = (StateField){"event_trackers.d_till_mod",             FT_DOUBLE,  &eventTrackers.d_till_mod,             0};
-  state->eventPF[ind++] = (StateField){"event_trackers.harvestFracRemoved",     FT_DOUBLE,  &eventTrackers.harvestFracRemoved,     0};
-  state->eventPF[ind++] = (StateField){"event_trackers.harvestFracTransferred", FT_DOUBLE,  &eventTrackers.harvestFracTransferred, 0};
+  state->eventPF[ind++] = (StateField){"event_trackers.d_till_mod",             FT_DOUBLE,  &model->eventTrackers.d_till_mod,             0};
+  state->eventPF[ind++] = (StateField){"event_trackers.harvestFracRemoved",     FT_DOUBLE,  &model->eventTrackers.harvestFracRemoved,     0};
+  state->eventPF[ind++] = (StateField){"event_trackers.harvestFracTransferred", FT_DOUBLE,  &model->eventTrackers.harvestFracTransferred, 0};
   state->eventPF[ind++] = (StateField){"event_trackers.invalid",                FT_INVALID, NULL, FIELD_INVALID};
   if (ind != NUM_EVENT_TRACKERS_FIELDS + 1) {
     logInternalError("Restart array size mismatch: eventPF\n");
@@ -302,7 +266,7 @@ void initResetState(RestartState *state, MeanTracker *npp) {
 
   // meanNPP array handlers
 
-  state->endPF[0] = (StateField){"end_restart", FT_INT, &endRestart, 0};
+  state->endPF[0] = (StateField){"end_restart", FT_INT, &state->endRestart, 0};
   // NOLINTEND
   // clang-format on
 }
@@ -341,6 +305,14 @@ static void advanceOneDay(int *year, int *day) {
   }
 }
 
+// Whether a checkpoint after this step is at a midnight boundary: the step is
+// the day's last, starting within one step of midnight
+static int isMidnightBoundary(const RestartClimateSignature *boundary) {
+  double stepHours = boundary->length * 24.0;
+  double hoursUntilMidnight = 24.0 - boundary->time;
+  return hoursUntilMidnight <= (stepHours + RESTART_FLOAT_EPSILON);
+}
+
 static void
 validateCheckpointBoundaryForWrite(const char *restartOut,
                                    const RestartClimateSignature *boundary) {
@@ -353,8 +325,7 @@ validateCheckpointBoundaryForWrite(const char *restartOut,
     exit(EXIT_CODE_BAD_RESTART_PARAMETER);
   }
 
-  double hoursUntilMidnight = 24.0 - boundary->time;
-  if (hoursUntilMidnight > (stepHours + RESTART_FLOAT_EPSILON)) {
+  if (!isMidnightBoundary(boundary)) {
     logWarning("Restart checkpoint %s ends more than one timestep before "
                "midnight; there will be a time gap if this file is used to "
                "resume.\n",
@@ -597,10 +568,43 @@ void markSeen(int *seen, const char *restartIn, const char *key) {
   *seen = FIELD_SEEN;
 }
 
-static void readRestartState(const char *restartIn, RestartState *state,
-                             MeanTracker *meanNPP) {
-  FILE *in = openFile(restartIn, "r");
+// Exits if a checkpoint's mean.npp.length differs from the model's
+static void checkMeanLength(const char *restartIn, const MeanTracker *meanNPP,
+                            int meanLength) {
+  if (meanNPP->length != meanLength) {
+    logError("Restart schema mismatch in %s: mean.npp.length (%d) does not "
+             "match the compiled model length (%d)\n",
+             restartIn, meanNPP->length, meanLength);
+    exit(EXIT_CODE_BAD_RESTART_PARAMETER);
+  }
+}
 
+// Flags added to the text schema after checkpoints were first written, and
+// the value that a checkpoint written before them implies
+static const struct {
+  const char *key;
+  int defaultValue;
+} OPTIONAL_FLAGS[] = {
+    // Checkpoints from before this flag used Simpson's rule
+    {"flags.analyticLight", 0}};
+
+// Fill in any optional flags the checkpoint didn't have with their defaults
+static void defaultOptionalFlags(RestartState *state) {
+  for (size_t opt = 0; opt < sizeof(OPTIONAL_FLAGS) / sizeof(OPTIONAL_FLAGS[0]);
+       ++opt) {
+    for (int ind = 0; ind < NUM_CONTEXT_MODEL_FLAGS; ++ind) {
+      StateField *sf = &state->flagsPF[ind];
+      if (strcmp(sf->key, OPTIONAL_FLAGS[opt].key) == 0 &&
+          sf->seen != FIELD_SEEN) {
+        *(int *)sf->value = OPTIONAL_FLAGS[opt].defaultValue;
+        setSeen(sf);
+      }
+    }
+  }
+}
+
+static void readRestartState(const char *restartIn, FILE *in,
+                             RestartState *state, MeanTracker *meanNPP) {
   char firstLine[256];
   if (fgets(firstLine, sizeof(firstLine), in) == NULL) {
     parseError(restartIn, "missing header line", NULL);
@@ -717,15 +721,10 @@ static void readRestartState(const char *restartIn, RestartState *state,
     exit(EXIT_CODE_BAD_RESTART_PARAMETER);
   }
 
-  fclose(in);
-
   // Validate that the checkpoint file did not attempt to resize the MeanTracker
-  if (meanNPP->length != meanLength) {
-    logError("Restart schema mismatch in %s: mean.npp.length (%d) does not "
-             "match the compiled model length (%d)\n",
-             restartIn, meanNPP->length, meanLength);
-    exit(EXIT_CODE_BAD_RESTART_PARAMETER);
-  }
+  checkMeanLength(restartIn, meanNPP, meanLength);
+
+  defaultOptionalFlags(state);
 
   verifySeenBatch(state->metaPF, NUM_META_FIELDS, restartIn);
   verifySeenBatch(state->schemaPF, NUM_SCHEMA_FIELDS, restartIn);
@@ -784,10 +783,8 @@ static void writeKeysBatch(FILE *out, const StateField *sf, int numFields) {
   }
 }
 
-static void writeRestartState(const char *restartOut, const RestartState *state,
+static void writeRestartState(FILE *out, const RestartState *state,
                               const MeanTracker *meanNPP) {
-  FILE *out = openFile(restartOut, "w");
-
   // Magic header
   fprintf(out, "%s\n", RESTART_MAGIC);
 
@@ -823,25 +820,439 @@ static void writeRestartState(const char *restartOut, const RestartState *state,
   fprintf(out, "\n");
 
   fprintf(out, "end_restart 1\n");
+}
+
+// Binary checkpoints
+//
+// The same fields as the text format, in a fixed order and without keys:
+//    header: RESTART_BINARY_MAGIC (16 bytes), format version, layout
+//            signature and payload length (uint32 each)
+//    payload: each batch of fields in binaryBatches() order, then
+//             mean.npp.values and mean.npp.weights, then end_restart
+//    trailer: CRC-32 of the header and payload (uint32)
+// Integers and doubles are little-endian: int fields and schema_layout.*
+// values as int32, long long as int64, doubles as IEEE 754 binary64. Strings
+// are a uint32 length followed by their characters.
+//
+// As values are found by position rather than by key, the layout signature,
+// a CRC-32 of every key in order, must match the running build; the
+// schema_layout.* values, flags, boundary and mean tracker are checked just as
+// for text checkpoints.
+
+#define RESTART_BINARY_MAGIC_SIZE 16
+#define RESTART_BINARY_VERSION 1
+#define RESTART_BINARY_HEADER_SIZE (RESTART_BINARY_MAGIC_SIZE + 3 * 4)
+#define RESTART_BINARY_TRAILER_SIZE 4
+// Far more than any checkpoint needs; guards against reading a huge file
+#define RESTART_BINARY_MAX_SIZE (16 * 1024 * 1024)
+#define NUM_BINARY_BATCHES 11
+
+static const char RESTART_BINARY_MAGIC[RESTART_BINARY_MAGIC_SIZE] =
+    "SIPNET_RESTARTB";
+
+typedef struct FieldBatch {
+  StateField *fields;
+  int numFields;
+} FieldBatch;
+
+// Serialized checkpoint bytes: appended to when writing, and read from pos
+// when loading
+typedef struct RestartBuffer {
+  unsigned char *data;
+  size_t size;
+  size_t capacity;
+  size_t pos;
+  const char *path;  // for error messages
+} RestartBuffer;
+
+// The batches of fields, in their binary order; returns NUM_BINARY_BATCHES
+static int binaryBatches(RestartState *state, FieldBatch *batches) {
+  int ind = 0;
+  batches[ind++] = (FieldBatch){state->metaPF, NUM_META_FIELDS};
+  batches[ind++] = (FieldBatch){state->schemaPF, NUM_SCHEMA_FIELDS};
+  batches[ind++] = (FieldBatch){state->flagsPF, NUM_CONTEXT_MODEL_FLAGS};
+  batches[ind++] =
+      (FieldBatch){state->boundaryPF, NUM_CLIMATE_SIGNATURE_FIELDS};
+  batches[ind++] = (FieldBatch){state->enviPF, NUM_ENVI_FIELDS};
+  batches[ind++] = (FieldBatch){state->trackersPF, NUM_TRACKER_FIELDS};
+  batches[ind++] =
+      (FieldBatch){state->phenologyPF, NUM_PHENOLOGY_TRACKERS_FIELDS};
+  batches[ind++] =
+      (FieldBatch){state->survivalPF, NUM_SURVIVAL_TRACKERS_FIELDS};
+  batches[ind++] = (FieldBatch){state->eventPF, NUM_EVENT_TRACKERS_FIELDS};
+  batches[ind++] = (FieldBatch){state->nppPF, NUM_MEAN_META_FIELDS};
+  batches[ind++] = (FieldBatch){state->endPF, NUM_END_FIELDS};
+  if (ind != NUM_BINARY_BATCHES) {
+    logInternalError("Restart array size mismatch: binary batches\n");
+    exit(EXIT_CODE_INTERNAL_ERROR);
+  }
+  return ind;
+}
+
+// CRC-32 (IEEE 802.3, as used by zlib and gzip); checkpoints are small, so
+// the bitwise form is fast enough
+static uint32_t crc32Update(uint32_t crc, const unsigned char *data,
+                            size_t size) {
+  crc = ~crc;
+  for (size_t ind = 0; ind < size; ++ind) {
+    crc ^= data[ind];
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+  }
+  return ~crc;
+}
+
+// CRC-32 of the keys of every field, in binary order
+static uint32_t binaryLayoutSignature(RestartState *state) {
+  FieldBatch batches[NUM_BINARY_BATCHES];
+  int numBatches = binaryBatches(state, batches);
+  uint32_t crc = 0;
+
+  for (int batch = 0; batch < numBatches; ++batch) {
+    for (int ind = 0; ind < batches[batch].numFields; ++ind) {
+      const char *key = batches[batch].fields[ind].key;
+      crc = crc32Update(crc, (const unsigned char *)key, strlen(key) + 1);
+    }
+  }
+  return crc;
+}
+
+static void putBytes(RestartBuffer *buf, const void *bytes, size_t size) {
+  if (buf->size + size > buf->capacity) {
+    size_t capacity = (buf->capacity == 0) ? 8192 : buf->capacity;
+    while (buf->size + size > capacity) {
+      capacity *= 2;
+    }
+    unsigned char *data = (unsigned char *)realloc(buf->data, capacity);
+    if (data == NULL) {
+      logError("memory allocation failure writing restart checkpoint %s\n",
+               buf->path);
+      exit(EXIT_CODE_INTERNAL_ERROR);
+    }
+    buf->data = data;
+    buf->capacity = capacity;
+  }
+  memcpy(buf->data + buf->size, bytes, size);
+  buf->size += size;
+}
+
+static void putUInt(RestartBuffer *buf, uint64_t value, int numBytes) {
+  unsigned char bytes[8];
+  for (int ind = 0; ind < numBytes; ++ind) {
+    bytes[ind] = (unsigned char)(value >> (8 * ind));
+  }
+  putBytes(buf, bytes, (size_t)numBytes);
+}
+
+static void putDouble(RestartBuffer *buf, double value) {
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  putUInt(buf, bits, 8);
+}
+
+static void putString(RestartBuffer *buf, const char *value) {
+  size_t len = strlen(value);
+  putUInt(buf, len, 4);
+  putBytes(buf, value, len);
+}
+
+static const unsigned char *getBytes(RestartBuffer *buf, size_t size) {
+  if (buf->size - buf->pos < size) {
+    parseError(buf->path, "binary checkpoint is truncated", NULL);
+  }
+  const unsigned char *bytes = buf->data + buf->pos;
+  buf->pos += size;
+  return bytes;
+}
+
+static uint64_t getUInt(RestartBuffer *buf, int numBytes) {
+  const unsigned char *bytes = getBytes(buf, (size_t)numBytes);
+  uint64_t value = 0;
+  for (int ind = 0; ind < numBytes; ++ind) {
+    value |= (uint64_t)bytes[ind] << (8 * ind);
+  }
+  return value;
+}
+
+static double getDouble(RestartBuffer *buf, const char *key) {
+  uint64_t bits = getUInt(buf, 8);
+  double value;
+  memcpy(&value, &bits, sizeof(value));
+  if (!isfinite(value)) {
+    logError("Restart parse error in %s: non-finite value for key '%s'\n",
+             buf->path, key);
+    exit(EXIT_CODE_BAD_RESTART_PARAMETER);
+  }
+  return value;
+}
+
+static void writeBinaryBatch(RestartBuffer *buf, const StateField *sf,
+                             int numFields) {
+  for (int ind = 0; ind < numFields; ++ind) {
+    switch (sf[ind].type) {
+      case FT_DOUBLE:
+        putDouble(buf, *(double *)sf[ind].value);
+        break;
+      case FT_INT:
+        putUInt(buf, (uint32_t)*(int *)sf[ind].value, 4);
+        break;
+      case FT_CHAR:
+        putString(buf, (char *)sf[ind].value);
+        break;
+      case FT_LONGLONG:
+        putUInt(buf, (uint64_t)*(long long *)sf[ind].value, 8);
+        break;
+      case FT_SPECIAL:  // FT_SPECIAL writes its 'seen' value
+        putUInt(buf, (uint32_t)sf[ind].seen, 4);
+        break;
+      case FT_INVALID:
+        logInternalError("Attempted to write invalid key %s, restart.c likely "
+                         "needs an update\n",
+                         sf[ind].key);
+        exit(EXIT_CODE_INTERNAL_ERROR);
+    }
+  }
+}
+
+static void readBinaryBatch(RestartBuffer *buf, StateField *sf,
+                            int numFields) {
+  for (int ind = 0; ind < numFields; ++ind) {
+    switch (sf[ind].type) {
+      case FT_DOUBLE: {
+        double val = getDouble(buf, sf[ind].key);
+        setFieldValue(&sf[ind], &val);
+      } break;
+      case FT_INT: {
+        int val = (int32_t)getUInt(buf, 4);
+        setFieldValue(&sf[ind], &val);
+      } break;
+      case FT_LONGLONG: {
+        long long val = (int64_t)getUInt(buf, 8);
+        setFieldValue(&sf[ind], &val);
+      } break;
+      case FT_CHAR: {
+        char val[BUILD_INFO_BUFFER_SIZE];
+        size_t len = getUInt(buf, 4);
+        if (len >= (size_t)sf[ind].seen || len >= sizeof(val)) {
+          parseError(buf->path, "string value too long", sf[ind].key);
+        }
+        memcpy(val, getBytes(buf, len), len);
+        val[len] = '\0';
+        setFieldValue(&sf[ind], val);
+      } break;
+      case FT_SPECIAL: {
+        long long found = (int32_t)getUInt(buf, 4);
+        if (found != sf[ind].seen) {
+          logError("Restart schema layout mismatch in %s: key=%s found=%lld "
+                   "expected=%lld\n",
+                   buf->path, sf[ind].key, found, (long long)sf[ind].seen);
+          exit(EXIT_CODE_BAD_RESTART_PARAMETER);
+        }
+      } break;
+      case FT_INVALID:
+        logInternalError("Restart parse error, found unexpected field type %d "
+                         "(binary)\n",
+                         sf[ind].type);
+        exit(EXIT_CODE_INTERNAL_ERROR);
+    }
+    setSeen(&sf[ind]);
+  }
+}
+
+// Serialize a checkpoint into buf, which starts out empty
+static void encodeBinaryRestartState(RestartBuffer *buf, RestartState *state,
+                                     const MeanTracker *meanNPP) {
+  FieldBatch batches[NUM_BINARY_BATCHES];
+  int numBatches = binaryBatches(state, batches);
+
+  putBytes(buf, RESTART_BINARY_MAGIC, RESTART_BINARY_MAGIC_SIZE);
+  putUInt(buf, RESTART_BINARY_VERSION, 4);
+  putUInt(buf, binaryLayoutSignature(state), 4);
+  putUInt(buf, 0, 4);  // payload length, filled in below
+
+  // All batches but end_restart, then the mean tracker arrays, then
+  // end_restart
+  for (int batch = 0; batch < numBatches - 1; ++batch) {
+    writeBinaryBatch(buf, batches[batch].fields, batches[batch].numFields);
+  }
+  for (int i = 0; i < meanNPP->length; ++i) {
+    putDouble(buf, meanNPP->values[i]);
+  }
+  for (int i = 0; i < meanNPP->length; ++i) {
+    putDouble(buf, meanNPP->weights[i]);
+  }
+  state->endRestart = 1;
+  writeBinaryBatch(buf, state->endPF, NUM_END_FIELDS);
+
+  uint32_t payloadSize = (uint32_t)(buf->size - RESTART_BINARY_HEADER_SIZE);
+  for (int ind = 0; ind < 4; ++ind) {
+    buf->data[RESTART_BINARY_HEADER_SIZE - 4 + ind] =
+        (unsigned char)(payloadSize >> (8 * ind));
+  }
+  putUInt(buf, crc32Update(0, buf->data, buf->size), 4);
+}
+
+// Check and deserialize the whole checkpoint in buf->data, which is not
+// modified
+static void decodeBinaryRestartState(RestartBuffer *buf, RestartState *state,
+                                     MeanTracker *meanNPP) {
+  const char *restartIn = buf->path;
+  FieldBatch batches[NUM_BINARY_BATCHES];
+  int numBatches = binaryBatches(state, batches);
+  int meanLength = meanNPP->length;
+
+  // Check the checksum before using any of it
+  if (buf->size < RESTART_BINARY_HEADER_SIZE + RESTART_BINARY_TRAILER_SIZE) {
+    parseError(restartIn, "binary checkpoint is truncated", NULL);
+  }
+  if (buf->size > RESTART_BINARY_MAX_SIZE) {
+    parseError(restartIn, "binary checkpoint is too large", NULL);
+  }
+  buf->pos = 0;
+  getBytes(buf, RESTART_BINARY_MAGIC_SIZE);
+  uint32_t version = (uint32_t)getUInt(buf, 4);
+  if (version != RESTART_BINARY_VERSION) {
+    logError("Restart file %s has binary format version %u; this build reads "
+             "version %d\n",
+             restartIn, version, RESTART_BINARY_VERSION);
+    exit(EXIT_CODE_BAD_RESTART_PARAMETER);
+  }
+  uint32_t signature = (uint32_t)getUInt(buf, 4);
+  uint32_t payloadSize = (uint32_t)getUInt(buf, 4);
+  if ((size_t)payloadSize !=
+      buf->size - RESTART_BINARY_HEADER_SIZE - RESTART_BINARY_TRAILER_SIZE) {
+    parseError(restartIn, "binary checkpoint is truncated or has extra data",
+               NULL);
+  }
+  size_t payloadEnd = buf->size - RESTART_BINARY_TRAILER_SIZE;
+  uint32_t expectedCRC = crc32Update(0, buf->data, payloadEnd);
+  buf->pos = payloadEnd;
+  if ((uint32_t)getUInt(buf, 4) != expectedCRC) {
+    parseError(restartIn, "checksum mismatch; the checkpoint is corrupt",
+               NULL);
+  }
+  if (signature != binaryLayoutSignature(state)) {
+    logError("Restart schema layout mismatch in %s: binary checkpoint fields "
+             "differ from this build's\n",
+             restartIn);
+    exit(EXIT_CODE_BAD_RESTART_PARAMETER);
+  }
+
+  buf->pos = RESTART_BINARY_HEADER_SIZE;
+  buf->size = payloadEnd;
+  for (int batch = 0; batch < numBatches - 1; ++batch) {
+    readBinaryBatch(buf, batches[batch].fields, batches[batch].numFields);
+  }
+  // The arrays are as long as mean.npp.length, so check that first
+  checkMeanLength(restartIn, meanNPP, meanLength);
+  for (int i = 0; i < meanLength; ++i) {
+    meanNPP->values[i] = getDouble(buf, "mean.npp.values");
+  }
+  for (int i = 0; i < meanLength; ++i) {
+    meanNPP->weights[i] = getDouble(buf, "mean.npp.weights");
+  }
+  readBinaryBatch(buf, state->endPF, NUM_END_FIELDS);
+  if (state->endRestart != 1 || buf->pos != buf->size) {
+    parseError(restartIn, "binary checkpoint does not end with end_restart",
+               NULL);
+  }
+}
+
+static void readBinaryRestartState(const char *restartIn, FILE *in,
+                                   RestartState *state, MeanTracker *meanNPP) {
+  RestartBuffer buf = {NULL, 0, 0, 0, restartIn};
+
+  // Read the whole file; decodeBinaryRestartState() checks its size again
+  if (fseek(in, 0, SEEK_END) != 0) {
+    parseError(restartIn, "unable to read binary checkpoint", NULL);
+  }
+  long fileSize = ftell(in);
+  if (fileSize < 0 || fileSize > RESTART_BINARY_MAX_SIZE) {
+    parseError(restartIn, "binary checkpoint is too large", NULL);
+  }
+  buf.size = (size_t)fileSize;
+  buf.data = (unsigned char *)malloc(buf.size);
+  if (buf.data == NULL) {
+    parseError(restartIn, "unable to allocate checkpoint memory", NULL);
+  }
+  rewind(in);
+  if (fread(buf.data, 1, buf.size, in) != buf.size) {
+    parseError(restartIn, "unable to read binary checkpoint", NULL);
+  }
+
+  decodeBinaryRestartState(&buf, state, meanNPP);
+  free(buf.data);
+}
+
+// Whether a checkpoint written to restartOut is binary: as --restart-format
+// says, or by the file's extension
+static int isBinaryRestartOut(const char *restartOut) {
+  if (strcmp(ctx.restartFormat, RESTART_FORMAT_BINARY) == 0) {
+    return 1;
+  }
+  if (strcmp(ctx.restartFormat, RESTART_FORMAT_TEXT) == 0) {
+    return 0;
+  }
+  size_t len = strlen(restartOut);
+  size_t extLen = strlen(RESTART_BINARY_EXTENSION);
+  return (len >= extLen) &&
+         (strcmp(restartOut + len - extLen, RESTART_BINARY_EXTENSION) == 0);
+}
 
-  fclose(out);
+// Read a checkpoint, binary or text as its first bytes show
+static void readCheckpoint(const char *restartIn, RestartState *state,
+                           MeanTracker *meanNPP) {
+  FILE *in = openFile(restartIn, "rb");
+  char magic[RESTART_BINARY_MAGIC_SIZE];
+
+  if (fread(magic, 1, sizeof(magic), in) == sizeof(magic) &&
+      memcmp(magic, RESTART_BINARY_MAGIC, sizeof(magic)) == 0) {
+    readBinaryRestartState(restartIn, in, state, meanNPP);
+  } else {
+    rewind(in);
+    readRestartState(restartIn, in, state, meanNPP);
+  }
+  fclose(in);
 }
 
-static void checkRestartContextCompatibility(void) {
+// As readCheckpoint(), for a checkpoint held in memory
+static void readCheckpointBuffer(const void *buffer, size_t size,
+                                 RestartState *state, MeanTracker *meanNPP) {
+  if (size >= RESTART_BINARY_MAGIC_SIZE &&
+      memcmp(buffer, RESTART_BINARY_MAGIC, RESTART_BINARY_MAGIC_SIZE) == 0) {
+    // Only read from; the cast is for RestartBuffer, which is also written to
+    RestartBuffer buf = {(unsigned char *)buffer, size, size, 0,
+                         RESTART_MEMORY_NAME};
+    decodeBinaryRestartState(&buf, state, meanNPP);
+    return;
+  }
+
+  FILE *in = fmemopen((void *)buffer, size, "r");
+  if (in == NULL) {
+    parseError(RESTART_MEMORY_NAME, "unable to read checkpoint", NULL);
+  }
+  readRestartState(RESTART_MEMORY_NAME, in, state, meanNPP);
+  fclose(in);
+}
+
+static void checkRestartContextCompatibility(
+    const RestartContextModelFlags *modelFlags) {
   int mismatch = 0;
 
-  mismatch |= (ctx.events != modelFlags.events);
-  mismatch |= (ctx.gdd != modelFlags.gdd);
-  mismatch |= (ctx.growthResp != modelFlags.growthResp);
-  mismatch |= (ctx.leafWater != modelFlags.leafWater);
-  mismatch |= (ctx.litterPool != modelFlags.litterPool);
-  mismatch |= (ctx.snow != modelFlags.snow);
-  mismatch |= (ctx.soilPhenol != modelFlags.soilPhenol);
-  mismatch |= (ctx.waterHResp != modelFlags.waterHResp);
-  mismatch |= (ctx.nitrogenCycle != modelFlags.nitrogenCycle);
-  mismatch |= (ctx.anaerobic != modelFlags.anaerobic);
-  mismatch |= (ctx.flooding != modelFlags.flooding);
-  mismatch |= (ctx.carbonSaturation != modelFlags.carbonSaturation);
+  mismatch |= (ctx.events != modelFlags->events);
+  mismatch |= (ctx.gdd != modelFlags->gdd);
+  mismatch |= (ctx.growthResp != modelFlags->growthResp);
+  mismatch |= (ctx.leafWater != modelFlags->leafWater);
+  mismatch |= (ctx.litterPool != modelFlags->litterPool);
+  mismatch |= (ctx.snow != modelFlags->snow);
+  mismatch |= (ctx.soilPhenol != modelFlags->soilPhenol);
+  mismatch |= (ctx.waterHResp != modelFlags->waterHResp);
+  mismatch |= (ctx.nitrogenCycle != modelFlags->nitrogenCycle);
+  mismatch |= (ctx.anaerobic != modelFlags->anaerobic);
+  mismatch |= (ctx.flooding != modelFlags->flooding);
+  mismatch |= (ctx.carbonSaturation != modelFlags->carbonSaturation);
+  mismatch |= (ctx.analyticLight != modelFlags->analyticLight);
 
   if (mismatch) {
     logError("Restart context mismatch: model flags must match checkpoint "
@@ -850,78 +1261,107 @@ static void checkRestartContextCompatibility(void) {
   }
 }
 
-static void validateRestartModelBuild(void) {
+static void validateRestartModelBuild(const RestartState *state) {
   char currentBuildInfo[BUILD_INFO_BUFFER_SIZE];
   sanitizeBuildInfo(currentBuildInfo, VERSION_STRING);
 
-  if (strcmp(modelVersion, NUMERIC_VERSION) != 0) {
+  if (strcmp(state->modelVersion, NUMERIC_VERSION) != 0) {
     logError("Restart model version mismatch: checkpoint=%s current=%s\n",
-             modelVersion, NUMERIC_VERSION);
+             state->modelVersion, NUMERIC_VERSION);
     exit(EXIT_CODE_BAD_RESTART_PARAMETER);
   }
 
-  if (strcmp(buildInfo, currentBuildInfo) != 0) {
+  if (strcmp(state->buildInfo, currentBuildInfo) != 0) {
     logInfo("Restart build info mismatch: checkpoint=%s current=%s\n",
-            buildInfo, currentBuildInfo);
+            state->buildInfo, currentBuildInfo);
   }
 }
 
-static void validateRestartBoundary(void) {
-  if (climate == NULL) {
+static void validateRestartBoundary(
+    SipnetModel *model, const RestartClimateSignature *boundaryClimate) {
+  if (model->climate == NULL) {
     logError("Cannot restart: climate forcing has no records\n");
     exit(EXIT_CODE_INPUT_FILE_ERROR);
   }
 
-  if (!climateTimestampIsAfterBoundary(climate, &(boundaryClimate))) {
+  if (!climateTimestampIsAfterBoundary(model->climate, boundaryClimate)) {
     logError("Restart boundary mismatch: first climate timestamp does not "
              "follow checkpoint boundary timestamp\n");
     logError("Checkpoint boundary: year=%d day=%d time=%.8f\n",
-             boundaryClimate.year, boundaryClimate.day, boundaryClimate.time);
-    logError("Found:    year=%d day=%d time=%.8f\n", climate->year,
-             climate->day, climate->time);
+             boundaryClimate->year, boundaryClimate->day,
+             boundaryClimate->time);
+    logError("Found:    year=%d day=%d time=%.8f\n", model->climate->year,
+             model->climate->day, model->climate->time);
     exit(EXIT_CODE_BAD_RESTART_PARAMETER);
   }
 
-  double firstStepHours = climate->length * 24.0;
+  double firstStepHours = model->climate->length * 24.0;
   if (firstStepHours <= RESTART_FLOAT_EPSILON) {
     logError("Cannot restart: first climate timestep length is non-positive "
              "(year=%d day=%d time=%.8f length=%.8f)\n",
-             climate->year, climate->day, climate->time, climate->length);
+             model->climate->year, model->climate->day, model->climate->time,
+             model->climate->length);
     exit(EXIT_CODE_BAD_RESTART_PARAMETER);
   }
 
-  int expectedYear = boundaryClimate.year;
-  int expectedDay = boundaryClimate.day;
+  int expectedYear = boundaryClimate->year;
+  int expectedDay = boundaryClimate->day;
   advanceOneDay(&expectedYear, &expectedDay);
 
-  if (climate->year != expectedYear || climate->day != expectedDay ||
-      climate->time > (firstStepHours + RESTART_FLOAT_EPSILON)) {
+  if (model->climate->year != expectedYear ||
+      model->climate->day != expectedDay ||
+      model->climate->time > (firstStepHours + RESTART_FLOAT_EPSILON)) {
     logWarning("Restart resumed segment starts more than one "
                "timestep after midnight checkpoint boundary; there is a time "
                "gap\n");
     logWarning("Expected start on year=%d day=%d with time<=%.8f; found "
                "year=%d day=%d time=%.8f length=%.8f\n",
-               expectedYear, expectedDay, firstStepHours, climate->year,
-               climate->day, climate->time, climate->length);
+               expectedYear, expectedDay, firstStepHours, model->climate->year,
+               model->climate->day, model->climate->time,
+               model->climate->length);
   }
 }
 
-void restartResetRunState(void) {
-  processedStepCount = 0;
-  lastProcessedClimateStep = NULL;
+// Move on to the next of --restart-dates, if any
+static void advanceRestartDate(SipnetModel *model) {
+  model->hasRestartDate =
+      (nextRestartDate(ctx.restartDates, &model->restartDatesPos,
+                       &model->restartDateYear, &model->restartDateDay) == 1);
 }
 
-void restartNoteProcessedClimateStep(const ClimateNode *climateStep) {
-  lastProcessedClimateStep = climateStep;
-  ++processedStepCount;
+void restartResetRunState(SipnetModel *model) {
+  model->processedStepCount = 0;
+  model->hasProcessedClimateStep = 0;
+
+  // validateContext() has checked the value
+  parseCheckpointEvery(ctx.checkpointEvery, &model->checkpointEvery,
+                       &model->checkpointInYears);
+  model->stepsSinceCheckpoint = 0;
+  model->yearsSinceCheckpoint = 0;
+
+  model->restartDatesPos = 0;
+  advanceRestartDate(model);
 }
 
-void restartWriteCheckpoint(const char *restartOut, MeanTracker *meanNPP) {
-  if (lastProcessedClimateStep == NULL) {
+void restartNoteProcessedClimateStep(SipnetModel *model,
+                                     const ClimateNode *climateStep) {
+  // Keep a copy; climateStep is overwritten when the model moves on
+  model->lastProcessedClimateStep = *climateStep;
+  model->hasProcessedClimateStep = 1;
+  ++model->processedStepCount;
+}
+
+// Fill in the parts of state that aren't model state: the climate boundary,
+// model version, build info, time written and model flags
+static void prepareCheckpointState(SipnetModel *model, const char *restartOut,
+                                   RestartState *state) {
+  if (!model->hasProcessedClimateStep) {
     logError("Cannot write restart checkpoint %s: no timestep processed\n",
              restartOut);
     exit(EXIT_CODE_BAD_RESTART_PARAMETER);
   }
+  initResetState(model, state);
+
   // Need to copy to restart versions of some state:
   // 1. climate
   // 2. model version
@@ -930,61 +1370,70 @@ void restartWriteCheckpoint(const char *restartOut, MeanTracker *meanNPP) {
   // 5. model flags
 
   // 1. climate
-  copyClimateSignature(&boundaryClimate, lastProcessedClimateStep);
-  validateCheckpointBoundaryForWrite(restartOut, &boundaryClimate);
-
-  RestartState state;
-  initResetState(&state, meanNPP);
+  copyClimateSignature(&state->boundaryClimate,
+                       &model->lastProcessedClimateStep);
+  validateCheckpointBoundaryForWrite(restartOut, &state->boundaryClimate);
 
   // 2, 3, 4: model version, build info, UTC epoch
-  strncpy(modelVersion, NUMERIC_VERSION, MODEL_VERSION_BUFFER_SIZE - 1);
-  sanitizeBuildInfo(buildInfo, VERSION_STRING);
-  checkpointUTCEpoch = (long long)time(NULL);
+  strncpy(state->modelVersion, NUMERIC_VERSION, MODEL_VERSION_BUFFER_SIZE - 1);
+  sanitizeBuildInfo(state->buildInfo, VERSION_STRING);
+  state->checkpointUTCEpoch = (long long)time(NULL);
 
   // 5. model flags
+  RestartContextModelFlags *modelFlags = &state->modelFlags;
   int numFlagsSet = 0;
-  modelFlags.events = ctx.events;
+  modelFlags->events = ctx.events;
+  ++numFlagsSet;
+  modelFlags->gdd = ctx.gdd;
   ++numFlagsSet;
-  modelFlags.gdd = ctx.gdd;
+  modelFlags->growthResp = ctx.growthResp;
   ++numFlagsSet;
-  modelFlags.growthResp = ctx.growthResp;
+  modelFlags->leafWater = ctx.leafWater;
   ++numFlagsSet;
-  modelFlags.leafWater = ctx.leafWater;
+  modelFlags->litterPool = ctx.litterPool;
   ++numFlagsSet;
-  modelFlags.litterPool = ctx.litterPool;
+  modelFlags->snow = ctx.snow;
   ++numFlagsSet;
-  modelFlags.snow = ctx.snow;
+  modelFlags->soilPhenol = ctx.soilPhenol;
   ++numFlagsSet;
-  modelFlags.soilPhenol = ctx.soilPhenol;
+  modelFlags->waterHResp = ctx.waterHResp;
   ++numFlagsSet;
-  modelFlags.waterHResp = ctx.waterHResp;
+  modelFlags->nitrogenCycle = ctx.nitrogenCycle;
   ++numFlagsSet;
-  modelFlags.nitrogenCycle = ctx.nitrogenCycle;
+  modelFlags->anaerobic = ctx.anaerobic;
   ++numFlagsSet;
-  modelFlags.anaerobic = ctx.anaerobic;
+  modelFlags->flooding = ctx.flooding;
   ++numFlagsSet;
-  modelFlags.flooding = ctx.flooding;
+  modelFlags->carbonSaturation = ctx.carbonSaturation;
   ++numFlagsSet;
-  modelFlags.carbonSaturation = ctx.carbonSaturation;
+  modelFlags->analyticLight = ctx.analyticLight;
   ++numFlagsSet;
   if (numFlagsSet != NUM_CONTEXT_MODEL_FLAGS) {
     logInternalError("Not all model flags set while writing checkpoint\n");
     exit(EXIT_CODE_INTERNAL_ERROR);
   }
-
-  writeRestartState(restartOut, &state, meanNPP);
 }
 
-void restartLoadCheckpoint(const char *restartIn, MeanTracker *meanNPP) {
-  RestartState state;
-  initResetState(&state, meanNPP);
+// A resumed run doesn't write the dated checkpoints from before it started
+static void skipRestartDatesThrough(SipnetModel *model,
+                                    const RestartClimateSignature *boundary) {
+  while (model->hasRestartDate &&
+         ((boundary->year > model->restartDateYear) ||
+          ((boundary->year == model->restartDateYear) &&
+           (boundary->day >= model->restartDateDay)))) {
+    advanceRestartDate(model);
+  }
+}
 
-  readRestartState(restartIn, &state, meanNPP);
+// Check a checkpoint just read into the model against this run
+static void validateLoadedCheckpoint(SipnetModel *model, const char *restartIn,
+                                     RestartState *state) {
+  MeanTracker *meanNPP = model->meanNPP;
 
-  validateCheckpointBoundaryForLoad(restartIn, &boundaryClimate);
-  checkRestartContextCompatibility();
-  validateRestartModelBuild();
-  validateRestartBoundary();
+  validateCheckpointBoundaryForLoad(restartIn, &state->boundaryClimate);
+  checkRestartContextCompatibility(&state->modelFlags);
+  validateRestartModelBuild(state);
+  validateRestartBoundary(model, &state->boundaryClimate);
 
   if (meanNPP->start < 0 || meanNPP->start >= meanNPP->length ||
       meanNPP->last < 0 || meanNPP->last >= meanNPP->length) {
@@ -992,5 +1441,439 @@ void restartLoadCheckpoint(const char *restartIn, MeanTracker *meanNPP) {
     exit(EXIT_CODE_BAD_RESTART_PARAMETER);
   }
 
-  lastProcessedClimateStep = NULL;
+  model->hasProcessedClimateStep = 0;
+  skipRestartDatesThrough(model, &state->boundaryClimate);
+}
+
+void restartWriteCheckpoint(SipnetModel *model, const char *restartOut) {
+  RestartState state;
+  prepareCheckpointState(model, restartOut, &state);
+
+  if (isBinaryRestartOut(restartOut)) {
+    RestartBuffer buf = {NULL, 0, 0, 0, restartOut};
+    encodeBinaryRestartState(&buf, &state, model->meanNPP);
+    FILE *out = openFile(restartOut, "wb");
+    if (fwrite(buf.data, 1, buf.size, out) != buf.size || fclose(out) != 0) {
+      logError("Error writing restart checkpoint %s\n", restartOut);
+      exit(EXIT_CODE_FILE_OPEN_OR_READ_ERROR);
+    }
+    free(buf.data);
+  } else {
+    FILE *out = openFile(restartOut, "w");
+    writeRestartState(out, &state, model->meanNPP);
+    fclose(out);
+  }
+}
+
+void restartLoadCheckpoint(SipnetModel *model, const char *restartIn) {
+  RestartState state;
+  initResetState(model, &state);
+
+  readCheckpoint(restartIn, &state, model->meanNPP);
+  validateLoadedCheckpoint(model, restartIn, &state);
+}
+
+size_t restartWriteCheckpointToBuffer(SipnetModel *model, void *buffer,
+                                      size_t capacity) {
+  RestartState state;
+  RestartBuffer buf = {NULL, 0, 0, 0, RESTART_MEMORY_NAME};
+  prepareCheckpointState(model, RESTART_MEMORY_NAME, &state);
+
+  if (strcmp(ctx.restartFormat, RESTART_FORMAT_TEXT) == 0) {
+    char *text = NULL;
+    size_t textSize = 0;
+    FILE *out = open_memstream(&text, &textSize);
+    if (out == NULL) {
+      logError("memory allocation failure writing restart checkpoint %s\n",
+               RESTART_MEMORY_NAME);
+      exit(EXIT_CODE_INTERNAL_ERROR);
+    }
+    writeRestartState(out, &state, model->meanNPP);
+    fclose(out);
+    buf.data = (unsigned char *)text;
+    buf.size = textSize;
+  } else {
+    encodeBinaryRestartState(&buf, &state, model->meanNPP);
+  }
+
+  if (buffer != NULL && buf.size <= capacity) {
+    memcpy(buffer, buf.data, buf.size);
+  }
+  free(buf.data);
+  return buf.size;
+}
+
+void restartLoadCheckpointFromBuffer(SipnetModel *model, const void *buffer,
+                                     size_t size) {
+  RestartState state;
+  initResetState(model, &state);
+
+  readCheckpointBuffer(buffer, size, &state, model->meanNPP);
+  validateLoadedCheckpoint(model, RESTART_MEMORY_NAME, &state);
+}
+
+// Periodic checkpoints
+//
+// Each is written to a temporary file, synced, and renamed into place, after
+// the last is renamed to CHECKPOINT_PREVIOUS_SUFFIX; some complete checkpoint
+// survives the run being killed at any point. Newest first, the files are the
+// temporary one (complete if killed between the sync and the renames), the
+// current one and the previous one.
+//
+// A periodic checkpoint file is a binary checkpoint followed by the lengths of
+// the main and events outputs when it was written (int64 each, -1 for an
+// output not written) and a CRC-32 of those, so that the run that resumes from
+// it can cut the outputs back to where it left them.
+
+static const char *CHECKPOINT_SUFFIXES[] = {
+    CHECKPOINT_TEMP_SUFFIX, CHECKPOINT_SUFFIX, CHECKPOINT_PREVIOUS_SUFFIX};
+#define NUM_CHECKPOINT_FILES 3
+#define CHECKPOINT_PATH_SIZE (FILENAME_MAXLEN + 32)
+#define NUM_CHECKPOINT_OUTPUTS 2
+#define CHECKPOINT_OUTPUTS_SIZE (NUM_CHECKPOINT_OUTPUTS * 8 + 4)
+
+static void checkpointPath(char *path, const char *suffix) {
+  snprintf(path, CHECKPOINT_PATH_SIZE, "%s%s", ctx.filePrefix, suffix);
+}
+
+static void checkpointWriteError(const char *path, const char *temp) {
+  logError("Error writing checkpoint %s: %s\n", path, strerror(errno));
+  remove(temp);
+  exit(EXIT_CODE_FILE_OPEN_OR_READ_ERROR);
+}
+
+// Length of an output once everything written to it so far is on disk, or -1
+// for an output not written
+static long long syncOutputLength(FILE *out, const char *path) {
+  if (out == NULL) {
+    return -1;
+  }
+  long length = -1;
+  if (fflush(out) == 0 && fsync(fileno(out)) == 0) {
+    length = ftell(out);
+  }
+  if (length < 0) {
+    logError("Error writing the outputs before checkpoint %s: %s\n", path,
+             strerror(errno));
+    exit(EXIT_CODE_FILE_OPEN_OR_READ_ERROR);
+  }
+  return length;
+}
+
+static void writePeriodicCheckpoint(SipnetModel *model, FILE *out) {
+  char path[CHECKPOINT_PATH_SIZE];
+  char previous[CHECKPOINT_PATH_SIZE];
+  char temp[CHECKPOINT_PATH_SIZE];
+  checkpointPath(path, CHECKPOINT_SUFFIX);
+  checkpointPath(previous, CHECKPOINT_PREVIOUS_SUFFIX);
+  checkpointPath(temp, CHECKPOINT_TEMP_SUFFIX);
+
+  RestartState state;
+  RestartBuffer buf = {NULL, 0, 0, 0, path};
+  prepareCheckpointState(model, path, &state);
+  encodeBinaryRestartState(&buf, &state, model->meanNPP);
+
+  // The outputs reach the checkpoint's step on disk before the checkpoint does
+  if (model->asyncOut != NULL) {
+    drainAsyncOutput(model->asyncOut);
+  }
+  size_t outputsStart = buf.size;
+  putUInt(&buf, (uint64_t)syncOutputLength(out, path), 8);
+  putUInt(&buf, (uint64_t)syncOutputLength(model->eventOutFile, path), 8);
+  uint32_t outputsCrc =
+      crc32Update(0, buf.data + outputsStart, buf.size - outputsStart);
+  putUInt(&buf, outputsCrc, 4);
+
+  FILE *file = openFile(temp, "wb");
+  if (fwrite(buf.data, 1, buf.size, file) != buf.size || fflush(file) != 0 ||
+      fsync(fileno(file)) != 0) {
+    fclose(file);
+    checkpointWriteError(path, temp);
+  }
+  if (fclose(file) != 0) {
+    checkpointWriteError(path, temp);
+  }
+  free(buf.data);
+
+  if (rename(path, previous) != 0 && errno != ENOENT) {
+    checkpointWriteError(path, temp);
+  }
+  if (rename(temp, path) != 0) {
+    checkpointWriteError(path, temp);
+  }
+  logInfo("Wrote checkpoint %s after year %d day %d\n", path,
+          state.boundaryClimate.year, state.boundaryClimate.day);
+}
+
+void restartPeriodicCheckpoint(SipnetModel *model, FILE *out) {
+  if (model->checkpointEvery == 0) {
+    return;
+  }
+
+  RestartClimateSignature boundary;
+  copyClimateSignature(&boundary, &model->lastProcessedClimateStep);
+  ++model->stepsSinceCheckpoint;
+  if (!isMidnightBoundary(&boundary)) {
+    return;
+  }
+  if (model->checkpointInYears) {
+    int nextYear = boundary.year;
+    int nextDay = boundary.day;
+    advanceOneDay(&nextYear, &nextDay);
+    if (nextYear == boundary.year) {
+      return;
+    }
+    if (++model->yearsSinceCheckpoint < model->checkpointEvery) {
+      return;
+    }
+  } else if (model->stepsSinceCheckpoint < model->checkpointEvery) {
+    return;
+  }
+
+  writePeriodicCheckpoint(model, out);
+  model->stepsSinceCheckpoint = 0;
+  model->yearsSinceCheckpoint = 0;
+}
+
+// Dated checkpoints
+//
+// Each of --restart-dates gets its own checkpoint from the one pass, written
+// as restartWriteCheckpoint() writes the end-of-run one, so its boundary is
+// checked in the same way.
+
+// restart-out expanded for a checkpoint after year and day
+static void restartOutPath(char *path, int year, int day) {
+  if (!formatRestartOut(path, FILENAME_MAXLEN, ctx.restartOut, year, day)) {
+    logError("restart-out %s is too long for a checkpoint after year %d day "
+             "%d\n",
+             ctx.restartOut, year, day);
+    exit(EXIT_CODE_BAD_RESTART_PARAMETER);
+  }
+}
+
+void restartDatedCheckpoint(SipnetModel *model) {
+  if (!model->hasRestartDate) {
+    return;
+  }
+
+  RestartClimateSignature boundary;
+  copyClimateSignature(&boundary, &model->lastProcessedClimateStep);
+  // Dates the climate has moved past without a midnight boundary
+  while (model->hasRestartDate &&
+         ((boundary.year > model->restartDateYear) ||
+          ((boundary.year == model->restartDateYear) &&
+           (boundary.day > model->restartDateDay)))) {
+    logWarning("No restart checkpoint after year %d day %d: no step ends at "
+               "its midnight\n",
+               model->restartDateYear, model->restartDateDay);
+    advanceRestartDate(model);
+  }
+  if (!model->hasRestartDate || (boundary.year != model->restartDateYear) ||
+      (boundary.day != model->restartDateDay) ||
+      !isMidnightBoundary(&boundary)) {
+    return;
+  }
+
+  char path[FILENAME_MAXLEN];
+  restartOutPath(path, boundary.year, boundary.day);
+  restartWriteCheckpoint(model, path);
+  logInfo("Wrote restart checkpoint %s after year %d day %d\n", path,
+          boundary.year, boundary.day);
+  advanceRestartDate(model);
+}
+
+void restartFinishRun(SipnetModel *model) {
+  if (strlen(ctx.restartOut) == 0) {
+    return;
+  }
+  if (strlen(ctx.restartDates) > 0) {
+    while (model->hasRestartDate) {
+      logWarning("No restart checkpoint after year %d day %d: it is after the "
+                 "end of the climate data\n",
+                 model->restartDateYear, model->restartDateDay);
+      advanceRestartDate(model);
+    }
+    return;
+  }
+
+  // prepareCheckpointState() catches a run with no steps
+  char path[FILENAME_MAXLEN];
+  const ClimateNode *last = &model->lastProcessedClimateStep;
+  if (model->hasProcessedClimateStep &&
+      isRestartOutTemplate(ctx.restartOut, ctx.restartDates)) {
+    restartOutPath(path, last->year, last->day);
+  } else {
+    strcpy(path, ctx.restartOut);
+  }
+  restartWriteCheckpoint(model, path);
+}
+
+// Read a whole checkpoint file if it is there; the caller frees the result
+static unsigned char *readCheckpointFile(const char *path, size_t *size) {
+  FILE *in = fopen(path, "rb");
+  if (in == NULL) {
+    return NULL;
+  }
+
+  unsigned char *data = NULL;
+  long fileSize = -1;
+  if (fseek(in, 0, SEEK_END) == 0) {
+    fileSize = ftell(in);
+  }
+  if (fileSize >= 0 && fileSize <= RESTART_BINARY_MAX_SIZE) {
+    *size = (size_t)fileSize;
+    data = (unsigned char *)malloc(*size + 1);
+    rewind(in);
+    if (data != NULL && fread(data, 1, *size, in) != *size) {
+      free(data);
+      data = NULL;
+    }
+  }
+  fclose(in);
+  return data;
+}
+
+// Whether data holds a whole binary checkpoint, as its length and checksum
+// show; what it holds is checked as it is loaded
+static int isIntactBinaryCheckpoint(const unsigned char *data, size_t size) {
+  if (size < RESTART_BINARY_HEADER_SIZE + RESTART_BINARY_TRAILER_SIZE ||
+      memcmp(data, RESTART_BINARY_MAGIC, RESTART_BINARY_MAGIC_SIZE) != 0) {
+    return 0;
+  }
+  RestartBuffer buf = {(unsigned char *)data, size, size,
+                       RESTART_BINARY_HEADER_SIZE - 4, NULL};
+  size_t payloadEnd = size - RESTART_BINARY_TRAILER_SIZE;
+  if (getUInt(&buf, 4) != payloadEnd - RESTART_BINARY_HEADER_SIZE) {
+    return 0;
+  }
+  buf.pos = payloadEnd;
+  return getUInt(&buf, 4) == crc32Update(0, data, payloadEnd);
+}
+
+// Whether data holds a whole periodic checkpoint: an intact binary checkpoint
+// and the lengths of the outputs after it
+static int isIntactPeriodicCheckpoint(const unsigned char *data, size_t size) {
+  if (size < CHECKPOINT_OUTPUTS_SIZE ||
+      !isIntactBinaryCheckpoint(data, size - CHECKPOINT_OUTPUTS_SIZE)) {
+    return 0;
+  }
+  const unsigned char *outputs = data + size - CHECKPOINT_OUTPUTS_SIZE;
+  RestartBuffer buf = {(unsigned char *)data, size, size, size - 4, NULL};
+  return getUInt(&buf, 4) ==
+         crc32Update(0, outputs, CHECKPOINT_OUTPUTS_SIZE - 4);
+}
+
+// Read the newest intact periodic checkpoint, and set path to its file; NULL
+// if there is none. The caller frees the result.
+static unsigned char *readNewestCheckpoint(char *path, size_t *size,
+                                           int warnSkipped) {
+  for (int ind = 0; ind < NUM_CHECKPOINT_FILES; ++ind) {
+    checkpointPath(path, CHECKPOINT_SUFFIXES[ind]);
+    unsigned char *data = readCheckpointFile(path, size);
+    if (data == NULL) {
+      continue;
+    }
+    if (isIntactPeriodicCheckpoint(data, *size)) {
+      return data;
+    }
+    if (warnSkipped) {
+      logWarning("Skipping checkpoint %s: it is incomplete or corrupt\n",
+                 path);
+    }
+    free(data);
+  }
+  return NULL;
+}
+
+// Cut an output back to length, the length it had when checkpoint was written
+static void truncateOutput(const char *output, long long length,
+                           const char *checkpoint) {
+  if (length < 0) {
+    logError("Can't resume from checkpoint %s: %s was not written by the run "
+             "that wrote it\n",
+             checkpoint, output);
+    exit(EXIT_CODE_BAD_RESTART_PARAMETER);
+  }
+  long long size = -1;
+  FILE *file = fopen(output, "rb");
+  if (file != NULL) {
+    if (fseek(file, 0, SEEK_END) == 0) {
+      size = ftell(file);
+    }
+    fclose(file);
+  }
+  if (size < length) {
+    logError("Can't resume from checkpoint %s: %s is missing, or shorter than "
+             "when the checkpoint was written\n",
+             checkpoint, output);
+    exit(EXIT_CODE_BAD_RESTART_PARAMETER);
+  }
+  if (truncate(output, (off_t)length) != 0) {
+    logError("Error truncating %s to checkpoint %s: %s\n", output, checkpoint,
+             strerror(errno));
+    exit(EXIT_CODE_FILE_OPEN_OR_READ_ERROR);
+  }
+}
+
+int restartTruncateOutputs(const char *outFile, const char *eventsOutFile) {
+  char path[CHECKPOINT_PATH_SIZE];
+  size_t size;
+  unsigned char *data = readNewestCheckpoint(path, &size, 0);
+  if (data == NULL) {
+    return 0;
+  }
+
+  const char *outputs[NUM_CHECKPOINT_OUTPUTS] = {outFile, eventsOutFile};
+  RestartBuffer buf = {data, size, size, size - CHECKPOINT_OUTPUTS_SIZE, path};
+  for (int ind = 0; ind < NUM_CHECKPOINT_OUTPUTS; ++ind) {
+    long long length = (long long)getUInt(&buf, 8);
+    if (outputs[ind] != NULL) {
+      truncateOutput(outputs[ind], length, path);
+    }
+  }
+  free(data);
+  return 1;
+}
+
+// Load a checkpoint written during an earlier run over the same climate
+// record, and move on to the climate step after it
+static void resumeFromCheckpoint(SipnetModel *model, const char *path,
+                                 unsigned char *data, size_t size) {
+  RestartState state;
+  RestartBuffer buf = {data, size, size, 0, path};
+  initResetState(model, &state);
+  decodeBinaryRestartState(&buf, &state, model->meanNPP);
+
+  while (model->climate != NULL &&
+         !climateTimestampIsAfterBoundary(model->climate,
+                                          &state.boundaryClimate)) {
+    setClimateStep(model, model->climateStep + 1);
+  }
+  if (model->climate == NULL) {
+    // The run had finished; check the checkpoint all the same
+    validateCheckpointBoundaryForLoad(path, &state.boundaryClimate);
+    checkRestartContextCompatibility(&state.modelFlags);
+    validateRestartModelBuild(&state);
+    logInfo("Checkpoint %s is at the end of the climate data; nothing left to "
+            "run\n",
+            path);
+    return;
+  }
+  skipEventsBefore(model, model->climate->year, model->climate->day);
+  validateLoadedCheckpoint(model, path, &state);
+  logInfo("Resuming from checkpoint %s at year %d day %d\n", path,
+          model->climate->year, model->climate->day);
+}
+
+int restartAutoResume(SipnetModel *model) {
+  char path[CHECKPOINT_PATH_SIZE];
+  size_t size;
+  unsigned char *data = readNewestCheckpoint(path, &size, 1);
+  if (data == NULL) {
+    logInfo("No checkpoint to resume from; starting from the beginning\n");
+    return 0;
+  }
+  resumeFromCheckpoint(model, path, data, size - CHECKPOINT_OUTPUTS_SIZE);
+  free(data);
+  return 1;
 }
@@ -1,15 +1,120 @@
 #ifndef SIPNET_RESTART_H
 #define SIPNET_RESTART_H
 
-#include "runmean.h"
+#include <stddef.h>
+#include <stdio.h>
+
 #include "state.h"
 
-void restartResetRunState(void);
+// Checkpoints are written as text key/value lines, or in a binary format with
+// a CRC-32 that is faster to read and write (see restart.c). --restart-format
+// chooses the format written; with "auto", a path ending in this extension is
+// written as binary. Either format is read, as the file's header shows.
+#define RESTART_BINARY_EXTENSION ".restartb"
+
+// With --checkpoint-every, checkpoints are written periodically during a run
+// to <file-prefix> plus CHECKPOINT_SUFFIX, always in binary, for a killed run
+// to resume from with --auto-resume. The last one is kept with
+// CHECKPOINT_PREVIOUS_SUFFIX until its replacement, first written with
+// CHECKPOINT_TEMP_SUFFIX, is complete.
+#define CHECKPOINT_SUFFIX ".checkpoint"
+#define CHECKPOINT_PREVIOUS_SUFFIX ".checkpoint.prev"
+#define CHECKPOINT_TEMP_SUFFIX ".checkpoint.tmp"
+
+void restartResetRunState(SipnetModel *model);
+
+void restartNoteProcessedClimateStep(SipnetModel *model,
+                                     const ClimateNode *climateStep);
+
+/*!
+ * Write a periodic checkpoint if one is due after the step just processed
+ *
+ * Called after restartNoteProcessedClimateStep(). With --checkpoint-every
+ * <n>steps, one is due at the first midnight boundary (the boundary
+ * restartWriteCheckpoint() expects) after n steps; with <n>years, at every
+ * nth year end. The main and events outputs are flushed to disk first, and
+ * their lengths kept with the checkpoint for restartTruncateOutputs().
+ *
+ * @param out main output file, or NULL if there is none
+ */
+void restartPeriodicCheckpoint(SipnetModel *model, FILE *out);
+
+/*!
+ * Write a restart-out checkpoint if one of --restart-dates ends with the step
+ * just processed
+ *
+ * Called after restartNoteProcessedClimateStep(). The checkpoint for a date is
+ * written after the date's step at a midnight boundary, to --restart-out with
+ * the date filled in (see formatRestartOut()); a date with no such step is
+ * warned about and skipped.
+ */
+void restartDatedCheckpoint(SipnetModel *model);
+
+/*!
+ * Finish restart-out checkpoints at the end of a run: without --restart-dates,
+ * write the checkpoint after the last step; with them, warn about any dates
+ * after the end of the climate data
+ */
+void restartFinishRun(SipnetModel *model);
+
+/*!
+ * Cut the main and events outputs of the run being resumed back to where they
+ * were when the checkpoint restartAutoResume() will resume from was written
+ *
+ * For --auto-resume, before the outputs are opened; when there is a
+ * checkpoint, set model->continueOutputs from the result, so that they are
+ * appended to. Exits if an output is shorter than when the checkpoint was
+ * written, as the rows before the checkpoint would then be missing.
+ *
+ * @param outFile main output file, or NULL if there is none
+ * @param eventsOutFile events output file, or NULL if there is none
+ * @return nonzero if there is a checkpoint to resume from
+ */
+int restartTruncateOutputs(const char *outFile, const char *eventsOutFile);
+
+/*!
+ * Load the newest complete periodic checkpoint, if there is one, and move the
+ * model's climate on to the step after it
+ *
+ * For --auto-resume, after setupModel() and setupEvents(), over the same
+ * climate and events as the run that wrote the checkpoint. Checkpoints that
+ * are incomplete or corrupt are skipped; one that is complete is checked as
+ * restartLoadCheckpoint() checks one.
+ *
+ * @return nonzero if a checkpoint was loaded
+ */
+int restartAutoResume(SipnetModel *model);
+
+void restartWriteCheckpoint(SipnetModel *model, const char *restartOut);
 
-void restartNoteProcessedClimateStep(const ClimateNode *climateStep);
+void restartLoadCheckpoint(SipnetModel *model, const char *restartIn);
 
-void restartWriteCheckpoint(const char *restartOut, MeanTracker *meanNPP);
+/*!
+ * Write a checkpoint of the model's state to memory rather than a file
+ *
+ * The checkpoint is binary unless --restart-format is text, and holds the
+ * same fields as restartWriteCheckpoint() writes. Like snprintf(), it is only
+ * copied to buffer if it fits, so a caller can pass a NULL buffer first to
+ * find the size needed.
+ *
+ * @param model model that has processed at least one climate step
+ * @param buffer where to copy the checkpoint; may be NULL
+ * @param capacity size of buffer in bytes
+ * @return size of the checkpoint in bytes
+ */
+size_t restartWriteCheckpointToBuffer(SipnetModel *model, void *buffer,
+                                      size_t capacity);
 
-void restartLoadCheckpoint(const char *restartIn, MeanTracker *meanNPP);
+/*!
+ * Load a checkpoint held in memory, binary or text, as restartLoadCheckpoint()
+ * loads one from a file; it is checked in the same ways
+ *
+ * @param model model set up to run its next climate segment
+ * @param buffer checkpoint from restartWriteCheckpointToBuffer(), or the
+ *               contents of a checkpoint file
+ * @param size size of the checkpoint in bytes
+ */
+void restartLoadCheckpointFromBuffer(SipnetModel *model, const void *buffer,
+                                     size_t size);
 
 #endif  // SIPNET_RESTART_H
@@ -0,0 +1,217 @@
+// Run management scenarios that branch from a shared baseline run
+
+#include "scenario.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/context.h"
+#include "common/exitCodes.h"
+#include "common/logging.h"
+#include "common/modelParams.h"
+#include "common/util.h"
+
+#include "climate.h"
+#include "compressedOutput.h"
+#include "events.h"
+#include "model.h"
+#include "outputItems.h"
+#include "restart.h"
+#include "sipnet.h"
+#include "workPool.h"
+
+#define SCENARIO_EVENTS_IN_SUFFIX ".events.in"
+#define SCENARIO_EVENTS_OUT_SUFFIX ".events.out"
+
+typedef struct ScenarioRun {
+  // File prefix of each branch, as listed in the scenario file
+  char (*branches)[FILENAME_MAXLEN];
+  int numBranches;
+
+  const char *paramFile;
+  // Climate data after the branch date, shared read-only by all branches
+  ClimateData *branchClimate;
+  // The baseline's state at the branch date, as an in-memory checkpoint
+  void *checkpoint;
+  size_t checkpointSize;
+
+  // Serializes model setup, as parameter and event file parsing is not
+  // thread-safe
+  pthread_mutex_t lock;
+} ScenarioRun;
+
+// Index of the first step after branchDay of branchYear; exits unless there
+// are steps on both sides
+static long findBranchStep(const ClimateData *climate, int branchYear,
+                           int branchDay) {
+  long step = 0;
+  while (step < climate->numSteps &&
+         (climate->year[step] < branchYear ||
+          (climate->year[step] == branchYear &&
+           climate->day[step] <= branchDay))) {
+    ++step;
+  }
+  if (step == 0 || step == climate->numSteps) {
+    logError("scenario-date %d-%d must be within the climate data, before its "
+             "last day\n",
+             branchYear, branchDay);
+    exit(EXIT_CODE_BAD_PARAMETER_VALUE);
+  }
+  return step;
+}
+
+// Run the baseline over its climate with the usual inputs and outputs, and
+// keep its state at the end in run->checkpoint
+static void runBaseline(ScenarioRun *run, ClimateData *baselineClimate) {
+  ModelParams *modelParams;
+  OutputItems *outputItems = NULL;
+  FILE *out = NULL;
+  char outFile[FILENAME_MAXLEN];
+
+  SipnetModel *model = newSipnetModel();
+  initModelWithClimate(model, &modelParams, run->paramFile, baselineClimate);
+  initEvents(model, ctx.eventsInFile, ctx.eventsOutFile, ctx.printHeader);
+  if (isFirstEventBefore(model, baselineClimate->year[0],
+                         baselineClimate->day[0])) {
+    logError("First event occurs before the start of the climate file; please "
+             "fix and rerun\n");
+    exit(EXIT_CODE_INPUT_FILE_ERROR);
+  }
+  if (ctx.doSingleOutputs) {
+    outputItems = newOutputItems(ctx.filePrefix, ' ');
+    setupOutputItems(model, outputItems);
+  }
+  if (ctx.doMainOutput) {
+    snprintf(outFile, sizeof(outFile), "%s%s", ctx.filePrefix,
+             mainOutputSuffix());
+    out = openMainOutput(model, outFile);
+  }
+
+  runModelOutput(model, out, NULL, outputItems, ctx.printHeader);
+
+  run->checkpointSize = restartWriteCheckpointToBuffer(model, NULL, 0);
+  run->checkpoint = malloc(run->checkpointSize);
+  if (run->checkpoint == NULL) {
+    logError("memory allocation failure keeping the scenario baseline state\n");
+    exit(EXIT_CODE_INTERNAL_ERROR);
+  }
+  restartWriteCheckpointToBuffer(model, run->checkpoint, run->checkpointSize);
+
+  if (out != NULL) {
+    fclose(out);
+  }
+  if (outputItems != NULL) {
+    deleteOutputItems(outputItems);
+  }
+  cleanupModel(model);
+  deleteSipnetModel(model);
+  deleteModelParams(modelParams);
+}
+
+// Everything a branch owns while it runs
+typedef struct ScenarioBranch {
+  SipnetModel *model;
+  ModelParams *modelParams;
+  OutputItems *outputItems;
+  FILE *out;
+} ScenarioBranch;
+
+// Set up a branch's model and events and open its outputs; the caller holds
+// run->lock
+static void setupScenarioBranch(ScenarioRun *run, int branchIndex,
+                                ScenarioBranch *branch) {
+  const char *prefix = run->branches[branchIndex];
+  char outFile[FILENAME_MAXLEN];
+  char eventsInFile[FILENAME_MAXLEN], eventsOutFile[FILENAME_MAXLEN];
+
+  snprintf(outFile, sizeof(outFile), "%s%s", prefix, mainOutputSuffix());
+  snprintf(eventsInFile, sizeof(eventsInFile), "%s%s", prefix,
+           SCENARIO_EVENTS_IN_SUFFIX);
+  snprintf(eventsOutFile, sizeof(eventsOutFile), "%s%s%s", prefix,
+           SCENARIO_EVENTS_OUT_SUFFIX, outputCompressionSuffix());
+
+  branch->outputItems = NULL;
+  branch->out = NULL;
+  branch->model = newSipnetModel();
+  initModelWithClimate(branch->model, &branch->modelParams, run->paramFile,
+                       run->branchClimate);
+  initEvents(branch->model, eventsInFile, eventsOutFile, ctx.printHeader);
+  if (ctx.doSingleOutputs) {
+    branch->outputItems = newOutputItems(prefix, ' ');
+    setupOutputItems(branch->model, branch->outputItems);
+  }
+  if (ctx.doMainOutput) {
+    branch->out = openMainOutput(branch->model, outFile);
+  }
+}
+
+// Close a branch's outputs and free its model
+static void cleanupScenarioBranch(ScenarioBranch *branch) {
+  if (branch->out != NULL) {
+    fclose(branch->out);
+  }
+  if (branch->outputItems != NULL) {
+    deleteOutputItems(branch->outputItems);
+  }
+  cleanupModel(branch->model);
+  deleteSipnetModel(branch->model);
+  deleteModelParams(branch->modelParams);
+}
+
+// Pool task: resume one branch from the baseline's state
+static void runScenarioBranch(void *arg, int branchIndex) {
+  ScenarioRun *run = (ScenarioRun *)arg;
+  ScenarioBranch branch;
+
+  pthread_mutex_lock(&run->lock);
+  setupScenarioBranch(run, branchIndex, &branch);
+  pthread_mutex_unlock(&run->lock);
+
+  // Events before the branch's first day are skipped here
+  resumeModelOutput(branch.model, run->checkpoint, run->checkpointSize,
+                    branch.out, NULL, branch.outputItems, ctx.printHeader);
+  cleanupScenarioBranch(&branch);
+}
+
+// See scenario.h
+void runScenarios(const char *scenarioFile, const char *paramFile,
+                  const char *climFile, int branchYear, int branchDay,
+                  int numThreads) {
+  ScenarioRun run;
+
+  // Branch file names end with the events output, the longest suffix
+  const size_t maxPrefixLen = FILENAME_MAXLEN -
+                              strlen(SCENARIO_EVENTS_OUT_SUFFIX) -
+                              strlen(outputCompressionSuffix()) - 1;
+  run.branches = readPrefixList(scenarioFile, "scenario", maxPrefixLen,
+                                &run.numBranches);
+  run.paramFile = paramFile;
+
+  // The baseline and the branches each see their part of one copy of the
+  // climate data
+  ClimateData *climate = readClimate(climFile);
+  long branchStep = findBranchStep(climate, branchYear, branchDay);
+  ClimateData *baselineClimate = newClimateView(climate, 0, branchStep);
+  run.branchClimate = newClimateView(climate, branchStep,
+                                     climate->numSteps - branchStep);
+
+  logInfo("Running the scenario baseline through year %d day %d\n", branchYear,
+          branchDay);
+  runBaseline(&run, baselineClimate);
+
+  pthread_mutex_init(&run.lock, NULL);
+  numThreads = workPoolThreads(numThreads, run.numBranches);
+  logInfo("Running %d scenarios from the baseline on %d threads\n",
+          run.numBranches, numThreads);
+  runWorkPool(run.numBranches, numThreads, runScenarioBranch, &run,
+              "scenario");
+
+  pthread_mutex_destroy(&run.lock);
+  free(run.checkpoint);
+  freeClimate(run.branchClimate);
+  freeClimate(baselineClimate);
+  freeClimate(climate);
+  free(run.branches);
+}
@@ -0,0 +1,35 @@
+// header file for running management scenarios
+//
+// A scenario tree is a set of runs that share a baseline up to a branch date
+// and then diverge, each with its own events. The baseline is run once, its
+// state at the branch date kept as an in-memory checkpoint (see restart.h),
+// and every branch resumes from that checkpoint on a pool of worker threads.
+
+#ifndef SIPNET_SCENARIO_H
+#define SIPNET_SCENARIO_H
+
+/*!
+ * Run the shared baseline once, then every branch listed in a scenario file
+ * from the baseline's state
+ *
+ * The baseline runs with the usual parameter, events and output files, from
+ * the start of the climate data through branchDay of branchYear. The scenario
+ * file lists one file prefix per line; blank lines and anything after a '!'
+ * are ignored. A branch with prefix P runs over the rest of the climate data
+ * with events read from P.events.in, and writes its output to P.out (and
+ * P.events.out and P.single, when those outputs are turned on). Events in P.events.in before the day after the branch date are
+ * skipped, so a branch can list the baseline's events too.
+ *
+ * @param scenarioFile file listing the branch file prefixes
+ * @param paramFile parameter file shared by the baseline and all branches
+ * @param climFile climate file shared by the baseline and all branches
+ * @param branchYear year of the branch date
+ * @param branchDay day of year of the branch date; the baseline runs through
+ *                  its midnight
+ * @param numThreads number of worker threads; 0 for one per online CPU
+ */
+void runScenarios(const char *scenarioFile, const char *paramFile,
+                  const char *climFile, int branchYear, int branchDay,
+                  int numThreads);
+
+#endif  // SIPNET_SCENARIO_H
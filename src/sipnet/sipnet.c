@@ -13,22 +13,31 @@
 #include <string.h>
 #include <stdlib.h>
 #include <math.h>
+#include <pthread.h>
 
 #include "common/context.h"
 #include "common/exitCodes.h"
 #include "common/logging.h"
+#include "common/numFormat.h"
 #include "common/util.h"
 
 #include "sipnet.h"
+#include "asyncOutput.h"
 #include "balance.h"
+#include "binaryOutput.h"
+#include "climate.h"
+#include "compressedOutput.h"
 #include "depeffects.h"
 #include "events.h"
+#include "forcing.h"
 #include "limitations.h"
 #include "nitrogen.h"
 #include "outputItems.h"
+#include "outputPeriod.h"
 #include "restart.h"
 #include "runmean.h"
-#include "state.h"
+#include "varRegistry.h"
+#include "model.h"
 
 #define C_WEIGHT 12.0  // molecular weight of carbon
 // #define TEN_6 1000000.0  // for conversions from micro
@@ -102,178 +111,26 @@
 //   - This paper details the now-removed MODIS and fAPAR tracking, if we want
 //   to bring those back at some point
 
-// more global variables:
-// these are global to increase efficiency (avoid lots of parameter passing)
-
-// running mean of NPP over some fixed time
-// (stored in g C * m^-2 * day^-1)
-static MeanTracker *meanNPP;
-
 //
 // Infrastructure and I/O functions
 //
 
 /*!
- * Read climate file into linked list
+ * Read climate file into this model's own climate data
  *
- * Each line of the climate file represents one time step, with the following
- * format:
- *    year day time intervalLength tair tsoil par precip vpd vpdSoil vPress wspd
- soilWetness
- *
- * NOTE: there should be NO blank lines in the file.
-
  * @param climFile Name of climate file
  */
-void readClimData(const char *climFile) {
-  FILE *in;
-  ClimateNode *curr, *next;
-  int year, day;
-  double time, length;  // time in hours, length in days (or fraction of day)
-  double tair, tsoil, par, precip, vpd, vpdSoil, vPress, wspd, soilWetness;
-
-  double thisGdd;  // growing degree days contributed by this time step
-
-  int status;  // status of the read
-
-  // for format check
-  int firstLoc, dummyLoc, numFields;
-  int expectedNumCols;
-  int legacyFormat;
-  char *firstLine = NULL;
-  size_t lineCap = 0;
-  const char *SEPARATORS = " \t\n\r";  // characters that can separate values in
-                                       // parameter files
-
-  in = openFile(climFile, "r");
-
-  // Check format of first line to see if location is still specified (we will
-  // ignore it if so)
-  if (getline(&firstLine, &lineCap, in) == -1) {  // EOF
-    logError("no climate data in %s\n", climFile);
-    exit(EXIT_CODE_INPUT_FILE_ERROR);
-  }
-
-  numFields = countFields(firstLine, SEPARATORS);
-  switch (numFields) {
-    case NUM_CLIM_FILE_COLS:
-      // Standard format
-      expectedNumCols = NUM_CLIM_FILE_COLS;
-      legacyFormat = 0;
-      break;
-    case NUM_CLIM_FILE_COLS_LEGACY:
-      expectedNumCols = NUM_CLIM_FILE_COLS_LEGACY;
-      legacyFormat = 1;
-      logInfo("old climate file format detected (found %d cols); ignoring "
-              "location and soilWetness columns in %s\n",
-              numFields, climFile);
-      break;
-    default:
-      // Unrecognized format
-      logError("format unrecognized in climate file %s; %d columns found, "
-               "expected %d or %d (legacy format)\n",
-               climFile, numFields, NUM_CLIM_FILE_COLS,
-               NUM_CLIM_FILE_COLS_LEGACY);
-      exit(EXIT_CODE_INPUT_FILE_ERROR);
-  }
-
-  if (legacyFormat) {
-    status = sscanf(firstLine,  // NOLINT
-                    "%d %d %d %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf",
-                    &firstLoc, &year, &day, &time, &length, &tair, &tsoil, &par,
-                    &precip, &vpd, &vpdSoil, &vPress, &wspd, &soilWetness);
+void readClimData(SipnetModel *model, const char *climFile) {
+  model->sharedClimate = 0;
+  model->climateChunkStart = 0;
+  if (ctx.climateStream) {
+    model->climateStream =
+        openClimateStream(climFile, CLIMATE_STREAM_CHUNK_STEPS);
+    model->climateData = nextClimateChunk(model->climateStream);
   } else {
-    status = sscanf(firstLine,  // NOLINT
-                    "%d %d %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf", &year,
-                    &day, &time, &length, &tair, &tsoil, &par, &precip, &vpd,
-                    &vpdSoil, &vPress, &wspd);
+    model->climateStream = NULL;
+    model->climateData = readClimate(climFile);
   }
-  free(firstLine);
-
-  if (status != expectedNumCols) {
-    logError("while reading climate file: bad data on first line\n");
-    exit(EXIT_CODE_INPUT_FILE_ERROR);
-  }
-
-  firstClimate = (ClimateNode *)malloc(sizeof(ClimateNode));
-  next = firstClimate;
-
-  while (status != EOF) {
-    // we have another day's climate
-    curr = next;
-
-    curr->year = year;
-    curr->day = day;
-    curr->time = time;
-
-    if (length < 0) {  // parse as seconds
-      length = length / -86400.;  // convert to days
-    }
-    curr->length = length;
-
-    curr->tair = tair;
-    curr->tsoil = tsoil;
-    curr->par = par * (1.0 / length);
-    // convert par from Einsteins * m^-2 to Einsteins * m^-2 * day^-1
-    curr->precip = precip * 0.1;  // convert from mm to cm
-    curr->vpd = vpd * 0.001;  // convert from Pa to kPa
-    if (curr->vpd < TINY) {
-      curr->vpd = TINY;  // avoid divide by zero
-    }
-    curr->vpdSoil = vpdSoil * 0.001;  // convert from Pa to kPa
-    curr->vPress = vPress * 0.001;  // convert from Pa to kPa
-    curr->wspd = wspd;
-    if (curr->wspd < TINY) {
-      curr->wspd = TINY;  // avoid divide by zero
-    }
-
-    if (ctx.gdd) {
-      thisGdd = tair * length;
-      if (thisGdd < 0) {  // can't have negative growing degree days
-        thisGdd = 0;
-      }
-      curr->gdd = thisGdd;
-    } else {
-      curr->gdd = 0.0;
-    }
-
-    if (legacyFormat) {
-      status =
-          fscanf(in,  // NOLINT
-                 "%d %d %d %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf",
-                 &dummyLoc, &year, &day, &time, &length, &tair, &tsoil, &par,
-                 &precip, &vpd, &vpdSoil, &vPress, &wspd, &soilWetness);
-    } else {
-      status = fscanf(in,  // NOLINT
-                      "%d %d %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf", &year,
-                      &day, &time, &length, &tair, &tsoil, &par, &precip, &vpd,
-                      &vpdSoil, &vPress, &wspd);
-    }
-    if (status != EOF) {
-      if (status != expectedNumCols) {
-        logError("while reading climate file: bad data near year %d day %d\n",
-                 year, day);
-        exit(EXIT_CODE_INPUT_FILE_ERROR);
-      }
-      // Check for older file with multiple locations - that's an error now
-      if (legacyFormat && (dummyLoc != firstLoc)) {
-        logError("while reading legacy climate file %s: multiple locations "
-                 "not supported (locations found: %d and %d)\n",
-                 climFile, firstLoc, dummyLoc);
-        exit(EXIT_CODE_INPUT_FILE_ERROR);
-      }
-
-      // add a new climate node at end of linked list
-      next = (ClimateNode *)malloc(sizeof(ClimateNode));
-      curr->nextClim = next;
-      // set this down here rather than at top of loop so head treated the
-      // same as rest of list
-    } else {  // status == EOF - no more records
-      curr->nextClim = NULL;  // terminate this last linked list
-    }
-  }  // end while
-
-  fclose(in);
 }
 
 /*!
@@ -287,7 +144,8 @@ void readClimData(const char *climFile) {
  * @param modelParamsPtr ModelParams struct, will be alloc'd here
  * @param paramFile Name of parameter file
  */
-void readParamData(ModelParams **modelParamsPtr, const char *paramFile) {
+void readParamData(SipnetModel *model, ModelParams **modelParamsPtr,
+                   const char *paramFile) {
   FILE *paramF;
   ModelParams *modelParams;
   paramF = openFile(paramFile, "r");
@@ -297,103 +155,103 @@ void readParamData(ModelParams **modelParamsPtr, const char *paramFile) {
 
   // clang-format off
   // NOLINTBEGIN
-  initializeOneModelParam(modelParams, "plantWoodInit", &(params.plantWoodInit), 1);
-  initializeOneModelParam(modelParams, "laiInit", &(params.laiInit), 1);
-  initializeOneModelParam(modelParams, "litterInit", &(params.litterInit), 1);
-  initializeOneModelParam(modelParams, "soilInit", &(params.soilInit), 1);
-  initializeOneModelParam(modelParams, "soilWFracInit", &(params.soilWFracInit), 1);
-  initializeOneModelParam(modelParams, "snowInit", &(params.snowInit), 1);
-  initializeOneModelParam(modelParams, "aMax", &(params.aMax), 1);
-  initializeOneModelParam(modelParams, "aMaxFrac", &(params.aMaxFrac), 1);
-  initializeOneModelParam(modelParams, "baseFolRespFrac", &(params.baseFolRespFrac), 1);
-
-  initializeOneModelParam(modelParams, "psnTMin", &(params.psnTMin), 1);
-  initializeOneModelParam(modelParams, "psnTOpt", &(params.psnTOpt), 1);
-  initializeOneModelParam(modelParams, "vegRespQ10", &(params.vegRespQ10), 1);
-  initializeOneModelParam(modelParams, "growthRespFrac", &(params.growthRespFrac), ctx.growthResp);
-  initializeOneModelParam(modelParams, "frozenSoilFolREff", &(params.frozenSoilFolREff), 1);
-  initializeOneModelParam(modelParams, "frozenSoilThreshold", &(params.frozenSoilThreshold), 1);
-  initializeOneModelParam(modelParams, "dVpdSlope", &(params.dVpdSlope), 1);
-  initializeOneModelParam(modelParams, "dVpdExp", &(params.dVpdExp), 1);
-  initializeOneModelParam(modelParams, "halfSatPar", &(params.halfSatPar), 1);
-  initializeOneModelParam(modelParams, "attenuation", &(params.attenuation), 1);
-
-  initializeOneModelParam(modelParams, "leafOnDay", &(params.leafOnDay), !((ctx.gdd) || (ctx.soilPhenol)));
-  initializeOneModelParam(modelParams, "gddLeafOn", &(params.gddLeafOn), ctx.gdd);
-  initializeOneModelParam(modelParams, "soilTempLeafOn", &(params.soilTempLeafOn), ctx.soilPhenol);
-  initializeOneModelParam(modelParams, "leafOffDay", &(params.leafOffDay), 1);
-  initializeOneModelParam(modelParams, "leafGrowth", &(params.leafGrowth), 1);
-  initializeOneModelParam(modelParams, "fracLeafFall", &(params.fracLeafFall), 1);
-  initializeOneModelParam(modelParams, "leafAllocation", &(params.leafAllocation), 1);
-  initializeOneModelParam(modelParams, "leafTurnoverRate", &(params.leafTurnoverRate), 1);
-  initializeOneModelParam(modelParams, "baseVegResp", &(params.baseVegResp), 1);
-  initializeOneModelParam(modelParams, "litterBreakdownRate", &(params.litterBreakdownRate), ctx.litterPool);
-
-  initializeOneModelParam(modelParams, "fracLitterRespired", &(params.fracLitterRespired), ctx.litterPool);
-  initializeOneModelParam(modelParams, "baseSoilResp", &(params.baseSoilResp), 1);
-  initializeOneModelParam(modelParams, "soilRespQ10", &(params.soilRespQ10), 1);
-
-  initializeOneModelParam(modelParams, "soilRespMoistEffect", &(params.soilRespMoistEffect), ctx.waterHResp);
-  initializeOneModelParam(modelParams, "waterRemoveFrac", &(params.waterRemoveFrac), 1);
-  initializeOneModelParam(modelParams, "frozenSoilEff", &(params.frozenSoilEff), 1);
-  initializeOneModelParam(modelParams, "wueConst", &(params.wueConst), 1);
-  initializeOneModelParam(modelParams, "soilWHC", &(params.soilWHC), 1);
-  initializeOneModelParam(modelParams, "immedEvapFrac", &(params.immedEvapFrac), 1);
-  initializeOneModelParam(modelParams, "fastFlowFrac", &(params.fastFlowFrac), 1);
-  initializeOneModelParam(modelParams, "leafPoolDepth", &(params.leafPoolDepth), ctx.leafWater);
-
-  initializeOneModelParam(modelParams, "snowMelt", &(params.snowMelt), ctx.snow);
-  initializeOneModelParam(modelParams, "rdConst", &(params.rdConst), 1);
-  initializeOneModelParam(modelParams, "rSoilConst1", &(params.rSoilConst1), 1);
-  initializeOneModelParam(modelParams, "rSoilConst2", &(params.rSoilConst2), 1);
-  initializeOneModelParam(modelParams, "leafCSpWt", &(params.leafCSpWt), 1);
-  initializeOneModelParam(modelParams, "cFracLeaf", &(params.cFracLeaf), 1);
-  initializeOneModelParam(modelParams, "woodTurnoverRate", &(params.woodTurnoverRate), 1);
-
-  initializeOneModelParam(modelParams, "fineRootFrac", &(params.fineRootFrac), 1);
-  initializeOneModelParam(modelParams, "coarseRootFrac", &(params.coarseRootFrac), 1);
-
-  initializeOneModelParam(modelParams, "fineRootAllocation", &(params.fineRootAllocation), 1);
-  initializeOneModelParam(modelParams, "woodAllocation", &(params.woodAllocation), 1);
-
-  initializeOneModelParam(modelParams, "fineRootTurnoverRate", &(params.fineRootTurnoverRate), 1);
-  initializeOneModelParam(modelParams, "coarseRootTurnoverRate", &(params.coarseRootTurnoverRate), 1);
-  initializeOneModelParam(modelParams, "baseFineRootResp", &(params.baseFineRootResp), 1);
-  initializeOneModelParam(modelParams, "baseCoarseRootResp", &(params.baseCoarseRootResp), 1);
-  initializeOneModelParam(modelParams, "fineRootQ10", &(params.fineRootQ10), 1);
-  initializeOneModelParam(modelParams, "coarseRootQ10", &(params.coarseRootQ10), 1);
+  initializeOneModelParam(modelParams, "plantWoodInit", &(model->params.plantWoodInit), 1);
+  initializeOneModelParam(modelParams, "laiInit", &(model->params.laiInit), 1);
+  initializeOneModelParam(modelParams, "litterInit", &(model->params.litterInit), 1);
+  initializeOneModelParam(modelParams, "soilInit", &(model->params.soilInit), 1);
+  initializeOneModelParam(modelParams, "soilWFracInit", &(model->params.soilWFracInit), 1);
+  initializeOneModelParam(modelParams, "snowInit", &(model->params.snowInit), 1);
+  initializeOneModelParam(modelParams, "aMax", &(model->params.aMax), 1);
+  initializeOneModelParam(modelParams, "aMaxFrac", &(model->params.aMaxFrac), 1);
+  initializeOneModelParam(modelParams, "baseFolRespFrac", &(model->params.baseFolRespFrac), 1);
+
+  initializeOneModelParam(modelParams, "psnTMin", &(model->params.psnTMin), 1);
+  initializeOneModelParam(modelParams, "psnTOpt", &(model->params.psnTOpt), 1);
+  initializeOneModelParam(modelParams, "vegRespQ10", &(model->params.vegRespQ10), 1);
+  initializeOneModelParam(modelParams, "growthRespFrac", &(model->params.growthRespFrac), ctx.growthResp);
+  initializeOneModelParam(modelParams, "frozenSoilFolREff", &(model->params.frozenSoilFolREff), 1);
+  initializeOneModelParam(modelParams, "frozenSoilThreshold", &(model->params.frozenSoilThreshold), 1);
+  initializeOneModelParam(modelParams, "dVpdSlope", &(model->params.dVpdSlope), 1);
+  initializeOneModelParam(modelParams, "dVpdExp", &(model->params.dVpdExp), 1);
+  initializeOneModelParam(modelParams, "halfSatPar", &(model->params.halfSatPar), 1);
+  initializeOneModelParam(modelParams, "attenuation", &(model->params.attenuation), 1);
+
+  initializeOneModelParam(modelParams, "leafOnDay", &(model->params.leafOnDay), !((ctx.gdd) || (ctx.soilPhenol)));
+  initializeOneModelParam(modelParams, "gddLeafOn", &(model->params.gddLeafOn), ctx.gdd);
+  initializeOneModelParam(modelParams, "soilTempLeafOn", &(model->params.soilTempLeafOn), ctx.soilPhenol);
+  initializeOneModelParam(modelParams, "leafOffDay", &(model->params.leafOffDay), 1);
+  initializeOneModelParam(modelParams, "leafGrowth", &(model->params.leafGrowth), 1);
+  initializeOneModelParam(modelParams, "fracLeafFall", &(model->params.fracLeafFall), 1);
+  initializeOneModelParam(modelParams, "leafAllocation", &(model->params.leafAllocation), 1);
+  initializeOneModelParam(modelParams, "leafTurnoverRate", &(model->params.leafTurnoverRate), 1);
+  initializeOneModelParam(modelParams, "baseVegResp", &(model->params.baseVegResp), 1);
+  initializeOneModelParam(modelParams, "litterBreakdownRate", &(model->params.litterBreakdownRate), ctx.litterPool);
+
+  initializeOneModelParam(modelParams, "fracLitterRespired", &(model->params.fracLitterRespired), ctx.litterPool);
+  initializeOneModelParam(modelParams, "baseSoilResp", &(model->params.baseSoilResp), 1);
+  initializeOneModelParam(modelParams, "soilRespQ10", &(model->params.soilRespQ10), 1);
+
+  initializeOneModelParam(modelParams, "soilRespMoistEffect", &(model->params.soilRespMoistEffect), ctx.waterHResp);
+  initializeOneModelParam(modelParams, "waterRemoveFrac", &(model->params.waterRemoveFrac), 1);
+  initializeOneModelParam(modelParams, "frozenSoilEff", &(model->params.frozenSoilEff), 1);
+  initializeOneModelParam(modelParams, "wueConst", &(model->params.wueConst), 1);
+  initializeOneModelParam(modelParams, "soilWHC", &(model->params.soilWHC), 1);
+  initializeOneModelParam(modelParams, "immedEvapFrac", &(model->params.immedEvapFrac), 1);
+  initializeOneModelParam(modelParams, "fastFlowFrac", &(model->params.fastFlowFrac), 1);
+  initializeOneModelParam(modelParams, "leafPoolDepth", &(model->params.leafPoolDepth), ctx.leafWater);
+
+  initializeOneModelParam(modelParams, "snowMelt", &(model->params.snowMelt), ctx.snow);
+  initializeOneModelParam(modelParams, "rdConst", &(model->params.rdConst), 1);
+  initializeOneModelParam(modelParams, "rSoilConst1", &(model->params.rSoilConst1), 1);
+  initializeOneModelParam(modelParams, "rSoilConst2", &(model->params.rSoilConst2), 1);
+  initializeOneModelParam(modelParams, "leafCSpWt", &(model->params.leafCSpWt), 1);
+  initializeOneModelParam(modelParams, "cFracLeaf", &(model->params.cFracLeaf), 1);
+  initializeOneModelParam(modelParams, "woodTurnoverRate", &(model->params.woodTurnoverRate), 1);
+
+  initializeOneModelParam(modelParams, "fineRootFrac", &(model->params.fineRootFrac), 1);
+  initializeOneModelParam(modelParams, "coarseRootFrac", &(model->params.coarseRootFrac), 1);
+
+  initializeOneModelParam(modelParams, "fineRootAllocation", &(model->params.fineRootAllocation), 1);
+  initializeOneModelParam(modelParams, "woodAllocation", &(model->params.woodAllocation), 1);
+
+  initializeOneModelParam(modelParams, "fineRootTurnoverRate", &(model->params.fineRootTurnoverRate), 1);
+  initializeOneModelParam(modelParams, "coarseRootTurnoverRate", &(model->params.coarseRootTurnoverRate), 1);
+  initializeOneModelParam(modelParams, "baseFineRootResp", &(model->params.baseFineRootResp), 1);
+  initializeOneModelParam(modelParams, "baseCoarseRootResp", &(model->params.baseCoarseRootResp), 1);
+  initializeOneModelParam(modelParams, "fineRootQ10", &(model->params.fineRootQ10), 1);
+  initializeOneModelParam(modelParams, "coarseRootQ10", &(model->params.coarseRootQ10), 1);
 
 
   // Nitrogen cycle params from [5] LeBauer et al. (unpublished)
-  initializeOneModelParam(modelParams, "mineralNInit", &(params.minNInit), ctx.nitrogenCycle);
-  initializeOneModelParam(modelParams, "soilOrgNInit", &(params.soilOrgNInit), ctx.nitrogenCycle);
-  initializeOneModelParam(modelParams, "litterOrgNInit", &(params.litterOrgNInit), ctx.nitrogenCycle);
-  initializeOneModelParam(modelParams, "plantStorageNInit", &(params.plantStorageNInit), ctx.nitrogenCycle);
-  initializeOneModelParam(modelParams, "nVolatilizationFrac", &(params.nVolatilizationFrac), ctx.nitrogenCycle);
-  initializeOneModelParam(modelParams, "nLeachingFrac", &(params.nLeachingFrac), ctx.nitrogenCycle);
-  initializeOneModelParam(modelParams, "leafCN", &(params.leafCN), ctx.nitrogenCycle);
-  initializeOneModelParam(modelParams, "woodCN", &(params.woodCN), ctx.nitrogenCycle);
-  initializeOneModelParam(modelParams, "fineRootCN", &(params.fineRootCN), ctx.nitrogenCycle);
-  initializeOneModelParam(modelParams, "kCN", &(params.kCN), ctx.nitrogenCycle);
-  initializeOneModelParam(modelParams, "nFixationFracMax", &(params.nFixationFracMax), ctx.nitrogenCycle);
-  initializeOneModelParam(modelParams, "halfNFixationMax", &(params.halfNFixationMax), ctx.nitrogenCycle);
-  initializeOneModelParam(modelParams, "leafOnReallocFrac", &(params.leafOnReallocFrac), 1);
-  initializeOneModelParam(modelParams, "leafNResorptionFrac", &(params.leafNResorptionFrac), ctx.nitrogenCycle);
+  initializeOneModelParam(modelParams, "mineralNInit", &(model->params.minNInit), ctx.nitrogenCycle);
+  initializeOneModelParam(modelParams, "soilOrgNInit", &(model->params.soilOrgNInit), ctx.nitrogenCycle);
+  initializeOneModelParam(modelParams, "litterOrgNInit", &(model->params.litterOrgNInit), ctx.nitrogenCycle);
+  initializeOneModelParam(modelParams, "plantStorageNInit", &(model->params.plantStorageNInit), ctx.nitrogenCycle);
+  initializeOneModelParam(modelParams, "nVolatilizationFrac", &(model->params.nVolatilizationFrac), ctx.nitrogenCycle);
+  initializeOneModelParam(modelParams, "nLeachingFrac", &(model->params.nLeachingFrac), ctx.nitrogenCycle);
+  initializeOneModelParam(modelParams, "leafCN", &(model->params.leafCN), ctx.nitrogenCycle);
+  initializeOneModelParam(modelParams, "woodCN", &(model->params.woodCN), ctx.nitrogenCycle);
+  initializeOneModelParam(modelParams, "fineRootCN", &(model->params.fineRootCN), ctx.nitrogenCycle);
+  initializeOneModelParam(modelParams, "kCN", &(model->params.kCN), ctx.nitrogenCycle);
+  initializeOneModelParam(modelParams, "nFixationFracMax", &(model->params.nFixationFracMax), ctx.nitrogenCycle);
+  initializeOneModelParam(modelParams, "halfNFixationMax", &(model->params.halfNFixationMax), ctx.nitrogenCycle);
+  initializeOneModelParam(modelParams, "leafOnReallocFrac", &(model->params.leafOnReallocFrac), 1);
+  initializeOneModelParam(modelParams, "leafNResorptionFrac", &(model->params.leafNResorptionFrac), ctx.nitrogenCycle);
 
   // New moisture dependency params
-  initializeOneModelParam(modelParams, "fAnoxia", &(params.fAnoxia), ctx.anaerobic || ctx.nitrogenCycle);
-  initializeOneModelParam(modelParams, "anaerobicDecompRate", &(params.anaerobicDecompRate), ctx.anaerobic);
+  initializeOneModelParam(modelParams, "fAnoxia", &(model->params.fAnoxia), ctx.anaerobic || ctx.nitrogenCycle);
+  initializeOneModelParam(modelParams, "anaerobicDecompRate", &(model->params.anaerobicDecompRate), ctx.anaerobic);
 
   // Methane
-  initializeOneModelParam(modelParams, "anaerobicTransExp", &(params.anaerobicTransExp), ctx.anaerobic);
-  initializeOneModelParam(modelParams, "soilMethaneRate", &(params.soilMethaneRate), ctx.anaerobic);
-  initializeOneModelParam(modelParams, "litterMethaneRate", &(params.litterMethaneRate), ctx.anaerobic);
+  initializeOneModelParam(modelParams, "anaerobicTransExp", &(model->params.anaerobicTransExp), ctx.anaerobic);
+  initializeOneModelParam(modelParams, "soilMethaneRate", &(model->params.soilMethaneRate), ctx.anaerobic);
+  initializeOneModelParam(modelParams, "litterMethaneRate", &(model->params.litterMethaneRate), ctx.anaerobic);
 
   // Water drainage
-  initializeOneModelParam(modelParams, "waterDrainFrac", &(params.waterDrainFrac), ctx.flooding);
+  initializeOneModelParam(modelParams, "waterDrainFrac", &(model->params.waterDrainFrac), ctx.flooding);
 
   // Soil carbon saturation
-  initializeOneModelParam(modelParams, "soilCSaturation", &(params.soilCSaturation), ctx.carbonSaturation);
+  initializeOneModelParam(modelParams, "soilCSaturation", &(model->params.soilCSaturation), ctx.carbonSaturation);
 
   // NOLINTEND
   // clang-format on
@@ -401,89 +259,518 @@ void readParamData(ModelParams **modelParamsPtr, const char *paramFile) {
   readModelParams(modelParams, paramF);
 
   // Validate parameters that are used as divisors to avoid division-by-zero
-  if (params.cFracLeaf < TINY) {
-    params.cFracLeaf = TINY;  // avoid divide by zero
+  if (model->params.cFracLeaf < TINY) {
+    model->params.cFracLeaf = TINY;  // avoid divide by zero
   }
-  if (params.halfSatPar < TINY) {
-    params.halfSatPar = TINY;  // avoid divide by zero
+  if (model->params.halfSatPar < TINY) {
+    model->params.halfSatPar = TINY;  // avoid divide by zero
   }
-  if (params.soilWHC < TINY) {
-    params.soilWHC = TINY;  // avoid divide by zero
+  if (model->params.soilWHC < TINY) {
+    model->params.soilWHC = TINY;  // avoid divide by zero
   }
-  if (params.leafCSpWt < TINY) {
-    params.leafCSpWt = TINY;  // avoid divide by zero
+  if (model->params.leafCSpWt < TINY) {
+    model->params.leafCSpWt = TINY;  // avoid divide by zero
   }
-  if (params.leafCN < TINY) {
-    params.leafCN = TINY;  // avoid divide by zero
+  if (model->params.leafCN < TINY) {
+    model->params.leafCN = TINY;  // avoid divide by zero
   }
-  if (params.woodCN < TINY) {
-    params.woodCN = TINY;  // avoid divide by zero
+  if (model->params.woodCN < TINY) {
+    model->params.woodCN = TINY;  // avoid divide by zero
   }
-  if (params.fineRootCN < TINY) {
-    params.fineRootCN = TINY;  // avoid divide by zero
+  if (model->params.fineRootCN < TINY) {
+    model->params.fineRootCN = TINY;  // avoid divide by zero
   }
 
   fclose(paramF);
 }
 
-/*!
- * Print header row to output file
- *
- * @param out File pointer for output
- */
-void outputHeader(FILE *out) {
-  fprintf(out, "year day  time plantWoodC plantLeafC woodCreation     ");
-  fprintf(out, "soil coarseRootC fineRootC   ");
-  fprintf(out, "litter  soilWater soilWetnessFrac     snow      ");
-  fprintf(out, "npp      nee   cumNEE      gpp rAboveground    rSoil    "
-               "rRoot       ra       rh     rtot evapotranspiration ");
-  fprintf(out,
-          "fluxestranspiration     minN  soilOrgN    litterN  "
-          "plantStorageN       n2o nLeaching  nFixation  nUptake      ch4  "
-          "nppStorage\n");
+typedef struct OutputColumn {
+  const char *name;
+  // Registry variable written (see varRegistry.h), which also gives the
+  // column's units and how it aggregates over an output period; NULL for
+  // year, day and time
+  const char *variable;
+  // Width and decimals of text output; year and day are integers, and have no
+  // decimals
+  int width;
+  int decimals;
+} OutputColumn;
+
+// Columns of the main output file, in the order outputHeader() names them and
+// getOutputValues() fills them in
+#define NUM_OUTPUT_COLUMNS 35
+#define NUM_LABEL_COLUMNS 3
+#define OUTPUT_YEAR_COLUMN 0
+#define OUTPUT_DAY_COLUMN 1
+// plantWoodC is written as the total wood C, envi.plantWoodC plus the
+// accounting delta
+#define OUTPUT_WOOD_COLUMN 3
+static const OutputColumn outputColumns[NUM_OUTPUT_COLUMNS] = {
+    {"year", NULL, 4, 0},
+    {"day", NULL, 3, 0},
+    {"time", NULL, 5, 2},
+    {"plantWoodC", "envi.plantWoodC", 10, 2},
+    {"plantLeafC", "envi.plantLeafC", 10, 2},
+    {"woodCreation", "trackers.woodCreation", 12, 2},
+    {"soil", "envi.soilC", 8, 2},
+    {"coarseRootC", "envi.coarseRootC", 11, 2},
+    {"fineRootC", "envi.fineRootC", 9, 2},
+    {"litter", "envi.litterC", 8, 2},
+    {"soilWater", "envi.soilWater", 10, 3},
+    {"soilWetnessFrac", "trackers.soilWetnessFrac", 15, 3},
+    {"snow", "envi.snow", 8, 2},
+    {"npp", "trackers.npp", 8, 3},
+    {"nee", "trackers.nee", 8, 3},
+    {"cumNEE", "trackers.totNee", 8, 3},
+    {"gpp", "trackers.gpp", 8, 3},
+    {"rAboveground", "trackers.rAboveground", 12, 3},
+    {"rSoil", "trackers.rSoil", 8, 3},
+    {"rRoot", "trackers.rRoot", 8, 3},
+    {"ra", "trackers.ra", 8, 3},
+    {"rh", "trackers.rh", 8, 3},
+    {"rtot", "trackers.rtot", 8, 3},
+    {"evapotranspiration", "trackers.evapotranspiration", 18, 8},
+    {"fluxestranspiration", "fluxes.transpiration", 19, 4},
+    {"minN", "envi.minN", 8, 4},
+    {"soilOrgN", "envi.soilOrgN", 9, 4},
+    {"litterN", "envi.litterN", 10, 4},
+    {"plantStorageN", "envi.plantStorageN", 14, 4},
+    {"n2o", "trackers.n2o", 9, 6},
+    {"nLeaching", "trackers.nLeaching", 9, 4},
+    {"nFixation", "trackers.nFixation", 10, 4},
+    {"nUptake", "trackers.nUptake", 8, 4},
+    {"ch4", "trackers.methane", 8, 4},
+    {"nppStorage", "envi.plantCAccountingDelta", 12, 4}};
+
+static const char *labelColumnUnits[NUM_LABEL_COLUMNS] = {"year", "day of year",
+                                                          "hour"};
+
+// The registry variables, units and aggregation of the columns, looked up from
+// outputColumns once per process by resolveOutputColumns()
+static const VarInfo *outputColumnVars[NUM_OUTPUT_COLUMNS];
+static const char *outputColumnUnits[NUM_OUTPUT_COLUMNS];
+static OutputColumnKind outputColumnKinds[NUM_OUTPUT_COLUMNS];
+static pthread_once_t outputColumnsOnce = PTHREAD_ONCE_INIT;
+
+static void resolveOutputColumns(void) {
+  for (int col = 0; col < NUM_OUTPUT_COLUMNS; ++col) {
+    if (col < NUM_LABEL_COLUMNS) {
+      outputColumnVars[col] = NULL;
+      outputColumnUnits[col] = labelColumnUnits[col];
+      outputColumnKinds[col] = COLUMN_LABEL;
+    } else {
+      outputColumnVars[col] = requireVariable(outputColumns[col].variable);
+      outputColumnUnits[col] = outputColumnVars[col]->units;
+      outputColumnKinds[col] = outputColumnVars[col]->kind;
+    }
+  }
 }
 
-/*!
- * Print current state values to output file
- * @param out File pointer for output
- * @param year
- * @param day
- * @param time
- */
-void outputState(FILE *out, int year, int day, double time) {
-
-  fprintf(out, "%4d %3d %5.2f %10.2f %10.2f %12.2f ", year, day, time,
-          getTotalWoodC(), envi.plantLeafC, trackers.woodCreation);
-  fprintf(out, "%8.2f ", envi.soilC);
-  fprintf(out, "%11.2f %9.2f ", envi.coarseRootC, envi.fineRootC);
-  fprintf(out, "%8.2f %10.3f %15.3f %8.2f ", envi.litterC, envi.soilWater,
-          trackers.soilWetnessFrac, envi.snow);
-  fprintf(
-      out,
-      "%8.3f %8.3f %8.3f %8.3f %12.3f %8.3f %8.3f %8.3f %8.3f %8.3f %18.8f ",
-      trackers.npp, trackers.nee, trackers.totNee, trackers.gpp,
-      trackers.rAboveground, trackers.rSoil, trackers.rRoot, trackers.ra,
-      trackers.rh, trackers.rtot, trackers.evapotranspiration);
-  fprintf(out, "%19.4f %8.4f %9.4f %10.4f %14.4f ", fluxes.transpiration,
-          envi.minN, envi.soilOrgN, envi.litterN, envi.plantStorageN);
-  fprintf(out, "%9.6f %9.4f %10.4f %8.4f %8.4f", trackers.n2o,
-          trackers.nLeaching, trackers.nFixation, trackers.nUptake,
-          trackers.methane);
-  fprintf(out, "%12.4f\n", envi.plantCAccountingDelta);
-}
-
-// de-allocate space used for climate linked list
-void freeClimateList() {
-  ClimateNode *curr, *prev;
-
-  curr = firstClimate;
-  while (curr != NULL) {
-    prev = curr;
-    curr = curr->nextClim;
-    free(prev);
+// Values for one row of the main output file, in column order
+static void getOutputValues(SipnetModel *model, int year, int day, double time,
+                            double *values) {
+  pthread_once(&outputColumnsOnce, resolveOutputColumns);
+  values[0] = year;
+  values[1] = day;
+  values[2] = time;
+  values[OUTPUT_WOOD_COLUMN] = getTotalWoodC(model);
+  for (int col = OUTPUT_WOOD_COLUMN + 1; col < NUM_OUTPUT_COLUMNS; ++col) {
+    values[col] = getVariableValue(model, outputColumnVars[col]);
+  }
+}
+
+// Index in outputColumns of the ind'th value of a row, given the selected
+// columns (NULL for all)
+static int outputColumn(const int *columns, int ind) {
+  return (columns == NULL) ? ind : columns[ind];
+}
+
+// Whether a space goes before a column of text output, given the column
+// before it (-1 for none)
+static int hasColumnSpace(int col, int prevCol) {
+  // nppStorage has always followed ch4 without a space
+  return (prevCol >= 0) &&
+         !((col == NUM_OUTPUT_COLUMNS - 1) && (prevCol == col - 1));
+}
+
+// See sipnet.h
+void outputHeader(SipnetModel *model, FILE *out) {
+  int numColumns = (model->outputColumns == NULL) ? NUM_OUTPUT_COLUMNS
+                                                  : model->numOutputColumns;
+  char line[NUM_OUTPUT_COLUMNS * (FORMAT_MAX_WIDTH + 1) + 1];
+  char *pos = line;
+  int prevCol = -1;
+
+  // Names are right-aligned over their values
+  for (int ind = 0; ind < numColumns; ++ind) {
+    int col = outputColumn(model->outputColumns, ind);
+    if (hasColumnSpace(col, prevCol)) {
+      *pos++ = ' ';
+    }
+    pos = formatString(pos, outputColumns[col].name, outputColumns[col].width);
+    prevCol = col;
+  }
+  *pos++ = '\n';
+  fwrite(line, 1, pos - line, out);
+}
+
+// Write a row of text output from its values; an AsyncRowWriter. layout is
+// the selected columns, or NULL for all of them.
+static void writeTextStateRow(void *target, const void *layout,
+                              const double *v, int numValues) {
+  FILE *out = (FILE *)target;
+  const int *columns = (const int *)layout;
+  char line[NUM_OUTPUT_COLUMNS * (FORMAT_MAX_LEN + 1)];
+  char *pos = line;
+  int prevCol = -1;
+
+  for (int ind = 0; ind < numValues; ++ind) {
+    int col = outputColumn(columns, ind);
+    if (hasColumnSpace(col, prevCol)) {
+      *pos++ = ' ';
+    }
+    if (col < 2) {
+      // year and day
+      pos = formatInt(pos, (int)v[ind], outputColumns[col].width);
+    } else {
+      pos = formatFixed(pos, v[ind], outputColumns[col].width,
+                        outputColumns[col].decimals);
+    }
+    prevCol = col;
+  }
+  *pos++ = '\n';
+  fwrite(line, 1, pos - line, out);
+}
+
+// Add a row to binary output from its values; an AsyncRowWriter
+static void writeBinaryStateRow(void *target, const void *layout,
+                                const double *v, int numValues) {
+  writeBinaryOutputRow((BinaryOutput *)target, v);
+}
+
+// Add a row to NetCDF output from its values, followed by the length of the
+// row; an AsyncRowWriter
+static void writeNetcdfStateRow(void *target, const void *layout,
+                                const double *v, int numValues) {
+  writeNetcdfOutputRow((NetcdfOutput *)target, v, v[numValues - 1]);
+}
+
+// Write a row of the main output from the values of all its columns; isPeriod
+// is set for rows of an aggregation period, rather than of the current step
+static void writeOutputRow(SipnetModel *model, FILE *out, const double *all,
+                           int isPeriod) {
+  AsyncRowWriter writer = writeTextStateRow;
+  void *target = out;
+  const int *columns = model->outputColumns;
+  int numValues = (columns == NULL) ? NUM_OUTPUT_COLUMNS
+                                    : model->numOutputColumns;
+  int numWritten = numValues;
+  double selected[NUM_OUTPUT_COLUMNS + 1];
+  double *v = selected;
+
+  if (model->binaryOut != NULL) {
+    writer = writeBinaryStateRow;
+    target = model->binaryOut;
+  } else if (model->netcdfOut != NULL) {
+    // NetCDF converts amounts over the row to rates, so it also gets the length
+    writer = writeNetcdfStateRow;
+    target = model->netcdfOut;
+    numWritten = numValues + 1;
+  }
+  if (model->asyncOut != NULL) {
+    v = reserveAsyncRow(model->asyncOut, writer, target, columns, numWritten);
+  }
+  // Only the selected columns are queued or written
+  for (int ind = 0; ind < numValues; ++ind) {
+    v[ind] = all[outputColumn(columns, ind)];
+  }
+  if (numWritten > numValues) {
+    // Length of the row, in days
+    v[numValues] = isPeriod ? getOutputPeriodLength(model->outputPeriod)
+                            : model->climate->length;
+  }
+  if (model->asyncOut == NULL) {
+    writer(target, columns, v, numWritten);
   }
 }
 
+// See sipnet.h
+void outputState(SipnetModel *model, FILE *out, int year, int day,
+                 double time) {
+  double all[NUM_OUTPUT_COLUMNS];
+
+  if ((model->outputColumns == NULL) && (model->outputPeriod == NULL) &&
+      (model->netcdfOut == NULL) && (model->asyncOut != NULL)) {
+    // Every value is queued as is, so fill in the queued row directly
+    AsyncRowWriter writer = writeTextStateRow;
+    void *target = out;
+    if (model->binaryOut != NULL) {
+      writer = writeBinaryStateRow;
+      target = model->binaryOut;
+    }
+    getOutputValues(model, year, day, time,
+                    reserveAsyncRow(model->asyncOut, writer, target, NULL,
+                                    NUM_OUTPUT_COLUMNS));
+    return;
+  }
+
+  getOutputValues(model, year, day, time, all);
+  if (model->outputPeriod != NULL) {
+    double row[NUM_OUTPUT_COLUMNS];
+    if (addOutputPeriodStep(model->outputPeriod, all, model->climate->length,
+                            row)) {
+      writeOutputRow(model, out, row, 1);
+    }
+    return;
+  }
+  writeOutputRow(model, out, all, 0);
+}
+
+// See sipnet.h
+void outputItemValues(SipnetModel *model, OutputItems *outputItems) {
+  ClimateNode *climate = model->climate;
+
+  if (model->asyncOut == NULL) {
+    writeOutputItemValues(outputItems, climate->year, climate->day,
+                          climate->time);
+    return;
+  }
+  double *values =
+      reserveAsyncRow(model->asyncOut, writeOutputItemRow, outputItems, NULL,
+                      OUTPUT_ITEMS_LABELS + outputItems->count);
+  getOutputItemValues(outputItems, climate->year, climate->day, climate->time,
+                      values);
+}
+
+// Set up model->outputColumns from ctx.outputVars, after checking that every
+// name listed is a column of the main output or a field of the debug logs.
+// year, day and time are always written.
+static void selectOutputColumns(SipnetModel *model) {
+  const char *item = ctx.outputVars;
+  int hasError = 0;
+
+  model->outputColumns = NULL;
+  model->numOutputColumns = NUM_OUTPUT_COLUMNS;
+  if (strlen(ctx.outputVars) == 0) {
+    return;
+  }
+
+  while (*item != '\0') {
+    char name[CONTEXT_CHAR_MAXLEN];
+    size_t len = strcspn(item, ",");
+    int found;
+
+    memcpy(name, item, len);
+    name[len] = '\0';
+    found = (len == 0) || isVariableField(name);
+    for (int col = 0; col < NUM_OUTPUT_COLUMNS && !found; ++col) {
+      found = (strcmp(name, outputColumns[col].name) == 0);
+    }
+    if (!found) {
+      logError("output-vars: %s is not an output variable\n", name);
+      hasError = 1;
+    }
+    item += len;
+    if (*item == ',') {
+      ++item;
+    }
+  }
+  if (hasError) {
+    exit(EXIT_CODE_BAD_PARAMETER_VALUE);
+  }
+
+  model->outputColumns = (int *)malloc(NUM_OUTPUT_COLUMNS * sizeof(int));
+  if (model->outputColumns == NULL) {
+    logError("memory allocation failure selecting output columns\n");
+    exit(EXIT_CODE_INTERNAL_ERROR);
+  }
+  model->numOutputColumns = 0;
+  for (int col = 0; col < NUM_OUTPUT_COLUMNS; ++col) {
+    if ((col < NUM_LABEL_COLUMNS) ||
+        isOutputVar(outputColumns[col].name)) {
+      model->outputColumns[model->numOutputColumns++] = col;
+    }
+  }
+}
+
+// See sipnet.h
+const char *mainOutputSuffix(void) {
+  // NetCDF output has its own compression (see --netcdf-deflate)
+  if (strcmp(ctx.outputFormat, OUTPUT_FORMAT_NETCDF) == 0) {
+    return ".nc";
+  }
+  if (strcmp(ctx.compressOutput, COMPRESS_OUTPUT_GZIP) == 0) {
+    return ".out" GZIP_SUFFIX;
+  }
+  if (strcmp(ctx.compressOutput, COMPRESS_OUTPUT_ZSTD) == 0) {
+    return ".out" ZSTD_SUFFIX;
+  }
+  return ".out";
+}
+
+// See sipnet.h
+FILE *openMainOutput(SipnetModel *model, const char *path) {
+  if (strcmp(ctx.outputFormat, OUTPUT_FORMAT_NETCDF) == 0) {
+    model->netcdfOut = newNetcdfOutput(path);
+    return NULL;
+  }
+  if (model->continueOutputs) {
+    return continueOutputFile(path);
+  }
+  return openOutputFile(path);
+}
+
+// See sipnet.h
+int hasMainOutput(const SipnetModel *model, FILE *out) {
+  return (out != NULL) || (model->netcdfOut != NULL);
+}
+
+// See sipnet.h
+void startMainOutput(SipnetModel *model, FILE *out, int printHeader) {
+  pthread_once(&outputColumnsOnce, resolveOutputColumns);
+  selectOutputColumns(model);
+  model->outputPeriod = NULL;
+  if (!hasMainOutput(model, out)) {
+    return;
+  }
+  if (strcmp(ctx.outputPeriod, OUTPUT_PERIOD_STEP) != 0) {
+    model->outputPeriod =
+        newOutputPeriod(ctx.outputPeriod, outputColumnKinds,
+                        NUM_OUTPUT_COLUMNS, OUTPUT_YEAR_COLUMN,
+                        OUTPUT_DAY_COLUMN);
+  }
+  if (model->netcdfOut != NULL) {
+    NetcdfColumn columns[NUM_OUTPUT_COLUMNS];
+    for (int ind = 0; ind < model->numOutputColumns; ++ind) {
+      int col = outputColumn(model->outputColumns, ind);
+      columns[ind].name = outputColumns[col].name;
+      columns[ind].units = outputColumnUnits[col];
+    }
+    // Times count from the start of the climate record's first year
+    startNetcdfOutput(model->netcdfOut, columns, model->numOutputColumns,
+                      model->climateData->year[0], ctx.netcdfDeflate);
+    return;
+  }
+  if (strcmp(ctx.outputFormat, OUTPUT_FORMAT_TEXT) == 0) {
+    if (printHeader) {
+      outputHeader(model, out);
+    }
+    return;
+  }
+
+  // Binary files always describe their columns; there is no headerless form
+  BinaryColumn columns[NUM_OUTPUT_COLUMNS];
+  BinaryColumnType floatType =
+      (strcmp(ctx.outputFormat, OUTPUT_FORMAT_BINARY32) == 0) ? BINARY_FLOAT32
+                                                              : BINARY_FLOAT64;
+  for (int ind = 0; ind < model->numOutputColumns; ++ind) {
+    int col = outputColumn(model->outputColumns, ind);
+    columns[ind].name = outputColumns[col].name;
+    columns[ind].units = outputColumnUnits[col];
+    columns[ind].type = (col < 2) ? BINARY_INT32 : floatType;
+  }
+  model->binaryOut = newBinaryOutput(out, columns, model->numOutputColumns);
+}
+
+// See sipnet.h
+void finishMainOutput(SipnetModel *model, FILE *out) {
+  if (model->outputPeriod != NULL) {
+    double row[NUM_OUTPUT_COLUMNS];
+    if (finishOutputPeriod(model->outputPeriod, row)) {
+      writeOutputRow(model, out, row, 1);
+    }
+    deleteOutputPeriod(model->outputPeriod);
+    model->outputPeriod = NULL;
+  }
+  if (model->binaryOut != NULL) {
+    closeBinaryOutput(model->binaryOut);
+    model->binaryOut = NULL;
+  }
+  if (model->netcdfOut != NULL) {
+    closeNetcdfOutput(model->netcdfOut);
+    model->netcdfOut = NULL;
+  }
+  free(model->outputColumns);
+  model->outputColumns = NULL;
+}
+
+// de-allocate space used for climate data, unless it is shared with other
+// models
+void freeClimateList(SipnetModel *model) {
+  if (model->climateStream != NULL) {
+    // The stream owns the chunks
+    closeClimateStream(model->climateStream);
+    model->climateStream = NULL;
+  } else if (!model->sharedClimate) {
+    freeClimate(model->climateData);
+  }
+  model->climateData = NULL;
+  model->climate = NULL;
+  freeForcing(model);
+}
+
+// See sipnet.h
+void setClimateStep(SipnetModel *model, long step) {
+  ClimateNode *curr = &model->currentClimate;
+  int newChunk = 0;
+
+  model->climateStep = step;
+  if (model->climateStream != NULL) {
+    // Streams only move forward: move on to the chunk holding this step
+    while ((model->climateData != NULL) &&
+           (step >= model->climateChunkStart + model->climateData->numSteps)) {
+      model->climateChunkStart += model->climateData->numSteps;
+      model->climateData = nextClimateChunk(model->climateStream);
+      newChunk = 1;
+    }
+    if (step < model->climateChunkStart) {
+      logInternalError("climate step %ld has already been streamed past\n",
+                       step);
+      exit(EXIT_CODE_INTERNAL_ERROR);
+    }
+  }
+
+  const ClimateData *data = model->climateData;
+  // Index of this step in the current chunk; chunks only apply to streamed
+  // climate, otherwise the start is always 0
+  step -= model->climateChunkStart;
+  if ((data == NULL) || (step >= data->numSteps)) {
+    model->climate = NULL;
+    return;
+  }
+
+  // setupModel() calculates the forcing; this catches new stream chunks, and
+  // climate data read after setup
+  const ForcingData *forcing = model->forcing;
+  if (newChunk || (forcing == NULL) || (forcing->climateData != data)) {
+    updateForcing(model);
+    forcing = model->forcing;
+  }
+
+  curr->year = data->year[step];
+  curr->day = data->day[step];
+  curr->time = data->time[step];
+  curr->length = data->length[step];
+  curr->tair = data->tair[step];
+  curr->tsoil = data->tsoil[step];
+  curr->par = data->par[step];
+  curr->precip = data->precip[step];
+  curr->vpd = data->vpd[step];
+  curr->vpdSoil = data->vpdSoil[step];
+  curr->vPress = data->vPress[step];
+  curr->wspd = data->wspd[step];
+  curr->gdd = data->gdd[step];
+  curr->dTemp = forcing->dTemp[step];
+  curr->dVpd = forcing->dVpd[step];
+  curr->folRespTempEffect = forcing->folRespTempEffect[step];
+  curr->woodRespTempEffect = forcing->woodRespTempEffect[step];
+  curr->soilTempEffect = forcing->soilTempEffect[step];
+  curr->coarseRootTempEffect = forcing->coarseRootTempEffect[step];
+  curr->fineRootTempEffect = forcing->fineRootTempEffect[step];
+  curr->rd = forcing->rd[step];
+  model->climate = curr;
+}
+
 // ////////////////// //
 // Modeling Functions //
 // ////////////////// //
@@ -491,6 +778,8 @@ void freeClimateList() {
 /*!
  * @brief Compute canopy light effect using Simpson's rule.
  *
+ * This is the default method; see calcLightEff().
+ *
  * Similar to light attenuation in PnET, first calculate light
  * intensity and then the light effect `lightEFF` for each layer.
  *
@@ -514,7 +803,8 @@ void freeClimateList() {
  * @param[in] lai Leaf area index (m^2 leaf/m^2 ground).
  * @param[in] par Incoming Photosynthetically Active Radiation (PAR).
  */
-void calcLightEff(double *lightEff, double lai, double par) {
+void calcLightEffSimpson(SipnetModel *model, double *lightEff, double lai,
+                         double par) {
 
   // Information on the distribution of LAI with height is available
   // as of March 2007 ... contact Dr. Maggie Prater Maggie.Prater@colorado.edu
@@ -543,12 +833,13 @@ void calcLightEff(double *lightEff, double lai, double par) {
 
       // par attenuated down to current layer
       // :: from [1], eq (A11)
-      lightIntensity = par * exp(-1.0 * params.attenuation * cumLai);
+      lightIntensity = par * exp(-1.0 * model->params.attenuation * cumLai);
 
       // between 0 and 1; when lightIntensity = halfSatPar, currLightEff = 1/2
       // :: from [1], eq (A12), modified as power of 2 instead of e (but
       // equivalent mathematically)
-      currLightEff = (1 - pow(2, (-1.0 * lightIntensity / params.halfSatPar)));
+      currLightEff =
+          (1 - pow(2, (-1.0 * lightIntensity / model->params.halfSatPar)));
 
       // CHANGE FROM [1]: instead of taking mean of the light effects at each
       // layer, we approximate the integral via simpson's rule, and then divide
@@ -569,6 +860,113 @@ void calcLightEff(double *lightEff, double lai, double par) {
   }
 }
 
+// Table of Ein(x) (see expIntEin()) and its derivative at steps of
+// EIN_TABLE_STEP from 0 to EIN_TABLE_MAX, for calcLightEffAnalytic(); built
+// once, on first use. Past EIN_TABLE_MAX, Ein(x) = gamma + ln(x) to double
+// precision.
+#define EIN_TABLE_STEPS_PER_UNIT 128
+#define EIN_TABLE_MAX 32
+#define EIN_TABLE_SIZE (EIN_TABLE_MAX * EIN_TABLE_STEPS_PER_UNIT + 1)
+#define EULER_GAMMA 0.57721566490153286061
+static double einTable[EIN_TABLE_SIZE];
+static double einSlopeTable[EIN_TABLE_SIZE];
+static pthread_once_t einTableOnce = PTHREAD_ONCE_INIT;
+
+static void initEinTable(void) {
+  einTable[0] = 0.0;
+  einSlopeTable[0] = 1.0;
+  for (int ind = 1; ind < EIN_TABLE_SIZE; ++ind) {
+    double x = (double)ind / EIN_TABLE_STEPS_PER_UNIT;
+    einTable[ind] = expIntEin(x);
+    einSlopeTable[ind] = -expm1(-x) / x;
+  }
+}
+
+// Ein(x) for x >= 0, by cubic Hermite interpolation in the table; accurate
+// to about 1e-12
+static double lookupEin(double x) {
+  if (x >= EIN_TABLE_MAX) {
+    return EULER_GAMMA + log(x);
+  }
+
+  double pos = x * EIN_TABLE_STEPS_PER_UNIT;
+  int ind = (int)pos;
+  double t = pos - ind;
+  double h = 1.0 / EIN_TABLE_STEPS_PER_UNIT;
+  double y0 = einTable[ind];
+  double y1 = einTable[ind + 1];
+  double m0 = einSlopeTable[ind] * h;
+  double m1 = einSlopeTable[ind + 1] * h;
+
+  return y0 + t * (m0 + t * (3.0 * (y1 - y0) - 2.0 * m0 - m1 +
+                             t * (2.0 * (y0 - y1) + m0 + m1)));
+}
+
+/*!
+ * @brief Compute canopy light effect by integrating in closed form.
+ *
+ * Computes the same canopy average as calcLightEffSimpson(), but evaluates
+ * the integral in closed form rather than numerically. With x the cumulative
+ * LAI from the top of the canopy, light intensity par * exp(-k x) (eq (A11)
+ * of [1]) and per-layer effect 1 - 2^(-intensity / halfSatPar) (eq (A12)),
+ * substituting u = a * exp(-k x) gives
+ *
+ *   (1/lai) * integral_0^lai (1 - exp(-a exp(-k x))) dx
+ *     = 1 - (E1(a exp(-b)) - E1(a)) / b
+ *     = (Ein(a) - Ein(a exp(-b))) / b,
+ *
+ * where a = ln(2) * par / halfSatPar, b = k * lai, and E1 and Ein are
+ * exponential integrals (see expIntE1() and expIntEin()). Ein is read from a
+ * precomputed table, so this takes one exp() where Simpson's rule takes seven
+ * exp() and seven pow() calls. See docs/model-structure.md for how the two
+ * compare.
+ *
+ * @param[out] lightEff Canopy average light effect.
+ * @param[in] lai Leaf area index (m^2 leaf/m^2 ground).
+ * @param[in] par Incoming Photosynthetically Active Radiation (PAR).
+ */
+void calcLightEffAnalytic(SipnetModel *model, double *lightEff, double lai,
+                          double par) {
+  // Below this b, dividing the difference of Ein values by b magnifies the
+  // table's error too much; a midpoint expansion is used instead
+  static const double MIN_TABLE_ATTENUATION = 0.02;
+
+  if (lai > 0 && par > 0) {  // must have at least some leaves and some light
+    double a = M_LN2 * par / model->params.halfSatPar;
+    double b = model->params.attenuation * lai;
+    if (b < MIN_TABLE_ATTENUATION) {
+      // Integrand at mid-canopy, plus the second-order midpoint correction;
+      // the error is O(b^4)
+      double u = a * exp(-0.5 * b);
+      *lightEff = 1.0 - exp(-u) * (1.0 - b * b * u * (1.0 - u) / 24.0);
+    } else {
+      pthread_once(&einTableOnce, initEinTable);
+      *lightEff = (lookupEin(a) - lookupEin(a * exp(-b))) / b;
+    }
+  } else {  // no leaves or no light!
+    *lightEff = 0;
+  }
+}
+
+/*!
+ * @brief Compute canopy light effect.
+ *
+ * Uses calcLightEffAnalytic() when ctx.analyticLight is set, and
+ * calcLightEffSimpson() otherwise.
+ *
+ * @param[out] lightEff Canopy average light effect.
+ * @param[in] lai Leaf area index (m^2 leaf/m^2 ground).
+ * @param[in] par Incoming Photosynthetically Active Radiation (PAR).
+ */
+void calcLightEff(SipnetModel *model, double *lightEff, double lai,
+                  double par) {
+  if (ctx.analyticLight) {
+    calcLightEffAnalytic(model, lightEff, lai, par);
+  } else {
+    calcLightEffSimpson(model, lightEff, lai, par);
+  }
+}
+
 /*!
  * @brief Compute gross potential photosynthesis with restrictions and base
  * foliar resp
@@ -582,13 +980,11 @@ void calcLightEff(double *lightEff, double lai, double par) {
  * @param[out] baseFolResp base foliar respiration unmodified by temp, water,
  *                         etc. (g C * m^-2 ground area * day^-1)
  * @param[in] lai leaf area index (m^2 leaf * m^-2 ground area)
- * @param[in] tair air temperature (degrees Celsius)
- * @param[in] vpd vapor pressure deficit (kPa)
  * @param[in] par photosynthetically active radiation (Einsteins * m^-2 ground
  *                area * day^-1)
  */
-void potPsn(double *potGrossPsn, double *baseFolResp, double lai, double tair,
-            double vpd, double par) {
+void potPsn(SipnetModel *model, double *potGrossPsn, double *baseFolResp,
+            double lai, double par) {
   // Calculation of potGrossPsn proceeds as described in [1], with minor
   // modifications as noted below.
 
@@ -611,26 +1007,22 @@ void potPsn(double *potGrossPsn, double *baseFolResp, double lai, double tair,
 
   // foliar respiration, unmodified by temp, etc.
   // :: from [1], eq (A5)
-  respPerGram = params.baseFolRespFrac * params.aMax;
+  respPerGram = model->params.baseFolRespFrac * model->params.aMax;
   // daily maximum gross photosynthetic rate
   // :: from [1], eq (A6)
-  grossAMax = params.aMax * params.aMaxFrac + respPerGram;
+  grossAMax = model->params.aMax * model->params.aMaxFrac + respPerGram;
 
   // Now to calculate reductions to the daily maximum - dTemp, dVpd, dLight
-  // :: from [1], eq (A9)
-  dTemp = (params.psnTMax - tair) * (tair - params.psnTMin) /
-          pow((params.psnTMax - params.psnTMin) / 2.0, 2);
-  dTemp = fmax(dTemp, 0.0);
-  // :: from [1], eq (A10); modified to accept a variable exponent, [1] uses
-  // dVpdExp = 2 [TAG:UNKNOWN_PROVENANCE] vpd exponent
-  dVpd = 1.0 - params.dVpdSlope * pow(vpd, params.dVpdExp);
-  dVpd = fmax(dVpd, 0.0);
+  // dTemp and dVpd depend only on climate, from [1], eqs (A9) and (A10); see
+  // forcing.c
+  dTemp = model->climate->dTemp;
+  dVpd = model->climate->dVpd;
   // dLight calculated as described in [1], see calcLightEff()
-  calcLightEff(&dLight, lai, par);
+  calcLightEff(model, &dLight, lai, par);
 
   // :: from [1], unit conversion taking into account eq (A8)
   conversion = C_WEIGHT * (1.0 / TEN_9) *
-               (params.leafCSpWt / params.cFracLeaf) * lai *
+               (model->params.leafCSpWt / model->params.cFracLeaf) * lai *
                SEC_PER_DAY;  // to convert units
   // :: from [1], eq (A7)
   *potGrossPsn = grossAMax * dTemp * dVpd * dLight * conversion;
@@ -653,8 +1045,8 @@ void potPsn(double *potGrossPsn, double *baseFolResp, double lai, double tair,
  * @param[in] vpd vapor pressure deficit (kPa)
  * @param[in] soilWater current water in soil (g C * m^-2 ground area)
  */
-void moisture(double *trans, double *dWater, double potGrossPsn, double vpd,
-              double soilWater) {
+void moisture(SipnetModel *model, double *trans, double *dWater,
+              double potGrossPsn, double vpd, double soilWater) {
   // potential transpiration in the absense of plant water stress
   // (cm H20 * day^-1)
   double potTrans;
@@ -669,7 +1061,7 @@ void moisture(double *trans, double *dWater, double potGrossPsn, double vpd,
                   // photosynthesis
   } else {
     // :: from [1], eq (A13)
-    wue = params.wueConst / vpd;
+    wue = model->params.wueConst / vpd;
 
     // 1000 converts g to mg; 44/12 converts g C to g CO2, 1/10000 converts m^2
     // to cm^2
@@ -679,15 +1071,16 @@ void moisture(double *trans, double *dWater, double potGrossPsn, double vpd,
     // :: from [1], discussion below eq (A14)
     // Cap the available water at soil WHC; excess flooding/pooling is not
     // available
-    removableWater = fmin(soilWater, params.soilWHC) * params.waterRemoveFrac;
+    removableWater = fmin(soilWater, model->params.soilWHC) *
+                     model->params.waterRemoveFrac;
 
     // :: from [2], snowpack modification
-    if (climate->tsoil < params.frozenSoilThreshold) {
+    if (model->climate->tsoil < model->params.frozenSoilThreshold) {
       // frozen soil - less or no water available
       // frozen soil effect: fraction of water available if soil is frozen
       // (assume amount of water available in frozen soil scales linearly
       // with amount of water available in thawed soil)
-      removableWater *= params.frozenSoilEff;
+      removableWater *= model->params.frozenSoilEff;
     }
 
     // :: from [1], eq (A15)
@@ -702,27 +1095,27 @@ void moisture(double *trans, double *dWater, double potGrossPsn, double vpd,
 // 0 = no, 1 = yes
 // note: there may be some fluctuations in this signal for some methods of
 // determining growing season start (e.g. for soil temp-based leaf growth)
-int pastLeafGrowth(void) {
+int pastLeafGrowth(SipnetModel *model) {
   if (ctx.gdd) {
     // :: from [1], description on pg 350
     // Compare threshold to year-to-date cumulative GDD:
     // trackers.gdd holds prior-step cumulative GDD for this year, while
     // climate->gdd is this step's non-negative contribution.
-    double cumulativeGdd = climate->gdd;
-    if (climate->year == trackers.lastYear) {
-      cumulativeGdd += trackers.gdd;
+    double cumulativeGdd = model->climate->gdd;
+    if (model->climate->year == model->trackers.lastYear) {
+      cumulativeGdd += model->trackers.gdd;
     }
-    return (cumulativeGdd >= params.gddLeafOn);
+    return (cumulativeGdd >= model->params.gddLeafOn);
   }
   if (ctx.soilPhenol) {
     // [TAG:UNKNOWN_PROVENANCE] soil phenol functionality
-    return (climate->tsoil >= params.soilTempLeafOn);  // soil temperature
-                                                       // threshold
+    // soil temperature threshold
+    return (model->climate->tsoil >= model->params.soilTempLeafOn);
   }
-  if (params.leafOnDay > 0) {
+  if (model->params.leafOnDay > 0) {
     // :: from [1]
-    double currTime = (double)climate->day + climate->time / 24.0;
-    return (currTime >= params.leafOnDay);  // turn-on day
+    double currTime = (double)model->climate->day + model->climate->time / 24.0;
+    return (currTime >= model->params.leafOnDay);  // turn-on day
   }
 
   return 0;
@@ -730,11 +1123,11 @@ int pastLeafGrowth(void) {
 
 // have we passed the growing season-end leaf fall trigger this year?
 // 0 = no, 1 = yes
-int pastLeafFall(void) {
+int pastLeafFall(SipnetModel *model) {
   // :: from [1]
-  if (params.leafOffDay > 0) {
-    return ((climate->day + climate->time / 24.0) >=
-            params.leafOffDay);  // turn-off
+  if (model->params.leafOffDay > 0) {
+    return ((model->climate->day + model->climate->time / 24.0) >=
+            model->params.leafOffDay);  // turn-off
     // day
   }
 
@@ -753,7 +1146,7 @@ int pastLeafFall(void) {
  * litter as described in [2], Appendix: Model Description. Calculation of
  * leafCreation is not from [1] (source TBD).
  */
-void calcWoodAndLeafFluxes(void) {
+void calcWoodAndLeafFluxes(SipnetModel *model) {
   // [TAG:UNKNOWN_PROVENANCE] leaf phenology combination
   // This function's exact source is still unknown, but is likely a combo of:
   // [1]: growing season boundary effects, but modified to be partial growth
@@ -762,23 +1155,24 @@ void calcWoodAndLeafFluxes(void) {
 
   // Wood litter, in g C * m^-2 ground area * day^-1
   // turnover rate is fraction lost per day
-  fluxes.woodLitter += getTotalWoodC() * params.woodTurnoverRate;
+  model->fluxes.woodLitter += getTotalWoodC(model) *
+                              model->params.woodTurnoverRate;
 
   // a constant fraction of leaves fall in each time step
-  double leafLitter = envi.plantLeafC * params.leafTurnoverRate;
-  fluxes.leafLitter += leafLitter;
+  double leafLitter = model->envi.plantLeafC * model->params.leafTurnoverRate;
+  model->fluxes.leafLitter += leafLitter;
 
   // temporal mean of recent npp (g C * m^-2 ground * day^-1)
-  double npp = getMeanTrackerMean(meanNPP);
+  double npp = getMeanTrackerMean(model->meanNPP);
 
   // a fraction of NPP is allocated to leaf growth; negative mean NPP indicates
   // carbon loss; note that we can't lose more than we have, but we'll handle
   // that when we calc wood fluxes (as we will deduct from there instead)
-  double leafCreation = npp * params.leafAllocation;
-  double woodCreation = npp * params.woodAllocation;
+  double leafCreation = npp * model->params.leafAllocation;
+  double woodCreation = npp * model->params.woodAllocation;
 
-  fluxes.leafCreation += leafCreation;
-  fluxes.woodCreation += woodCreation;
+  model->fluxes.leafCreation += leafCreation;
+  model->fluxes.woodCreation += woodCreation;
 }
 
 /*!
@@ -797,44 +1191,46 @@ void calcWoodAndLeafFluxes(void) {
  *   (g C/m^2 ground/day)
  * @param[in] plantLeafC Leaf carbon pool size (g C/m^2 ground area)
  */
-void calcLeafOnOffFluxes(double *leafOnCreation, double *leafOnFromWood,
-                         double *leafLitter, double plantLeafC) {
+void calcLeafOnOffFluxes(SipnetModel *model, double *leafOnCreation,
+                         double *leafOnFromWood, double *leafLitter,
+                         double plantLeafC) {
   // Calc additional fluxes at start/end of growing season
   // Note that these are basically events, and we will track them as such
 
   // first check for new year; if new year, reset trackers (since we haven't
   // done leaf growth or fall yet in this new year):
-  if (climate->year > phenologyTrackers.lastYear) {  // HAPPY NEW YEAR!
-    phenologyTrackers.didLeafGrowth = 0;
-    phenologyTrackers.didLeafFall = 0;
-    phenologyTrackers.lastYear = climate->year;
+  // HAPPY NEW YEAR!
+  if (model->climate->year > model->phenologyTrackers.lastYear) {
+    model->phenologyTrackers.didLeafGrowth = 0;
+    model->phenologyTrackers.didLeafFall = 0;
+    model->phenologyTrackers.lastYear = model->climate->year;
   }
 
   // check for start of growing season:
-  if (!phenologyTrackers.didLeafGrowth && pastLeafGrowth()) {
+  if (!model->phenologyTrackers.didLeafGrowth && pastLeafGrowth(model)) {
     // we just reached the start of the growing season
-    double leafOn = params.leafGrowth / climate->length;
-    checkLeafOnLimitation(&leafOn);
+    double leafOn = model->params.leafGrowth / model->climate->length;
+    checkLeafOnLimitation(model, &leafOn);
     *leafOnCreation += leafOn;
-    double totalSourceC = envi.plantWoodC + envi.coarseRootC;
+    double totalSourceC = model->envi.plantWoodC + model->envi.coarseRootC;
     if (totalSourceC > TINY) {
-      *leafOnFromWood += leafOn * envi.plantWoodC / totalSourceC;
+      *leafOnFromWood += leafOn * model->envi.plantWoodC / totalSourceC;
     }
-    phenologyTrackers.didLeafGrowth = 1;
+    model->phenologyTrackers.didLeafGrowth = 1;
     // This is a computed event - however, the value may get reduced by
     // nitrogen limitation. The writeEvent call is in writeLeafOnEventIfNeeded,
     // called after N limiting is checked.
   }
 
   // check for end of growing season:
-  if (!phenologyTrackers.didLeafFall && pastLeafFall()) {
+  if (!model->phenologyTrackers.didLeafFall && pastLeafFall(model)) {
     // we just reached the end of the growing season
-    double len = climate->length;
-    double leafOff = (plantLeafC * params.fracLeafFall) / len;
+    double len = model->climate->length;
+    double leafOff = (plantLeafC * model->params.fracLeafFall) / len;
     *leafLitter += leafOff;
-    phenologyTrackers.didLeafFall = 1;
+    model->phenologyTrackers.didLeafFall = 1;
     if (leafOff > TINY && ctx.events) {
-      writeComputedEventOut(climate->year, climate->day,
+      writeComputedEventOut(model, model->climate->year, model->climate->day,
                             eventTypeToString(LEAFOFF), 1, "leafLitter",
                             leafOff * len);
     }
@@ -845,17 +1241,18 @@ void calcLeafOnOffFluxes(double *leafOnCreation, double *leafOnFromWood,
 
 // calculate total rain and snowfall (cm water equiv./day)
 // also, immediate evaporation (from interception) (cm/day)
-void calcPrecip(double *rain, double *snowFall, double *immedEvap, double lai) {
+void calcPrecip(SipnetModel *model, double *rain, double *snowFall,
+                double *immedEvap, double lai) {
   // below freezing -> precip falls as snow
-  if (climate->tair <= 0) {
-    *snowFall = climate->precip / climate->length;
+  if (model->climate->tair <= 0) {
+    *snowFall = model->climate->precip / model->climate->length;
     *rain = 0;
   }
 
   // above freezing -> precip falls as rain
   else {
     *snowFall = 0;
-    *rain = climate->precip / climate->length;
+    *rain = model->climate->precip / model->climate->length;
   }
 
   /* Immediate evaporation is a sum of evaporation from canopy interception
@@ -870,14 +1267,14 @@ void calcPrecip(double *rain, double *snowFall, double *immedEvap, double lai) {
     double maxLeafPool;
 
     // calculate current leaf pool size depending on lai
-    maxLeafPool = lai * params.leafPoolDepth;
-    *immedEvap = (*rain) * params.immedEvapFrac;
+    maxLeafPool = lai * model->params.leafPoolDepth;
+    *immedEvap = (*rain) * model->params.immedEvapFrac;
 
     // don't evaporate more than pool size, excess water will go to the soil
     if (*immedEvap > maxLeafPool)
       *immedEvap = maxLeafPool;
   } else {
-    *immedEvap = (*rain) * params.immedEvapFrac;
+    *immedEvap = (*rain) * model->params.immedEvapFrac;
   }
 }
 
@@ -885,19 +1282,18 @@ void calcPrecip(double *rain, double *snowFall, double *immedEvap, double lai) {
 // calculate snow melt (cm water equiv./day) & sublimation (cm water equiv./day)
 // ensure we don't over-drain the snowpack (so that it becomes negative)
 // snowFall in cm/day
-void snowPack(double *snowMelt, double *sublimation, double snowFall) {
+void snowPack(SipnetModel *model, double *snowMelt, double *sublimation,
+              double snowFall) {
   // conversion factor for sublimation
   static const double CONVERSION = (RHO * CP) / GAMMA * (1. / LAMBDA_S) *
                                    1000. * 1000. * (1. / 10000) * SEC_PER_DAY;
   // 1000 converts kg to g, 1000 converts kPa to Pa, 1/10000 converts m^2 to
   // cm^2
 
-  double rd;  // aerodynamic resistance between ground and canopy air space
-              // (sec/m)
   double snowRemaining;  // to make sure we don't get rid of more than there is
 
   // if no snow, set fluxes to 0
-  if (envi.snow <= 0) {
+  if (model->envi.snow <= 0) {
     *snowMelt = 0;
     *sublimation = 0;
   }
@@ -906,10 +1302,11 @@ void snowPack(double *snowMelt, double *sublimation, double snowFall) {
   else {
     // first calculate sublimation, then snow melt
     // (if there's not enough snow to do both, priority given to sublimation)
-    rd = (params.rdConst) / (climate->wspd);  // aerodynamic resistance (sec/m)
-    *sublimation = CONVERSION * (E_STAR_SNOW - climate->vPress) / rd;
+    // rd is the aerodynamic resistance (sec/m)
+    *sublimation = CONVERSION * (E_STAR_SNOW - model->climate->vPress) /
+                   model->climate->rd;
 
-    snowRemaining = envi.snow + (snowFall * climate->length);
+    snowRemaining = model->envi.snow + (snowFall * model->climate->length);
 
     // remove to allow sublimation of a negative amount of snow
     // right now we can't sublime a negative amount of snow
@@ -918,28 +1315,28 @@ void snowPack(double *snowMelt, double *sublimation, double snowFall) {
     }
 
     // make sure we don't sublime more than there is to sublime:
-    if (snowRemaining - (*sublimation * climate->length) < 0) {
-      *sublimation = snowRemaining / climate->length;
+    if (snowRemaining - (*sublimation * model->climate->length) < 0) {
+      *sublimation = snowRemaining / model->climate->length;
       snowRemaining = 0;
     }
 
     else {
-      snowRemaining -= (*sublimation * climate->length);
+      snowRemaining -= (*sublimation * model->climate->length);
     }
 
     // below freezing: no snow melt
-    if (climate->tair <= 0) {
+    if (model->climate->tair <= 0) {
       *snowMelt = 0;
     }
 
     // above freezing: melt snow
     else {
-      *snowMelt = params.snowMelt * climate->tair;  // snow melt proportional to
-                                                    // temp.
+      // snow melt proportional to temp.
+      *snowMelt = model->params.snowMelt * model->climate->tair;
 
       // make sure we don't melt more than there is to melt:
-      if (snowRemaining - (*snowMelt * climate->length) < 0) {
-        *snowMelt = snowRemaining / climate->length;
+      if (snowRemaining - (*snowMelt * model->climate->length) < 0) {
+        *snowMelt = snowRemaining / model->climate->length;
       }
     }  // end else above freezing
   }  // end else there is snow
@@ -960,9 +1357,9 @@ void snowPack(double *snowMelt, double *sublimation, double snowFall) {
  * @param[in] snowMelt water available from snow (cm equiv/day)
  * @param[in] trans water leaving via transpiration
  */
-void calcSoilWaterFluxes(double *fastFlow, double *evaporation,
-                         double *drainage, double water, double netRain,
-                         double snowMelt, double trans) {
+void calcSoilWaterFluxes(SipnetModel *model, double *fastFlow,
+                         double *evaporation, double *drainage, double water,
+                         double netRain, double snowMelt, double trans) {
   // conversion factor for evaporation
   // 1000 converts kg to g, 1000 converts kPa to Pa, 1/10000 converts m^2 to
   // cm^2
@@ -975,29 +1372,31 @@ void calcSoilWaterFluxes(double *fastFlow, double *evaporation,
   double netIn = netRain + snowMelt;
 
   // fast flow: fraction that goes directly to drainage
-  *fastFlow = netIn * params.fastFlowFrac;
+  *fastFlow = netIn * model->params.fastFlowFrac;
   netIn -= *fastFlow;
 
   // calculate evaporation:
   // first calculate how much water is left to evaporate (used later)
-  waterRemaining = water + netIn * climate->length - trans * climate->length;
+  waterRemaining = water + netIn * model->climate->length -
+                   trans * model->climate->length;
 
   // if there's a snow pack, don't evaporate from soil:
-  if (envi.snow > 0) {
+  if (model->envi.snow > 0) {
     *evaporation = 0;
   }
 
   // else no snow pack:
   else {
-    double waterFrac = getClippedWaterFrac(water, params.soilWHC);
+    double waterFrac = getClippedWaterFrac(water, model->params.soilWHC);
     // aerodynamic resistance between ground and canopy airspace (sec/m)
-    double rd = (params.rdConst) / (climate->wspd);
+    double rd = model->climate->rd;
     // bare soil surface resistance (sec/m)
-    double rsoil = exp(params.rSoilConst1 - params.rSoilConst2 * (waterFrac));
+    double rsoil = exp(model->params.rSoilConst1 -
+                       model->params.rSoilConst2 * (waterFrac));
 
     // by using vpd we assume that relative humidity of soil pore space is 1
     // (when this isn't true, there won't be much water evaporated anyway)
-    *evaporation = CONVERSION * climate->vpdSoil / (rd + rsoil);
+    *evaporation = CONVERSION * model->climate->vpdSoil / (rd + rsoil);
 
     // remove to allow negative evaporation (i.e. condensation):
     if (*evaporation < 0) {
@@ -1005,25 +1404,25 @@ void calcSoilWaterFluxes(double *fastFlow, double *evaporation,
     }
 
     // make sure we don't evaporate more than we have:
-    if (waterRemaining - (*evaporation * climate->length) < TINY) {
+    if (waterRemaining - (*evaporation * model->climate->length) < TINY) {
       // leave a tiny little bit, to avoid negative water due to round-off
       // errors
-      *evaporation = (waterRemaining - TINY) / climate->length;
+      *evaporation = (waterRemaining - TINY) / model->climate->length;
       waterRemaining = 0;
     } else {
-      waterRemaining -= (*evaporation * climate->length);
+      waterRemaining -= (*evaporation * model->climate->length);
     }
   }
 
   // drain any water that remains beyond water holding capacity:
-  if (waterRemaining > params.soilWHC) {
-    double excessWater = waterRemaining - params.soilWHC;
+  if (waterRemaining > model->params.soilWHC) {
+    double excessWater = waterRemaining - model->params.soilWHC;
     if (ctx.flooding) {
       // Careful not to drain more than all the excess water
-      *drainage = fmin(excessWater * params.waterDrainFrac,
-                       excessWater / climate->length);
+      *drainage = fmin(excessWater * model->params.waterDrainFrac,
+                       excessWater / model->climate->length);
     } else {
-      *drainage = excessWater / climate->length;
+      *drainage = excessWater / model->climate->length;
     }
   } else {
     *drainage = 0;
@@ -1048,32 +1447,34 @@ void getGpp(double *gpp, double potGrossPsn, double dWater) {
  * @param[in] baseFolResp base foliar respiration (g C * m^-2 ground area *
  * day^-1)
  */
-void vegResp(double *folResp, double *woodResp, double baseFolResp) {
+void vegResp(SipnetModel *model, double *folResp, double *woodResp,
+             double baseFolResp) {
   // Respiration model according to [1]
 
   // :: from [1], eq (A18)
-  *folResp = baseFolResp *
-             pow(params.vegRespQ10, (climate->tair - params.psnTOpt) / 10.0);
+  *folResp = baseFolResp * model->climate->folRespTempEffect;
 
   // :: from [2], snowpack addition
-  if (climate->tsoil < params.frozenSoilThreshold) {
+  if (model->climate->tsoil < model->params.frozenSoilThreshold) {
     // allows foliar resp. to be shutdown by a given fraction in winter
-    *folResp *= params.frozenSoilFolREff;
+    *folResp *= model->params.frozenSoilFolREff;
   }
   // end snowpack addition
 
   // :: from [1], eq (A19)
-  *woodResp = params.baseVegResp * getTotalWoodC() *
-              pow(params.vegRespQ10, climate->tair / 10.0);
+  *woodResp = model->params.baseVegResp * getTotalWoodC(model) *
+              model->climate->woodRespTempEffect;
 }
 
 // calculate foliar respiration and wood maint. resp, both in g C * m^-2 ground
 // area * day^-1 does *not* explicitly model growth resp. (includes it in maint.
 // resp)
-void calcRootResp(double *rootResp, double respQ10, double baseRate,
-                  double poolSize) {
+//
+// tempEffect is the Q10 effect of soil temperature for this pool
+void calcRootResp(SipnetModel *model, double *rootResp, double tempEffect,
+                  double baseRate, double poolSize) {
   // :: from [3], root model description (eq (1) with root params)
-  *rootResp = baseRate * poolSize * pow(respQ10, climate->tsoil / 10.0);
+  *rootResp = baseRate * poolSize * tempEffect;
 }
 
 // a second veg. resp. method:
@@ -1081,20 +1482,20 @@ void calcRootResp(double *rootResp, double respQ10, double baseRate,
 // ground area * day^-1 growth resp. modeled in a very simple way
 // This is in addition to [1], source not yet determined (controlled by
 // ctx.growthResp)
-void vegResp2(double *folResp, double *woodResp, double *growthResp,
-              double baseFolResp) {
+void vegResp2(SipnetModel *model, double *folResp, double *woodResp,
+              double *growthResp, double baseFolResp) {
   // [TAG:UNKNOWN_PROVENANCE] growthResp
-  *folResp = baseFolResp *
-             pow(params.vegRespQ10, (climate->tair - params.psnTOpt) / 10.0);
-  if (climate->tsoil < params.frozenSoilThreshold) {
-    *folResp *= params.frozenSoilFolREff;  // allows foliar resp. to be shutdown
-                                           // by a given fraction in winter
+  *folResp = baseFolResp * model->climate->folRespTempEffect;
+  if (model->climate->tsoil < model->params.frozenSoilThreshold) {
+    // allows foliar resp. to be shutdown by a given fraction in winter
+    *folResp *= model->params.frozenSoilFolREff;
   }
-  *woodResp = params.baseVegResp * getTotalWoodC() *
-              pow(params.vegRespQ10, climate->tair / 10.0);
+  *woodResp = model->params.baseVegResp * getTotalWoodC(model) *
+              model->climate->woodRespTempEffect;
 
   // Rg is a fraction of the recent mean NPP
-  *growthResp = params.growthRespFrac * getMeanTrackerMean(meanNPP);
+  *growthResp =
+      model->params.growthRespFrac * getMeanTrackerMean(model->meanNPP);
 
   // TODO: not sure what to do here, probably just delete this?
   if (*growthResp < 0) {
@@ -1108,14 +1509,16 @@ void vegResp2(double *folResp, double *woodResp, double *growthResp,
 // require:
 //   leaf, wood, fine root < 1 individually
 //   coarse root >=0 which enforces leaf + wood + fine root <= 1
-void ensureAllocation(void) {
+void ensureAllocation(SipnetModel *model) {
   // :: from [3], root model description
-  params.coarseRootAllocation = 1 - params.leafAllocation -
-                                params.woodAllocation -
-                                params.fineRootAllocation;
-
-  if ((params.leafAllocation >= 1.0) || (params.woodAllocation >= 1.0) ||
-      (params.fineRootAllocation >= 1.0) || (params.coarseRootAllocation < 0)) {
+  model->params.coarseRootAllocation = 1 - model->params.leafAllocation -
+                                       model->params.woodAllocation -
+                                       model->params.fineRootAllocation;
+
+  if ((model->params.leafAllocation >= 1.0) ||
+      (model->params.woodAllocation >= 1.0) ||
+      (model->params.fineRootAllocation >= 1.0) ||
+      (model->params.coarseRootAllocation < 0)) {
     printf("ERROR: NPP allocation params must be less than one individually "
            "and add to less than one\n");
     exit(EXIT_CODE_BAD_PARAMETER_VALUE);
@@ -1125,91 +1528,100 @@ void ensureAllocation(void) {
 /*!
  * Calculate soil respiration flux
  *
- * @param tsoil Temperature of the soil
  * @param water Current soil water
  * @param whc Soil water holding capacity
  */
-void calcSoilRespiration(double tsoil, double water, double whc) {
-  double moistEffect = calcRespMoistEffect(water, whc);
+void calcSoilRespiration(SipnetModel *model, double water, double whc) {
+  double moistEffect = calcRespMoistEffect(model, water, whc);
 
   // :: from [1], remainder of eq (A20)
   // See calcMoistEffect() for first part of eq (A20) calculation
-  double tempEffect = calcTempEffect(tsoil);
+  double tempEffect = model->climate->soilTempEffect;
 
   // Effects of tillage, if any
-  double tillageEffect = calcTillageEffect();
+  double tillageEffect = calcTillageEffect(model);
 
   // Effects of current CN
-  double cnEffect = calcCNEffect(params.kCN, envi.soilC, envi.soilOrgN);
+  double cnEffect = calcCNEffect(model->params.kCN, model->envi.soilC,
+                                 model->envi.soilOrgN);
 
   // Put it all together!
-  fluxes.rSoil = envi.soilC * params.baseSoilResp * moistEffect * tempEffect *
-                 tillageEffect * cnEffect;
+  model->fluxes.rSoil = model->envi.soilC * model->params.baseSoilResp *
+                        moistEffect * tempEffect * tillageEffect * cnEffect;
 }
 
-void calcLitterFluxes() {
+void calcLitterFluxes(SipnetModel *model) {
   if (ctx.litterPool) {
-    double tempEffect = calcTempEffect(climate->tsoil);
-    double moistEffect = calcRespMoistEffect(envi.soilWater, params.soilWHC);
+    double tempEffect = model->climate->soilTempEffect;
+    double moistEffect = calcRespMoistEffect(model, model->envi.soilWater,
+                                             model->params.soilWHC);
     // Effects of tillage, if any
-    double tillageEffect = calcTillageEffect();
+    double tillageEffect = calcTillageEffect(model);
     // Effects of current CN
-    double cnEffect = calcCNEffect(params.kCN, envi.litterC, envi.litterN);
+    double cnEffect = calcCNEffect(model->params.kCN, model->envi.litterC,
+                                   model->envi.litterN);
 
     // total litter breakdown (i.e. litterToSoil + rLitter) (g C/m^2 ground/day)
-    double litterBreakdown = envi.litterC * params.litterBreakdownRate *
-                             tempEffect * moistEffect * tillageEffect *
-                             cnEffect;
+    double litterBreakdown = model->envi.litterC *
+                             model->params.litterBreakdownRate * tempEffect *
+                             moistEffect * tillageEffect * cnEffect;
 
-    fluxes.rLitter = litterBreakdown * params.fracLitterRespired;
-    fluxes.litterToSoil = litterBreakdown * (1.0 - params.fracLitterRespired);
+    model->fluxes.rLitter = litterBreakdown * model->params.fracLitterRespired;
+    model->fluxes.litterToSoil = litterBreakdown *
+                                 (1.0 - model->params.fracLitterRespired);
   } else {
     // litterBreakdown = 0;
-    fluxes.rLitter = 0;
-    fluxes.litterToSoil = 0;
+    model->fluxes.rLitter = 0;
+    model->fluxes.litterToSoil = 0;
   }
 }
 
 /*!
  * Calculate root and wood creation and loss
  */
-void calcRootFluxes(void) {
+void calcRootFluxes(SipnetModel *model) {
   // :: from [3], roots model descriptions
-  fluxes.coarseRootLoss += params.coarseRootTurnoverRate * envi.coarseRootC;
-  fluxes.fineRootLoss += params.fineRootTurnoverRate * envi.fineRootC;
+  model->fluxes.coarseRootLoss += model->params.coarseRootTurnoverRate *
+                                  model->envi.coarseRootC;
+  model->fluxes.fineRootLoss += model->params.fineRootTurnoverRate *
+                                model->envi.fineRootC;
 
-  double npp = getMeanTrackerMean(meanNPP);
+  double npp = getMeanTrackerMean(model->meanNPP);
 
   // :: from [3], root model description and eq (3)
   // negative mean NPP indicates carbon loss
-  double coarseRootCreation = params.coarseRootAllocation * npp;
-  double fineRootCreation = params.fineRootAllocation * npp;
+  double coarseRootCreation = model->params.coarseRootAllocation * npp;
+  double fineRootCreation = model->params.fineRootAllocation * npp;
 
-  fluxes.coarseRootCreation += coarseRootCreation;
-  fluxes.fineRootCreation += fineRootCreation;
+  model->fluxes.coarseRootCreation += coarseRootCreation;
+  model->fluxes.fineRootCreation += fineRootCreation;
 
   // :: from [3], root model description
-  calcRootResp(&fluxes.rCoarseRoot, params.coarseRootQ10,
-               params.baseCoarseRootResp, envi.coarseRootC);
-  calcRootResp(&fluxes.rFineRoot, params.fineRootQ10, params.baseFineRootResp,
-               envi.fineRootC);
+  calcRootResp(model, &model->fluxes.rCoarseRoot,
+               model->climate->coarseRootTempEffect,
+               model->params.baseCoarseRootResp, model->envi.coarseRootC);
+  calcRootResp(model, &model->fluxes.rFineRoot,
+               model->climate->fineRootTempEffect,
+               model->params.baseFineRootResp, model->envi.fineRootC);
 }
 
 /**
  * Calculate methane flux
  */
-void calcMethaneFlux(void) {
+void calcMethaneFlux(SipnetModel *model) {
   // Like soil respiration, but with own moisture dep and no tillage or CN
-  double tempEffect = calcTempEffect(climate->tsoil);
-  double moistEffect = calcMethaneMoistEffect(envi.soilWater, params.soilWHC);
+  double tempEffect = model->climate->soilTempEffect;
+  double moistEffect = calcMethaneMoistEffect(model, model->envi.soilWater,
+                                              model->params.soilWHC);
 
-  fluxes.soilMethane =
-      params.soilMethaneRate * envi.soilC * tempEffect * moistEffect;
+  model->fluxes.soilMethane = model->params.soilMethaneRate *
+                              model->envi.soilC * tempEffect * moistEffect;
   if (ctx.litterPool) {
-    fluxes.litterMethane =
-        params.litterMethaneRate * envi.litterC * tempEffect * moistEffect;
+    model->fluxes.litterMethane = model->params.litterMethaneRate *
+                                  model->envi.litterC * tempEffect *
+                                  moistEffect;
   } else {
-    fluxes.litterMethane = 0.0;
+    model->fluxes.litterMethane = 0.0;
   }
 }
 
@@ -1219,7 +1631,7 @@ void calcMethaneFlux(void) {
  * This is called at the start of each time step (in updateState()), before
  * event and non-event fluxes are calculated.
  */
-void resetFluxes(void) { fluxes = (struct FluxVars){0}; }
+void resetFluxes(SipnetModel *model) { model->fluxes = (struct FluxVars){0}; }
 
 /**
  * Write out a leaf-on event if one happened
@@ -1227,22 +1639,24 @@ void resetFluxes(void) { fluxes = (struct FluxVars){0}; }
  * Delayed event writing for leaf-on, if appropriate, since the value may
  * have changed due to N limitation
  */
-void writeLeafOnEventIfNeeded(void) {
+void writeLeafOnEventIfNeeded(SipnetModel *model) {
   const char *type = eventTypeToString(LEAFON);
-  const double len = climate->length;
-  if (fluxes.leafOnCreation > TINY && ctx.events) {
-    writeComputedEventOut(climate->year, climate->day, type, 2,
-                          "leafOnCreation", fluxes.leafOnCreation * len,
+  const double len = model->climate->length;
+  if (model->fluxes.leafOnCreation > TINY && ctx.events) {
+    writeComputedEventOut(model, model->climate->year, model->climate->day,
+                          type, 2, "leafOnCreation",
+                          model->fluxes.leafOnCreation * len,
                           "leafOnCreationFromWood",
-                          fluxes.leafOnCreationFromWood * len);
+                          model->fluxes.leafOnCreationFromWood * len);
   }
-  if (fluxes.eventLeafOnCreation > TINY && ctx.events) {
+  if (model->fluxes.eventLeafOnCreation > TINY && ctx.events) {
     // Not really a computed event, but we don't have the event object here, so
     // we use this mechanism
-    writeComputedEventOut(
-        climate->year, climate->day, type, 2, "eventLeafOnCreation",
-        fluxes.eventLeafOnCreation * len, "eventLeafOnCreationFromWood",
-        fluxes.eventLeafOnCreationFromWood * len);
+    writeComputedEventOut(model, model->climate->year, model->climate->day,
+                          type, 2, "eventLeafOnCreation",
+                          model->fluxes.eventLeafOnCreation * len,
+                          "eventLeafOnCreationFromWood",
+                          model->fluxes.eventLeafOnCreationFromWood * len);
   }
 }
 
@@ -1253,7 +1667,7 @@ void writeLeafOnEventIfNeeded(void) {
  * Note: fluxes are reset in updateState() before this is called, so we can
  * assume fluxes start at zero here.
  */
-void calculateFluxes(void) {
+void calculateFluxes(SipnetModel *model) {
   // base foliar respiration, calc'd as part of potential photosynthesis
   double baseFolResp;
   // potential photosynthesis, without water stress
@@ -1271,52 +1685,55 @@ void calculateFluxes(void) {
   double netRain;
 
   // Psn, moisture and water fluxes
-  lai = envi.plantLeafC / params.leafCSpWt;  // current lai
-
-  potPsn(&potGrossPsn, &baseFolResp, lai, climate->tair, climate->vpd,
-         climate->par);
-  moisture(&(fluxes.transpiration), &dWater, potGrossPsn, climate->vpd,
-           envi.soilWater);
-  calcPrecip(&(fluxes.rain), &(fluxes.snowFall), &(fluxes.immedEvap), lai);
-  netRain = fluxes.rain - fluxes.immedEvap;
-  snowPack(&(fluxes.snowMelt), &(fluxes.sublimation), fluxes.snowFall);
-  calcSoilWaterFluxes(&(fluxes.fastFlow), &(fluxes.evaporation),
-                      &(fluxes.drainage), envi.soilWater, netRain,
-                      fluxes.snowMelt, fluxes.transpiration);
-  getGpp(&(fluxes.photosynthesis), potGrossPsn, dWater);
+  lai = model->envi.plantLeafC / model->params.leafCSpWt;  // current lai
+
+  potPsn(model, &potGrossPsn, &baseFolResp, lai, model->climate->par);
+  moisture(model, &(model->fluxes.transpiration), &dWater, potGrossPsn,
+           model->climate->vpd, model->envi.soilWater);
+  calcPrecip(model, &(model->fluxes.rain), &(model->fluxes.snowFall),
+             &(model->fluxes.immedEvap), lai);
+  netRain = model->fluxes.rain - model->fluxes.immedEvap;
+  snowPack(model, &(model->fluxes.snowMelt), &(model->fluxes.sublimation),
+           model->fluxes.snowFall);
+  calcSoilWaterFluxes(model, &(model->fluxes.fastFlow),
+                      &(model->fluxes.evaporation), &(model->fluxes.drainage),
+                      model->envi.soilWater, netRain, model->fluxes.snowMelt,
+                      model->fluxes.transpiration);
+  getGpp(&(model->fluxes.photosynthesis), potGrossPsn, dWater);
 
   // Vegetation respiration
   if (ctx.growthResp) {
-    vegResp2(&folResp, &woodResp, &growthResp, baseFolResp);
-    fluxes.rVeg = folResp + woodResp + growthResp;
+    vegResp2(model, &folResp, &woodResp, &growthResp, baseFolResp);
+    model->fluxes.rVeg = folResp + woodResp + growthResp;
   } else {
-    vegResp(&folResp, &woodResp, baseFolResp);
-    fluxes.rVeg = folResp + woodResp;
+    vegResp(model, &folResp, &woodResp, baseFolResp);
+    model->fluxes.rVeg = folResp + woodResp;
   }
 
   // Leaf creation and litter
-  calcWoodAndLeafFluxes();
+  calcWoodAndLeafFluxes(model);
 
   // Leaf on/off
-  calcLeafOnOffFluxes(&fluxes.leafOnCreation, &fluxes.leafOnCreationFromWood,
-                      &fluxes.leafLitter, envi.plantLeafC);
+  calcLeafOnOffFluxes(model, &model->fluxes.leafOnCreation,
+                      &model->fluxes.leafOnCreationFromWood,
+                      &model->fluxes.leafLitter, model->envi.plantLeafC);
 
   // Litter pool, if LITTER is on
-  calcLitterFluxes();
+  calcLitterFluxes(model);
 
   // Roots
-  calcRootFluxes();
+  calcRootFluxes(model);
 
   // Soil respiration
-  calcSoilRespiration(climate->tsoil, envi.soilWater, params.soilWHC);
+  calcSoilRespiration(model, model->envi.soilWater, model->params.soilWHC);
 
   // Methane
   if (ctx.anaerobic) {
-    calcMethaneFlux();
+    calcMethaneFlux(model);
   }
 
   // Check carbon flux limitations before moving to nitrogen
-  checkCarbonLimitations();
+  checkCarbonLimitations(model);
 
   // Nitrogen cycle
   //
@@ -1324,15 +1741,15 @@ void calculateFluxes(void) {
   // so make sure this stays at the bottom of this function (or after the
   // carbon and water calcs, at least).
   if (ctx.nitrogenCycle) {
-    calcNitrogenFluxes();
+    calcNitrogenFluxes(model);
   }
 
   // Check limitations; must be after all flux calcs
-  checkLimitations();
+  checkLimitations(model);
 
   // Delayed write needed due to N limitation check - leafOn value may have
   // changed
-  writeLeafOnEventIfNeeded();
+  writeLeafOnEventIfNeeded(model);
 }
 
 // /////////////////////// //
@@ -1343,13 +1760,15 @@ void calculateFluxes(void) {
 // Note that if minVal = 0, then this will (as suggested) ensure that var >= 0
 //  If minVal > 0, then minVal can be thought of as some epsilon value, below
 //  which var is treated as 0
-void ensureNonNegative(double *var, double minVal, const char *label) {
+void ensureNonNegative(SipnetModel *model, double *var, double minVal,
+                       const char *label) {
   if (*var < minVal) {
     if (fabs(*var) > EPS) {  // Don't print the zeros
       logWarning(
           "Non-negative stock constraint applied for %s (value %8.5f set "
           "to zero) year %d day %d time %6.3f\n",
-          label, *var, climate->year, climate->day, climate->time);
+          label, *var, model->climate->year, model->climate->day,
+              model->climate->time);
     }
     *var = 0.;
   }
@@ -1365,19 +1784,19 @@ void ensureNonNegative(double *var, double minVal, const char *label) {
 //  ideally, the fluxes would be modified so that they did not make the stocks
 //  negative (otherwise the fluxes could be inconsistent with the changes in the
 //  stocks)
-void ensureNonNegativeStocks(void) {
+void ensureNonNegativeStocks(SipnetModel *model) {
 
-  ensureNonNegative(&(envi.plantWoodC), 0, "plantWoodC");
-  ensureNonNegative(&(envi.plantLeafC), 0, "plantLeafC");
+  ensureNonNegative(model, &(model->envi.plantWoodC), 0, "plantWoodC");
+  ensureNonNegative(model, &(model->envi.plantLeafC), 0, "plantLeafC");
 
   if (ctx.litterPool) {
-    ensureNonNegative(&(envi.litterC), 0, "litterC");
+    ensureNonNegative(model, &(model->envi.litterC), 0, "litterC");
   }
 
-  ensureNonNegative(&(envi.soilC), 0, "soilC");
-  ensureNonNegative(&(envi.coarseRootC), 0, "coarseRootC");
-  ensureNonNegative(&(envi.fineRootC), 0, "fineRootC");
-  ensureNonNegative(&(envi.soilWater), 0, "soilWater");
+  ensureNonNegative(model, &(model->envi.soilC), 0, "soilC");
+  ensureNonNegative(model, &(model->envi.coarseRootC), 0, "coarseRootC");
+  ensureNonNegative(model, &(model->envi.fineRootC), 0, "fineRootC");
+  ensureNonNegative(model, &(model->envi.soilWater), 0, "soilWater");
 
   /* In the case of snow, the model has very different behavior for a snow pack
      of 0 vs. a snow pack of slightly greater than 0 (e.g. no soil evaporation
@@ -1385,14 +1804,14 @@ void ensureNonNegativeStocks(void) {
      we'll set snow = 0 any time it falls below TINY, the assumption being that
      if snow < TINY, then it was really supposed to be 0, but isn't because of
      rounding errors.*/
-  ensureNonNegative(&(envi.snow), TINY, "snow");
+  ensureNonNegative(model, &(model->envi.snow), TINY, "snow");
 
   // Nitrogen cycle stocks
   // if (ctx.nitrogenCycle) {
-  ensureNonNegative(&envi.minN, 0, "minN");
-  ensureNonNegative(&envi.soilOrgN, 0, "soilOrgN");
-  ensureNonNegative(&envi.litterN, 0, "litterN");
-  ensureNonNegative(&envi.plantStorageN, 0, "plantStorageN");
+  ensureNonNegative(model, &model->envi.minN, 0, "minN");
+  ensureNonNegative(model, &model->envi.soilOrgN, 0, "soilOrgN");
+  ensureNonNegative(model, &model->envi.litterN, 0, "litterN");
+  ensureNonNegative(model, &model->envi.plantStorageN, 0, "plantStorageN");
   //}
 }
 
@@ -1403,13 +1822,14 @@ void ensureNonNegativeStocks(void) {
 /**
  * Initialize trackers at start of simulation
  */
-void initTrackers(void) {
+void initTrackers(SipnetModel *model) {
   // Set everything to zero; make sure get them all when new ones are added
-  trackers = (struct TrackerVars){0};
+  model->trackers = (struct TrackerVars){0};
 
   // Now, update the non-zero entries
-  trackers.soilWetnessFrac = envi.soilWater / params.soilWHC;
-  trackers.lastYear = -1;
+  model->trackers.soilWetnessFrac = model->envi.soilWater /
+                                    model->params.soilWHC;
+  model->trackers.lastYear = -1;
 }
 
 /**
@@ -1417,94 +1837,102 @@ void initTrackers(void) {
  *
  * @param oldSoilWater how much soil water there was at time step start (cm)
  */
-void updateTrackers(double oldSoilWater) {
-  if (climate->year != trackers.lastYear) {  // new year: reset yearly trackers
-    trackers.yearlyGpp = 0.0;
-    trackers.yearlyRtot = 0.0;
-    trackers.yearlyRa = 0.0;
-    trackers.yearlyRh = 0.0;
-    trackers.yearlyNpp = 0.0;
-    trackers.yearlyNee = 0.0;
-    trackers.gdd = 0.0;
+void updateTrackers(SipnetModel *model, double oldSoilWater) {
+  // new year: reset yearly trackers
+  if (model->climate->year != model->trackers.lastYear) {
+    model->trackers.yearlyGpp = 0.0;
+    model->trackers.yearlyRtot = 0.0;
+    model->trackers.yearlyRa = 0.0;
+    model->trackers.yearlyRh = 0.0;
+    model->trackers.yearlyNpp = 0.0;
+    model->trackers.yearlyNee = 0.0;
+    model->trackers.gdd = 0.0;
 
-    trackers.lastYear = climate->year;
+    model->trackers.lastYear = model->climate->year;
   }
 
-  trackers.gpp = fluxes.photosynthesis * climate->length;
+  model->trackers.gpp = model->fluxes.photosynthesis * model->climate->length;
 
   // everything that is microbial
-  trackers.rh = (fluxes.rLitter + fluxes.rSoil) * climate->length;
+  model->trackers.rh = (model->fluxes.rLitter + model->fluxes.rSoil) *
+                       model->climate->length;
 
   // This is wood plus leaf respiration
-  trackers.rAboveground = (fluxes.rVeg) * climate->length;
-
-  trackers.rRoot = (fluxes.rCoarseRoot + fluxes.rFineRoot) * climate->length;
-  trackers.rSoil = trackers.rRoot + trackers.rh;
-  trackers.ra = trackers.rRoot + trackers.rAboveground;
-  trackers.rtot = trackers.ra + trackers.rh;
-  trackers.npp = trackers.gpp - trackers.ra;
-  trackers.nee = -1.0 * (trackers.npp - trackers.rh);
-
-  trackers.yearlyGpp += trackers.gpp;
-  trackers.yearlyRa += trackers.ra;
-  trackers.yearlyRh += trackers.rh;
-  trackers.yearlyRtot += trackers.rtot;
-  trackers.yearlyNpp += trackers.npp;
-  trackers.yearlyNee += trackers.nee;
-
-  trackers.totGpp += trackers.gpp;
-  trackers.totRa += trackers.ra;
-  trackers.totRh += trackers.rh;
-  trackers.totRtot += trackers.rtot;
-  trackers.totNpp += trackers.npp;
-  trackers.totNee += trackers.nee;
-  trackers.woodCreation = fluxes.woodCreation * climate->length;
-
-  trackers.methane =
-      (fluxes.soilMethane + fluxes.litterMethane) * climate->length;
+  model->trackers.rAboveground = (model->fluxes.rVeg) * model->climate->length;
+
+  model->trackers.rRoot = (model->fluxes.rCoarseRoot +
+                           model->fluxes.rFineRoot) * model->climate->length;
+  model->trackers.rSoil = model->trackers.rRoot + model->trackers.rh;
+  model->trackers.ra = model->trackers.rRoot + model->trackers.rAboveground;
+  model->trackers.rtot = model->trackers.ra + model->trackers.rh;
+  model->trackers.npp = model->trackers.gpp - model->trackers.ra;
+  model->trackers.nee = -1.0 * (model->trackers.npp - model->trackers.rh);
+
+  model->trackers.yearlyGpp += model->trackers.gpp;
+  model->trackers.yearlyRa += model->trackers.ra;
+  model->trackers.yearlyRh += model->trackers.rh;
+  model->trackers.yearlyRtot += model->trackers.rtot;
+  model->trackers.yearlyNpp += model->trackers.npp;
+  model->trackers.yearlyNee += model->trackers.nee;
+
+  model->trackers.totGpp += model->trackers.gpp;
+  model->trackers.totRa += model->trackers.ra;
+  model->trackers.totRh += model->trackers.rh;
+  model->trackers.totRtot += model->trackers.rtot;
+  model->trackers.totNpp += model->trackers.npp;
+  model->trackers.totNee += model->trackers.nee;
+  model->trackers.woodCreation = model->fluxes.woodCreation *
+                                 model->climate->length;
+
+  model->trackers.methane = (model->fluxes.soilMethane +
+                             model->fluxes.litterMethane) *
+                            model->climate->length;
 
   // evapotranspiration includes water lost to evaporation from canopy
   // irrigation (fluxes.eventEvap)
-  trackers.evapotranspiration =
-      (fluxes.transpiration + fluxes.immedEvap + fluxes.evaporation +
-       fluxes.sublimation + fluxes.eventEvap) *
-      climate->length;
+  model->trackers.evapotranspiration =
+      (model->fluxes.transpiration + model->fluxes.immedEvap +
+       model->fluxes.evaporation + model->fluxes.sublimation +
+       model->fluxes.eventEvap) * model->climate->length;
 
-  trackers.soilWetnessFrac =
-      (oldSoilWater + envi.soilWater) / (2.0 * params.soilWHC);
+  model->trackers.soilWetnessFrac = (oldSoilWater + model->envi.soilWater) /
+                                    (2.0 * model->params.soilWHC);
 
   // If we get another event flux in this function, we should create an
   // updateTrackersForEvents() function in events.c|h
-  trackers.yearlyLitter += fluxes.leafLitter + fluxes.eventLeafOffLitter;
+  model->trackers.yearlyLitter += model->fluxes.leafLitter +
+                                  model->fluxes.eventLeafOffLitter;
 
   if (ctx.gdd) {
-    trackers.gdd += climate->gdd;
+    model->trackers.gdd += model->climate->gdd;
   } else {
-    trackers.gdd = 0.0;
+    model->trackers.gdd = 0.0;
   }
 
-  double mean_npp = getMeanTrackerMean(meanNPP);
-  trackers.meanNPP = mean_npp;
+  double mean_npp = getMeanTrackerMean(model->meanNPP);
+  model->trackers.meanNPP = mean_npp;
 
   // N cycle trackers
   if (ctx.nitrogenCycle) {
-    trackers.n2o = fluxes.nVolatilization * climate->length;
-    trackers.nLeaching = fluxes.nLeaching * climate->length;
-    trackers.nFixation = fluxes.nFixation * climate->length;
-    trackers.nUptake = fluxes.nUptake * climate->length;
+    model->trackers.n2o = model->fluxes.nVolatilization *
+                          model->climate->length;
+    model->trackers.nLeaching = model->fluxes.nLeaching *
+                                model->climate->length;
+    model->trackers.nFixation = model->fluxes.nFixation *
+                                model->climate->length;
+    model->trackers.nUptake = model->fluxes.nUptake * model->climate->length;
   }
 }
 
 // initialize phenology tracker structure, based on day of year of first climate
 // record (have the leaves come on yet this year? have they fallen off yet this
 // year?)
-void initPhenologyTrackers(void) {
+void initPhenologyTrackers(SipnetModel *model) {
 
-  phenologyTrackers.didLeafGrowth = pastLeafGrowth();  // first year: have we
-                                                       // passed growing season
-                                                       // start date?
-  phenologyTrackers.didLeafFall = pastLeafFall();  // first year: have we passed
-                                                   // growing season end date?
+  // first year: have we passed growing season start date?
+  model->phenologyTrackers.didLeafGrowth = pastLeafGrowth(model);
+  // first year: have we passed growing season end date?
+  model->phenologyTrackers.didLeafFall = pastLeafFall(model);
 
   /* if we think we've done leaf fall this year but not leaf growth, something's
      wrong this could happen if, e.g. we're using soil temp-based leaf growth,
@@ -1517,34 +1945,35 @@ void initPhenologyTrackers(void) {
      have problems with GDD-based growth if first day of simulation is not
      Jan. 1.)
   */
-  if (phenologyTrackers.didLeafFall && !phenologyTrackers.didLeafGrowth) {
-    phenologyTrackers.didLeafGrowth = 1;
+  if (model->phenologyTrackers.didLeafFall &&
+      !model->phenologyTrackers.didLeafGrowth) {
+    model->phenologyTrackers.didLeafGrowth = 1;
   }
   // printf("stuff: %8d %8d \n",phenologyTrackers.lastYear, climate->year);
-  phenologyTrackers.lastYear = climate->year;  // set the year of the previous
-                                               // (non-existent) time step to be
-                                               // this year
+  // set the year of the previous (non-existent) time step to be this year
+  model->phenologyTrackers.lastYear = model->climate->year;
 }
 
 // Check that woodC and total root C are both positive
-int hasSufficientBiomass(void) {
-  double totalWoodC = getTotalWoodC();
-  double totalRootC = envi.fineRootC + envi.coarseRootC;
+int hasSufficientBiomass(SipnetModel *model) {
+  double totalWoodC = getTotalWoodC(model);
+  double totalRootC = model->envi.fineRootC + model->envi.coarseRootC;
   // We want to check that both plantWoodC AND totalWoodC are positive, as well
   // as totalRootC
-  return envi.plantWoodC > TINY && totalWoodC > TINY && totalRootC > TINY;
+  return model->envi.plantWoodC > TINY && totalWoodC > TINY &&
+         totalRootC > TINY;
 }
 
-void initPlantSurvivalTracker(void) {
-  if (hasSufficientBiomass()) {
-    plantSurvivalTracker.isAlive = 1;
+void initPlantSurvivalTracker(SipnetModel *model) {
+  if (hasSufficientBiomass(model)) {
+    model->plantSurvivalTracker.isAlive = 1;
   } else {
-    plantSurvivalTracker.isAlive = 0;
+    model->plantSurvivalTracker.isAlive = 0;
   }
 }
 
-void updateMeanTrackers(void) {
-  if (!plantSurvivalTracker.isAlive) {
+void updateMeanTrackers(SipnetModel *model) {
+  if (!model->plantSurvivalTracker.isAlive) {
     // If the plant is dead, there's no NPP to add
     // In particular, if the plant JUST died (likely via harvest), we want to
     // avoid the lingering NPP from that time step.
@@ -1554,16 +1983,16 @@ void updateMeanTrackers(void) {
   double npp;  // net primary productivity, g C * m^-2 ground area * day^-1
   int err;
 
-  npp = fluxes.photosynthesis - fluxes.rVeg - fluxes.rCoarseRoot -
-        fluxes.rFineRoot;
+  npp = model->fluxes.photosynthesis - model->fluxes.rVeg -
+        model->fluxes.rCoarseRoot - model->fluxes.rFineRoot;
 
-  err = addValueToMeanTracker(meanNPP, npp, climate->length);  // update running
-                                                               // mean of NPP
+  // update running mean of NPP
+  err = addValueToMeanTracker(model->meanNPP, npp, model->climate->length);
   if (err != 0) {
     logError("Error type %d while trying to add value to NPP mean tracker in "
              "sipnet:updateMeanTrackers()\n",
              err);
-    logError("npp = %f, climate->length = %f\n", npp, climate->length);
+    logError("npp = %f, climate->length = %f\n", npp, model->climate->length);
     logError("Suggestion: try changing MEAN_NPP_MAX_ENTRIES in sipnet.c\n");
     exit(EXIT_CODE_INTERNAL_ERROR);
   }
@@ -1576,7 +2005,7 @@ void updateMeanTrackers(void) {
 /*!
  * Update the main pools, leafC, woodC, soil and snow
  */
-void updateMainPools(void) {
+void updateMainPools(SipnetModel *model) {
   // Update the stocks, with fluxes adjusted for length of time step.
   // Note: the soil C pool(s) (envi.soil, envi.fineRootC, envi.CoarseRootC)
   //   are updated in updatePoolsForSoil().
@@ -1591,22 +2020,25 @@ void updateMainPools(void) {
   // WOOD CARBON MODEL
   // As described in state.h, we split woodC into two pieces so that we can
   // track non-nitrogen-affecting changes
-  double r_a = fluxes.rVeg + fluxes.rFineRoot + fluxes.rCoarseRoot;
-  double nppAllocations = fluxes.leafCreation + fluxes.woodCreation +
-                          fluxes.fineRootCreation + fluxes.coarseRootCreation;
-  envi.plantCAccountingDelta +=
-      ((fluxes.photosynthesis - r_a) - nppAllocations) * climate->length;
-  envi.plantWoodC += (fluxes.woodCreation - fluxes.woodLitter -
-                      fluxes.leafOnCreationFromWood) *
-                     climate->length;
+  double r_a = model->fluxes.rVeg + model->fluxes.rFineRoot +
+               model->fluxes.rCoarseRoot;
+  double nppAllocations =
+      model->fluxes.leafCreation + model->fluxes.woodCreation +
+      model->fluxes.fineRootCreation + model->fluxes.coarseRootCreation;
+  model->envi.plantCAccountingDelta += ((model->fluxes.photosynthesis - r_a) -
+                                        nppAllocations) *
+                                       model->climate->length;
+  model->envi.plantWoodC +=
+      (model->fluxes.woodCreation - model->fluxes.woodLitter -
+       model->fluxes.leafOnCreationFromWood) * model->climate->length;
 
   // :: from [1], eq (A2), where:
   //     L   = fluxes.leafCreation
   //     L_L = fluxes.leafLitter
   // Note: we have split leafCreation into two parts
-  envi.plantLeafC +=
-      (fluxes.leafCreation + fluxes.leafOnCreation - fluxes.leafLitter) *
-      climate->length;
+  model->envi.plantLeafC += (model->fluxes.leafCreation +
+                             model->fluxes.leafOnCreation -
+                             model->fluxes.leafLitter) * model->climate->length;
 
   // :: from [1], eq (A4), where:
   //     P = (fluxes.rain - fluxes.immedEvap)
@@ -1614,15 +2046,16 @@ void updateMainPools(void) {
   //     D = (fluxes.bottomDrainage + fluxes.fastFlow)
   //    from [2], addition of fluxes.snowMelt, as well as the modifications in
   //    the terms above: immedEvap in P, evaporation in T, and fastFlow in D
-  envi.soilWater +=
-      (fluxes.rain + fluxes.snowMelt - fluxes.immedEvap - fluxes.fastFlow -
-       fluxes.evaporation - fluxes.transpiration - fluxes.drainage) *
-      climate->length;
+  model->envi.soilWater += (model->fluxes.rain + model->fluxes.snowMelt -
+                            model->fluxes.immedEvap - model->fluxes.fastFlow -
+                            model->fluxes.evaporation -
+                            model->fluxes.transpiration -
+                            model->fluxes.drainage) * model->climate->length;
 
   // if ctx.snow = 0, some or all of these fluxes will always be 0
   // :: from [2], addition of snowpack description
-  envi.snow += (fluxes.snowFall - fluxes.snowMelt - fluxes.sublimation) *
-               climate->length;
+  model->envi.snow += (model->fluxes.snowFall - model->fluxes.snowMelt -
+                       model->fluxes.sublimation) * model->climate->length;
 }
 
 /*!
@@ -1631,10 +2064,10 @@ void updateMainPools(void) {
  * Calculates soil respiration, method depending on the LITTER_POOL
  * flag. Updates carbon pools for soil, fine roots, and coarse roots.
  */
-void updatePoolsForSoil(void) {
+void updatePoolsForSoil(SipnetModel *model) {
   if (ctx.litterPool) {
-    double soilInputs =
-        fluxes.coarseRootLoss + fluxes.fineRootLoss + fluxes.litterToSoil;
+    double soilInputs = model->fluxes.coarseRootLoss +
+                        model->fluxes.fineRootLoss + model->fluxes.litterToSoil;
     // Adding soil carbon saturation functionality
     // soilFraction capped between zero and one
     // if envi.soilC > params.soilCSaturation (due to initialization or events)
@@ -1643,17 +2076,19 @@ void updatePoolsForSoil(void) {
     // pool below saturation level, all inputs will be directed to envi.litterC
     // pool while envi.soilC is above saturation level
     double saturationFraction =
-        ctx.carbonSaturation ? unitClip(envi.soilC / params.soilCSaturation)
+        ctx.carbonSaturation ? unitClip(model->envi.soilC /
+                                        model->params.soilCSaturation)
                              : 0.0;
     // :: from [2], litter model description
-    envi.litterC += (fluxes.woodLitter + fluxes.leafLitter +
-                     (soilInputs * saturationFraction) - fluxes.litterToSoil -
-                     fluxes.rLitter - fluxes.litterMethane) *
-                    climate->length;
+    model->envi.litterC +=
+        (model->fluxes.woodLitter + model->fluxes.leafLitter +
+         (soilInputs * saturationFraction) - model->fluxes.litterToSoil -
+         model->fluxes.rLitter - model->fluxes.litterMethane) *
+        model->climate->length;
     // from [2] and [3], litter and root terms respectively
-    envi.soilC += (soilInputs * (1 - saturationFraction) - fluxes.rSoil -
-                   fluxes.soilMethane) *
-                  climate->length;
+    model->envi.soilC += (soilInputs * (1 - saturationFraction) -
+                          model->fluxes.rSoil - model->fluxes.soilMethane) *
+                         model->climate->length;
   } else {
     // Normal pool (single pool, no microbes)
     // :: from [1] (and others, TBD), eq (A3), where:
@@ -1661,22 +2096,24 @@ void updatePoolsForSoil(void) {
     //     L_l = fluxes.leafLitter
     //     R_h = fluxes.rSoil
     // :: from [3], root terms
-    envi.soilC +=
-        (fluxes.coarseRootLoss + fluxes.fineRootLoss + fluxes.woodLitter +
-         fluxes.leafLitter - fluxes.rSoil - fluxes.soilMethane) *
-        climate->length;
+    model->envi.soilC += (model->fluxes.coarseRootLoss +
+                          model->fluxes.fineRootLoss +
+                          model->fluxes.woodLitter + model->fluxes.leafLitter -
+                          model->fluxes.rSoil - model->fluxes.soilMethane) *
+                         model->climate->length;
   }
 
   // :: from [3], root model description, except that we deal with
   //    respiration in the woodC calculations (or, put another way, it's
   //    implicit in the creation term)
-  double leafOnCreationFromRoot =
-      fluxes.leafOnCreation - fluxes.leafOnCreationFromWood;
-  envi.coarseRootC += (fluxes.coarseRootCreation - fluxes.coarseRootLoss -
-                       leafOnCreationFromRoot) *
-                      climate->length;
-  envi.fineRootC +=
-      (fluxes.fineRootCreation - fluxes.fineRootLoss) * climate->length;
+  double leafOnCreationFromRoot = model->fluxes.leafOnCreation -
+                                  model->fluxes.leafOnCreationFromWood;
+  model->envi.coarseRootC += (model->fluxes.coarseRootCreation -
+                              model->fluxes.coarseRootLoss -
+                              leafOnCreationFromRoot) * model->climate->length;
+  model->envi.fineRootC += (model->fluxes.fineRootCreation -
+                            model->fluxes.fineRootLoss) *
+                           model->climate->length;
 }
 
 /*!
@@ -1685,12 +2122,12 @@ void updatePoolsForSoil(void) {
  * This avoids mistaken warnings in succeeding steps. Also checks for plant
  * reemergence (say, after a planting)
  */
-void checkForMortality(void) {
+void checkForMortality(SipnetModel *model) {
   // Transition check 1: plant was dead, but is back
-  if (!plantSurvivalTracker.isAlive) {
-    if (hasSufficientBiomass()) {
+  if (!model->plantSurvivalTracker.isAlive) {
+    if (hasSufficientBiomass(model)) {
       // It's back!
-      plantSurvivalTracker.isAlive = 1;
+      model->plantSurvivalTracker.isAlive = 1;
     }
     // No cleanup needed for this transition
     return;
@@ -1699,29 +2136,31 @@ void checkForMortality(void) {
   // Transition check 2: plant was alive, but is now dead
 
   // Plant was alive last time step - are you still there?
-  if (!hasSufficientBiomass()) {
-    plantSurvivalTracker.isAlive = 0;
-    double totalWoodC = getTotalWoodC();
-    double totalRootC = envi.fineRootC + envi.coarseRootC;
-
-    if (eventTrackers.harvestFracRemoved +
-            eventTrackers.harvestFracTransferred >=
-        TINY) {
+  if (!hasSufficientBiomass(model)) {
+    model->plantSurvivalTracker.isAlive = 0;
+    double totalWoodC = getTotalWoodC(model);
+    double totalRootC = model->envi.fineRootC + model->envi.coarseRootC;
+
+    if (model->eventTrackers.harvestFracRemoved +
+        model->eventTrackers.harvestFracTransferred >= TINY) {
       logInfo("Plant mortality detected after harvest event: total fraction "
               "removed %.3f total fraction transferred %.3f; woodC %f "
               "totalWoodC %f coarseRootC %f fineRootC %f year %d day %d "
               "time %6.3f; zeroing out biomass pools\n",
-              eventTrackers.harvestFracRemoved,
-              eventTrackers.harvestFracTransferred, envi.plantWoodC, totalWoodC,
-              envi.coarseRootC, envi.fineRootC, climate->year, climate->day,
-              climate->time);
+              model->eventTrackers.harvestFracRemoved,
+              model->eventTrackers.harvestFracTransferred,
+                  model->envi.plantWoodC, totalWoodC,
+              model->envi.coarseRootC, model->envi.fineRootC,
+                  model->climate->year, model->climate->day,
+              model->climate->time);
     } else {
       logWarning(
           "Plant mortality detected as wood or total root carbon is zero "
           "or negative: woodC %f totalWoodC %f coarseRootC %f fineRootC %f "
           "year %d day %d time %6.3f; zeroing out biomass pools\n",
-          envi.plantWoodC, totalWoodC, envi.coarseRootC, envi.fineRootC,
-          climate->year, climate->day, climate->time);
+          model->envi.plantWoodC, totalWoodC, model->envi.coarseRootC,
+              model->envi.fineRootC,
+          model->climate->year, model->climate->day, model->climate->time);
     }
 
     // Move remnants to litter/soil as appropriate. Note we add all pools, even
@@ -1729,80 +2168,83 @@ void checkForMortality(void) {
     // multiple processes being modeled, it's believable that there may be a bit
     // of overshoot when a plant dies - for example, a 100% harvest event with
     // any overall loss (respiration, turnover).
-    envi.soilC += totalRootC;
+    model->envi.soilC += totalRootC;
     if (ctx.litterPool) {
-      envi.litterC +=
-          envi.plantWoodC + envi.plantLeafC + envi.plantCAccountingDelta;
+      model->envi.litterC += model->envi.plantWoodC + model->envi.plantLeafC +
+                             model->envi.plantCAccountingDelta;
     } else {
-      envi.soilC +=
-          envi.plantWoodC + envi.plantLeafC + envi.plantCAccountingDelta;
+      model->envi.soilC += model->envi.plantWoodC + model->envi.plantLeafC +
+                           model->envi.plantCAccountingDelta;
     }
     if (ctx.nitrogenCycle) {  // litter pool implied
-      envi.soilOrgN +=
-          envi.fineRootC / params.fineRootCN + envi.coarseRootC / params.woodCN;
-      envi.litterN += envi.plantWoodC / params.woodCN +
-                      envi.plantLeafC / params.leafCN + envi.plantStorageN;
+      model->envi.soilOrgN += model->envi.fineRootC / model->params.fineRootCN +
+                              model->envi.coarseRootC / model->params.woodCN;
+      model->envi.litterN += model->envi.plantWoodC / model->params.woodCN +
+                             model->envi.plantLeafC / model->params.leafCN +
+                             model->envi.plantStorageN;
     }
 
     // Force pools to zero
-    envi.plantWoodC = 0.0;
-    envi.plantLeafC = 0.0;
-    envi.coarseRootC = 0.0;
-    envi.fineRootC = 0.0;
-    envi.plantCAccountingDelta = 0.0;
+    model->envi.plantWoodC = 0.0;
+    model->envi.plantLeafC = 0.0;
+    model->envi.coarseRootC = 0.0;
+    model->envi.fineRootC = 0.0;
+    model->envi.plantCAccountingDelta = 0.0;
     if (ctx.nitrogenCycle) {
-      envi.plantStorageN = 0.0;
+      model->envi.plantStorageN = 0.0;
     }
     // Reset mean npp tracker to zero; there's nothing to grow
-    resetMeanTracker(meanNPP, 0.0);
+    resetMeanTracker(model->meanNPP, 0.0);
 
     if (ctx.events) {
-      writeComputedEventOut(
-          climate->year, climate->day, eventTypeToString(PLANTDEATH), 4,
-          "harvestFracRemoved", eventTrackers.harvestFracRemoved,
-          "harvestFracTransferred", eventTrackers.harvestFracTransferred,
-          "totalWoodC", totalWoodC, "totalRootC", totalRootC);
+      writeComputedEventOut(model, model->climate->year, model->climate->day,
+                            eventTypeToString(PLANTDEATH), 4,
+                            "harvestFracRemoved",
+                            model->eventTrackers.harvestFracRemoved,
+                            "harvestFracTransferred",
+                            model->eventTrackers.harvestFracTransferred,
+                            "totalWoodC", totalWoodC, "totalRootC", totalRootC);
     }
   }
 }
 
-void updatePoolsAndBalance() {
+void updatePoolsAndBalance(SipnetModel *model) {
   // Calc total C and N before pool updates
-  updateBalanceTrackerPreUpdate();
+  updateBalanceTrackerPreUpdate(model);
 
   // Update pools for fluxes from events
   // There is a timing dependency for leaf-on events; event pools need to be
   // updated before the nitrogen pools so that the storage pool is handled
   // correctly. We put them first to be in sync with the order in
   // calculateFluxes().
-  updatePoolsForEvents();
+  updatePoolsForEvents(model);
 
   // Update leafC, woodC, soil water and snow pools
-  updateMainPools();
+  updateMainPools(model);
 
   // Update soil carbon pools
-  updatePoolsForSoil();
+  updatePoolsForSoil(model);
 
   // Update nitrogen cycle pools
   if (ctx.nitrogenCycle) {
-    updateNitrogenPools();
+    updateNitrogenPools(model);
   }
 
   // Calc total C and N after pool updates
-  updateBalanceTrackerPostUpdate();
+  updateBalanceTrackerPostUpdate(model);
 
   // Check for obvious plant death (wood and/or roots at zero)
-  checkForMortality();
+  checkForMortality(model);
 
   // Verify none of our stocks have gone negative (set any that are to zero).
-  ensureNonNegativeStocks();
+  ensureNonNegativeStocks(model);
 
   // Calc total C and N after non-negative check, and total system inputs and
   // outputs
-  updateBalanceTrackerPostClamp();
+  updateBalanceTrackerPostClamp(model);
 
   // Perform balance check
-  checkBalance();
+  checkBalance(model);
 }
 
 // ////////////////////////// //
@@ -1815,17 +2257,17 @@ void updatePoolsAndBalance() {
  * Calculate all fluxes before updating state, as fluxes may depend on current
  * state, and we want all flux calcs to use the same state
  */
-void updateState(void) {
+void updateState(SipnetModel *model) {
   // how much soil water was there before we updated it?
   // Used in trackers
-  double oldSoilWater = envi.soilWater;
+  double oldSoilWater = model->envi.soilWater;
 
   ///////////////////////
   // 0. Per-step init
   // Reset all fluxes to zero before calculating anything this time step.
-  resetFluxes();
+  resetFluxes(model);
   // Set plant health
-  initPlantSurvivalTracker();
+  initPlantSurvivalTracker(model);
 
   ///////////////////////
   // 1. Calculate Fluxes
@@ -1833,29 +2275,30 @@ void updateState(void) {
   // All event handling, which is modeled as fluxes. Note that we have this
   // before the other fluxes so that everything is in place when we consider
   // N limitation at the end of calculateFluxes().
-  processEvents();
+  processEvents(model);
 
   // All non-event fluxes
-  calculateFluxes();
+  calculateFluxes(model);
 
   ///////////////////////
   // 2. Update Pools
 
   // Call the wrapper function that updates all pools and checks mass balance
-  updatePoolsAndBalance();
+  updatePoolsAndBalance(model);
 
   ///////////////////////
   // 3. Update trackers
 
-  updateTrackers(oldSoilWater);
+  updateTrackers(model, oldSoilWater);
 
-  updateMeanTrackers();
+  updateMeanTrackers(model);
 
-  updateEventTrackers();
+  updateEventTrackers(model);
 }
 
 // See sipnet.h
-void setupModel(void) {
+void setupModel(SipnetModel *model) {
+  model->unconvertedParams = model->params;
 
   // a test: use constant (measured) soil respiration:
   // make it so soil resp. is 5.2 g C m-2 day-1 at 10 degrees C,
@@ -1864,160 +2307,278 @@ void setupModel(void) {
 
   // ensure that all the allocation parameters sum up to something less than
   // one:
-  ensureAllocation();
+  ensureAllocation(model);
 
   ///
   /// PARAMS SETUP
 
   // change units of parameters:
-  params.baseVegResp /= 365.0;  // change from per-year to per-day rate
-  params.litterBreakdownRate /= 365.0;
-  params.baseSoilResp /= 365.0;
-  params.woodTurnoverRate /= 365.0;
-  params.leafTurnoverRate /= 365.0;
+  model->params.baseVegResp /= 365.0;  // change from per-year to per-day rate
+  model->params.litterBreakdownRate /= 365.0;
+  model->params.baseSoilResp /= 365.0;
+  model->params.woodTurnoverRate /= 365.0;
+  model->params.leafTurnoverRate /= 365.0;
 
   // calculate additional parameters:
-  params.psnTMax =
-      params.psnTOpt + (params.psnTOpt - params.psnTMin);  // assumed
-                                                           // symmetrical
+  // assumed symmetrical
+  model->params.psnTMax = model->params.psnTOpt +
+                          (model->params.psnTOpt - model->params.psnTMin);
 
-  envi.plantWoodC =
-      (1 - params.coarseRootFrac - params.fineRootFrac) * params.plantWoodInit;
-  envi.plantCAccountingDelta = 0.0;
-  envi.plantLeafC = params.laiInit * params.leafCSpWt;
+  model->envi.plantWoodC = (1 - model->params.coarseRootFrac -
+                            model->params.fineRootFrac) *
+                           model->params.plantWoodInit;
+  model->envi.plantCAccountingDelta = 0.0;
+  model->envi.plantLeafC = model->params.laiInit * model->params.leafCSpWt;
 
   if (ctx.litterPool) {
-    envi.litterC = params.litterInit;
+    model->envi.litterC = model->params.litterInit;
   } else {
     // Don't set a value if the litter pool is off
-    envi.litterC = 0.0;
+    model->envi.litterC = 0.0;
   }
-  envi.soilC = params.soilInit;
+  model->envi.soilC = model->params.soilInit;
 
   // change from per year to per day rate
-  params.fineRootTurnoverRate /= 365.0;
-  params.coarseRootTurnoverRate /= 365.0;
+  model->params.fineRootTurnoverRate /= 365.0;
+  model->params.coarseRootTurnoverRate /= 365.0;
 
-  params.baseCoarseRootResp /= 365.0;
-  params.baseFineRootResp /= 365.0;
+  model->params.baseCoarseRootResp /= 365.0;
+  model->params.baseFineRootResp /= 365.0;
 
   /* Ensure fAnoxia stays within (0, 1) to avoid division by zero and NaNs */
-  if (params.fAnoxia <= 0.0) {
-    params.fAnoxia = TINY;
-  } else if (params.fAnoxia >= 1.0) {
-    params.fAnoxia = 1.0 - TINY;
+  if (model->params.fAnoxia <= 0.0) {
+    model->params.fAnoxia = TINY;
+  } else if (model->params.fAnoxia >= 1.0) {
+    model->params.fAnoxia = 1.0 - TINY;
   }
 
   // Constraint anaerobic decomp rate to (0,1]
-  if (params.anaerobicDecompRate <= 0.0) {
-    params.anaerobicDecompRate = TINY;
-  } else if (params.anaerobicDecompRate > 1.0) {
-    params.anaerobicDecompRate = 1.0;
+  if (model->params.anaerobicDecompRate <= 0.0) {
+    model->params.anaerobicDecompRate = TINY;
+  } else if (model->params.anaerobicDecompRate > 1.0) {
+    model->params.anaerobicDecompRate = 1.0;
   }
 
   ///
   /// ENVIRONMENT SETUP
 
-  envi.coarseRootC = params.coarseRootFrac * params.plantWoodInit;
-  envi.fineRootC = params.fineRootFrac * params.plantWoodInit;
+  model->envi.coarseRootC = model->params.coarseRootFrac *
+                            model->params.plantWoodInit;
+  model->envi.fineRootC = model->params.fineRootFrac *
+                          model->params.plantWoodInit;
 
-  envi.soilWater = params.soilWFracInit * params.soilWHC;
-  if (envi.soilWater < 0) {
-    envi.soilWater = 0;
+  model->envi.soilWater = model->params.soilWFracInit * model->params.soilWHC;
+  if (model->envi.soilWater < 0) {
+    model->envi.soilWater = 0;
   }
 
-  envi.snow = params.snowInit;
+  model->envi.snow = model->params.snowInit;
 
   if (ctx.nitrogenCycle) {
-    envi.minN = params.minNInit;
-    envi.soilOrgN = params.soilOrgNInit;
-    envi.litterN = params.litterOrgNInit;
-    envi.plantStorageN = params.plantStorageNInit;
+    model->envi.minN = model->params.minNInit;
+    model->envi.soilOrgN = model->params.soilOrgNInit;
+    model->envi.litterN = model->params.litterOrgNInit;
+    model->envi.plantStorageN = model->params.plantStorageNInit;
   } else {
-    envi.minN = 0.0;
-    envi.soilOrgN = 0.0;
-    envi.litterN = 0.0;
-  }
+    model->envi.minN = 0.0;
+    model->envi.soilOrgN = 0.0;
+    model->envi.litterN = 0.0;
+  }
+
+  // Climate-derived terms, now that the parameters are final
+  updateForcing(model);
+  setClimateStep(model, 0);
+
+  initTrackers(model);
+  initPhenologyTrackers(model);
+  initEventTrackers(model);
+  initBalanceTracker(model);
+  resetMeanTracker(model->meanNPP, 0);  // initialize with mean NPP (over last
+                                        // MEAN_NPP_DAYS) of 0
+  restartResetRunState(model);
+}
 
-  climate = firstClimate;
+// Step the model through the rest of its climate data, then finish the
+// outputs and write any checkpoints asked for
+static void stepModelOutput(SipnetModel *model, FILE *out,
+                            DebugLogFiles *debugLogFiles,
+                            OutputItems *outputItems) {
+  if (ctx.asyncOutput) {
+    model->asyncOut = newAsyncOutput();
+  }
+  while (model->climate != NULL) {
+    updateState(model);
+    if (hasMainOutput(model, out)) {
+      outputState(model, out, model->climate->year, model->climate->day,
+                  model->climate->time);
+    }
+    outputDebugState(model, debugLogFiles, model->climate->year,
+                     model->climate->day, model->climate->time);
+    if (outputItems != NULL) {
+      outputItemValues(model, outputItems);
+    }
+    // Always kept, so that a checkpoint can be taken in memory after the run
+    restartNoteProcessedClimateStep(model, model->climate);
+    restartPeriodicCheckpoint(model, out);
+    restartDatedCheckpoint(model);
+    setClimateStep(model, model->climateStep + 1);
+  }
 
-  initTrackers();
-  initPhenologyTrackers();
-  initEventTrackers();
-  initBalanceTracker();
-  resetMeanTracker(meanNPP, 0);  // initialize with mean NPP (over last
-                                 // MEAN_NPP_DAYS) of 0
-  restartResetRunState();
+  if (model->asyncOut != NULL) {
+    deleteAsyncOutput(model->asyncOut);
+    model->asyncOut = NULL;
+  }
+  finishMainOutput(model, out);
+  if (outputItems != NULL) {
+    finishOutputItems(outputItems);
+  }
+  restartFinishRun(model);
 }
 
 // See sipnet.h
-void runModelOutput(FILE *out, DebugLogFiles *debugLogFiles,
+void runModelOutput(SipnetModel *model, FILE *out, DebugLogFiles *debugLogFiles,
                     OutputItems *outputItems, int printHeader) {
-  if ((out != NULL) && printHeader) {
-    outputHeader(out);
-  }
+  startMainOutput(model, out, printHeader);
   if (printHeader) {
-    outputDebugHeaders(debugLogFiles);
+    outputDebugHeaders(model, debugLogFiles);
   }
 
-  setupModel();
-  setupEvents();
+  setupModel(model);
+  setupEvents(model);
   if (strlen(ctx.restartIn) > 0) {
-    restartLoadCheckpoint(ctx.restartIn, meanNPP);
+    restartLoadCheckpoint(model, ctx.restartIn);
+  } else if (ctx.autoResume) {
+    restartAutoResume(model);
+  }
+
+  stepModelOutput(model, out, debugLogFiles, outputItems);
+}
+
+// See sipnet.h
+void resumeModelOutput(SipnetModel *model, const void *checkpoint,
+                       size_t checkpointSize, FILE *out,
+                       DebugLogFiles *debugLogFiles, OutputItems *outputItems,
+                       int printHeader) {
+  startMainOutput(model, out, printHeader);
+  if (printHeader) {
+    outputDebugHeaders(model, debugLogFiles);
+  }
+
+  // Parameters are converted in place, so start again from the values read
+  model->params = model->unconvertedParams;
+  setupModel(model);
+  setupEvents(model);
+  if (model->climate != NULL) {
+    // Events of the segments already run have been applied
+    skipEventsBefore(model, model->climate->year, model->climate->day);
   }
+  restartLoadCheckpointFromBuffer(model, checkpoint, checkpointSize);
 
-  while (climate != NULL) {
-    updateState();
-    if (out != NULL) {
-      outputState(out, climate->year, climate->day, climate->time);
+  stepModelOutput(model, out, debugLogFiles, outputItems);
+}
+
+// See sipnet.h
+void setupOutputItems(SipnetModel *model, OutputItems *outputItems) {
+  // Short names kept from when each of these had a file of its own, and the
+  // registry variable each stands for
+  static const char *aliases[][2] = {{"NEE", "trackers.nee"},
+                                     {"NEE_cum", "trackers.totNee"},
+                                     {"GPP", "trackers.gpp"},
+                                     {"GPP_cum", "trackers.totGpp"}};
+  const char *item = (strlen(ctx.singleOutputVars) > 0)
+                         ? ctx.singleOutputVars
+                         : "NEE,NEE_cum,GPP,GPP_cum";
+  int hasError = 0;
+
+  while (*item != '\0') {
+    char name[CONTEXT_CHAR_MAXLEN];
+    size_t len = strcspn(item, ",");
+    const VarInfo *var = NULL;
+
+    memcpy(name, item, len);
+    name[len] = '\0';
+    for (size_t ind = 0; ind < sizeof(aliases) / sizeof(aliases[0]); ++ind) {
+      if (strcmp(name, aliases[ind][0]) == 0) {
+        var = requireVariable(aliases[ind][1]);
+      }
     }
-    outputDebugState(debugLogFiles, climate->year, climate->day, climate->time);
-    if (outputItems != NULL) {
-      writeOutputItemValues(outputItems);
+    if (var == NULL) {
+      var = findVariable(name);
     }
-    if (strlen(ctx.restartOut) > 0) {
-      restartNoteProcessedClimateStep(climate);
+    if (var != NULL) {
+      addOutputItem(outputItems, name, var->units,
+                    getVariableAddress(model, var), var->type);
+    } else if (len > 0) {
+      logError("single-output-vars: %s is not a model variable\n", name);
+      hasError = 1;
+    }
+    item += len;
+    if (*item == ',') {
+      ++item;
     }
-    climate = climate->nextClim;
-  }
-
-  if (outputItems != NULL) {
-    terminateOutputItemLines(outputItems);
   }
-  if (strlen(ctx.restartOut) > 0) {
-    restartWriteCheckpoint(ctx.restartOut, meanNPP);
+  if (hasError) {
+    exit(EXIT_CODE_BAD_PARAMETER_VALUE);
   }
+
+  openOutputItems(outputItems, ctx.outputFormat, ctx.printHeader);
 }
 
 // See sipnet.h
-void setupOutputItems(OutputItems *outputItems) {
-  addOutputItem(outputItems, "NEE", &(trackers.nee));
-  addOutputItem(outputItems, "NEE_cum", &(trackers.totNee));
-  addOutputItem(outputItems, "GPP", &(trackers.gpp));
-  addOutputItem(outputItems, "GPP_cum", &(trackers.totGpp));
+void initModel(SipnetModel *model, ModelParams **modelParams,
+               const char *paramFile, const char *climFile) {
+  readParamData(model, modelParams, paramFile);
+  model->unconvertedParams = model->params;
+  readClimData(model, climFile);
+
+  initDebugArrays(model);
+
+  model->meanNPP = newMeanTracker(0, MEAN_NPP_DAYS, MEAN_NPP_MAX_ENTRIES);
 }
 
 // See sipnet.h
-void initModel(ModelParams **modelParams, const char *paramFile,
-               const char *climFile) {
-  readParamData(modelParams, paramFile);
-  readClimData(climFile);
+void initModelWithClimate(SipnetModel *model, ModelParams **modelParams,
+                          const char *paramFile, ClimateData *climateData) {
+  readParamData(model, modelParams, paramFile);
+  model->unconvertedParams = model->params;
+  model->climateData = climateData;
+  model->sharedClimate = 1;
 
-  initDebugArrays();
+  initDebugArrays(model);
 
-  meanNPP = newMeanTracker(0, MEAN_NPP_DAYS, MEAN_NPP_MAX_ENTRIES);
+  model->meanNPP = newMeanTracker(0, MEAN_NPP_DAYS, MEAN_NPP_MAX_ENTRIES);
 }
 
 // See sipnet.h
-void cleanupModel() {
-  freeClimateList();
+void setModelClimate(SipnetModel *model, ClimateData *climateData) {
+  freeClimateList(model);
+  model->climateData = climateData;
+  model->climateChunkStart = 0;
+  model->sharedClimate = 1;
+}
 
-  deallocateMeanTracker(meanNPP);
+// See sipnet.h
+void cleanupModel(SipnetModel *model) {
+  freeClimateList(model);
+
+  deallocateMeanTracker(model->meanNPP);
   if (ctx.events) {
-    freeEventList();
-    closeEventOutFile();
+    freeEventList(model);
+    closeEventOutFile(model);
   }
 
-  freeDebugArrays();
-  freeContextMetadata();
+  freeDebugArrays(model);
 }
+
+// See sipnet.h
+SipnetModel *newSipnetModel(void) {
+  SipnetModel *model = (SipnetModel *)calloc(1, sizeof(SipnetModel));
+  if (model == NULL) {
+    logError("memory allocation failure creating model\n");
+    exit(EXIT_CODE_INTERNAL_ERROR);
+  }
+  return model;
+}
+
+// See sipnet.h
+void deleteSipnetModel(SipnetModel *model) { free(model); }
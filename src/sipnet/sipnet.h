@@ -5,7 +5,9 @@
 
 #include <stdio.h>
 #include "common/modelParams.h"
+#include "climate.h"
 #include "debug_log.h"
+#include "model.h"
 #include "outputItems.h"
 
 // write to file which model components are turned on
@@ -13,18 +15,72 @@
 // pre: out is open for writing
 void printModelComponents(FILE *out);
 
+/*!
+ * Allocate a new, zeroed model instance
+ *
+ * The returned model must be initialized with initModel() before it is run,
+ * and released with cleanupModel() and deleteSipnetModel() when done.
+ */
+SipnetModel *newSipnetModel(void);
+
+/*!
+ * Free a model instance allocated with newSipnetModel()
+ *
+ * Call cleanupModel() first to release the memory the model owns.
+ */
+void deleteSipnetModel(SipnetModel *model);
+
 /*!
  * Do model initializations
  *
  * Read in initial parameter values and climate data. Also set up pointers to
  * different output data types and allocate tracker structs.
  *
+ * @param model model instance to initialize
  * @param modelParams pointer to ModelParams struct, will be alloc'd here
  * @param paramFile name of parameter file
  * @param climFile name of climate file
  */
-void initModel(ModelParams **modelParams, const char *paramFile,
-               const char *climFile);
+void initModel(SipnetModel *model, ModelParams **modelParams,
+               const char *paramFile, const char *climFile);
+
+/*!
+ * Do model initializations, using climate data read by the caller
+ *
+ * Like initModel(), but the model runs over climateData instead of reading
+ * its own copy. The data is only read while the model runs, so any number of
+ * models may share it, including from different threads; the caller keeps
+ * ownership and frees it with freeClimate() once all models are cleaned up.
+ *
+ * @param model model instance to initialize
+ * @param modelParams pointer to ModelParams struct, will be alloc'd here
+ * @param paramFile name of parameter file
+ * @param climateData climate data returned by readClimate()
+ */
+void initModelWithClimate(SipnetModel *model, ModelParams **modelParams,
+                          const char *paramFile, ClimateData *climateData);
+
+/*!
+ * Run the model over different climate data from now on
+ *
+ * Frees the climate data the model read itself, if any; as with
+ * initModelWithClimate(), climateData stays the caller's to free.
+ *
+ * @param model model instance
+ * @param climateData climate data returned by readClimate()
+ */
+void setModelClimate(SipnetModel *model, ClimateData *climateData);
+
+/*!
+ * Make the given step of the model's climate data the current step
+ *
+ * Copies that step's values to model->currentClimate and points
+ * model->climate at it; past the last step, model->climate is set to NULL.
+ *
+ * @param model model instance
+ * @param step index of the climate step, starting at 0
+ */
+void setClimateStep(SipnetModel *model, long step);
 
 /*!
  * Setup model for run
@@ -32,17 +88,19 @@ void initModel(ModelParams **modelParams, const char *paramFile,
  * Set calculated parameters, do parameter conversions, and initialize
  * tracker structs.
  */
-void setupModel(void);
+void setupModel(SipnetModel *model);
 
 /*!
- * Free allocated memory
+ * Free memory owned by the model
  *
- * Call this when done running model
+ * Call this when done running model; the model struct itself is freed by
+ * deleteSipnetModel()
  */
-void cleanupModel(void);
+void cleanupModel(SipnetModel *model);
 
 /*! Run the model using parameter values in modelParams
  *
+ * @param model model instance to run; must have been set up with initModel()
  * @param out File pointer for main output; can be null to suppress this
  * @param debugLogFiles File pointers for debug logs; can be null to
  *                         suppress debug logging
@@ -50,17 +108,160 @@ void cleanupModel(void);
  *                    Can be null to suppress this output
  * @param printHeader Whether to print a header row in output files
  */
-void runModelOutput(FILE *out, DebugLogFiles *debugLogFiles,
+void runModelOutput(SipnetModel *model, FILE *out, DebugLogFiles *debugLogFiles,
                     OutputItems *outputItems, int printHeader);
 
 /*!
-   Setup outputItems structure
+ * Resume a run in the same process from a checkpoint held in memory
+ *
+ * As runModelOutput() with --restart-in, without the checkpoint file or a new
+ * process: the model is set up again, its state loaded from checkpoint, and
+ * run over its climate data, which must start the day after the checkpoint
+ * (see setModelClimate()). Events before that day are skipped. For state data
+ * assimilation, a caller takes a checkpoint with
+ * restartWriteCheckpointToBuffer() after each segment, edits it, and resumes
+ * from it here.
+ *
+ * @param model model instance that has already run, or one just set up with
+ *              initModel() or initModelWithClimate() that hasn't
+ * @param checkpoint checkpoint from restartWriteCheckpointToBuffer()
+ * @param checkpointSize size of the checkpoint in bytes
+ * @param out, debugLogFiles, outputItems, printHeader as for runModelOutput()
+ */
+void resumeModelOutput(SipnetModel *model, const void *checkpoint,
+                       size_t checkpointSize, FILE *out,
+                       DebugLogFiles *debugLogFiles, OutputItems *outputItems,
+                       int printHeader);
+
+/*!
+ * Suffix of the main output file for the configured output format: ".nc" for
+ * NetCDF, ".out" otherwise, followed by the compression suffix with
+ * --compress-output
+ */
+const char *mainOutputSuffix(void);
+
+/*!
+ * Open the main output file
+ *
+ * NetCDF files are written by the NetCDF library rather than through a FILE;
+ * for NetCDF output, the file is created and its writer attached to the model
+ * (model->netcdfOut), and NULL is returned. The writer is closed by
+ * finishMainOutput(). With model->continueOutputs, the file is appended to;
+ * pass startMainOutput() a printHeader of 0 then.
+ *
+ * @param model model instance
+ * @param path file to write; see mainOutputSuffix()
+ * @return the file, open for writing and compressed as --compress-output says
+ *         (see compressedOutput.h), or NULL for NetCDF output
+ */
+FILE *openMainOutput(SipnetModel *model, const char *path);
+
+/*!
+ * Nonzero if the model has a main output: out, or NetCDF output
+ */
+int hasMainOutput(const SipnetModel *model, FILE *out);
+
+/*!
+ * Print header row to the main output file
+ *
+ * @param model model instance, for the columns selected by output-vars
+ * @param out File pointer for output
+ */
+void outputHeader(SipnetModel *model, FILE *out);
+
+/*!
+ * Print the model's current state as a row of the main output file
+ *
+ * Once startMainOutput() has started binary output, the row is added to the
+ * current block instead, and out is not used. When output is aggregated by
+ * period (ctx.outputPeriod), the step is added to its period instead, and a
+ * row is only written when the step starts a new period. When the model has asynchronous
+ * output (model->asyncOut), the row's values are queued, and written later on
+ * the writer thread.
+ *
+ * @param model model instance
+ * @param out File pointer for output
+ * @param year year of the current step
+ * @param day day of the current step
+ * @param time time of the current step
+ */
+void outputState(SipnetModel *model, FILE *out, int year, int day,
+                 double time);
+
+/*!
+ * Write the current values of the single-variable outputs
+ *
+ * Like writeOutputItemValues(), for the current climate step, but queues the
+ * row when the model has asynchronous output.
+ *
+ * @param model model instance
+ * @param outputItems single-variable outputs to write
+ */
+void outputItemValues(SipnetModel *model, OutputItems *outputItems);
+
+/*!
+ * Start the main output file: write its header, if any, in the configured
+ * output format (ctx.outputFormat)
+ *
+ * Also selects the columns listed in ctx.outputVars (year, day and time are
+ * always included), exiting with an error if any name listed there is not a
+ * column of the main output or a field of the debug logs.
+ *
+ * Text output only gets a header row if printHeader is set; binary and NetCDF
+ * output always start with a description of their columns, and their rows are
+ * buffered in the model until finishMainOutput().
+ *
+ * @param model model instance
+ * @param out File pointer for output; NULL for NetCDF or no main output
+ * @param printHeader Whether to print a header row in text output
+ */
+void startMainOutput(SipnetModel *model, FILE *out, int printHeader);
+
+/*!
+ * Finish the main output file, writing any rows still buffered
+ *
+ * When output is aggregated by period, the current period is written as it
+ * stands, even if partial. Does not close out; NetCDF output is closed.
+ *
+ * @param model model instance
+ * @param out File pointer for output, as passed to startMainOutput()
+ */
+void finishMainOutput(SipnetModel *model, FILE *out);
+
+/*!
+ * Calculate all fluxes and update state for one time step
+ *
+ * @param model model instance, at the climate step to compute
+ */
+void updateState(SipnetModel *model);
+
+/*!
+ * Compute canopy light effect
+ *
+ * @param model model instance
+ * @param[out] lightEff Canopy average light effect
+ * @param lai Leaf area index (m^2 leaf/m^2 ground)
+ * @param par Incoming Photosynthetically Active Radiation (PAR)
+ */
+void calcLightEff(SipnetModel *model, double *lightEff, double lai, double par);
+
+/*!
+ * Calculate rain and snowfall, and immediate evaporation (all cm/day)
+ */
+void calcPrecip(SipnetModel *model, double *rain, double *snowFall,
+                double *immedEvap, double lai);
+
+/*!
+   Setup outputItems structure, and open its output file
 
-   Each variable added will be output in a separate file ('*.varName')
+   The variables listed in ctx.singleOutputVars (or NEE, NEE_cum, GPP and
+   GPP_cum, if it is empty) are added, each written to a
+   column of <file-prefix>.single; exits if one isn't a model variable
 
+   @param model model instance whose values are written
    @param outputItems OutputItems struct to be filled out; must be created with
                       newOutputItems()
  */
-void setupOutputItems(OutputItems *outputItems);
+void setupOutputItems(SipnetModel *model, OutputItems *outputItems);
 
 #endif
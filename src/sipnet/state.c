@@ -1,19 +1,7 @@
-// Definition of global state variables
+// Helpers for reading model state
 
-#include "state.h"
+#include "model.h"
 
-// linked list of climate variables
-// one node for each time step
-// these climate data are read in from a file
-ClimateNode *firstClimate;  // pointer to first climate
-ClimateNode *climate;  // current climate
-Params params;
-Envi envi;  // state variables
-Fluxes fluxes;  // fluxes
-Trackers trackers;
-PhenologyTrackers phenologyTrackers;
-PlantSurvivalTracker plantSurvivalTracker;
-
-double getTotalWoodC(void) {
-  return envi.plantWoodC + envi.plantCAccountingDelta;
+double getTotalWoodC(SipnetModel *model) {
+  return model->envi.plantWoodC + model->envi.plantCAccountingDelta;
 }
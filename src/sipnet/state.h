@@ -1,14 +1,20 @@
 #ifndef SIPNET_STATE_H
 #define SIPNET_STATE_H
 
+#include <stddef.h>
+
 // See sipnet.c for the list of references cited below. In short:
 // [1] Braswell et al., 2005
 // [2] Sacks et al., 2006
 // [3] Zobitz et al., 2008
 // [4] LeBauer et al., unpublished
 
+// Model instance holding all run state; defined in model.h
+typedef struct SipnetModel SipnetModel;
+
 typedef struct ClimateVars ClimateNode;
 
+// Climate forcing for a single time step
 struct ClimateVars {
   // year of start of this timestep
   int year;
@@ -45,12 +51,54 @@ struct ClimateVars {
   // NOTE: Calculated, *not* read from file
   double gdd;
 
-  ClimateNode *nextClim;
+  // Terms derived from this step's climate and the parameters; see forcing.h
+  // NOTE: Calculated, *not* read from file
+  //
+  // effect of air temperature on photosynthesis (range: [0:1])
+  double dTemp;
+  // decrease in leaf gas exchange due to vapor pressure deficit
+  double dVpd;
+  // Q10 effect of air temperature on foliar respiration, relative to psnTOpt
+  double folRespTempEffect;
+  // Q10 effect of air temperature on wood respiration
+  double woodRespTempEffect;
+  // Q10 effect of soil temperature on soil and litter respiration, see
+  // calcTempEffect()
+  double soilTempEffect;
+  // Q10 effects of soil temperature on coarse and fine root respiration
+  double coarseRootTempEffect;
+  double fineRootTempEffect;
+  // aerodynamic resistance between ground and canopy air space (sec/m)
+  double rd;
 };
 
-// Global vars
-extern ClimateNode *firstClimate;  // pointer to first climate
-extern ClimateNode *climate;  // current climate
+// Climate forcing for a whole run, stored as one array per variable; element
+// i of each array belongs to time step i. See ClimateVars for the meaning and
+// units of each variable. The struct and all of its arrays share a single
+// allocation.
+typedef struct ClimateData {
+  // number of time steps
+  long numSteps;
+
+  int *year;
+  int *day;
+  double *time;
+  double *length;
+  double *tair;
+  double *tsoil;
+  double *par;
+  double *precip;
+  double *vpd;
+  double *vpdSoil;
+  double *vPress;
+  double *wspd;
+  double *gdd;
+
+  // Memory-mapped cache file holding the arrays (see climate_cache.h), or NULL
+  // when the arrays share the struct's allocation
+  void *mapping;
+  size_t mappingSize;
+} ClimateData;
 
 #define NUM_CLIM_FILE_COLS 12
 #define NUM_CLIM_FILE_COLS_LEGACY (NUM_CLIM_FILE_COLS + 2)
@@ -409,9 +457,6 @@ typedef struct Parameters {
 
 #define NUM_PARAMS (sizeof(Params) / sizeof(double))
 
-// Global var
-extern Params params;
-
 // the state of the environment
 typedef struct Environment {
   ///// From [1] Braswell et al. 2005
@@ -462,9 +507,6 @@ typedef struct Environment {
   double plantCAccountingDelta;
 } Envi;
 
-// Global var
-extern Envi envi;  // state variables
-
 // fluxes as per-day rates
 typedef struct FluxVars {
   // ****************************************
@@ -644,9 +686,6 @@ typedef struct FluxVars {
   double litterMethane;
 } Fluxes;
 
-// Global var
-extern Fluxes fluxes;
-
 typedef struct TrackerVars {  // variables to track various things
   // g C * m^-2 taken up in this time interval; GROSS photosynthesis
   double gpp;
@@ -725,9 +764,6 @@ typedef struct TrackerVars {  // variables to track various things
   double meanNPP;
 } Trackers;
 
-// Global var
-extern Trackers trackers;
-
 typedef struct PhenologyTrackersStruct {
   // variables to track each year's phenological development. Only used in
   // leafFluxes function, but made global so can be initialized dynamically,
@@ -743,16 +779,14 @@ typedef struct PhenologyTrackersStruct {
   int lastYear;
 } PhenologyTrackers;
 
-// Global var
-extern PhenologyTrackers phenologyTrackers;
-
-// Global var
 typedef struct PlantSurvivalStruct {
   int isAlive;
 } PlantSurvivalTracker;
 
-extern PlantSurvivalTracker plantSurvivalTracker;
-
-double getTotalWoodC(void);
+/*!
+ * Total plant wood carbon, including the accounting delta
+ * @param model model instance to read from
+ */
+double getTotalWoodC(SipnetModel *model);
 
 #endif  // SIPNET_STATE_H
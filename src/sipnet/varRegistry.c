@@ -0,0 +1,274 @@
+// The registry of model state variables; see varRegistry.h
+
+#include "varRegistry.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/exitCodes.h"
+#include "common/logging.h"
+#include "common/uthash.h"
+#include "model.h"
+
+// Units shared by many variables
+#define C_POOL "g C m-2"
+#define N_POOL "g N m-2"
+#define C_FLUX "g C m-2 day-1"
+#define N_FLUX "g N m-2 day-1"
+#define WATER "cm"
+#define WATER_FLUX "cm day-1"
+
+#define VAR(group, prefix, member, field, type, units, kind)                   \
+  {prefix "." #field,                                                          \
+   #field,                                                                     \
+   group,                                                                      \
+   offsetof(SipnetModel, member.field),                                        \
+   type,                                                                       \
+   units,                                                                      \
+   kind}
+
+// Pools, sampled at the end of an output period
+#define ENVI(field, units)                                                     \
+  VAR(VAR_ENVI, "envi", envi, field, VAR_DOUBLE, units, COLUMN_LAST)
+// Rates, averaged over an output period
+#define FLUX(field, units)                                                     \
+  VAR(VAR_FLUXES, "fluxes", fluxes, field, VAR_DOUBLE, units, COLUMN_MEAN)
+#define TRACKER(field, units, kind)                                            \
+  VAR(VAR_TRACKERS, "trackers", trackers, field, VAR_DOUBLE, units, kind)
+#define TRACKER_INT(field, units)                                              \
+  VAR(VAR_TRACKERS, "trackers", trackers, field, VAR_INT, units, COLUMN_LAST)
+#define PHENOLOGY(field, units)                                                \
+  VAR(VAR_PHENOLOGY, "phenology", phenologyTrackers, field, VAR_INT, units,    \
+      COLUMN_LAST)
+#define SURVIVAL(field, units)                                                 \
+  VAR(VAR_SURVIVAL, "survival", plantSurvivalTracker, field, VAR_INT, units,   \
+      COLUMN_LAST)
+
+#define NUM_VARIABLES 106
+
+// Grouped by VarGroup, in struct order; restart checkpoints and the debug logs
+// list fields in this order
+static const VarInfo variables[] = {
+    ENVI(plantWoodC, C_POOL),
+    ENVI(plantLeafC, C_POOL),
+    ENVI(soilC, C_POOL),
+    ENVI(soilWater, WATER),
+    ENVI(litterC, C_POOL),
+    ENVI(snow, WATER),
+    ENVI(coarseRootC, C_POOL),
+    ENVI(fineRootC, C_POOL),
+    ENVI(minN, N_POOL),
+    ENVI(soilOrgN, N_POOL),
+    ENVI(litterN, N_POOL),
+    ENVI(plantStorageN, N_POOL),
+    ENVI(plantCAccountingDelta, C_POOL),
+
+    FLUX(photosynthesis, C_FLUX),
+    FLUX(leafLitter, C_FLUX),
+    FLUX(woodLitter, C_FLUX),
+    FLUX(rVeg, C_FLUX),
+    FLUX(rSoil, C_FLUX),
+    FLUX(rain, WATER_FLUX),
+    FLUX(transpiration, WATER_FLUX),
+    FLUX(drainage, WATER_FLUX),
+    FLUX(litterToSoil, C_FLUX),
+    FLUX(rLitter, C_FLUX),
+    FLUX(snowFall, WATER_FLUX),
+    FLUX(snowMelt, WATER_FLUX),
+    FLUX(sublimation, WATER_FLUX),
+    FLUX(immedEvap, WATER_FLUX),
+    FLUX(fastFlow, WATER_FLUX),
+    FLUX(evaporation, WATER_FLUX),
+    FLUX(fineRootLoss, C_FLUX),
+    FLUX(coarseRootLoss, C_FLUX),
+    FLUX(fineRootCreation, C_FLUX),
+    FLUX(coarseRootCreation, C_FLUX),
+    FLUX(rCoarseRoot, C_FLUX),
+    FLUX(rFineRoot, C_FLUX),
+    FLUX(leafCreation, C_FLUX),
+    FLUX(woodCreation, C_FLUX),
+    FLUX(leafOnCreation, C_FLUX),
+    FLUX(leafOnCreationFromWood, C_FLUX),
+    FLUX(nVolatilization, N_FLUX),
+    FLUX(nLeaching, N_FLUX),
+    FLUX(nOrgSoil, N_FLUX),
+    FLUX(nOrgLitter, N_FLUX),
+    FLUX(nMin, N_FLUX),
+    FLUX(nFixation, N_FLUX),
+    FLUX(nUptake, N_FLUX),
+    FLUX(leafOffNResorption, N_FLUX),
+    FLUX(reductionNResorption, N_FLUX),
+    FLUX(eventLeafC, C_FLUX),
+    FLUX(eventWoodC, C_FLUX),
+    FLUX(eventFineRootC, C_FLUX),
+    FLUX(eventCoarseRootC, C_FLUX),
+    FLUX(eventEvap, WATER_FLUX),
+    FLUX(eventSoilWater, WATER_FLUX),
+    FLUX(eventSoilC, C_FLUX),
+    FLUX(eventLitterC, C_FLUX),
+    FLUX(eventMinN, N_FLUX),
+    FLUX(eventSoilOrgN, N_FLUX),
+    FLUX(eventLitterN, N_FLUX),
+    FLUX(eventInputC, C_FLUX),
+    FLUX(eventOutputC, C_FLUX),
+    FLUX(eventInputN, N_FLUX),
+    FLUX(eventOutputN, N_FLUX),
+    FLUX(eventLeafOnCreation, C_FLUX),
+    FLUX(eventLeafOnCreationFromWood, C_FLUX),
+    FLUX(eventLeafOffLitter, C_FLUX),
+    FLUX(eventLeafOffNResorption, N_FLUX),
+    FLUX(soilMethane, C_FLUX),
+    FLUX(litterMethane, C_FLUX),
+
+    // Amounts over the step are summed; year-to-date and running totals are
+    // sampled
+    TRACKER(gpp, C_POOL, COLUMN_SUM),
+    TRACKER(rtot, C_POOL, COLUMN_SUM),
+    TRACKER(ra, C_POOL, COLUMN_SUM),
+    TRACKER(rh, C_POOL, COLUMN_SUM),
+    TRACKER(rRoot, C_POOL, COLUMN_SUM),
+    TRACKER(rSoil, C_POOL, COLUMN_SUM),
+    TRACKER(rAboveground, C_POOL, COLUMN_SUM),
+    TRACKER(npp, C_POOL, COLUMN_SUM),
+    TRACKER(nee, C_POOL, COLUMN_SUM),
+    TRACKER(woodCreation, C_POOL, COLUMN_SUM),
+    TRACKER(gdd, "degC day", COLUMN_LAST),
+    TRACKER(evapotranspiration, WATER, COLUMN_SUM),
+    TRACKER(soilWetnessFrac, "1", COLUMN_MEAN),
+    TRACKER(yearlyGpp, C_POOL, COLUMN_LAST),
+    TRACKER(yearlyRtot, C_POOL, COLUMN_LAST),
+    TRACKER(yearlyRa, C_POOL, COLUMN_LAST),
+    TRACKER(yearlyRh, C_POOL, COLUMN_LAST),
+    TRACKER(yearlyNpp, C_POOL, COLUMN_LAST),
+    TRACKER(yearlyNee, C_POOL, COLUMN_LAST),
+    TRACKER(yearlyLitter, C_POOL, COLUMN_LAST),
+    TRACKER(totGpp, C_POOL, COLUMN_LAST),
+    TRACKER(totRtot, C_POOL, COLUMN_LAST),
+    TRACKER(totRa, C_POOL, COLUMN_LAST),
+    TRACKER(totRh, C_POOL, COLUMN_LAST),
+    TRACKER(totNpp, C_POOL, COLUMN_LAST),
+    TRACKER(totNee, C_POOL, COLUMN_LAST),
+    TRACKER_INT(lastYear, "year"),
+    TRACKER(methane, C_POOL, COLUMN_SUM),
+    TRACKER(n2o, N_POOL, COLUMN_SUM),
+    TRACKER(nLeaching, N_POOL, COLUMN_SUM),
+    TRACKER(nFixation, N_POOL, COLUMN_SUM),
+    TRACKER(nUptake, N_POOL, COLUMN_SUM),
+    TRACKER(meanNPP, C_FLUX, COLUMN_LAST),
+
+    PHENOLOGY(didLeafGrowth, "1"),
+    PHENOLOGY(didLeafFall, "1"),
+    PHENOLOGY(lastYear, "year"),
+
+    SURVIVAL(isAlive, "1")};
+
+_Static_assert(sizeof(variables) / sizeof(variables[0]) == NUM_VARIABLES,
+               "NUM_VARIABLES doesn't match the registry");
+
+static const char *groupNames[NUM_VAR_GROUPS] = {"envi", "fluxes", "trackers",
+                                                 "phenology", "survival"};
+
+// Hash of the variables by qualified name
+typedef struct VarEntry {
+  const VarInfo *var;
+  UT_hash_handle hh;
+} VarEntry;
+
+static VarEntry varEntries[NUM_VARIABLES];
+static VarEntry *varMap = NULL;
+static int groupStart[NUM_VAR_GROUPS + 1];
+static pthread_once_t registryOnce = PTHREAD_ONCE_INIT;
+
+// Build the hash and group index; run once, by the first lookup
+static void initRegistry(void) {
+  int group = 0;
+
+  for (int ind = 0; ind < NUM_VARIABLES; ++ind) {
+    const VarInfo *var = &variables[ind];
+    VarEntry *existing;
+
+    HASH_FIND_STR(varMap, var->name, existing);
+    if ((existing != NULL) ||
+        ((ind > 0) && (var->group < variables[ind - 1].group))) {
+      logInternalError("variable registry: %s is listed twice or out of "
+                       "order\n",
+                       var->name);
+      exit(EXIT_CODE_INTERNAL_ERROR);
+    }
+    while (group <= var->group) {
+      groupStart[group++] = ind;
+    }
+    varEntries[ind].var = var;
+    HASH_ADD_KEYPTR(hh, varMap, var->name, strlen(var->name),
+                    &varEntries[ind]);
+  }
+  while (group <= NUM_VAR_GROUPS) {
+    groupStart[group++] = NUM_VARIABLES;
+  }
+}
+
+// See varRegistry.h
+const VarInfo *getVariables(int *count) {
+  *count = NUM_VARIABLES;
+  return variables;
+}
+
+// See varRegistry.h
+const VarInfo *getGroupVariables(VarGroup group, int *count) {
+  pthread_once(&registryOnce, initRegistry);
+  *count = groupStart[group + 1] - groupStart[group];
+  return &variables[groupStart[group]];
+}
+
+// See varRegistry.h
+const char *getVarGroupName(VarGroup group) { return groupNames[group]; }
+
+// See varRegistry.h
+const VarInfo *findVariable(const char *name) {
+  VarEntry *entry;
+
+  pthread_once(&registryOnce, initRegistry);
+  HASH_FIND_STR(varMap, name, entry);
+  return (entry != NULL) ? entry->var : NULL;
+}
+
+// See varRegistry.h
+const VarInfo *requireVariable(const char *name) {
+  const VarInfo *var = findVariable(name);
+
+  if (var == NULL) {
+    logInternalError("variable registry has no variable %s\n", name);
+    exit(EXIT_CODE_INTERNAL_ERROR);
+  }
+  return var;
+}
+
+// See varRegistry.h
+int isVariableField(const char *field) {
+  char name[128];
+
+  for (int group = 0; group < NUM_VAR_GROUPS; ++group) {
+    int len = snprintf(name, sizeof(name), "%s.%s", groupNames[group], field);
+    if ((len < (int)sizeof(name)) && (findVariable(name) != NULL)) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+// See varRegistry.h
+void *getVariableAddress(SipnetModel *model, const VarInfo *var) {
+  return (char *)model + var->offset;
+}
+
+// See varRegistry.h
+double getVariableValue(const SipnetModel *model, const VarInfo *var) {
+  const char *address = (const char *)model + var->offset;
+
+  if (var->type == VAR_INT) {
+    return *(const int *)address;
+  }
+  return *(const double *)address;
+}
@@ -0,0 +1,103 @@
+// header file for varRegistry.c: the registry of model state variables
+//
+// Every field of the model's Envi, Fluxes, Trackers, PhenologyTrackers and
+// PlantSurvivalTracker structs is listed once, in varRegistry.c, with where it
+// lives in a SipnetModel, its type, units, and how it aggregates over time.
+// The writers that name state fields - the main output, the debug logs, the
+// single-variable outputs and restart checkpoints - all build their field
+// lists from it, at setup; nothing is looked up by name per step.
+//
+// Variables are named "<group>.<field>", e.g. "envi.soilC" or
+// "trackers.gpp", which are also their restart keys. Field names alone are not
+// unique: rSoil, for one, is both a flux and a tracker.
+
+#ifndef VAR_REGISTRY_H
+#define VAR_REGISTRY_H
+
+#include <stddef.h>
+
+#include "outputPeriod.h"
+
+// Model instance holding all run state; defined in model.h
+typedef struct SipnetModel SipnetModel;
+
+// The struct of the model a variable is in, in registry order
+typedef enum VarGroup {
+  VAR_ENVI,
+  VAR_FLUXES,
+  VAR_TRACKERS,
+  VAR_PHENOLOGY,
+  VAR_SURVIVAL,
+  NUM_VAR_GROUPS
+} VarGroup;
+
+typedef enum VarType { VAR_DOUBLE, VAR_INT } VarType;
+
+typedef struct VarInfo {
+  // Qualified name, "<group>.<field>"
+  const char *name;
+  // Field name, as in the debug logs and output-vars
+  const char *field;
+  VarGroup group;
+  // Byte offset of the field in SipnetModel
+  size_t offset;
+  VarType type;
+  const char *units;
+  // How the variable aggregates over an output period: amounts over the step
+  // are summed, rates averaged, and pools and other state sampled
+  OutputColumnKind kind;
+} VarInfo;
+
+/*!
+ * All the variables, grouped by VarGroup, each group in struct order
+ *
+ * @param count set to the number of variables
+ * @return the variables
+ */
+const VarInfo *getVariables(int *count);
+
+/*!
+ * The variables of one group, in struct order
+ *
+ * @param group group
+ * @param count set to the number of variables in the group
+ * @return the group's first variable
+ */
+const VarInfo *getGroupVariables(VarGroup group, int *count);
+
+/*!
+ * Name of a group, as used in qualified variable names
+ */
+const char *getVarGroupName(VarGroup group);
+
+/*!
+ * Find a variable by qualified name, e.g. "trackers.gpp"
+ *
+ * Lookup is by hash, and safe from any thread.
+ *
+ * @return the variable, or NULL if there is none of that name
+ */
+const VarInfo *findVariable(const char *name);
+
+/*!
+ * Find a variable whose name is fixed in the code, exiting with an internal
+ * error if there is none of that name
+ */
+const VarInfo *requireVariable(const char *name);
+
+/*!
+ * Nonzero if field is the field name of any variable, in any group
+ */
+int isVariableField(const char *field);
+
+/*!
+ * Address of a variable in model
+ */
+void *getVariableAddress(SipnetModel *model, const VarInfo *var);
+
+/*!
+ * Current value of a variable in model; ints are converted to double
+ */
+double getVariableValue(const SipnetModel *model, const VarInfo *var);
+
+#endif
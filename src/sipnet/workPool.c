@@ -0,0 +1,129 @@
+// Read a list of run prefixes, and run tasks on a pool of threads
+
+#include "workPool.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "common/exitCodes.h"
+#include "common/logging.h"
+#include "common/util.h"
+
+typedef struct WorkPool {
+  int numTasks;
+  void (*runTask)(void *arg, int task);
+  void *arg;
+
+  // Index of the next task to run; guarded by lock
+  int nextTask;
+  pthread_mutex_t lock;
+} WorkPool;
+
+// See workPool.h
+char (*readPrefixList(const char *listFile, const char *what,
+                      size_t maxPrefixLen, int *numPrefixes))[FILENAME_MAXLEN] {
+  const char *SEPARATORS = " \t\n\r";
+  const char *COMMENT_CHARS = "!";
+
+  FILE *in = openFile(listFile, "r");
+  char line[FILENAME_MAXLEN + 64];
+  char (*prefixes)[FILENAME_MAXLEN] = NULL;
+  int capacity = 0;
+
+  *numPrefixes = 0;
+  while (fgets(line, sizeof(line), in) != NULL) {
+    if (stripComment(line, COMMENT_CHARS)) {
+      continue;
+    }
+    char *prefix = strtok(line, SEPARATORS);
+    if (strlen(prefix) > maxPrefixLen) {
+      logError("%s prefix %s is too long; max length is %zu\n", what, prefix,
+               maxPrefixLen);
+      exit(EXIT_CODE_INPUT_FILE_ERROR);
+    }
+    if (*numPrefixes == capacity) {
+      capacity = (capacity == 0) ? 16 : 2 * capacity;
+      prefixes = realloc(prefixes, capacity * sizeof(*prefixes));
+      if (prefixes == NULL) {
+        logError("memory allocation failure reading %s\n", listFile);
+        exit(EXIT_CODE_INTERNAL_ERROR);
+      }
+    }
+    strcpy(prefixes[*numPrefixes], prefix);
+    ++(*numPrefixes);
+  }
+  fclose(in);
+
+  if (*numPrefixes == 0) {
+    logError("no %s prefixes found in %s\n", what, listFile);
+    exit(EXIT_CODE_INPUT_FILE_ERROR);
+  }
+  return prefixes;
+}
+
+// See workPool.h
+int workPoolThreads(int numThreads, int numTasks) {
+  if (numThreads == 0) {
+    long numCPUs = sysconf(_SC_NPROCESSORS_ONLN);
+    numThreads = (numCPUs > 0) ? (int)numCPUs : 1;
+  }
+  // No more threads than tasks
+  if (numThreads > numTasks) {
+    numThreads = numTasks;
+  }
+  return (numThreads > 0) ? numThreads : 1;
+}
+
+// Worker thread: run tasks until there are none left
+static void *workPoolWorker(void *arg) {
+  WorkPool *pool = (WorkPool *)arg;
+
+  while (1) {
+    pthread_mutex_lock(&pool->lock);
+    int task = pool->nextTask;
+    if (task < pool->numTasks) {
+      ++pool->nextTask;
+    }
+    pthread_mutex_unlock(&pool->lock);
+    if (task >= pool->numTasks) {
+      break;
+    }
+    pool->runTask(pool->arg, task);
+  }
+
+  return NULL;
+}
+
+// See workPool.h
+void runWorkPool(int numTasks, int numThreads,
+                 void (*runTask)(void *arg, int task), void *arg,
+                 const char *what) {
+  WorkPool pool;
+
+  pool.numTasks = numTasks;
+  pool.runTask = runTask;
+  pool.arg = arg;
+  pool.nextTask = 0;
+  pthread_mutex_init(&pool.lock, NULL);
+
+  pthread_t *threads = (pthread_t *)malloc(numThreads * sizeof(pthread_t));
+  if (threads == NULL) {
+    logError("memory allocation failure starting %s threads\n", what);
+    exit(EXIT_CODE_INTERNAL_ERROR);
+  }
+  for (int ind = 0; ind < numThreads; ++ind) {
+    if (pthread_create(&threads[ind], NULL, workPoolWorker, &pool) != 0) {
+      logError("unable to start %s thread %d\n", what, ind);
+      exit(EXIT_CODE_INTERNAL_ERROR);
+    }
+  }
+  for (int ind = 0; ind < numThreads; ++ind) {
+    pthread_join(threads[ind], NULL);
+  }
+
+  free(threads);
+  pthread_mutex_destroy(&pool.lock);
+}
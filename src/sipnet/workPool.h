@@ -0,0 +1,56 @@
+// header file for the runs that share a prefix list and a pool of threads
+//
+// Ensembles (see ensemble.h) and scenario trees (see scenario.h) both read a
+// list of file prefixes, one run per prefix, and hand the runs out to a pool
+// of worker threads as threads become free.
+
+#ifndef SIPNET_WORK_POOL_H
+#define SIPNET_WORK_POOL_H
+
+#include <stddef.h>
+
+#include "common/context.h"
+
+/*!
+ * Read a list of file prefixes, one per line
+ *
+ * Blank lines and anything after a '!' are ignored. Exits if a prefix is
+ * longer than maxPrefixLen, or if there are none.
+ *
+ * @param listFile file listing the prefixes
+ * @param what what each prefix names, for messages (e.g. "scenario")
+ * @param maxPrefixLen longest prefix allowed, so that the longest file name
+ *                     made from it fits in FILENAME_MAXLEN
+ * @param[out] numPrefixes number of prefixes read
+ * @return the prefixes, to be freed by the caller
+ */
+char (*readPrefixList(const char *listFile, const char *what,
+                      size_t maxPrefixLen, int *numPrefixes))[FILENAME_MAXLEN];
+
+/*!
+ * Number of worker threads to use for a pool
+ *
+ * @param numThreads number of threads asked for; 0 for one per online CPU
+ * @param numTasks number of tasks; there are no more threads than this
+ * @return number of threads, at least 1
+ */
+int workPoolThreads(int numThreads, int numTasks);
+
+/*!
+ * Run tasks 0 to numTasks-1 on a pool of threads, and wait for them all
+ *
+ * Tasks are handed out in order, one at a time, as threads become free, so
+ * runs that finish early don't leave threads idle. runTask is called from the
+ * worker threads, and must do its own locking of anything they share.
+ *
+ * @param numTasks number of tasks
+ * @param numThreads number of threads, as returned by workPoolThreads()
+ * @param runTask function run for each task, with arg and the task index
+ * @param arg passed to runTask
+ * @param what what the threads run, for messages (e.g. "scenario")
+ */
+void runWorkPool(int numTasks, int numThreads,
+                 void (*runTask)(void *arg, int task), void *arg,
+                 const char *what);
+
+#endif  // SIPNET_WORK_POOL_H
@@ -4,6 +4,10 @@
 #include "utils/exitHandler.c"
 #include "sipnet/events.c"
 
+// Model instance shared by the tests in this file
+static SipnetModel testModel;
+static SipnetModel *model = &testModel;
+
 // These test points check the fix for issue
 // https://github.com/PecanProject/sipnet/issues/74
 
@@ -23,7 +27,7 @@ int run(void) {
   expected_code = EXIT_CODE_INPUT_FILE_ERROR;
   jmp_rval = setjmp(jump_env);
   if (!jmp_rval) {
-    readEventData("infra_events_year_boundary.in");
+    readEventData(model, "infra_events_year_boundary.in");
   }
   test_assert(jmp_rval == 0);
   status |= !exit_result;
@@ -37,7 +41,7 @@ int run(void) {
   expected_code = EXIT_CODE_INPUT_FILE_ERROR;
   jmp_rval = setjmp(jump_env);
   if (!jmp_rval) {
-    readEventData("infra_events_bad_order.in");
+    readEventData(model, "infra_events_bad_order.in");
   }
   test_assert(jmp_rval == 1);
   status |= !exit_result;
@@ -6,6 +6,10 @@
 #include "common/logging.h"
 #include "sipnet/events.c"
 
+// Model instance shared by the tests in this file
+static SipnetModel testModel;
+static SipnetModel *model = &testModel;
+
 int checkEvent(EventNode *event, int year, int day, enum EventType type) {
   if (!event) {
     return 1;
@@ -79,9 +83,9 @@ int init(void) { return 0; }
 int runTestEmpty(void) {
   int status = 0;
   // Should return empty for no file
-  EventNode *output = readEventData("infra_events_no_file.in");
+  EventNode *output = readEventData(model, "infra_events_no_file.in");
   status |= (output != NULL);
-  output = readEventData("infra_events_empty_file.in");
+  output = readEventData(model, "infra_events_empty_file.in");
   status |= (output != NULL);
 
   return status;
@@ -89,7 +93,7 @@ int runTestEmpty(void) {
 
 int runTestSimple(void) {
   // Simple test with one loc, one outEvent per type
-  EventNode *output = readEventData("infra_events_simple.in");
+  EventNode *output = readEventData(model, "infra_events_simple.in");
 
   if (!output) {
     logTest("runTestSimple: events not read properly\n");
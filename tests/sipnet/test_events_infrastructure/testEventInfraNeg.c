@@ -5,6 +5,10 @@
 #include "common/logging.h"
 #include "utils/exitHandler.c"
 
+// Model instance shared by the tests in this file
+static SipnetModel testModel;
+static SipnetModel *model = &testModel;
+
 int run(void) {
   int status = 0;
 
@@ -16,7 +20,7 @@ int run(void) {
   exit_result = 1;
   jmp_rval = setjmp(jump_env);
   if (!jmp_rval) {
-    readEventData("infra_events_simple.in");
+    readEventData(model, "infra_events_simple.in");
   }
   test_assert(jmp_rval == 0);
   status |= !exit_result;
@@ -32,7 +36,7 @@ int run(void) {
   expected_code = EXIT_CODE_UNKNOWN_EVENT_TYPE_OR_PARAM;
   jmp_rval = setjmp(jump_env);
   if (!jmp_rval) {
-    readEventData("infra_events_unknown.in");
+    readEventData(model, "infra_events_unknown.in");
   }
   test_assert(jmp_rval == 1);
   status |= !exit_result;
@@ -45,7 +49,7 @@ int run(void) {
   expected_code = EXIT_CODE_INPUT_FILE_ERROR;
   jmp_rval = setjmp(jump_env);
   if (!jmp_rval) {
-    readEventData("infra_events_date_ooo.in");
+    readEventData(model, "infra_events_date_ooo.in");
   }
   test_assert(jmp_rval == 1);
   status |= !exit_result;
@@ -59,7 +63,7 @@ int run(void) {
   expected_code = EXIT_CODE_INPUT_FILE_ERROR;
   jmp_rval = setjmp(jump_env);
   if (!jmp_rval) {
-    readEventData("infra_events_bad_first.in");
+    readEventData(model, "infra_events_bad_first.in");
   }
   test_assert(jmp_rval == 1);
   status |= !exit_result;
@@ -72,7 +76,7 @@ int run(void) {
   expected_code = EXIT_CODE_INPUT_FILE_ERROR;
   jmp_rval = setjmp(jump_env);
   if (!jmp_rval) {
-    readEventData("infra_events_bad_till.in");
+    readEventData(model, "infra_events_bad_till.in");
   }
   test_assert(jmp_rval == 1);
   status |= !exit_result;
@@ -7,60 +7,41 @@
 // #include "sipnet/sipnet.c"
 #include "utils/helpers.c"
 
+#define NUM_CLIM_STEPS 6
+
+// Dummy climate, one entry per step
+static ClimateNode climate[NUM_CLIM_STEPS];
+
 void init(void) {
   // Values here don't matter, just want to make sure they are initialized to
   // something. Value checks are in other tests.
-  envi.litterC = 1;
-  envi.plantLeafC = 2;
-  envi.plantWoodC = 3;
-  envi.fineRootC = 4;
-  envi.coarseRootC = 5;
-  envi.soilWater = 0;
-  fluxes.immedEvap = 0;
-  params.immedEvapFrac = 0.5;
+  model->envi.litterC = 1;
+  model->envi.plantLeafC = 2;
+  model->envi.plantWoodC = 3;
+  model->envi.fineRootC = 4;
+  model->envi.coarseRootC = 5;
+  model->envi.soilWater = 0;
+  model->fluxes.immedEvap = 0;
+  model->params.immedEvapFrac = 0.5;
 
   // set up dummy climate
-  ClimateNode *climate1 = (ClimateNode *)malloc(sizeof(ClimateNode));
-  ClimateNode *climate2 = (ClimateNode *)malloc(sizeof(ClimateNode));
-  ClimateNode *climate3 = (ClimateNode *)malloc(sizeof(ClimateNode));
-  climate1->year = 2023;
-  climate1->day = 65;
-  climate1->length = 0.5;
-  climate2->year = 2023;
-  climate2->day = 70;
-  climate2->length = 0.5;
-  climate3->year = 2023;
-  climate3->day = 200;
-  climate3->length = 0.5;
-  ClimateNode *climate4 = (ClimateNode *)malloc(sizeof(ClimateNode));
-  ClimateNode *climate5 = (ClimateNode *)malloc(sizeof(ClimateNode));
-  ClimateNode *climate6 = (ClimateNode *)malloc(sizeof(ClimateNode));
-  climate4->year = 2024;
-  climate4->day = 65;
-  climate4->length = 0.5;
-  climate5->year = 2024;
-  climate5->day = 70;
-  climate5->length = 0.5;
-  climate6->year = 2024;
-  climate6->day = 200;
-  climate6->length = 0.5;
-
-  climate5->nextClim = climate6;
-  climate4->nextClim = climate5;
-  climate3->nextClim = climate4;
-  climate2->nextClim = climate3;
-  climate1->nextClim = climate2;
-  climate = climate1;
+  static const int years[NUM_CLIM_STEPS] = {2023, 2023, 2023,
+                                            2024, 2024, 2024};
+  static const int days[NUM_CLIM_STEPS] = {65, 70, 200, 65, 70, 200};
+  for (int ind = 0; ind < NUM_CLIM_STEPS; ++ind) {
+    climate[ind].year = years[ind];
+    climate[ind].day = days[ind];
+    climate[ind].length = 0.5;
+  }
 }
 
 void runLoc(void) {
-  ClimateNode *climStart = climate;
-  setupEvents();
-  while (climate != NULL) {
+  setupEvents(model);
+  for (int ind = 0; ind < NUM_CLIM_STEPS; ++ind) {
+    model->climate = &climate[ind];
     procEvents();
-    climate = climate->nextClim;
   }
-  climate = climStart;
+  model->climate = &climate[0];
 }
 
 int runTest(const char *prefix, int header) {
@@ -74,10 +55,10 @@ int runTest(const char *prefix, int header) {
   strcpy(output, prefix);
   strcat(output, ".out");
 
-  initEvents(input, "events.out", header);
+  initEvents(model, input, "events.out", header);
   runLoc();
 
-  closeEventOutFile();
+  closeEventOutFile(model);
   status = diffFiles(output, "events.out");
 
   return status;
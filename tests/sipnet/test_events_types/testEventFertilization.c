@@ -7,14 +7,14 @@
 int checkOutput(double orgN, double litterC, double minN) {
   int status = 0;
   double curLitterC = 0;
-  double curOrgN = envi.litterN;
-  double curMinN = envi.minN;
+  double curOrgN = model->envi.litterN;
+  double curMinN = model->envi.minN;
   if (ctx.litterPool) {
     logTest("Checking litter pool for carbon addition\n");
-    curLitterC = envi.litterC;
+    curLitterC = model->envi.litterC;
   } else {
     logTest("Checking soil pool for carbon addition\n");
-    curLitterC = envi.soilC;
+    curLitterC = model->envi.soilC;
     // We bumped init soil C to distinguish
     litterC += 0.5;
   }
@@ -35,11 +35,11 @@ int checkOutput(double orgN, double litterC, double minN) {
 }
 
 void initEnv(double minN, double orgN) {
-  envi.soilC = 1.5;
-  envi.litterC = 1;
-  envi.minN = minN;
-  envi.soilOrgN = 0;
-  envi.litterN = orgN;
+  model->envi.soilC = 1.5;
+  model->envi.litterC = 1;
+  model->envi.minN = minN;
+  model->envi.soilOrgN = 0;
+  model->envi.litterN = orgN;
 }
 
 int run(void) {
@@ -57,10 +57,10 @@ int run(void) {
   updateIntContext("litterPool", 0, CTX_TEST);
   logTest("Litter pool is %s\n", ctx.litterPool ? "on" : "off");
   logTest("Nitrogen cycle is %s\n", ctx.nitrogenCycle ? "on" : "off");
-  initEvents("events_one_fert.in", "events.out", 0);
-  setupEvents();
+  initEvents(model, "events_one_fert.in", "events.out", 0);
+  setupEvents(model);
   procEvents();
-  closeEventOutFile();
+  closeEventOutFile(model);
 
   // First fert: (15-5-10)
   expOrgN = 0;  // nitrogen cycle is off
@@ -75,10 +75,10 @@ int run(void) {
   logTest("Litter pool is %s\n", ctx.litterPool ? "on" : "off");
   logTest("Nitrogen cycle is %s\n", ctx.nitrogenCycle ? "on" : "off");
   initEnv(2, 3);
-  initEvents("events_two_fert.in", "events.out", 1);
-  setupEvents();
+  initEvents(model, "events_two_fert.in", "events.out", 1);
+  setupEvents(model);
   procEvents();
-  closeEventOutFile();
+  closeEventOutFile(model);
 
   // First event same as above (15-5-10)
   expOrgN = 3 + 15;
@@ -6,20 +6,21 @@
 
 int checkBioOutput(double leafC, double woodC, double fineC, double coarseC) {
   int status = 0;
-  if (!compareDoubles(leafC, envi.plantLeafC)) {
-    logTest("Plant leaf C is %f, expected %f\n", envi.plantLeafC, leafC);
+  if (!compareDoubles(leafC, model->envi.plantLeafC)) {
+    logTest("Plant leaf C is %f, expected %f\n", model->envi.plantLeafC, leafC);
     status = 1;
   }
-  if (!compareDoubles(woodC, envi.plantWoodC)) {
-    logTest("Plant wood C is %f, expected %f\n", envi.plantWoodC, woodC);
+  if (!compareDoubles(woodC, model->envi.plantWoodC)) {
+    logTest("Plant wood C is %f, expected %f\n", model->envi.plantWoodC, woodC);
     status = 1;
   }
-  if (!compareDoubles(fineC, envi.fineRootC)) {
-    logTest("Fine root C is %f, expected %f\n", envi.fineRootC, fineC);
+  if (!compareDoubles(fineC, model->envi.fineRootC)) {
+    logTest("Fine root C is %f, expected %f\n", model->envi.fineRootC, fineC);
     status = 1;
   }
-  if (!compareDoubles(coarseC, envi.coarseRootC)) {
-    logTest("Coarse root C is %f, expected %f\n", envi.coarseRootC, coarseC);
+  if (!compareDoubles(coarseC, model->envi.coarseRootC)) {
+    logTest("Coarse root C is %f, expected %f\n", model->envi.coarseRootC,
+            coarseC);
     status = 1;
   }
   return status;
@@ -28,50 +29,50 @@ int checkBioOutput(double leafC, double woodC, double fineC, double coarseC) {
 int checkSoilOutput(double soilC, double litterC, double soilOrgN,
                     double litterN) {
   int status = 0;
-  if (!compareDoubles(soilC, envi.soilC)) {
-    logTest("Soil C is %f, expected %f\n", envi.soilC, soilC);
+  if (!compareDoubles(soilC, model->envi.soilC)) {
+    logTest("Soil C is %f, expected %f\n", model->envi.soilC, soilC);
     status = 1;
   }
-  if (!compareDoubles(litterC, envi.litterC)) {
-    logTest("Litter C is %f, expected %f\n", envi.litterC, litterC);
+  if (!compareDoubles(litterC, model->envi.litterC)) {
+    logTest("Litter C is %f, expected %f\n", model->envi.litterC, litterC);
     status = 1;
   }
-  if (!compareDoubles(soilOrgN, envi.soilOrgN)) {
-    logTest("Soil Org N is %f, expected %f\n", envi.soilOrgN, soilOrgN);
+  if (!compareDoubles(soilOrgN, model->envi.soilOrgN)) {
+    logTest("Soil Org N is %f, expected %f\n", model->envi.soilOrgN, soilOrgN);
     status = 1;
   }
-  if (!compareDoubles(litterN, envi.litterN)) {
-    logTest("Litter N is %f, expected %f\n", envi.litterN, litterN);
+  if (!compareDoubles(litterN, model->envi.litterN)) {
+    logTest("Litter N is %f, expected %f\n", model->envi.litterN, litterN);
     status = 1;
   }
   return status;
 }
 
 void initEnv(void) {
-  envi.soilC = 10;
-  envi.litterC = 0;
-  envi.plantLeafC = 2;
-  envi.plantWoodC = 3;
-  envi.fineRootC = 4;
-  envi.coarseRootC = 5;
-  envi.soilOrgN = 0;
-  envi.litterN = 0;
+  model->envi.soilC = 10;
+  model->envi.litterC = 0;
+  model->envi.plantLeafC = 2;
+  model->envi.plantWoodC = 3;
+  model->envi.fineRootC = 4;
+  model->envi.coarseRootC = 5;
+  model->envi.soilOrgN = 0;
+  model->envi.litterN = 0;
 
   if (ctx.litterPool) {
-    envi.litterC = 15;
+    model->envi.litterC = 15;
   }
   if (ctx.nitrogenCycle) {
-    envi.soilOrgN = 2.0;
-    envi.litterN = 3.0;
-    params.woodCN = 10;
-    params.leafCN = 20;
-    params.fineRootCN = 30;
+    model->envi.soilOrgN = 2.0;
+    model->envi.litterN = 3.0;
+    model->params.woodCN = 10;
+    model->params.leafCN = 20;
+    model->params.fineRootCN = 30;
   }
 
   // not used here, but accessed
-  envi.plantCAccountingDelta = 0.0;
-  envi.soilWater = 10.0;
-  envi.minN = 10.0;
+  model->envi.plantCAccountingDelta = 0.0;
+  model->envi.soilWater = 10.0;
+  model->envi.minN = 10.0;
 }
 
 int run(void) {
@@ -93,10 +94,10 @@ int run(void) {
   updateIntContext("nitrogenCycle", 0, CTX_TEST);
   logTest("Litter pool is %s, nitrogen cycle is %s\n",
           ctx.litterPool ? "on" : "off", ctx.nitrogenCycle ? "on" : "off");
-  initEvents("events_one_harvest.in", "events.out", 0);
-  setupEvents();
+  initEvents(model, "events_one_harvest.in", "events.out", 0);
+  setupEvents(model);
   procEvents();
-  closeEventOutFile();
+  closeEventOutFile(model);
   // fracRA = 0.1, fracRB = 0.2, frac TA = 0.3, fracTB = 0.4
   expSoilC = 10 + 0.3 * (2 + 3) + 0.4 * (4 + 5);  // 10 + 1.5 + 3.6 = 15.1
   expLitterC = 0.0;  // litter pool off
@@ -118,10 +119,10 @@ int run(void) {
   logTest("Litter pool is %s, nitrogen cycle is %s\n",
           ctx.litterPool ? "on" : "off", ctx.nitrogenCycle ? "on" : "off");
   initEnv();
-  initEvents("events_two_harvest.in", "events.out", 1);
-  setupEvents();
+  initEvents(model, "events_two_harvest.in", "events.out", 1);
+  setupEvents(model);
   procEvents();
-  closeEventOutFile();
+  closeEventOutFile(model);
   // Two events are additive
   expSoilC = 10 + (0.4 + 0.1) * (4 + 5);
   expLitterC = 15 + (0.3 + 0.2) * (2 + 3);
@@ -129,10 +130,10 @@ int run(void) {
   expWoodC = 3 * (1 - 0.1 - 0.3 - 0.2 - 0.2);
   expFineC = 4 * (1 - 0.2 - 0.4 - 0.1 - 0.1);
   expCoarseC = 5 * (1 - 0.2 - 0.4 - 0.1 - 0.1);
-  expSoilOrgN = 2 + (4 * (0.4 + 0.1)) / params.fineRootCN +
-                (5 * (0.4 + 0.1)) / params.woodCN;
-  expLitterN =
-      3 + (3 * (0.3 + 0.2)) / params.woodCN + (2 * (0.3 + 0.2)) / params.leafCN;
+  expSoilOrgN = 2 + (4 * (0.4 + 0.1)) / model->params.fineRootCN +
+                (5 * (0.4 + 0.1)) / model->params.woodCN;
+  expLitterN = 3 + (3 * (0.3 + 0.2)) / model->params.woodCN +
+               (2 * (0.3 + 0.2)) / model->params.leafCN;
 
   status |= checkBioOutput(expLeafC, expWoodC, expFineC, expCoarseC);
   status |= checkSoilOutput(expSoilC, expLitterC, expSoilOrgN, expLitterN);
@@ -7,13 +7,16 @@
 
 int checkOutput(double soilWater, double eventEvap) {
   int status = 0;
-  if (!compareDoubles(soilWater, envi.soilWater)) {
-    logTest("Soil water is %f, expected %f\n", envi.soilWater, soilWater);
+  if (!compareDoubles(soilWater, model->envi.soilWater)) {
+    logTest("Soil water is %f, expected %f\n", model->envi.soilWater,
+            soilWater);
     status = 1;
   }
   // This is a proper flux - need to multiply flux by climate length to compare
-  if (!compareDoubles(eventEvap, fluxes.eventEvap * climate->length)) {
-    logTest("Event evap is %f, expected %f\n", fluxes.immedEvap, eventEvap);
+  if (!compareDoubles(eventEvap,
+                      model->fluxes.eventEvap * model->climate->length)) {
+    logTest("Event evap is %f, expected %f\n", model->fluxes.immedEvap,
+            eventEvap);
     status = 1;
   }
   return status;
@@ -25,32 +28,32 @@ int run(void) {
   prepTypesTest();
 
   // set up dummy envi/fluxes/params
-  envi.soilWater = 0;
-  fluxes.eventEvap = 0;
-  params.immedEvapFrac = 0.5;
+  model->envi.soilWater = 0;
+  model->fluxes.eventEvap = 0;
+  model->params.immedEvapFrac = 0.5;
 
   //// ONE IRRIGATION EVENT
   // amount 5, method 1 (soil)
-  initEvents("events_one_irrig.in", "events.out", 0);
-  setupEvents();
+  initEvents(model, "events_one_irrig.in", "events.out", 0);
+  setupEvents(model);
   procEvents();
-  closeEventOutFile();
+  closeEventOutFile(model);
   // should have 5 going to the soil
   status |= checkOutput(5, 0);
 
   //// TWO IRRIGATION EVENTS
   // amount 3, method 1 (soil)
   // amount 4, method 0 (canopy)
-  initEvents("events_two_irrig.in", "events.out", 1);
-  setupEvents();
+  initEvents(model, "events_two_irrig.in", "events.out", 1);
+  setupEvents(model);
   procEvents();
-  closeEventOutFile();
+  closeEventOutFile(model);
   // event 1: 3 to soil
   // event 2: 2=4*0.5 to evap, the rest (2) to soil
   // (plus the five from the test above)
   status |= checkOutput(10, 2);
 
-  free(climate);
+  free(model->climate);
 
   return status;
 }
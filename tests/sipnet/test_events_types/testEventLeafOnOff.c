@@ -8,19 +8,19 @@
 int checkLeafOn(const char *stage, double expWoodC, double expCoarseRootC,
                 double expLeafC) {
   int status = 0;
-  if (!compareDoubles(expWoodC, envi.plantWoodC)) {
-    logTest("%s: plantWoodC is %f, expected %f\n", stage, envi.plantWoodC,
-            expWoodC);
+  if (!compareDoubles(expWoodC, model->envi.plantWoodC)) {
+    logTest("%s: plantWoodC is %f, expected %f\n", stage,
+            model->envi.plantWoodC, expWoodC);
     status = 1;
   }
-  if (!compareDoubles(expCoarseRootC, envi.coarseRootC)) {
-    logTest("%s: coarseRootC is %f, expected %f\n", stage, envi.coarseRootC,
-            expCoarseRootC);
+  if (!compareDoubles(expCoarseRootC, model->envi.coarseRootC)) {
+    logTest("%s: coarseRootC is %f, expected %f\n", stage,
+            model->envi.coarseRootC, expCoarseRootC);
     status = 1;
   }
-  if (!compareDoubles(expLeafC, envi.plantLeafC)) {
-    logTest("%s: plantLeafC is %f, expected %f\n", stage, envi.plantLeafC,
-            expLeafC);
+  if (!compareDoubles(expLeafC, model->envi.plantLeafC)) {
+    logTest("%s: plantLeafC is %f, expected %f\n", stage,
+            model->envi.plantLeafC, expLeafC);
     status = 1;
   }
   return status;
@@ -29,10 +29,10 @@ int checkLeafOn(const char *stage, double expWoodC, double expCoarseRootC,
 int checkLeafOff(const char *stage, double expLeafC, double expPoolC,
                  double expLitterN) {
   int status = 0;
-  double curPoolC = ctx.litterPool ? envi.litterC : envi.soilC;
-  if (!compareDoubles(expLeafC, envi.plantLeafC)) {
-    logTest("%s: plantLeafC is %f, expected %f\n", stage, envi.plantLeafC,
-            expLeafC);
+  double curPoolC = ctx.litterPool ? model->envi.litterC : model->envi.soilC;
+  if (!compareDoubles(expLeafC, model->envi.plantLeafC)) {
+    logTest("%s: plantLeafC is %f, expected %f\n", stage,
+            model->envi.plantLeafC, expLeafC);
     status = 1;
   }
   if (!compareDoubles(expPoolC, curPoolC)) {
@@ -40,8 +40,8 @@ int checkLeafOff(const char *stage, double expLeafC, double expPoolC,
             ctx.litterPool ? "litterC" : "soilC", curPoolC, expPoolC);
     status = 1;
   }
-  if (!compareDoubles(expLitterN, envi.litterN)) {
-    logTest("%s: litterN is %f, expected %f\n", stage, envi.litterN,
+  if (!compareDoubles(expLitterN, model->envi.litterN)) {
+    logTest("%s: litterN is %f, expected %f\n", stage, model->envi.litterN,
             expLitterN);
     status = 1;
   }
@@ -50,22 +50,22 @@ int checkLeafOff(const char *stage, double expLeafC, double expPoolC,
 
 int checkPlantStorageN(const char *stage, double expStorageN) {
   int status = 0;
-  if (!compareDoubles(expStorageN, envi.plantStorageN)) {
-    logTest("%s: plantStorageN is %f, expected %f\n", stage, envi.plantStorageN,
-            expStorageN);
+  if (!compareDoubles(expStorageN, model->envi.plantStorageN)) {
+    logTest("%s: plantStorageN is %f, expected %f\n", stage,
+            model->envi.plantStorageN, expStorageN);
     status = 1;
   }
   return status;
 }
 
 void initEnv(double woodC, double leafC) {
-  envi.plantWoodC = woodC;
-  envi.plantLeafC = leafC;
-  envi.coarseRootC = 0.0;
-  envi.litterC = 0.0;
-  envi.soilC = 0.0;
-  envi.litterN = 0.0;
-  envi.plantStorageN = 0.0;
+  model->envi.plantWoodC = woodC;
+  model->envi.plantLeafC = leafC;
+  model->envi.coarseRootC = 0.0;
+  model->envi.litterC = 0.0;
+  model->envi.soilC = 0.0;
+  model->envi.litterN = 0.0;
+  model->envi.plantStorageN = 0.0;
 }
 
 int run(void) {
@@ -76,21 +76,21 @@ int run(void) {
   updateIntContext("gdd", 0, CTX_TEST);
 
   // Set params needed for leaf on/off events
-  params.leafGrowth = 3.0;
-  params.fracLeafFall = 0.5;
-  params.leafCN = 30.0;
-  params.leafOnDay = 0;
-  params.leafOffDay = 0;
-  params.leafOnReallocFrac = 0.5;
+  model->params.leafGrowth = 3.0;
+  model->params.fracLeafFall = 0.5;
+  model->params.leafCN = 30.0;
+  model->params.leafOnDay = 0;
+  model->params.leafOffDay = 0;
+  model->params.leafOnReallocFrac = 0.5;
 
   //// ONE LEAFON EVENT
   logTest("Testing one leafon event\n");
   initEnv(10.0, 0.0);
-  resetFluxes();
-  initEvents("events_one_leafon.in", "events.out", 0);
-  setupEvents();
+  resetFluxes(model);
+  initEvents(model, "events_one_leafon.in", "events.out", 0);
+  setupEvents(model);
   procEvents();
-  closeEventOutFile();
+  closeEventOutFile(model);
 
   // leafOn = params.leafGrowth = 3.0
   // wood decreases by 3.0, leaf increases by 3.0 (coarseRootC=0 so all from
@@ -100,11 +100,11 @@ int run(void) {
   //// TWO LEAFON EVENTS
   logTest("Testing two leafon events\n");
   initEnv(10.0, 0.0);
-  resetFluxes();
-  initEvents("events_two_leafon.in", "events.out", 0);
-  setupEvents();
+  resetFluxes(model);
+  initEvents(model, "events_two_leafon.in", "events.out", 0);
+  setupEvents(model);
   procEvents();
-  closeEventOutFile();
+  closeEventOutFile(model);
 
   // Two leafOn events: total 2 * 3.0 = 6.0 from wood to leaf (coarseRootC=0)
   status |= checkLeafOn("two leafon", 10.0 - 6.0, 0.0, 0.0 + 6.0);
@@ -115,12 +115,12 @@ int run(void) {
   // 4/10=0.4 leafGrowth=3.0 -> from wood: 3.0*0.6=1.8, from
   // coarseRoot: 3.0*0.4=1.2
   initEnv(6.0, 0.0);
-  envi.coarseRootC = 4.0;
-  resetFluxes();
-  initEvents("events_one_leafon.in", "events.out", 0);
-  setupEvents();
+  model->envi.coarseRootC = 4.0;
+  resetFluxes(model);
+  initEvents(model, "events_one_leafon.in", "events.out", 0);
+  setupEvents(model);
   procEvents();
-  closeEventOutFile();
+  closeEventOutFile(model);
 
   status |=
       checkLeafOn("leafon proportional split", 6.0 - 1.8, 4.0 - 1.2, 0.0 + 3.0);
@@ -128,11 +128,11 @@ int run(void) {
   //// ONE LEAFOFF EVENT (without nitrogen cycle)
   logTest("Testing one leafoff event (no nitrogen cycle)\n");
   initEnv(5.0, 10.0);
-  resetFluxes();
-  initEvents("events_one_leafoff.in", "events.out", 0);
-  setupEvents();
+  resetFluxes(model);
+  initEvents(model, "events_one_leafoff.in", "events.out", 0);
+  setupEvents(model);
   procEvents();
-  closeEventOutFile();
+  closeEventOutFile(model);
 
   // leafOff = plantLeafC * fracLeafFall = 10.0 * 0.5 = 5.0
   // leaf decreases by 5.0, litter increases by 5.0; no N (nitrogenCycle off)
@@ -144,11 +144,11 @@ int run(void) {
   updateIntContext("waterHResp", 1, CTX_TEST);
   updateIntContext("nitrogenCycle", 1, CTX_TEST);
   initEnv(5.0, 10.0);
-  resetFluxes();
-  initEvents("events_one_leafoff.in", "events.out", 0);
-  setupEvents();
+  resetFluxes(model);
+  initEvents(model, "events_one_leafoff.in", "events.out", 0);
+  setupEvents(model);
   procEvents();
-  closeEventOutFile();
+  closeEventOutFile(model);
 
   // leafOff = 10.0 * 0.5 = 5.0; N = leafOff / leafCN = 5.0 / 30.0
   status |=
@@ -161,11 +161,11 @@ int run(void) {
   updateIntContext("anaerobic", 0, CTX_TEST);
   updateIntContext("waterHResp", 0, CTX_TEST);
   initEnv(5.0, 10.0);
-  resetFluxes();
-  initEvents("events_one_leafoff.in", "events.out", 0);
-  setupEvents();
+  resetFluxes(model);
+  initEvents(model, "events_one_leafoff.in", "events.out", 0);
+  setupEvents(model);
   procEvents();
-  closeEventOutFile();
+  closeEventOutFile(model);
 
   // Without litter pool, leaf C goes to soil C instead
   status |=
@@ -179,13 +179,13 @@ int run(void) {
   // availableC = 0.5
   updateIntContext("litterPool", 1, CTX_TEST);
   initEnv(1.0, 0.0);
-  resetFluxes();
-  initEvents("events_one_leafon.in", "events.out", 0);
-  setupEvents();
+  resetFluxes(model);
+  initEvents(model, "events_one_leafon.in", "events.out", 0);
+  setupEvents(model);
   procEvents();
-  closeEventOutFile();
+  closeEventOutFile(model);
 
-  double availableC = 1.0 * params.leafOnReallocFrac;  // = 0.5
+  double availableC = 1.0 * model->params.leafOnReallocFrac;  // = 0.5
   status |= checkLeafOn("C-limited leafon", 1.0 - availableC, 0.0, availableC);
 
   //// N-LIMITED LEAF-ON EVENT
@@ -196,21 +196,21 @@ int run(void) {
   updateIntContext("anaerobic", 1, CTX_TEST);
   updateIntContext("waterHResp", 1, CTX_TEST);
   updateIntContext("nitrogenCycle", 1, CTX_TEST);
-  params.woodCN = 100.0;
-  params.nFixationFracMax = 0.0;
-  params.halfNFixationMax = 0.0;
+  model->params.woodCN = 100.0;
+  model->params.nFixationFracMax = 0.0;
+  model->params.halfNFixationMax = 0.0;
   initEnv(10.0, 0.0);
-  envi.plantStorageN = 0.05;
-  resetFluxes();
-  initEvents("events_one_leafon.in", "events.out", 0);
-  setupEvents();
+  model->envi.plantStorageN = 0.05;
+  resetFluxes(model);
+  initEvents(model, "events_one_leafon.in", "events.out", 0);
+  setupEvents(model);
   procEvents();
-  closeEventOutFile();
+  closeEventOutFile(model);
 
-  double leafOnNDemand =
-      params.leafGrowth / params.leafCN - params.leafGrowth / params.woodCN;
+  double leafOnNDemand = model->params.leafGrowth / model->params.leafCN -
+                         model->params.leafGrowth / model->params.woodCN;
   double nRatio = 0.05 / leafOnNDemand;
-  double transferred = params.leafGrowth * nRatio;
+  double transferred = model->params.leafGrowth * nRatio;
   status |=
       checkLeafOn("N-limited leafon", 10.0 - transferred, 0.0, transferred);
 
@@ -229,24 +229,24 @@ int run(void) {
   updateIntContext("anaerobic", 1, CTX_TEST);
   updateIntContext("waterHResp", 1, CTX_TEST);
   updateIntContext("nitrogenCycle", 1, CTX_TEST);
-  params.leafNResorptionFrac = 0.3;
+  model->params.leafNResorptionFrac = 0.3;
   initEnv(5.0, 10.0);
-  resetFluxes();
-  initEvents("events_one_leafoff.in", "events.out", 0);
-  setupEvents();
+  resetFluxes(model);
+  initEvents(model, "events_one_leafoff.in", "events.out", 0);
+  setupEvents(model);
   procEvents();
-  closeEventOutFile();
+  closeEventOutFile(model);
 
-  double leafOff = 10.0 * params.fracLeafFall;
-  double leafN = leafOff / params.leafCN;
-  double leafNResorption = leafN * params.leafNResorptionFrac;
+  double leafOff = 10.0 * model->params.fracLeafFall;
+  double leafN = leafOff / model->params.leafCN;
+  double leafNResorption = leafN * model->params.leafNResorptionFrac;
   double litterNAdd = leafN - leafNResorption;
   status |= checkLeafOff("leaf-off N resorption", 10.0 - leafOff, leafOff,
                          litterNAdd);
   status |= checkPlantStorageN("leaf-off N resorption", leafNResorption);
 
   // Reset for subsequent tests
-  params.leafNResorptionFrac = 0.0;
+  model->params.leafNResorptionFrac = 0.0;
   updateIntContext("nitrogenCycle", 0, CTX_TEST);
   updateIntContext("anaerobic", 0, CTX_TEST);
   updateIntContext("waterHResp", 0, CTX_TEST);
@@ -258,8 +258,8 @@ int run(void) {
   updateIntContext("litterPool", 1, CTX_TEST);
   updateIntContext("gdd", 0, CTX_TEST);
   updateIntContext("soilPhenol", 0, CTX_TEST);
-  params.leafOnDay = 0;
-  params.leafOffDay = 0;
+  model->params.leafOnDay = 0;
+  model->params.leafOffDay = 0;
 
   int jmp_rval;
 
@@ -270,7 +270,7 @@ int run(void) {
   exit_result = 1;
   jmp_rval = setjmp(jump_env);
   if (!jmp_rval) {
-    readEventData("events_one_leafon.in");
+    readEventData(model, "events_one_leafon.in");
   }
   test_assert(jmp_rval == 0);
   status |= !exit_result;
@@ -286,7 +286,7 @@ int run(void) {
   expected_code = EXIT_CODE_BAD_PARAMETER_VALUE;
   jmp_rval = setjmp(jump_env);
   if (!jmp_rval) {
-    readEventData("events_one_leafon.in");
+    readEventData(model, "events_one_leafon.in");
   }
   test_assert(jmp_rval == 1);
   status |= !exit_result;
@@ -303,7 +303,7 @@ int run(void) {
   expected_code = EXIT_CODE_BAD_PARAMETER_VALUE;
   jmp_rval = setjmp(jump_env);
   if (!jmp_rval) {
-    readEventData("events_one_leafon.in");
+    readEventData(model, "events_one_leafon.in");
   }
   test_assert(jmp_rval == 1);
   status |= !exit_result;
@@ -314,37 +314,37 @@ int run(void) {
 
   // params.leafOnDay > 0 should error
   logTest("Testing checkForCalculateLeafEvents: leafOnDay>0 conflicts\n");
-  params.leafOnDay = 47.0;
+  model->params.leafOnDay = 47.0;
   should_exit = 1;
   exit_result = 1;
   expected_code = EXIT_CODE_BAD_PARAMETER_VALUE;
   jmp_rval = setjmp(jump_env);
   if (!jmp_rval) {
-    readEventData("events_one_leafon.in");
+    readEventData(model, "events_one_leafon.in");
   }
   test_assert(jmp_rval == 1);
   status |= !exit_result;
   if (!exit_result) {
     logTest("FAIL checkForCalculateLeafEvents with leafOnDay>0\n");
   }
-  params.leafOnDay = 0;
+  model->params.leafOnDay = 0;
 
   // params.leafOffDay > 0 should error
   logTest("Testing checkForCalculateLeafEvents: leafOffDay>0 conflicts\n");
-  params.leafOffDay = 285.0;
+  model->params.leafOffDay = 285.0;
   should_exit = 1;
   exit_result = 1;
   expected_code = EXIT_CODE_BAD_PARAMETER_VALUE;
   jmp_rval = setjmp(jump_env);
   if (!jmp_rval) {
-    readEventData("events_one_leafoff.in");
+    readEventData(model, "events_one_leafoff.in");
   }
   test_assert(jmp_rval == 1);
   status |= !exit_result;
   if (!exit_result) {
     logTest("FAIL checkForCalculateLeafEvents with leafOffDay>0\n");
   }
-  params.leafOffDay = 0;
+  model->params.leafOffDay = 0;
 
   // Allow real exit for the remainder of the test
   really_exit = 1;
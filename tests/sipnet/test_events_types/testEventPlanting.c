@@ -6,30 +6,31 @@
 
 int checkOutput(double leafC, double woodC, double fineC, double coarseC) {
   int status = 0;
-  if (!compareDoubles(leafC, envi.plantLeafC)) {
-    logTest("Plant leaf C is %f, expected %f\n", envi.plantLeafC, leafC);
+  if (!compareDoubles(leafC, model->envi.plantLeafC)) {
+    logTest("Plant leaf C is %f, expected %f\n", model->envi.plantLeafC, leafC);
     status = 1;
   }
-  if (!compareDoubles(woodC, envi.plantWoodC)) {
-    logTest("Plant wood C is %f, expected %f\n", envi.plantWoodC, woodC);
+  if (!compareDoubles(woodC, model->envi.plantWoodC)) {
+    logTest("Plant wood C is %f, expected %f\n", model->envi.plantWoodC, woodC);
     status = 1;
   }
-  if (!compareDoubles(fineC, envi.fineRootC)) {
-    logTest("Fine root C is %f, expected %f\n", envi.fineRootC, fineC);
+  if (!compareDoubles(fineC, model->envi.fineRootC)) {
+    logTest("Fine root C is %f, expected %f\n", model->envi.fineRootC, fineC);
     status = 1;
   }
-  if (!compareDoubles(coarseC, envi.coarseRootC)) {
-    logTest("Coarse root C is %f, expected %f\n", envi.coarseRootC, coarseC);
+  if (!compareDoubles(coarseC, model->envi.coarseRootC)) {
+    logTest("Coarse root C is %f, expected %f\n", model->envi.coarseRootC,
+            coarseC);
     status = 1;
   }
   return status;
 }
 
 void initEnv(void) {
-  envi.plantLeafC = 1;
-  envi.plantWoodC = 2;
-  envi.fineRootC = 3;
-  envi.coarseRootC = 4;
+  model->envi.plantLeafC = 1;
+  model->envi.plantWoodC = 2;
+  model->envi.fineRootC = 3;
+  model->envi.coarseRootC = 4;
 }
 
 int run(void) {
@@ -41,19 +42,19 @@ int run(void) {
   initEnv();
 
   //// ONE PLANTING EVENT
-  initEvents("events_one_planting.in", "events.out", 0);
-  setupEvents();
+  initEvents(model, "events_one_planting.in", "events.out", 0);
+  setupEvents(model);
   procEvents();
-  closeEventOutFile();
+  closeEventOutFile(model);
   // added: leaf 10, wood 5, fine root 4, coarse root 3
   status |= checkOutput(1 + 10, 2 + 5, 3 + 4, 4 + 3);
 
   //// TWO PLANTING EVENTS
   initEnv();
-  initEvents("events_two_planting.in", "events.out", 1);
-  setupEvents();
+  initEvents(model, "events_two_planting.in", "events.out", 1);
+  setupEvents(model);
   procEvents();
-  closeEventOutFile();
+  closeEventOutFile(model);
   // leaf 10+9, wood 5+6, fine root 4+8, coarse root 3+4
   status |= checkOutput(1 + 19, 2 + 11, 3 + 12, 4 + 7);
 
@@ -5,18 +5,18 @@
 
 int checkOutput(const char *stage, double expTillMod) {
   int status = 0;
-  double curTillMod = eventTrackers.d_till_mod;
+  double curTillMod = model->eventTrackers.d_till_mod;
   if (!compareDoubles(expTillMod, curTillMod)) {
     logTest("%s: (day %d, hour %4.2f) tillage mod is %f, expected %f\n", stage,
-            climate->day, climate->time, curTillMod, expTillMod);
+            model->climate->day, model->climate->time, curTillMod, expTillMod);
     status = 1;
   }
   return status;
 }
 
-void decayMod(double *mod) { (*mod) *= exp(-climate->length / 30.0); }
+void decayMod(double *mod) { (*mod) *= exp(-model->climate->length / 30.0); }
 
-void initEnv(void) { initEventTrackers(); }
+void initEnv(void) { initEventTrackers(model); }
 
 int run(void) {
   int status = 0;
@@ -29,41 +29,42 @@ int run(void) {
   initEnv();
 
   //// ONE TILLAGE EVENT
-  initEvents("events_one_tillage.in", "events.out", 0);
-  setupEvents();
+  initEvents(model, "events_one_tillage.in", "events.out", 0);
+  setupEvents(model);
   procEvents();
-  closeEventOutFile();
+  closeEventOutFile(model);
 
   // First tillage:
   expTillMod = 0.5;
   status |= checkOutput("pre-update", expTillMod);
-  updateEventTrackers();
+  updateEventTrackers(model);
   decayMod(&expTillMod);
   status |= checkOutput("post-update", expTillMod);
 
   //// TWO TILLAGE EVENTS
-  initEventTrackers();
-  initEvents("events_two_tillage.in", "events.out", 0);
-  setupEvents();
-  readClimData("events_two_tillage.clim");
-  climate = firstClimate;
+  initEventTrackers(model);
+  initEvents(model, "events_two_tillage.in", "events.out", 0);
+  setupEvents(model);
+  readClimData(model, "events_two_tillage.clim");
+  setClimateStep(model, 0);
 
   expTillMod = 0.5;
-  while (climate) {
+  while (model->climate) {
     // This is kinda hacky, but fine for a test; add in effect of second tillage
     // when it is time
-    if ((climate->day == 75) && (compareDoubles(climate->time, 0.0))) {
+    if ((model->climate->day == 75) &&
+        (compareDoubles(model->climate->time, 0.0))) {
       expTillMod += 0.2;
     }
 
     procEvents();
     status |= checkOutput("pre-update", expTillMod);
-    updateEventTrackers();
+    updateEventTrackers(model);
     decayMod(&expTillMod);
     status |= checkOutput("post-update", expTillMod);
-    climate = climate->nextClim;
+    setClimateStep(model, model->climateStep + 1);
   }
-  closeEventOutFile();
+  closeEventOutFile(model);
 
   return status;
 }
@@ -2,6 +2,10 @@
 #include "sipnet/events.c"
 #include "sipnet/sipnet.c"
 
+// Model instance shared by the tests in this file
+static SipnetModel testModel;
+static SipnetModel *model = &testModel;
+
 #define TEST_EPS 1e-8
 
 // For help with debugging failures
@@ -18,7 +22,7 @@ FILE *out;
 // be it. This will hopefully be useful for debugging balance issues once
 // complete.
 
-void reset(void) { setupModel(); }
+void reset(void) { setupModel(model); }
 
 void setupTests(ModelParams **modelParamsPtr) {
   // Set up the context
@@ -29,21 +33,22 @@ void setupTests(ModelParams **modelParamsPtr) {
   ctx.waterHResp = 1;
   ctx.anaerobic = 1;
 
-  initModel(modelParamsPtr, "balance.param", "balance.clim");
-  initEvents("events.in", "events.out", ctx.printHeader);
+  initModel(model, modelParamsPtr, "balance.param", "balance.clim");
+  initEvents(model, "events.in", "events.out", ctx.printHeader);
   reset();
 #if DO_OUTPUT
   out = openFile(OUTPUT_FILE, "w");
-  outputHeader(out);
+  outputHeader(model, out);
 #endif
 }
 
 void dumpState(void);
 
 void step(void) {
-  updateState();
+  updateState(model);
 #if DO_OUTPUT
-  outputState(out, climate->year, climate->day, climate->time);
+  outputState(model, out, model->climate->year, model->climate->day,
+              model->climate->time);
 #endif
   dumpState();
 }
@@ -53,10 +58,11 @@ int checkCarbon(void) {
   validateContext();
 
   int status = 0;
-  if (fabs(balanceTracker.deltaC) > TEST_EPS) {
+  if (fabs(model->balanceTracker.deltaC) > TEST_EPS) {
     status = 1;
     logTest("carbon balance check delta %8.5f (Y %d D %d T %4.2f)\n",
-            balanceTracker.deltaC, climate->year, climate->day, climate->time);
+            model->balanceTracker.deltaC, model->climate->year,
+            model->climate->day, model->climate->time);
   }
   return status;
 }
@@ -66,10 +72,11 @@ int checkNitrogen(void) {
   validateContext();
 
   int status = 0;
-  if (fabs(balanceTracker.deltaN) > TEST_EPS) {
+  if (fabs(model->balanceTracker.deltaN) > TEST_EPS) {
     status = 1;
     logTest("nitrogen balance check delta %8.5f (Y %d D %d T %4.2f)\n",
-            balanceTracker.deltaN, climate->year, climate->day, climate->time);
+            model->balanceTracker.deltaN, model->climate->year,
+            model->climate->day, model->climate->time);
   }
   return status;
 }
@@ -91,18 +98,18 @@ int testBalanceLeaf(void) {
   logTest("Starting testBalanceLeaf()\n");
   int status = 0;
 
-  params.leafOnDay = 0;
-  params.leafOffDay = 0;
+  model->params.leafOnDay = 0;
+  model->params.leafOffDay = 0;
 
   // Run the whole climate file (5 days), which includes a leaf-on event and a
   // leaf-off event
-  while (climate != NULL) {
+  while (model->climate != NULL) {
     step();
 
     status |= checkCarbon();
     status |= checkNitrogen();
 
-    climate = climate->nextClim;
+    setClimateStep(model, model->climateStep + 1);
   }
 
   return status;
@@ -116,13 +123,13 @@ int testBalanceLeafEvents(void) {
   // and leaf-off events (days 47 and 49), PLUS event-file-based
   // leaf-on/leaf-off events on different days to test that event-based leaf
   // fluxes maintain carbon and nitrogen balance
-  while (climate != NULL) {
+  while (model->climate != NULL) {
     step();
 
     status |= checkCarbon();
     status |= checkNitrogen();
 
-    climate = climate->nextClim;
+    setClimateStep(model, model->climateStep + 1);
   }
 
   return status;
@@ -135,7 +142,7 @@ int testBalanceNoLitterPool(void) {
   ctx.nitrogenCycle = 0;  // requires litter-pool
 
   // Run the whole climate file (5 days)
-  while (climate != NULL) {
+  while (model->climate != NULL) {
     step();
 
     status |= checkCarbon();
@@ -143,7 +150,7 @@ int testBalanceNoLitterPool(void) {
     // aren't mishandling the case
     status |= checkNitrogen();
 
-    climate = climate->nextClim;
+    setClimateStep(model, model->climateStep + 1);
   }
 
   return status;
@@ -162,9 +169,9 @@ int run(void) {
   reset();
 
   // Re-initialize events with leaf on/off events for the next test
-  closeEventOutFile();
-  initEvents("events_leaf.in", "events.out", 0);
-  setupEvents();
+  closeEventOutFile(model);
+  initEvents(model, "events_leaf.in", "events.out", 0);
+  setupEvents(model);
   status |= testBalanceLeafEvents();
   reset();
 
@@ -192,49 +199,53 @@ int main(void) {
 
 void dumpState(void) {
 #if DEBUG_C | DEBUG_N
-  double len = climate->length;
+  double len = model->climate->length;
 #endif
 #if DEBUG_C
   logTest("preC %10.6f postC %10.6f inC %10.6f outC %10.6f pDelta %10.6f "
           "sDelta %10.6f delta %10.6f\n",
-          balanceTracker.preTotalC, balanceTracker.postTotalC,
-          balanceTracker.inputsC, balanceTracker.outputsC,
-          balanceTracker.postTotalC - balanceTracker.preTotalC,
-          balanceTracker.inputsC - balanceTracker.outputsC,
-          balanceTracker.deltaC);
+          model->balanceTracker.preTotalC, model->balanceTracker.postTotalC,
+          model->balanceTracker.inputsC, model->balanceTracker.outputsC,
+          model->balanceTracker.postTotalC - model->balanceTracker.preTotalC,
+          model->balanceTracker.inputsC - model->balanceTracker.outputsC,
+          model->balanceTracker.deltaC);
   logTest("  C:        wood %10.6f leaf %10.6f fine %10.6f coarse %10.6f "
           "soil %10.6f litter %10.6f\n",
-          envi.plantWoodC, envi.plantLeafC, envi.fineRootC, envi.coarseRootC,
-          envi.soilC, envi.litterC);
+          model->envi.plantWoodC, model->envi.plantLeafC, model->envi.fineRootC,
+              model->envi.coarseRootC,
+          model->envi.soilC, model->envi.litterC);
   logTest("  creation: wood %10.6f leaf %10.6f fine %10.6f coarse %10.6f\n",
-          fluxes.woodCreation * len, fluxes.leafCreation * len,
-          fluxes.fineRootCreation * len, fluxes.coarseRootCreation * len);
+          model->fluxes.woodCreation * len, model->fluxes.leafCreation * len,
+          model->fluxes.fineRootCreation * len,
+          model->fluxes.coarseRootCreation * len);
   logTest("  loss:     wood %10.6f leaf %10.6f fine %10.6f coarse %10.6f\n",
-          fluxes.woodLitter * len, fluxes.leafLitter * len,
-          fluxes.fineRootLoss * len, fluxes.coarseRootLoss * len);
+          model->fluxes.woodLitter * len, model->fluxes.leafLitter * len,
+          model->fluxes.fineRootLoss * len, model->fluxes.coarseRootLoss * len);
 #endif
 #if DEBUG_N
   logTest("preN %10.6f postN %10.6f inN %10.6f outN %10.6f pDelta %10.6f "
           "sDelta %10.6f delta %10.6f\n",
-          balanceTracker.preTotalN, balanceTracker.postTotalN,
-          balanceTracker.inputsN, balanceTracker.outputsN,
-          balanceTracker.postTotalN - balanceTracker.preTotalN,
-          balanceTracker.inputsN - balanceTracker.outputsN,
-          balanceTracker.deltaN);
+          model->balanceTracker.preTotalN, model->balanceTracker.postTotalN,
+          model->balanceTracker.inputsN, model->balanceTracker.outputsN,
+          model->balanceTracker.postTotalN - model->balanceTracker.preTotalN,
+          model->balanceTracker.inputsN - model->balanceTracker.outputsN,
+          model->balanceTracker.deltaN);
   logTest("  N:        wood %10.6f leaf %10.6f fine %10.6f coarse %10.6f "
           "soil %10.6f litter %10.6f min %10.6f\n",
-          envi.plantWoodC / params.woodCN, envi.plantLeafC / params.leafCN,
-          envi.fineRootC / params.fineRootCN, envi.coarseRootC / params.woodCN,
-          envi.soilOrgN, envi.litterN, envi.minN);
+          model->envi.plantWoodC / model->params.woodCN,
+              model->envi.plantLeafC / model->params.leafCN,
+          model->envi.fineRootC / model->params.fineRootCN,
+              model->envi.coarseRootC / model->params.woodCN,
+          model->envi.soilOrgN, model->envi.litterN, model->envi.minN);
   logTest("  creation: wood %10.6f leaf %10.6f fine %10.6f coarse %10.6f\n",
-          fluxes.woodCreation * len / params.woodCN,
-          fluxes.leafCreation * len / params.leafCN,
-          fluxes.fineRootCreation * len / params.fineRootCN,
-          fluxes.coarseRootCreation * len / params.woodCN);
+          model->fluxes.woodCreation * len / model->params.woodCN,
+          model->fluxes.leafCreation * len / model->params.leafCN,
+          model->fluxes.fineRootCreation * len / model->params.fineRootCN,
+          model->fluxes.coarseRootCreation * len / model->params.woodCN);
   logTest("  loss:     wood %10.6f leaf %10.6f fine %10.6f coarse %10.6f\n",
-          fluxes.woodLitter * len / params.woodCN,
-          fluxes.leafLitter * len / params.leafCN,
-          fluxes.fineRootLoss * len / params.fineRootCN,
-          fluxes.coarseRootLoss * len / params.woodCN);
+          model->fluxes.woodLitter * len / model->params.woodCN,
+          model->fluxes.leafLitter * len / model->params.leafCN,
+          model->fluxes.fineRootLoss * len / model->params.fineRootCN,
+          model->fluxes.coarseRootLoss * len / model->params.woodCN);
 #endif
 }
@@ -1,30 +1,34 @@
 #include "utils/tUtils.h"
 #include "sipnet/sipnet.c"
 
+// Model instance shared by the tests in this file
+static SipnetModel testModel;
+static SipnetModel *model = &testModel;
+
 void resetState(void) {
   ctx.litterPool = 1;
   ctx.carbonSaturation = 1;
 
-  envi.litterC = 10;
+  model->envi.litterC = 10;
 
-  params.soilCSaturation = 10;
+  model->params.soilCSaturation = 10;
 
-  fluxes.woodLitter = 0;
-  fluxes.leafLitter = 0;
-  fluxes.litterToSoil = 0;
-  fluxes.rLitter = 0;
-  fluxes.litterMethane = 0;
-  fluxes.soilMethane = 0;
-  fluxes.fineRootLoss = 0;
+  model->fluxes.woodLitter = 0;
+  model->fluxes.leafLitter = 0;
+  model->fluxes.litterToSoil = 0;
+  model->fluxes.rLitter = 0;
+  model->fluxes.litterMethane = 0;
+  model->fluxes.soilMethane = 0;
+  model->fluxes.fineRootLoss = 0;
 }
 
 void setupTests(void) {
   // set up dummy climate
-  climate = (ClimateNode *)malloc(sizeof(ClimateNode));
-  climate->year = 2024;
-  climate->day = 70;
-  climate->length = 0.125;
-  climate->tsoil = 20.0;
+  model->climate = (ClimateNode *)malloc(sizeof(ClimateNode));
+  model->climate->year = 2024;
+  model->climate->day = 70;
+  model->climate->length = 0.125;
+  model->climate->tsoil = 20.0;
 
   // Initialize general state
   resetState();
@@ -49,26 +53,28 @@ int checkPool(double calcPool, double expPool, const char *label) {
 
 int checkSoil(double pool) {
   int status = 0;
-  status |= checkPool(envi.soilC, pool, "soil");
+  status |= checkPool(model->envi.soilC, pool, "soil");
   return status;
 }
 
 int checkLitter(double pool) {
   int status = 0;
-  status |= checkPool(envi.litterC, pool, "litter");
+  status |= checkPool(model->envi.litterC, pool, "litter");
   return status;
 }
 
 void calcCSaturation(double *expSoilC, double *expLitterC) {
-  double soilInputs =
-      fluxes.coarseRootLoss + fluxes.fineRootLoss + fluxes.litterToSoil;
+  double soilInputs = model->fluxes.coarseRootLoss +
+                      model->fluxes.fineRootLoss + model->fluxes.litterToSoil;
   double saturationFraction =
-      ctx.carbonSaturation ? unitClip(*expSoilC / params.soilCSaturation) : 0.0;
+      ctx.carbonSaturation ? unitClip(*expSoilC / model->params.soilCSaturation)
+          : 0.0;
 
-  *expLitterC += soilInputs * saturationFraction * climate->length;
+  *expLitterC += soilInputs * saturationFraction * model->climate->length;
 
   *expSoilC +=
-      (soilInputs * (1 - saturationFraction) - fluxes.rSoil) * climate->length;
+      (soilInputs * (1 - saturationFraction) - model->fluxes.rSoil) *
+      model->climate->length;
 }
 
 int testCarbonSaturation(void) {
@@ -81,13 +87,13 @@ int testCarbonSaturation(void) {
   resetState();
 
   expSoilC = 2.5;  // 25% saturation
-  envi.soilC = 2.5;
+  model->envi.soilC = 2.5;
   expLitterC = 10;
-  fluxes.coarseRootLoss = 100;
-  fluxes.rSoil = 0;
+  model->fluxes.coarseRootLoss = 100;
+  model->fluxes.rSoil = 0;
 
   calcCSaturation(&expSoilC, &expLitterC);
-  updatePoolsForSoil();
+  updatePoolsForSoil(model);
   status |= checkSoil(expSoilC);
   status |= checkLitter(expLitterC);
 
@@ -96,13 +102,13 @@ int testCarbonSaturation(void) {
   resetState();
 
   expSoilC = 2.5;  // 25% saturation
-  envi.soilC = 2.5;
+  model->envi.soilC = 2.5;
   expLitterC = 10;
-  fluxes.coarseRootLoss = 200;
-  fluxes.rSoil = 0;
+  model->fluxes.coarseRootLoss = 200;
+  model->fluxes.rSoil = 0;
 
   calcCSaturation(&expSoilC, &expLitterC);
-  updatePoolsForSoil();
+  updatePoolsForSoil(model);
   status |= checkSoil(expSoilC);
   status |= checkLitter(expLitterC);
 
@@ -111,13 +117,13 @@ int testCarbonSaturation(void) {
   resetState();
 
   expSoilC = 7.5;  // 75% saturation
-  envi.soilC = 7.5;
+  model->envi.soilC = 7.5;
   expLitterC = 10;
-  fluxes.coarseRootLoss = 100;
-  fluxes.rSoil = 0;
+  model->fluxes.coarseRootLoss = 100;
+  model->fluxes.rSoil = 0;
 
   calcCSaturation(&expSoilC, &expLitterC);
-  updatePoolsForSoil();
+  updatePoolsForSoil(model);
   status |= checkSoil(expSoilC);
   status |= checkLitter(expLitterC);
 
@@ -126,13 +132,13 @@ int testCarbonSaturation(void) {
   resetState();
 
   expSoilC = 7.5;  // 75% saturation
-  envi.soilC = 7.5;
+  model->envi.soilC = 7.5;
   expLitterC = 10;
-  fluxes.coarseRootLoss = 200;
-  fluxes.rSoil = 0;
+  model->fluxes.coarseRootLoss = 200;
+  model->fluxes.rSoil = 0;
 
   calcCSaturation(&expSoilC, &expLitterC);
-  updatePoolsForSoil();
+  updatePoolsForSoil(model);
   status |= checkSoil(expSoilC);
   status |= checkLitter(expLitterC);
 
@@ -141,13 +147,13 @@ int testCarbonSaturation(void) {
   resetState();
 
   expSoilC = 12.5;  // 125% saturation
-  envi.soilC = 12.5;
+  model->envi.soilC = 12.5;
   expLitterC = 10;
-  fluxes.coarseRootLoss = 200;
-  fluxes.rSoil = 50;
+  model->fluxes.coarseRootLoss = 200;
+  model->fluxes.rSoil = 50;
 
   calcCSaturation(&expSoilC, &expLitterC);
-  updatePoolsForSoil();
+  updatePoolsForSoil(model);
   // logTest("   expSoilC is %f\n", expSoilC);
   // logTest("   expLitterC is %f\n", expLitterC);
   status |= checkSoil(expSoilC);
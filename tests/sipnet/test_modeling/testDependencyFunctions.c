@@ -1,6 +1,10 @@
 #include "utils/tUtils.h"
 #include "sipnet/depeffects.c"
 
+// Model instance shared by the tests in this file
+static SipnetModel testModel;
+static SipnetModel *model = &testModel;
+
 void setupTests() {
   // Set up the context
   initContext();
@@ -10,32 +14,32 @@ void setupTests() {
   ctx.nitrogenCycle = 0;
 
   // Climate
-  climate = (ClimateNode *)malloc(sizeof(ClimateNode));
-  climate->year = 2024;
-  climate->day = 70;
-  climate->length = 0.125;
-  climate->tsoil = 20.0;
+  model->climate = (ClimateNode *)malloc(sizeof(ClimateNode));
+  model->climate->year = 2024;
+  model->climate->day = 70;
+  model->climate->length = 0.125;
+  model->climate->tsoil = 20.0;
 
   // Params; values picked for ease of calculation
-  params.soilWHC = 10.0;
-  params.soilRespMoistEffect = 2.0;
-  params.kCN = 10.0;
-  params.soilRespQ10 = 3.0;
-  params.fAnoxia = 0.75;
-  params.anaerobicDecompRate = 0.5;
-  params.anaerobicTransExp = 2.0;
+  model->params.soilWHC = 10.0;
+  model->params.soilRespMoistEffect = 2.0;
+  model->params.kCN = 10.0;
+  model->params.soilRespQ10 = 3.0;
+  model->params.fAnoxia = 0.75;
+  model->params.anaerobicDecompRate = 0.5;
+  model->params.anaerobicTransExp = 2.0;
 
   // Environment
-  envi.soilWater = 5.0;
+  model->envi.soilWater = 5.0;
   // soil CN 7.5
-  envi.soilC = 15.0;
-  envi.soilOrgN = 2.0;
+  model->envi.soilC = 15.0;
+  model->envi.soilOrgN = 2.0;
   // litter CN 5.0
-  envi.litterC = 7.5;
-  envi.litterN = 1.5;
+  model->envi.litterC = 7.5;
+  model->envi.litterN = 1.5;
 
   // Trackers
-  initEventTrackers();
+  initEventTrackers(model);
 }
 
 void initTestState(void) {
@@ -43,10 +47,10 @@ void initTestState(void) {
   ctx.litterPool = 1;
   ctx.anaerobic = 0;
   ctx.nitrogenCycle = 0;
-  envi.soilWater = 5.0;
-  climate->tsoil = 20;
-  eventTrackers.d_till_mod = 0.0;
-  params.fAnoxia = 0.75;
+  model->envi.soilWater = 5.0;
+  model->climate->tsoil = 20;
+  model->eventTrackers.d_till_mod = 0.0;
+  model->params.fAnoxia = 0.75;
 }
 
 void checkStatus(int status, const char *label, double calc, double exp) {
@@ -59,35 +63,38 @@ void checkStatus(int status, const char *label, double calc, double exp) {
 }
 
 int checkRespMoistEffect(double exp) {
-  double calc = calcRespMoistEffect(envi.soilWater, params.soilWHC);
+  double calc = calcRespMoistEffect(model, model->envi.soilWater,
+                                    model->params.soilWHC);
   int status = !compareDoubles(calc, exp);
   checkStatus(status, "Moist effect (resp)", calc, exp);
   return status;
 }
 
 int checkVolatilizationMoistEffect(double exp) {
-  double calc = calcVolatilizationMoistEffect(envi.soilWater, params.soilWHC);
+  double calc = calcVolatilizationMoistEffect(model, model->envi.soilWater,
+                                              model->params.soilWHC);
   int status = !compareDoubles(calc, exp);
   checkStatus(status, "Moist effect (vol)", calc, exp);
   return status;
 }
 
 int checkMethaneMoistEffect(double exp) {
-  double calc = calcMethaneMoistEffect(envi.soilWater, params.soilWHC);
+  double calc = calcMethaneMoistEffect(model, model->envi.soilWater,
+                                       model->params.soilWHC);
   int status = !compareDoubles(calc, exp);
   checkStatus(status, "Moist effect (methane)", calc, exp);
   return status;
 }
 
 int checkTempEffect(double exp) {
-  double calc = calcTempEffect(climate->tsoil);
+  double calc = calcTempEffect(model, model->climate->tsoil);
   int status = !compareDoubles(calc, exp);
   checkStatus(status, "Temp effect", calc, exp);
   return status;
 }
 
 int checkTillageEffect(double exp) {
-  double calc = calcTillageEffect();
+  double calc = calcTillageEffect(model);
   int status = !compareDoubles(calc, exp);
   checkStatus(status, "Tillage effect", calc, exp);
   return status;
@@ -100,7 +107,7 @@ int checkCNRatio(double calc, double exp, const char *label) {
 }
 
 int checkCNEffect(double c, double n, double exp, const char *label) {
-  double calc = calcCNEffect(params.kCN, c, n);
+  double calc = calcCNEffect(model->params.kCN, c, n);
   int status = !compareDoubles(calc, exp);
   checkStatus(status, label, calc, exp);
   return status;
@@ -116,15 +123,15 @@ int runTests() {
   ctx.waterHResp = 0;
   status |= checkRespMoistEffect(1);
   ctx.waterHResp = 1;
-  climate->tsoil = -10.0;
+  model->climate->tsoil = -10.0;
   status |= checkRespMoistEffect(1);
 
   // Moisture effect clipping in non-anaerobic mode
   initTestState();
-  envi.soilWater = 12.0;
+  model->envi.soilWater = 12.0;
   // f_whc clips to 1
   status |= checkRespMoistEffect(1.0);
-  envi.soilWater = -1.0;
+  model->envi.soilWater = -1.0;
   // f_whc clips to 0
   status |= checkRespMoistEffect(0.0);
 
@@ -133,7 +140,7 @@ int runTests() {
   ctx.anaerobic = 1;
   // D_aer=2/3, A=0
   status |= checkRespMoistEffect(2.0 / 3.0);
-  params.fAnoxia = 0.4;
+  model->params.fAnoxia = 0.4;
   // D_aer=1, A=1/6
   status |= checkRespMoistEffect(5.5 / 6.0);
 
@@ -143,7 +150,7 @@ int runTests() {
   ctx.nitrogenCycle = 1;
   // A=0
   status |= checkVolatilizationMoistEffect(0.05);
-  params.fAnoxia = 0.4;
+  model->params.fAnoxia = 0.4;
   // A=1/6
   status |= checkVolatilizationMoistEffect(26.0 / 45.0);
 
@@ -152,7 +159,7 @@ int runTests() {
   ctx.anaerobic = 1;
   // A=0
   status |= checkMethaneMoistEffect(0.0);
-  params.fAnoxia = 0.4;
+  model->params.fAnoxia = 0.4;
   // A=1/6
   status |= checkMethaneMoistEffect(1.0 / 36.0);
 
@@ -164,28 +171,30 @@ int runTests() {
   // More complicated effects are tested elsewhere
   initTestState();
   status |= checkTillageEffect(1.0);
-  eventTrackers.d_till_mod = 1.0;
+  model->eventTrackers.d_till_mod = 1.0;
   status |= checkTillageEffect(2.0);
 
   // C:N effect, one branch
   initTestState();
   ctx.anaerobic = 1;  // req for nitrogenCycle
   ctx.nitrogenCycle = 1;
-  status |=
-      checkCNRatio(calcRatio(envi.soilC, envi.soilOrgN), 7.5, "Soil C:N ratio");
-  status |= checkCNRatio(calcRatio(envi.litterC, envi.litterN), 5.0,
-                         "Litter C:N ratio");
-  status |=
-      checkCNEffect(envi.soilC, envi.soilOrgN, 10.0 / 17.5, "Soil C:N effect");
-  status |= checkCNEffect(envi.litterC, envi.litterN, 10.0 / 15.0,
+  status |= checkCNRatio(calcRatio(model->envi.soilC, model->envi.soilOrgN),
+                         7.5, "Soil C:N ratio");
+  status |= checkCNRatio(calcRatio(model->envi.litterC, model->envi.litterN),
+                         5.0, "Litter C:N ratio");
+  status |= checkCNEffect(model->envi.soilC, model->envi.soilOrgN, 10.0 / 17.5,
+                          "Soil C:N effect");
+  status |= checkCNEffect(model->envi.litterC, model->envi.litterN, 10.0 / 15.0,
                           "Litter C:N effect");
   // kCN should be CN value at which dep is 0.5, so let's check
-  params.kCN = 5.0;
-  status |= checkCNEffect(envi.litterC, envi.litterN, 0.5, "Litter C:N effect");
+  model->params.kCN = 5.0;
+  status |= checkCNEffect(model->envi.litterC, model->envi.litterN, 0.5,
+                          "Litter C:N effect");
 
   // Lastly, dep is 1 when nitrogen_cycle is off
   ctx.nitrogenCycle = 0;
-  status |= checkCNEffect(envi.soilC, envi.soilOrgN, 1.0, "Soil C:N effect");
+  status |= checkCNEffect(model->envi.soilC, model->envi.soilOrgN, 1.0,
+                          "Soil C:N effect");
 
   return status;
 }
@@ -2,6 +2,10 @@
 #include "sipnet/events.c"
 #include "sipnet/sipnet.c"
 
+// Model instance shared by the tests in this file
+static SipnetModel testModel;
+static SipnetModel *model = &testModel;
+
 /////
 // Setup and state management
 
@@ -15,25 +19,28 @@ void resetContext(void) {
 
 void setupTests(void) {
   // Set up dummy climate
-  climate = (ClimateNode *)malloc(sizeof(ClimateNode));
-  climate->year = 2024;
-  climate->day = 70;
-  climate->time = 0.0;
-  climate->tsoil = 20.0;
-  climate->length = 0.125;
+  model->climate = (ClimateNode *)malloc(sizeof(ClimateNode));
+  model->climate->year = 2024;
+  model->climate->day = 70;
+  model->climate->time = 0.0;
+  model->climate->tsoil = 20.0;
+  model->climate->length = 0.125;
 
   // Set up the context
   initContext();
   resetContext();
 
   // Initialize mean NPP tracker
-  meanNPP = newMeanTracker(0, MEAN_NPP_DAYS, MEAN_NPP_MAX_ENTRIES);
+  model->meanNPP = newMeanTracker(0, MEAN_NPP_DAYS, MEAN_NPP_MAX_ENTRIES);
 
   // Initialize event trackers
-  initEventTrackers();
+  initEventTrackers(model);
+
+  // Climate-derived terms, e.g. root temperature effects
+  calcStepForcing(model, model->climate);
 }
 
-void resetFluxVars(void) { fluxes = (struct FluxVars){0}; }
+void resetFluxVars(void) { model->fluxes = (struct FluxVars){0}; }
 
 int checkFlux(double calc, double exp, const char *label) {
   validateContext();
@@ -55,15 +62,15 @@ int testWoodAndLeafFluxesPositiveNPP(void) {
   resetContext();
   resetFluxVars();
   // Set NPP mean to 10.0 g C/m^2/day
-  resetMeanTracker(meanNPP, 10.0);
+  resetMeanTracker(model->meanNPP, 10.0);
 
-  envi.plantWoodC = 5.0;
-  envi.plantCAccountingDelta = 0.0;
-  envi.plantLeafC = 3.0;
-  params.woodTurnoverRate = 0.1;
-  params.leafTurnoverRate = 0.2;
-  params.leafAllocation = 0.3;
-  params.woodAllocation = 0.4;
+  model->envi.plantWoodC = 5.0;
+  model->envi.plantCAccountingDelta = 0.0;
+  model->envi.plantLeafC = 3.0;
+  model->params.woodTurnoverRate = 0.1;
+  model->params.leafTurnoverRate = 0.2;
+  model->params.leafAllocation = 0.3;
+  model->params.woodAllocation = 0.4;
 
   // Expected:
   // woodLitter = (5.0 + 0.0) * 0.1 = 0.5
@@ -71,14 +78,18 @@ int testWoodAndLeafFluxesPositiveNPP(void) {
   // leafCreation = 10.0 * 0.3 = 3.0
   // woodCreation = 10.0 * 0.4 = 4.0
   // leafDeficit = 3.0 / 0.125 + 3.0 - 0.6 = 26.4 > 0 -> no adjustment
-  calcWoodAndLeafFluxes();
-
-  status |= checkFlux(fluxes.woodLitter, 0.5, "woodLitter (positive NPP)");
-  status |= checkFlux(fluxes.leafLitter, 0.6, "leafLitter (positive NPP)");
-  status |= checkFlux(fluxes.leafCreation, 3.0, "leafCreation (positive NPP)");
-  status |= checkFlux(fluxes.woodCreation, 4.0, "woodCreation (positive NPP)");
+  calcWoodAndLeafFluxes(model);
+
+  status |= checkFlux(model->fluxes.woodLitter, 0.5,
+                      "woodLitter (positive NPP)");
+  status |= checkFlux(model->fluxes.leafLitter, 0.6,
+                      "leafLitter (positive NPP)");
+  status |= checkFlux(model->fluxes.leafCreation, 3.0,
+                      "leafCreation (positive NPP)");
+  status |= checkFlux(model->fluxes.woodCreation, 4.0,
+                      "woodCreation (positive NPP)");
   // No N resorption when NPP is positive
-  status |= checkFlux(fluxes.reductionNResorption, 0.0,
+  status |= checkFlux(model->fluxes.reductionNResorption, 0.0,
                       "reductionNResorption (positive NPP)");
   return status;
 }
@@ -93,18 +104,18 @@ int testWoodAndLeafFluxesNegativeNPP(void) {
   ctx.anaerobic = 1;
   resetFluxVars();
   // Set NPP mean to -2.0 (carbon loss)
-  resetMeanTracker(meanNPP, -2.0);
-
-  envi.plantWoodC = 5.0;
-  envi.plantCAccountingDelta = 0.0;
-  envi.plantLeafC = 3.0;
-  params.woodTurnoverRate = 0.1;
-  params.leafTurnoverRate = 0.2;
-  params.leafAllocation = 0.3;
-  params.woodAllocation = 0.4;
-  params.leafCN = 20.0;
-  params.woodCN = 100.0;
-  params.fineRootCN = 40.0;
+  resetMeanTracker(model->meanNPP, -2.0);
+
+  model->envi.plantWoodC = 5.0;
+  model->envi.plantCAccountingDelta = 0.0;
+  model->envi.plantLeafC = 3.0;
+  model->params.woodTurnoverRate = 0.1;
+  model->params.leafTurnoverRate = 0.2;
+  model->params.leafAllocation = 0.3;
+  model->params.woodAllocation = 0.4;
+  model->params.leafCN = 20.0;
+  model->params.woodCN = 100.0;
+  model->params.fineRootCN = 40.0;
 
   // Expected:
   // woodLitter = 5.0 * 0.1 = 0.5
@@ -116,15 +127,19 @@ int testWoodAndLeafFluxesNegativeNPP(void) {
   //   leafOffNResorption += -(-0.6) / 20.0 = 0.03
   //   leafOffNResorption += -(-0.8) / 100.0 = 0.008
   //   total = 0.038
-  calcWoodAndLeafFluxes();
-  checkCarbonLimitations();
-  calcNResorptionFluxes();
-
-  status |= checkFlux(fluxes.woodLitter, 0.5, "woodLitter (negative NPP)");
-  status |= checkFlux(fluxes.leafLitter, 0.6, "leafLitter (negative NPP)");
-  status |= checkFlux(fluxes.leafCreation, -0.6, "leafCreation (negative NPP)");
-  status |= checkFlux(fluxes.woodCreation, -0.8, "woodCreation (negative NPP)");
-  status |= checkFlux(fluxes.reductionNResorption, 0.038,
+  calcWoodAndLeafFluxes(model);
+  checkCarbonLimitations(model);
+  calcNResorptionFluxes(model);
+
+  status |= checkFlux(model->fluxes.woodLitter, 0.5,
+                      "woodLitter (negative NPP)");
+  status |= checkFlux(model->fluxes.leafLitter, 0.6,
+                      "leafLitter (negative NPP)");
+  status |= checkFlux(model->fluxes.leafCreation, -0.6,
+                      "leafCreation (negative NPP)");
+  status |= checkFlux(model->fluxes.woodCreation, -0.8,
+                      "woodCreation (negative NPP)");
+  status |= checkFlux(model->fluxes.reductionNResorption, 0.038,
                       "reductionNResorption (negative NPP)");
   return status;
 }
@@ -136,15 +151,15 @@ int testWoodAndLeafFluxesLeafDeficit(void) {
   resetContext();
   resetFluxVars();
   // Very negative NPP causes leaf deficit - excess deducted from wood
-  resetMeanTracker(meanNPP, -5.0);
+  resetMeanTracker(model->meanNPP, -5.0);
 
-  envi.plantWoodC = 10.0;
-  envi.plantCAccountingDelta = 0.0;
-  envi.plantLeafC = 0.0;  // empty leaf pool
-  params.woodTurnoverRate = 0.0;
-  params.leafTurnoverRate = 0.0;
-  params.leafAllocation = 0.3;
-  params.woodAllocation = 0.4;
+  model->envi.plantWoodC = 10.0;
+  model->envi.plantCAccountingDelta = 0.0;
+  model->envi.plantLeafC = 0.0;  // empty leaf pool
+  model->params.woodTurnoverRate = 0.0;
+  model->params.leafTurnoverRate = 0.0;
+  model->params.leafAllocation = 0.3;
+  model->params.woodAllocation = 0.4;
 
   // Expected:
   // woodLitter = 0, leafLitter = 0
@@ -153,11 +168,13 @@ int testWoodAndLeafFluxesLeafDeficit(void) {
   // leafDeficit = 0/0.125 + (-1.5) - 0 = -1.5 < 0
   //   -> woodCreation += -1.5 -> woodCreation = -3.5
   //   -> leafCreation -= -1.5 -> leafCreation = 0.0
-  calcWoodAndLeafFluxes();
-  checkCarbonLimitations();
+  calcWoodAndLeafFluxes(model);
+  checkCarbonLimitations(model);
 
-  status |= checkFlux(fluxes.leafCreation, 0.0, "leafCreation (leaf deficit)");
-  status |= checkFlux(fluxes.woodCreation, -3.5, "woodCreation (leaf deficit)");
+  status |= checkFlux(model->fluxes.leafCreation, 0.0,
+                      "leafCreation (leaf deficit)");
+  status |= checkFlux(model->fluxes.woodCreation, -3.5,
+                      "woodCreation (leaf deficit)");
   return status;
 }
 
@@ -167,22 +184,22 @@ int testWoodAndLeafFluxesWithAccountingDelta(void) {
 
   resetContext();
   resetFluxVars();
-  resetMeanTracker(meanNPP, 0.0);  // zero NPP
+  resetMeanTracker(model->meanNPP, 0.0);  // zero NPP
 
-  envi.plantWoodC = 5.0;
-  envi.plantCAccountingDelta = 3.0;  // positive accounting delta
-  envi.plantLeafC = 0.0;
-  params.woodTurnoverRate = 0.1;
-  params.leafTurnoverRate = 0.0;
-  params.leafAllocation = 0.3;
-  params.woodAllocation = 0.4;
+  model->envi.plantWoodC = 5.0;
+  model->envi.plantCAccountingDelta = 3.0;  // positive accounting delta
+  model->envi.plantLeafC = 0.0;
+  model->params.woodTurnoverRate = 0.1;
+  model->params.leafTurnoverRate = 0.0;
+  model->params.leafAllocation = 0.3;
+  model->params.woodAllocation = 0.4;
 
   // Wood litter uses total wood = woodC + delta = 5 + 3 = 8
   // Expected: woodLitter = 8.0 * 0.1 = 0.8
-  calcWoodAndLeafFluxes();
-  checkCarbonLimitations();
+  calcWoodAndLeafFluxes(model);
+  checkCarbonLimitations(model);
 
-  status |= checkFlux(fluxes.woodLitter, 0.8, "woodLitter (with delta)");
+  status |= checkFlux(model->fluxes.woodLitter, 0.8, "woodLitter (with delta)");
   return status;
 }
 
@@ -195,35 +212,36 @@ int testRootFluxesPositiveNPP(void) {
 
   resetContext();
   resetFluxVars();
-  resetMeanTracker(meanNPP, 8.0);
-
-  envi.coarseRootC = 5.0;
-  envi.fineRootC = 3.0;
-  params.coarseRootAllocation = 0.1;
-  params.fineRootAllocation = 0.2;
-  params.coarseRootTurnoverRate = 0.01;
-  params.fineRootTurnoverRate = 0.02;
+  resetMeanTracker(model->meanNPP, 8.0);
+
+  model->envi.coarseRootC = 5.0;
+  model->envi.fineRootC = 3.0;
+  model->params.coarseRootAllocation = 0.1;
+  model->params.fineRootAllocation = 0.2;
+  model->params.coarseRootTurnoverRate = 0.01;
+  model->params.fineRootTurnoverRate = 0.02;
   // These are needed for calcRootResp, set to zero to avoid side effects
-  params.baseCoarseRootResp = 0.0;
-  params.baseFineRootResp = 0.0;
+  model->params.baseCoarseRootResp = 0.0;
+  model->params.baseFineRootResp = 0.0;
 
   // Expected:
   // coarseRootCreation = 8.0 * 0.1 = 0.8
   // fineRootCreation = 8.0 * 0.2 = 1.6
   // coarseRootLoss = 5.0 * 0.01 = 0.05
   // fineRootLoss = 3.0 * 0.02 = 0.06
-  calcRootFluxes();
-  checkCarbonLimitations();
+  calcRootFluxes(model);
+  checkCarbonLimitations(model);
 
-  status |= checkFlux(fluxes.coarseRootCreation, 0.8,
+  status |= checkFlux(model->fluxes.coarseRootCreation, 0.8,
                       "coarseRootCreation (positive NPP)");
-  status |= checkFlux(fluxes.fineRootCreation, 1.6,
+  status |= checkFlux(model->fluxes.fineRootCreation, 1.6,
                       "fineRootCreation (positive NPP)");
-  status |=
-      checkFlux(fluxes.coarseRootLoss, 0.05, "coarseRootLoss (positive NPP)");
-  status |= checkFlux(fluxes.fineRootLoss, 0.06, "fineRootLoss (positive NPP)");
+  status |= checkFlux(model->fluxes.coarseRootLoss, 0.05,
+                      "coarseRootLoss (positive NPP)");
+  status |= checkFlux(model->fluxes.fineRootLoss, 0.06,
+                      "fineRootLoss (positive NPP)");
   // No N resorption when NPP is positive
-  status |= checkFlux(fluxes.reductionNResorption, 0.0,
+  status |= checkFlux(model->fluxes.reductionNResorption, 0.0,
                       "reductionNResorption (positive NPP roots)");
   return status;
 }
@@ -235,19 +253,19 @@ void initRootFluxesNegativeNPPState(double nppInit, double coarseInit,
   ctx.litterPool = 1;
   ctx.anaerobic = 1;
   resetFluxVars();
-  resetMeanTracker(meanNPP, nppInit);
-
-  envi.coarseRootC = coarseInit;
-  envi.fineRootC = fineInit;
-  params.coarseRootAllocation = 0.1;
-  params.fineRootAllocation = 0.2;
-  params.coarseRootTurnoverRate = 0.0;
-  params.fineRootTurnoverRate = 0.0;
-  params.woodCN = 100.0;
-  params.leafCN = 20.0;
-  params.fineRootCN = 40.0;
-  params.baseCoarseRootResp = 0.0;
-  params.baseFineRootResp = 0.0;
+  resetMeanTracker(model->meanNPP, nppInit);
+
+  model->envi.coarseRootC = coarseInit;
+  model->envi.fineRootC = fineInit;
+  model->params.coarseRootAllocation = 0.1;
+  model->params.fineRootAllocation = 0.2;
+  model->params.coarseRootTurnoverRate = 0.0;
+  model->params.fineRootTurnoverRate = 0.0;
+  model->params.woodCN = 100.0;
+  model->params.leafCN = 20.0;
+  model->params.fineRootCN = 40.0;
+  model->params.baseCoarseRootResp = 0.0;
+  model->params.baseFineRootResp = 0.0;
 }
 
 int testRootFluxesNegativeNPP(void) {
@@ -263,15 +281,15 @@ int testRootFluxesNegativeNPP(void) {
   //   leafOffNResorption += -(-0.8) / 40.0  = 0.02
   //   total = 0.024
   initRootFluxesNegativeNPPState(-4.0, 5.0, 3.0);
-  calcRootFluxes();
-  checkCarbonLimitations();
-  calcNResorptionFluxes();
+  calcRootFluxes(model);
+  checkCarbonLimitations(model);
+  calcNResorptionFluxes(model);
 
-  status |= checkFlux(fluxes.coarseRootCreation, -0.4,
+  status |= checkFlux(model->fluxes.coarseRootCreation, -0.4,
                       "coarseRootCreation (negative NPP)");
-  status |= checkFlux(fluxes.fineRootCreation, -0.8,
+  status |= checkFlux(model->fluxes.fineRootCreation, -0.8,
                       "fineRootCreation (negative NPP)");
-  status |= checkFlux(fluxes.reductionNResorption, 0.024,
+  status |= checkFlux(model->fluxes.reductionNResorption, 0.024,
                       "reductionNResorption (negative NPP roots)");
 
   // Case 2: negative fine root
@@ -284,15 +302,15 @@ int testRootFluxesNegativeNPP(void) {
   //   leafOffNResorption += 4.0 / 40.0  = 0.1
   //   total = 0.156
   initRootFluxesNegativeNPPState(-32.0, 5.0, 0.5);
-  calcRootFluxes();
-  checkCarbonLimitations();
-  calcNResorptionFluxes();
+  calcRootFluxes(model);
+  checkCarbonLimitations(model);
+  calcNResorptionFluxes(model);
 
-  status |= checkFlux(fluxes.coarseRootCreation, -5.6,
+  status |= checkFlux(model->fluxes.coarseRootCreation, -5.6,
                       "coarseRootCreation (negative fine roots)");
-  status |= checkFlux(fluxes.fineRootCreation, -4.0,
+  status |= checkFlux(model->fluxes.fineRootCreation, -4.0,
                       "fineRootCreation (negative fine roots)");
-  status |= checkFlux(fluxes.reductionNResorption, 0.156,
+  status |= checkFlux(model->fluxes.reductionNResorption, 0.156,
                       "reductionNResorption (negative fine roots)");
 
   // Case 3: negative coarse root
@@ -305,15 +323,15 @@ int testRootFluxesNegativeNPP(void) {
   //   leafOffNResorption += 8.0 / 40.0  = 0.2
   //   total = 0.216
   initRootFluxesNegativeNPPState(-32.0, 0.2, 5.0);
-  calcRootFluxes();
-  checkCarbonLimitations();
-  calcNResorptionFluxes();
+  calcRootFluxes(model);
+  checkCarbonLimitations(model);
+  calcNResorptionFluxes(model);
 
-  status |= checkFlux(fluxes.coarseRootCreation, -1.6,
+  status |= checkFlux(model->fluxes.coarseRootCreation, -1.6,
                       "coarseRootCreation (negative fine roots)");
-  status |= checkFlux(fluxes.fineRootCreation, -8.0,
+  status |= checkFlux(model->fluxes.fineRootCreation, -8.0,
                       "fineRootCreation (negative fine roots)");
-  status |= checkFlux(fluxes.reductionNResorption, 0.216,
+  status |= checkFlux(model->fluxes.reductionNResorption, 0.216,
                       "reductionNResorption (negative fine roots)");
 
   return status;
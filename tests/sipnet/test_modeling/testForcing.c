@@ -0,0 +1,125 @@
+#include "utils/tUtils.h"
+#include "sipnet/sipnet.c"
+
+// Model instance shared by the tests in this file
+static SipnetModel testModel;
+static SipnetModel *model = &testModel;
+
+int checkTerm(double calc, double exp, const char *label) {
+  // The terms must match the calculations they replace exactly, not just to
+  // within rounding
+  if (memcmp(&calc, &exp, sizeof(double)) != 0) {
+    logTest("Step %ld: %s is %.17g, expected %.17g\n", model->climateStep,
+            label, calc, exp);
+    return 1;
+  }
+  return 0;
+}
+
+// Check the climate-derived terms of the current step against the inline
+// calculations they replace
+int checkStep(const ClimateNode *climate) {
+  const Params *params = &model->params;
+  int status = 0;
+
+  double dTemp = (params->psnTMax - climate->tair) *
+                 (climate->tair - params->psnTMin) /
+                 pow((params->psnTMax - params->psnTMin) / 2.0, 2);
+  double dVpd = 1.0 - params->dVpdSlope * pow(climate->vpd, params->dVpdExp);
+
+  status |= checkTerm(climate->dTemp, fmax(dTemp, 0.0), "dTemp");
+  status |= checkTerm(climate->dVpd, fmax(dVpd, 0.0), "dVpd");
+  status |= checkTerm(
+      climate->folRespTempEffect,
+      pow(params->vegRespQ10, (climate->tair - params->psnTOpt) / 10.0),
+      "folRespTempEffect");
+  status |= checkTerm(climate->woodRespTempEffect,
+                      pow(params->vegRespQ10, climate->tair / 10.0),
+                      "woodRespTempEffect");
+  status |= checkTerm(climate->soilTempEffect,
+                      pow(params->soilRespQ10, climate->tsoil / 10),
+                      "soilTempEffect");
+  status |= checkTerm(climate->coarseRootTempEffect,
+                      pow(params->coarseRootQ10, climate->tsoil / 10.0),
+                      "coarseRootTempEffect");
+  status |= checkTerm(climate->fineRootTempEffect,
+                      pow(params->fineRootQ10, climate->tsoil / 10.0),
+                      "fineRootTempEffect");
+  status |= checkTerm(climate->rd, params->rdConst / climate->wspd, "rd");
+
+  return status;
+}
+
+int testForcingSteps(void) {
+  int status = 0;
+
+  logTest("Running testForcingSteps\n");
+
+  setupModel(model);
+  while (model->climate != NULL) {
+    status |= checkStep(model->climate);
+
+    // A copy of the step, recalculated on its own, gives the same terms
+    ClimateNode copy = *model->climate;
+    copy.dTemp = copy.rd = 0.0;
+    calcStepForcing(model, &copy);
+    status |= checkStep(&copy);
+
+    setClimateStep(model, model->climateStep + 1);
+  }
+
+  return status;
+}
+
+int testForcingUpdate(void) {
+  int status = 0;
+
+  logTest("Running testForcingUpdate\n");
+
+  // Changing the parameters and setting up again recalculates the terms
+  model->params.vegRespQ10 *= 1.5;
+  model->params.rdConst *= 2.0;
+  setupModel(model);
+  if (model->forcing->numSteps != model->climateData->numSteps) {
+    logTest("Forcing has %ld steps, expected %ld\n", model->forcing->numSteps,
+            model->climateData->numSteps);
+    status = 1;
+  }
+  while (model->climate != NULL) {
+    status |= checkStep(model->climate);
+    setClimateStep(model, model->climateStep + 1);
+  }
+
+  return status;
+}
+
+int run(void) {
+  int status = 0;
+  ModelParams *modelParams;
+
+  initContext();
+  ctx.events = 0;
+  initModel(model, &modelParams, "balance.param", "balance.clim");
+
+  status |= testForcingSteps();
+  status |= testForcingUpdate();
+
+  cleanupModel(model);
+  deleteModelParams(modelParams);
+
+  return status;
+}
+
+int main(void) {
+  int status;
+
+  logTest("Starting testForcing:run()\n");
+  status = run();
+  if (status) {
+    logTest("FAILED testForcing with status %d\n", status);
+    exit(status);
+  }
+
+  logTest("PASSED testForcing\n");
+  return 0;
+}
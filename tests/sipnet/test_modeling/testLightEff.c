@@ -0,0 +1,158 @@
+#include "utils/tUtils.h"
+#include "sipnet/sipnet.c"
+
+// Model instance shared by the tests in this file
+static SipnetModel testModel;
+static SipnetModel *model = &testModel;
+
+// Simpson's rule with this many layers stands in for the exact integral
+#define REF_LAYERS 2000
+
+// Canopy light effect by Simpson's rule with REF_LAYERS layers
+double refLightEff(double lai, double par) {
+  double sum = 0.0;
+
+  for (int layer = 0; layer <= REF_LAYERS; ++layer) {
+    double cumLai = lai * ((double)layer / REF_LAYERS);
+    double intensity = par * exp(-model->params.attenuation * cumLai);
+    double eff = 1 - pow(2, -intensity / model->params.halfSatPar);
+    int coeff = ((layer == 0) || (layer == REF_LAYERS)) ? 1
+                                                         : 2 * (1 + layer % 2);
+    sum += coeff * eff;
+  }
+  return sum / (3.0 * REF_LAYERS);
+}
+
+int checkClose(double calc, double exp, double tol, const char *label) {
+  if (fabs(calc - exp) > tol) {
+    logTest("%s: calculated %.17g, expected %.17g\n", label, calc, exp);
+    return 1;
+  }
+  return 0;
+}
+
+int testExpInt(void) {
+  int status = 0;
+
+  logTest("Running testExpInt\n");
+
+  // Reference values from Abramowitz & Stegun, table 5.1, and mpmath
+  status |= checkClose(expIntE1(0.5), 0.55977359477616081175, 1e-15, "E1(0.5)");
+  status |= checkClose(expIntE1(1.0), 0.21938393439552027368, 1e-15, "E1(1)");
+  status |= checkClose(expIntE1(2.0), 0.04890051070806111957, 1e-16, "E1(2)");
+  status |= checkClose(expIntE1(10.0), 4.1569689296853242774e-06, 1e-20,
+                       "E1(10)");
+  status |= checkClose(expIntEin(1.0), 0.79659959929705313428, 1e-15,
+                       "Ein(1)");
+  status |= checkClose(expIntEin(0.0), 0.0, 0.0, "Ein(0)");
+  status |= checkClose(expIntEin(1e-10), 1e-10 - 2.5e-21, 1e-25, "Ein(1e-10)");
+
+  return status;
+}
+
+// Compare both methods to the reference over a grid of lai and par, from
+// nearly bare to dense canopies and from dim to bright light
+int checkGrid(double attenuation, double halfSatPar) {
+  int status = 0;
+  double maxAnalytic = 0.0;
+  double maxSimpson = 0.0;
+  const double lais[] = {1e-6, 1e-3, 0.01, 0.03, 0.1, 0.5, 1, 2, 4, 8};
+  const double pars[] = {0.01, 1, 5, 10, 25, 50, 100, 200, 1000};
+
+  model->params.attenuation = attenuation;
+  model->params.halfSatPar = halfSatPar;
+  for (int i = 0; i < (int)(sizeof(lais) / sizeof(double)); ++i) {
+    for (int j = 0; j < (int)(sizeof(pars) / sizeof(double)); ++j) {
+      double analytic, simpson;
+      double ref = refLightEff(lais[i], pars[j]);
+      calcLightEffAnalytic(model, &analytic, lais[i], pars[j]);
+      calcLightEffSimpson(model, &simpson, lais[i], pars[j]);
+      maxAnalytic = fmax(maxAnalytic, fabs(analytic - ref));
+      maxSimpson = fmax(maxSimpson, fabs(simpson - ref));
+    }
+  }
+
+  // The closed form is exact up to the Ein table; Simpson's rule with six
+  // layers is much less so, but still close
+  if (maxAnalytic > 1e-10) {
+    logTest("attenuation %g halfSatPar %g: analytic differs by %g\n",
+            attenuation, halfSatPar, maxAnalytic);
+    status = 1;
+  }
+  if (maxSimpson > 1e-3) {
+    logTest("attenuation %g halfSatPar %g: Simpson differs by %g\n",
+            attenuation, halfSatPar, maxSimpson);
+    status = 1;
+  }
+
+  return status;
+}
+
+int testLightEffAccuracy(void) {
+  int status = 0;
+
+  logTest("Running testLightEffAccuracy\n");
+
+  // Smoke test sites, and the ends of the niwot parameter ranges
+  status |= checkGrid(0.5, 17.0);
+  status |= checkGrid(0.599056349736876, 26.4931410129647);
+  status |= checkGrid(0.38, 4.0);
+  status |= checkGrid(0.62, 27.0);
+
+  return status;
+}
+
+int testLightEffSwitch(void) {
+  int status = 0;
+  double lightEff, expected;
+
+  logTest("Running testLightEffSwitch\n");
+
+  model->params.attenuation = 0.5;
+  model->params.halfSatPar = 17.0;
+
+  ctx.analyticLight = 0;
+  calcLightEff(model, &lightEff, 2.0, 30.0);
+  calcLightEffSimpson(model, &expected, 2.0, 30.0);
+  status |= checkClose(lightEff, expected, 0.0, "Simpson selected");
+
+  ctx.analyticLight = 1;
+  calcLightEff(model, &lightEff, 2.0, 30.0);
+  calcLightEffAnalytic(model, &expected, 2.0, 30.0);
+  status |= checkClose(lightEff, expected, 0.0, "analytic selected");
+
+  // No leaves or no light means no light effect
+  calcLightEff(model, &lightEff, 0.0, 30.0);
+  status |= checkClose(lightEff, 0.0, 0.0, "no leaves");
+  calcLightEff(model, &lightEff, 2.0, 0.0);
+  status |= checkClose(lightEff, 0.0, 0.0, "no light");
+  ctx.analyticLight = 0;
+
+  return status;
+}
+
+int run(void) {
+  int status = 0;
+
+  initContext();
+
+  status |= testExpInt();
+  status |= testLightEffAccuracy();
+  status |= testLightEffSwitch();
+
+  return status;
+}
+
+int main(void) {
+  int status;
+
+  logTest("Starting testLightEff:run()\n");
+  status = run();
+  if (status) {
+    logTest("FAILED testLightEff with status %d\n", status);
+    exit(status);
+  }
+
+  logTest("PASSED testLightEff\n");
+  return 0;
+}
@@ -1,38 +1,45 @@
 #include "utils/tUtils.h"
 #include "sipnet/sipnet.c"
 
+// Model instance shared by the tests in this file
+static SipnetModel testModel;
+static SipnetModel *model = &testModel;
+
 void resetState(void) {
   ctx.litterPool = 1;
   ctx.anaerobic = 1;
 
-  envi.soilWater = 7.5;
+  model->envi.soilWater = 7.5;
 
-  params.soilMethaneRate = 0.05;
-  params.litterMethaneRate = 0.1;
+  model->params.soilMethaneRate = 0.05;
+  model->params.litterMethaneRate = 0.1;
 }
 
 void setupTests(void) {
   // set up dummy climate
-  climate = (ClimateNode *)malloc(sizeof(ClimateNode));
-  climate->year = 2024;
-  climate->day = 70;
-  climate->length = 0.125;
-  climate->tsoil = 20.0;
+  model->climate = (ClimateNode *)malloc(sizeof(ClimateNode));
+  model->climate->year = 2024;
+  model->climate->day = 70;
+  model->climate->length = 0.125;
+  model->climate->tsoil = 20.0;
 
   // Environment
-  envi.soilWater = 7.5;
+  model->envi.soilWater = 7.5;
   // soil CN 7.5
-  envi.soilC = 15.0;
-  envi.soilOrgN = 2.0;
+  model->envi.soilC = 15.0;
+  model->envi.soilOrgN = 2.0;
   // litter CN 5.0
-  envi.litterC = 7.5;
-  envi.litterN = 1.5;
+  model->envi.litterC = 7.5;
+  model->envi.litterN = 1.5;
+
+  model->params.soilWHC = 10.0;
+  model->params.soilRespQ10 = 3.0;
+  model->params.fAnoxia = 0.6;
+  model->params.anaerobicDecompRate = 0.5;
+  model->params.anaerobicTransExp = 2.0;
 
-  params.soilWHC = 10.0;
-  params.soilRespQ10 = 3.0;
-  params.fAnoxia = 0.6;
-  params.anaerobicDecompRate = 0.5;
-  params.anaerobicTransExp = 2.0;
+  // Climate-derived terms, e.g. soil temperature effect
+  calcStepForcing(model, model->climate);
 
   // Initialize general state
   resetState();
@@ -71,29 +78,30 @@ int checkPool(double calcPool, double expPool, const char *label) {
 
 int checkSoil(double flux, double pool) {
   int status = 0;
-  status |= checkFlux(fluxes.soilMethane, flux, "soil");
-  status |= checkPool(envi.soilC, pool, "soil");
+  status |= checkFlux(model->fluxes.soilMethane, flux, "soil");
+  status |= checkPool(model->envi.soilC, pool, "soil");
   return status;
 }
 
 int checkLitter(double flux, double pool) {
   int status = 0;
-  status |= checkFlux(fluxes.litterMethane, flux, "litter");
-  status |= checkPool(envi.litterC, pool, "litter");
+  status |= checkFlux(model->fluxes.litterMethane, flux, "litter");
+  status |= checkPool(model->envi.litterC, pool, "litter");
   return status;
 }
 
 void callCalcMethaneFlux(void) {
   // Make sure we didn't make a dumb mistake with tests points
   // That is, make sure we HAVE some methane flux
-  if (envi.soilWater / params.soilWHC <= params.fAnoxia + 0.1) {
+  if (model->envi.soilWater / model->params.soilWHC <=
+      model->params.fAnoxia + 0.1) {
     logTest("Soil water is not high enough to trigger methane production!\n");
-    logTest("SoilW %8.4f WHC %8.4f f_a %8.4f\n", envi.soilWater, params.soilWHC,
-            params.fAnoxia);
+    logTest("SoilW %8.4f WHC %8.4f f_a %8.4f\n", model->envi.soilWater,
+            model->params.soilWHC, model->params.fAnoxia);
     exit(1);
   }
 
-  calcMethaneFlux();
+  calcMethaneFlux(model);
 }
 
 int testMethane(void) {
@@ -101,18 +109,19 @@ int testMethane(void) {
   double expSoilF, expSoilC;
   double expLitterF, expLitterC;
 
-  double tempEffect = calcTempEffect(climate->tsoil);
-  double moistEfffect = calcMethaneMoistEffect(envi.soilWater, params.soilWHC);
+  double tempEffect = calcTempEffect(model, model->climate->tsoil);
+  double moistEfffect = calcMethaneMoistEffect(model, model->envi.soilWater,
+                                               model->params.soilWHC);
 
   // Standard
   logTest("  Test: standard\n");
   resetState();
   callCalcMethaneFlux();
-  updatePoolsForSoil();
+  updatePoolsForSoil(model);
   expSoilF = 0.75 * tempEffect * moistEfffect;
   expLitterF = 0.75 * tempEffect * moistEfffect;
-  expSoilC = 15 - expSoilF * climate->length;
-  expLitterC = 7.5 - expLitterF * climate->length;
+  expSoilC = 15 - expSoilF * model->climate->length;
+  expLitterC = 7.5 - expLitterF * model->climate->length;
   status |= checkSoil(expSoilF, expSoilC);
   status |= checkLitter(expLitterF, expLitterC);
 
@@ -120,13 +129,13 @@ int testMethane(void) {
   logTest("  Test: no litter pool\n");
   resetState();
   ctx.litterPool = 0;
-  envi.soilC = 20.0;
-  envi.litterC = 0.0;
+  model->envi.soilC = 20.0;
+  model->envi.litterC = 0.0;
   callCalcMethaneFlux();
-  updatePoolsForSoil();
+  updatePoolsForSoil(model);
   expSoilF = 1.0 * tempEffect * moistEfffect;
   expLitterF = 0.0;
-  expSoilC = 20.0 - expSoilF * climate->length;
+  expSoilC = 20.0 - expSoilF * model->climate->length;
   expLitterC = 0.0;
   status |= checkSoil(expSoilF, expSoilC);
   status |= checkLitter(expLitterF, expLitterC);
@@ -3,24 +3,31 @@
 #include "sipnet/nitrogen.c"
 #include "sipnet/limitations.c"
 
+// Model instance shared by the tests in this file
+static SipnetModel testModel;
+static SipnetModel *model = &testModel;
+
 /////
 // Setup and general test state management
 void initGeneralState(void) {
   // Static for all tests, just needs to be set once
-  envi.soilWater = 5.0;
-  envi.soilC = 1.5;
-  envi.litterC = 1;
+  model->envi.soilWater = 5.0;
+  model->envi.soilC = 1.5;
+  model->envi.litterC = 1;
 
-  params.minNInit = 0.0;
-  params.soilWHC = 10.0;
+  model->params.minNInit = 0.0;
+  model->params.soilWHC = 10.0;
 
   // Values from russell_2 smoke test
-  params.soilRespMoistEffect = 1.0;
-  params.baseSoilResp = 0.06;
-  params.soilRespQ10 = 2.9;
-  params.leafCN = 20.0;
-  params.woodCN = 100.0;
-  params.fineRootCN = 40.0;
+  model->params.soilRespMoistEffect = 1.0;
+  model->params.baseSoilResp = 0.06;
+  model->params.soilRespQ10 = 2.9;
+  model->params.leafCN = 20.0;
+  model->params.woodCN = 100.0;
+  model->params.fineRootCN = 40.0;
+
+  // Climate-derived terms, e.g. soil temperature effect
+  calcStepForcing(model, model->climate);
 }
 
 void resetState() {
@@ -28,29 +35,29 @@ void resetState() {
   // start of each test
 
   // Reset all the fluxes
-  fluxes = (struct FluxVars){0};
+  model->fluxes = (struct FluxVars){0};
 
   // Params
   // Volatilization
-  params.nVolatilizationFrac = 0;
+  model->params.nVolatilizationFrac = 0;
   // Leaching
-  params.nLeachingFrac = 0;
+  model->params.nLeachingFrac = 0;
   // Fixation/Uptake
-  params.nFixationFracMax = 0;
-  params.halfNFixationMax = 0;
+  model->params.nFixationFracMax = 0;
+  model->params.halfNFixationMax = 0;
 
   // Pools
   // Plant storage N and leaf-off resorption flux (new in SIP336)
-  envi.plantStorageN = 0.0;
+  model->envi.plantStorageN = 0.0;
 }
 
 void setupTests(void) {
   // set up dummy climate
-  climate = (ClimateNode *)malloc(sizeof(ClimateNode));
-  climate->year = 2024;
-  climate->day = 70;
-  climate->length = 0.125;
-  climate->tsoil = 20.0;
+  model->climate = (ClimateNode *)malloc(sizeof(ClimateNode));
+  model->climate->year = 2024;
+  model->climate->day = 70;
+  model->climate->length = 0.125;
+  model->climate->tsoil = 20.0;
 
   // Set up the context
   initContext();
@@ -80,8 +87,8 @@ int checkFlux(double calcFlux, double expFlux, const char *label) {
 // N Volatilization
 void initNVolatilizationState(double initN, double nVol) {
   resetState();
-  envi.minN = initN;
-  params.nVolatilizationFrac = nVol;
+  model->envi.minN = initN;
+  model->params.nVolatilizationFrac = nVol;
 }
 
 int testNVolatilization(void) {
@@ -94,27 +101,29 @@ int testNVolatilization(void) {
   minN = 2;
   nVolFrac = 0.1;
   initNVolatilizationState(minN, nVolFrac);
-  double tEffect = calcTempEffect(climate->tsoil);
-  double mEffect =
-      calcVolatilizationMoistEffect(envi.soilWater, params.soilWHC);
+  double tEffect = calcTempEffect(model, model->climate->tsoil);
+  double mEffect = calcVolatilizationMoistEffect(model, model->envi.soilWater,
+                                                 model->params.soilWHC);
   expNVolFlux = nVolFrac * minN * tEffect * mEffect;
-  calcNVolatilizationFlux();
-  status |= checkFlux(fluxes.nVolatilization, expNVolFlux, "N volatilization");
+  calcNVolatilizationFlux(model);
+  status |= checkFlux(model->fluxes.nVolatilization, expNVolFlux,
+                      "N volatilization");
 
   // easy proportionality test - doubling params should double output
   minN *= 2;
   expNVolFlux *= 2;
   initNVolatilizationState(minN, nVolFrac);
-  calcNVolatilizationFlux();
-  status |= checkFlux(fluxes.nVolatilization, expNVolFlux, "N volatilization");
+  calcNVolatilizationFlux(model);
+  status |= checkFlux(model->fluxes.nVolatilization, expNVolFlux,
+                      "N volatilization");
 
   // Check minN for the last
-  updateNitrogenPools();
-  double expMinN = minN - expNVolFlux * climate->length;
+  updateNitrogenPools(model);
+  double expMinN = minN - expNVolFlux * model->climate->length;
   int minStatus = 0;
-  if (!compareDoubles(envi.minN, expMinN)) {
+  if (!compareDoubles(model->envi.minN, expMinN)) {
     minStatus = 1;
-    logTest("minN pool is %8.3f, expected %8.3f\n", envi.minN, expMinN);
+    logTest("minN pool is %8.3f, expected %8.3f\n", model->envi.minN, expMinN);
   }
   status |= minStatus;
 
@@ -136,37 +145,37 @@ int testFertilization(void) {
 
   // fert event: 15 5 10
   double fertMinN = 10;
-  initEvents("events_fert.in", "events.out", 0);
-  setupEvents();
+  initEvents(model, "events_fert.in", "events.out", 0);
+  setupEvents(model);
 
-  calcNVolatilizationFlux();
-  processEvents();
-  updateNitrogenPools();
-  updatePoolsForEvents();
+  calcNVolatilizationFlux(model);
+  processEvents(model);
+  updateNitrogenPools(model);
+  updatePoolsForEvents(model);
 
   // Want to test:
   // envi: minN
   // fluxes: nVol, eventMinN
-  double tEffect = calcTempEffect(climate->tsoil);
-  double mEffect =
-      calcVolatilizationMoistEffect(envi.soilWater, params.soilWHC);
+  double tEffect = calcTempEffect(model, model->climate->tsoil);
+  double mEffect = calcVolatilizationMoistEffect(model, model->envi.soilWater,
+                                                 model->params.soilWHC);
   expNVolFlux = (nVolFrac * initN * tEffect * mEffect);
-  expEventMinNFlux = fertMinN / climate->length;
-  expMinN = initN + (expEventMinNFlux - expNVolFlux) * climate->length;
+  expEventMinNFlux = fertMinN / model->climate->length;
+  expMinN = initN + (expEventMinNFlux - expNVolFlux) * model->climate->length;
 
-  if (!compareDoubles(fluxes.nVolatilization, expNVolFlux)) {
+  if (!compareDoubles(model->fluxes.nVolatilization, expNVolFlux)) {
     status = 1;
     logTest("fluxes.nVolatilization is %8.4f, expected %8.4f\n",
-            fluxes.nVolatilization, expNVolFlux);
+            model->fluxes.nVolatilization, expNVolFlux);
   }
-  if (!compareDoubles(fluxes.eventMinN, expEventMinNFlux)) {
+  if (!compareDoubles(model->fluxes.eventMinN, expEventMinNFlux)) {
     status = 1;
-    logTest("fluxes.eventMinN is %8.4f, expected %8.4f\n", fluxes.eventMinN,
-            expEventMinNFlux);
+    logTest("fluxes.eventMinN is %8.4f, expected %8.4f\n",
+            model->fluxes.eventMinN, expEventMinNFlux);
   }
-  if (!compareDoubles(envi.minN, expMinN)) {
+  if (!compareDoubles(model->envi.minN, expMinN)) {
     status = 1;
-    logTest("envi.minN is %8.4f, expected %8.4f\n", envi.minN, expMinN);
+    logTest("envi.minN is %8.4f, expected %8.4f\n", model->envi.minN, expMinN);
   }
 
   return status;
@@ -176,8 +185,8 @@ int testFertilization(void) {
 // N Leaching
 void initNLeachingState(double initN, double nLeachFrac) {
   resetState();
-  envi.minN = initN;
-  params.nLeachingFrac = nLeachFrac;
+  model->envi.minN = initN;
+  model->params.nLeachingFrac = nLeachFrac;
 }
 
 int testNLeaching(void) {
@@ -190,37 +199,37 @@ int testNLeaching(void) {
 
   minN = 1;
   nLeachFrac = 0.5;
-  fluxes.drainage = 5;
+  model->fluxes.drainage = 5;
   initNLeachingState(minN, nLeachFrac);
-  if ((fluxes.drainage / params.soilWHC) < 1) {
-    phi = fluxes.drainage / params.soilWHC;
+  if ((model->fluxes.drainage / model->params.soilWHC) < 1) {
+    phi = model->fluxes.drainage / model->params.soilWHC;
   } else {
     phi = 1;
   }
   expNLeaching = minN * phi * nLeachFrac;
-  calcNLeachingFlux();
-  status |= checkFlux(fluxes.nLeaching, expNLeaching, "N leaching");
+  calcNLeachingFlux(model);
+  status |= checkFlux(model->fluxes.nLeaching, expNLeaching, "N leaching");
 
   minN = 1;
   nLeachFrac = 0.5;
-  fluxes.drainage = 20;
+  model->fluxes.drainage = 20;
   initNLeachingState(minN, nLeachFrac);
-  if ((fluxes.drainage / params.soilWHC) < 1) {
-    phi = fluxes.drainage / params.soilWHC;
+  if ((model->fluxes.drainage / model->params.soilWHC) < 1) {
+    phi = model->fluxes.drainage / model->params.soilWHC;
   } else {
     phi = 1;
   }
   expNLeaching = minN * phi * nLeachFrac;
-  calcNLeachingFlux();
-  status |= checkFlux(fluxes.nLeaching, expNLeaching, "N leaching");
+  calcNLeachingFlux(model);
+  status |= checkFlux(model->fluxes.nLeaching, expNLeaching, "N leaching");
 
   // Check minN for the last
-  updateNitrogenPools();
-  double expMinN = minN - (expNLeaching * climate->length);
+  updateNitrogenPools(model);
+  double expMinN = minN - (expNLeaching * model->climate->length);
   int minStatus = 0;
-  if (!compareDoubles(envi.minN, expMinN)) {
+  if (!compareDoubles(model->envi.minN, expMinN)) {
     minStatus = 1;
-    logTest("minN pool is %8.3f, expected %8.3f\n", envi.minN, expMinN);
+    logTest("minN pool is %8.3f, expected %8.3f\n", model->envi.minN, expMinN);
   }
   status |= minStatus;
 
@@ -231,36 +240,36 @@ int testNLeaching(void) {
 // N Fixation and Uptake
 void initNFixationState(double initN, double nFixFracMax, double nFixHalved) {
   resetState();
-  envi.minN = initN;
-  params.nFixationFracMax = nFixFracMax;
-  params.halfNFixationMax = nFixHalved;
+  model->envi.minN = initN;
+  model->params.nFixationFracMax = nFixFracMax;
+  model->params.halfNFixationMax = nFixHalved;
 
   // We need some demand. For convenience:
   //  leafCN = 20
   //  woodCN = 100
   //  fineRootCN = 40
-  fluxes.leafOnCreation = 0;  // too messy
-  fluxes.leafCreation = 60;  // 3 demand flux
-  fluxes.woodCreation = 500;  // 5
-  fluxes.fineRootCreation = 40;  // 1
-  fluxes.coarseRootCreation = 100;  // 1 = 10 total
+  model->fluxes.leafOnCreation = 0;  // too messy
+  model->fluxes.leafCreation = 60;  // 3 demand flux
+  model->fluxes.woodCreation = 500;  // 5
+  model->fluxes.fineRootCreation = 40;  // 1
+  model->fluxes.coarseRootCreation = 100;  // 1 = 10 total
 }
 
 int checkFinalMinN(double initMinN, double expMinN) {
   int status = 0;
-  updateNitrogenPools();
-  if (!compareDoubles(envi.minN, expMinN)) {
+  updateNitrogenPools(model);
+  if (!compareDoubles(model->envi.minN, expMinN)) {
     status = 1;
     logTest("For init minN %6.3f: minN pool is %8.3f, expected %8.3f\n",
-            initMinN, envi.minN, expMinN);
+            initMinN, model->envi.minN, expMinN);
   }
 
   return status;
 }
 
 void doNFixUpLimitCalcs(void) {
-  calcNFixationAndUptakeFluxes();
-  checkNitrogenLimitation();
+  calcNFixationAndUptakeFluxes(model);
+  checkNitrogenLimitation(model);
 }
 
 int testNFixation(void) {
@@ -285,9 +294,9 @@ int testNFixation(void) {
   expNFixation = nFixFrac * nDemand;
   expNUptake = (1 - nFixFrac) * nDemand;
   doNFixUpLimitCalcs();
-  status |= checkFlux(fluxes.nFixation, expNFixation, "N fixation");
-  status |= checkFlux(fluxes.nUptake, expNUptake, "N uptake");
-  expMinN = minN - expNUptake * climate->length;
+  status |= checkFlux(model->fluxes.nFixation, expNFixation, "N fixation");
+  status |= checkFlux(model->fluxes.nUptake, expNUptake, "N uptake");
+  expMinN = minN - expNUptake * model->climate->length;
   status |= checkFinalMinN(minN, expMinN);
 
   // Just above min N needed
@@ -301,9 +310,9 @@ int testNFixation(void) {
   expNFixation = nFixFrac * nDemand;
   expNUptake = (1 - nFixFrac) * nDemand;
   doNFixUpLimitCalcs();
-  status |= checkFlux(fluxes.nFixation, expNFixation, "N fixation");
-  status |= checkFlux(fluxes.nUptake, expNUptake, "N uptake");
-  expMinN = minN - expNUptake * climate->length;
+  status |= checkFlux(model->fluxes.nFixation, expNFixation, "N fixation");
+  status |= checkFlux(model->fluxes.nUptake, expNUptake, "N uptake");
+  expMinN = minN - expNUptake * model->climate->length;
   status |= checkFinalMinN(minN, expMinN);
 
   // Just below min N needed; limitation will hit, should be 20% reduction
@@ -318,9 +327,9 @@ int testNFixation(void) {
   expNFixation = nFixFrac * nDemand * red;
   expNUptake = (1 - nFixFrac) * nDemand * red;
   doNFixUpLimitCalcs();
-  status |= checkFlux(fluxes.nFixation, expNFixation, "N fixation");
-  status |= checkFlux(fluxes.nUptake, expNUptake, "N uptake");
-  expMinN = minN - expNUptake * climate->length;
+  status |= checkFlux(model->fluxes.nFixation, expNFixation, "N fixation");
+  status |= checkFlux(model->fluxes.nUptake, expNUptake, "N uptake");
+  expMinN = minN - expNUptake * model->climate->length;
   status |= checkFinalMinN(minN, expMinN);
 
   // Zero minN (which really shouldn't happen, but still good to test edge case)
@@ -331,8 +340,8 @@ int testNFixation(void) {
   nFixHalved = 2;
   initNFixationState(minN, nFixFracMax, nFixHalved);
   doNFixUpLimitCalcs();
-  status |= checkFlux(fluxes.nFixation, 0, "N fixation");
-  status |= checkFlux(fluxes.nUptake, 0, "N uptake");
+  status |= checkFlux(model->fluxes.nFixation, 0, "N fixation");
+  status |= checkFlux(model->fluxes.nUptake, 0, "N uptake");
   expMinN = 0;
   status |= checkFinalMinN(minN, expMinN);
 
@@ -343,17 +352,18 @@ int testNFixation(void) {
 // N Limitation effects on plant growth fluxes
 void initNLimitationState(double initN, double initLeafOnCreation) {
   resetState();
-  envi.minN = initN;
-  params.nFixationFracMax = 0;  // No N fixation for clean testing
-  params.halfNFixationMax = 0;
+  model->envi.minN = initN;
+  model->params.nFixationFracMax = 0;  // No N fixation for clean testing
+  model->params.halfNFixationMax = 0;
 
   // Demand setup (same layout as initNFixationState):
   //  leafCN = 20, woodCN = 100, fineRootCN = 40
-  fluxes.leafOnCreation = initLeafOnCreation;
-  fluxes.leafCreation = 60;  // 3 demand flux
-  fluxes.woodCreation = 500;  // 5
-  fluxes.fineRootCreation = 40;  // 1
-  fluxes.coarseRootCreation = 100;  // 1; 10 total demand without leafOnCreation
+  model->fluxes.leafOnCreation = initLeafOnCreation;
+  model->fluxes.leafCreation = 60;  // 3 demand flux
+  model->fluxes.woodCreation = 500;  // 5
+  model->fluxes.fineRootCreation = 40;  // 1
+  model->fluxes.coarseRootCreation = 100;  // 1; 10 total demand without
+                                           // leafOnCreation
 }
 
 int checkNLimitationFlux(double flux, double exp, const char *label) {
@@ -377,25 +387,25 @@ int testNLimitation(void) {
 
   doNFixUpLimitCalcs();
 
-  status |=
-      checkNLimitationFlux(fluxes.leafCreation, 60 * reduction, "leafCreation");
-  status |= checkNLimitationFlux(fluxes.woodCreation, 500 * reduction,
+  status |= checkNLimitationFlux(model->fluxes.leafCreation, 60 * reduction,
+                                 "leafCreation");
+  status |= checkNLimitationFlux(model->fluxes.woodCreation, 500 * reduction,
                                  "[50%] woodCreation");
-  status |= checkNLimitationFlux(fluxes.fineRootCreation, 40 * reduction,
+  status |= checkNLimitationFlux(model->fluxes.fineRootCreation, 40 * reduction,
                                  "[50%] fineRootCreation");
-  status |= checkNLimitationFlux(fluxes.coarseRootCreation, 100 * reduction,
-                                 "[50%] coarseRootCreation");
+  status |= checkNLimitationFlux(model->fluxes.coarseRootCreation,
+                                 100 * reduction, "[50%] coarseRootCreation");
 
   // Sufficient mineralization (nMin) prevents N limitation
   // minN=0.1, nMin=12 -> availableMinN = 0.1 + 12 * 0.125 = 1.6 > 1.25
   // -> no limitation, all creation fluxes stay at original values
   initNLimitationState(0.1, 0);
-  fluxes.nMin = 12.0;
+  model->fluxes.nMin = 12.0;
 
   doNFixUpLimitCalcs();
-  status |= checkNLimitationFlux(fluxes.leafCreation, 60,
+  status |= checkNLimitationFlux(model->fluxes.leafCreation, 60,
                                  "[boosted nMin] leafCreation");
-  status |= checkNLimitationFlux(fluxes.woodCreation, 500,
+  status |= checkNLimitationFlux(model->fluxes.woodCreation, 500,
                                  "[boosted nMin] woodCreation");
 
   // leafOnCreation is NOT reduced by soil N limitation; leaf-on draws N from
@@ -411,19 +421,20 @@ int testNLimitation(void) {
   double leafOnInit = 50.0;
   double leafOnReduction = 0.8;
   initNLimitationState(0.75, leafOnInit);
-  envi.plantStorageN = 0.5;
+  model->envi.plantStorageN = 0.5;
 
   doNFixUpLimitCalcs();
 
   // leafOnCreation is unchanged (not reduced by soil N limitation)
-  status |= checkNLimitationFlux(fluxes.leafOnCreation, leafOnInit,
+  status |= checkNLimitationFlux(model->fluxes.leafOnCreation, leafOnInit,
                                  "[leafOn] leafOnCreation");
   // other growth fluxes are still reduced by 0.4 because leaf-on's N demand
   // reduces available soil N through unclaimedStorage
-  status |= checkNLimitationFlux(fluxes.woodCreation, 500 * leafOnReduction,
+  status |= checkNLimitationFlux(model->fluxes.woodCreation,
+                                 500 * leafOnReduction,
                                  "[leafOn] woodCreation");
-  status |= checkNLimitationFlux(fluxes.leafCreation, 60 * leafOnReduction,
-                                 "[leafOn] leafCreation");
+  status |= checkNLimitationFlux(model->fluxes.leafCreation,
+                                 60 * leafOnReduction, "[leafOn] leafCreation");
 
   return status;
 }
@@ -434,21 +445,21 @@ void initOrganicNState(double initLitterN, double initSoilN) {
   resetState();
 
   // envi
-  envi.minN = 1;
-  envi.litterC = 2;
-  envi.soilC = 3;
-  envi.litterN = initLitterN;
-  envi.soilOrgN = initSoilN;
+  model->envi.minN = 1;
+  model->envi.litterC = 2;
+  model->envi.soilC = 3;
+  model->envi.litterN = initLitterN;
+  model->envi.soilOrgN = initSoilN;
 
   // fluxes; these values make all terms in flux calc equal to 1 for
   // easy comparison
-  fluxes.leafLitter = params.leafCN;
-  fluxes.woodLitter = params.woodCN;
-  fluxes.fineRootLoss = params.fineRootCN;
-  fluxes.coarseRootLoss = params.woodCN;
-  fluxes.rLitter = envi.litterC / envi.litterN;
-  fluxes.litterToSoil = envi.soilC / envi.soilOrgN;
-  fluxes.rSoil = envi.soilC / envi.soilOrgN;
+  model->fluxes.leafLitter = model->params.leafCN;
+  model->fluxes.woodLitter = model->params.woodCN;
+  model->fluxes.fineRootLoss = model->params.fineRootCN;
+  model->fluxes.coarseRootLoss = model->params.woodCN;
+  model->fluxes.rLitter = model->envi.litterC / model->envi.litterN;
+  model->fluxes.litterToSoil = model->envi.soilC / model->envi.soilOrgN;
+  model->fluxes.rSoil = model->envi.soilC / model->envi.soilOrgN;
 }
 
 int testOrganicN(void) {
@@ -464,19 +475,19 @@ int testOrganicN(void) {
   initOrganicNState(litterN, soilOrgN);
   expSoilOrgN = 2;
   expLitterN = 0;
-  calcNPoolFluxes();
+  calcNPoolFluxes(model);
 
-  status |= checkFlux(fluxes.nOrgLitter, expLitterN, "Organic litter N");
-  status |= checkFlux(fluxes.nOrgSoil, expSoilOrgN, "Organic soil N");
+  status |= checkFlux(model->fluxes.nOrgLitter, expLitterN, "Organic litter N");
+  status |= checkFlux(model->fluxes.nOrgSoil, expSoilOrgN, "Organic soil N");
 
   // Check minN for the last - it should have increased from mineralization
-  updateNitrogenPools();
-  double expMinN = minN + 2 * climate->length;
+  updateNitrogenPools(model);
+  double expMinN = minN + 2 * model->climate->length;
   int minStatus = 0;
-  if (!compareDoubles(envi.minN, expMinN)) {
+  if (!compareDoubles(model->envi.minN, expMinN)) {
     minStatus = 1;
-    logTest("minN pool is %8.3f, expected %8.3f\n", envi.minN, expMinN);
-    logTest("nMin flux is %8.3f\n", fluxes.nMin);
+    logTest("minN pool is %8.3f, expected %8.3f\n", model->envi.minN, expMinN);
+    logTest("nMin flux is %8.3f\n", model->fluxes.nMin);
   }
   status |= minStatus;
 
@@ -496,11 +507,11 @@ int testOrganicNWithResorption(void) {
   //   litterToSoil/litterCN
   //              = 1 - 0.5 + 1 - 1 - 1 = -0.5
   initOrganicNState(2.0, 3.0);
-  fluxes.leafOffNResorption = 0.5;
+  model->fluxes.leafOffNResorption = 0.5;
 
-  calcNPoolFluxes();
+  calcNPoolFluxes(model);
 
-  status |= checkFlux(fluxes.nOrgLitter, -0.5,
+  status |= checkFlux(model->fluxes.nOrgLitter, -0.5,
                       "Organic litter N with leafOffNResorption");
 
   return status;
@@ -509,15 +520,15 @@ int testOrganicNWithResorption(void) {
 int checkMinAndStorageN(const char *prefix, double expMinN,
                         double expStorageN) {
   int status = 0;
-  if (!compareDoubles(envi.minN, expMinN)) {
+  if (!compareDoubles(model->envi.minN, expMinN)) {
     status = 1;
-    logTest("[%s] minN is %8.4f, expected %8.4f\n", prefix, envi.minN,
+    logTest("[%s] minN is %8.4f, expected %8.4f\n", prefix, model->envi.minN,
             expStorageN);
   }
-  if (!compareDoubles(envi.plantStorageN, expStorageN)) {
+  if (!compareDoubles(model->envi.plantStorageN, expStorageN)) {
     status = 1;
     logTest("[%s] plantStorageN is %8.4f, expected %8.4f\n", prefix,
-            envi.plantStorageN, expStorageN);
+            model->envi.plantStorageN, expStorageN);
   }
   return status;
 }
@@ -536,19 +547,19 @@ int testNLimitationWithStorage(void) {
   // With minN=0.625 + plantStorageN=0.625: availableMinN=1.25 >= maxUptake ->
   // no limit
   initNLimitationState(0.625, 0);
-  envi.plantStorageN = 0.625;
+  model->envi.plantStorageN = 0.625;
 
   doNFixUpLimitCalcs();
-  updateNitrogenPools();
+  updateNitrogenPools(model);
 
   // All creation fluxes should be unreduced
-  status |= checkNLimitationFlux(fluxes.leafCreation, 60.0,
+  status |= checkNLimitationFlux(model->fluxes.leafCreation, 60.0,
                                  "[storageN] leafCreation");
-  status |= checkNLimitationFlux(fluxes.woodCreation, 500.0,
+  status |= checkNLimitationFlux(model->fluxes.woodCreation, 500.0,
                                  "[storageN] woodCreation");
-  status |= checkNLimitationFlux(fluxes.fineRootCreation, 40.0,
+  status |= checkNLimitationFlux(model->fluxes.fineRootCreation, 40.0,
                                  "[storageN] fineRootCreation");
-  status |= checkNLimitationFlux(fluxes.coarseRootCreation, 100.0,
+  status |= checkNLimitationFlux(model->fluxes.coarseRootCreation, 100.0,
                                  "[storageN] coarseRootCreation");
   status |= checkMinAndStorageN("storageN", 0.0, 0.0);
 
@@ -559,41 +570,45 @@ int testNLimitationWithStorage(void) {
   // calcNFixationAndUptakeFluxes() + checkLimitations() + updateNitrogenPools()
   // minN ended at -0.227273 (from copilot)
   initNLimitationState(0.1, 0);
-  envi.plantStorageN = 0.5;
-  params.nFixationFracMax = 0.5;
-  params.halfNFixationMax = 1.0;
+  model->envi.plantStorageN = 0.5;
+  model->params.nFixationFracMax = 0.5;
+  model->params.halfNFixationMax = 1.0;
 
-  double len = climate->length;
+  double len = model->climate->length;
   logTest("minN %f storageN %f fixation %f uptake %f demand %f  "
           "1-fixfrac %f\n",
-          envi.minN, envi.plantStorageN, fluxes.nFixation * len,
-          fluxes.nUptake * len, calcPlantNDemandFlux() * len,
-          1 - calcNFixationFrac());
+          model->envi.minN, model->envi.plantStorageN, model->fluxes.nFixation *
+              len,
+          model->fluxes.nUptake * len, calcPlantNDemandFlux(model) * len,
+          1 - calcNFixationFrac(model));
 
   // doNFixUpLimitCalcs();
-  calcNFixationAndUptakeFluxes();
+  calcNFixationAndUptakeFluxes(model);
 
   logTest("minN %f storageN %f fixation %f uptake %f demand %f  "
           "1-fixfrac %f\n",
-          envi.minN, envi.plantStorageN, fluxes.nFixation * len,
-          fluxes.nUptake * len, calcPlantNDemandFlux() * len,
-          1 - calcNFixationFrac());
+          model->envi.minN, model->envi.plantStorageN, model->fluxes.nFixation *
+              len,
+          model->fluxes.nUptake * len, calcPlantNDemandFlux(model) * len,
+          1 - calcNFixationFrac(model));
 
-  checkNitrogenLimitation();
+  checkNitrogenLimitation(model);
 
   logTest("minN %f storageN %f fixation %f uptake %f demand %f  "
           "1-fixfrac %f\n",
-          envi.minN, envi.plantStorageN, fluxes.nFixation * len,
-          fluxes.nUptake * len, calcPlantNDemandFlux() * len,
-          1 - calcNFixationFrac());
+          model->envi.minN, model->envi.plantStorageN, model->fluxes.nFixation *
+              len,
+          model->fluxes.nUptake * len, calcPlantNDemandFlux(model) * len,
+          1 - calcNFixationFrac(model));
 
-  updateNitrogenPools();
+  updateNitrogenPools(model);
 
   logTest("minN %f storageN %f fixation %f uptake %f demand %f  "
           "1-fixfrac %f\n",
-          envi.minN, envi.plantStorageN, fluxes.nFixation * len,
-          fluxes.nUptake * len, calcPlantNDemandFlux() * len,
-          1 - calcNFixationFrac());
+          model->envi.minN, model->envi.plantStorageN, model->fluxes.nFixation *
+              len,
+          model->fluxes.nUptake * len, calcPlantNDemandFlux(model) * len,
+          1 - calcNFixationFrac(model));
 
   status |= checkMinAndStorageN("storageN", 0.0, 0.0);
 
@@ -606,15 +621,15 @@ void initNitrogenPoolsFromStorageState(double plantStorageN) {
   resetState();
 
   // envi
-  envi.minN = 1;
-  envi.plantStorageN = plantStorageN;
+  model->envi.minN = 1;
+  model->envi.plantStorageN = plantStorageN;
 
   // fluxes; these values make all terms plant N demand =2, so demand flux = 8,
   // and demand = (8*climate->length) = 1
-  fluxes.leafCreation = params.leafCN * 2;
-  fluxes.woodCreation = params.woodCN * 2;
-  fluxes.fineRootCreation = params.fineRootCN * 2;
-  fluxes.coarseRootCreation = params.woodCN * 2;
+  model->fluxes.leafCreation = model->params.leafCN * 2;
+  model->fluxes.woodCreation = model->params.woodCN * 2;
+  model->fluxes.fineRootCreation = model->params.fineRootCN * 2;
+  model->fluxes.coarseRootCreation = model->params.woodCN * 2;
 }
 
 int testUpdateNitrogenPoolsFromStorage(void) {
@@ -627,48 +642,48 @@ int testUpdateNitrogenPoolsFromStorage(void) {
   // plantNDemand = 4, storage = 5
   // -> all uptake from storage, minN unchanged
   initNitrogenPoolsFromStorageState(2.0);
-  calcNFixationAndUptakeFluxes();
-  updateNitrogenPools();
+  calcNFixationAndUptakeFluxes(model);
+  updateNitrogenPools(model);
 
   double expStorageN = 1.0;
-  if (!compareDoubles(envi.plantStorageN, expStorageN)) {
+  if (!compareDoubles(model->envi.plantStorageN, expStorageN)) {
     status = 1;
     logTest("[full storage] plantStorageN is %8.4f, expected %8.4f\n",
-            envi.plantStorageN, expStorageN);
+            model->envi.plantStorageN, expStorageN);
   }
   double expNUptake = 0.0;
-  if (!compareDoubles(fluxes.nUptake, expNUptake)) {
+  if (!compareDoubles(model->fluxes.nUptake, expNUptake)) {
     status = 1;
-    logTest("[full storage] nUptake is %8.4f, expected %8.4f\n", fluxes.nUptake,
-            expNUptake);
+    logTest("[full storage] nUptake is %8.4f, expected %8.4f\n",
+            model->fluxes.nUptake, expNUptake);
   }
-  if (!compareDoubles(envi.minN, 1.0)) {
+  if (!compareDoubles(model->envi.minN, 1.0)) {
     status = 1;
     logTest("[full storage] minN is %8.4f, expected 1.0 (unchanged)\n",
-            envi.minN);
+            model->envi.minN);
   }
 
   // Case 2: uptake partially covered by storage, remainder from minN
   initNitrogenPoolsFromStorageState(0.5);
-  calcNFixationAndUptakeFluxes();
-  updateNitrogenPools();
+  calcNFixationAndUptakeFluxes(model);
+  updateNitrogenPools(model);
 
-  if (!compareDoubles(envi.plantStorageN, 0.0)) {
+  if (!compareDoubles(model->envi.plantStorageN, 0.0)) {
     status = 1;
     logTest("[partial storage] plantStorageN is %8.4f, expected 0.0\n",
-            envi.plantStorageN);
+            model->envi.plantStorageN);
   }
-  expNUptake = 0.5 / climate->length;
-  if (!compareDoubles(fluxes.nUptake, expNUptake)) {
+  expNUptake = 0.5 / model->climate->length;
+  if (!compareDoubles(model->fluxes.nUptake, expNUptake)) {
     status = 1;
     logTest("[partial storage] nUptake is %8.4f, expected %8.4f\n",
-            fluxes.nUptake, expNUptake);
+            model->fluxes.nUptake, expNUptake);
   }
   double expMinN = 0.5;
-  if (!compareDoubles(envi.minN, expMinN)) {
+  if (!compareDoubles(model->envi.minN, expMinN)) {
     status = 1;
-    logTest("[partial storage] minN is %8.4f, expected %8.4f\n", envi.minN,
-            expMinN);
+    logTest("[partial storage] minN is %8.4f, expected %8.4f\n",
+            model->envi.minN, expMinN);
   }
 
   return status;
@@ -686,16 +701,16 @@ int testLeafTurnoverNResorption(void) {
   //   uptake = 0 * climate->length = 0; uptakeFromStorage = min(0, 0) = 0
   //   plantStorageN_new = 0 + 2.0 * climate->length - 0 = 0.25
   resetState();
-  envi.minN = 1.0;
-  envi.plantStorageN = 0.0;
-  fluxes.leafOffNResorption = 2.0;
-  updateNitrogenPools();
+  model->envi.minN = 1.0;
+  model->envi.plantStorageN = 0.0;
+  model->fluxes.leafOffNResorption = 2.0;
+  updateNitrogenPools(model);
 
-  double expStorageN = 2.0 * climate->length;  // 0.25
-  if (!compareDoubles(envi.plantStorageN, expStorageN)) {
+  double expStorageN = 2.0 * model->climate->length;  // 0.25
+  if (!compareDoubles(model->envi.plantStorageN, expStorageN)) {
     status = 1;
     logTest("[turnover resorption] plantStorageN is %8.4f, expected %8.4f\n",
-            envi.plantStorageN, expStorageN);
+            model->envi.plantStorageN, expStorageN);
   }
 
   // Case 2: UPDATE: leafOffNResorption no longer increases available N, as it
@@ -706,21 +721,21 @@ int testLeafTurnoverNResorption(void) {
   double resorpFlux = 2.0;
   double demandFlux = 10.0;  // sum of demand fluxes set in initNLimitationState
   double availableN = minN2;  // plus unclaimed plantStorageN, which is 0 here
-  double maxUptake = demandFlux * climate->length;
+  double maxUptake = demandFlux * model->climate->length;
   double reduction = availableN / maxUptake;
 
   initNLimitationState(minN2, 0);
-  fluxes.leafOffNResorption = resorpFlux;
+  model->fluxes.leafOffNResorption = resorpFlux;
 
   doNFixUpLimitCalcs();
-  updateNitrogenPools();
+  updateNitrogenPools(model);
 
-  status |= checkNLimitationFlux(fluxes.leafCreation, 60 * reduction,
+  status |= checkNLimitationFlux(model->fluxes.leafCreation, 60 * reduction,
                                  "[turnover resorption] leafCreation");
-  status |= checkNLimitationFlux(fluxes.woodCreation, 500 * reduction,
+  status |= checkNLimitationFlux(model->fluxes.woodCreation, 500 * reduction,
                                  "[turnover resorption] woodCreation");
   status |= checkMinAndStorageN("turnover resorption", 0.0,
-                                resorpFlux * climate->length);
+                                resorpFlux * model->climate->length);
 
   return status;
 }
@@ -728,15 +743,15 @@ int testLeafTurnoverNResorption(void) {
 int checkVolAndLeachingFlux(const char *prefix, double expNVol,
                             double expNLeach) {
   int status = 0;
-  if (!compareDoubles(fluxes.nVolatilization, expNVol)) {
+  if (!compareDoubles(model->fluxes.nVolatilization, expNVol)) {
     status = 1;
     logTest("[%s] nVolatilization is %8.4f, expected %8.4f\n", prefix,
-            fluxes.nVolatilization, expNVol);
+            model->fluxes.nVolatilization, expNVol);
   }
-  if (!compareDoubles(fluxes.nLeaching, expNLeach)) {
+  if (!compareDoubles(model->fluxes.nLeaching, expNLeach)) {
     status = 1;
     logTest("[%s] nLeaching is %8.4f, expected %8.4f\n", prefix,
-            fluxes.nLeaching, expNLeach);
+            model->fluxes.nLeaching, expNLeach);
   }
   return status;
 }
@@ -752,62 +767,64 @@ int testGuardAgainstNegativeMinN(void) {
   // that case
   // Vol
   resetState();
-  fluxes.nMin = 2.0;  // 0.25 extra min N
-  envi.minN = 1.0;
-  params.fAnoxia = 0.6;
-  params.soilWHC = 10.0;
-  envi.soilWater = 8.0;  // anaerobic index = 0.5, D_water = 1
-  params.soilRespQ10 = 2.5;
-  climate->tsoil = 30.0;  // D_temp = 15.625
-  params.nVolatilizationFrac = 1.0;  // 100% can volatilize / day
+  model->fluxes.nMin = 2.0;  // 0.25 extra min N
+  model->envi.minN = 1.0;
+  model->params.fAnoxia = 0.6;
+  model->params.soilWHC = 10.0;
+  model->envi.soilWater = 8.0;  // anaerobic index = 0.5, D_water = 1
+  model->params.soilRespQ10 = 2.5;
+  model->climate->tsoil = 30.0;  // D_temp = 15.625
+  calcStepForcing(model, model->climate);
+  model->params.nVolatilizationFrac = 1.0;  // 100% can volatilize / day
   double expNVol = 1 * 1 * 1 * 15.625;
 
   // We'll set up the leaching, as we need some values for this
   // Leaching
   // nLeaching = 1.0 * 0.8 * 0.5 = 0.4
-  params.nLeachingFrac = 0.5;
-  fluxes.drainage = 0.0;
+  model->params.nLeachingFrac = 0.5;
+  model->fluxes.drainage = 0.0;
   double expNLeach = 0.0;
 
-  calcNVolatilizationFlux();
-  calcNLeachingFlux();
+  calcNVolatilizationFlux(model);
+  calcNLeachingFlux(model);
   status |= checkVolAndLeachingFlux("volatilization", expNVol, expNLeach);
   // Call the limit check should reduce nVol to 10 (enough to just exhaust nMin)
-  checkMineralNLimitation();
+  checkMineralNLimitation(model);
   expNVol *= 10.0 / expNVol;
   status |= checkVolAndLeachingFlux("volatilization", expNVol, 0.0);
   // Check that minN is zero at end
-  updateNitrogenPools();
+  updateNitrogenPools(model);
   status |= checkMinAndStorageN("volatilization", 0.0, 0.0);
 
   // Case 2: Leaching
   // We'll have a trickle of vol here, plus as much leaching as we can. Need
   // hot + wet (flooding)
   resetState();
-  envi.minN = 1.0;
+  model->envi.minN = 1.0;
   // Leaching
-  envi.soilWater = 20.0;
-  fluxes.drainage = 10.0;  // phi = 1.0
-  params.nLeachingFrac = 8.0;  // 100% leached every three hours
+  model->envi.soilWater = 20.0;
+  model->fluxes.drainage = 10.0;  // phi = 1.0
+  model->params.nLeachingFrac = 8.0;  // 100% leached every three hours
   expNLeach = 1.0 * 1.0 * 8.0;  // 8.0
   // Vol
-  params.nVolatilizationFrac = 1.0;  // 100% can volatilize / day
-  params.soilRespQ10 = 3;
-  climate->tsoil = 20.0;  // D_temp = 9
+  model->params.nVolatilizationFrac = 1.0;  // 100% can volatilize / day
+  model->params.soilRespQ10 = 3;
+  model->climate->tsoil = 20.0;  // D_temp = 9
+  calcStepForcing(model, model->climate);
   // D_water = 0.05 now
   expNVol = 1 * 1 * 0.05 * 9;  // 0.45
 
-  calcNVolatilizationFlux();
-  calcNLeachingFlux();
+  calcNVolatilizationFlux(model);
+  calcNLeachingFlux(model);
   status |= checkVolAndLeachingFlux("leaching", expNVol, expNLeach);
   // Call the limit check should reduce both to sum to 8
   double reduction = 8.0 / 8.45;
   expNVol *= reduction;
   expNLeach *= reduction;
-  checkMineralNLimitation();
+  checkMineralNLimitation(model);
   status |= checkVolAndLeachingFlux("leaching", expNVol, expNLeach);
   // Check that minN is zero at end
-  updateNitrogenPools();
+  updateNitrogenPools(model);
   status |= checkMinAndStorageN("leaching", 0.0, 0.0);
 
   return status;
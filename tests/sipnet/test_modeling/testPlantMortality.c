@@ -2,6 +2,10 @@
 #include "sipnet/events.c"
 #include "sipnet/sipnet.c"
 
+// Model instance shared by the tests in this file
+static SipnetModel testModel;
+static SipnetModel *model = &testModel;
+
 /////
 // Setup and state management
 
@@ -15,11 +19,11 @@ void resetContext(void) {
 
 void setupTests(void) {
   // Set up dummy climate
-  climate = (ClimateNode *)malloc(sizeof(ClimateNode));
-  climate->year = 2024;
-  climate->day = 70;
-  climate->time = 0.0;
-  climate->length = 0.125;
+  model->climate = (ClimateNode *)malloc(sizeof(ClimateNode));
+  model->climate->year = 2024;
+  model->climate->day = 70;
+  model->climate->time = 0.0;
+  model->climate->length = 0.125;
 
   // Set up the context
   initContext();
@@ -27,25 +31,25 @@ void setupTests(void) {
 
   // Initialize mean NPP tracker (needed by checkForMortality ->
   // resetMeanTracker)
-  meanNPP = newMeanTracker(0, MEAN_NPP_DAYS, MEAN_NPP_MAX_ENTRIES);
+  model->meanNPP = newMeanTracker(0, MEAN_NPP_DAYS, MEAN_NPP_MAX_ENTRIES);
 
   // Initialize event trackers
-  initEventTrackers();
+  initEventTrackers(model);
 }
 
 void resetEnv(void) {
-  envi.plantWoodC = 5.0;
-  envi.plantLeafC = 2.0;
-  envi.plantCAccountingDelta = 0.0;
-  envi.fineRootC = 3.0;
-  envi.coarseRootC = 4.0;
-  envi.soilC = 10.0;
-  envi.litterC = 0.0;
-  envi.soilOrgN = 0.0;
-  envi.litterN = 0.0;
-  envi.plantStorageN = 0.0;
-  eventTrackers.harvestFracRemoved = 0.0;
-  eventTrackers.harvestFracTransferred = 0.0;
+  model->envi.plantWoodC = 5.0;
+  model->envi.plantLeafC = 2.0;
+  model->envi.plantCAccountingDelta = 0.0;
+  model->envi.fineRootC = 3.0;
+  model->envi.coarseRootC = 4.0;
+  model->envi.soilC = 10.0;
+  model->envi.litterC = 0.0;
+  model->envi.soilOrgN = 0.0;
+  model->envi.litterN = 0.0;
+  model->envi.plantStorageN = 0.0;
+  model->eventTrackers.harvestFracRemoved = 0.0;
+  model->eventTrackers.harvestFracTransferred = 0.0;
 }
 
 int checkPool(double calc, double exp, const char *label) {
@@ -67,8 +71,8 @@ int testInitPlantSurvivalTrackerAlive(void) {
 
   resetContext();
   resetEnv();  // woodC=5.0, fineRootC=3.0, coarseRootC=4.0
-  initPlantSurvivalTracker();
-  if (!plantSurvivalTracker.isAlive) {
+  initPlantSurvivalTracker(model);
+  if (!model->plantSurvivalTracker.isAlive) {
     status = 1;
     logTest("Expected isAlive=1 with woodC=5 and roots=7, got 0\n");
   }
@@ -81,9 +85,9 @@ int testInitPlantSurvivalTrackerDeadNoWood(void) {
 
   resetContext();
   resetEnv();
-  envi.plantWoodC = 0.0;
-  initPlantSurvivalTracker();
-  if (plantSurvivalTracker.isAlive) {
+  model->envi.plantWoodC = 0.0;
+  initPlantSurvivalTracker(model);
+  if (model->plantSurvivalTracker.isAlive) {
     status = 1;
     logTest("Expected isAlive=0 with woodC=0, got 1\n");
   }
@@ -96,10 +100,10 @@ int testInitPlantSurvivalTrackerDeadNoRoots(void) {
 
   resetContext();
   resetEnv();
-  envi.fineRootC = 0.0;
-  envi.coarseRootC = 0.0;
-  initPlantSurvivalTracker();
-  if (plantSurvivalTracker.isAlive) {
+  model->envi.fineRootC = 0.0;
+  model->envi.coarseRootC = 0.0;
+  initPlantSurvivalTracker(model);
+  if (model->plantSurvivalTracker.isAlive) {
     status = 1;
     logTest("Expected isAlive=0 with totalRoots=0, got 1\n");
   }
@@ -112,10 +116,10 @@ int testInitPlantSurvivalTrackerDeadNegativeTotalWood(void) {
 
   resetContext();
   resetEnv();
-  envi.plantWoodC = 1.0;
-  envi.plantCAccountingDelta = -1.5;
-  initPlantSurvivalTracker();
-  if (plantSurvivalTracker.isAlive) {
+  model->envi.plantWoodC = 1.0;
+  model->envi.plantCAccountingDelta = -1.5;
+  initPlantSurvivalTracker(model);
+  if (model->plantSurvivalTracker.isAlive) {
     status = 1;
     logTest("Expected isAlive=0 with totalWoodC=-0.5, got 1\n");
   }
@@ -131,16 +135,16 @@ int testMortalityAliveStaysAlive(void) {
 
   resetContext();
   resetEnv();  // woodC=5, leafC=2, fineRoot=3, coarseRoot=4
-  plantSurvivalTracker.isAlive = 1;
+  model->plantSurvivalTracker.isAlive = 1;
 
-  checkForMortality();
+  checkForMortality(model);
 
-  if (!plantSurvivalTracker.isAlive) {
+  if (!model->plantSurvivalTracker.isAlive) {
     status = 1;
     logTest("Expected plant to remain alive\n");
   }
-  status |= checkPool(envi.plantWoodC, 5.0, "plantWoodC unchanged");
-  status |= checkPool(envi.soilC, 10.0, "soilC unchanged");
+  status |= checkPool(model->envi.plantWoodC, 5.0, "plantWoodC unchanged");
+  status |= checkPool(model->envi.soilC, 10.0, "soilC unchanged");
   return status;
 }
 
@@ -150,25 +154,26 @@ int testMortalityPlantDiesNoLitter(void) {
 
   resetContext();
   resetEnv();
-  envi.plantWoodC = 0.0;  // woodC=0 triggers death
-  plantSurvivalTracker.isAlive = 1;
+  model->envi.plantWoodC = 0.0;  // woodC=0 triggers death
+  model->plantSurvivalTracker.isAlive = 1;
 
   // All pools go to soilC when no litter pool:
   // soilC += fineRoot + coarseRoot = 3 + 4 = 7
   // soilC += woodC + leafC + delta = 0 + 2 + 0 = 2
   double expSoilC = 10.0 + 3.0 + 4.0 + 0.0 + 2.0 + 0.0;
-  checkForMortality();
+  checkForMortality(model);
 
-  if (plantSurvivalTracker.isAlive) {
+  if (model->plantSurvivalTracker.isAlive) {
     status = 1;
     logTest("Expected plant to be marked dead\n");
   }
-  status |= checkPool(envi.soilC, expSoilC, "soilC after death (no litter)");
-  status |= checkPool(envi.plantWoodC, 0.0, "plantWoodC zeroed");
-  status |= checkPool(envi.plantLeafC, 0.0, "plantLeafC zeroed");
-  status |= checkPool(envi.fineRootC, 0.0, "fineRootC zeroed");
-  status |= checkPool(envi.coarseRootC, 0.0, "coarseRootC zeroed");
-  status |= checkPool(envi.plantCAccountingDelta, 0.0,
+  status |= checkPool(model->envi.soilC, expSoilC,
+                      "soilC after death (no litter)");
+  status |= checkPool(model->envi.plantWoodC, 0.0, "plantWoodC zeroed");
+  status |= checkPool(model->envi.plantLeafC, 0.0, "plantLeafC zeroed");
+  status |= checkPool(model->envi.fineRootC, 0.0, "fineRootC zeroed");
+  status |= checkPool(model->envi.coarseRootC, 0.0, "coarseRootC zeroed");
+  status |= checkPool(model->envi.plantCAccountingDelta, 0.0,
                       "plantCAccountingDelta zeroed");
   return status;
 }
@@ -180,21 +185,22 @@ int testMortalityPlantDiesWithLitter(void) {
   resetContext();
   ctx.litterPool = 1;
   resetEnv();
-  envi.litterC = 5.0;
-  envi.plantWoodC = 0.0;  // trigger death
-  plantSurvivalTracker.isAlive = 1;
+  model->envi.litterC = 5.0;
+  model->envi.plantWoodC = 0.0;  // trigger death
+  model->plantSurvivalTracker.isAlive = 1;
 
   // Roots go to soilC: 10 + 3 + 4 = 17
   // Above-ground goes to litterC: 5 + 0 (woodC) + 2 (leafC) + 0 (delta) = 7
   double expSoilC = 10.0 + 3.0 + 4.0;
   double expLitterC = 5.0 + 0.0 + 2.0 + 0.0;
-  checkForMortality();
-
-  status |= checkPool(envi.soilC, expSoilC, "soilC after death (with litter)");
-  status |=
-      checkPool(envi.litterC, expLitterC, "litterC after death (with litter)");
-  status |= checkPool(envi.plantWoodC, 0.0, "plantWoodC zeroed");
-  status |= checkPool(envi.plantLeafC, 0.0, "plantLeafC zeroed");
+  checkForMortality(model);
+
+  status |= checkPool(model->envi.soilC, expSoilC,
+                      "soilC after death (with litter)");
+  status |= checkPool(model->envi.litterC, expLitterC,
+                      "litterC after death (with litter)");
+  status |= checkPool(model->envi.plantWoodC, 0.0, "plantWoodC zeroed");
+  status |= checkPool(model->envi.plantLeafC, 0.0, "plantLeafC zeroed");
   return status;
 }
 
@@ -209,29 +215,30 @@ int testMortalityPlantDiesWithNitrogen(void) {
   ctx.nitrogenCycle = 1;
 
   resetEnv();
-  envi.litterC = 5.0;
-  envi.soilOrgN = 2.0;
-  envi.litterN = 3.0;
-  envi.plantStorageN = 0.5;
-  params.woodCN = 100.0;
-  params.leafCN = 20.0;
-  params.fineRootCN = 40.0;
-  envi.fineRootC = 3.0;
-  envi.coarseRootC = 4.0;
-  envi.plantLeafC = 2.0;
-  envi.plantWoodC = 0.0;  // trigger death
-  plantSurvivalTracker.isAlive = 1;
+  model->envi.litterC = 5.0;
+  model->envi.soilOrgN = 2.0;
+  model->envi.litterN = 3.0;
+  model->envi.plantStorageN = 0.5;
+  model->params.woodCN = 100.0;
+  model->params.leafCN = 20.0;
+  model->params.fineRootCN = 40.0;
+  model->envi.fineRootC = 3.0;
+  model->envi.coarseRootC = 4.0;
+  model->envi.plantLeafC = 2.0;
+  model->envi.plantWoodC = 0.0;  // trigger death
+  model->plantSurvivalTracker.isAlive = 1;
 
   // soilOrgN += fineRoot/fineRootCN + coarseRoot/woodCN = 3/40 + 4/100 = 0.075
   // + 0.04 = 0.115 litterN += woodC/woodCN + leafC/leafCN + storageN = 0/100 +
   // 2/20 + 0.5 = 0.6
   double expSoilOrgN = 2.0 + 3.0 / 40.0 + 4.0 / 100.0;
   double expLitterN = 3.0 + 0.0 / 100.0 + 2.0 / 20.0 + 0.5;
-  checkForMortality();
+  checkForMortality(model);
 
-  status |= checkPool(envi.soilOrgN, expSoilOrgN, "soilOrgN after death");
-  status |= checkPool(envi.litterN, expLitterN, "litterN after death");
-  status |= checkPool(envi.plantStorageN, 0.0, "plantStorageN zeroed");
+  status |= checkPool(model->envi.soilOrgN, expSoilOrgN,
+                      "soilOrgN after death");
+  status |= checkPool(model->envi.litterN, expLitterN, "litterN after death");
+  status |= checkPool(model->envi.plantStorageN, 0.0, "plantStorageN zeroed");
   return status;
 }
 
@@ -242,20 +249,21 @@ int testMortalityDeadStaysDead(void) {
   resetContext();
   resetEnv();
   // All pools are zero: plant is dead and stays dead
-  envi.plantWoodC = 0.0;
-  envi.plantLeafC = 0.0;
-  envi.fineRootC = 0.0;
-  envi.coarseRootC = 0.0;
-  plantSurvivalTracker.isAlive = 0;
+  model->envi.plantWoodC = 0.0;
+  model->envi.plantLeafC = 0.0;
+  model->envi.fineRootC = 0.0;
+  model->envi.coarseRootC = 0.0;
+  model->plantSurvivalTracker.isAlive = 0;
 
-  checkForMortality();
+  checkForMortality(model);
 
-  if (plantSurvivalTracker.isAlive) {
+  if (model->plantSurvivalTracker.isAlive) {
     status = 1;
     logTest("Expected plant to remain dead\n");
   }
   // soilC should be unchanged (no double-counting)
-  status |= checkPool(envi.soilC, 10.0, "soilC unchanged for dead plant");
+  status |= checkPool(model->envi.soilC, 10.0,
+                      "soilC unchanged for dead plant");
   return status;
 }
 
@@ -265,19 +273,20 @@ int testMortalityReemergence(void) {
 
   resetContext();
   resetEnv();  // woodC=5, roots=7
-  plantSurvivalTracker.isAlive = 0;  // plant was previously dead
+  model->plantSurvivalTracker.isAlive = 0;  // plant was previously dead
 
   // After a planting event, woodC and roots are positive -> plant re-emerges
-  checkForMortality();
+  checkForMortality(model);
 
-  if (!plantSurvivalTracker.isAlive) {
+  if (!model->plantSurvivalTracker.isAlive) {
     status = 1;
     logTest("Expected plant to re-emerge when woodC>0 and rootC>0\n");
   }
   // Pools should be unchanged on re-emergence (no cleanup needed)
-  status |=
-      checkPool(envi.plantWoodC, 5.0, "plantWoodC unchanged on reemergence");
-  status |= checkPool(envi.soilC, 10.0, "soilC unchanged on reemergence");
+  status |= checkPool(model->envi.plantWoodC, 5.0,
+                      "plantWoodC unchanged on reemergence");
+  status |= checkPool(model->envi.soilC, 10.0,
+                      "soilC unchanged on reemergence");
   return status;
 }
 
@@ -288,20 +297,20 @@ int testMortalityWithAccountingDelta(void) {
   resetContext();
   resetEnv();
   // plantWoodC=1 but plantCAccountingDelta=-1.5 -> totalWoodC=-0.5 -> death
-  envi.plantWoodC = 1.0;
-  envi.plantCAccountingDelta = -1.5;
-  plantSurvivalTracker.isAlive = 1;
+  model->envi.plantWoodC = 1.0;
+  model->envi.plantCAccountingDelta = -1.5;
+  model->plantSurvivalTracker.isAlive = 1;
 
   // soilC starts at 10, then gets fineRootC=3, coarseRootC=4, plantWoodC=1,
   // plantLeafC=2, and plantCAccountingDelta=-1.5 for a final value of 18.5.
   double expSoilC = 10.0 + 3.0 + 4.0 + 1.0 + 2.0 - 1.5;
-  checkForMortality();
+  checkForMortality(model);
 
-  if (plantSurvivalTracker.isAlive) {
+  if (model->plantSurvivalTracker.isAlive) {
     status = 1;
     logTest("Expected plant to die when totalWoodC=-0.5\n");
   }
-  status |= checkPool(envi.soilC, expSoilC,
+  status |= checkPool(model->envi.soilC, expSoilC,
                       "soilC after death (negative totalWoodC)");
   return status;
 }
@@ -1,34 +1,38 @@
 #include "utils/tUtils.h"
 #include "sipnet/sipnet.c"
 
+// Model instance shared by the tests in this file
+static SipnetModel testModel;
+static SipnetModel *model = &testModel;
+
 void setupTests(void) {
   // Set up dummy climate
-  climate = (ClimateNode *)malloc(sizeof(ClimateNode));
-  climate->year = 2024;
-  climate->day = 70;
-  climate->length = 0.125;
-  climate->tsoil = 20.0;
-  climate->wspd = 2.0;
-  climate->vpdSoil = 0.5;
+  model->climate = (ClimateNode *)malloc(sizeof(ClimateNode));
+  model->climate->year = 2024;
+  model->climate->day = 70;
+  model->climate->length = 0.125;
+  model->climate->tsoil = 20.0;
+  model->climate->wspd = 2.0;
+  model->climate->vpdSoil = 0.5;
 
   // Set up the context
   initContext();
 
   // Params
-  params.soilWHC = 10.0;
-  params.fastFlowFrac = 0.0;
-  params.waterDrainFrac = 1.0;
-  params.waterRemoveFrac = 0.5;
-  params.frozenSoilThreshold = -30.0;
-  params.frozenSoilEff = 1.0;
-  params.wueConst = 10.0;
-  params.rdConst = 100.0;
-  params.rSoilConst1 = 3.5;
-  params.rSoilConst2 = 10.0;
+  model->params.soilWHC = 10.0;
+  model->params.fastFlowFrac = 0.0;
+  model->params.waterDrainFrac = 1.0;
+  model->params.waterRemoveFrac = 0.5;
+  model->params.frozenSoilThreshold = -30.0;
+  model->params.frozenSoilEff = 1.0;
+  model->params.wueConst = 10.0;
+  model->params.rdConst = 100.0;
+  model->params.rSoilConst1 = 3.5;
+  model->params.rSoilConst2 = 10.0;
 
   // Environment
-  envi.snow = 0;
-  envi.soilWater = 5.0;
+  model->envi.snow = 0;
+  model->envi.soilWater = 5.0;
 }
 
 int checkValue(double calc, double exp, const char *label) {
@@ -74,44 +78,49 @@ int testDrainageWithWaterDrainFrac(void) {
   double fastFlow, evaporation, drainage;
 
   double water = 12.0;  // 2 cm above soilWHC=10
-  double excessOverWHC = (water - params.soilWHC) / climate->length;
-  double clen = climate->length;
+  double excessOverWHC = (water - model->params.soilWHC) /
+                         model->climate->length;
+  double clen = model->climate->length;
   double preFrac = excessOverWHC * clen;
 
   ctx.flooding = 1;
 
   // Use snow to suppress evaporation so drainage calc is straightforward
-  envi.snow = 1.0;
+  model->envi.snow = 1.0;
 
   // waterDrainFrac = 2.0: excess drains in half a day
-  params.waterDrainFrac = 2.0;
-  calcSoilWaterFluxes(&fastFlow, &evaporation, &drainage, water, 0, 0, 0);
+  model->params.waterDrainFrac = 2.0;
+  calcSoilWaterFluxes(model, &fastFlow, &evaporation, &drainage, water, 0, 0,
+                      0);
   status |= checkValue(drainage, preFrac * 2.0, "drainage (frac=2.0)");
 
   // waterDrainFrac = 0.5: half of excess drains per day
-  params.waterDrainFrac = 0.5;
-  calcSoilWaterFluxes(&fastFlow, &evaporation, &drainage, water, 0, 0, 0);
+  model->params.waterDrainFrac = 0.5;
+  calcSoilWaterFluxes(model, &fastFlow, &evaporation, &drainage, water, 0, 0,
+                      0);
   status |= checkValue(drainage, preFrac * 0.5, "drainage (frac=0.5)");
 
   // waterDrainFrac = 0.0: no drainage (water stays above WHC, modeling
   // flooding)
-  params.waterDrainFrac = 0.0;
-  calcSoilWaterFluxes(&fastFlow, &evaporation, &drainage, water, 0, 0, 0);
+  model->params.waterDrainFrac = 0.0;
+  calcSoilWaterFluxes(model, &fastFlow, &evaporation, &drainage, water, 0, 0,
+                      0);
   status |= checkValue(drainage, 0.0, "drainage (frac=0.0)");
 
   // No drainage when water is at or below soilWHC
-  params.waterDrainFrac = 1.0;
-  calcSoilWaterFluxes(&fastFlow, &evaporation, &drainage, params.soilWHC, 0, 0,
-                      0);
+  model->params.waterDrainFrac = 1.0;
+  calcSoilWaterFluxes(model, &fastFlow, &evaporation, &drainage,
+                      model->params.soilWHC, 0, 0, 0);
   status |= checkValue(drainage, 0.0, "no drainage at WHC");
 
   // Last one - waterDrainFrac high enough to attempt to drain more than the
   // excess (should be capped)
-  params.waterDrainFrac = 20.0;
-  calcSoilWaterFluxes(&fastFlow, &evaporation, &drainage, water, 0, 0, 0);
+  model->params.waterDrainFrac = 20.0;
+  calcSoilWaterFluxes(model, &fastFlow, &evaporation, &drainage, water, 0, 0,
+                      0);
   status |= checkValue(drainage, excessOverWHC, "capped drainage");
 
-  envi.snow = 0;
+  model->envi.snow = 0;
   return status;
 }
 
@@ -141,17 +150,19 @@ int testMoistureFloodedSoil(void) {
   double vpd = 1.0;
 
   // Baseline: soilWater exactly at soilWHC
-  moisture(&transAtWHC, &dWaterAtWHC, potGrossPsn, vpd, params.soilWHC);
+  moisture(model, &transAtWHC, &dWaterAtWHC, potGrossPsn, vpd,
+           model->params.soilWHC);
 
   // Flooded: soilWater double the soilWHC; should produce same result
-  moisture(&trans, &dWater, potGrossPsn, vpd, 2 * params.soilWHC);
+  moisture(model, &trans, &dWater, potGrossPsn, vpd, 2 * model->params.soilWHC);
   status |= checkValue(trans, transAtWHC, "trans same when flooded vs. at WHC");
   status |=
       checkValue(dWater, dWaterAtWHC, "dWater same when flooded vs. at WHC");
 
   // Dry soil: soilWater well below soilWHC; trans should differ (water-limited)
   double transLow, dWaterLow;
-  moisture(&transLow, &dWaterLow, potGrossPsn, vpd, params.soilWHC * 0.2);
+  moisture(model, &transLow, &dWaterLow, potGrossPsn, vpd,
+           model->params.soilWHC * 0.2);
   if (compareDoubles(transLow, transAtWHC)) {
     status = 1;
     logTest("  trans should be lower for dry soil than at WHC\n");
@@ -0,0 +1,218 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common/logging.h"
+#include "utils/tUtils.h"
+
+// The continuous run's config, whose files are all prefixed "run"; it sets
+// QUIET, so runs whose messages are checked add --no-quiet
+#define CONFIG "restart_cont.in"
+#define CHECKPOINT "run.checkpoint"
+#define PREVIOUS_CHECKPOINT "run.checkpoint.prev"
+#define TEMP_CHECKPOINT "run.checkpoint.tmp"
+
+static int fileExists(const char *file) {
+  FILE *in = fopen(file, "rb");
+  if (in == NULL) {
+    return 0;
+  }
+  fclose(in);
+  return 1;
+}
+
+// The outputs of an auto-resumed run are those of a run that was never
+// stopped
+static int matchesContinuous(void) {
+  int status = 0;
+  status |= diffFiles("continuous.out", "run.out");
+  status |= diffFiles("continuous_events.out", "events.out");
+  return status;
+}
+
+// Periodic checkpoints don't change the output, and are rotated at midnight
+// boundaries: with 3-hour steps, every 16 steps is every other day
+static int testPeriodicCheckpoints(void) {
+  int status = 0;
+
+  logTest("Starting testPeriodicCheckpoints\n");
+
+  runShell("rm -f run.out run.checkpoint* continuous.out periodic.out *.log");
+  status |= copyFile((char *)"restart.param", (char *)"run.param");
+  status |= copyFile((char *)"restart_full.clim", (char *)"run.clim");
+  status |= copyFile((char *)"events_base.in", (char *)"events.in");
+  status |= (runModel(CONFIG, "continuous.log") != 0);
+  status |= rename("run.out", "continuous.out");
+  status |= rename("events.out", "continuous_events.out");
+
+  status |= (runModelWithArgs(CONFIG, "periodic.log",
+                              "--no-quiet --checkpoint-every 16steps") != 0);
+  status |= rename("run.out", "periodic.out");
+  status |= diffFiles("continuous.out", "periodic.out");
+  status |= !fileContains("periodic.log",
+                          "Wrote checkpoint run.checkpoint after year 2016 "
+                          "day 47");
+  status |= !fileContains("periodic.log",
+                          "Wrote checkpoint run.checkpoint after year 2016 "
+                          "day 49");
+  status |= !fileExists(CHECKPOINT);
+  status |= !fileExists(PREVIOUS_CHECKPOINT);
+  status |= fileExists(TEMP_CHECKPOINT);
+
+  // No year ends in this climate, so no checkpoints
+  runShell("rm -f run.checkpoint*");
+  status |= (runModelWithArgs(CONFIG, "years.log",
+                              "--checkpoint-every 1years") != 0);
+  status |= fileExists(CHECKPOINT);
+
+  if (status) {
+    logTest("testPeriodicCheckpoints failed\n");
+  }
+  return status;
+}
+
+// Auto-resume picks the newest complete checkpoint, seeks into the climate
+// record, and cuts the outputs back to the checkpoint before carrying on, so
+// that they come out as a continuous run's
+static int testAutoResume(void) {
+  int status = 0;
+
+  logTest("Starting testAutoResume\n");
+
+  runShell("rm -f run.out run.checkpoint* *.log");
+  status |= (runModelWithArgs(CONFIG, "periodic.log",
+                              "--no-quiet --checkpoint-every 16steps") != 0);
+  status |= copyFile((char *)CHECKPOINT, (char *)"day49.checkpoint");
+
+  // From the newest, after day 49, as if killed partway through a row of day
+  // 50
+  status |= runShell("head -c -1000 run.out > killed.out && "
+                     "mv killed.out run.out");
+  status |= (runModelWithArgs(CONFIG, "resume.log",
+                              "--no-quiet --auto-resume") != 0);
+  status |= matchesContinuous();
+  status |= !fileContains("resume.log", "Resuming from checkpoint "
+                                        "run.checkpoint at year 2016 day 50");
+
+  // A partly written checkpoint is skipped
+  status |= runShell("head -c 100 day49.checkpoint > " TEMP_CHECKPOINT);
+  status |= (runModelWithArgs(CONFIG, "partial.log",
+                              "--no-quiet --auto-resume") != 0);
+  status |= matchesContinuous();
+  status |=
+      !fileContains("partial.log", "Skipping checkpoint " TEMP_CHECKPOINT);
+
+  // As is a corrupt one, falling back to the previous, after day 47; its
+  // events on day 47 aren't applied again
+  status |= runShell("printf x | dd of=" CHECKPOINT
+                     " bs=1 seek=200 conv=notrunc 2>/dev/null");
+  status |= (runModelWithArgs(CONFIG, "previous.log",
+                              "--no-quiet --auto-resume") != 0);
+  status |= matchesContinuous();
+  status |= !fileContains("previous.log", "Resuming from checkpoint "
+                                          PREVIOUS_CHECKPOINT);
+
+  // Or a missing one
+  status |= copyFile((char *)"day49.checkpoint", (char *)PREVIOUS_CHECKPOINT);
+  runShell("rm -f " CHECKPOINT);
+  status |= (runModelWithArgs(CONFIG, "missing.log",
+                              "--no-quiet --auto-resume") != 0);
+  status |= matchesContinuous();
+  status |= !fileContains("missing.log", "Resuming from checkpoint "
+                                         PREVIOUS_CHECKPOINT);
+
+  // Outputs shorter than at the checkpoint can't be continued
+  runShell("rm -f run.out");
+  status |= (runModelWithArgs(CONFIG, "short.log", "--auto-resume") !=
+             EXIT_CODE_BAD_RESTART_PARAMETER);
+
+  // With none, the run starts from the beginning
+  runShell("rm -f run.checkpoint*");
+  status |= (runModelWithArgs(CONFIG, "none.log", "--no-quiet --auto-resume") !=
+             0);
+  status |= matchesContinuous();
+
+  if (status) {
+    logTest("testAutoResume failed\n");
+  }
+  return status;
+}
+
+// A run that had finished, with a checkpoint at the end of the climate data,
+// keeps its outputs when it is run again with --auto-resume
+static int testResumeFinishedRun(void) {
+  int status = 0;
+
+  logTest("Starting testResumeFinishedRun\n");
+
+  runShell("rm -f run.out run.checkpoint* *.log");
+  status |= (runModelWithArgs(CONFIG, "daily.log",
+                              "--checkpoint-every 8steps") != 0);
+  status |= (runModelWithArgs(CONFIG, "finished.log",
+                              "--no-quiet --checkpoint-every 8steps "
+                              "--auto-resume") != 0);
+  status |= matchesContinuous();
+  status |= !fileContains("finished.log", "is at the end of the climate "
+                                          "data; nothing left to run");
+
+  if (status) {
+    logTest("testResumeFinishedRun failed\n");
+  }
+  return status;
+}
+
+static int testBadOptions(void) {
+  int status = 0;
+
+  logTest("Starting testBadOptions\n");
+
+  status |= (runModelWithArgs(CONFIG, "bad.log", "--checkpoint-every 10") !=
+             EXIT_CODE_BAD_CLI_ARGUMENT);
+  status |= (runModelWithArgs(CONFIG, "bad.log",
+                              "--checkpoint-every 0steps") !=
+             EXIT_CODE_BAD_CLI_ARGUMENT);
+  status |= (runModelWithArgs(CONFIG, "bad.log", "--checkpoint-every 5days") !=
+             EXIT_CODE_BAD_CLI_ARGUMENT);
+  status |= (runModelWithArgs(CONFIG, "bad.log",
+                              "--auto-resume --restart-in day49.checkpoint") !=
+             EXIT_CODE_BAD_PARAMETER_VALUE);
+  // Only plain outputs written a row per step can be continued
+  status |= (runModelWithArgs(CONFIG, "bad.log",
+                              "--auto-resume --output-format binary") !=
+             EXIT_CODE_BAD_PARAMETER_VALUE);
+  status |= (runModelWithArgs(CONFIG, "bad.log",
+                              "--auto-resume --output-period day") !=
+             EXIT_CODE_BAD_PARAMETER_VALUE);
+  status |= (runModelWithArgs(CONFIG, "bad.log",
+                              "--auto-resume --debug-log run") !=
+             EXIT_CODE_BAD_PARAMETER_VALUE);
+
+  if (status) {
+    logTest("testBadOptions failed\n");
+  }
+  return status;
+}
+
+int run(void) {
+  int status = 0;
+
+  status |= testPeriodicCheckpoints();
+  status |= testAutoResume();
+  status |= testResumeFinishedRun();
+  status |= testBadOptions();
+
+  return status;
+}
+
+int main(void) {
+  int status;
+
+  logTest("Starting testCheckpointEvery\n");
+  status = run();
+  if (status) {
+    logTest("FAILED testCheckpointEvery with status %d\n", status);
+    exit(status);
+  }
+
+  logTest("PASSED testCheckpointEvery\n");
+  return 0;
+}
@@ -0,0 +1,294 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/logging.h"
+#include "utils/tUtils.h"
+
+#define BINARY_CHECKPOINT "run.restartb"
+#define TEXT_CHECKPOINT "run.restart"
+#define BINARY_MAGIC "SIPNET_RESTARTB"
+#define TEXT_MAGIC "SIPNET_RESTART\n"
+// Magic, then format version, layout signature and payload length
+#define HEADER_SIZE (16 + 3 * 4)
+
+static int prepRunFiles(const char *climFile, const char *eventFile) {
+  int status = 0;
+  status |= copyFile((char *)"restart.param", (char *)"run.param");
+  status |= copyFile((char *)climFile, (char *)"run.clim");
+  status |= copyFile((char *)eventFile, (char *)"events.in");
+  return status;
+}
+
+// Run segment 1, writing a checkpoint, with extra arguments; returns sipnet's
+// exit code
+static int runSegment1(const char *args, const char *logFile) {
+  if (prepRunFiles("restart_segment1.clim", "events_segment1.in")) {
+    logTest("Failed to prepare files for segment 1\n");
+    return 255;
+  }
+  return runModelWithArgs("restart_seg1.in", logFile, args);
+}
+
+// Run segment 2 from a checkpoint; returns sipnet's exit code
+static int runSegment2(const char *args, const char *logFile) {
+  if (prepRunFiles("restart_segment2.clim", "events_segment2.in")) {
+    logTest("Failed to prepare files for segment 2\n");
+    return 255;
+  }
+  return runModelWithArgs("restart_seg2.in", logFile, args);
+}
+
+// Read a whole file; the caller frees the result
+static unsigned char *readWholeFile(const char *file, long *size) {
+  if (getFileSize(file, size)) {
+    return NULL;
+  }
+  unsigned char *data = (unsigned char *)malloc((size_t)*size);
+  FILE *in = fopen(file, "rb");
+  if (data == NULL || in == NULL ||
+      fread(data, 1, (size_t)*size, in) != (size_t)*size) {
+    logTest("Unable to read %s\n", file);
+    free(data);
+    if (in != NULL) {
+      fclose(in);
+    }
+    return NULL;
+  }
+  fclose(in);
+  return data;
+}
+
+static int writeWholeFile(const char *file, const unsigned char *data,
+                          long size) {
+  FILE *out = fopen(file, "wb");
+  if (out == NULL || fwrite(data, 1, (size_t)size, out) != (size_t)size) {
+    logTest("Unable to write %s\n", file);
+    if (out != NULL) {
+      fclose(out);
+    }
+    return 1;
+  }
+  fclose(out);
+  return 0;
+}
+
+static int fileHasMagic(const char *file, const char *magic) {
+  long size;
+  unsigned char *data = readWholeFile(file, &size);
+  int found = (data != NULL) && (size >= (long)strlen(magic)) &&
+              (memcmp(data, magic, strlen(magic)) == 0);
+  free(data);
+  return found;
+}
+
+static uint32_t crc32(const unsigned char *data, size_t size) {
+  uint32_t crc = 0xFFFFFFFFu;
+  for (size_t ind = 0; ind < size; ++ind) {
+    crc ^= data[ind];
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+  }
+  return ~crc;
+}
+
+static uint32_t getUInt32(const unsigned char *data) {
+  return (uint32_t)data[0] | ((uint32_t)data[1] << 8) |
+         ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static void putUInt32(unsigned char *data, uint32_t value) {
+  for (int ind = 0; ind < 4; ++ind) {
+    data[ind] = (unsigned char)(value >> (8 * ind));
+  }
+}
+
+// Binary checkpoints resume to the same output as a continuous run, and as a
+// text checkpoint
+static int testBinarySegmentedEquivalence(void) {
+  int status = 0;
+
+  logTest("Starting testBinarySegmentedEquivalence\n");
+
+  runShell("rm -f run.out events.out run.restart run.restartb continuous.out "
+           "seg1.out seg2.out seg2_text.out segmented_joined.out *.log");
+
+  if (prepRunFiles("restart_full.clim", "events_base.in")) {
+    logTest("Failed to prepare files for continuous run\n");
+    return 1;
+  }
+  status |= (runModel("restart_cont.in", "continuous.log") != 0);
+  status |= rename("run.out", "continuous.out");
+
+  status |=
+      (runSegment1("--restart-out " BINARY_CHECKPOINT, "seg1.log") != 0);
+  status |= rename("run.out", "seg1.out");
+  status |= !fileHasMagic(BINARY_CHECKPOINT, BINARY_MAGIC);
+
+  status |= (runSegment2("--restart-in " BINARY_CHECKPOINT, "seg2.log") != 0);
+  status |= rename("run.out", "seg2.out");
+
+  status |= runShell("cat seg1.out > segmented_joined.out");
+  status |= runShell("tail -n +2 seg2.out >> segmented_joined.out");
+  status |= diffFiles("continuous.out", "segmented_joined.out");
+
+  // The same resume from a text checkpoint
+  status |= (runSegment1("", "seg1_text.log") != 0);
+  status |= !fileHasMagic(TEXT_CHECKPOINT, TEXT_MAGIC);
+  status |= (runSegment2("", "seg2_text.log") != 0);
+  status |= rename("run.out", "seg2_text.out");
+  status |= diffFiles("seg2.out", "seg2_text.out");
+
+  if (status) {
+    logTest("testBinarySegmentedEquivalence failed\n");
+  }
+  return status;
+}
+
+// --restart-format overrides the file extension
+static int testRestartFormatOption(void) {
+  int status = 0;
+
+  logTest("Starting testRestartFormatOption\n");
+
+  runShell("rm -f run.out events.out run.restart run.restartb *.log");
+
+  status |=
+      (runSegment1("--restart-format binary", "format_binary.log") != 0);
+  status |= !fileHasMagic(TEXT_CHECKPOINT, BINARY_MAGIC);
+  status |= (runSegment2("", "format_binary_seg2.log") != 0);
+
+  status |= (runSegment1("--restart-format text --restart-out "
+                         BINARY_CHECKPOINT, "format_text.log") != 0);
+  status |= !fileHasMagic(BINARY_CHECKPOINT, TEXT_MAGIC);
+
+  status |= (runSegment1("--restart-format xdr", "format_bad.log") !=
+             EXIT_CODE_BAD_CLI_ARGUMENT);
+
+  if (status) {
+    logTest("testRestartFormatOption failed\n");
+  }
+  return status;
+}
+
+// Any change to the file is caught by its checksum
+static int testBinaryCorruptionFails(void) {
+  int status = 0;
+  long size;
+  int rc;
+
+  logTest("Starting testBinaryCorruptionFails\n");
+
+  runShell("rm -f run.out events.out run.restartb *.log");
+  status |= (runSegment1("--restart-out " BINARY_CHECKPOINT,
+                         "corrupt_seg1.log") != 0);
+
+  unsigned char *data = readWholeFile(BINARY_CHECKPOINT, &size);
+  if (data == NULL) {
+    return 1;
+  }
+  data[size / 2] ^= 0x01;
+  status |= writeWholeFile(BINARY_CHECKPOINT, data, size);
+  rc = runSegment2("--restart-in " BINARY_CHECKPOINT, "corrupt_seg2.log");
+  status |= (rc != EXIT_CODE_BAD_RESTART_PARAMETER);
+  status |= !fileContains("corrupt_seg2.log", "checksum mismatch");
+
+  // Truncated
+  data[size / 2] ^= 0x01;
+  status |= writeWholeFile(BINARY_CHECKPOINT, data, size - 9);
+  rc = runSegment2("--restart-in " BINARY_CHECKPOINT, "truncate_seg2.log");
+  status |= (rc != EXIT_CODE_BAD_RESTART_PARAMETER);
+  free(data);
+
+  if (status) {
+    logTest("testBinaryCorruptionFails failed (rc=%d)\n", rc);
+  }
+  return status;
+}
+
+// A schema_layout value that doesn't match the build is rejected, even with a
+// valid checksum
+static int testBinarySchemaLayoutMismatchFails(void) {
+  int status = 0;
+  long size;
+  int rc;
+
+  logTest("Starting testBinarySchemaLayoutMismatchFails\n");
+
+  runShell("rm -f run.out events.out run.restartb *.log");
+  status |=
+      (runSegment1("--restart-out " BINARY_CHECKPOINT, "layout_seg1.log") != 0);
+
+  unsigned char *data = readWholeFile(BINARY_CHECKPOINT, &size);
+  if (data == NULL) {
+    return 1;
+  }
+  // Skip the model version and build info strings, the checkpoint time and
+  // the processed step count, to reach schema_layout.envi_size
+  long pos = HEADER_SIZE;
+  pos += 4 + getUInt32(data + pos);
+  pos += 4 + getUInt32(data + pos);
+  pos += 2 * 8;
+  putUInt32(data + pos, getUInt32(data + pos) + 8);
+  putUInt32(data + size - 4, crc32(data, (size_t)size - 4));
+  status |= writeWholeFile(BINARY_CHECKPOINT, data, size);
+  free(data);
+
+  rc = runSegment2("--restart-in " BINARY_CHECKPOINT, "layout_seg2.log");
+  status |= (rc != EXIT_CODE_BAD_RESTART_PARAMETER);
+  status |= !fileContains("layout_seg2.log", "schema_layout.envi_size");
+
+  if (status) {
+    logTest("testBinarySchemaLayoutMismatchFails failed (rc=%d)\n", rc);
+  }
+  return status;
+}
+
+// Model flags must match the checkpoint's, as for text checkpoints
+static int testBinaryFlagMismatchFails(void) {
+  int status = 0;
+  int rc;
+
+  logTest("Starting testBinaryFlagMismatchFails\n");
+
+  runShell("rm -f run.out events.out run.restartb *.log");
+  status |=
+      (runSegment1("--restart-out " BINARY_CHECKPOINT, "flags_seg1.log") != 0);
+  rc = runSegment2("--restart-in " BINARY_CHECKPOINT " --no-snow",
+                   "flags_seg2.log");
+  status |= (rc != EXIT_CODE_BAD_RESTART_PARAMETER);
+  status |= !fileContains("flags_seg2.log", "Restart context mismatch");
+
+  if (status) {
+    logTest("testBinaryFlagMismatchFails failed (rc=%d)\n", rc);
+  }
+  return status;
+}
+
+int run(void) {
+  int status = 0;
+
+  status |= testBinarySegmentedEquivalence();
+  status |= testRestartFormatOption();
+  status |= testBinaryCorruptionFails();
+  status |= testBinarySchemaLayoutMismatchFails();
+  status |= testBinaryFlagMismatchFails();
+
+  return status;
+}
+
+int main(void) {
+  int status;
+
+  logTest("Starting testRestartBinary\n");
+  status = run();
+  if (status) {
+    logTest("FAILED testRestartBinary with status %d\n", status);
+    exit(status);
+  }
+
+  logTest("PASSED testRestartBinary\n");
+  return 0;
+}
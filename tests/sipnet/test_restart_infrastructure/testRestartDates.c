@@ -0,0 +1,178 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common/logging.h"
+#include "utils/tUtils.h"
+
+// The continuous run's config, whose files are all prefixed "run"; it sets
+// QUIET, so runs whose messages are checked add --no-quiet
+#define CONFIG "restart_cont.in"
+#define DATED_ARGS "--no-quiet --restart-out state_%Y_%j.restart"
+
+static int fileExists(const char *file) {
+  FILE *in = fopen(file, "rb");
+  if (in == NULL) {
+    return 0;
+  }
+  fclose(in);
+  return 1;
+}
+
+static int prepContinuousRun(void) {
+  int status = 0;
+  status |= copyFile((char *)"restart.param", (char *)"run.param");
+  status |= copyFile((char *)"restart_full.clim", (char *)"run.clim");
+  status |= copyFile((char *)"events_base.in", (char *)"events.in");
+  return status;
+}
+
+// Resume from checkpoint with restart_seg2.in over the climate from firstDay
+// on, and check the output against continuous.out's rows from there
+static int resumeMatchesContinuous(const char *checkpoint, int firstDay,
+                                   const char *eventsFile) {
+  char cmd[256];
+  int status = 0;
+
+  status |= copyFile((char *)checkpoint, (char *)"run.restart");
+  status |= copyFile((char *)eventsFile, (char *)"events.in");
+  snprintf(cmd, sizeof(cmd), "awk '$2 >= %d' restart_full.clim > run.clim",
+           firstDay);
+  status |= runShell(cmd);
+  snprintf(cmd, sizeof(cmd),
+           "awk 'NR == 1 || $2 >= %d' continuous.out > expected.out",
+           firstDay);
+  status |= runShell(cmd);
+  status |= (runModel("restart_seg2.in", "resume.log") != 0);
+  status |= diffFiles("expected.out", "run.out");
+
+  status |= prepContinuousRun();
+  if (status) {
+    logTest("Resuming from %s not as expected\n", checkpoint);
+  }
+  return status;
+}
+
+// One pass writes a checkpoint after each date, without changing the output;
+// resuming from each gives the continuous run's output from there on
+static int testDatedCheckpoints(void) {
+  int status = 0;
+
+  logTest("Starting testDatedCheckpoints\n");
+
+  runShell("rm -f run.out state_* continuous.out dated.out *.log");
+  status |= prepContinuousRun();
+  status |= (runModel(CONFIG, "continuous.log") != 0);
+  status |= rename("run.out", "continuous.out");
+
+  status |= (runModelWithArgs(CONFIG, "dated.log",
+                              DATED_ARGS " --restart-dates 2016-47,2016-49") !=
+             0);
+  status |= rename("run.out", "dated.out");
+  status |= diffFiles("continuous.out", "dated.out");
+  status |= !fileContains("dated.log", "Wrote restart checkpoint "
+                                       "state_2016_047.restart after year "
+                                       "2016 day 47");
+  status |= !fileExists("state_2016_047.restart");
+  status |= !fileExists("state_2016_049.restart");
+  status |= fileExists("state_2016_050.restart");
+
+  status |= resumeMatchesContinuous("state_2016_047.restart", 48,
+                                    "events_segment2.in");
+  status |= runShell("> no_events.in");
+  status |= resumeMatchesContinuous("state_2016_049.restart", 50,
+                                    "no_events.in");
+
+  if (status) {
+    logTest("testDatedCheckpoints failed\n");
+  }
+  return status;
+}
+
+// Dates the run can't write a checkpoint after are warned about; without
+// dates, a template is filled in with the end of the run, and any other path
+// is used as it is
+static int testMissedDates(void) {
+  int status = 0;
+
+  logTest("Starting testMissedDates\n");
+
+  runShell("rm -f state_* *.log");
+  status |= (runModelWithArgs(CONFIG, "missed.log",
+                              DATED_ARGS
+                              " --restart-dates 2016-10,2016-48,2016-60") != 0);
+  status |= !fileContains("missed.log", "No restart checkpoint after year "
+                                        "2016 day 10");
+  status |= !fileContains("missed.log", "No restart checkpoint after year "
+                                        "2016 day 60: it is after the end");
+  status |= !fileExists("state_2016_048.restart");
+
+  runShell("rm -f state_*");
+  status |= (runModelWithArgs(CONFIG, "end.log", DATED_ARGS) != 0);
+  status |= !fileExists("state_2016_050.restart");
+
+  // Other paths are not templates, so a '%' in them is kept
+  runShell("rm -f state_*");
+  status |= (runModelWithArgs(CONFIG, "plain.log",
+                              "--restart-out state_100%.restart") != 0);
+  status |= !fileExists("state_100%.restart");
+
+  if (status) {
+    logTest("testMissedDates failed\n");
+  }
+  return status;
+}
+
+static int testBadOptions(void) {
+  int status = 0;
+
+  logTest("Starting testBadOptions\n");
+
+  status |= (runModelWithArgs(CONFIG, "bad.log",
+                              DATED_ARGS " --restart-dates 2016-49,2016-47") !=
+             EXIT_CODE_BAD_CLI_ARGUMENT);
+  status |= (runModelWithArgs(CONFIG, "bad.log",
+                              DATED_ARGS " --restart-dates 2016-400") !=
+             EXIT_CODE_BAD_CLI_ARGUMENT);
+  status |= (runModelWithArgs(CONFIG, "bad.log",
+                              DATED_ARGS " --restart-dates 2016-47,") !=
+             EXIT_CODE_BAD_CLI_ARGUMENT);
+  // More than one date needs a template, which has to be valid
+  status |= (runModelWithArgs(CONFIG, "bad.log",
+                              "--restart-out state.restart "
+                              "--restart-dates 2016-47,2016-49") !=
+             EXIT_CODE_BAD_PARAMETER_VALUE);
+  status |= (runModelWithArgs(CONFIG, "bad.log",
+                              "--restart-out state_%Y_%d.restart") !=
+             EXIT_CODE_BAD_PARAMETER_VALUE);
+  status |= (runModelWithArgs(CONFIG, "bad.log", "--restart-dates 2016-47") !=
+             EXIT_CODE_BAD_PARAMETER_VALUE);
+
+  if (status) {
+    logTest("testBadOptions failed\n");
+  }
+  return status;
+}
+
+int run(void) {
+  int status = 0;
+
+  status |= testDatedCheckpoints();
+  status |= testMissedDates();
+  status |= testBadOptions();
+
+  return status;
+}
+
+int main(void) {
+  int status;
+
+  logTest("Starting testRestartDates\n");
+  status = run();
+  if (status) {
+    logTest("FAILED testRestartDates with status %d\n", status);
+    exit(status);
+  }
+
+  logTest("PASSED testRestartDates\n");
+  return 0;
+}
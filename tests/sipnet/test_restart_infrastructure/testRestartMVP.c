@@ -439,6 +439,46 @@ static int testMissingFinalNewlineCheckpointSucceeds(void) {
   return status;
 }
 
+// Checkpoints written before flags.analyticLight was added don't have it; they
+// load as written with the flag off, and are rejected with it on
+static int testMissingAnalyticLightFlagDefaultsOff(void) {
+  int status = 0;
+  int stepStatus = 0;
+  int rc;
+
+  logTest("Starting testMissingAnalyticLightFlagDefaultsOff\n");
+
+  runShell("rm -f run.out events.out run.restart *.log");
+
+  stepStatus = prepRunFiles("restart_segment1.clim", "events_segment1.in");
+  if (stepStatus) {
+    logTest("Failed to prepare files for analytic-light test segment 1\n");
+    return stepStatus;
+  }
+  status |= (runModel("restart_seg1.in", "no_light_flag_seg1.log") != 0);
+  status |= !fileContains(CHECKPOINT_FILE, "flags.analyticLight 0");
+  status |= runShell("sed -i '/^flags.analyticLight /d' " CHECKPOINT_FILE);
+  status |= fileContains(CHECKPOINT_FILE, "flags.analyticLight");
+
+  stepStatus = prepRunFiles("restart_segment2.clim", "events_segment2.in");
+  if (stepStatus) {
+    logTest("Failed to prepare files for analytic-light test segment 2\n");
+    return status | stepStatus;
+  }
+
+  rc = runModel("restart_seg2.in", "no_light_flag_seg2.log");
+  status |= (rc != 0);
+  rc = runModelWithArgs("restart_seg2.in", "no_light_flag_on.log",
+                        "--analytic-light");
+  status |= (rc != EXIT_CODE_BAD_RESTART_PARAMETER);
+
+  if (status) {
+    logTest("testMissingAnalyticLightFlagDefaultsOff failed (rc=%d)\n", rc);
+  }
+
+  return status;
+}
+
 static int testModelVersionMismatchFails(void) {
   int status = 0;
   int stepStatus = 0;
@@ -727,6 +767,7 @@ int run(void) {
   status |= testCheckpointFarFromMidnightWarnsAndWrites();
   status |= testRestartNotNearMidnightWarns();
   status |= testMissingFinalNewlineCheckpointSucceeds();
+  status |= testMissingAnalyticLightFlagDefaultsOff();
   status |= testModelVersionMismatchFails();
   status |= testSchemaLayoutMismatchFails();
   status |= testMeanValueIndexOutOfRangeFails();
@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/context.h"
+#include "common/logging.h"
+#include "common/modelParams.h"
+#include "sipnet/events.h"
+#include "sipnet/restart.h"
+#include "sipnet/sipnet.h"
+#include "utils/tUtils.h"
+
+#define BINARY_MAGIC "SIPNET_RESTARTB"
+#define TEXT_MAGIC "SIPNET_RESTART\n"
+
+// Run segment 1, take a checkpoint in memory, then resume segment 2 from it
+// in the same process, writing both segments' output to outFile; checks the
+// checkpoint starts with magic
+static int runSegmentsInMemory(const char *outFile, const char *magic) {
+  ModelParams *modelParams;
+  int status = 0;
+
+  SipnetModel *model = newSipnetModel();
+  initModel(model, &modelParams, "run.param", "restart_segment1.clim");
+  initEvents(model, "events_base.in", "events_memory.out", 1);
+  FILE *out = openMainOutput(model, outFile);
+
+  runModelOutput(model, out, NULL, NULL, 1);
+
+  size_t size = restartWriteCheckpointToBuffer(model, NULL, 0);
+  char *checkpoint = (char *)malloc(size);
+  if (size < strlen(magic) || checkpoint == NULL) {
+    logTest("Unexpected checkpoint size %zu\n", size);
+    free(checkpoint);
+    return 1;
+  }
+  // Too small a buffer is left alone
+  checkpoint[0] = '\0';
+  status |= (restartWriteCheckpointToBuffer(model, checkpoint, size - 1) !=
+             size);
+  status |= (checkpoint[0] != '\0');
+  status |= (restartWriteCheckpointToBuffer(model, checkpoint, size) != size);
+  status |= (memcmp(checkpoint, magic, strlen(magic)) != 0);
+
+  ClimateData *segment2 = readClimate("restart_segment2.clim");
+  setModelClimate(model, segment2);
+  resumeModelOutput(model, checkpoint, size, out, NULL, NULL, 0);
+  fclose(out);
+
+  free(checkpoint);
+  cleanupModel(model);
+  deleteSipnetModel(model);
+  deleteModelParams(modelParams);
+  freeClimate(segment2);
+
+  if (status) {
+    logTest("Checkpoint in memory not as expected for %s\n", outFile);
+  }
+  return status;
+}
+
+// Resuming in the same process from an in-memory checkpoint, binary or text,
+// gives the same output as a continuous run; the event list still holds
+// segment 1's events, which the resumed run skips
+static int testMemorySegmentedEquivalence(void) {
+  int status = 0;
+
+  logTest("Starting testMemorySegmentedEquivalence\n");
+
+  runShell("rm -f run.out events.out continuous.out memory_binary.out "
+           "memory_text.out events_memory.out *.log");
+
+  status |= copyFile((char *)"restart.param", (char *)"run.param");
+  status |= copyFile((char *)"restart_full.clim", (char *)"run.clim");
+  status |= copyFile((char *)"events_base.in", (char *)"events.in");
+  status |= (runModel("restart_cont.in", "continuous.log") != 0);
+  status |= rename("run.out", "continuous.out");
+  if (status) {
+    logTest("Continuous run failed\n");
+    return status;
+  }
+
+  initContext();
+  updateIntContext("events", 1, CTX_TEST);
+
+  status |= runSegmentsInMemory("memory_binary.out", BINARY_MAGIC);
+  status |= diffFiles("continuous.out", "memory_binary.out");
+  status |= diffFiles("events.out", "events_memory.out");
+
+  updateCharContext("restartFormat", RESTART_FORMAT_TEXT, CTX_TEST);
+  status |= runSegmentsInMemory("memory_text.out", TEXT_MAGIC);
+  status |= diffFiles("continuous.out", "memory_text.out");
+
+  if (status) {
+    logTest("testMemorySegmentedEquivalence failed\n");
+  }
+  return status;
+}
+
+int run(void) {
+  int status = 0;
+
+  status |= testMemorySegmentedEquivalence();
+
+  return status;
+}
+
+int main(void) {
+  int status;
+
+  logTest("Starting testRestartMemory\n");
+  status = run();
+  if (status) {
+    logTest("FAILED testRestartMemory with status %d\n", status);
+    exit(status);
+  }
+
+  logTest("PASSED testRestartMemory\n");
+  return 0;
+}
@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common/logging.h"
+#include "utils/tUtils.h"
+
+// The continuous run's config, whose files are all prefixed "run"
+#define CONFIG "restart_cont.in"
+#define SCENARIO_ARGS "--scenarios scenarios.txt --scenario-date 2016-47"
+
+// Rows of a continuous run's output selected by an awk condition on the day,
+// with its header
+static int continuousRows(const char *continuousFile, const char *condition,
+                          const char *expectedFile) {
+  char cmd[256];
+  snprintf(cmd, sizeof(cmd), "awk 'NR == 1 || $2 %s' %s > %s", condition,
+           continuousFile, expectedFile);
+  return runShell(cmd);
+}
+
+static int prepRunFiles(const char *eventFile) {
+  int status = 0;
+  status |= copyFile((char *)"restart.param", (char *)"run.param");
+  status |= copyFile((char *)"restart_full.clim", (char *)"run.clim");
+  status |= copyFile((char *)eventFile, (char *)"events.in");
+  return status;
+}
+
+// The baseline runs through the branch date, and each branch on from there
+// gives what a continuous run with its events gives. Both branches list the
+// baseline's day 47 events, which they skip; only "irrigated" adds day 49's.
+static int testScenariosMatchContinuousRuns(void) {
+  int status = 0;
+
+  logTest("Starting testScenariosMatchContinuousRuns\n");
+
+  runShell("rm -f run.out events.out irrigated.* dry.* scenarios.txt *.log");
+  status |= prepRunFiles("events_base.in");
+  status |= (runModel(CONFIG, "irrigated_cont.log") != 0);
+  status |= rename("run.out", "irrigated_cont.out");
+  status |= prepRunFiles("events_segment1.in");
+  status |= (runModel(CONFIG, "dry_cont.log") != 0);
+  status |= rename("run.out", "dry_cont.out");
+  if (status) {
+    logTest("Continuous runs failed\n");
+    return status;
+  }
+
+  status |= runShell("printf 'irrigated\\n! no irrigation\\ndry\\n' > "
+                     "scenarios.txt");
+  status |= copyFile((char *)"events_base.in", (char *)"irrigated.events.in");
+  status |= copyFile((char *)"events_segment1.in", (char *)"dry.events.in");
+  status |= (runModelWithArgs(CONFIG, "scenarios.log",
+                              SCENARIO_ARGS " --threads 2") != 0);
+
+  status |= continuousRows("irrigated_cont.out", "<= 47", "expected.out");
+  status |= diffFiles("expected.out", "run.out");
+  status |= continuousRows("irrigated_cont.out", ">= 48", "expected.out");
+  status |= diffFiles("expected.out", "irrigated.out");
+  status |= continuousRows("dry_cont.out", ">= 48", "expected.out");
+  status |= diffFiles("expected.out", "dry.out");
+
+  if (status) {
+    logTest("testScenariosMatchContinuousRuns failed\n");
+  }
+  return status;
+}
+
+static int testBadOptions(void) {
+  int status = 0;
+
+  logTest("Starting testBadOptions\n");
+
+  status |= (runModelWithArgs(CONFIG, "bad.log", "--scenarios scenarios.txt") !=
+             EXIT_CODE_BAD_PARAMETER_VALUE);
+  status |= (runModelWithArgs(CONFIG, "bad.log", "--scenario-date 2016-47") !=
+             EXIT_CODE_BAD_PARAMETER_VALUE);
+  status |= (runModelWithArgs(CONFIG, "bad.log",
+                              "--scenarios scenarios.txt "
+                              "--scenario-date 2016-47,2016-48") !=
+             EXIT_CODE_BAD_CLI_ARGUMENT);
+  // The branch date has to leave steps for the baseline and the branches
+  status |= (runModelWithArgs(CONFIG, "bad.log",
+                              "--scenarios scenarios.txt "
+                              "--scenario-date 2016-50") !=
+             EXIT_CODE_BAD_PARAMETER_VALUE);
+  status |= (runModelWithArgs(CONFIG, "bad.log",
+                              SCENARIO_ARGS " --restart-out run.restart") !=
+             EXIT_CODE_BAD_PARAMETER_VALUE);
+
+  if (status) {
+    logTest("testBadOptions failed\n");
+  }
+  return status;
+}
+
+int run(void) {
+  int status = 0;
+
+  status |= testScenariosMatchContinuousRuns();
+  status |= testBadOptions();
+
+  return status;
+}
+
+int main(void) {
+  int status;
+
+  logTest("Starting testScenarios\n");
+  status = run();
+  if (status) {
+    logTest("FAILED testScenarios with status %d\n", status);
+    exit(status);
+  }
+
+  logTest("PASSED testScenarios\n");
+  return 0;
+}
@@ -0,0 +1,194 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "common/logging.h"
+#include "sipnet/asyncOutput.h"
+#include "utils/tUtils.h"
+
+#define SMOKE_DIR "../../../tests/smoke/russell_1"
+#define TEST_WORK_DIR "async_work"
+
+// Enough rows of 50 values to go around the ring several times
+#define NUM_ROWS 20000
+#define ROW_VALUES 50
+
+// Rows seen by the test writer, in the order written
+typedef struct RowLog {
+  int numRows;
+  int outOfOrder;
+  int badValues;
+} RowLog;
+
+// Checks each row carries its row number and the values that follow it; slow
+// now and then, so the ring fills up and the model side has to wait
+static void logRow(void *target, const void *layout, const double *values,
+                   int numValues) {
+  RowLog *log = (RowLog *)target;
+  int row = (int)values[0];
+
+  if (row != log->numRows) {
+    log->outOfOrder = 1;
+  }
+  if (numValues != ROW_VALUES || layout != (const void *)log) {
+    log->badValues = 1;
+  }
+  for (int ind = 1; ind < numValues; ++ind) {
+    if (values[ind] != row + ind * 0.5) {
+      log->badValues = 1;
+    }
+  }
+  if (row % 2000 == 0) {
+    usleep(2000);
+  }
+  log->numRows++;
+}
+
+int testRing(void) {
+  int status = 0;
+  RowLog log = {0, 0, 0};
+  AsyncOutput *async;
+
+  logTest("Starting testRing\n");
+
+  async = newAsyncOutput();
+  for (int row = 0; row < NUM_ROWS; ++row) {
+    double *values = reserveAsyncRow(async, logRow, &log, &log, ROW_VALUES);
+    values[0] = row;
+    for (int ind = 1; ind < ROW_VALUES; ++ind) {
+      values[ind] = row + ind * 0.5;
+    }
+    if (row == NUM_ROWS / 2) {
+      drainAsyncOutput(async);
+      if (log.numRows != row + 1) {
+        logTest("after draining, %d of %d rows written\n", log.numRows,
+                row + 1);
+        status = 1;
+      }
+    }
+  }
+  deleteAsyncOutput(async);
+
+  if (log.numRows != NUM_ROWS) {
+    logTest("%d of %d rows written\n", log.numRows, NUM_ROWS);
+    status = 1;
+  }
+  if (log.outOfOrder) {
+    logTest("rows written out of order\n");
+    status = 1;
+  }
+  if (log.badValues) {
+    logTest("rows written with the wrong values\n");
+    status = 1;
+  }
+
+  return status;
+}
+
+// Run sipnet in the work dir; returns its exit status
+static int runSipnet(const char *args) {
+  char cmd[1024];
+
+  snprintf(cmd, sizeof(cmd),
+           "cd %s && ../../../../sipnet -i sipnet.in %s > async_test.log 2>&1",
+           TEST_WORK_DIR, args);
+  return runShell(cmd);
+}
+
+// Every output file is the same whether written on the model thread or the
+// writer thread
+int testSameFiles(void) {
+  int status = 0;
+  const char *files[] = {"sipnet.out",         "sipnet.single",
+                         "debug_envi.log",     "debug_fluxes.log",
+                         "debug_trackers.log", "member1.out",
+                         "member1.single",     "member2.out",
+                         "member2.single",     "member3.out",
+                         "member3.single"};
+  const int numFiles = sizeof(files) / sizeof(files[0]);
+
+  logTest("Starting testSameFiles\n");
+
+  status |= runSipnet("--do-single-outputs --debug-log debug");
+  status |= runSipnet(
+      "--ensemble members.txt --lanes 2 --threads 1 --do-single-outputs");
+  status |= runShell("cd " TEST_WORK_DIR " && mkdir sync && "
+                     "mv sipnet.out sipnet.single debug_*.log member?.out "
+                     "member?.single sync");
+  status |= runSipnet("--do-single-outputs --debug-log debug --async-output");
+  status |= runSipnet(
+      "--ensemble members.txt --lanes 2 --threads 1 --do-single-outputs "
+      "--async-output");
+  if (status != 0) {
+    logTest("sipnet runs failed with status %d\n", status);
+    return status;
+  }
+
+  for (int ind = 0; ind < numFiles; ++ind) {
+    char asyncFile[256], syncFile[256];
+    snprintf(asyncFile, sizeof(asyncFile), "%s/%s", TEST_WORK_DIR, files[ind]);
+    snprintf(syncFile, sizeof(syncFile), "%s/sync/%s", TEST_WORK_DIR,
+             files[ind]);
+    if (diffFiles(asyncFile, syncFile)) {
+      logTest("%s differs with asynchronous output\n", files[ind]);
+      status = 1;
+    }
+  }
+
+  return status;
+}
+
+int init(void) {
+  int status = 0;
+
+  status |= runShell("rm -rf " TEST_WORK_DIR " && mkdir " TEST_WORK_DIR);
+  status |= runShell("cp " SMOKE_DIR "/sipnet.in " SMOKE_DIR
+                     "/sipnet.clim " SMOKE_DIR "/sipnet.param " SMOKE_DIR
+                     "/events.in " TEST_WORK_DIR);
+  status |= runShell("cd " TEST_WORK_DIR " && for ind in 1 2 3; do "
+                     "cp sipnet.param member$ind.param; "
+                     "echo member$ind >> members.txt; done");
+
+  if (status != 0) {
+    logTest("Could not initialize test directory %s, failed with status %d\n",
+            TEST_WORK_DIR, status);
+  }
+
+  return status;
+}
+
+int cleanup(void) {
+  int status = runShell("rm -rf " TEST_WORK_DIR);
+
+  if (status != 0) {
+    logTest("Could not clean up test directory %s, failed with status %d\n",
+            TEST_WORK_DIR, status);
+  }
+
+  return status;
+}
+
+int main(void) {
+  int status = 0;
+
+  logTest("Starting testAsyncOutput\n");
+
+  status |= testRing();
+  status |= init();
+
+  // If init() fails, don't run the tests; but, we'll want to attempt cleanup()
+  if (!status) {
+    status |= testSameFiles();
+  }
+
+  status |= cleanup();
+
+  if (status) {
+    logTest("FAILED testAsyncOutput with status %d\n", status);
+    exit(status);
+  }
+
+  logTest("PASSED testAsyncOutput\n");
+  return 0;
+}
@@ -0,0 +1,290 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/logging.h"
+#include "sipnet/netcdfOutput.h"
+#include "utils/tUtils.h"
+#include "tools/sipnet_binary.c"
+
+#define SMOKE_DIR "../../../tests/smoke/russell_1"
+#define TEST_WORK_DIR "binary_work"
+#define MAX_LINE_LEN 4096
+
+// Run sipnet in the work dir; returns its exit status
+static int runSipnet(const char *args) {
+  char cmd[1024];
+
+  snprintf(cmd, sizeof(cmd),
+           "cd %s && ../../../../sipnet -i sipnet.in %s > binary_test.log "
+           "2>&1",
+           TEST_WORK_DIR, args);
+  return runShell(cmd);
+}
+
+// Text output is rounded to the number of decimals printed; the binary value
+// must round to the same text
+static int checkTextValue(const char *token, double value) {
+  const char *point = strchr(token, '.');
+  int decimals = (point == NULL) ? 0 : (int)strlen(point + 1);
+  double tol = 0.5 * pow(10, -decimals) * (1 + 1e-9) + 1e-12;
+
+  return fabs(atof(token) - value) <= tol;
+}
+
+// The binary file has the same columns as the text output, and each value
+// matches to the precision printed
+int testBinaryMatchesText(void) {
+  int status = 0;
+  char line[MAX_LINE_LEN];
+  long row = -1;
+  SipnetBinaryFile *file;
+  FILE *text;
+
+  logTest("Starting testBinaryMatchesText\n");
+
+  status |= runSipnet("");
+  status |= runShell("cd " TEST_WORK_DIR " && mv sipnet.out text.out");
+  status |= runSipnet("--output-format binary --no-print-header");
+  if (status != 0) {
+    logTest("sipnet runs failed with status %d\n", status);
+    return status;
+  }
+
+  file = readSipnetBinary(TEST_WORK_DIR "/sipnet.out");
+  text = fopen(TEST_WORK_DIR "/text.out", "r");
+  if (file == NULL || text == NULL) {
+    logTest("could not read output files\n");
+    return 1;
+  }
+
+  while (fgets(line, sizeof(line), text) != NULL) {
+    int col = 0;
+    for (char *token = strtok(line, " \n"); token != NULL;
+         token = strtok(NULL, " \n"), ++col) {
+      if (col >= file->numColumns) {
+        logTest("text output has more than %d columns\n", file->numColumns);
+        status = 1;
+        break;
+      }
+      if (row < 0) {
+        if (strcmp(token, file->columns[col].name) != 0) {
+          logTest("column %d is %s in text, %s in binary\n", col, token,
+                  file->columns[col].name);
+          status = 1;
+        }
+      } else if (!checkTextValue(token, file->values[col][row])) {
+        logTest("row %ld %s is %s in text, %.17g in binary\n", row,
+                file->columns[col].name, token, file->values[col][row]);
+        status = 1;
+      }
+    }
+    if (col != file->numColumns) {
+      logTest("row %ld has %d columns, binary has %d\n", row, col,
+              file->numColumns);
+      status = 1;
+    }
+    if (status) {
+      break;
+    }
+    ++row;
+  }
+  if (row != file->numRows) {
+    logTest("text output has %ld rows, binary has %ld\n", row, file->numRows);
+    status = 1;
+  }
+
+  fclose(text);
+  freeSipnetBinary(file);
+  return status;
+}
+
+// binary32 holds the float64 values rounded to float32
+int testBinary32(void) {
+  int status = 0;
+  SipnetBinaryFile *file64, *file32;
+
+  logTest("Starting testBinary32\n");
+
+  status |= runShell("cd " TEST_WORK_DIR " && mv sipnet.out binary64.out");
+  status |= runSipnet("--output-format binary32");
+  if (status != 0) {
+    logTest("sipnet run failed with status %d\n", status);
+    return status;
+  }
+
+  file64 = readSipnetBinary(TEST_WORK_DIR "/binary64.out");
+  file32 = readSipnetBinary(TEST_WORK_DIR "/sipnet.out");
+  if (file64 == NULL || file32 == NULL) {
+    logTest("could not read output files\n");
+    return 1;
+  }
+  if (file32->numColumns != file64->numColumns ||
+      file32->numRows != file64->numRows) {
+    logTest("binary32 output has a different shape from binary output\n");
+    return 1;
+  }
+  for (int col = 0; col < file32->numColumns && !status; ++col) {
+    int expectedType = (col < 2) ? SIPNET_BINARY_INT32 : SIPNET_BINARY_FLOAT32;
+    if (file32->columns[col].type != expectedType) {
+      logTest("column %s has type %d\n", file32->columns[col].name,
+              file32->columns[col].type);
+      status = 1;
+    }
+    for (long row = 0; row < file32->numRows; ++row) {
+      if (file32->values[col][row] != (float)file64->values[col][row]) {
+        logTest("row %ld %s is %.9g in binary32, %.17g in binary\n", row,
+                file32->columns[col].name, file32->values[col][row],
+                file64->values[col][row]);
+        status = 1;
+        break;
+      }
+    }
+  }
+
+  freeSipnetBinary(file64);
+  freeSipnetBinary(file32);
+  return status;
+}
+
+// Ensemble members running in lanes write the same binary file as a single
+// run
+int testBinaryEnsemble(void) {
+  int status = 0;
+
+  logTest("Starting testBinaryEnsemble\n");
+
+  status = runSipnet("--output-format binary --ensemble members.txt "
+                     "--lanes 2 --threads 1");
+  if (status != 0) {
+    logTest("ensemble sipnet run failed with status %d\n", status);
+    return status;
+  }
+  for (int ind = 1; ind <= 3; ++ind) {
+    char memberFile[256];
+    snprintf(memberFile, sizeof(memberFile), "%s/member%d.out", TEST_WORK_DIR,
+             ind);
+    if (diffFiles(memberFile, TEST_WORK_DIR "/binary64.out")) {
+      logTest("%s differs from single run output\n", memberFile);
+      status = 1;
+    }
+  }
+
+  return status;
+}
+
+int testBadFormat(void) {
+  logTest("Starting testBadFormat\n");
+
+  int rc = runSipnet("--output-format csv");
+  if (rc != EXIT_CODE_BAD_CLI_ARGUMENT) {
+    logTest("expected exit code %d for --output-format csv, got %d\n",
+            EXIT_CODE_BAD_CLI_ARGUMENT, rc);
+    return 1;
+  }
+
+  return 0;
+}
+
+// NetCDF output is written to sipnet.nc by builds with NetCDF support, and is
+// a parameter error in the others
+int testNetcdfFormat(void) {
+  const char hdf5Signature[] = "\x89HDF\r\n\x1a\n";
+  char signature[sizeof(hdf5Signature) - 1];
+  FILE *f;
+  int rc;
+
+  logTest("Starting testNetcdfFormat\n");
+
+  rc = runSipnet("--output-format netcdf --netcdf-deflate 10");
+  if (rc != EXIT_CODE_BAD_CLI_ARGUMENT) {
+    logTest("expected exit code %d for --netcdf-deflate 10, got %d\n",
+            EXIT_CODE_BAD_CLI_ARGUMENT, rc);
+    return 1;
+  }
+
+  runShell("rm -f " TEST_WORK_DIR "/sipnet.nc");
+  rc = runSipnet("--output-format netcdf --netcdf-deflate 4");
+  f = fopen(TEST_WORK_DIR "/sipnet.nc", "rb");
+  if (!hasNetcdfOutput()) {
+    if (rc != EXIT_CODE_BAD_PARAMETER_VALUE || f != NULL) {
+      logTest("expected exit code %d and no sipnet.nc without NetCDF support, "
+              "got %d\n",
+              EXIT_CODE_BAD_PARAMETER_VALUE, rc);
+      return 1;
+    }
+    return 0;
+  }
+
+  if (rc != 0 || f == NULL) {
+    logTest("netcdf run failed with status %d\n", rc);
+    return 1;
+  }
+  // NetCDF-4 files are HDF5 files
+  if (fread(signature, 1, sizeof(signature), f) != sizeof(signature) ||
+      memcmp(signature, hdf5Signature, sizeof(signature)) != 0) {
+    logTest("sipnet.nc is not a NetCDF-4 file\n");
+    fclose(f);
+    return 1;
+  }
+  fclose(f);
+
+  return 0;
+}
+
+int init(void) {
+  int status = 0;
+
+  status |= runShell("rm -rf " TEST_WORK_DIR " && mkdir " TEST_WORK_DIR);
+  status |= runShell("cp " SMOKE_DIR "/sipnet.in " SMOKE_DIR
+                     "/sipnet.clim " SMOKE_DIR "/sipnet.param " SMOKE_DIR
+                     "/events.in " TEST_WORK_DIR);
+  status |= runShell("cd " TEST_WORK_DIR " && for ind in 1 2 3; do "
+                     "cp sipnet.param member$ind.param; "
+                     "echo member$ind >> members.txt; done");
+
+  if (status != 0) {
+    logTest("Could not initialize test directory %s, failed with status %d\n",
+            TEST_WORK_DIR, status);
+  }
+
+  return status;
+}
+
+int cleanup(void) {
+  int status = runShell("rm -rf " TEST_WORK_DIR);
+
+  if (status != 0) {
+    logTest("Could not clean up test directory %s, failed with status %d\n",
+            TEST_WORK_DIR, status);
+  }
+
+  return status;
+}
+
+int main(void) {
+  int status = 0;
+
+  logTest("Starting testBinaryOutput\n");
+
+  status |= init();
+
+  // If init() fails, don't run the tests; but, we'll want to attempt cleanup()
+  if (!status) {
+    status |= testBinaryMatchesText();
+    status |= testBinary32();
+    status |= testBinaryEnsemble();
+    status |= testBadFormat();
+    status |= testNetcdfFormat();
+  }
+
+  status |= cleanup();
+
+  if (status) {
+    logTest("FAILED testBinaryOutput with status %d\n", status);
+    exit(status);
+  }
+
+  logTest("PASSED testBinaryOutput\n");
+  return 0;
+}
@@ -5,21 +5,21 @@
 #include "common/logging.h"
 #include "sipnet/sipnet.c"
 
+// Model instance shared by the tests in this file
+static SipnetModel testModel;
+static SipnetModel *model = &testModel;
+
 int runTest(const char *climFile) {
-  int numRecords = 0;
-  int expNumRecords = 10;
+  long numRecords;
+  long expNumRecords = 10;
 
   // Read climate data from file
-  readClimData(climFile);
+  readClimData(model, climFile);
 
   // Make sure correct number of records are read
-  ClimateNode *curr = firstClimate;
-  while (curr != NULL) {
-    ++numRecords;
-    curr = curr->nextClim;
-  }
+  numRecords = model->climateData->numSteps;
 
-  freeClimateList();
+  freeClimateList(model);
 
   return numRecords != expNumRecords;
 }
@@ -0,0 +1,194 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "common/context.h"
+#include "common/logging.h"
+#include "sipnet/climate_cache.h"
+#include "sipnet/sipnet.h"
+#include "utils/tUtils.h"
+
+#define CLIM_FILE "cache_test.clim"
+#define CACHE_FILE CLIM_FILE "b"
+
+static int cacheExists(void) { return access(CACHE_FILE, F_OK) == 0; }
+
+// Compare every variable of every step
+static int compareClimate(const ClimateData *exp, const ClimateData *act) {
+  if (exp->numSteps != act->numSteps) {
+    logTest("numSteps mismatch: expected %ld, got %ld\n", exp->numSteps,
+            act->numSteps);
+    return 1;
+  }
+  for (long step = 0; step < exp->numSteps; ++step) {
+    if ((exp->year[step] != act->year[step]) ||
+        (exp->day[step] != act->day[step]) ||
+        (exp->time[step] != act->time[step]) ||
+        (exp->length[step] != act->length[step]) ||
+        (exp->tair[step] != act->tair[step]) ||
+        (exp->tsoil[step] != act->tsoil[step]) ||
+        (exp->par[step] != act->par[step]) ||
+        (exp->precip[step] != act->precip[step]) ||
+        (exp->vpd[step] != act->vpd[step]) ||
+        (exp->vpdSoil[step] != act->vpdSoil[step]) ||
+        (exp->vPress[step] != act->vPress[step]) ||
+        (exp->wspd[step] != act->wspd[step]) ||
+        (exp->gdd[step] != act->gdd[step])) {
+      logTest("climate mismatch at step %ld\n", step);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int testCacheRoundTrip(void) {
+  int status = 0;
+
+  logTest("Starting testCacheRoundTrip\n");
+
+  // First read parses the text file and writes the cache
+  ClimateData *parsed = readClimate(CLIM_FILE);
+  if ((parsed->mapping != NULL) || !cacheExists()) {
+    logTest("first read should parse the text file and write %s\n",
+            CACHE_FILE);
+    status = 1;
+  }
+
+  // Second read maps the cache, with identical contents
+  ClimateData *cached = readClimate(CLIM_FILE);
+  if (cached->mapping == NULL) {
+    logTest("second read should use %s\n", CACHE_FILE);
+    status = 1;
+  }
+  status |= compareClimate(parsed, cached);
+
+  freeClimate(cached);
+  freeClimate(parsed);
+
+  return status;
+}
+
+int testStaleCache(void) {
+  int status = 0;
+  struct timeval times[2] = {{1000000000, 0}, {1000000000, 0}};
+
+  logTest("Starting testStaleCache\n");
+
+  ClimateData *parsed = readClimate(CLIM_FILE);
+
+  // A new modification time on the text file invalidates the cache...
+  utimes(CLIM_FILE, times);
+  ClimateData *reread = readClimate(CLIM_FILE);
+  if (reread->mapping != NULL) {
+    logTest("cache should be stale after the climate file changed\n");
+    status = 1;
+  }
+  status |= compareClimate(parsed, reread);
+  freeClimate(reread);
+
+  // ...which is then rewritten and reused
+  reread = readClimate(CLIM_FILE);
+  if (reread->mapping == NULL) {
+    logTest("cache should be rewritten after it went stale\n");
+    status = 1;
+  }
+  freeClimate(reread);
+
+  // The gdd array depends on the gdd flag, so changing it invalidates the
+  // cache too
+  updateIntContext("gdd", 0, CTX_TEST);
+  reread = readClimate(CLIM_FILE);
+  if (reread->mapping != NULL) {
+    logTest("cache should be stale after the gdd flag changed\n");
+    status = 1;
+  }
+  freeClimate(reread);
+  updateIntContext("gdd", 1, CTX_TEST);
+
+  freeClimate(parsed);
+
+  return status;
+}
+
+// A climate file rewritten while it is parsed isn't cached under the new
+// file's key
+int testSourceChangedDuringParse(void) {
+  int status = 0;
+  struct stat before;
+  struct timeval times[2] = {{1100000000, 0}, {1100000000, 0}};
+
+  logTest("Starting testSourceChangedDuringParse\n");
+
+  unlink(CACHE_FILE);
+  stat(CLIM_FILE, &before);
+  ClimateData *parsed = readClimate(CLIM_FILE);
+  unlink(CACHE_FILE);
+  // As if the file were rewritten between the stat and the end of the parse
+  utimes(CLIM_FILE, times);
+  writeClimateCache(CLIM_FILE, &before, parsed);
+  if (cacheExists()) {
+    logTest("no cache should be written when the climate file changed while "
+            "it was read\n");
+    status = 1;
+  }
+  freeClimate(parsed);
+
+  return status;
+}
+
+int testCacheDisabled(void) {
+  int status = 0;
+
+  logTest("Starting testCacheDisabled\n");
+
+  updateIntContext("climateCache", 0, CTX_TEST);
+  unlink(CACHE_FILE);
+  ClimateData *parsed = readClimate(CLIM_FILE);
+  if ((parsed->mapping != NULL) || cacheExists()) {
+    logTest("no cache should be read or written with --no-climate-cache\n");
+    status = 1;
+  }
+  freeClimate(parsed);
+  updateIntContext("climateCache", 1, CTX_TEST);
+
+  return status;
+}
+
+int run(void) {
+  int status = 0;
+
+  initContext();
+  status |= copyFile("standard.clim", CLIM_FILE);
+  unlink(CACHE_FILE);
+  if (status) {
+    logTest("Could not set up %s\n", CLIM_FILE);
+    return status;
+  }
+
+  status |= testCacheRoundTrip();
+  status |= testStaleCache();
+  status |= testSourceChangedDuringParse();
+  status |= testCacheDisabled();
+
+  unlink(CLIM_FILE);
+  unlink(CACHE_FILE);
+
+  return status;
+}
+
+int main(void) {
+  int status;
+
+  logTest("Starting testClimateCache\n");
+
+  status = run();
+  if (status) {
+    logTest("FAILED testClimateCache with status %d\n", status);
+    exit(status);
+  }
+
+  logTest("PASSED testClimateCache\n");
+  return 0;
+}
@@ -0,0 +1,165 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "common/context.h"
+#include "common/logging.h"
+#include "common/modelParams.h"
+#include "sipnet/sipnet.h"
+#include "utils/tUtils.h"
+
+#define CLIM_FILE "standard.clim"
+#define RUN_DIR "../../../tests/smoke/russell_1"
+#define RUN_PARAM_FILE RUN_DIR "/sipnet.param"
+#define RUN_CLIM_FILE RUN_DIR "/sipnet.clim"
+
+// Compare step ind of a chunk to step expInd of the fully read climate
+static int sameStep(const ClimateData *exp, long expInd, const ClimateData *act,
+                    long ind) {
+  return (exp->year[expInd] == act->year[ind]) &&
+         (exp->day[expInd] == act->day[ind]) &&
+         (exp->time[expInd] == act->time[ind]) &&
+         (exp->length[expInd] == act->length[ind]) &&
+         (exp->tair[expInd] == act->tair[ind]) &&
+         (exp->tsoil[expInd] == act->tsoil[ind]) &&
+         (exp->par[expInd] == act->par[ind]) &&
+         (exp->precip[expInd] == act->precip[ind]) &&
+         (exp->vpd[expInd] == act->vpd[ind]) &&
+         (exp->vpdSoil[expInd] == act->vpdSoil[ind]) &&
+         (exp->vPress[expInd] == act->vPress[ind]) &&
+         (exp->wspd[expInd] == act->wspd[ind]) &&
+         (exp->gdd[expInd] == act->gdd[ind]);
+}
+
+// Stream the climate file in chunks of chunkSteps and check the chunks against
+// the fully read file
+static int checkChunks(const ClimateData *full, long chunkSteps) {
+  int status = 0;
+  long numSteps = 0;
+  ClimateData *chunk;
+
+  ClimateStream *stream = openClimateStream(CLIM_FILE, chunkSteps);
+  while ((chunk = nextClimateChunk(stream)) != NULL) {
+    // Only the last chunk may be short
+    if ((chunk->numSteps < chunkSteps) &&
+        (numSteps + chunk->numSteps != full->numSteps)) {
+      logTest("chunk size %ld: short chunk of %ld steps before the end\n",
+              chunkSteps, chunk->numSteps);
+      status = 1;
+    }
+    for (long ind = 0; ind < chunk->numSteps; ++ind) {
+      if (!sameStep(full, numSteps + ind, chunk, ind)) {
+        logTest("chunk size %ld: step %ld differs\n", chunkSteps,
+                numSteps + ind);
+        status = 1;
+      }
+    }
+    numSteps += chunk->numSteps;
+  }
+  closeClimateStream(stream);
+
+  if (numSteps != full->numSteps) {
+    logTest("chunk size %ld: streamed %ld steps, expected %ld\n", chunkSteps,
+            numSteps, full->numSteps);
+    status = 1;
+  }
+
+  return status;
+}
+
+int testStreamChunks(void) {
+  int status = 0;
+  // standard.clim has 10 steps; cover short last chunks, an exact multiple,
+  // and a single chunk
+  long chunkSizes[] = {1, 3, 5, 10, 64};
+
+  logTest("Starting testStreamChunks\n");
+
+  ClimateData *full = readClimate(CLIM_FILE);
+  for (int ind = 0; ind < (int)(sizeof(chunkSizes) / sizeof(long)); ++ind) {
+    status |= checkChunks(full, chunkSizes[ind]);
+  }
+  freeClimate(full);
+
+  return status;
+}
+
+int testCloseStreamEarly(void) {
+  logTest("Starting testCloseStreamEarly\n");
+
+  // The parser is left waiting for a free chunk; closing must still stop it
+  ClimateStream *stream = openClimateStream(CLIM_FILE, 1);
+  nextClimateChunk(stream);
+  closeClimateStream(stream);
+
+  return 0;
+}
+
+int testStreamedRun(void) {
+  int status = 0;
+  ModelParams *paramsA, *paramsB;
+
+  logTest("Starting testStreamedRun\n");
+
+  SipnetModel *modelA = newSipnetModel();
+  initModel(modelA, &paramsA, RUN_PARAM_FILE, RUN_CLIM_FILE);
+  runModelOutput(modelA, NULL, NULL, NULL, 0);
+
+  // Stream the same climate in small chunks, so the run crosses many chunk
+  // boundaries
+  updateIntContext("climateStream", 1, CTX_TEST);
+  SipnetModel *modelB = newSipnetModel();
+  initModel(modelB, &paramsB, RUN_PARAM_FILE, RUN_CLIM_FILE);
+  closeClimateStream(modelB->climateStream);
+  modelB->climateStream = openClimateStream(RUN_CLIM_FILE, 100);
+  modelB->climateData = nextClimateChunk(modelB->climateStream);
+  runModelOutput(modelB, NULL, NULL, NULL, 0);
+  updateIntContext("climateStream", 0, CTX_TEST);
+
+  if ((modelA->trackers.totGpp == 0.0) ||
+      (memcmp(&modelA->envi, &modelB->envi, sizeof(Envi)) != 0) ||
+      (memcmp(&modelA->trackers, &modelB->trackers, sizeof(Trackers)) != 0)) {
+    logTest("streamed run differs from run over fully read climate\n");
+    status = 1;
+  }
+  if (modelB->climateStep != modelA->climateStep) {
+    logTest("streamed run stopped at step %ld, expected %ld\n",
+            modelB->climateStep, modelA->climateStep);
+    status = 1;
+  }
+
+  cleanupModel(modelA);
+  deleteSipnetModel(modelA);
+  deleteModelParams(paramsA);
+  cleanupModel(modelB);
+  deleteSipnetModel(modelB);
+  deleteModelParams(paramsB);
+
+  return status;
+}
+
+int run(void) {
+  int status = 0;
+
+  initContext();
+  updateIntContext("events", 0, CTX_TEST);
+
+  status |= testStreamChunks();
+  status |= testCloseStreamEarly();
+  status |= testStreamedRun();
+
+  freeContextMetadata();
+
+  return status;
+}
+
+int main(void) {
+  int status;
+
+  status = run();
+  if (status) {
+    logTest("FAILED testClimateStream with status %d\n", status);
+    exit(status);
+  }
+
+  logTest("PASSED testClimateStream\n");
+}
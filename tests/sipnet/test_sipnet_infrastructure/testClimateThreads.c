@@ -0,0 +1,209 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "utils/tUtils.h"
+#include "utils/exitHandler.c"
+#include "common/context.h"
+#include "common/logging.h"
+#include "sipnet/sipnet.h"
+
+#define TEST_CLIM_FILE "threads_test.clim"
+#define SERIAL_LOG "threads_serial.log"
+#define PARALLEL_LOG "threads_parallel.log"
+#define MAX_TEST_THREADS 12
+
+// Compare every variable of every step
+static int sameClimate(const ClimateData *exp, const ClimateData *act) {
+  if (exp->numSteps != act->numSteps) {
+    logTest("numSteps mismatch: expected %ld, got %ld\n", exp->numSteps,
+            act->numSteps);
+    return 0;
+  }
+  for (long step = 0; step < exp->numSteps; ++step) {
+    if ((exp->year[step] != act->year[step]) ||
+        (exp->day[step] != act->day[step]) ||
+        (exp->time[step] != act->time[step]) ||
+        (exp->length[step] != act->length[step]) ||
+        (exp->tair[step] != act->tair[step]) ||
+        (exp->tsoil[step] != act->tsoil[step]) ||
+        (exp->par[step] != act->par[step]) ||
+        (exp->precip[step] != act->precip[step]) ||
+        (exp->vpd[step] != act->vpd[step]) ||
+        (exp->vpdSoil[step] != act->vpdSoil[step]) ||
+        (exp->vPress[step] != act->vPress[step]) ||
+        (exp->wspd[step] != act->wspd[step]) ||
+        (exp->gdd[step] != act->gdd[step])) {
+      logTest("climate mismatch at step %ld\n", step);
+      return 0;
+    }
+  }
+  return 1;
+}
+
+// Read climFile serially and with 2 to MAX_TEST_THREADS threads, and check
+// that all reads agree
+static int checkThreadCounts(const char *climFile) {
+  int status = 0;
+
+  updateIntContext("climateThreads", 1, CTX_TEST);
+  ClimateData *serial = readClimate(climFile);
+  for (int numThreads = 2; numThreads <= MAX_TEST_THREADS; ++numThreads) {
+    updateIntContext("climateThreads", numThreads, CTX_TEST);
+    ClimateData *parallel = readClimate(climFile);
+    if (!sameClimate(serial, parallel)) {
+      logTest("%s differs when read on %d threads\n", climFile, numThreads);
+      status = 1;
+    }
+    freeClimate(parallel);
+  }
+  freeClimate(serial);
+  updateIntContext("climateThreads", 1, CTX_TEST);
+
+  return status;
+}
+
+// Read climFile on numThreads threads, expecting it to fail, with all output
+// going to logFile; return 1 if it didn't fail as expected
+static int readBadClimate(const char *climFile, int numThreads,
+                          const char *logFile) {
+  int jmp_rval;
+  int savedStdout;
+  int fd;
+
+  updateIntContext("climateThreads", numThreads, CTX_TEST);
+
+  fflush(stdout);
+  savedStdout = dup(STDOUT_FILENO);
+  fd = open(logFile, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  dup2(fd, STDOUT_FILENO);
+  close(fd);
+
+  really_exit = 0;
+  should_exit = 1;
+  exit_result = 1;
+  expected_code = EXIT_CODE_INPUT_FILE_ERROR;
+  jmp_rval = setjmp(jump_env);
+  if (!jmp_rval) {
+    readClimate(climFile);
+  }
+  test_assert(jmp_rval == 1);
+  really_exit = 1;
+
+  fflush(stdout);
+  dup2(savedStdout, STDOUT_FILENO);
+  close(savedStdout);
+  updateIntContext("climateThreads", 1, CTX_TEST);
+
+  return !exit_result;
+}
+
+// Check that a bad climate file gives the same error on any number of threads
+static int checkSameError(const char *climFile) {
+  int status = 0;
+
+  status |= readBadClimate(climFile, 1, SERIAL_LOG);
+  for (int numThreads = 2; numThreads <= MAX_TEST_THREADS; ++numThreads) {
+    status |= readBadClimate(climFile, numThreads, PARALLEL_LOG);
+    if (diffFiles(SERIAL_LOG, PARALLEL_LOG)) {
+      logTest("error for %s differs when read on %d threads\n", climFile,
+              numThreads);
+      status = 1;
+    }
+  }
+
+  return status;
+}
+
+// Write standard.clim to TEST_CLIM_FILE, with line lineNum (counting from 1)
+// replaced by replacement
+static void writeModifiedClim(int lineNum, const char *replacement) {
+  char line[1024];
+  int currLine = 0;
+  FILE *in = fopen("standard.clim", "r");
+  FILE *out = fopen(TEST_CLIM_FILE, "w");
+
+  while (fgets(line, sizeof(line), in) != NULL) {
+    ++currLine;
+    if (currLine == lineNum) {
+      fputs(replacement, out);
+    } else {
+      fputs(line, out);
+    }
+  }
+  fclose(in);
+  fclose(out);
+}
+
+int testSameData(void) {
+  int status = 0;
+
+  logTest("Starting testSameData\n");
+
+  status |= checkThreadCounts("standard.clim");
+  status |= checkThreadCounts("with_loc.clim");
+
+  // Blank lines leave gaps between pieces that have to be closed up
+  writeModifiedClim(3, "\n \n\n");
+  status |= checkThreadCounts(TEST_CLIM_FILE);
+  writeModifiedClim(10, "2000 1 0.00 0.25 1 1 1 1 1 1 1 1");  // no newline
+  status |= checkThreadCounts(TEST_CLIM_FILE);
+
+  return status;
+}
+
+int testSameErrors(void) {
+  int status = 0;
+  // Lines cut off before the year, before the day, and in the data
+  const char *badLines[] = {"x\n", "2000\n", "2000 1 0.00 0.25 1 1\n",
+                            "2000 1 0.00 0.25 1 1 1 1 1 1 1 1 1\n"};
+
+  logTest("Starting testSameErrors\n");
+
+  status |= checkSameError("multi_loc.clim");
+  status |= checkSameError("missing_one.clim");
+
+  // Put each bad line on each line of the file, so that with some number of
+  // threads it is the first line of a piece
+  for (int bad = 0; bad < (int)(sizeof(badLines) / sizeof(char *)); ++bad) {
+    for (int lineNum = 2; lineNum <= 10; ++lineNum) {
+      writeModifiedClim(lineNum, badLines[bad]);
+      status |= checkSameError(TEST_CLIM_FILE);
+    }
+  }
+
+  return status;
+}
+
+int run(void) {
+  int status = 0;
+
+  really_exit = 1;
+  initContext();
+  updateIntContext("climateCache", 0, CTX_TEST);
+
+  status |= testSameData();
+  status |= testSameErrors();
+
+  unlink(TEST_CLIM_FILE);
+  unlink(SERIAL_LOG);
+  unlink(PARALLEL_LOG);
+
+  return status;
+}
+
+int main(void) {
+  int status;
+
+  logTest("Starting testClimateThreads\n");
+
+  status = run();
+  if (status) {
+    logTest("FAILED testClimateThreads with status %d\n", status);
+    exit(status);
+  }
+
+  logTest("PASSED testClimateThreads\n");
+  return 0;
+}
@@ -0,0 +1,170 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common/context.h"
+#include "common/exitCodes.h"
+#include "common/logging.h"
+#include "sipnet/compressedOutput.h"
+#include "utils/tUtils.h"
+
+#define SMOKE_DIR "../../../tests/smoke/russell_1"
+#define TEST_WORK_DIR "compressed_output_work"
+
+// Run sipnet in the work dir; returns its exit status
+static int runSipnet(const char *args) {
+  char cmd[1024];
+
+  snprintf(cmd, sizeof(cmd),
+           "cd %s && ../../../../sipnet -i sipnet.in %s > compressed.log 2>&1",
+           TEST_WORK_DIR, args);
+  return runShell(cmd);
+}
+
+// Compare a compressed file in the work dir with the uncompressed file it
+// should hold, decompressing it with decompressCmd; returns nonzero if they
+// differ
+static int compareCompressed(const char *decompressCmd,
+                             const char *compressedFile,
+                             const char *expected) {
+  char cmd[1024];
+
+  snprintf(cmd, sizeof(cmd),
+           "cd %s && %s %s > uncompressed.tmp && cmp -s uncompressed.tmp %s",
+           TEST_WORK_DIR, decompressCmd, compressedFile, expected);
+  if (runShell(cmd) != 0) {
+    logTest("%s does not decompress to %s\n", compressedFile, expected);
+    return 1;
+  }
+  return 0;
+}
+
+// Outputs written with the given compression method, to files ending in
+// suffix, decompress to the uncompressed ones, whether they are written by
+// the model thread or the async writer
+int testMethod(const char *method, const char *suffix,
+               const char *decompressCmd, const char *extraArgs) {
+  const char *files[] = {"sipnet.out", "events.out", "plain_envi.log",
+                         "plain_fluxes.log", "plain_trackers.log"};
+  char args[256];
+  int status = 0;
+
+  logTest("Starting testMethod %s %s\n", method, extraArgs);
+
+  snprintf(args, sizeof(args), "--debug-log plain %s", extraArgs);
+  status |= runSipnet(args);
+  status |= runShell("cd " TEST_WORK_DIR " && mkdir -p plain && mv sipnet.out "
+                     "events.out plain_*.log plain");
+
+  snprintf(args, sizeof(args), "--debug-log plain --compress-output %s %s",
+           method, extraArgs);
+  status |= runSipnet(args);
+  if (status != 0) {
+    logTest("sipnet failed\n");
+    return status;
+  }
+
+  for (int ind = 0; ind < 5; ++ind) {
+    char compressedFile[64], expected[64];
+    snprintf(compressedFile, sizeof(compressedFile), "%s%s", files[ind],
+             suffix);
+    snprintf(expected, sizeof(expected), "plain/%s", files[ind]);
+    status |= compareCompressed(decompressCmd, compressedFile, expected);
+  }
+
+  status |= runShell("cd " TEST_WORK_DIR " && rm -rf plain *.gz *.zst");
+  return status;
+}
+
+// Methods this build doesn't have are rejected
+int testMissingMethods(void) {
+  const char *methods[] = {COMPRESS_OUTPUT_GZIP, COMPRESS_OUTPUT_ZSTD};
+  int status = 0;
+  int rc;
+
+  logTest("Starting testMissingMethods\n");
+
+  for (int ind = 0; ind < 2; ++ind) {
+    char args[64];
+    if (hasOutputCompression(methods[ind])) {
+      continue;
+    }
+    snprintf(args, sizeof(args), "--compress-output %s", methods[ind]);
+    rc = runSipnet(args);
+    if (rc != EXIT_CODE_BAD_PARAMETER_VALUE) {
+      logTest("expected exit code %d for %s, got %d\n",
+              EXIT_CODE_BAD_PARAMETER_VALUE, args, rc);
+      status = 1;
+    }
+  }
+
+  rc = runSipnet("--compress-output bzip2");
+  if (rc != EXIT_CODE_BAD_CLI_ARGUMENT) {
+    logTest("expected exit code %d for --compress-output bzip2, got %d\n",
+            EXIT_CODE_BAD_CLI_ARGUMENT, rc);
+    status = 1;
+  }
+
+  return status;
+}
+
+int init(void) {
+  int status = 0;
+
+  status |= runShell("rm -rf " TEST_WORK_DIR " && mkdir " TEST_WORK_DIR);
+  status |= runShell("cp " SMOKE_DIR "/sipnet.in " SMOKE_DIR
+                     "/sipnet.param " SMOKE_DIR "/sipnet.clim " SMOKE_DIR
+                     "/events.in " TEST_WORK_DIR);
+
+  if (status != 0) {
+    logTest("Could not initialize test directory %s, failed with status %d\n",
+            TEST_WORK_DIR, status);
+  }
+
+  return status;
+}
+
+int cleanup(void) {
+  int status = runShell("rm -rf " TEST_WORK_DIR);
+
+  if (status != 0) {
+    logTest("Could not clean up test directory %s, failed with status %d\n",
+            TEST_WORK_DIR, status);
+  }
+
+  return status;
+}
+
+int main(void) {
+  int status = 0;
+
+  logTest("Starting testCompressedOutput\n");
+
+  status |= init();
+  // If init() fails, don't run the tests; but, we'll want to attempt cleanup()
+  if (!status) {
+    if (hasOutputCompression(COMPRESS_OUTPUT_GZIP)) {
+      status |= testMethod(COMPRESS_OUTPUT_GZIP, ".gz", "gzip -dc", "");
+      status |= testMethod(COMPRESS_OUTPUT_GZIP, ".gz", "gzip -dc",
+                           "--async-output");
+      status |= testMethod(COMPRESS_OUTPUT_GZIP, ".gz", "gzip -dc",
+                           "--output-format binary");
+    }
+    if (hasOutputCompression(COMPRESS_OUTPUT_ZSTD)) {
+      status |= testMethod(COMPRESS_OUTPUT_ZSTD, ".zst", "zstd -dcq", "");
+      status |= testMethod(COMPRESS_OUTPUT_ZSTD, ".zst", "zstd -dcq",
+                           "--async-output");
+      status |= testMethod(COMPRESS_OUTPUT_ZSTD, ".zst", "zstd -dcq",
+                           "--output-format binary");
+    }
+    status |= testMissingMethods();
+  }
+  status |= cleanup();
+
+  if (status) {
+    logTest("FAILED testCompressedOutput with status %d\n", status);
+    exit(status);
+  }
+
+  logTest("PASSED testCompressedOutput\n");
+  return 0;
+}
@@ -0,0 +1,206 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/logging.h"
+#include "utils/tUtils.h"
+
+#define SMOKE_DIR "../../../tests/smoke/russell_1"
+#define TEST_WORK_DIR "ensemble_work"
+#define NUM_MEMBERS 3
+
+// Run sipnet in the work dir; returns its exit status
+static int runSipnet(const char *args) {
+  char cmd[1024];
+
+  snprintf(cmd, sizeof(cmd),
+           "cd %s && ../../../../sipnet -i sipnet.in %s > ensemble_test.log "
+           "2>&1",
+           TEST_WORK_DIR, args);
+  return runShell(cmd);
+}
+
+// Every member has the same parameters as the single run, so each must
+// reproduce its output exactly, no matter which thread ran it
+int testEnsembleMatchesSingleRuns(void) {
+  int status = 0;
+  char memberFile[256], singleFile[256];
+
+  logTest("Starting testEnsembleMatchesSingleRuns\n");
+
+  status = runSipnet("");
+  if (status != 0) {
+    logTest("single sipnet run failed with status %d\n", status);
+    return status;
+  }
+  status = runSipnet("--ensemble members.txt --threads 2");
+  if (status != 0) {
+    logTest("ensemble sipnet run failed with status %d\n", status);
+    return status;
+  }
+
+  for (int ind = 1; ind <= NUM_MEMBERS; ++ind) {
+    snprintf(memberFile, sizeof(memberFile), "%s/member%d.out", TEST_WORK_DIR,
+             ind);
+    snprintf(singleFile, sizeof(singleFile), "%s/sipnet.out", TEST_WORK_DIR);
+    if (diffFiles(memberFile, singleFile)) {
+      logTest("%s differs from single run output\n", memberFile);
+      status = 1;
+    }
+    snprintf(memberFile, sizeof(memberFile), "%s/member%d.events.out",
+             TEST_WORK_DIR, ind);
+    snprintf(singleFile, sizeof(singleFile), "%s/events.out", TEST_WORK_DIR);
+    if (diffFiles(memberFile, singleFile)) {
+      logTest("%s differs from single run events output\n", memberFile);
+      status = 1;
+    }
+  }
+
+  return status;
+}
+
+// Members with different parameters must give the same output whether they
+// run one at a time or together in lanes, including a partly filled batch
+int testEnsembleLanesMatch(void) {
+  int status = 0;
+  char laneFile[256], singleFile[256];
+
+  logTest("Starting testEnsembleLanesMatch\n");
+
+  status = runSipnet("--ensemble lanes.txt --lanes 1");
+  status |= runShell("cd " TEST_WORK_DIR " && mkdir -p single && "
+                     "for ind in 1 2 3 4 5; do mv lane$ind.out "
+                     "lane$ind.events.out single; done");
+  if (status != 0) {
+    logTest("ensemble sipnet run with one lane failed with status %d\n",
+            status);
+    return status;
+  }
+
+  for (int lanes = 2; lanes <= 4; ++lanes) {
+    char args[256];
+    snprintf(args, sizeof(args), "--ensemble lanes.txt --lanes %d --threads 2",
+             lanes);
+    status = runSipnet(args);
+    if (status != 0) {
+      logTest("ensemble sipnet run with %d lanes failed with status %d\n",
+              lanes, status);
+      return status;
+    }
+    for (int ind = 1; ind <= 5; ++ind) {
+      snprintf(laneFile, sizeof(laneFile), "%s/lane%d.out", TEST_WORK_DIR, ind);
+      snprintf(singleFile, sizeof(singleFile), "%s/single/lane%d.out",
+               TEST_WORK_DIR, ind);
+      if (diffFiles(laneFile, singleFile)) {
+        logTest("%s with %d lanes differs from one lane\n", laneFile, lanes);
+        status = 1;
+      }
+      snprintf(laneFile, sizeof(laneFile), "%s/lane%d.events.out",
+               TEST_WORK_DIR, ind);
+      snprintf(singleFile, sizeof(singleFile), "%s/single/lane%d.events.out",
+               TEST_WORK_DIR, ind);
+      if (diffFiles(laneFile, singleFile)) {
+        logTest("%s with %d lanes differs from one lane\n", laneFile, lanes);
+        status = 1;
+      }
+    }
+  }
+
+  return status;
+}
+
+int testEnsembleRejectsBadLanes(void) {
+  logTest("Starting testEnsembleRejectsBadLanes\n");
+
+  int rc = runSipnet("--ensemble members.txt --lanes 9");
+  if (rc != EXIT_CODE_BAD_CLI_ARGUMENT) {
+    logTest("expected exit code %d for --lanes 9, got %d\n",
+            EXIT_CODE_BAD_CLI_ARGUMENT, rc);
+    return 1;
+  }
+
+  return 0;
+}
+
+int testEnsembleRejectsRestart(void) {
+  logTest("Starting testEnsembleRejectsRestart\n");
+
+  int rc = runSipnet("--ensemble members.txt --restart-out run.restart");
+  if (rc != EXIT_CODE_BAD_PARAMETER_VALUE) {
+    logTest("expected exit code %d for --ensemble with --restart-out, got %d\n",
+            EXIT_CODE_BAD_PARAMETER_VALUE, rc);
+    return 1;
+  }
+
+  return 0;
+}
+
+int init(void) {
+  int status = 0;
+
+  status |= runShell("rm -rf " TEST_WORK_DIR " && mkdir " TEST_WORK_DIR);
+  status |= runShell("cp " SMOKE_DIR "/sipnet.in " SMOKE_DIR
+                     "/sipnet.clim " SMOKE_DIR "/sipnet.param " SMOKE_DIR
+                     "/events.in " TEST_WORK_DIR);
+  status |= runShell("cd " TEST_WORK_DIR " && for ind in 1 2 3; do "
+                     "cp sipnet.param member$ind.param; done");
+  // Comments and blank lines in the member list are skipped
+  status |= runShell("cd " TEST_WORK_DIR " && printf '! members\\nmember1\\n\\n"
+                     "member2 ! second\\nmember3\\n' > members.txt");
+  // Lane members differ in light, respiration and water parameters, so they
+  // take different branches (snow, leaf growth) on different steps
+  status |= runShell(
+      "cd " TEST_WORK_DIR " && for ind in 1 2 3 4 5; do "
+      "awk -v k=$ind '"
+      "$1 == \"halfSatPar\" { $2 = $2 * (0.7 + 0.15 * k) } "
+      "$1 == \"attenuation\" { $2 = $2 * (1.2 - 0.1 * k) } "
+      "$1 == \"baseSoilResp\" { $2 = $2 * (0.5 + 0.25 * k) } "
+      "$1 == \"soilWFracInit\" { $2 = $2 * (0.6 + 0.2 * k) } "
+      "$1 == \"snowInit\" { $2 = (k % 2) * 5 } "
+      "{ print }' sipnet.param > lane$ind.param; "
+      "echo lane$ind >> lanes.txt; done");
+
+  if (status != 0) {
+    logTest("Could not initialize test directory %s, failed with status %d\n",
+            TEST_WORK_DIR, status);
+  }
+
+  return status;
+}
+
+int cleanup(void) {
+  int status = runShell("rm -rf " TEST_WORK_DIR);
+
+  if (status != 0) {
+    logTest("Could not clean up test directory %s, failed with status %d\n",
+            TEST_WORK_DIR, status);
+  }
+
+  return status;
+}
+
+int main(void) {
+  int status = 0;
+
+  logTest("Starting testEnsemble\n");
+
+  status |= init();
+
+  // If init() fails, don't run the tests; but, we'll want to attempt cleanup()
+  if (!status) {
+    status |= testEnsembleMatchesSingleRuns();
+    status |= testEnsembleLanesMatch();
+    status |= testEnsembleRejectsBadLanes();
+    status |= testEnsembleRejectsRestart();
+  }
+
+  status |= cleanup();
+
+  if (status) {
+    logTest("FAILED testEnsemble with status %d\n", status);
+    exit(status);
+  }
+
+  logTest("PASSED testEnsemble\n");
+  return 0;
+}
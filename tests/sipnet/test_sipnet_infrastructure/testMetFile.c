@@ -0,0 +1,401 @@
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/context.h"
+#include "common/exitCodes.h"
+#include "common/logging.h"
+#include "sipnet/climate_netcdf.h"
+#include "utils/tUtils.h"
+
+#ifdef SIPNET_NETCDF
+#include <netcdf.h>
+#endif
+
+#define SMOKE_DIR "../../../tests/smoke/russell_1"
+#define TEST_WORK_DIR "met_file_work"
+
+// Seconds from 1970-01-01 to 2016-01-01
+#define SECONDS_TO_2016 1451606400LL
+
+// Run sipnet in the work dir; returns its exit status
+static int runSipnet(const char *args) {
+  char cmd[1024];
+
+  snprintf(cmd, sizeof(cmd),
+           "cd %s && ../../../../sipnet -i sipnet.in %s > met_file.log 2>&1",
+           TEST_WORK_DIR, args);
+  return runShell(cmd);
+}
+
+static int checkUnits(const char *units, double expectedSecondsPerUnit,
+                      long long expectedBase) {
+  double secondsPerUnit;
+  long long base;
+
+  if (!parseCFTimeUnits(units, &secondsPerUnit, &base)) {
+    logTest("could not parse '%s'\n", units);
+    return 1;
+  }
+  if (secondsPerUnit != expectedSecondsPerUnit || base != expectedBase) {
+    logTest("'%s' parsed as %g s per unit from %lld, expected %g from %lld\n",
+            units, secondsPerUnit, base, expectedSecondsPerUnit, expectedBase);
+    return 1;
+  }
+  return 0;
+}
+
+static int checkBadUnits(const char *units) {
+  double secondsPerUnit;
+  long long base;
+
+  if (parseCFTimeUnits(units, &secondsPerUnit, &base)) {
+    logTest("parsed bad units '%s'\n", units);
+    return 1;
+  }
+  return 0;
+}
+
+int testCFTimeUnits(void) {
+  int status = 0;
+
+  logTest("Starting testCFTimeUnits\n");
+
+  status |= checkUnits("days since 1970-01-01", 86400, 0);
+  status |= checkUnits("hours since 2016-01-01 00:00:00", 3600,
+                       SECONDS_TO_2016);
+  status |= checkUnits("seconds since 2016-01-01T06:30:00Z", 1,
+                       SECONDS_TO_2016 + 6 * 3600 + 30 * 60);
+  status |= checkUnits("minutes since 2016-3-1 UTC", 60,
+                       SECONDS_TO_2016 + 60 * 86400LL);
+  status |= checkUnits("Days since 1969-12-31", 86400, -86400);
+  status |= checkBadUnits("fortnights since 2016-01-01");
+  status |= checkBadUnits("days since");
+  status |= checkBadUnits("days after 2016-01-01");
+  status |= checkBadUnits("days since 2016-13-01");
+  status |= checkBadUnits("days since 2016-01-01 noon");
+
+  return status;
+}
+
+static int checkDate(long long seconds, int expectedYear, int expectedDay,
+                     double expectedHour) {
+  int year, day;
+  double hour;
+
+  cfTimeToDate(seconds, &year, &day, &hour);
+  if (year != expectedYear || day != expectedDay || hour != expectedHour) {
+    logTest("%lld s is year %d day %d hour %g, expected %d %d %g\n", seconds,
+            year, day, hour, expectedYear, expectedDay, expectedHour);
+    return 1;
+  }
+  return 0;
+}
+
+int testCFTimeToDate(void) {
+  int status = 0;
+
+  logTest("Starting testCFTimeToDate\n");
+
+  status |= checkDate(0, 1970, 1, 0);
+  status |= checkDate(SECONDS_TO_2016 + 3 * 3600 + 1800, 2016, 1, 3.5);
+  // 2016 is a leap year; 1900 is not, and 2000 is
+  status |= checkDate(SECONDS_TO_2016 + 365 * 86400LL + 21 * 3600, 2016, 366,
+                      21);
+  status |= checkDate(SECONDS_TO_2016 + 366 * 86400LL, 2017, 1, 0);
+  status |= checkDate(-2208988800LL + 59 * 86400LL, 1900, 60, 0);
+  status |= checkDate(946684800LL + 59 * 86400LL, 2000, 60, 0);
+  status |= checkDate(-43200, 1969, 365, 12);
+
+  return status;
+}
+
+static int checkYears(const char *years, int valid, int expectedFirst,
+                      int expectedLast) {
+  int first, last;
+  int ok = parseMetYears(years, &first, &last);
+
+  if (ok != valid || (valid && (first != expectedFirst ||
+                                last != expectedLast))) {
+    logTest("met-years '%s' parsed as %d (%d to %d)\n", years, ok, first,
+            last);
+    return 1;
+  }
+  return 0;
+}
+
+int testMetYears(void) {
+  int status = 0;
+
+  logTest("Starting testMetYears\n");
+
+  status |= checkYears("", 1, INT_MIN, INT_MAX);
+  status |= checkYears("2016", 1, 2016, 2016);
+  status |= checkYears("2010-2015", 1, 2010, 2015);
+  status |= checkYears("2015-2010", 0, 0, 0);
+  status |= checkYears("2010-", 0, 0, 0);
+  status |= checkYears("-2010", 0, 0, 0);
+  status |= checkYears("twenty", 0, 0, 0);
+
+  return status;
+}
+
+// Met file options are checked, and met files need a build with NetCDF
+// support
+int testMetFileOptions(void) {
+  int status = 0;
+  int rc;
+
+  logTest("Starting testMetFileOptions\n");
+
+  rc = runSipnet("--met-file missing.nc");
+  if (hasNetcdfClimate()) {
+    if (rc != EXIT_CODE_FILE_OPEN_OR_READ_ERROR) {
+      logTest("expected exit code %d for a missing met file, got %d\n",
+              EXIT_CODE_FILE_OPEN_OR_READ_ERROR, rc);
+      status = 1;
+    }
+  } else if (rc != EXIT_CODE_BAD_PARAMETER_VALUE) {
+    logTest("expected exit code %d without NetCDF support, got %d\n",
+            EXIT_CODE_BAD_PARAMETER_VALUE, rc);
+    status = 1;
+  }
+
+  rc = runSipnet("--met-years 2016");
+  if (rc != EXIT_CODE_BAD_PARAMETER_VALUE) {
+    logTest("expected exit code %d for met-years without met-file, got %d\n",
+            EXIT_CODE_BAD_PARAMETER_VALUE, rc);
+    status = 1;
+  }
+
+  rc = runSipnet("--met-file missing.nc --met-years 2016-");
+  if (rc != EXIT_CODE_BAD_CLI_ARGUMENT) {
+    logTest("expected exit code %d for --met-years 2016-, got %d\n",
+            EXIT_CODE_BAD_CLI_ARGUMENT, rc);
+    status = 1;
+  }
+
+  return status;
+}
+
+#ifdef SIPNET_NETCDF
+
+// Steps in the generated met data: ten days, three hours apart
+#define MET_STEPS 80
+#define MET_STEP_SECONDS 10800
+
+// Met data for MET_STEPS steps from the start of 2016, in the met file's
+// units
+typedef struct MetData {
+  double time[MET_STEPS];  // hours since 2016-01-01
+  double tair[MET_STEPS], tsoil[MET_STEPS];  // degC
+  double par[MET_STEPS];  // mol m-2 s-1
+  double precip[MET_STEPS];  // kg m-2 s-1
+  double humidity[MET_STEPS];  // kg kg-1
+  double pressure[MET_STEPS];  // Pa
+  double wind[MET_STEPS];  // m s-1
+} MetData;
+
+static void makeMetData(MetData *met) {
+  for (int step = 0; step < MET_STEPS; ++step) {
+    double hour = (step % 8) * 3.0;
+    double daily = sin(2 * M_PI * (hour - 9) / 24);
+    met->time[step] = step * 3.0;
+    met->tair[step] = 4 + 6 * daily + 0.1 * step;
+    met->tsoil[step] = 3 + 2 * daily + 0.05 * step;
+    met->par[step] = (hour > 6 && hour < 18) ? 0.0012 * (1 + daily) : 0;
+    met->precip[step] = (step % 11 == 0) ? 2.5e-4 : 0;
+    met->humidity[step] = 0.004 + 0.001 * daily;
+    met->pressure[step] = 100000 + 300 * cos(step / 10.0);
+    met->wind[step] = 2 + sin(step / 5.0);
+  }
+}
+
+// Saturation vapor pressure (Pa) at temp (degC), as the met file reader
+// computes it
+static double saturationVaporPressure(double temp) {
+  return 611.2 * exp(17.67 * temp / (temp + 243.5));
+}
+
+// Write the .clim file the met data converts to; soil temperature is air
+// temperature if withSoil is 0
+static int writeMetClim(const MetData *met, int withSoil, const char *path) {
+  FILE *out = fopen(path, "w");
+
+  if (out == NULL) {
+    logTest("could not create %s\n", path);
+    return 1;
+  }
+  for (int step = 0; step < MET_STEPS; ++step) {
+    double tsoil = withSoil ? met->tsoil[step] : met->tair[step];
+    double vPress = met->humidity[step] * met->pressure[step] /
+                    (0.622 + 0.378 * met->humidity[step]);
+    double saturated = saturationVaporPressure(met->tair[step]);
+    double saturatedSoil = saturationVaporPressure(tsoil);
+    double vpdSoil = (vPress < saturatedSoil) ? saturatedSoil - vPress : 0;
+    fprintf(out,
+            "2016 %d %.17g %.17g %.17g %.17g %.17g %.17g %.17g %.17g %.17g "
+            "%.17g\n",
+            1 + step / 8, (step % 8) * 3.0,
+            (double)MET_STEP_SECONDS / 86400, met->tair[step], tsoil,
+            met->par[step] * MET_STEP_SECONDS,
+            met->precip[step] * MET_STEP_SECONDS, saturated - vPress, vpdSoil,
+            vPress, met->wind[step]);
+  }
+  fclose(out);
+  return 0;
+}
+
+// Write the met data as a CF met file; without soil_temperature if withSoil
+// is 0
+static int writeMetFile(const MetData *met, int withSoil, const char *path) {
+  const struct {
+    const char *name;
+    const char *units;
+    const double *values;
+  } vars[] = {
+      {"time", "hours since 2016-01-01 00:00:00", met->time},
+      {"air_temperature", "degC", met->tair},
+      {"surface_downwelling_photosynthetic_photon_flux_in_air", "mol m-2 s-1",
+       met->par},
+      {"precipitation_flux", "kg m-2 s-1", met->precip},
+      {"specific_humidity", "kg kg-1", met->humidity},
+      {"air_pressure", "Pa", met->pressure},
+      {"wind_speed", "m s-1", met->wind},
+      {"soil_temperature", "degC", met->tsoil}};
+  // soil_temperature is last, so it can be left out
+  int numVars = sizeof(vars) / sizeof(vars[0]) - (withSoil ? 0 : 1);
+  size_t start = 0, count = MET_STEPS;
+  int ncid, timeDim, varids[8];
+  int status = 0;
+
+  status |= nc_create(path, NC_CLOBBER | NC_NETCDF4, &ncid);
+  status |= nc_def_dim(ncid, "time", NC_UNLIMITED, &timeDim);
+  for (int ind = 0; ind < numVars; ++ind) {
+    status |=
+        nc_def_var(ncid, vars[ind].name, NC_DOUBLE, 1, &timeDim, &varids[ind]);
+    status |= nc_put_att_text(ncid, varids[ind], "units",
+                              strlen(vars[ind].units), vars[ind].units);
+  }
+  status |= nc_enddef(ncid);
+  for (int ind = 0; ind < numVars; ++ind) {
+    status |= nc_put_vara_double(ncid, varids[ind], &start, &count,
+                                 vars[ind].values);
+  }
+  status |= nc_close(ncid);
+
+  if (status != NC_NOERR) {
+    logTest("could not write met file %s\n", path);
+    return 1;
+  }
+  return 0;
+}
+
+// A run from a met file has the same output as a run from the .clim file
+// made from the same data; a missing soil temperature is air temperature,
+// with a warning
+static int compareMetWithClim(const MetData *met, int withSoil) {
+  int status = 0;
+
+  logTest("Comparing met file with .clim, %s soil temperature\n",
+          withSoil ? "with" : "without");
+
+  status |= writeMetClim(met, withSoil, TEST_WORK_DIR "/sipnet.clim");
+  status |= writeMetFile(met, withSoil, TEST_WORK_DIR "/met.nc");
+  if (status != 0) {
+    return status;
+  }
+
+  status |= runSipnet("--no-events --no-climate-cache");
+  status |= runShell("mv " TEST_WORK_DIR "/sipnet.out " TEST_WORK_DIR
+                     "/clim.out");
+  status |= runSipnet("--no-events --met-file met.nc");
+  if (status != 0) {
+    logTest("sipnet failed\n");
+    return status;
+  }
+  if (diffFiles(TEST_WORK_DIR "/clim.out", TEST_WORK_DIR "/sipnet.out")) {
+    logTest("met file output differs from .clim output\n");
+    status = 1;
+  }
+
+  int warned = fileContains(TEST_WORK_DIR "/met_file.log",
+                            "has no soil_temperature");
+  if (warned == withSoil) {
+    logTest("expected %s soil temperature warning\n", withSoil ? "no" : "a");
+    status = 1;
+  }
+
+  return status;
+}
+
+int testMetFileMatchesClim(void) {
+  MetData met;
+  int status = 0;
+
+  logTest("Starting testMetFileMatchesClim\n");
+
+  makeMetData(&met);
+  status |= compareMetWithClim(&met, 1);
+  status |= compareMetWithClim(&met, 0);
+
+  return status;
+}
+
+#endif  // SIPNET_NETCDF
+
+int init(void) {
+  int status = 0;
+
+  status |= runShell("rm -rf " TEST_WORK_DIR " && mkdir " TEST_WORK_DIR);
+  status |= runShell("cp " SMOKE_DIR "/sipnet.in " SMOKE_DIR
+                     "/sipnet.param " SMOKE_DIR "/events.in " TEST_WORK_DIR);
+
+  if (status != 0) {
+    logTest("Could not initialize test directory %s, failed with status %d\n",
+            TEST_WORK_DIR, status);
+  }
+
+  return status;
+}
+
+int cleanup(void) {
+  int status = runShell("rm -rf " TEST_WORK_DIR);
+
+  if (status != 0) {
+    logTest("Could not clean up test directory %s, failed with status %d\n",
+            TEST_WORK_DIR, status);
+  }
+
+  return status;
+}
+
+int main(void) {
+  int status = 0;
+
+  logTest("Starting testMetFile\n");
+
+  status |= testCFTimeUnits();
+  status |= testCFTimeToDate();
+  status |= testMetYears();
+
+  status |= init();
+  // If init() fails, don't run the tests; but, we'll want to attempt cleanup()
+  if (!status) {
+    status |= testMetFileOptions();
+#ifdef SIPNET_NETCDF
+    status |= testMetFileMatchesClim();
+#endif
+  }
+  status |= cleanup();
+
+  if (status) {
+    logTest("FAILED testMetFile with status %d\n", status);
+    exit(status);
+  }
+
+  logTest("PASSED testMetFile\n");
+  return 0;
+}
@@ -0,0 +1,89 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "common/context.h"
+#include "common/logging.h"
+#include "common/modelParams.h"
+#include "sipnet/sipnet.h"
+#include "utils/tUtils.h"
+
+#define TEST_WORK_DIR "../../../tests/smoke/russell_1"
+#define PARAM_FILE TEST_WORK_DIR "/sipnet.param"
+#define CLIM_FILE TEST_WORK_DIR "/sipnet.clim"
+
+static SipnetModel *newTestModel(ModelParams **modelParams) {
+  SipnetModel *model = newSipnetModel();
+  initModel(model, modelParams, PARAM_FILE, CLIM_FILE);
+  return model;
+}
+
+static void freeTestModel(SipnetModel *model, ModelParams *modelParams) {
+  cleanupModel(model);
+  deleteSipnetModel(model);
+  deleteModelParams(modelParams);
+}
+
+static int sameState(const SipnetModel *a, const SipnetModel *b) {
+  return memcmp(&a->envi, &b->envi, sizeof(Envi)) == 0 &&
+         memcmp(&a->trackers, &b->trackers, sizeof(Trackers)) == 0;
+}
+
+int testIndependentInstances(void) {
+  int status = 0;
+  ModelParams *paramsA, *paramsB;
+
+  logTest("Starting testIndependentInstances\n");
+
+  SipnetModel *modelA = newTestModel(&paramsA);
+  SipnetModel *modelB = newTestModel(&paramsB);
+
+  // Running A must leave B untouched
+  Envi enviB = modelB->envi;
+  runModelOutput(modelA, NULL, NULL, NULL, 0);
+  if (memcmp(&enviB, &modelB->envi, sizeof(Envi)) != 0) {
+    logTest("Running model A modified the state of model B\n");
+    status = 1;
+  }
+  if (modelA->trackers.totGpp == 0.0) {
+    logTest("Model A does not appear to have run\n");
+    status = 1;
+  }
+
+  // ... and B, run afterwards, must end up exactly where A did
+  runModelOutput(modelB, NULL, NULL, NULL, 0);
+  if (!sameState(modelA, modelB)) {
+    logTest("Models A and B differ after identical runs\n");
+    status = 1;
+  }
+
+  freeTestModel(modelA, paramsA);
+  freeTestModel(modelB, paramsB);
+
+  return status;
+}
+
+int run(void) {
+  int status = 0;
+
+  initContext();
+  // Events are per-model too, but are covered by the event tests
+  updateIntContext("events", 0, CTX_TEST);
+
+  status |= testIndependentInstances();
+
+  freeContextMetadata();
+
+  return status;
+}
+
+int main(void) {
+  int status;
+
+  status = run();
+  if (status) {
+    logTest("FAILED testModelInstances with status %d\n", status);
+    exit(status);
+  }
+
+  logTest("PASSED testModelInstances\n");
+}
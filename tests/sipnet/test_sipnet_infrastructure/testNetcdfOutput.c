@@ -0,0 +1,336 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/exitCodes.h"
+#include "common/logging.h"
+#include "sipnet/netcdfOutput.h"
+#include "utils/tUtils.h"
+
+#ifdef SIPNET_NETCDF
+#include <netcdf.h>
+#endif
+
+#define SMOKE_DIR "../../../tests/smoke/russell_1"
+#define TEST_WORK_DIR "netcdf_output_work"
+
+// Most rows read from the text output or climate file
+#define MAX_ROWS 8192
+
+// Run sipnet in the work dir; returns its exit status
+static int runSipnet(const char *args) {
+  char cmd[1024];
+
+  snprintf(cmd, sizeof(cmd),
+           "cd %s && ../../../../sipnet -i sipnet.in %s > netcdf_output.log "
+           "2>&1",
+           TEST_WORK_DIR, args);
+  return runShell(cmd);
+}
+
+#ifdef SIPNET_NETCDF
+
+// The year, day, time and length of each climate step, which is also each
+// row of the output
+typedef struct ClimSteps {
+  int year[MAX_ROWS], day[MAX_ROWS];
+  double time[MAX_ROWS], length[MAX_ROWS];
+  int numSteps;
+} ClimSteps;
+
+static int readClimSteps(ClimSteps *steps) {
+  FILE *in = fopen(TEST_WORK_DIR "/sipnet.clim", "r");
+  char line[1024];
+
+  if (in == NULL) {
+    logTest("could not open sipnet.clim\n");
+    return 1;
+  }
+  steps->numSteps = 0;
+  while (fgets(line, sizeof(line), in) != NULL && steps->numSteps < MAX_ROWS) {
+    int ind = steps->numSteps;
+    if (sscanf(line, "%d %d %lf %lf", &steps->year[ind], &steps->day[ind],
+               &steps->time[ind], &steps->length[ind]) == 4) {
+      ++steps->numSteps;
+    }
+  }
+  fclose(in);
+  return 0;
+}
+
+// Read the named column of the text output; returns the number of rows
+static int readTextColumn(const char *column, double *values) {
+  FILE *in = fopen(TEST_WORK_DIR "/sipnet.out", "r");
+  char line[4096];
+  int col = -1, numRows = 0;
+
+  if (in == NULL || fgets(line, sizeof(line), in) == NULL) {
+    logTest("could not read sipnet.out\n");
+    return 0;
+  }
+  int ind = 0;
+  for (char *tok = strtok(line, " \n"); tok != NULL;
+       tok = strtok(NULL, " \n"), ++ind) {
+    if (strcmp(tok, column) == 0) {
+      col = ind;
+    }
+  }
+  if (col < 0) {
+    logTest("no %s column in sipnet.out\n", column);
+    fclose(in);
+    return 0;
+  }
+  while (fgets(line, sizeof(line), in) != NULL && numRows < MAX_ROWS) {
+    char *tok = strtok(line, " \n");
+    for (ind = 0; ind < col && tok != NULL; ++ind) {
+      tok = strtok(NULL, " \n");
+    }
+    if (tok != NULL) {
+      values[numRows++] = atof(tok);
+    }
+  }
+  fclose(in);
+  return numRows;
+}
+
+// Check that a variable has the given units; returns its id, or -1
+static int checkVarUnits(int ncid, const char *name, const char *units) {
+  char text[NC_MAX_NAME + 1];
+  size_t len;
+  int varid;
+
+  if (nc_inq_varid(ncid, name, &varid) != NC_NOERR) {
+    logTest("sipnet.nc has no %s variable\n", name);
+    return -1;
+  }
+  if (nc_inq_attlen(ncid, varid, "units", &len) != NC_NOERR ||
+      len > NC_MAX_NAME ||
+      nc_get_att_text(ncid, varid, "units", text) != NC_NOERR) {
+    logTest("%s has no units\n", name);
+    return -1;
+  }
+  text[len] = '\0';
+  if (strcmp(text, units) != 0) {
+    logTest("%s has units '%s', expected '%s'\n", name, text, units);
+    return -1;
+  }
+  return varid;
+}
+
+// Compare a variable with a text output column; the text values are scaled
+// by scale, and divided by each row's length in seconds if perSecond. The
+// text is rounded to the given number of decimals, so the values can differ
+// by half of the last one
+static int checkVarValues(int ncid, int varid, const char *name,
+                          const char *column, int decimals, double scale,
+                          int perSecond, const ClimSteps *steps) {
+  static double expected[MAX_ROWS];
+  static float values[MAX_ROWS];
+  int numRows = readTextColumn(column, expected);
+
+  if (numRows != steps->numSteps) {
+    logTest("sipnet.out has %d rows, expected %d\n", numRows,
+            steps->numSteps);
+    return 1;
+  }
+  if (nc_get_var_float(ncid, varid, values) != NC_NOERR) {
+    logTest("could not read %s\n", name);
+    return 1;
+  }
+  for (int row = 0; row < numRows; ++row) {
+    double divisor = perSecond ? steps->length[row] * 86400.0 : 1.0;
+    double want = expected[row] * scale / divisor;
+    double tolerance =
+        0.5 * pow(10, -decimals) * scale / divisor + 1e-6 * fabs(want);
+    if (fabs(values[row] - want) > tolerance) {
+      logTest("%s is %g at row %d, expected %g from %s\n", name, values[row],
+              row, want, column);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+// Days from the start of baseYear to the start of year
+static double daysToYear(int baseYear, int year) {
+  double days = 0;
+
+  for (int y = baseYear; y < year; ++y) {
+    days += ((y % 4 == 0 && y % 100 != 0) || y % 400 == 0) ? 366 : 365;
+  }
+  return days;
+}
+
+// The time axis counts days from the first year of the climate data, with a
+// value for each row
+static int checkTimeAxis(int ncid, const ClimSteps *steps) {
+  static double times[MAX_ROWS];
+  char expectedUnits[64];
+  int dimid, varid;
+  size_t numTimes;
+
+  if (nc_inq_dimid(ncid, "time", &dimid) != NC_NOERR ||
+      nc_inq_dimlen(ncid, dimid, &numTimes) != NC_NOERR) {
+    logTest("sipnet.nc has no time dimension\n");
+    return 1;
+  }
+  if ((int)numTimes != steps->numSteps) {
+    logTest("sipnet.nc has %zu times, expected %d\n", numTimes,
+            steps->numSteps);
+    return 1;
+  }
+
+  snprintf(expectedUnits, sizeof(expectedUnits),
+           "days since %04d-01-01 00:00:00", steps->year[0]);
+  varid = checkVarUnits(ncid, "time", expectedUnits);
+  if (varid < 0 || nc_get_var_double(ncid, varid, times) != NC_NOERR) {
+    return 1;
+  }
+  for (int row = 0; row < steps->numSteps; ++row) {
+    double want = daysToYear(steps->year[0], steps->year[row]) +
+                  (steps->day[row] - 1) + steps->time[row] / 24.0;
+    if (fabs(times[row] - want) > 1e-9) {
+      logTest("time is %.9f at row %d, expected %.9f\n", times[row], row,
+              want);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+// Check sipnet.nc in the work dir against sipnet.out from the same run
+static int checkNetcdfFile(const ClimSteps *steps) {
+  int ncid, varid;
+  int status = 0;
+
+  if (nc_open(TEST_WORK_DIR "/sipnet.nc", NC_NOWRITE, &ncid) != NC_NOERR) {
+    logTest("could not open sipnet.nc\n");
+    return 1;
+  }
+
+  status |= checkTimeAxis(ncid, steps);
+
+  // Pools in standard names and units
+  varid = checkVarUnits(ncid, "AbvGrndWood", "kg C m-2");
+  status |= (varid < 0) || checkVarValues(ncid, varid, "AbvGrndWood",
+                                          "plantWoodC", 2, 0.001, 0, steps);
+  varid = checkVarUnits(ncid, "SoilMoist", "kg m-2");
+  status |= (varid < 0) || checkVarValues(ncid, varid, "SoilMoist",
+                                          "soilWater", 3, 10, 0, steps);
+
+  // Amounts over the row as rates
+  varid = checkVarUnits(ncid, "NEE", "kg C m-2 s-1");
+  status |= (varid < 0) ||
+            checkVarValues(ncid, varid, "NEE", "nee", 3, 0.001, 1, steps);
+
+  // Columns without a standard variable keep their names and units
+  varid = checkVarUnits(ncid, "woodCreation", "g C m-2");
+  status |= (varid < 0) || checkVarValues(ncid, varid, "woodCreation",
+                                          "woodCreation", 2, 1, 0, steps);
+
+  nc_close(ncid);
+  return status;
+}
+
+// A run written as NetCDF holds the same rows as the text output, converted
+// to standard units, with and without compression
+int testNetcdfRows(void) {
+  ClimSteps *steps = (ClimSteps *)malloc(sizeof(ClimSteps));
+  int status = 0;
+
+  logTest("Starting testNetcdfRows\n");
+
+  status |= readClimSteps(steps);
+  status |= runSipnet("");
+  status |= runSipnet("--output-format netcdf");
+  if (status != 0) {
+    logTest("sipnet failed\n");
+    free(steps);
+    return status;
+  }
+  status |= checkNetcdfFile(steps);
+
+  status |= runSipnet("--output-format netcdf --netcdf-deflate 4");
+  status |= checkNetcdfFile(steps);
+
+  free(steps);
+  return status;
+}
+
+#endif  // SIPNET_NETCDF
+
+// Without NetCDF support, asking for NetCDF output is an error
+int testNoNetcdfOutput(void) {
+  int status = 0;
+  int rc;
+
+  logTest("Starting testNoNetcdfOutput\n");
+
+  rc = runSipnet("--output-format netcdf");
+  if (rc != EXIT_CODE_BAD_PARAMETER_VALUE) {
+    logTest("expected exit code %d without NetCDF support, got %d\n",
+            EXIT_CODE_BAD_PARAMETER_VALUE, rc);
+    status = 1;
+  }
+
+  return status;
+}
+
+int init(void) {
+  int status = 0;
+
+  status |= runShell("rm -rf " TEST_WORK_DIR " && mkdir " TEST_WORK_DIR);
+  status |= runShell("cp " SMOKE_DIR "/sipnet.in " SMOKE_DIR
+                     "/sipnet.param " SMOKE_DIR "/sipnet.clim " SMOKE_DIR
+                     "/events.in " TEST_WORK_DIR);
+
+  if (status != 0) {
+    logTest("Could not initialize test directory %s, failed with status %d\n",
+            TEST_WORK_DIR, status);
+  }
+
+  return status;
+}
+
+int cleanup(void) {
+  int status = runShell("rm -rf " TEST_WORK_DIR);
+
+  if (status != 0) {
+    logTest("Could not clean up test directory %s, failed with status %d\n",
+            TEST_WORK_DIR, status);
+  }
+
+  return status;
+}
+
+int main(void) {
+  int status = 0;
+
+  logTest("Starting testNetcdfOutput\n");
+
+  status |= init();
+  // If init() fails, don't run the tests; but, we'll want to attempt cleanup()
+  if (!status) {
+    if (hasNetcdfOutput()) {
+#ifdef SIPNET_NETCDF
+      status |= testNetcdfRows();
+#else
+      logTest("sipnet has NetCDF support, but this test was built without "
+              "it; build the tests with make NETCDF=1\n");
+      status = 1;
+#endif
+    } else {
+      status |= testNoNetcdfOutput();
+    }
+  }
+  status |= cleanup();
+
+  if (status) {
+    logTest("FAILED testNetcdfOutput with status %d\n", status);
+    exit(status);
+  }
+
+  logTest("PASSED testNetcdfOutput\n");
+  return 0;
+}
@@ -0,0 +1,192 @@
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/logging.h"
+#include "common/numFormat.h"
+#include "utils/tUtils.h"
+
+// Check formatFixed against snprintf, byte for byte
+static int checkFixed(double value, int width, int precision) {
+  char exp[FORMAT_MAX_LEN], act[FORMAT_MAX_LEN];
+  snprintf(exp, sizeof(exp), "%*.*f", width, precision, value);
+  *formatFixed(act, value, width, precision) = '\0';
+
+  if (strcmp(exp, act) != 0) {
+    logTest("formatFixed(%.17g, %d, %d) gave \"%s\", printf gave \"%s\"\n",
+            value, width, precision, act, exp);
+    return 1;
+  }
+  return 0;
+}
+
+// Check formatGeneral against snprintf, byte for byte
+static int checkGeneral(double value, int precision) {
+  char exp[FORMAT_MAX_LEN], act[FORMAT_MAX_LEN];
+  snprintf(exp, sizeof(exp), "%.*g", precision, value);
+  *formatGeneral(act, value, precision) = '\0';
+
+  if (strcmp(exp, act) != 0) {
+    logTest("formatGeneral(%.17g, %d) gave \"%s\", printf gave \"%s\"\n", value,
+            precision, act, exp);
+    return 1;
+  }
+  return 0;
+}
+
+// A random double from a wide range of magnitudes
+static double randomValue(void) {
+  double value = (double)rand() / RAND_MAX;
+  value = ldexp(value + (double)rand() / RAND_MAX / RAND_MAX,
+                rand() % 120 - 60);
+  return (rand() % 2) ? -value : value;
+}
+
+int testFormatCases(void) {
+  int status = 0;
+  // Edge cases: zeros, exact ties (which go to even), rounding up to a new
+  // digit, and values too large, small or odd for the direct path
+  const double cases[] = {0.0,
+                          -0.0,
+                          0.5,
+                          1.5,
+                          2.5,
+                          -0.5,
+                          0.125,
+                          0.375,
+                          -0.001,
+                          0.005,
+                          0.015,
+                          1.005,
+                          9.995,
+                          99.9999999,
+                          999999999999999.5,
+                          1e15,
+                          4503599627370495.5,
+                          4503599627370496.0,
+                          9007199254740993.0,
+                          1e22,
+                          1e23,
+                          1e300,
+                          -1e300,
+                          DBL_MAX,
+                          DBL_MIN,
+                          5e-324,
+                          1e-8,
+                          1.5e-8,
+                          1e-9,
+                          0.0001,
+                          0.00001,
+                          123456789012345.6,
+                          0.1,
+                          0.3,
+                          2.0 / 3.0,
+                          INFINITY,
+                          -INFINITY,
+                          NAN};
+  const int numCases = sizeof(cases) / sizeof(cases[0]);
+
+  logTest("Starting testFormatCases\n");
+
+  for (int ind = 0; ind < numCases; ++ind) {
+    for (int precision = 0; precision <= FORMAT_MAX_PRECISION; ++precision) {
+      status |= checkFixed(cases[ind], 0, precision);
+      status |= checkFixed(cases[ind], 12, precision);
+      status |= checkFixed(cases[ind], -12, precision);
+      if (precision > 0) {
+        status |= checkGeneral(cases[ind], precision);
+      }
+    }
+  }
+
+  return status;
+}
+
+int testFormatRandom(void) {
+  int status = 0;
+
+  logTest("Starting testFormatRandom\n");
+
+  srand(2468);
+  for (int ind = 0; ind < 500000 && !status; ++ind) {
+    double value = randomValue();
+    int precision = rand() % (FORMAT_MAX_PRECISION + 1);
+    status |= checkFixed(value, rand() % 20, precision);
+    status |= checkGeneral(value, 15);
+    status |= checkGeneral(value, 1 + rand() % FORMAT_MAX_PRECISION);
+  }
+
+  // Exact ties at each precision: odd multiples of 2^-k
+  for (int ind = 0; ind < 100000 && !status; ++ind) {
+    int k = 1 + rand() % 20;
+    double value = ldexp(2 * (rand() % 100000) + 1, -k);
+    status |= checkFixed(value, 0, rand() % 12);
+    status |= checkGeneral(value, 1 + rand() % 15);
+  }
+
+  // Values near the halfway points of the formats used for output
+  for (int ind = 0; ind < 100000 && !status; ++ind) {
+    int precision = 2 + rand() % 7;
+    double value = ((rand() % 2000000) + 0.5) / pow(10, precision);
+    value = nextafter(value, (rand() % 2) ? INFINITY : -INFINITY);
+    status |= checkFixed(value, 8, precision);
+    status |= checkFixed(-value, 8, precision);
+  }
+
+  return status;
+}
+
+int testFormatIntString(void) {
+  int status = 0;
+  const int ints[] = {0, 7, -7, 2016, 365, -12345, INT_MAX, INT_MIN};
+  const int widths[] = {0, 3, 4, 8, -3, -8};
+  char exp[64], act[64];
+
+  logTest("Starting testFormatIntString\n");
+
+  for (int ind = 0; ind < (int)(sizeof(ints) / sizeof(int)); ++ind) {
+    for (int w = 0; w < (int)(sizeof(widths) / sizeof(int)); ++w) {
+      snprintf(exp, sizeof(exp), "%*d", widths[w], ints[ind]);
+      *formatInt(act, ints[ind], widths[w]) = '\0';
+      if (strcmp(exp, act) != 0) {
+        logTest("formatInt(%d, %d) gave \"%s\", printf gave \"%s\"\n",
+                ints[ind], widths[w], act, exp);
+        status = 1;
+      }
+    }
+  }
+
+  snprintf(exp, sizeof(exp), "%-7s|%7s|%s", "till", "harv", "irrig");
+  char *pos = formatString(act, "till", -7);
+  *pos++ = '|';
+  pos = formatString(pos, "harv", 7);
+  *pos++ = '|';
+  *formatString(pos, "irrig", 0) = '\0';
+  if (strcmp(exp, act) != 0) {
+    logTest("formatString gave \"%s\", printf gave \"%s\"\n", act, exp);
+    status = 1;
+  }
+
+  return status;
+}
+
+int main(void) {
+  int status = 0;
+
+  logTest("Starting testNumFormat\n");
+
+  status |= testFormatCases();
+  status |= testFormatRandom();
+  status |= testFormatIntString();
+
+  if (status) {
+    logTest("FAILED testNumFormat with status %d\n", status);
+    exit(status);
+  }
+
+  logTest("PASSED testNumFormat\n");
+  return 0;
+}
@@ -6,6 +6,10 @@
 #include "common/logging.h"
 #include "sipnet/sipnet.c"
 
+// Model instance shared by the tests in this file
+static SipnetModel testModel;
+static SipnetModel *model = &testModel;
+
 #define MAX_LINE_LEN 4096
 #define MAX_TOKENS 1024
 #define FORMAT_OUTPUT_FILE "format_check.out"
@@ -83,16 +87,16 @@ int checkOutput(void) {
 }
 
 void init(void) {
-  initTrackers();
+  initTrackers(model);
   // soilC is often 4 digits
-  envi.soilC = 5555;
+  model->envi.soilC = 5555;
 }
 
 void genOutput(FILE *out) {
   init();
 
-  outputHeader(out);
-  outputState(out, 2026, 50, 0.0);
+  outputHeader(model, out);
+  outputState(model, out, 2026, 50, 0.0);
 }
 
 int run(void) {
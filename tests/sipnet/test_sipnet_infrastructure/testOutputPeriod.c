@@ -0,0 +1,291 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/logging.h"
+#include "utils/tUtils.h"
+#include "tools/sipnet_binary.c"
+
+#define SMOKE_DIR "../../../tests/smoke/russell_1"
+#define TEST_WORK_DIR "output_period_work"
+#define MAX_STEPS 10000
+#define TOLERANCE 1e-9
+
+// Columns summed over a period, and those averaged by step length; the others,
+// apart from year, day and time, are sampled at the end of the period
+static const char *sumColumns[] = {"woodCreation", "npp", "nee", "gpp",
+                                   "rAboveground", "rSoil", "rRoot", "ra",
+                                   "rh", "rtot", "evapotranspiration", "n2o",
+                                   "nLeaching", "nFixation", "nUptake", "ch4"};
+static const char *meanColumns[] = {"soilWetnessFrac", "fluxestranspiration"};
+
+// Run sipnet in the work dir; returns its exit status
+static int runSipnet(const char *args) {
+  char cmd[1024];
+
+  snprintf(cmd, sizeof(cmd),
+           "cd %s && ../../../../sipnet -i sipnet.in %s > output_period.log "
+           "2>&1",
+           TEST_WORK_DIR, args);
+  return runShell(cmd);
+}
+
+// Read the length of each step from the climate file; returns the number of
+// steps
+static int readStepLengths(double *lengths) {
+  FILE *clim = fopen(TEST_WORK_DIR "/sipnet.clim", "r");
+  int numSteps = 0;
+  double length;
+
+  if (clim == NULL) {
+    return 0;
+  }
+  while (numSteps < MAX_STEPS &&
+         fscanf(clim, "%*d %*d %*f %lf %*[^\n]", &length) == 1) {
+    lengths[numSteps++] = length;
+  }
+  fclose(clim);
+  return numSteps;
+}
+
+static int isListed(const char *name, const char **list, int count) {
+  for (int ind = 0; ind < count; ++ind) {
+    if (strcmp(name, list[ind]) == 0) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+// Month (1 to 12) of a day of year
+static int monthOf(int year, int day) {
+  static const int monthDays[12] = {31, 28, 31, 30, 31, 30,
+                                    31, 31, 30, 31, 30, 31};
+  int isLeap = ((year % 4 == 0) && (year % 100 != 0)) || (year % 400 == 0);
+  int month = 0;
+
+  while (month < 11 && day > monthDays[month] + (month == 1 && isLeap)) {
+    day -= monthDays[month] + (month == 1 && isLeap);
+    ++month;
+  }
+  return month + 1;
+}
+
+// Whether steps a and b of the step-level output fall in the same period
+static int samePeriod(const SipnetBinaryFile *steps, const char *period, long a,
+                      long b) {
+  int yearA = (int)steps->values[0][a], yearB = (int)steps->values[0][b];
+  int dayA = (int)steps->values[1][a], dayB = (int)steps->values[1][b];
+
+  if (yearA != yearB) {
+    return 0;
+  }
+  if (strcmp(period, "day") == 0) {
+    return dayA == dayB;
+  }
+  if (strcmp(period, "month") == 0) {
+    return monthOf(yearA, dayA) == monthOf(yearB, dayB);
+  }
+  return 1;
+}
+
+static int isClose(double expected, double actual) {
+  return fabs(expected - actual) <= TOLERANCE * fmax(1, fabs(expected));
+}
+
+// Check output aggregated by period against the same aggregation of the
+// step-level output
+static int checkPeriod(const SipnetBinaryFile *steps, const double *lengths,
+                       const char *period, int expectedRows) {
+  char args[256];
+  SipnetBinaryFile *agg;
+  long first = 0;
+  long row = 0;
+  int status = 0;
+
+  snprintf(args, sizeof(args), "--output-format binary --output-period %s",
+           period);
+  if (runSipnet(args) != 0 ||
+      (agg = readSipnetBinary(TEST_WORK_DIR "/sipnet.out")) == NULL) {
+    logTest("sipnet run by %s failed\n", period);
+    return 1;
+  }
+  if (agg->numColumns != steps->numColumns || agg->numRows != expectedRows) {
+    logTest("output by %s has %d columns and %ld rows, expected %d rows\n",
+            period, agg->numColumns, agg->numRows, expectedRows);
+    freeSipnetBinary(agg);
+    return 1;
+  }
+
+  while (first < steps->numRows && !status) {
+    long last = first;
+    while (last + 1 < steps->numRows &&
+           samePeriod(steps, period, first, last + 1)) {
+      ++last;
+    }
+    for (int col = 0; col < steps->numColumns && !status; ++col) {
+      const char *name = steps->columns[col].name;
+      double expected = 0;
+      double totLength = 0;
+      if (col < 3) {
+        expected = steps->values[col][first];
+      } else if (isListed(name, sumColumns,
+                          sizeof(sumColumns) / sizeof(char *))) {
+        for (long step = first; step <= last; ++step) {
+          expected += steps->values[col][step];
+        }
+      } else if (isListed(name, meanColumns,
+                          sizeof(meanColumns) / sizeof(char *))) {
+        for (long step = first; step <= last; ++step) {
+          expected += steps->values[col][step] * lengths[step];
+          totLength += lengths[step];
+        }
+        expected /= totLength;
+      } else {
+        expected = steps->values[col][last];
+      }
+      if (!isClose(expected, agg->values[col][row])) {
+        logTest("by %s, row %ld %s is %.10g, expected %.10g\n", period, row,
+                name, agg->values[col][row], expected);
+        status = 1;
+      }
+    }
+    first = last + 1;
+    ++row;
+  }
+
+  freeSipnetBinary(agg);
+  return status;
+}
+
+// Daily, monthly and annual output are the sums, averages and end values of
+// the step-level output over each period
+int testPeriodValues(void) {
+  int status = 0;
+  double lengths[MAX_STEPS];
+  SipnetBinaryFile *steps;
+
+  logTest("Starting testPeriodValues\n");
+
+  status |= runSipnet("--output-format binary");
+  status |= runShell("cd " TEST_WORK_DIR " && mv sipnet.out steps.bin");
+  if (status != 0) {
+    logTest("sipnet run failed with status %d\n", status);
+    return status;
+  }
+  steps = readSipnetBinary(TEST_WORK_DIR "/steps.bin");
+  if (steps == NULL || readStepLengths(lengths) != steps->numRows) {
+    logTest("could not read step-level output and climate\n");
+    return 1;
+  }
+
+  // russell_1 runs through 2016 and 2017
+  status |= checkPeriod(steps, lengths, "day", 366 + 365);
+  status |= checkPeriod(steps, lengths, "month", 24);
+  status |= checkPeriod(steps, lengths, "year", 2);
+
+  freeSipnetBinary(steps);
+  return status;
+}
+
+// Text output by period has the same rows with or without asynchronous output
+// and column selection
+int testPeriodText(void) {
+  int status = 0;
+
+  logTest("Starting testPeriodText\n");
+
+  status |= runSipnet("--output-period month --output-vars gpp,soilWater");
+  status |= runShell("cd " TEST_WORK_DIR " && mv sipnet.out sync.out");
+  status |= runSipnet("--output-period month --output-vars gpp,soilWater "
+                      "--async-output");
+  if (status != 0) {
+    logTest("sipnet runs failed with status %d\n", status);
+    return status;
+  }
+  if (diffFiles(TEST_WORK_DIR "/sipnet.out", TEST_WORK_DIR "/sync.out")) {
+    logTest("monthly output differs with asynchronous output\n");
+    status = 1;
+  }
+
+  return status;
+}
+
+int testBadPeriod(void) {
+  int status = 0;
+  int rc;
+
+  logTest("Starting testBadPeriod\n");
+
+  rc = runSipnet("--output-period week");
+  if (rc != EXIT_CODE_BAD_CLI_ARGUMENT) {
+    logTest("expected exit code %d for --output-period week, got %d\n",
+            EXIT_CODE_BAD_CLI_ARGUMENT, rc);
+    status = 1;
+  }
+
+  status |= runShell("cd " TEST_WORK_DIR " && cp sipnet.in period.in && "
+                     "echo 'OUTPUT_PERIOD = week' >> period.in");
+  rc = runShell("cd " TEST_WORK_DIR " && ../../../../sipnet -i period.in "
+                "> output_period.log 2>&1");
+  if (rc != EXIT_CODE_BAD_PARAMETER_VALUE) {
+    logTest("expected exit code %d for OUTPUT_PERIOD week, got %d\n",
+            EXIT_CODE_BAD_PARAMETER_VALUE, rc);
+    status = 1;
+  }
+
+  return status;
+}
+
+int init(void) {
+  int status = 0;
+
+  status |= runShell("rm -rf " TEST_WORK_DIR " && mkdir " TEST_WORK_DIR);
+  status |= runShell("cp " SMOKE_DIR "/sipnet.in " SMOKE_DIR
+                     "/sipnet.clim " SMOKE_DIR "/sipnet.param " SMOKE_DIR
+                     "/events.in " TEST_WORK_DIR);
+
+  if (status != 0) {
+    logTest("Could not initialize test directory %s, failed with status %d\n",
+            TEST_WORK_DIR, status);
+  }
+
+  return status;
+}
+
+int cleanup(void) {
+  int status = runShell("rm -rf " TEST_WORK_DIR);
+
+  if (status != 0) {
+    logTest("Could not clean up test directory %s, failed with status %d\n",
+            TEST_WORK_DIR, status);
+  }
+
+  return status;
+}
+
+int main(void) {
+  int status = 0;
+
+  logTest("Starting testOutputPeriod\n");
+
+  status |= init();
+
+  // If init() fails, don't run the tests; but, we'll want to attempt cleanup()
+  if (!status) {
+    status |= testPeriodValues();
+    status |= testPeriodText();
+    status |= testBadPeriod();
+  }
+
+  status |= cleanup();
+
+  if (status) {
+    logTest("FAILED testOutputPeriod with status %d\n", status);
+    exit(status);
+  }
+
+  logTest("PASSED testOutputPeriod\n");
+  return 0;
+}
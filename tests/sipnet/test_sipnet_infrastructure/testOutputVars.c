@@ -0,0 +1,305 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/logging.h"
+#include "utils/tUtils.h"
+#include "tools/sipnet_binary.c"
+
+#define SMOKE_DIR "../../../tests/smoke/russell_1"
+#define TEST_WORK_DIR "output_vars_work"
+#define MAX_LINE_LEN 8192
+#define MAX_COLUMNS 128
+
+// Run sipnet in the work dir; returns its exit status
+static int runSipnet(const char *args) {
+  char cmd[1024];
+
+  snprintf(cmd, sizeof(cmd),
+           "cd %s && ../../../../sipnet -i sipnet.in %s > output_vars.log "
+           "2>&1",
+           TEST_WORK_DIR, args);
+  return runShell(cmd);
+}
+
+// Split line into whitespace-separated tokens, in place; returns the count
+static int splitLine(char *line, char **tokens) {
+  int count = 0;
+
+  for (char *token = strtok(line, " \n"); token != NULL && count < MAX_COLUMNS;
+       token = strtok(NULL, " \n")) {
+    tokens[count++] = token;
+  }
+  return count;
+}
+
+// Check that selFile has the header expected (space-separated names), and
+// that each of its columns is the same, row by row, as the column of that
+// name in fullFile
+static int checkColumns(const char *fullFile, const char *selFile,
+                        const char *expectedHeader) {
+  char fullLine[MAX_LINE_LEN], selLine[MAX_LINE_LEN], header[MAX_LINE_LEN];
+  char *fullTokens[MAX_COLUMNS], *selTokens[MAX_COLUMNS];
+  int fullIndex[MAX_COLUMNS];
+  int numFull, numSel, row = 0, status = 0;
+  char path[256];
+  FILE *full, *sel;
+
+  snprintf(path, sizeof(path), "%s/%s", TEST_WORK_DIR, fullFile);
+  full = fopen(path, "r");
+  snprintf(path, sizeof(path), "%s/%s", TEST_WORK_DIR, selFile);
+  sel = fopen(path, "r");
+  if (full == NULL || sel == NULL ||
+      fgets(fullLine, sizeof(fullLine), full) == NULL ||
+      fgets(selLine, sizeof(selLine), sel) == NULL) {
+    logTest("could not read headers of %s and %s\n", fullFile, selFile);
+    return 1;
+  }
+
+  numFull = splitLine(fullLine, fullTokens);
+  numSel = splitLine(selLine, selTokens);
+  header[0] = '\0';
+  for (int col = 0; col < numSel; ++col) {
+    strcat(header, (col > 0) ? " " : "");
+    strcat(header, selTokens[col]);
+    fullIndex[col] = -1;
+    for (int ind = 0; ind < numFull; ++ind) {
+      if (strcmp(fullTokens[ind], selTokens[col]) == 0) {
+        fullIndex[col] = ind;
+      }
+    }
+    if (fullIndex[col] < 0) {
+      logTest("%s has column %s, which %s doesn't\n", selFile, selTokens[col],
+              fullFile);
+      status = 1;
+    }
+  }
+  if (strcmp(header, expectedHeader) != 0) {
+    logTest("%s header is \"%s\", expected \"%s\"\n", selFile, header,
+            expectedHeader);
+    status = 1;
+  }
+
+  while (!status && fgets(fullLine, sizeof(fullLine), full) != NULL) {
+    ++row;
+    if (fgets(selLine, sizeof(selLine), sel) == NULL) {
+      logTest("%s ends at row %d\n", selFile, row);
+      status = 1;
+      break;
+    }
+    splitLine(fullLine, fullTokens);
+    if (splitLine(selLine, selTokens) != numSel) {
+      logTest("%s row %d has the wrong number of columns\n", selFile, row);
+      status = 1;
+      break;
+    }
+    for (int col = 0; col < numSel; ++col) {
+      if (strcmp(selTokens[col], fullTokens[fullIndex[col]]) != 0) {
+        logTest("%s row %d column %d is %s, %s in %s\n", selFile, row, col,
+                selTokens[col], fullTokens[fullIndex[col]], fullFile);
+        status = 1;
+        break;
+      }
+    }
+  }
+  if (!status && fgets(selLine, sizeof(selLine), sel) != NULL) {
+    logTest("%s has more rows than %s\n", selFile, fullFile);
+    status = 1;
+  }
+
+  fclose(full);
+  fclose(sel);
+  return status;
+}
+
+// Selected columns of the main output are the same as in the full output,
+// in file order, however they are listed and whether or not output is
+// asynchronous
+int testMainOutput(void) {
+  int status = 0;
+
+  logTest("Starting testMainOutput\n");
+
+  status |= runSipnet("--debug-log full");
+  status |= runShell("cd " TEST_WORK_DIR " && mv sipnet.out full.out");
+  status |= runSipnet("--output-vars gpp,nee,soilWater");
+  status |= runShell("cd " TEST_WORK_DIR " && mv sipnet.out sel.out");
+  status |= runSipnet("--output-vars gpp,nee,soilWater --async-output");
+  if (status != 0) {
+    logTest("sipnet runs failed with status %d\n", status);
+    return status;
+  }
+
+  status |= checkColumns("full.out", "sel.out",
+                         "year day time soilWater nee gpp");
+  if (diffFiles(TEST_WORK_DIR "/sipnet.out", TEST_WORK_DIR "/sel.out")) {
+    logTest("selected columns differ with asynchronous output\n");
+    status = 1;
+  }
+
+  return status;
+}
+
+// The same names select fields of the debug logs
+int testDebugLogs(void) {
+  int status = 0;
+
+  logTest("Starting testDebugLogs\n");
+
+  status |= runSipnet("--debug-log sel --output-vars "
+                      "gpp,soilWater,photosynthesis,lastYear");
+  if (status != 0) {
+    logTest("sipnet run failed with status %d\n", status);
+    return status;
+  }
+
+  status |= checkColumns("full_envi.log", "sel_envi.log",
+                         "year day time soilWater");
+  status |= checkColumns("full_fluxes.log", "sel_fluxes.log",
+                         "year day time photosynthesis");
+  status |= checkColumns("full_trackers.log", "sel_trackers.log",
+                         "year day time t.gpp t.lastYear pt.lastYear");
+
+  return status;
+}
+
+// Binary output has just the selected columns, with the same values
+int testBinaryOutput(void) {
+  int status = 0;
+  SipnetBinaryFile *full, *sel;
+  const char *expected[] = {"year", "day", "time", "nee", "ch4"};
+  const int numExpected = sizeof(expected) / sizeof(expected[0]);
+
+  logTest("Starting testBinaryOutput\n");
+
+  status |= runSipnet("--output-format binary");
+  status |= runShell("cd " TEST_WORK_DIR " && mv sipnet.out full.bin");
+  status |= runSipnet("--output-format binary --output-vars ch4,nee");
+  if (status != 0) {
+    logTest("sipnet runs failed with status %d\n", status);
+    return status;
+  }
+
+  full = readSipnetBinary(TEST_WORK_DIR "/full.bin");
+  sel = readSipnetBinary(TEST_WORK_DIR "/sipnet.out");
+  if (full == NULL || sel == NULL) {
+    logTest("could not read binary output files\n");
+    return 1;
+  }
+  if (sel->numColumns != numExpected || sel->numRows != full->numRows) {
+    logTest("binary output has %d columns and %ld rows\n", sel->numColumns,
+            sel->numRows);
+    status = 1;
+  }
+  for (int col = 0; col < sel->numColumns && !status; ++col) {
+    int fullCol = findSipnetBinaryColumn(full, expected[col]);
+    if (strcmp(sel->columns[col].name, expected[col]) != 0 || fullCol < 0 ||
+        sel->columns[col].type != full->columns[fullCol].type ||
+        strcmp(sel->columns[col].units, full->columns[fullCol].units) != 0) {
+      logTest("binary column %d is %s, expected %s\n", col,
+              sel->columns[col].name, expected[col]);
+      status = 1;
+      break;
+    }
+    for (long row = 0; row < sel->numRows; ++row) {
+      if (sel->values[col][row] != full->values[fullCol][row]) {
+        logTest("row %ld %s differs\n", row, expected[col]);
+        status = 1;
+        break;
+      }
+    }
+  }
+
+  freeSipnetBinary(full);
+  freeSipnetBinary(sel);
+  return status;
+}
+
+// output-vars in the config file works like the option
+int testConfigFile(void) {
+  int status = 0;
+
+  logTest("Starting testConfigFile\n");
+
+  status |= runShell("cd " TEST_WORK_DIR " && cp sipnet.in vars.in && "
+                     "echo 'OUTPUT_VARS = nee,gpp,soilWater' >> vars.in");
+  status |= runShell("cd " TEST_WORK_DIR " && ../../../../sipnet -i vars.in "
+                     "> output_vars.log 2>&1");
+  if (status != 0) {
+    logTest("sipnet run failed with status %d\n", status);
+    return status;
+  }
+  if (diffFiles(TEST_WORK_DIR "/sipnet.out", TEST_WORK_DIR "/sel.out")) {
+    logTest("output-vars from the config file gave different output\n");
+    status = 1;
+  }
+
+  return status;
+}
+
+int testUnknownVar(void) {
+  logTest("Starting testUnknownVar\n");
+
+  int rc = runSipnet("--output-vars nee,LAI");
+  if (rc != EXIT_CODE_BAD_PARAMETER_VALUE) {
+    logTest("expected exit code %d for an unknown variable, got %d\n",
+            EXIT_CODE_BAD_PARAMETER_VALUE, rc);
+    return 1;
+  }
+
+  return 0;
+}
+
+int init(void) {
+  int status = 0;
+
+  status |= runShell("rm -rf " TEST_WORK_DIR " && mkdir " TEST_WORK_DIR);
+  status |= runShell("cp " SMOKE_DIR "/sipnet.in " SMOKE_DIR
+                     "/sipnet.clim " SMOKE_DIR "/sipnet.param " SMOKE_DIR
+                     "/events.in " TEST_WORK_DIR);
+
+  if (status != 0) {
+    logTest("Could not initialize test directory %s, failed with status %d\n",
+            TEST_WORK_DIR, status);
+  }
+
+  return status;
+}
+
+int cleanup(void) {
+  int status = runShell("rm -rf " TEST_WORK_DIR);
+
+  if (status != 0) {
+    logTest("Could not clean up test directory %s, failed with status %d\n",
+            TEST_WORK_DIR, status);
+  }
+
+  return status;
+}
+
+int main(void) {
+  int status = 0;
+
+  logTest("Starting testOutputVars\n");
+
+  status |= init();
+
+  // If init() fails, don't run the tests; but, we'll want to attempt cleanup()
+  if (!status) {
+    status |= testMainOutput();
+    status |= testDebugLogs();
+    status |= testBinaryOutput();
+    status |= testConfigFile();
+    status |= testUnknownVar();
+  }
+
+  status |= cleanup();
+
+  if (status) {
+    logTest("FAILED testOutputVars with status %d\n", status);
+    exit(status);
+  }
+
+  logTest("PASSED testOutputVars\n");
+  return 0;
+}
@@ -5,14 +5,18 @@
 #include "common/logging.h"
 #include "sipnet/sipnet.c"
 
+// Model instance shared by the tests in this file
+static SipnetModel testModel;
+static SipnetModel *model = &testModel;
+
 void writeParams(const char *fname);
 
-void resetParams(void) { memset(&params, 0, sizeof(struct Parameters)); }
+void resetParams(void) { memset(&model->params, 0, sizeof(struct Parameters)); }
 
 void runNegTest(const char *fName) {
   // Pretty much guaranteed to leak memory, but that should be ok for a test
   ModelParams *modelParams = NULL;
-  readParamData(&modelParams, fName);
+  readParamData(model, &modelParams, fName);
 }
 
 int runTest(const char *root) {
@@ -30,7 +34,7 @@ int runTest(const char *root) {
   strcat(outName, ".out");
   strcat(expName, ".exp");
 
-  readParamData(&modelParams, inName);
+  readParamData(model, &modelParams, inName);
   writeParams(outName);
   resetParams();
   deleteModelParams(modelParams);
@@ -100,69 +104,79 @@ void writeParams(const char *fname) {
     exit(1);
   }
 
-  fprintf(out, "%s: %.2f\n", "plantWoodInit", params.plantWoodInit);
-  fprintf(out, "%s: %.2f\n", "laiInit", params.laiInit);
-  fprintf(out, "%s: %.2f\n", "litterInit", params.litterInit);
-  fprintf(out, "%s: %.2f\n", "soilInit", params.soilInit);
-  fprintf(out, "%s: %.2f\n", "soilWFracInit", params.soilWFracInit);
-  fprintf(out, "%s: %.2f\n", "snowInit", params.snowInit);
-  fprintf(out, "%s: %.2f\n", "aMax", params.aMax);
-  fprintf(out, "%s: %.2f\n", "aMaxFrac", params.aMaxFrac);
-  fprintf(out, "%s: %.2f\n", "baseFolRespFrac", params.baseFolRespFrac);
-  fprintf(out, "%s: %.2f\n", "psnTMin", params.psnTMin);
-  fprintf(out, "%s: %.2f\n", "psnTOpt", params.psnTOpt);
-  fprintf(out, "%s: %.2f\n", "dVpdSlope", params.dVpdSlope);
-  fprintf(out, "%s: %.2f\n", "dVpdExp", params.dVpdExp);
-  fprintf(out, "%s: %.2f\n", "halfSatPar", params.halfSatPar);
-  fprintf(out, "%s: %.2f\n", "attenuation", params.attenuation);
-  fprintf(out, "%s: %.2f\n", "leafOnDay", params.leafOnDay);
-  fprintf(out, "%s: %.2f\n", "gddLeafOn", params.gddLeafOn);
-  fprintf(out, "%s: %.2f\n", "soilTempLeafOn", params.soilTempLeafOn);
-  fprintf(out, "%s: %.2f\n", "leafOffDay", params.leafOffDay);
-  fprintf(out, "%s: %.2f\n", "leafGrowth", params.leafGrowth);
-  fprintf(out, "%s: %.2f\n", "fracLeafFall", params.fracLeafFall);
-  fprintf(out, "%s: %.2f\n", "leafAllocation", params.leafAllocation);
-  fprintf(out, "%s: %.2f\n", "leafTurnoverRate", params.leafTurnoverRate);
-  fprintf(out, "%s: %.2f\n", "baseVegResp", params.baseVegResp);
-  fprintf(out, "%s: %.2f\n", "vegRespQ10", params.vegRespQ10);
-  fprintf(out, "%s: %.2f\n", "growthRespFrac", params.growthRespFrac);
-  fprintf(out, "%s: %.2f\n", "frozenSoilFolREff", params.frozenSoilFolREff);
-  fprintf(out, "%s: %.2f\n", "frozenSoilThreshold", params.frozenSoilThreshold);
-  fprintf(out, "%s: %.2f\n", "litterBreakdownRate", params.litterBreakdownRate);
-  fprintf(out, "%s: %.2f\n", "fracLitterRespired", params.fracLitterRespired);
-  fprintf(out, "%s: %.2f\n", "baseSoilResp", params.baseSoilResp);
-  fprintf(out, "%s: %.2f\n", "soilRespQ10", params.soilRespQ10);
-  fprintf(out, "%s: %.2f\n", "soilRespMoistEffect", params.soilRespMoistEffect);
-  fprintf(out, "%s: %.2f\n", "waterRemoveFrac", params.waterRemoveFrac);
-  fprintf(out, "%s: %.2f\n", "frozenSoilEff", params.frozenSoilEff);
-  fprintf(out, "%s: %.2f\n", "wueConst", params.wueConst);
-  fprintf(out, "%s: %.2f\n", "soilWHC", params.soilWHC);
-  fprintf(out, "%s: %.2f\n", "immedEvapFrac", params.immedEvapFrac);
-  fprintf(out, "%s: %.2f\n", "fastFlowFrac", params.fastFlowFrac);
-  fprintf(out, "%s: %.2f\n", "snowMelt", params.snowMelt);
-  fprintf(out, "%s: %.2f\n", "rdConst", params.rdConst);
-  fprintf(out, "%s: %.2f\n", "rSoilConst1", params.rSoilConst1);
-  fprintf(out, "%s: %.2f\n", "rSoilConst2", params.rSoilConst2);
-  fprintf(out, "%s: %.2f\n", "leafCSpWt", params.leafCSpWt);
-  fprintf(out, "%s: %.2f\n", "cFracLeaf", params.cFracLeaf);
-  fprintf(out, "%s: %.2f\n", "leafPoolDepth", params.leafPoolDepth);
-  fprintf(out, "%s: %.2f\n", "woodTurnoverRate", params.woodTurnoverRate);
-  fprintf(out, "%s: %.2f\n", "psnTMax", params.psnTMax);
-  fprintf(out, "%s: %.2f\n", "fineRootFrac", params.fineRootFrac);
-  fprintf(out, "%s: %.2f\n", "coarseRootFrac", params.coarseRootFrac);
-  fprintf(out, "%s: %.2f\n", "fineRootAllocation", params.fineRootAllocation);
-  fprintf(out, "%s: %.2f\n", "woodAllocation", params.woodAllocation);
+  fprintf(out, "%s: %.2f\n", "plantWoodInit", model->params.plantWoodInit);
+  fprintf(out, "%s: %.2f\n", "laiInit", model->params.laiInit);
+  fprintf(out, "%s: %.2f\n", "litterInit", model->params.litterInit);
+  fprintf(out, "%s: %.2f\n", "soilInit", model->params.soilInit);
+  fprintf(out, "%s: %.2f\n", "soilWFracInit", model->params.soilWFracInit);
+  fprintf(out, "%s: %.2f\n", "snowInit", model->params.snowInit);
+  fprintf(out, "%s: %.2f\n", "aMax", model->params.aMax);
+  fprintf(out, "%s: %.2f\n", "aMaxFrac", model->params.aMaxFrac);
+  fprintf(out, "%s: %.2f\n", "baseFolRespFrac", model->params.baseFolRespFrac);
+  fprintf(out, "%s: %.2f\n", "psnTMin", model->params.psnTMin);
+  fprintf(out, "%s: %.2f\n", "psnTOpt", model->params.psnTOpt);
+  fprintf(out, "%s: %.2f\n", "dVpdSlope", model->params.dVpdSlope);
+  fprintf(out, "%s: %.2f\n", "dVpdExp", model->params.dVpdExp);
+  fprintf(out, "%s: %.2f\n", "halfSatPar", model->params.halfSatPar);
+  fprintf(out, "%s: %.2f\n", "attenuation", model->params.attenuation);
+  fprintf(out, "%s: %.2f\n", "leafOnDay", model->params.leafOnDay);
+  fprintf(out, "%s: %.2f\n", "gddLeafOn", model->params.gddLeafOn);
+  fprintf(out, "%s: %.2f\n", "soilTempLeafOn", model->params.soilTempLeafOn);
+  fprintf(out, "%s: %.2f\n", "leafOffDay", model->params.leafOffDay);
+  fprintf(out, "%s: %.2f\n", "leafGrowth", model->params.leafGrowth);
+  fprintf(out, "%s: %.2f\n", "fracLeafFall", model->params.fracLeafFall);
+  fprintf(out, "%s: %.2f\n", "leafAllocation", model->params.leafAllocation);
+  fprintf(out, "%s: %.2f\n", "leafTurnoverRate",
+          model->params.leafTurnoverRate);
+  fprintf(out, "%s: %.2f\n", "baseVegResp", model->params.baseVegResp);
+  fprintf(out, "%s: %.2f\n", "vegRespQ10", model->params.vegRespQ10);
+  fprintf(out, "%s: %.2f\n", "growthRespFrac", model->params.growthRespFrac);
+  fprintf(out, "%s: %.2f\n", "frozenSoilFolREff",
+          model->params.frozenSoilFolREff);
+  fprintf(out, "%s: %.2f\n", "frozenSoilThreshold",
+          model->params.frozenSoilThreshold);
+  fprintf(out, "%s: %.2f\n", "litterBreakdownRate",
+          model->params.litterBreakdownRate);
+  fprintf(out, "%s: %.2f\n", "fracLitterRespired",
+          model->params.fracLitterRespired);
+  fprintf(out, "%s: %.2f\n", "baseSoilResp", model->params.baseSoilResp);
+  fprintf(out, "%s: %.2f\n", "soilRespQ10", model->params.soilRespQ10);
+  fprintf(out, "%s: %.2f\n", "soilRespMoistEffect",
+          model->params.soilRespMoistEffect);
+  fprintf(out, "%s: %.2f\n", "waterRemoveFrac", model->params.waterRemoveFrac);
+  fprintf(out, "%s: %.2f\n", "frozenSoilEff", model->params.frozenSoilEff);
+  fprintf(out, "%s: %.2f\n", "wueConst", model->params.wueConst);
+  fprintf(out, "%s: %.2f\n", "soilWHC", model->params.soilWHC);
+  fprintf(out, "%s: %.2f\n", "immedEvapFrac", model->params.immedEvapFrac);
+  fprintf(out, "%s: %.2f\n", "fastFlowFrac", model->params.fastFlowFrac);
+  fprintf(out, "%s: %.2f\n", "snowMelt", model->params.snowMelt);
+  fprintf(out, "%s: %.2f\n", "rdConst", model->params.rdConst);
+  fprintf(out, "%s: %.2f\n", "rSoilConst1", model->params.rSoilConst1);
+  fprintf(out, "%s: %.2f\n", "rSoilConst2", model->params.rSoilConst2);
+  fprintf(out, "%s: %.2f\n", "leafCSpWt", model->params.leafCSpWt);
+  fprintf(out, "%s: %.2f\n", "cFracLeaf", model->params.cFracLeaf);
+  fprintf(out, "%s: %.2f\n", "leafPoolDepth", model->params.leafPoolDepth);
+  fprintf(out, "%s: %.2f\n", "woodTurnoverRate",
+          model->params.woodTurnoverRate);
+  fprintf(out, "%s: %.2f\n", "psnTMax", model->params.psnTMax);
+  fprintf(out, "%s: %.2f\n", "fineRootFrac", model->params.fineRootFrac);
+  fprintf(out, "%s: %.2f\n", "coarseRootFrac", model->params.coarseRootFrac);
+  fprintf(out, "%s: %.2f\n", "fineRootAllocation",
+          model->params.fineRootAllocation);
+  fprintf(out, "%s: %.2f\n", "woodAllocation", model->params.woodAllocation);
   fprintf(out, "%s: %.2f\n", "coarseRootAllocation",
-          params.coarseRootAllocation);
+          model->params.coarseRootAllocation);
   fprintf(out, "%s: %.2f\n", "fineRootTurnoverRate",
-          params.fineRootTurnoverRate);
+          model->params.fineRootTurnoverRate);
   fprintf(out, "%s: %.2f\n", "coarseRootTurnoverRate",
-          params.coarseRootTurnoverRate);
-  fprintf(out, "%s: %.2f\n", "baseFineRootResp", params.baseFineRootResp);
-  fprintf(out, "%s: %.2f\n", "baseCoarseRootResp", params.baseCoarseRootResp);
-  fprintf(out, "%s: %.2f\n", "fineRootQ10", params.fineRootQ10);
-  fprintf(out, "%s: %.2f\n", "coarseRootQ10", params.coarseRootQ10);
-  fprintf(out, "%s: %.2f\n", "waterDrainFrac", params.waterDrainFrac);
+          model->params.coarseRootTurnoverRate);
+  fprintf(out, "%s: %.2f\n", "baseFineRootResp",
+          model->params.baseFineRootResp);
+  fprintf(out, "%s: %.2f\n", "baseCoarseRootResp",
+          model->params.baseCoarseRootResp);
+  fprintf(out, "%s: %.2f\n", "fineRootQ10", model->params.fineRootQ10);
+  fprintf(out, "%s: %.2f\n", "coarseRootQ10", model->params.coarseRootQ10);
+  fprintf(out, "%s: %.2f\n", "waterDrainFrac", model->params.waterDrainFrac);
 
   fclose(out);
 }
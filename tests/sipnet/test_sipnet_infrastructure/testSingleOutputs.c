@@ -0,0 +1,222 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/logging.h"
+#include "utils/tUtils.h"
+#include "tools/sipnet_binary.c"
+
+#define SMOKE_DIR "../../../tests/smoke/russell_1"
+#define TEST_WORK_DIR "single_outputs_work"
+// Text output has 6 decimals, and 2 for time
+#define TEXT_TOLERANCE 5e-7
+#define TIME_TOLERANCE 5e-3
+
+// Run sipnet in the work dir; returns its exit status
+static int runSipnet(const char *args) {
+  char cmd[1024];
+
+  snprintf(cmd, sizeof(cmd),
+           "cd %s && ../../../../sipnet -i sipnet.in %s > single_outputs.log "
+           "2>&1",
+           TEST_WORK_DIR, args);
+  return runShell(cmd);
+}
+
+// Whether column col of a equals column name of b in every row
+static int sameColumn(const SipnetBinaryFile *a, const char *col,
+                      const SipnetBinaryFile *b, const char *name) {
+  int colA = findSipnetBinaryColumn(a, col);
+  int colB = findSipnetBinaryColumn(b, name);
+
+  if (colA < 0 || colB < 0 || a->numRows != b->numRows) {
+    logTest("no column %s, or %s, or different numbers of rows\n", col, name);
+    return 0;
+  }
+  for (long row = 0; row < a->numRows; ++row) {
+    if (a->values[colA][row] != b->values[colB][row]) {
+      logTest("%s differs from %s at row %ld\n", col, name, row);
+      return 0;
+    }
+  }
+  return 1;
+}
+
+// The default items are columns of one file, with the values of the main
+// output's columns for the same variables
+int testDefaultItems(void) {
+  const char *columns[] = {"year", "day", "time",   "NEE",
+                           "NEE_cum", "GPP", "GPP_cum"};
+  SipnetBinaryFile *out, *single;
+  int status = 0;
+
+  logTest("Starting testDefaultItems\n");
+
+  if (runSipnet("--do-single-outputs --output-format binary") != 0) {
+    logTest("sipnet run failed\n");
+    return 1;
+  }
+  out = readSipnetBinary(TEST_WORK_DIR "/sipnet.out");
+  single = readSipnetBinary(TEST_WORK_DIR "/sipnet.single");
+  if (out == NULL || single == NULL) {
+    logTest("could not read sipnet.out and sipnet.single\n");
+    return 1;
+  }
+
+  if (single->numColumns != sizeof(columns) / sizeof(columns[0])) {
+    logTest("sipnet.single has %d columns\n", single->numColumns);
+    status = 1;
+  }
+  for (int col = 0; col < single->numColumns && !status; ++col) {
+    if (strcmp(single->columns[col].name, columns[col]) != 0) {
+      logTest("column %d is %s, expected %s\n", col, single->columns[col].name,
+              columns[col]);
+      status = 1;
+    }
+  }
+  if (!status) {
+    status |= !sameColumn(single, "year", out, "year");
+    status |= !sameColumn(single, "time", out, "time");
+    status |= !sameColumn(single, "NEE", out, "nee");
+    status |= !sameColumn(single, "NEE_cum", out, "cumNEE");
+    status |= !sameColumn(single, "GPP", out, "gpp");
+  }
+
+  freeSipnetBinary(out);
+  freeSipnetBinary(single);
+  return status;
+}
+
+// Any registry variable can be listed; text and binary files hold the same
+// values
+int testListedItems(void) {
+  const char *vars = "--single-output-vars "
+                     "envi.soilC,trackers.soilWetnessFrac,phenology.lastYear";
+  char args[256];
+  char header[256];
+  SipnetBinaryFile *single;
+  FILE *text;
+  int status = 0;
+
+  logTest("Starting testListedItems\n");
+
+  snprintf(args, sizeof(args), "--do-single-outputs %s --output-format binary",
+           vars);
+  status |= runSipnet(args);
+  status |= runShell("cd " TEST_WORK_DIR " && mv sipnet.single single.bin");
+  snprintf(args, sizeof(args), "--do-single-outputs %s", vars);
+  status |= runSipnet(args);
+  if (status != 0) {
+    logTest("sipnet runs failed with status %d\n", status);
+    return status;
+  }
+
+  single = readSipnetBinary(TEST_WORK_DIR "/single.bin");
+  text = fopen(TEST_WORK_DIR "/sipnet.single", "r");
+  if (single == NULL || text == NULL || single->numColumns != 6) {
+    logTest("could not read the single-variable outputs\n");
+    return 1;
+  }
+  if (single->columns[5].type != SIPNET_BINARY_INT32 ||
+      strcmp(single->columns[3].units, "g C m-2") != 0) {
+    logTest("wrong types or units in single.bin\n");
+    status = 1;
+  }
+  if (fgets(header, sizeof(header), text) == NULL ||
+      strcmp(header, "year day time envi.soilC trackers.soilWetnessFrac "
+                     "phenology.lastYear\n") != 0) {
+    logTest("wrong header in sipnet.single\n");
+    status = 1;
+  }
+
+  for (long row = 0; row < single->numRows && !status; ++row) {
+    double values[6];
+    if (fscanf(text, "%lf %lf %lf %lf %lf %lf", &values[0], &values[1],
+               &values[2], &values[3], &values[4], &values[5]) != 6) {
+      logTest("sipnet.single ends at row %ld\n", row);
+      status = 1;
+      break;
+    }
+    for (int col = 0; col < 6; ++col) {
+      double tolerance = (col == 2) ? TIME_TOLERANCE : TEXT_TOLERANCE;
+      if (fabs(values[col] - single->values[col][row]) > tolerance) {
+        logTest("row %ld column %d is %g in text, %g in binary\n", row, col,
+                values[col], single->values[col][row]);
+        status = 1;
+      }
+    }
+  }
+
+  fclose(text);
+  freeSipnetBinary(single);
+  return status;
+}
+
+int testBadItem(void) {
+  int status = 0;
+  int rc;
+
+  logTest("Starting testBadItem\n");
+
+  rc = runSipnet("--do-single-outputs --single-output-vars soilC");
+  if (rc != EXIT_CODE_BAD_PARAMETER_VALUE) {
+    logTest("expected exit code %d for soilC, got %d\n",
+            EXIT_CODE_BAD_PARAMETER_VALUE, rc);
+    status = 1;
+  }
+
+  return status;
+}
+
+int init(void) {
+  int status = 0;
+
+  status |= runShell("rm -rf " TEST_WORK_DIR " && mkdir " TEST_WORK_DIR);
+  status |= runShell("cp " SMOKE_DIR "/sipnet.in " SMOKE_DIR
+                     "/sipnet.clim " SMOKE_DIR "/sipnet.param " SMOKE_DIR
+                     "/events.in " TEST_WORK_DIR);
+
+  if (status != 0) {
+    logTest("Could not initialize test directory %s, failed with status %d\n",
+            TEST_WORK_DIR, status);
+  }
+
+  return status;
+}
+
+int cleanup(void) {
+  int status = runShell("rm -rf " TEST_WORK_DIR);
+
+  if (status != 0) {
+    logTest("Could not clean up test directory %s, failed with status %d\n",
+            TEST_WORK_DIR, status);
+  }
+
+  return status;
+}
+
+int main(void) {
+  int status = 0;
+
+  logTest("Starting testSingleOutputs\n");
+
+  status |= init();
+
+  // If init() fails, don't run the tests; but, we'll want to attempt cleanup()
+  if (!status) {
+    status |= testDefaultItems();
+    status |= testListedItems();
+    status |= testBadItem();
+  }
+
+  status |= cleanup();
+
+  if (status) {
+    logTest("FAILED testSingleOutputs with status %d\n", status);
+    exit(status);
+  }
+
+  logTest("PASSED testSingleOutputs\n");
+  return 0;
+}
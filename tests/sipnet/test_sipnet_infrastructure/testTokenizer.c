@@ -0,0 +1,230 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "common/logging.h"
+#include "common/tokenizer.h"
+#include "utils/tUtils.h"
+
+#define LINES_FILE "tokenizer_lines.txt"
+
+// Check parseDouble against strtod: same value, bit for bit, and same end
+static int checkParseDouble(const char *str) {
+  char *expEnd, *actEnd;
+  double exp = strtod(str, &expEnd);
+  double act = parseDouble(str, &actEnd);
+
+  if ((memcmp(&exp, &act, sizeof(double)) != 0) || (expEnd != actEnd)) {
+    logTest("parseDouble(\"%s\") gave %.17g (end +%ld), strtod gave %.17g "
+            "(end +%ld)\n",
+            str, act, (long)(actEnd - str), exp, (long)(expEnd - str));
+    return 1;
+  }
+  return 0;
+}
+
+int testParseDoubleCases(void) {
+  int status = 0;
+  // Edge cases, and values like those in our input files
+  const char *cases[] = {
+      "0", "-0", "0.0", "-0.000", "1", "1.5", "  42.125", "\t-3.75x", "+7",
+      "5.", ".5", "-.25", ".", "-", "+", "", "abc", "1e5", "1E-5", "2.5e+3",
+      "1e", "1e+", "3.0e-x", "0x1A", "0x1p-3", "inf", "-nan", "1e400", "1e-400",
+      "123456789012345678", "1234567890123456789", "12345678901234567890",
+      "9007199254740993", "0.1", "0.3", "1.0000000000000000000001", "1e22",
+      "1e23", "4.35e-23", "00012.5000", "711.6313", "-1.5314 0.8162",
+      "105.7962\n"};
+
+  logTest("Starting testParseDoubleCases\n");
+
+  for (int ind = 0; ind < (int)(sizeof(cases) / sizeof(char *)); ++ind) {
+    status |= checkParseDouble(cases[ind]);
+  }
+
+  return status;
+}
+
+int testParseDoubleRandom(void) {
+  int status = 0;
+  char str[64];
+
+  logTest("Starting testParseDoubleRandom\n");
+
+  srand(12345);
+  for (int ind = 0; ind < 200000; ++ind) {
+    double value = (rand() - RAND_MAX / 2.0) / (1 + rand() % 100000);
+    int precision = rand() % 18;
+    switch (ind % 3) {
+      case 0:
+        snprintf(str, sizeof(str), "%.*f", precision, value);
+        break;
+      case 1:
+        snprintf(str, sizeof(str), "%.*e", precision, value);
+        break;
+      default:
+        snprintf(str, sizeof(str), "%.17g", value);
+        break;
+    }
+    status |= checkParseDouble(str);
+    if (status) {
+      break;
+    }
+  }
+
+  return status;
+}
+
+int testScan(void) {
+  int status = 0;
+  const char *line = " 2001\t 17  harv 0.25 -3 12x";
+  const char *curr = line;
+  char token[5];
+  double dVal;
+  int iVal;
+
+  logTest("Starting testScan\n");
+
+  if (countTokens(line) != 6) {
+    logTest("countTokens found %d tokens, expected 6\n", countTokens(line));
+    status = 1;
+  }
+  if (!scanInt(&curr, &iVal) || (iVal != 2001)) {
+    logTest("scanInt did not read 2001\n");
+    status = 1;
+  }
+  if (!scanInt(&curr, &iVal) || (iVal != 17)) {
+    logTest("scanInt did not read 17\n");
+    status = 1;
+  }
+  // Like %d, an int can't be read from a word
+  if (scanInt(&curr, &iVal)) {
+    logTest("scanInt read a number from 'harv'\n");
+    status = 1;
+  }
+  if (!scanToken(&curr, token, sizeof(token)) || (strcmp(token, "harv") != 0)) {
+    logTest("scanToken did not read 'harv'\n");
+    status = 1;
+  }
+  if (!scanDouble(&curr, &dVal) || (dVal != 0.25)) {
+    logTest("scanDouble did not read 0.25\n");
+    status = 1;
+  }
+  if (!scanInt(&curr, &iVal) || (iVal != -3)) {
+    logTest("scanInt did not read -3\n");
+    status = 1;
+  }
+  // Like %lf, reads the number at the start of '12x' and stops there
+  if (!scanDouble(&curr, &dVal) || (dVal != 12) || (strcmp(curr, "x") != 0)) {
+    logTest("scanDouble did not read 12 from '12x'\n");
+    status = 1;
+  }
+  if (scanDouble(&curr, &dVal) || (strcmp(curr, "x") != 0)) {
+    logTest("scanDouble read a number from 'x'\n");
+    status = 1;
+  }
+
+  // Tokens that don't fit are truncated, and skipped over entirely
+  curr = "leafoff next";
+  if (!scanToken(&curr, token, sizeof(token)) || (strcmp(token, "leaf") != 0) ||
+      (strcmp(curr, " next") != 0)) {
+    logTest("scanToken did not truncate 'leafoff'\n");
+    status = 1;
+  }
+  curr = "  \t\n";
+  if (scanToken(&curr, token, sizeof(token)) || (countTokens(curr) != 0)) {
+    logTest("scanToken found a token in whitespace\n");
+    status = 1;
+  }
+
+  return status;
+}
+
+int testReadLine(void) {
+  int status = 0;
+  const char *expected[] = {"first line", "", "  third\tline\r", "last"};
+  int numExpected = sizeof(expected) / sizeof(char *);
+  LineReader *reader = (LineReader *)malloc(sizeof(LineReader));
+  char *line;
+  int numLines = 0;
+
+  logTest("Starting testReadLine\n");
+
+  // The last line has no newline
+  FILE *out = fopen(LINES_FILE, "w");
+  fputs("first line\n\n  third\tline\r\nlast", out);
+  fclose(out);
+
+  FILE *in = fopen(LINES_FILE, "r");
+  initLineReader(reader, in);
+  while ((line = readLine(reader)) != NULL) {
+    if ((numLines >= numExpected) || (strcmp(line, expected[numLines]) != 0)) {
+      logTest("readLine gave unexpected line %d: '%s'\n", numLines + 1, line);
+      status = 1;
+    }
+    ++numLines;
+  }
+  if (numLines != numExpected) {
+    logTest("readLine read %d lines, expected %d\n", numLines, numExpected);
+    status = 1;
+  }
+  fclose(in);
+
+  // Lines spanning buffer refills come back whole
+  out = fopen(LINES_FILE, "w");
+  for (int ind = 0; ind < 20000; ++ind) {
+    fprintf(out, "%d %d\n", ind, ind * 7);
+  }
+  fclose(out);
+
+  in = fopen(LINES_FILE, "r");
+  initLineReader(reader, in);
+  numLines = 0;
+  while ((line = readLine(reader)) != NULL) {
+    const char *curr = line;
+    int first, second;
+    if (!scanInt(&curr, &first) || !scanInt(&curr, &second) ||
+        (first != numLines) || (second != numLines * 7)) {
+      logTest("readLine gave bad line %d: '%s'\n", numLines + 1, line);
+      status = 1;
+      break;
+    }
+    ++numLines;
+  }
+  if (numLines != 20000) {
+    logTest("readLine read %d lines, expected 20000\n", numLines);
+    status = 1;
+  }
+  fclose(in);
+
+  free(reader);
+  unlink(LINES_FILE);
+
+  return status;
+}
+
+int run(void) {
+  int status = 0;
+
+  status |= testParseDoubleCases();
+  status |= testParseDoubleRandom();
+  status |= testScan();
+  status |= testReadLine();
+
+  return status;
+}
+
+int main(void) {
+  int status;
+
+  logTest("Starting testTokenizer\n");
+
+  status = run();
+  if (status) {
+    logTest("FAILED testTokenizer with status %d\n", status);
+    exit(status);
+  }
+
+  logTest("PASSED testTokenizer\n");
+  return 0;
+}
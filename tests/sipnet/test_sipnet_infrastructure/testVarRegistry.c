@@ -0,0 +1,121 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common/logging.h"
+#include "sipnet/model.h"
+#include "sipnet/sipnet.h"
+#include "sipnet/varRegistry.h"
+#include "utils/tUtils.h"
+
+// Every variable can be found by name, and points inside its own struct
+int testLookup(void) {
+  int status = 0;
+  int count;
+  const VarInfo *vars = getVariables(&count);
+  SipnetModel *model = newSipnetModel();
+  // Start and size of each group's struct in the model, in VarGroup order
+  const char *starts[NUM_VAR_GROUPS] = {
+      (char *)&model->envi, (char *)&model->fluxes, (char *)&model->trackers,
+      (char *)&model->phenologyTrackers, (char *)&model->plantSurvivalTracker};
+  const size_t sizes[NUM_VAR_GROUPS] = {
+      sizeof(Envi), sizeof(Fluxes), sizeof(Trackers), sizeof(PhenologyTrackers),
+      sizeof(PlantSurvivalTracker)};
+
+  logTest("Starting testLookup\n");
+
+  for (int ind = 0; ind < count; ++ind) {
+    const VarInfo *var = &vars[ind];
+    const char *address = getVariableAddress(model, var);
+    size_t size = (var->type == VAR_INT) ? sizeof(int) : sizeof(double);
+    if (findVariable(var->name) != var) {
+      logTest("%s is not found by name\n", var->name);
+      status = 1;
+    }
+    if (!isVariableField(var->field)) {
+      logTest("%s is not found by field name\n", var->field);
+      status = 1;
+    }
+    if ((address < starts[var->group]) ||
+        (address + size > starts[var->group] + sizes[var->group])) {
+      logTest("%s is outside its struct\n", var->name);
+      status = 1;
+    }
+  }
+
+  if (getVariableAddress(model, findVariable("envi.soilC")) !=
+          &model->envi.soilC ||
+      getVariableAddress(model, findVariable("fluxes.rSoil")) !=
+          &model->fluxes.rSoil ||
+      getVariableAddress(model, findVariable("trackers.rSoil")) !=
+          &model->trackers.rSoil ||
+      getVariableAddress(model, findVariable("phenology.lastYear")) !=
+          &model->phenologyTrackers.lastYear) {
+    logTest("variables have the wrong addresses\n");
+    status = 1;
+  }
+  if (findVariable("rSoil") != NULL || findVariable("envi.LAI") != NULL ||
+      isVariableField("LAI")) {
+    logTest("unknown names were found\n");
+    status = 1;
+  }
+
+  model->trackers.lastYear = 2017;
+  model->envi.snow = 1.5;
+  if (getVariableValue(model, findVariable("trackers.lastYear")) != 2017 ||
+      getVariableValue(model, findVariable("envi.snow")) != 1.5) {
+    logTest("variables have the wrong values\n");
+    status = 1;
+  }
+
+  deleteSipnetModel(model);
+  return status;
+}
+
+// Each group covers its whole struct, so a field added to one of the structs
+// has to be registered too
+int testCoverage(void) {
+  int status = 0;
+  const size_t sizes[NUM_VAR_GROUPS] = {
+      sizeof(Envi), sizeof(Fluxes), sizeof(Trackers), sizeof(PhenologyTrackers),
+      sizeof(PlantSurvivalTracker)};
+
+  logTest("Starting testCoverage\n");
+
+  for (int group = 0; group < NUM_VAR_GROUPS; ++group) {
+    int count;
+    const VarInfo *vars = getGroupVariables(group, &count);
+    size_t covered = 0;
+    for (int ind = 0; ind < count; ++ind) {
+      if (vars[ind].group != group) {
+        logTest("%s is in the wrong group\n", vars[ind].name);
+        status = 1;
+      }
+      covered += (vars[ind].type == VAR_INT) ? sizeof(int) : sizeof(double);
+    }
+    // Allow for the padding after an int among doubles
+    if ((covered > sizes[group]) || (covered + sizeof(int) < sizes[group])) {
+      logTest("%s variables cover %zu bytes of %zu\n", getVarGroupName(group),
+              covered, sizes[group]);
+      status = 1;
+    }
+  }
+
+  return status;
+}
+
+int main(void) {
+  int status = 0;
+
+  logTest("Starting testVarRegistry\n");
+
+  status |= testLookup();
+  status |= testCoverage();
+
+  if (status) {
+    logTest("FAILED testVarRegistry with status %d\n", status);
+    exit(status);
+  }
+
+  logTest("PASSED testVarRegistry\n");
+  return 0;
+}
@@ -5,22 +5,25 @@
 #include "common/context.h"
 #include "sipnet/sipnet.c"
 
+// Model instance shared by the tests in this file
+static SipnetModel testModel;
+static SipnetModel *model = &testModel;
+
 void prepTypesTest(void) {
   // Setup context
   initContext();
   updateIntContext("events", 1, CTX_TEST);
 
   // set up dummy climate
-  climate = (ClimateNode *)malloc(sizeof(ClimateNode));
-  climate->year = 2024;
-  climate->day = 70;
-  climate->length = 0.125;
-  climate->time = 0.0;
-  climate->nextClim = NULL;
+  model->climate = (ClimateNode *)malloc(sizeof(ClimateNode));
+  model->climate->year = 2024;
+  model->climate->day = 70;
+  model->climate->length = 0.125;
+  model->climate->time = 0.0;
 }
 
 void procEvents(void) {
-  resetFluxes();
-  processEvents();
-  updatePoolsForEvents();
+  resetFluxes(model);
+  processEvents(model);
+  updatePoolsForEvents(model);
 }
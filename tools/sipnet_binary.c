@@ -0,0 +1,249 @@
+// Reader for SIPNET binary output files; see sipnet_binary.h
+
+#include "sipnet_binary.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAGIC "SIPNETOB"
+#define MAGIC_LEN 8
+#define BYTE_ORDER_MARK 0x01020304u
+#define SUPPORTED_VERSION 1
+
+typedef struct Reader {
+  FILE *in;
+  const char *path;
+  int swap;  // nonzero if the file has the other byte order
+} Reader;
+
+static void swapBytes(void *data, size_t size) {
+  unsigned char *bytes = (unsigned char *)data;
+
+  for (size_t ind = 0; ind < size / 2; ++ind) {
+    unsigned char tmp = bytes[ind];
+    bytes[ind] = bytes[size - 1 - ind];
+    bytes[size - 1 - ind] = tmp;
+  }
+}
+
+// Read count values of the given size, in this machine's byte order; returns
+// 0 at end of file or on error
+static int readValues(Reader *reader, void *data, size_t size, size_t count) {
+  if (fread(data, size, count, reader->in) != count) {
+    return 0;
+  }
+  if (reader->swap && size > 1) {
+    for (size_t ind = 0; ind < count; ++ind) {
+      swapBytes((unsigned char *)data + ind * size, size);
+    }
+  }
+  return 1;
+}
+
+static int readLabel(Reader *reader, char *label) {
+  uint8_t len;
+
+  if (!readValues(reader, &len, 1, 1) ||
+      fread(label, 1, len, reader->in) != len) {
+    return 0;
+  }
+  label[len] = '\0';
+  return 1;
+}
+
+static size_t typeSize(int type) {
+  switch (type) {
+    case SIPNET_BINARY_INT32:
+      return sizeof(int32_t);
+    case SIPNET_BINARY_FLOAT32:
+      return sizeof(float);
+    case SIPNET_BINARY_FLOAT64:
+      return sizeof(double);
+    default:
+      return 0;
+  }
+}
+
+static SipnetBinaryFile *fail(Reader *reader, SipnetBinaryFile *file,
+                              const char *message) {
+  fprintf(stderr, "Error reading %s: %s\n", reader->path, message);
+  fclose(reader->in);
+  freeSipnetBinary(file);
+  return NULL;
+}
+
+static int readHeader(Reader *reader, SipnetBinaryFile *file,
+                      uint32_t *blockRows, const char **message) {
+  char magic[MAGIC_LEN];
+  uint32_t version, byteOrder, numColumns;
+
+  if (fread(magic, 1, MAGIC_LEN, reader->in) != MAGIC_LEN ||
+      memcmp(magic, MAGIC, MAGIC_LEN) != 0) {
+    *message = "not a SIPNET binary output file";
+    return 0;
+  }
+  // The version is checked once the byte order is known
+  if (!readValues(reader, &version, sizeof(version), 1) ||
+      !readValues(reader, &byteOrder, sizeof(byteOrder), 1)) {
+    *message = "truncated header";
+    return 0;
+  }
+  if (byteOrder != BYTE_ORDER_MARK) {
+    swapBytes(&byteOrder, sizeof(byteOrder));
+    if (byteOrder != BYTE_ORDER_MARK) {
+      *message = "bad byte order mark";
+      return 0;
+    }
+    swapBytes(&version, sizeof(version));
+    reader->swap = 1;
+  }
+  if (version != SUPPORTED_VERSION) {
+    *message = "unsupported format version";
+    return 0;
+  }
+  if (!readValues(reader, &numColumns, sizeof(numColumns), 1) ||
+      !readValues(reader, blockRows, sizeof(*blockRows), 1)) {
+    *message = "truncated header";
+    return 0;
+  }
+
+  file->numColumns = (int)numColumns;
+  file->columns =
+      (SipnetBinaryColumn *)calloc(numColumns, sizeof(SipnetBinaryColumn));
+  file->values = (double **)calloc(numColumns, sizeof(double *));
+  if (file->columns == NULL || file->values == NULL) {
+    *message = "out of memory";
+    return 0;
+  }
+  for (uint32_t col = 0; col < numColumns; ++col) {
+    uint8_t type;
+    if (!readValues(reader, &type, 1, 1) ||
+        !readLabel(reader, file->columns[col].name) ||
+        !readLabel(reader, file->columns[col].units)) {
+      *message = "truncated header";
+      return 0;
+    }
+    if (typeSize(type) == 0) {
+      *message = "unknown column type";
+      return 0;
+    }
+    file->columns[col].type = type;
+  }
+
+  return 1;
+}
+
+// See sipnet_binary.h
+SipnetBinaryFile *readSipnetBinary(const char *path) {
+  Reader reader = {NULL, path, 0};
+  SipnetBinaryFile *file;
+  const char *message = NULL;
+  uint32_t blockRows, numRows;
+  long capacity = 0;
+  void *block = NULL;
+
+  reader.in = fopen(path, "rb");
+  if (reader.in == NULL) {
+    fprintf(stderr, "Error reading %s: could not open file\n", path);
+    return NULL;
+  }
+  file = (SipnetBinaryFile *)calloc(1, sizeof(SipnetBinaryFile));
+  if (file == NULL) {
+    return fail(&reader, file, "out of memory");
+  }
+  if (!readHeader(&reader, file, &blockRows, &message)) {
+    return fail(&reader, file, message);
+  }
+
+  block = malloc((size_t)blockRows * sizeof(double));
+  if (block == NULL) {
+    return fail(&reader, file, "out of memory");
+  }
+  while (1) {
+    // End of file is only allowed between blocks
+    size_t got = fread(&numRows, 1, sizeof(numRows), reader.in);
+    if (got == 0) {
+      break;
+    }
+    if (got < sizeof(numRows)) {
+      free(block);
+      return fail(&reader, file, "truncated block");
+    }
+    if (reader.swap) {
+      swapBytes(&numRows, sizeof(numRows));
+    }
+    if (numRows == 0 || numRows > blockRows) {
+      free(block);
+      return fail(&reader, file, "bad block size");
+    }
+    if (file->numRows + numRows > capacity) {
+      capacity = (capacity == 0) ? blockRows : 2 * capacity;
+      for (int col = 0; col < file->numColumns; ++col) {
+        double *values =
+            (double *)realloc(file->values[col], capacity * sizeof(double));
+        if (values == NULL) {
+          free(block);
+          return fail(&reader, file, "out of memory");
+        }
+        file->values[col] = values;
+      }
+    }
+    for (int col = 0; col < file->numColumns; ++col) {
+      int type = file->columns[col].type;
+      double *dest = file->values[col] + file->numRows;
+      if (!readValues(&reader, block, typeSize(type), numRows)) {
+        free(block);
+        return fail(&reader, file, "truncated block");
+      }
+      for (uint32_t row = 0; row < numRows; ++row) {
+        switch (type) {
+          case SIPNET_BINARY_INT32:
+            dest[row] = ((int32_t *)block)[row];
+            break;
+          case SIPNET_BINARY_FLOAT32:
+            dest[row] = ((float *)block)[row];
+            break;
+          default:
+            dest[row] = ((double *)block)[row];
+            break;
+        }
+      }
+    }
+    file->numRows += numRows;
+  }
+  free(block);
+
+  if (ferror(reader.in)) {
+    return fail(&reader, file, "read error");
+  }
+  fclose(reader.in);
+
+  return file;
+}
+
+// See sipnet_binary.h
+int findSipnetBinaryColumn(const SipnetBinaryFile *file, const char *name) {
+  for (int col = 0; col < file->numColumns; ++col) {
+    if (strcmp(file->columns[col].name, name) == 0) {
+      return col;
+    }
+  }
+  return -1;
+}
+
+// See sipnet_binary.h
+void freeSipnetBinary(SipnetBinaryFile *file) {
+  if (file == NULL) {
+    return;
+  }
+  if (file->values != NULL) {
+    for (int col = 0; col < file->numColumns; ++col) {
+      free(file->values[col]);
+    }
+    free(file->values);
+  }
+  free(file->columns);
+  free(file);
+}
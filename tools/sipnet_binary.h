@@ -0,0 +1,62 @@
+// Reader for SIPNET binary output files (--output-format binary or binary32)
+//
+// The file layout is described in src/sipnet/binaryOutput.h. This reader
+// depends only on the C standard library, so sipnet_binary.h and
+// sipnet_binary.c can be copied into other programs as they are.
+//
+// Example:
+//
+//   SipnetBinaryFile *file = readSipnetBinary("sipnet.out");
+//   int nee = findSipnetBinaryColumn(file, "nee");
+//   for (long row = 0; row < file->numRows; ++row) {
+//     total += file->values[nee][row];
+//   }
+//   freeSipnetBinary(file);
+
+#ifndef SIPNET_BINARY_H
+#define SIPNET_BINARY_H
+
+#define SIPNET_BINARY_MAXLABEL 256
+
+// Column types, as stored in the file
+#define SIPNET_BINARY_INT32 1
+#define SIPNET_BINARY_FLOAT32 2
+#define SIPNET_BINARY_FLOAT64 3
+
+typedef struct SipnetBinaryColumn {
+  char name[SIPNET_BINARY_MAXLABEL];
+  char units[SIPNET_BINARY_MAXLABEL];
+  int type;  // one of the SIPNET_BINARY_* types
+} SipnetBinaryColumn;
+
+typedef struct SipnetBinaryFile {
+  int numColumns;
+  long numRows;
+  SipnetBinaryColumn *columns;
+  // values[col][row], converted to double whatever the column type; the
+  // conversion is exact for every type
+  double **values;
+} SipnetBinaryFile;
+
+/*!
+ * Read a whole binary output file
+ *
+ * Files written on a machine with the other byte order are read too.
+ *
+ * @param path file to read
+ * @return the file's columns and values, or NULL (with a message on stderr)
+ *         if the file can't be read or isn't a SIPNET binary output file
+ */
+SipnetBinaryFile *readSipnetBinary(const char *path);
+
+/*!
+ * Index of the column with the given name, or -1 if there is none
+ */
+int findSipnetBinaryColumn(const SipnetBinaryFile *file, const char *name);
+
+/*!
+ * Free a file returned by readSipnetBinary()
+ */
+void freeSipnetBinary(SipnetBinaryFile *file);
+
+#endif  // SIPNET_BINARY_H
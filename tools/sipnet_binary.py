@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+"""Reader for SIPNET binary output files (``--output-format binary``).
+
+The file layout is described in ``src/sipnet/binaryOutput.h``: a header with
+the name, units and type of each column, then blocks of rows stored column by
+column.
+
+Example::
+
+  from tools.sipnet_binary import read_binary_output
+
+  out = read_binary_output("sipnet.out")
+  out.data["nee"].sum()
+  out.units["nee"]  # 'g C m-2'
+"""
+
+from __future__ import annotations
+
+from dataclasses import dataclass
+from pathlib import Path
+import struct
+
+import numpy as np
+import pandas as pd
+
+MAGIC = b"SIPNETOB"
+BYTE_ORDER_MARK = 0x01020304
+SUPPORTED_VERSION = 1
+
+# Column type codes in the file, and their numpy types (without byte order)
+COLUMN_TYPES = {1: "i4", 2: "f4", 3: "f8"}
+
+
+@dataclass
+class BinaryOutput:
+  """Columns of a binary output file, and the units of each column."""
+  data: pd.DataFrame
+  units: dict[str, str]
+
+
+def is_binary_output(path: str | Path) -> bool:
+  """Whether the file starts like a SIPNET binary output file."""
+  with open(path, "rb") as f:
+    return f.read(len(MAGIC)) == MAGIC
+
+
+def _parse_header(buf: bytes) -> tuple[str, int, list[tuple[str, str, str]], int]:
+  """Return byte order, rows per block, columns and header length."""
+  if buf[:len(MAGIC)] != MAGIC:
+    raise ValueError("not a SIPNET binary output file")
+  pos = len(MAGIC)
+  for order in ("<", ">"):
+    version, mark = struct.unpack_from(order + "II", buf, pos)
+    if mark == BYTE_ORDER_MARK:
+      break
+  else:
+    raise ValueError("bad byte order mark")
+  if version != SUPPORTED_VERSION:
+    raise ValueError(f"unsupported format version {version}")
+  pos += 8
+  num_columns, block_rows = struct.unpack_from(order + "II", buf, pos)
+  pos += 8
+
+  columns = []
+  for _ in range(num_columns):
+    type_code = buf[pos]
+    if type_code not in COLUMN_TYPES:
+      raise ValueError(f"unknown column type {type_code}")
+    pos += 1
+    labels = []
+    for _ in range(2):
+      length = buf[pos]
+      labels.append(buf[pos + 1:pos + 1 + length].decode("utf-8"))
+      pos += 1 + length
+    columns.append((labels[0], labels[1], order + COLUMN_TYPES[type_code]))
+  return order, block_rows, columns, pos
+
+
+def read_binary_output(path: str | Path) -> BinaryOutput:
+  """Read a whole binary output file.
+
+  Integer columns (year, day) keep their integer type; float32 files give
+  float32 columns.
+  """
+  buf = Path(path).read_bytes()
+  try:
+    order, block_rows, columns, pos = _parse_header(buf)
+  except (struct.error, IndexError) as exc:
+    raise ValueError(f"{path}: truncated header") from exc
+
+  pieces: list[list[np.ndarray]] = [[] for _ in columns]
+  while pos < len(buf):
+    if pos + 4 > len(buf):
+      raise ValueError(f"{path}: truncated block")
+    (num_rows,) = struct.unpack_from(order + "I", buf, pos)
+    pos += 4
+    if num_rows == 0 or num_rows > block_rows:
+      raise ValueError(f"{path}: bad block size {num_rows}")
+    for ind, (_, _, dtype) in enumerate(columns):
+      size = np.dtype(dtype).itemsize * num_rows
+      if pos + size > len(buf):
+        raise ValueError(f"{path}: truncated block")
+      pieces[ind].append(np.frombuffer(buf, dtype=dtype, count=num_rows,
+                                       offset=pos))
+      pos += size
+
+  data = {}
+  for (name, _, dtype), parts in zip(columns, pieces):
+    values = np.concatenate(parts) if parts else np.empty(0, dtype=dtype)
+    # Native byte order, so pandas and numpy use their fast paths
+    data[name] = values.astype(np.dtype(dtype).newbyteorder("="))
+  return BinaryOutput(data=pd.DataFrame(data),
+                      units={name: units for name, units, _ in columns})
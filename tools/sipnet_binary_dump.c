@@ -0,0 +1,57 @@
+// Print a SIPNET binary output file as text: a row of column names, then one
+// row per time step with every value at full precision
+//
+// Usage: sipnet-binary-dump <file> [column ...]
+//
+// With column names, only those columns are printed, in the order given.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "sipnet_binary.h"
+
+int main(int argc, char *argv[]) {
+  SipnetBinaryFile *file;
+  int numSelected;
+  int *selected;
+
+  if (argc < 2) {
+    fprintf(stderr, "Usage: %s <file> [column ...]\n", argv[0]);
+    return 1;
+  }
+  file = readSipnetBinary(argv[1]);
+  if (file == NULL) {
+    return 1;
+  }
+
+  numSelected = (argc > 2) ? argc - 2 : file->numColumns;
+  selected = (int *)malloc(numSelected * sizeof(int));
+  if (selected == NULL) {
+    fprintf(stderr, "Out of memory\n");
+    return 1;
+  }
+  for (int ind = 0; ind < numSelected; ++ind) {
+    selected[ind] =
+        (argc > 2) ? findSipnetBinaryColumn(file, argv[ind + 2]) : ind;
+    if (selected[ind] < 0) {
+      fprintf(stderr, "No column named %s in %s\n", argv[ind + 2], argv[1]);
+      return 1;
+    }
+  }
+
+  for (int ind = 0; ind < numSelected; ++ind) {
+    printf("%s%s", (ind > 0) ? " " : "", file->columns[selected[ind]].name);
+  }
+  printf("\n");
+  for (long row = 0; row < file->numRows; ++row) {
+    for (int ind = 0; ind < numSelected; ++ind) {
+      printf("%s%.17g", (ind > 0) ? " " : "",
+             file->values[selected[ind]][row]);
+    }
+    printf("\n");
+  }
+
+  free(selected);
+  freeSipnetBinary(file);
+  return 0;
+}
@@ -0,0 +1,67 @@
+#!/usr/bin/env python3
+from __future__ import annotations
+
+import struct
+import tempfile
+import unittest
+from pathlib import Path
+
+import numpy as np
+
+import tools.sipnet_binary as sipnet_binary
+
+
+def make_file(order: str, block_rows: int, blocks: list[list[list[float]]]) -> bytes:
+  """Build a binary output file with columns year (int32), gpp (float64) and
+  nee (float32); each block is a list of rows."""
+  columns = [(1, "year", "year"), (3, "gpp", "g C m-2"), (2, "nee", "g C m-2")]
+  buf = sipnet_binary.MAGIC + struct.pack(order + "IIII", 1, 0x01020304,
+                                          len(columns), block_rows)
+  for type_code, name, units in columns:
+    buf += bytes([type_code, len(name)]) + name.encode()
+    buf += bytes([len(units)]) + units.encode()
+  for rows in blocks:
+    buf += struct.pack(order + "I", len(rows))
+    for col, fmt in enumerate(("i", "d", "f")):
+      buf += struct.pack(order + fmt * len(rows), *[row[col] for row in rows])
+  return buf
+
+
+class SipnetBinaryTests(unittest.TestCase):
+  def write(self, data: bytes) -> Path:
+    tmp = tempfile.NamedTemporaryFile(suffix=".out", delete=False)
+    tmp.write(data)
+    tmp.close()
+    self.addCleanup(Path(tmp.name).unlink)
+    return Path(tmp.name)
+
+  def test_reads_blocks_in_either_byte_order(self) -> None:
+    blocks = [[[2016, 0.1, 0.25], [2016, 0.2, -0.5]], [[2017, 0.3, 1.5]]]
+    for order in ("<", ">"):
+      path = self.write(make_file(order, 2, blocks))
+      self.assertTrue(sipnet_binary.is_binary_output(path))
+      out = sipnet_binary.read_binary_output(path)
+      self.assertEqual(list(out.data.columns), ["year", "gpp", "nee"])
+      self.assertEqual(out.units["gpp"], "g C m-2")
+      self.assertEqual(out.data["year"].dtype, np.int32)
+      self.assertEqual(out.data["nee"].dtype, np.float32)
+      np.testing.assert_array_equal(out.data["year"], [2016, 2016, 2017])
+      np.testing.assert_array_equal(out.data["gpp"], [0.1, 0.2, 0.3])
+      np.testing.assert_array_equal(out.data["nee"], [0.25, -0.5, 1.5])
+
+  def test_no_rows(self) -> None:
+    out = sipnet_binary.read_binary_output(self.write(make_file("<", 4, [])))
+    self.assertEqual(len(out.data), 0)
+    self.assertEqual(list(out.data.columns), ["year", "gpp", "nee"])
+
+  def test_rejects_truncated_and_foreign_files(self) -> None:
+    data = make_file("<", 2, [[[2016, 0.1, 0.25]]])
+    with self.assertRaises(ValueError):
+      sipnet_binary.read_binary_output(self.write(data[:-2]))
+    with self.assertRaises(ValueError):
+      sipnet_binary.read_binary_output(self.write(b"year day time\n"))
+    self.assertFalse(sipnet_binary.is_binary_output(self.write(b"year day\n")))
+
+
+if __name__ == "__main__":
+  unittest.main()